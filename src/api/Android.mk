@@ -38,15 +38,19 @@ LOCAL_STATIC_LIBRARIES := libosal libandroidifaddrs
 include $(BUILD_STATIC_LIBRARY)
 endef
 
-$(eval $(call build_plugin_util, libtr50, ./plugin/tr50/tr50.c ) )
+$(eval $(call build_plugin_util, libcbor, ./plugin/cbor/cbor.c ) )
+$(eval $(call build_plugin_util, libtr50, ./plugin/tr50/tr50.c \
+	./plugin/tr50/tr50_dedup.c \
+	./plugin/tr50/tr50_journal.c \
+	./plugin/tr50/tr50_telemetry.c ) )
 
 # build libiot
 include $(CLEAR_VARS)
 LOCAL_C_INCLUDES := $(iot_c_includes) external/hdc/libarchive/contrib/android/include
 LOCAL_CFLAGS += -DIOT_PLUGIN_SUPPORT=1 -DOPENSSL -DJSMN_PARENT_LINKS -DJSMN_STRICT ${EXTRA_CFLAGS}
 LOCAL_EXPORT_C_INCLUDE_DIRS := $(LOCAL_PATH)/public
-LOCAL_SHARED_LIBRARIES := libcutils libdl libjansson libmosquitto libext2_uuid libcrypto libssl libcurl
-LOCAL_STATIC_LIBRARIES := libiotutils libosal libandroidifaddrs libtr50 libpaho-mqtt3as libiotjsmn libarchive
+LOCAL_SHARED_LIBRARIES := libcutils libdl libjansson libmosquitto libext2_uuid libcrypto libssl libcurl libz
+LOCAL_STATIC_LIBRARIES := libiotutils libosal libandroidifaddrs libcbor libtr50 libpaho-mqtt3as libiotjsmn libarchive
 
 LOCAL_MODULE := libiot
 LOCAL_SRC_FILES := \
@@ -62,6 +66,7 @@ LOCAL_SRC_FILES := \
 	./iot_mqtt.c \
 	./iot_option.c \
 	./iot_plugin.c \
+	./iot_spawn.c \
 	./iot_telemetry.c \
 	./checksum/iot_checksum.c \
 	./checksum/iot_checksum_crc32.c \
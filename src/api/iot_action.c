@@ -32,9 +32,156 @@
 #define IOT_ACTION_COMMAND_STDERR                "stderr"
 /** @brief Name of the parameter containing standard out for a command */
 #define IOT_ACTION_COMMAND_STDOUT                "stdout"
+/** @brief Maximum number of arguments when spawning a command */
+#define IOT_ACTION_COMMAND_ARGV_MAX              ( IOT_PARAMETER_MAX + 16u )
+/** @brief Characters in a command that need the shell to interpret them */
+#define IOT_ACTION_COMMAND_SHELL_CHARACTERS      "\"'\\$`|&;<>(){}[]*?~#=%!\n\r"
+/** @brief Shell running commands whose output is streamed */
+#define IOT_ACTION_COMMAND_SHELL                 "/bin/sh"
+/** @brief Maximum size of each event publishing streamed command output */
+#define IOT_ACTION_COMMAND_STREAM_CHUNK          1024u
+/** @brief Minimum time in milliseconds between events publishing streamed
+ *         command output, unless the output fills a chunk */
+#define IOT_ACTION_COMMAND_STREAM_INTERVAL       1000u
+/** @brief Alignment of blocks allocated from the arena of a request */
+#define IOT_ACTION_REQUEST_ARENA_ALIGN           sizeof( iot_float64_t )
+/** @brief Number of items an array in the arena of a request grows by */
+#define IOT_ACTION_REQUEST_ARENA_GROWTH          4u
 /** @brief Characters that cannot be used in parameter names */
 #define IOT_PARAMETER_NAME_BAD_CHARACTERS        "=\\;&|"
 
+#ifdef IOT_SPAWN_SUPPORT
+/**
+ * @brief Output of a command being published while it runs
+ */
+struct iot_action_command_stream
+{
+	/** @brief action the command is registered with */
+	const struct iot_action *action;
+	/** @brief output not yet published (standard output, then error) */
+	char buf[2u][IOT_ACTION_COMMAND_STREAM_CHUNK];
+	/** @brief number of characters not yet published */
+	size_t len[2u];
+	/** @brief number of characters output in total */
+	iot_uint64_t total[2u];
+	/** @brief time output was last published */
+	iot_timestamp_t last;
+};
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
+#ifdef IOT_SPAWN_SUPPORT
+/**
+ * @brief Builds the argument list to spawn a command without a shell
+ *
+ * The command is split into words at blanks, then each parameter is added as
+ * a single argument, "--name=value" (or the value, if it has no name).  As
+ * the arguments are not parsed again, values are not quoted.
+ *
+ * @param[in]      action              action containing the registered command
+ * @param[in]      request             request holding the parameters
+ * @param[out]     argv                argument list, terminated by NULL
+ *                                     (IOT_ACTION_COMMAND_ARGV_MAX + 1 items)
+ * @param[out]     buf                 storage for the arguments
+ * @param[in]      len                 size of the storage
+ *
+ * @retval IOT_FALSE                   command uses shell syntax, or does not
+ *                                     fit, so must be run through the shell
+ * @retval IOT_TRUE                    argument list built
+ */
+static IOT_SECTION iot_bool_t iot_action_command_argv(
+	const struct iot_action *action,
+	const struct iot_action_request *request,
+	const char **argv,
+	char *buf,
+	size_t len );
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
+/**
+ * @brief Builds the command line to run a command through the shell
+ *
+ * Each parameter is appended as "--name=value" (or the value, if it has no
+ * name), with string values quoted.  Parameters that do not fit are
+ * truncated.
+ *
+ * @param[in]      action              action containing the registered command
+ * @param[in]      request             request holding the parameters
+ * @param[out]     buf                 destination buffer
+ * @param[in]      len                 size of the destination buffer
+ */
+static IOT_SECTION void iot_action_command_line(
+	const struct iot_action *action,
+	const struct iot_action_request *request,
+	char *buf,
+	size_t len );
+
+#ifdef IOT_SPAWN_SUPPORT
+/**
+ * @brief Collects output of a command while it runs, publishing it
+ *
+ * Output is published an event at a time, each holding complete lines
+ * where possible, at most once per IOT_ACTION_COMMAND_STREAM_INTERVAL unless
+ * a chunk fills up; so memory used does not depend on the amount of output.
+ *
+ * @param[in,out]  user_data           output being streamed
+ * @param[in]      is_err              whether the output is standard error
+ * @param[in]      buf                 output read
+ * @param[in]      len                 number of characters read
+ */
+static IOT_SECTION void iot_action_command_output(
+	void *user_data,
+	iot_bool_t is_err,
+	const char *buf,
+	size_t len );
+
+/**
+ * @brief Publishes output of a command collected so far
+ *
+ * @param[in,out]  stream              output being streamed
+ * @param[in]      i                   0 for standard output, 1 for error
+ * @param[in]      all                 publish partial lines as well
+ */
+static IOT_SECTION void iot_action_command_output_flush(
+	struct iot_action_command_stream *stream,
+	size_t i,
+	iot_bool_t all );
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
+/**
+ * @brief Sets the result of a command that ran to completion on a request
+ *
+ * @param[in]      action              action containing the registered command
+ * @param[in,out]  request             request to return the output in
+ * @param[in]      return_code         exit code of the command
+ * @param[in]      std_out             standard output captured (optional)
+ * @param[in]      std_err             standard error captured (optional)
+ *
+ * @retval IOT_STATUS_EXECUTION_ERROR  command exited with a non-zero code
+ * @retval IOT_STATUS_SUCCESS          command exited successfully
+ */
+static IOT_SECTION iot_status_t iot_action_command_result(
+	const struct iot_action *action,
+	struct iot_action_request *request,
+	int return_code,
+	const char *std_out,
+	const char *std_err );
+
+/**
+ * @brief Writes the value of a parameter as a command-line argument
+ *
+ * @param[in]      data                value of the parameter
+ * @param[out]     buf                 destination buffer
+ * @param[in]      len                 size of the destination buffer
+ * @param[in]      quote               whether to quote strings for the shell
+ *
+ * @retval IOT_FALSE                   value did not fit, it may be truncated
+ * @retval IOT_TRUE                    value written
+ */
+static IOT_SECTION iot_bool_t iot_action_command_value(
+	const struct iot_data *data,
+	char *buf,
+	size_t len,
+	iot_bool_t quote );
+
 /**
  * @brief Executes the action specified
  *
@@ -75,6 +222,31 @@ static IOT_SECTION iot_status_t iot_action_execute_command(
 	struct iot_action_request *request,
 	iot_millisecond_t max_time_out );
 
+#ifdef IOT_SPAWN_SUPPORT
+/**
+ * @brief Executes a system command registered with an action, without a
+ *        shell
+ *
+ * @param[in]      action              action containing the registered command
+ * @param[in,out]  request             request received from the cloud
+ * @param[in]      max_time_out        maximum time to wait in milliseconds for
+ *                                     execution
+ *
+ * @retval IOT_STATUS_FAILURE          failed to start the command
+ * @retval IOT_STATUS_INVOKED          command executed with no status return
+ * @retval IOT_STATUS_NOT_SUPPORTED    command must be run through the shell
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @retval IOT_STATUS_EXECUTION_ERROR  command exited with a non-zero code
+ * @retval IOT_STATUS_TIMED_OUT        command did not exit in time
+ *
+ * @see iot_action_execute_command
+ */
+static IOT_SECTION iot_status_t iot_action_execute_spawn(
+	const struct iot_action *action,
+	struct iot_action_request *request,
+	iot_millisecond_t max_time_out );
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
 /**
  * @brief Sets the value of an action option
  *
@@ -123,6 +295,178 @@ static IOT_SECTION iot_status_t iot_action_register(
 	iot_transaction_t *txn,
 	iot_millisecond_t max_time_out );
 
+#ifndef IOT_STACK_ONLY
+/**
+ * @brief Frees memory held by a request, unless it is in the request's arena
+ *
+ * @param[in]      request             action request
+ * @param[in,out]  ptr                 memory to free, set to NULL
+ */
+static IOT_SECTION void iot_action_request_arena_free(
+	const struct iot_action_request *request,
+	void **ptr );
+
+/**
+ * @brief Makes room for one more item in an array held by a request
+ *
+ * Arrays are grown within the arena of the request, a few items at a time,
+ * and are moved to the heap once the arena is full.
+ *
+ * @param[in,out]  request             action request
+ * @param[in]      ptr                 array to grow (NULL if none yet)
+ * @param[in]      count               number of items in the array
+ * @param[in]      size                size of each item
+ *
+ * @return the array with room for @p count + 1 items, NULL on failure (the
+ *         original array is left untouched)
+ */
+static IOT_SECTION void *iot_action_request_arena_grow(
+	struct iot_action_request *request,
+	void *ptr,
+	size_t count,
+	size_t size );
+#endif /* ifndef IOT_STACK_ONLY */
+
+/**
+ * @brief Returns whether memory belongs to the arena of a request
+ *
+ * @param[in]      request             action request
+ * @param[in]      ptr                 memory to check
+ *
+ * @retval IOT_FALSE                   memory is not in the arena
+ * @retval IOT_TRUE                    memory is in the arena
+ */
+static IOT_SECTION iot_bool_t iot_action_request_arena_owns(
+	const struct iot_action_request *request,
+	const void *ptr );
+
+#ifndef IOT_STACK_ONLY
+/**
+ * @brief Allocates space from the arena of a request, or from the heap if
+ *        the arena is full
+ *
+ * @param[in,out]  request             action request
+ * @param[in]      size                number of bytes required
+ *
+ * @return a pointer to the space, NULL on failure
+ *
+ * @see iot_action_request_arena_free
+ */
+static IOT_SECTION void *iot_action_request_arena_storage(
+	struct iot_action_request *request,
+	size_t size );
+#endif /* ifndef IOT_STACK_ONLY */
+
+/**
+ * @brief Sets the value of a request option or parameter
+ *
+ * Strings are copied into the arena of the request, unless they are already
+ * held there.  Other values needing storage are copied onto the heap.
+ *
+ * @param[in,out]  request             action request
+ * @param[out]     data                object to set
+ * @param[in]      type                data type
+ * @param[in]      args                argument containing data
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to function
+ * @retval IOT_STATUS_NO_MEMORY        no space to store the value
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t iot_action_request_data_set(
+	struct iot_action_request *request,
+	struct iot_data *data,
+	iot_type_t type,
+	va_list args );
+
+/**
+ * @brief Returns the queue lane for requests to an action
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      name                name of the action requested
+ *
+ * @return the lane matching the priority flags of the action,
+ *         IOT_ACTION_LANE_NORMAL if the action is not found
+ */
+static IOT_SECTION iot_uint8_t iot_action_request_lane(
+	const iot_t *lib,
+	const char *name );
+
+#ifdef IOT_THREAD_SUPPORT
+/**
+ * @brief Takes the locks an action holds while it executes
+ *
+ * Actions flagged with IOT_ACTION_EXCLUSIVE_APP take the library lock
+ * exclusively, any other action takes it shared followed by the locks of
+ * its groups.  Group locks are always taken in the order of the groups, so
+ * actions in several groups cannot deadlock each other.
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in]      action              action about to execute
+ *
+ * @see iot_action_unlock
+ */
+static IOT_SECTION void iot_action_lock(
+	iot_t *lib,
+	const iot_action_t *action );
+
+/**
+ * @brief Releases the locks taken by @ref iot_action_lock
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in]      action              action that has executed
+ *
+ * @see iot_action_lock
+ */
+static IOT_SECTION void iot_action_unlock(
+	iot_t *lib,
+	const iot_action_t *action );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+/**
+ * @brief Removes the next request that can be executed from the queue
+ *
+ * The oldest request in the highest priority lane is returned, skipping
+ * requests for actions already running their maximum number of concurrent
+ * requests.
+ *
+ * @note The caller must hold @c worker_mutex, if running multi-threaded
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[out]     action              action requested, its count of running
+ *                                     requests is incremented (NULL if the
+ *                                     action is not registered)
+ *
+ * @return the request removed from the queue, NULL if there is no request
+ *         that can be executed
+ */
+static IOT_SECTION struct iot_action_request *iot_action_request_next(
+	iot_t *lib,
+	iot_action_t **action );
+
+/**
+ * @brief Finishes a deferred request
+ *
+ * Reports the result and frees the request, unless its time out was already
+ * reported, in which case the request is only freed.  If the time out is
+ * being reported by another thread, that thread frees the request.
+ *
+ * @param[in,out]  action              action requested (optional)
+ * @param[in,out]  request             deferred request to finish
+ * @param[in]      status              result of the action
+ * @param[in]      message             error message to report (optional)
+ * @param[in]      max_time_out        maximum time to wait in milliseconds
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    request is not deferred
+ * @retval IOT_STATUS_SUCCESS          result reported
+ * @retval IOT_STATUS_TIMED_OUT        request had already timed out
+ */
+static IOT_SECTION iot_status_t iot_action_request_finish(
+	iot_action_t *action,
+	struct iot_action_request *request,
+	iot_status_t status,
+	const char *message,
+	iot_millisecond_t max_time_out );
+
 /**
  * @brief Sets the value of an action request option
  *
@@ -160,6 +504,18 @@ static IOT_SECTION iot_status_t iot_action_request_parameter_set_args(
 	iot_type_t type,
 	va_list args );
 
+/**
+ * @brief Frees a finished request and releases its slot of the action
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in,out]  action              action requested (optional)
+ * @param[in,out]  request             request to free
+ */
+static IOT_SECTION void iot_action_request_release(
+	iot_t *lib,
+	iot_action_t *action,
+	struct iot_action_request *request );
+
 
 /**
  * @brief Sets a parameter value for an action request to be executed
@@ -185,15 +541,45 @@ iot_action_t *iot_action_allocate(
 	struct iot_action *result = NULL;
 	if ( lib && name && *name != '\0' )
 	{
-		if ( lib->action_count < IOT_ACTION_MAX )
+		struct iot_action **action_ptr = IOT_ACTION_PTR( lib );
+		iot_uint32_t max = IOT_ACTION_MAX;
+#ifndef IOT_STACK_ONLY
+		if ( lib->action_heap )
+			max = lib->action_max;
+
+		/* grow the list of actions if it is full */
+		if ( lib->action_count >= max )
+		{
+			struct iot_action **const heap =
+				(struct iot_action **)iot_common_list_grow(
+					(void **)lib->action_heap,
+					(void *const *)lib->action_ptr, &max );
+			if ( heap )
+			{
+				lib->action_heap = heap;
+				lib->action_max = max;
+				action_ptr = heap;
+			}
+		}
+#endif /* ifndef IOT_STACK_ONLY */
+
+		if ( !lib->action_index.slot )
+			iot_common_index_initialize( &lib->action_index,
+				offsetof( struct iot_action, name ),
+				lib->_action_index,
+				IOT_INDEX_SIZE( IOT_ACTION_MAX ) );
+
+		if ( lib->action_count < max &&
+			iot_common_index_reserve( &lib->action_index,
+				lib->action_count + 1u ) == IOT_STATUS_SUCCESS )
 		{
-			const unsigned int count = lib->action_count;
+			const iot_uint32_t count = lib->action_count;
 #ifndef IOT_STACK_ONLY
 			iot_bool_t is_in_heap = IOT_FALSE;
 #endif /* ifndef IOT_STACK_ONLY */
 
 			/* look for free action in stack */
-			result = lib->action_ptr[count];
+			result = action_ptr[count];
 
 #ifndef IOT_STACK_ONLY
 			/* allocate action in heap if none is available in stack */
@@ -207,9 +593,9 @@ iot_action_t *iot_action_allocate(
 
 			if ( result )
 			{
-				unsigned int cur_idx = 0u;
-				unsigned int min_idx = 0u;
-				unsigned int max_idx = count;
+				iot_uint32_t cur_idx = 0u;
+				iot_uint32_t min_idx = 0u;
+				iot_uint32_t max_idx = count;
 				size_t name_len;
 
 				os_memzero( result, sizeof( struct iot_action ) );
@@ -239,7 +625,7 @@ iot_action_t *iot_action_allocate(
 						int cmp_result;
 						cur_idx = (max_idx - min_idx) / 2u + min_idx;
 						cmp_result = os_strncasecmp( name,
-							lib->action_ptr[cur_idx]->name,
+							action_ptr[cur_idx]->name,
 							IOT_NAME_MAX_LEN );
 						if ( cmp_result > 0 )
 						{
@@ -251,11 +637,15 @@ iot_action_t *iot_action_allocate(
 					}
 
 					/* insert into proper spot in list */
-					os_memmove( &lib->action_ptr[cur_idx + 1u],
-						&lib->action_ptr[cur_idx],
+					os_memmove( &action_ptr[cur_idx + 1u],
+						&action_ptr[cur_idx],
 						sizeof( struct iot_action * ) * (count - cur_idx) );
-					lib->action_ptr[cur_idx] = result;
+					action_ptr[cur_idx] = result;
 					++lib->action_count;
+
+					/* room was reserved above */
+					iot_common_index_insert( &lib->action_index,
+						result );
 				}
 #ifndef IOT_STACK_ONLY
 				else if ( is_in_heap )
@@ -270,7 +660,420 @@ iot_action_t *iot_action_allocate(
 		else
 			IOT_LOG( lib, IOT_LOG_ERROR,
 				"no remaining space (max: %u) for action: %s",
-				IOT_ACTION_MAX, name );
+				(unsigned int)max, name );
+	}
+	return result;
+}
+
+#ifdef IOT_SPAWN_SUPPORT
+iot_bool_t iot_action_command_argv(
+	const struct iot_action *action,
+	const struct iot_action_request *request,
+	const char **argv,
+	char *buf,
+	size_t len )
+{
+	iot_bool_t result = IOT_FALSE;
+	const char *const command = action->command;
+	if ( os_strpbrk( command, IOT_ACTION_COMMAND_SHELL_CHARACTERS ) == NULL &&
+		os_strlen( command ) < len )
+	{
+		size_t argc = 0u;
+		size_t i;
+		char *pos = buf;
+		char *word;
+
+		/* split the command into words */
+		os_strncpy( buf, command, len );
+		result = IOT_TRUE;
+		while ( *pos != '\0' )
+		{
+			while ( *pos == ' ' || *pos == '\t' )
+			{
+				*pos = '\0';
+				++pos;
+			}
+			word = pos;
+			while ( *pos != '\0' && *pos != ' ' && *pos != '\t' )
+				++pos;
+			if ( pos != word )
+			{
+				if ( argc < IOT_ACTION_COMMAND_ARGV_MAX )
+					argv[argc] = word;
+				else
+					result = IOT_FALSE;
+				++argc;
+			}
+		}
+		if ( argc == 0u )
+			result = IOT_FALSE;
+		++pos;
+
+		/* each parameter is a single argument */
+		for ( i = 0u; result != IOT_FALSE &&
+			i < request->parameter_count; ++i )
+		{
+			const struct iot_action_parameter *const p =
+				&request->parameter[i];
+			const size_t space_left = len - (size_t)( pos - buf );
+			int name_len = 0;
+
+			result = IOT_FALSE;
+			if ( argc < IOT_ACTION_COMMAND_ARGV_MAX &&
+				space_left > 0u )
+			{
+				if ( *p->name != '\0' )
+					name_len = os_snprintf( pos, space_left,
+						"--%s=", p->name );
+				if ( name_len >= 0 &&
+					(size_t)name_len < space_left )
+					result = iot_action_command_value(
+						&p->data, pos + name_len,
+						space_left - (size_t)name_len,
+						IOT_FALSE );
+			}
+			if ( result != IOT_FALSE )
+			{
+				iot_action_parameter_adjustment( pos, "\r\n" );
+				argv[argc] = pos;
+				++argc;
+				pos += os_strlen( pos ) + 1u;
+			}
+		}
+		if ( result != IOT_FALSE )
+			argv[argc] = NULL;
+	}
+	return result;
+}
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
+void iot_action_command_line(
+	const struct iot_action *action,
+	const struct iot_action_request *request,
+	char *buf,
+	size_t len )
+{
+	const size_t max_len = len - 1u;
+	size_t i;
+
+	os_memzero( buf, len );
+	os_strncpy( buf, action->command, max_len );
+	buf[ max_len ] = '\0';
+	for ( i = 0u; i < request->parameter_count; ++i )
+	{
+		const size_t cur_len = os_strlen( buf );
+		const struct iot_action_parameter *p =
+			&request->parameter[i];
+
+		size_t space_left = max_len - cur_len;
+		char* param_pos = &buf[cur_len];
+		if ( space_left > 0u )
+		{
+			*param_pos = ' ';
+			--space_left;
+			++param_pos;
+			if ( *p->name != '\0' )
+			{
+				const size_t name_len =
+					os_strlen( p->name ) + 3u;
+				if ( space_left > name_len )
+				{
+					os_snprintf( param_pos, space_left,
+						"--%s=", p->name );
+					space_left -= name_len;
+					param_pos += name_len;
+				}
+			}
+		}
+		iot_action_command_value( &p->data, param_pos,
+			space_left, IOT_TRUE );
+	}
+
+	/* base64 encoded string, may contain "\r\n" characters.
+	 * Some OSs, (i.e. Windows), will next execute if the
+	 * line contains "\r\n".
+	 * Remove the CRLF in command parameter.
+	 */
+	iot_action_parameter_adjustment( buf, "\r\n" );
+}
+
+#ifdef IOT_SPAWN_SUPPORT
+void iot_action_command_output(
+	void *user_data,
+	iot_bool_t is_err,
+	const char *buf,
+	size_t len )
+{
+	struct iot_action_command_stream *const stream =
+		(struct iot_action_command_stream *)user_data;
+	iot_timestamp_t now = 0u;
+	size_t i = 0u;
+
+	if ( is_err != IOT_FALSE )
+		i = 1u;
+	stream->total[i] += len;
+	while ( len > 0u )
+	{
+		size_t copy = IOT_ACTION_COMMAND_STREAM_CHUNK - stream->len[i];
+		if ( copy > len )
+			copy = len;
+		os_memcpy( &stream->buf[i][stream->len[i]], buf, copy );
+		stream->len[i] += copy;
+		buf += copy;
+		len -= copy;
+		if ( stream->len[i] == IOT_ACTION_COMMAND_STREAM_CHUNK )
+			iot_action_command_output_flush( stream, i, IOT_FALSE );
+	}
+
+	os_time( &now, NULL );
+	if ( now - stream->last >= IOT_ACTION_COMMAND_STREAM_INTERVAL )
+	{
+		iot_action_command_output_flush( stream, 0u, IOT_FALSE );
+		iot_action_command_output_flush( stream, 1u, IOT_FALSE );
+	}
+}
+
+void iot_action_command_output_flush(
+	struct iot_action_command_stream *stream,
+	size_t i,
+	iot_bool_t all )
+{
+	size_t len = stream->len[i];
+
+	/* publish complete lines, unless a single line fills the chunk */
+	if ( all == IOT_FALSE )
+	{
+		while ( len > 0u && stream->buf[i][len - 1u] != '\n' )
+			--len;
+		if ( len == 0u &&
+			stream->len[i] == IOT_ACTION_COMMAND_STREAM_CHUNK )
+			len = stream->len[i];
+	}
+
+	if ( len > 0u )
+	{
+		const struct iot_action *const action = stream->action;
+		char msg[ IOT_NAME_MAX_LEN + IOT_ACTION_COMMAND_STREAM_CHUNK +
+			16u ];
+		size_t msg_len = len;
+		const char *source = "";
+
+		if ( stream->buf[i][msg_len - 1u] == '\n' )
+			--msg_len;
+		if ( i != 0u )
+			source = " (stderr)";
+		os_snprintf( msg, sizeof( msg ), "%s%s: %.*s", action->name,
+			source, (int)msg_len, stream->buf[i] );
+		if ( iot_event_publish( action->lib, NULL, NULL, msg ) !=
+			IOT_STATUS_SUCCESS )
+			IOT_LOG( action->lib, IOT_LOG_WARNING,
+				"Failed to publish output of command \"%s\"",
+				action->name );
+
+		stream->len[i] -= len;
+		os_memmove( stream->buf[i], &stream->buf[i][len],
+			stream->len[i] );
+		os_time( &stream->last, NULL );
+	}
+}
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
+iot_status_t iot_action_command_result(
+	const struct iot_action *action,
+	struct iot_action_request *request,
+	int return_code,
+	const char *std_out,
+	const char *std_err )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	if ( !( action->flags & IOT_ACTION_NO_RETURN ) )
+	{
+		const char * const output_params[2u] = {
+			IOT_ACTION_COMMAND_STDOUT,
+			IOT_ACTION_COMMAND_STDERR,
+		};
+		size_t i;
+
+		/* return the return code from the script */
+		iot_action_request_parameter_set( request,
+			IOT_ACTION_COMMAND_RETVAL,
+			IOT_TYPE_INT32, return_code );
+		/* if stdout or stderr contained data update
+		   the output parameters */
+		for ( i = 0u; i < 2u; ++i )
+		{
+			const char *buf = std_out;
+			if ( i != 0u )
+				buf = std_err;
+			if ( buf && buf[0] != '\0' )
+			{
+				iot_action_request_parameter_set(
+					request,
+					output_params[i],
+					IOT_TYPE_STRING,
+					buf );
+			}
+		}
+	}
+	IOT_LOG( action->lib, IOT_LOG_INFO,
+		"Command \"%s\", exited with: %d",
+		action->name, return_code );
+	if ( return_code != 0 )
+		result = IOT_STATUS_EXECUTION_ERROR;
+	return result;
+}
+
+iot_bool_t iot_action_command_value(
+	const struct iot_data *data,
+	char *buf,
+	size_t len,
+	iot_bool_t quote )
+{
+	iot_bool_t result = IOT_FALSE;
+	int written = -1;
+	switch( data->type )
+	{
+		case IOT_TYPE_NULL:
+			written = os_snprintf( buf, len, "[NULL]" );
+			break;
+		case IOT_TYPE_BOOL:
+			written = os_snprintf( buf, len, "%u",
+				data->value.boolean == IOT_FALSE ? 0u : 1u );
+			break;
+		case IOT_TYPE_FLOAT32:
+			written = os_snprintf( buf, len, "%f",
+				(double)data->value.float32 );
+			break;
+		case IOT_TYPE_FLOAT64:
+			written = os_snprintf( buf, len, "%f",
+				data->value.float64 );
+			break;
+		case IOT_TYPE_INT8:
+			written = os_snprintf( buf, len, "%hhi",
+				data->value.int8 );
+			break;
+		case IOT_TYPE_INT16:
+			written = os_snprintf( buf, len, "%hi",
+				data->value.int16 );
+			break;
+		case IOT_TYPE_INT32:
+			written = os_snprintf( buf, len, "%i",
+				data->value.int32 );
+			break;
+		case IOT_TYPE_INT64:
+			written = os_snprintf( buf, len, "%lli",
+				(long long int)data->value.int64 );
+			break;
+		case IOT_TYPE_LOCATION:
+		{
+			iot_float64_t lon = 0.0;
+			iot_float64_t lat = 0.0;
+			if ( data->value.location )
+			{
+				lon = data->value.location->longitude;
+				lat = data->value.location->latitude;
+			}
+			written = os_snprintf( buf, len, "[%f,%f]",
+				lon, lat );
+			break;
+		}
+		case IOT_TYPE_RAW:
+		{
+			/* convert data to base64 */
+			const size_t min_size =
+				iot_base64_encode_size(
+					data->value.raw.length );
+			if ( len > min_size )
+			{
+				iot_base64_encode(
+					buf,
+					len,
+					(const uint8_t*)data->value.raw.ptr,
+					data->value.raw.length );
+				buf[min_size] = '\0';
+				result = IOT_TRUE;
+			}
+			break;
+		}
+		case IOT_TYPE_STRING:
+		{
+			const char *s = data->value.string;
+			if ( quote == IOT_FALSE )
+				written = os_snprintf( buf, len, "%s", s );
+			else if ( len > os_strlen( s ) + 2u )
+			{
+				*buf = '"';
+				++buf;
+				--len;
+				while ( len > 0u && *s != '\0' )
+				{
+					if ( *s == '"' || *s == '\\' )
+					{
+						if ( len > 1u )
+						{
+							*buf = '\\';
+							++buf;
+							*buf = *s;
+							++buf;
+							len -= 2u;
+							++s;
+						}
+						else
+							len = 0u;
+					}
+					else
+					{
+						*buf = *s;
+						++buf;
+						--len;
+						++s;
+					}
+				}
+				if ( len > 0u )
+				{
+					*buf = '"';
+					++buf;
+					--len;
+					if ( len > 0u )
+					{
+						*buf = '\0';
+						result = IOT_TRUE;
+					}
+				}
+			}
+			break;
+		}
+		case IOT_TYPE_UINT8:
+			written = os_snprintf( buf, len, "%hhu",
+				data->value.uint8 );
+			break;
+		case IOT_TYPE_UINT16:
+			written = os_snprintf( buf, len, "%hu",
+				data->value.uint16 );
+			break;
+		case IOT_TYPE_UINT32:
+			written = os_snprintf( buf, len, "%u",
+				data->value.uint32 );
+			break;
+		case IOT_TYPE_UINT64:
+			written = os_snprintf( buf, len, "%llu",
+				(long long unsigned int)data->value.uint64 );
+			break;
+	}
+	if ( written >= 0 && (size_t)written < len )
+		result = IOT_TRUE;
+	return result;
+}
+
+iot_status_t iot_action_concurrency_set(
+	iot_action_t *action,
+	iot_uint32_t max )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( action )
+	{
+		action->concurrency_max = max;
+		result = IOT_STATUS_SUCCESS;
 	}
 	return result;
 }
@@ -413,8 +1216,16 @@ iot_status_t iot_action_execute(
 						action->user_data );
 				else if ( action->command &&
 					*action->command != '\0' )
-					result = iot_action_execute_command(
+				{
+#ifdef IOT_SPAWN_SUPPORT
+					result = iot_action_execute_spawn(
 						action, request, max_time_out );
+					if ( result == IOT_STATUS_NOT_SUPPORTED )
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+						result = iot_action_execute_command(
+							action, request,
+							max_time_out );
+				}
 				else
 				{
 					iot_action_request_set_status(
@@ -505,186 +1316,10 @@ iot_status_t iot_action_execute_command(
 			char buf_stderr[ IOT_ACTION_COMMAND_OUTPUT_MAX_LEN ];
 			char buf_stdout[ IOT_ACTION_COMMAND_OUTPUT_MAX_LEN ];
 			char command_with_params[PATH_MAX + 1u];
-			size_t i;
-			const char * const output_params[2u] = {
-				IOT_ACTION_COMMAND_STDOUT,
-				IOT_ACTION_COMMAND_STDERR,
-			};
 			os_status_t system_res;
 
-			os_memzero( command_with_params, PATH_MAX + 1u );
-			os_strncpy( command_with_params, command_path,
-				PATH_MAX );
-			command_with_params[ PATH_MAX ] = '\0';
-			for ( i = 0u; i < request->parameter_count; ++i )
-			{
-				const size_t cur_len =
-					os_strlen( command_with_params );
-				const struct iot_action_parameter *p =
-					&request->parameter[i];
-
-				size_t space_left = PATH_MAX - cur_len;
-				char* param_pos = &command_with_params[cur_len];
-				if ( space_left > 0u )
-				{
-					*param_pos = ' ';
-					--space_left;
-					++param_pos;
-					if ( *p->name != '\0' )
-					{
-						const size_t name_len =
-							os_strlen( p->name ) + 3u;
-						if ( space_left > name_len )
-						{
-							os_snprintf(
-								param_pos,
-								space_left,
-								"--%s=",
-								p->name );
-							space_left -= name_len;
-							param_pos += name_len;
-						}
-					}
-				}
-				switch( p->data.type )
-				{
-					case IOT_TYPE_NULL:
-						os_snprintf( param_pos,
-							space_left, "[NULL]" );
-						break;
-					case IOT_TYPE_BOOL:
-						os_snprintf( param_pos,
-							space_left, "%u",
-							p->data.value.boolean ==
-							IOT_FALSE ? 0u : 1u );
-						break;
-					case IOT_TYPE_FLOAT32:
-						os_snprintf( param_pos,
-							space_left, "%f",
-							(double)p->data.value.float32 );
-						break;
-					case IOT_TYPE_FLOAT64:
-						os_snprintf( param_pos,
-							space_left, "%f",
-							p->data.value.float64 );
-						break;
-					case IOT_TYPE_INT8:
-						os_snprintf( param_pos,
-							space_left, "%hhi",
-							p->data.value.int8 );
-						break;
-					case IOT_TYPE_INT16:
-						os_snprintf( param_pos,
-							space_left, "%hi",
-							p->data.value.int16 );
-						break;
-					case IOT_TYPE_INT32:
-						os_snprintf( param_pos,
-							space_left, "%i",
-							p->data.value.int32 );
-						break;
-					case IOT_TYPE_INT64:
-						os_snprintf( param_pos,
-							space_left, "%lli",
-							(long long int)p->data.value.int64 );
-						break;
-					case IOT_TYPE_LOCATION:
-					{
-						iot_float64_t lon = 0.0;
-						iot_float64_t lat = 0.0;
-						if ( p->data.value.location )
-						{
-							lon = p->data.value.location->longitude;
-							lat = p->data.value.location->latitude;
-						}
-						os_snprintf( param_pos,
-							space_left, "[%f,%f]",
-							lon, lat );
-						break;
-					}
-					case IOT_TYPE_RAW:
-					{
-						/* convert data to base64 */
-						const size_t min_size =
-							iot_base64_encode_size(
-								p->data.value.raw.length );
-						if ( space_left > min_size )
-						{
-							iot_base64_encode(
-								param_pos,
-								space_left,
-								(const uint8_t*)p->data.value.raw.ptr,
-								p->data.value.raw.length );
-							param_pos[min_size] = '\0';
-							param_pos += min_size;
-						}
-						break;
-					}
-					case IOT_TYPE_STRING:
-					{
-						const char *s = p->data.value.string;
-						if ( space_left > os_strlen( s ) + 2u )
-						{
-							*param_pos = '"';
-							++param_pos;
-							--space_left;
-							while ( space_left > 0u && *s != '\0' )
-							{
-								if ( *s == '"' || *s == '\\' )
-								{
-									if ( space_left > 1u )
-									{
-										*param_pos = '\\';
-										++param_pos;
-										*param_pos = *s;
-										++param_pos;
-										space_left -= 2u;
-										++s;
-									}
-									else
-										space_left = 0u;
-								}
-								else
-								{
-									*param_pos = *s;
-									++param_pos;
-									--space_left;
-									++s;
-								}
-							}
-							if ( space_left > 0u )
-							{
-								*param_pos = '"';
-								++param_pos;
-								--space_left;
-								if ( space_left > 0u )
-									*param_pos = '\0';
-							}
-						}
-						break;
-					}
-					case IOT_TYPE_UINT8:
-						os_snprintf( param_pos,
-							space_left, "%hhu",
-							p->data.value.uint8 );
-						break;
-					case IOT_TYPE_UINT16:
-						os_snprintf( param_pos,
-							space_left, "%hu",
-							p->data.value.uint16 );
-						break;
-					case IOT_TYPE_UINT32:
-						os_snprintf( param_pos,
-							space_left, "%u",
-							p->data.value.uint32 );
-						break;
-					case IOT_TYPE_UINT64:
-						os_snprintf( param_pos,
-							space_left, "%llu",
-							(long long unsigned int)p->data.value.uint64 );
-						break;
-				}
-			}
+			iot_action_command_line( action, request,
+				command_with_params, PATH_MAX + 1u );
 
 			/* script is returnable, set the output buffers */
 			if ( !( action->flags & IOT_ACTION_NO_RETURN ) )
@@ -695,14 +1330,6 @@ iot_status_t iot_action_execute_command(
 				args.opts.block.std_err.len = IOT_ACTION_COMMAND_OUTPUT_MAX_LEN;
 			}
 
-			/* base64 encoded string, may contain "\r\n" characters.
-			 * Some OSs, (i.e. Windows), will next execute if the
-			 * line contains "\r\n".
-			 * Remove the CRLF in command parameter.
-			 */
-			iot_action_parameter_adjustment( command_with_params,
-				"\r\n" );
-
 			IOT_LOG( action->lib, IOT_LOG_DEBUG,
 				"Executing command: %s", command_with_params );
 
@@ -721,38 +1348,10 @@ iot_status_t iot_action_execute_command(
 			args.opts.block.max_wait_time = max_time_out;
 			system_res = os_system_run( &args );
 			if ( system_res == OS_STATUS_SUCCESS )
-			{
-				if ( !( action->flags & IOT_ACTION_NO_RETURN ) )
-				{
-					/* return the return code from the script */
-					iot_action_request_parameter_set( request,
-						IOT_ACTION_COMMAND_RETVAL,
-						IOT_TYPE_INT32, args.return_code );
-					/* if stdout or stderr contained data update
-					   the output parameters */
-					for ( i = 0u; i < 2u; ++i )
-					{
-						char *buf = args.opts.block.std_out.buf;
-						if ( i != 0u )
-							buf = args.opts.block.std_err.buf;
-						if ( buf && buf[0] != '\0' )
-						{
-							iot_action_request_parameter_set(
-								request,
-								output_params[i],
-								IOT_TYPE_STRING,
-								buf );
-						}
-					}
-				}
-				IOT_LOG( action->lib, IOT_LOG_INFO,
-					"Command \"%s\", exited with: %d",
-					action->name, args.return_code );
-				if ( args.return_code != 0 )
-					result = IOT_STATUS_EXECUTION_ERROR;
-				else
-					result = IOT_STATUS_SUCCESS;
-			}
+				result = iot_action_command_result( action,
+					request, args.return_code,
+					args.opts.block.std_out.buf,
+					args.opts.block.std_err.buf );
 			else if ( ( action->flags & IOT_ACTION_NO_RETURN ) &&
 				system_res == OS_STATUS_INVOKED )
 			{
@@ -775,6 +1374,145 @@ iot_status_t iot_action_execute_command(
 	return result;
 }
 
+#ifdef IOT_SPAWN_SUPPORT
+iot_status_t iot_action_execute_spawn(
+	const struct iot_action *action,
+	struct iot_action_request *request,
+	iot_millisecond_t max_time_out )
+{
+	iot_status_t result = IOT_STATUS_NOT_SUPPORTED;
+	iot_t *const lib = action->lib;
+	const char *argv[ IOT_ACTION_COMMAND_ARGV_MAX + 1u ];
+	char arg_buf[ PATH_MAX + 1u ];
+	iot_bool_t stream_output = IOT_FALSE;
+
+	/* output can only be streamed if the command is waited on */
+	if ( ( action->flags & IOT_ACTION_STREAM_OUTPUT ) &&
+		!( action->flags & IOT_ACTION_NO_RETURN ) )
+		stream_output = IOT_TRUE;
+
+	/* commands not waited on need the helper process to reap them */
+	if ( ( lib->command_launch != IOT_COMMAND_LAUNCH_SHELL ||
+	       stream_output != IOT_FALSE ) &&
+		( !( action->flags & IOT_ACTION_NO_RETURN ) ||
+		  lib->spawn_helper_pid > 0 ) )
+	{
+		result = IOT_STATUS_SUCCESS;
+		if ( lib->command_launch == IOT_COMMAND_LAUNCH_SHELL ||
+			iot_action_command_argv( action, request, argv,
+				arg_buf, PATH_MAX + 1u ) == IOT_FALSE )
+		{
+			/* to stream its output, run the shell directly */
+			result = IOT_STATUS_NOT_SUPPORTED;
+			if ( stream_output != IOT_FALSE )
+			{
+				iot_action_command_line( action, request,
+					arg_buf, PATH_MAX + 1u );
+				argv[0] = IOT_ACTION_COMMAND_SHELL;
+				argv[1] = "-c";
+				argv[2] = arg_buf;
+				argv[3] = NULL;
+				result = IOT_STATUS_SUCCESS;
+			}
+		}
+	}
+
+	if ( result == IOT_STATUS_SUCCESS )
+	{
+		struct iot_action_command_stream stream;
+		struct iot_spawn_args args;
+		char buf_stderr[ IOT_ACTION_COMMAND_OUTPUT_MAX_LEN ];
+		char buf_stdout[ IOT_ACTION_COMMAND_OUTPUT_MAX_LEN ];
+
+		os_memzero( &args, sizeof( struct iot_spawn_args ) );
+		args.argv = argv;
+		if ( !( action->flags & IOT_ACTION_NO_RETURN ) )
+		{
+			args.block = IOT_TRUE;
+			args.std_out = buf_stdout;
+			args.std_out_len = IOT_ACTION_COMMAND_OUTPUT_MAX_LEN;
+			args.std_err = buf_stderr;
+			args.std_err_len = IOT_ACTION_COMMAND_OUTPUT_MAX_LEN;
+		}
+		if ( stream_output != IOT_FALSE )
+		{
+			os_memzero( &stream,
+				sizeof( struct iot_action_command_stream ) );
+			stream.action = action;
+			os_time( &stream.last, NULL );
+			args.output = iot_action_command_output;
+			args.user_data = &stream;
+		}
+
+		/* if there is a time limit and it's less then our
+		 * maximum time to wait then set it to the action
+		 * limit */
+		if ( !( action->flags & IOT_ACTION_NO_TIME_LIMIT )
+			&& ( max_time_out == 0u ||
+			     max_time_out > action->time_limit ) )
+		{
+			max_time_out = action->time_limit;
+		}
+		args.max_time_out = max_time_out;
+
+		IOT_LOG( lib, IOT_LOG_DEBUG,
+			"Spawning command: %s", argv[0] );
+		result = iot_spawn_run( action->lib, &args );
+
+		/* publish what is left, then a summary */
+		if ( stream_output != IOT_FALSE &&
+			( result == IOT_STATUS_SUCCESS ||
+			  result == IOT_STATUS_TIMED_OUT ) )
+		{
+			char msg[ IOT_NAME_MAX_LEN + 128u ];
+
+			iot_action_command_output_flush( &stream, 0u, IOT_TRUE );
+			iot_action_command_output_flush( &stream, 1u, IOT_TRUE );
+			if ( result == IOT_STATUS_SUCCESS )
+				os_snprintf( msg, sizeof( msg ),
+					"%s: exited with %d, %lu bytes of "
+					"output (%lu on stderr)", action->name,
+					args.return_code,
+					(unsigned long)( stream.total[0] +
+						stream.total[1] ),
+					(unsigned long)stream.total[1] );
+			else
+				os_snprintf( msg, sizeof( msg ),
+					"%s: timed out, %lu bytes of output "
+					"(%lu on stderr)", action->name,
+					(unsigned long)( stream.total[0] +
+						stream.total[1] ),
+					(unsigned long)stream.total[1] );
+			iot_event_publish( action->lib, NULL, NULL, msg );
+		}
+
+		if ( result == IOT_STATUS_SUCCESS )
+			result = iot_action_command_result( action, request,
+				args.return_code, args.std_out, args.std_err );
+		else if ( result == IOT_STATUS_INVOKED )
+			IOT_LOG( lib, IOT_LOG_INFO,
+				"Command \"%s\", has been invoked",
+				action->name );
+		else if ( result != IOT_STATUS_NOT_SUPPORTED )
+			IOT_LOG( lib, IOT_LOG_ERROR,
+				"Command \"%s\" failed, reason: %s",
+				action->name, iot_error( result ) );
+	}
+	return result;
+}
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
+iot_action_t *iot_action_find(
+	const iot_t *lib,
+	const char *name )
+{
+	iot_action_t *result = NULL;
+	if ( lib && name )
+		result = (iot_action_t *)iot_common_index_find(
+			&lib->action_index, name );
+	return result;
+}
+
 iot_status_t iot_action_flags_set(
 	iot_action_t *action,
 	iot_uint8_t flags )
@@ -798,7 +1536,9 @@ iot_status_t iot_action_free( iot_action_t *action,
 		result = IOT_STATUS_NOT_INITIALIZED;
 		if ( lib )
 		{
-			unsigned int i, max;
+			struct iot_action **const action_ptr =
+				IOT_ACTION_PTR( lib );
+			iot_uint32_t i, max;
 			result = iot_action_deregister( action, NULL,
 				max_time_out );
 
@@ -807,7 +1547,7 @@ iot_status_t iot_action_free( iot_action_t *action,
 				/* find action within the library */
 				max = lib->action_count;
 				for ( i = 0u; i < max &&
-					lib->action_ptr[ i ] != action;
+					action_ptr[ i ] != action;
 					++i );
 
 				result = IOT_STATUS_NOT_FOUND;
@@ -832,9 +1572,11 @@ iot_status_t iot_action_free( iot_action_t *action,
 #endif /* ifndef IOT_STACK_ONLY */
 
 					/* remove from client */
+					iot_common_index_remove( &lib->action_index,
+						action );
 					os_memmove(
-						&lib->action_ptr[ i ],
-						&lib->action_ptr[ i + 1u ],
+						&action_ptr[ i ],
+						&action_ptr[ i + 1u ],
 						sizeof( struct iot_action * ) * ( max - i - 1u ) );
 
 					/* set lib to NULL */
@@ -843,7 +1585,7 @@ iot_status_t iot_action_free( iot_action_t *action,
 					/* clear/free the action */
 					--lib->action_count;
 #ifdef IOT_STACK_ONLY
-					lib->action_ptr[
+					action_ptr[
 						lib->action_count] = action;
 #else /* ifdef IOT_STACK_ONLY */
 					os_free_null( (void **)&action->option );
@@ -852,12 +1594,12 @@ iot_status_t iot_action_free( iot_action_t *action,
 					os_free_null( (void **)&action->command );
 					if ( action->is_in_heap == IOT_FALSE )
 					{
-						lib->action_ptr[
+						action_ptr[
 							lib->action_count] = action;
 					}
 					else
 					{
-						lib->action_ptr[
+						action_ptr[
 							lib->action_count] = NULL;
 						os_free_null( (void **)&action );
 					}
@@ -870,6 +1612,96 @@ iot_status_t iot_action_free( iot_action_t *action,
 	return result;
 }
 
+#ifdef IOT_THREAD_SUPPORT
+void iot_action_lock(
+	iot_t *lib,
+	const iot_action_t *action )
+{
+	if ( action->flags & IOT_ACTION_EXCLUSIVE_APP )
+		os_thread_rwlock_write_lock(
+			&lib->worker_thread_exclusive_lock );
+	else
+	{
+		iot_uint8_t i;
+		os_thread_rwlock_read_lock(
+			&lib->worker_thread_exclusive_lock );
+		for ( i = 0u; i < IOT_LOCK_GROUP_MAX; ++i )
+		{
+			const iot_uint32_t bit = (iot_uint32_t)1u << i;
+			if ( action->lock_exclusive & bit )
+				os_thread_rwlock_write_lock(
+					&lib->lock_group[i].lock );
+			else if ( action->lock_shared & bit )
+				os_thread_rwlock_read_lock(
+					&lib->lock_group[i].lock );
+		}
+	}
+}
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+iot_status_t iot_action_lock_group_add(
+	iot_action_t *action,
+	const char *group,
+	iot_bool_t exclusive )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( action && action->lib && group && *group != '\0' )
+	{
+		struct iot *const lib = action->lib;
+		iot_uint8_t group_idx = lib->lock_group_count;
+		iot_uint8_t i;
+
+#ifdef IOT_THREAD_SUPPORT
+		if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+			os_thread_mutex_lock( &lib->worker_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		for ( i = 0u; group_idx == lib->lock_group_count &&
+			i < lib->lock_group_count; ++i )
+		{
+			if ( os_strncmp( lib->lock_group[i].name, group,
+				IOT_NAME_MAX_LEN ) == 0 )
+				group_idx = i;
+		}
+
+		result = IOT_STATUS_FULL;
+		if ( group_idx < lib->lock_group_count )
+			result = IOT_STATUS_SUCCESS;
+		else if ( group_idx < IOT_LOCK_GROUP_MAX )
+		{
+			struct iot_lock_group *const lock_group =
+				&lib->lock_group[group_idx];
+			os_strncpy( lock_group->name, group, IOT_NAME_MAX_LEN );
+			lock_group->name[IOT_NAME_MAX_LEN] = '\0';
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_rwlock_create( &lock_group->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+			++lib->lock_group_count;
+			result = IOT_STATUS_SUCCESS;
+		}
+
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			const iot_uint32_t bit = (iot_uint32_t)1u << group_idx;
+			if ( exclusive != IOT_FALSE )
+			{
+				action->lock_exclusive |= bit;
+				action->lock_shared &= ~bit;
+			}
+			else if ( !( action->lock_exclusive & bit ) )
+				action->lock_shared |= bit;
+		}
+		else
+			IOT_LOG( lib, IOT_LOG_ERROR,
+				"no remaining space (max: %u) for lock group: %s",
+				(unsigned int)IOT_LOCK_GROUP_MAX, group );
+#ifdef IOT_THREAD_SUPPORT
+		if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+			os_thread_mutex_unlock( &lib->worker_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+	return result;
+}
+
 iot_status_t iot_action_option_get(
 	const iot_action_t *action,
 	const char *name,
@@ -1238,66 +2070,83 @@ iot_status_t iot_action_process(
 	if ( lib )
 	{
 		struct iot_action_request *request = NULL;
+		iot_action_t *action = NULL;
 
 		result = IOT_STATUS_NOT_FOUND;
 #ifdef IOT_THREAD_SUPPORT
 		if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
-		{
 			os_thread_mutex_lock( &lib->worker_mutex );
-			/* nothing to do, so wait for signal to do work */
-			if ( lib->request_queue_wait_count == 0u )
-				os_thread_condition_wait(
-					&lib->worker_signal,
-					&lib->worker_mutex );
-		}
 #endif /* ifdef IOT_THREAD_SUPPORT */
-		/* if this thread was not woke just to quit,
-		   then there must be a request */
-		if ( lib->request_queue_wait_count > 0u )
-		{
-			request = lib->request_queue_wait[0u];
-			--lib->request_queue_wait_count;
-
-			/* move all items up by 1 in request wait queue */
-			os_memcpy( &lib->request_queue_wait[0u],
-				&lib->request_queue_wait[1u],
-				sizeof( struct iot_action_request *) *
-					 lib->request_queue_wait_count );
-		}
+		request = iot_action_request_next( lib, &action );
 #ifdef IOT_THREAD_SUPPORT
 		if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+		{
+			/* nothing to do, so wait for signal to do work */
+			if ( !request && lib->to_quit == IOT_FALSE )
+			{
+				++lib->worker_idle;
+				/* workers beyond the minimum only wait for a
+				 * while, so the pool shrinks when idle */
+				if ( lib->worker_count > lib->worker_min )
+				{
+					if ( os_thread_condition_timed_wait(
+						&lib->worker_signal,
+						&lib->worker_mutex,
+						lib->worker_idle_time ) ==
+						OS_STATUS_TIMED_OUT )
+						result = IOT_STATUS_TIMED_OUT;
+				}
+				else
+					os_thread_condition_wait(
+						&lib->worker_signal,
+						&lib->worker_mutex );
+				--lib->worker_idle;
+
+				/* if this thread was not woke just to quit,
+				   then there may be a request */
+				request = iot_action_request_next( lib,
+					&action );
+			}
 			os_thread_mutex_unlock( &lib->worker_mutex );
+		}
 #endif /* ifdef IOT_THREAD_SUPPORT */
 
 		if ( request )
 		{
-			size_t i;
-			const iot_action_t *action = NULL;
 			iot_status_t action_result = IOT_STATUS_NOT_FOUND;
-			for ( i = 0u; action == NULL &&
-				i < lib->action_count &&
-				i < IOT_ACTION_MAX; ++i )
+			iot_bool_t deferrable = IOT_FALSE;
+
+			if ( lib->to_quit == IOT_FALSE && action )
 			{
-				action = lib->action_ptr[i];
-				if ( action && action->name )
+				/* a callback may keep the request to complete it
+				 * later, possibly before it returns, so it is
+				 * tracked as deferred before the callback runs */
+				if ( action->callback &&
+					!( action->flags & IOT_ACTION_NO_RETURN ) )
 				{
-					if ( os_strncasecmp( action->name,
-						request->name,
-						IOT_NAME_MAX_LEN ) != 0 )
-						action = NULL;
+					deferrable = IOT_TRUE;
+					request->deadline = 0u;
+					if ( request->time_limit > 0u &&
+						!( action->flags & IOT_ACTION_NO_TIME_LIMIT ) )
+					{
+						os_time( &request->deadline, NULL );
+						request->deadline += request->time_limit;
+					}
+#ifdef IOT_THREAD_SUPPORT
+					if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+						os_thread_mutex_lock( &lib->worker_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+					request->deferred = IOT_ACTION_REQUEST_DEFERRED;
+					++lib->request_deferred_count;
+#ifdef IOT_THREAD_SUPPORT
+					if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+						os_thread_mutex_unlock( &lib->worker_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
 				}
-			}
 
-			if ( lib->to_quit == IOT_FALSE && action )
-			{
 #ifdef IOT_THREAD_SUPPORT
 				/* lock to support exclusive actions */
-				if ( action->flags & IOT_ACTION_EXCLUSIVE_APP )
-					os_thread_rwlock_write_lock(
-						&lib->worker_thread_exclusive_lock );
-				else
-					os_thread_rwlock_read_lock(
-						&lib->worker_thread_exclusive_lock );
+				iot_action_lock( lib, action );
 #endif /* ifdef IOT_THREAD_SUPPORT */
 				IOT_LOG( lib, IOT_LOG_DEBUG,
 					"Executing action: %s", action->name );
@@ -1305,13 +2154,9 @@ iot_status_t iot_action_process(
 					request, max_time_out );
 
 #ifdef IOT_THREAD_SUPPORT
-				/* done processing, unlock our operation */
-				if ( action->flags & IOT_ACTION_EXCLUSIVE_APP )
-					os_thread_rwlock_write_unlock(
-						&lib->worker_thread_exclusive_lock );
-				else
-					os_thread_rwlock_read_unlock(
-						&lib->worker_thread_exclusive_lock );
+				/* done processing, unlock our operation, locks
+				 * are not held while a deferred request waits */
+				iot_action_unlock( lib, action );
 #endif /* ifdef IOT_THREAD_SUPPORT */
 			}
 			else if ( lib->to_quit == IOT_FALSE )
@@ -1320,15 +2165,25 @@ iot_status_t iot_action_process(
 					"reason: %s", request->name,
 					iot_error( action_result ) );
 
-			/* send command execution result to the cloud */
-			iot_action_request_set_status( request,
-				action_result, NULL );
-			result = iot_plugin_perform( lib, NULL, &max_time_out,
-				IOT_OPERATION_ACTION_COMPLETE, action, request,
-				NULL );
+			if ( deferrable == IOT_FALSE )
+			{
+				/* send command execution result to the cloud */
+				iot_action_request_set_status( request,
+					action_result, NULL );
+				iot_plugin_perform( lib, NULL, &max_time_out,
+					IOT_OPERATION_ACTION_COMPLETE, action,
+					request, NULL );
 
-			/* free memory associated with the request */
-			iot_action_request_free( request );
+				/* free memory associated with the request */
+				iot_action_request_release( lib, action,
+					request );
+			}
+			else if ( action_result != IOT_STATUS_INVOKED )
+				/* callback returned its result directly */
+				iot_action_request_finish( action, request,
+					action_result, NULL, max_time_out );
+			/* otherwise the request now belongs to the callback,
+			 * it is finished by iot_action_request_complete */
 
 			result = IOT_STATUS_SUCCESS;
 		}
@@ -1438,13 +2293,26 @@ iot_action_request_t *iot_action_request_allocate(
 
 		if ( result )
 		{
+#ifdef IOT_STACK_ONLY
 			os_memzero( result, sizeof( struct iot_action_request ) );
 			result->lib = lib;
-#ifdef IOT_STACK_ONLY
+			result->arena = result->_arena;
+			result->option = result->_option;
+			result->parameter = result->_parameter;
 			result->name = result->_name;
 			result->source = result->_source;
 #else /* ifdef IOT_STACK_ONLY */
-			result->name = os_malloc( name_len + source_len + 2u );
+			/* the arena of a recycled slot is reused */
+			char *const arena = result->arena;
+			os_memzero( result, sizeof( struct iot_action_request ) );
+			result->lib = lib;
+			result->arena = arena;
+			if ( !result->arena )
+				result->arena = os_malloc(
+					IOT_ACTION_REQUEST_ARENA_SIZE );
+			if ( result->arena )
+				result->name = iot_action_request_arena_storage(
+					result, name_len + source_len + 2u );
 			if ( result->name )
 			{
 				if ( source_len > 0u )
@@ -1475,6 +2343,229 @@ iot_action_request_t *iot_action_request_allocate(
 	return result;
 }
 
+void *iot_action_request_arena_alloc(
+	iot_action_request_t *request,
+	size_t size )
+{
+	void *result = NULL;
+	if ( request && request->arena )
+	{
+		const size_t offset = ( request->arena_used +
+			IOT_ACTION_REQUEST_ARENA_ALIGN - 1u ) &
+			~( IOT_ACTION_REQUEST_ARENA_ALIGN - 1u );
+		if ( offset <= IOT_ACTION_REQUEST_ARENA_SIZE &&
+			size <= IOT_ACTION_REQUEST_ARENA_SIZE - offset )
+		{
+			result = &request->arena[offset];
+			request->arena_last = offset;
+			request->arena_used = offset + size;
+		}
+	}
+	return result;
+}
+
+#ifndef IOT_STACK_ONLY
+void iot_action_request_arena_free(
+	const struct iot_action_request *request,
+	void **ptr )
+{
+	if ( iot_action_request_arena_owns( request, *ptr ) != IOT_FALSE )
+		*ptr = NULL;
+	else
+		os_free_null( ptr );
+}
+
+void *iot_action_request_arena_grow(
+	struct iot_action_request *request,
+	void *ptr,
+	size_t count,
+	size_t size )
+{
+	void *result = ptr;
+	if ( iot_action_request_arena_owns( request, ptr ) != IOT_FALSE )
+	{
+		/* arrays in the arena have room for a multiple of
+		 * IOT_ACTION_REQUEST_ARENA_GROWTH items */
+		if ( count % IOT_ACTION_REQUEST_ARENA_GROWTH == 0u )
+		{
+			const size_t grow = size *
+				IOT_ACTION_REQUEST_ARENA_GROWTH;
+			if ( (size_t)( (char *)ptr - request->arena ) ==
+				request->arena_last &&
+				grow <= IOT_ACTION_REQUEST_ARENA_SIZE -
+					request->arena_used )
+				request->arena_used += grow;
+			else
+			{
+				result = iot_action_request_arena_alloc(
+					request, size *
+					( count + IOT_ACTION_REQUEST_ARENA_GROWTH ) );
+				if ( !result )
+					result = os_malloc( size * ( count + 1u ) );
+				if ( result )
+					os_memcpy( result, ptr, size * count );
+			}
+		}
+	}
+	else
+	{
+		result = NULL;
+		if ( !ptr )
+			result = iot_action_request_arena_alloc( request,
+				size * IOT_ACTION_REQUEST_ARENA_GROWTH );
+		if ( !result )
+			result = os_realloc( ptr, size * ( count + 1u ) );
+	}
+	return result;
+}
+#endif /* ifndef IOT_STACK_ONLY */
+
+iot_bool_t iot_action_request_arena_owns(
+	const struct iot_action_request *request,
+	const void *ptr )
+{
+	iot_bool_t result = IOT_FALSE;
+	if ( request->arena && ptr &&
+		(const char *)ptr >= request->arena &&
+		(const char *)ptr <
+			request->arena + IOT_ACTION_REQUEST_ARENA_SIZE )
+		result = IOT_TRUE;
+	return result;
+}
+
+#ifndef IOT_STACK_ONLY
+void *iot_action_request_arena_storage(
+	struct iot_action_request *request,
+	size_t size )
+{
+	void *result = iot_action_request_arena_alloc( request, size );
+	if ( !result )
+		result = os_malloc( size );
+	return result;
+}
+#endif /* ifndef IOT_STACK_ONLY */
+
+iot_status_t iot_action_request_complete(
+	iot_action_request_t *request,
+	iot_status_t status,
+	const char *message )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( request && request->lib )
+		result = iot_action_request_finish(
+			iot_action_find( request->lib, request->name ),
+			request, status, message, 0u );
+	return result;
+}
+
+iot_status_t iot_action_request_data_set(
+	struct iot_action_request *request,
+	struct iot_data *data,
+	iot_type_t type,
+	va_list args )
+{
+	iot_status_t result;
+	if ( type == IOT_TYPE_STRING )
+	{
+		va_list args_copy;
+		va_copy( args_copy, args );
+		result = iot_common_arg_set( data, IOT_FALSE, type, args_copy );
+		va_end( args_copy );
+		if ( result == IOT_STATUS_SUCCESS &&
+			iot_action_request_arena_owns( request,
+				data->value.string ) == IOT_FALSE )
+		{
+			const char *const src = data->value.string;
+			size_t len = 0u;
+			char *dest;
+			if ( src )
+				len = os_strlen( src );
+			dest = iot_action_request_arena_alloc( request,
+				len + 1u );
+			if ( dest )
+			{
+				if ( src )
+					os_memcpy( dest, src, len );
+				dest[len] = '\0';
+				data->value.string = dest;
+			}
+			else
+				/* copy onto the heap instead */
+				result = iot_common_arg_set( data, IOT_TRUE,
+					type, args );
+		}
+	}
+	else
+		result = iot_common_arg_set( data, IOT_TRUE, type, args );
+	return result;
+}
+
+iot_uint8_t iot_action_request_lane(
+	const iot_t *lib,
+	const char *name )
+{
+	iot_uint8_t result = IOT_ACTION_LANE_NORMAL;
+	if ( lib && name )
+	{
+		const iot_action_t *const action = iot_action_find( lib, name );
+		if ( action && ( action->flags & IOT_ACTION_PRIORITY_HIGH ) )
+			result = IOT_ACTION_LANE_HIGH;
+		else if ( action && ( action->flags & IOT_ACTION_PRIORITY_LOW ) )
+			result = IOT_ACTION_LANE_LOW;
+	}
+	return result;
+}
+
+struct iot_action_request *iot_action_request_next(
+	iot_t *lib,
+	iot_action_t **action )
+{
+	struct iot_action_request *result = NULL;
+	size_t lane;
+
+	*action = NULL;
+	for ( lane = 0u; !result && lib->request_queue_wait_count > 0u &&
+		lane < IOT_ACTION_LANE_COUNT; ++lane )
+	{
+		struct iot_action_request_ring *const ring =
+			&lib->request_queue_wait[lane];
+		iot_uint8_t i;
+		for ( i = 0u; !result && i < ring->count; ++i )
+		{
+			struct iot_action_request *const request =
+				ring->request[( ring->head + i ) %
+					IOT_ACTION_QUEUE_MAX];
+			iot_action_t *const request_action =
+				iot_action_find( lib, request->name );
+			if ( !request_action ||
+				request_action->concurrency_max == 0u ||
+				request_action->running <
+					request_action->concurrency_max )
+			{
+				/* close the gap, keeping the order of the
+				 * requests that are skipped */
+				iot_uint8_t j;
+				for ( j = i; j > 0u; --j )
+					ring->request[( ring->head + j ) %
+						IOT_ACTION_QUEUE_MAX] =
+					ring->request[( ring->head + j - 1u ) %
+						IOT_ACTION_QUEUE_MAX];
+				ring->head = (iot_uint8_t)(
+					( ring->head + 1u ) %
+					IOT_ACTION_QUEUE_MAX );
+				--ring->count;
+				--lib->request_queue_wait_count;
+
+				if ( request_action )
+					++request_action->running;
+				*action = request_action;
+				result = request;
+			}
+		}
+	}
+	return result;
+}
+
 iot_status_t iot_action_request_option_get(
 	const iot_action_request_t *request,
 	const char *name,
@@ -1514,7 +2605,8 @@ iot_status_t iot_action_request_option_set(
 		struct iot_data data;
 		os_memzero( &data, sizeof( struct iot_data ) );
 		va_start( args, type );
-		result = iot_common_arg_set( &data, IOT_TRUE, type, args );
+		result = iot_action_request_data_set( request, &data,
+			type, args );
 		va_end( args );
 		if ( result == IOT_STATUS_SUCCESS )
 			result = iot_action_request_option_set_data(
@@ -1546,9 +2638,9 @@ iot_status_t iot_action_request_option_set_data(
 		if ( !opt && request->option_count < IOT_OPTION_MAX )
 		{
 #ifndef IOT_STACK_ONLY
-			void *ptr = os_realloc( request->option,
-				sizeof( struct iot_option ) *
-					( request->option_count + 1u ) );
+			void *ptr = iot_action_request_arena_grow( request,
+				request->option, request->option_count,
+				sizeof( struct iot_option ) );
 			if ( ptr )
 				request->option = ptr;
 			else
@@ -1580,7 +2672,8 @@ iot_status_t iot_action_request_option_set_data(
 				if ( name_len > IOT_NAME_MAX_LEN )
 					name_len = IOT_NAME_MAX_LEN;
 #ifndef IOT_STACK_ONLY
-				opt->name = os_malloc( name_len + 1u );
+				opt->name = iot_action_request_arena_storage(
+					request, name_len + 1u );
 				if ( !opt->name )
 				{
 					result = IOT_STATUS_NO_MEMORY;
@@ -1764,20 +2857,50 @@ iot_status_t iot_action_request_execute(
 		if ( request->lib )
 		{
 			struct iot *lib = request->lib;
+			struct iot_action_request_ring *const ring =
+				&lib->request_queue_wait[
+					iot_action_request_lane( lib, request->name )];
+
+			iot_bool_t shed = IOT_FALSE;
 
 #ifdef IOT_THREAD_SUPPORT
 			if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
 			{
 				os_thread_mutex_lock( &lib->worker_mutex );
+
+				/* refuse requests once the queue is backed up,
+				 * keeping the remaining room for high priority
+				 * requests */
+				if ( lib->worker_shed_depth > 0u &&
+					lib->request_queue_wait_count >=
+						lib->worker_shed_depth &&
+					ring != &lib->request_queue_wait[
+						IOT_ACTION_LANE_HIGH] )
+					shed = IOT_TRUE;
 			}
 #endif /* ifdef IOT_THREAD_SUPPORT */
 
-			if ( lib->request_queue_wait_count < IOT_ACTION_QUEUE_MAX )
+			if ( shed == IOT_FALSE &&
+				lib->request_queue_wait_count < IOT_ACTION_QUEUE_MAX &&
+				ring->count < IOT_ACTION_QUEUE_MAX )
 			{
 				result = IOT_STATUS_SUCCESS;
-				lib->request_queue_wait[
-					lib->request_queue_wait_count] = request;
+				ring->request[( ring->head + ring->count ) %
+					IOT_ACTION_QUEUE_MAX] = request;
+				++ring->count;
 				++lib->request_queue_wait_count;
+
+#ifdef IOT_THREAD_SUPPORT
+				/* more requests waiting than idle workers, grow
+				 * the pool (if the main loop is running) */
+				if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) &&
+					lib->main_thread != 0 &&
+					lib->to_quit == IOT_FALSE &&
+					lib->request_queue_wait_count >
+						lib->worker_idle &&
+					lib->worker_count < lib->worker_max )
+					iot_loop_worker_start( lib );
+#endif /* ifdef IOT_THREAD_SUPPORT */
 			}
 			else
 			{
@@ -1809,6 +2932,145 @@ iot_status_t iot_action_request_execute(
 	return result;
 }
 
+iot_status_t iot_action_request_expire( iot_t *lib )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( lib )
+	{
+		struct iot_action_request *expired[IOT_ACTION_QUEUE_MAX];
+		size_t expired_count = 0u;
+		size_t i;
+
+		result = IOT_STATUS_NOT_FOUND;
+#ifdef IOT_THREAD_SUPPORT
+		if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+			os_thread_mutex_lock( &lib->worker_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		if ( lib->request_deferred_count > 0u )
+		{
+			iot_timestamp_t now = 0u;
+			os_time( &now, NULL );
+			for ( i = 0u; i < IOT_ACTION_QUEUE_MAX; ++i )
+			{
+				struct iot_action_request *const request =
+					&lib->request_queue[i];
+				if ( request->deferred ==
+					IOT_ACTION_REQUEST_DEFERRED &&
+					request->deadline > 0u &&
+					now >= request->deadline )
+				{
+					request->deferred =
+						IOT_ACTION_REQUEST_DEFERRED_EXPIRING;
+					expired[expired_count] = request;
+					++expired_count;
+				}
+			}
+		}
+#ifdef IOT_THREAD_SUPPORT
+		if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+			os_thread_mutex_unlock( &lib->worker_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+		/* report outside of the lock, the owner of a request may
+		 * complete it meanwhile and leaves freeing it to us */
+		for ( i = 0u; i < expired_count; ++i )
+		{
+			struct iot_action_request *const request = expired[i];
+			iot_action_t *const action =
+				iot_action_find( lib, request->name );
+			iot_millisecond_t max_time_out = 0u;
+			iot_bool_t release = IOT_FALSE;
+
+			iot_action_request_set_status( request,
+				IOT_STATUS_TIMED_OUT,
+				"Action %s timed out after %lu ms",
+				request->name,
+				(unsigned long)request->time_limit );
+			iot_plugin_perform( lib, NULL, &max_time_out,
+				IOT_OPERATION_ACTION_COMPLETE, action, request,
+				NULL );
+
+#ifdef IOT_THREAD_SUPPORT
+			if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+				os_thread_mutex_lock( &lib->worker_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+			if ( request->deferred ==
+				IOT_ACTION_REQUEST_DEFERRED_EXPIRING_DONE )
+			{
+				request->deferred =
+					IOT_ACTION_REQUEST_DEFERRED_NONE;
+				--lib->request_deferred_count;
+				release = IOT_TRUE;
+			}
+			else
+				request->deferred =
+					IOT_ACTION_REQUEST_DEFERRED_EXPIRED;
+#ifdef IOT_THREAD_SUPPORT
+			if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+				os_thread_mutex_unlock( &lib->worker_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+			if ( release != IOT_FALSE )
+				iot_action_request_release( lib, action,
+					request );
+			result = IOT_STATUS_SUCCESS;
+		}
+	}
+	return result;
+}
+
+iot_status_t iot_action_request_finish(
+	iot_action_t *action,
+	struct iot_action_request *request,
+	iot_status_t status,
+	const char *message,
+	iot_millisecond_t max_time_out )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	iot_t *const lib = request->lib;
+	iot_uint8_t state;
+
+#ifdef IOT_THREAD_SUPPORT
+	if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+		os_thread_mutex_lock( &lib->worker_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	state = request->deferred;
+	if ( state == IOT_ACTION_REQUEST_DEFERRED ||
+		state == IOT_ACTION_REQUEST_DEFERRED_EXPIRED )
+	{
+		request->deferred = IOT_ACTION_REQUEST_DEFERRED_NONE;
+		--lib->request_deferred_count;
+	}
+	else if ( state == IOT_ACTION_REQUEST_DEFERRED_EXPIRING )
+		request->deferred = IOT_ACTION_REQUEST_DEFERRED_EXPIRING_DONE;
+#ifdef IOT_THREAD_SUPPORT
+	if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+		os_thread_mutex_unlock( &lib->worker_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+	if ( state == IOT_ACTION_REQUEST_DEFERRED )
+	{
+		if ( message )
+			iot_action_request_set_status( request, status,
+				"%s", message );
+		else
+			iot_action_request_set_status( request, status,
+				NULL );
+		iot_plugin_perform( lib, NULL, &max_time_out,
+			IOT_OPERATION_ACTION_COMPLETE, action, request, NULL );
+		iot_action_request_release( lib, action, request );
+		result = IOT_STATUS_SUCCESS;
+	}
+	else if ( state == IOT_ACTION_REQUEST_DEFERRED_EXPIRED )
+	{
+		iot_action_request_release( lib, action, request );
+		result = IOT_STATUS_TIMED_OUT;
+	}
+	else if ( state == IOT_ACTION_REQUEST_DEFERRED_EXPIRING )
+		result = IOT_STATUS_TIMED_OUT;
+	return result;
+}
+
 iot_status_t iot_action_request_free(
 	iot_action_request_t *request )
 {
@@ -1819,27 +3081,38 @@ iot_status_t iot_action_request_free(
 #ifndef IOT_STACK_ONLY
 		size_t i;
 
-		/* free any space allocated */
+		char *const arena = request->arena;
+
+		/* free any space allocated outside of the arena */
 		for ( i = 0u; i < request->option_count; ++i )
 		{
-			os_free_null( (void**)&request->option[i].name );
+			iot_action_request_arena_free( request,
+				(void**)&request->option[i].name );
 			os_free_null( (void**)&request->option[i].data.heap_storage );
 		}
 		for ( i = 0u; i < request->parameter_count; ++i )
 		{
-			os_free_null( (void**)&request->parameter[i].name );
+			iot_action_request_arena_free( request,
+				(void**)&request->parameter[i].name );
 			os_free_null( (void**)&request->parameter[i].data.heap_storage );
 		}
 
 		request->option_count = 0u;
 		request->parameter_count = 0u;
-		os_free_null( (void**)&request->option );
-		os_free_null( (void**)&request->parameter );
+		iot_action_request_arena_free( request,
+			(void**)&request->option );
+		iot_action_request_arena_free( request,
+			(void**)&request->parameter );
 		os_free_null( (void**)&request->error );
-		os_free_null( (void**)&request->name );
-#endif /* ifndef IOT_STACK_ONLY */
+		iot_action_request_arena_free( request,
+			(void**)&request->name );
 
+		/* the arena is kept for the next request using the slot */
+		os_memzero( request, sizeof( struct iot_action_request ) );
+		request->arena = arena;
+#else /* ifndef IOT_STACK_ONLY */
 		os_memzero( request, sizeof( struct iot_action_request ) );
+#endif /* else IOT_STACK_ONLY */
 
 		/* mark request spot as clear */
 #ifdef IOT_THREAD_SUPPORT
@@ -2077,10 +3350,12 @@ iot_status_t iot_action_request_parameter_set_args(
 					p = &request->parameter[request->parameter_count];
 					p_name = p->_name;
 #else /* ifdef IOT_STACK_ONLY */
-					p = os_realloc( request->parameter,
-						sizeof( struct iot_action_parameter )
-						* ( request->parameter_count + 1u ) );
-					p_name = os_malloc( sizeof( char ) * name_len + 1u );
+					p = iot_action_request_arena_grow( request,
+						request->parameter,
+						request->parameter_count,
+						sizeof( struct iot_action_parameter ) );
+					p_name = iot_action_request_arena_storage(
+						request, sizeof( char ) * name_len + 1u );
 					if ( p && p_name )
 					{
 						request->parameter = p;
@@ -2088,16 +3363,16 @@ iot_status_t iot_action_request_parameter_set_args(
 					}
 					else
 					{
-						if ( p )
-						{
-							os_free( p );
-							p = NULL;
-						}
+						/* a grown array may have moved */
+						if ( p && request->parameter_count > 0u )
+							request->parameter = p;
+						else if ( p )
+							iot_action_request_arena_free(
+								request, (void **)&p );
 						if ( p_name )
-						{
-							os_free( p_name );
-							p_name = NULL;
-						}
+							iot_action_request_arena_free(
+								request, (void **)&p_name );
+						p = NULL;
 						result = IOT_STATUS_NO_MEMORY;
 					}
 #endif /* else IOT_STACK_ONLY */
@@ -2119,8 +3394,8 @@ iot_status_t iot_action_request_parameter_set_args(
 				if ( p )
 				{
 					p->type = IOT_PARAMETER_OUT;
-					result = iot_common_arg_set(
-						&p->data, IOT_TRUE, type, args );
+					result = iot_action_request_data_set(
+						request, &p->data, type, args );
 					if ( result == IOT_STATUS_SUCCESS &&
 						add_parameter != IOT_FALSE )
 					{
@@ -2133,6 +3408,33 @@ iot_status_t iot_action_request_parameter_set_args(
 	return result;
 }
 
+void iot_action_request_release(
+	iot_t *lib,
+	iot_action_t *action,
+	struct iot_action_request *request )
+{
+	iot_action_request_free( request );
+	if ( action )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+		{
+			os_thread_mutex_lock( &lib->worker_mutex );
+			--action->running;
+			/* requests held back by the concurrency limit of the
+			 * action can run now */
+			if ( action->concurrency_max > 0u &&
+				lib->request_queue_wait_count > 0u )
+				os_thread_condition_signal( &lib->worker_signal,
+					&lib->worker_mutex );
+			os_thread_mutex_unlock( &lib->worker_mutex );
+		}
+		else
+#endif /* ifdef IOT_THREAD_SUPPORT */
+			--action->running;
+	}
+}
+
 void iot_action_request_set_status(
 	struct iot_action_request *request,
 	iot_status_t status,
@@ -2235,3 +3537,31 @@ iot_status_t iot_action_time_limit_set(
 	}
 	return result;
 }
+
+#ifdef IOT_THREAD_SUPPORT
+void iot_action_unlock(
+	iot_t *lib,
+	const iot_action_t *action )
+{
+	if ( action->flags & IOT_ACTION_EXCLUSIVE_APP )
+		os_thread_rwlock_write_unlock(
+			&lib->worker_thread_exclusive_lock );
+	else
+	{
+		/* release in the reverse order the locks were taken */
+		iot_uint8_t i;
+		for ( i = IOT_LOCK_GROUP_MAX; i > 0u; --i )
+		{
+			const iot_uint32_t bit = (iot_uint32_t)1u << ( i - 1u );
+			if ( action->lock_exclusive & bit )
+				os_thread_rwlock_write_unlock(
+					&lib->lock_group[i - 1u].lock );
+			else if ( action->lock_shared & bit )
+				os_thread_rwlock_read_unlock(
+					&lib->lock_group[i - 1u].lock );
+		}
+		os_thread_rwlock_read_unlock(
+			&lib->worker_thread_exclusive_lock );
+	}
+}
+#endif /* ifdef IOT_THREAD_SUPPORT */
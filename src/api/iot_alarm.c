@@ -16,6 +16,8 @@
  */
 
 #include "public/iot.h"
+
+#include "iot_common.h"           /* for iot_common_list_grow */
 #include "shared/iot_types.h"
 
 iot_alarm_t *iot_alarm_register(
@@ -25,18 +27,41 @@ iot_alarm_t *iot_alarm_register(
 	struct iot_alarm *alarm = NULL;
 	if( lib && name && *name != '\0' )
 	{
+		struct iot_alarm **alarm_ptr;
+		iot_uint32_t max = IOT_ALARM_MAX;
 #ifdef IOT_THREAD_SUPPORT
 		os_thread_mutex_lock( &lib->alarm_mutex );
 #endif /* ifdef IOT_THREAD_SUPPORT */
-		if ( lib->alarm_count < IOT_ALARM_MAX )
+		alarm_ptr = IOT_ALARM_PTR( lib );
+#ifndef IOT_STACK_ONLY
+		if ( lib->alarm_heap )
+			max = lib->alarm_max;
+
+		/* grow the list of alarms if it is full */
+		if ( lib->alarm_count >= max )
+		{
+			struct iot_alarm **const heap =
+				(struct iot_alarm **)iot_common_list_grow(
+					(void **)lib->alarm_heap,
+					(void *const *)lib->alarm_ptr, &max );
+			if ( heap )
+			{
+				lib->alarm_heap = heap;
+				lib->alarm_max = max;
+				alarm_ptr = heap;
+			}
+		}
+#endif /* ifndef IOT_STACK_ONLY */
+
+		if ( lib->alarm_count < max )
 		{
-			const unsigned int count = lib->alarm_count;
+			const iot_uint32_t count = lib->alarm_count;
 #ifndef IOT_STACK_ONLY
 			iot_bool_t is_in_heap = IOT_FALSE;
 #endif
 
 			/* look for free alarm in stack */
-			alarm = lib->alarm_ptr[count];
+			alarm = alarm_ptr[count];
 
 #ifndef IOT_STACK_ONLY
 			/* allocate alarm in heap if none is available in stack */
@@ -50,9 +75,9 @@ iot_alarm_t *iot_alarm_register(
 
 			if ( alarm )
 			{
-				unsigned int cur_idx = 0u;
-				unsigned int min_idx = 0u;
-				unsigned int max_idx = count;
+				iot_uint32_t cur_idx = 0u;
+				iot_uint32_t min_idx = 0u;
+				iot_uint32_t max_idx = count;
 				size_t name_len = os_strlen(name);
 
 				if( name_len > IOT_NAME_MAX_LEN )
@@ -81,7 +106,7 @@ iot_alarm_t *iot_alarm_register(
 						int cmp_result;
 						cur_idx = (max_idx - min_idx) / 2u + min_idx;
 						cmp_result = os_strncmp( name,
-							lib->alarm_ptr[cur_idx]->name,
+							alarm_ptr[cur_idx]->name,
 							name_len );
 						if ( cmp_result > 0 )
 						{
@@ -93,10 +118,10 @@ iot_alarm_t *iot_alarm_register(
 					}
 
 					/* insert into proper spot in list */
-					os_memmove( &lib->alarm_ptr[cur_idx + 1u],
-						&lib->alarm_ptr[cur_idx],
+					os_memmove( &alarm_ptr[cur_idx + 1u],
+						&alarm_ptr[cur_idx],
 						sizeof(struct iot_alarm *) * (count - cur_idx) );
-					lib->alarm_ptr[cur_idx] = alarm;
+					alarm_ptr[cur_idx] = alarm;
 					++lib->alarm_count;
 				}
 #ifndef IOT_STACK_ONLY
@@ -116,7 +141,7 @@ iot_alarm_t *iot_alarm_register(
 		}else
 			IOT_LOG( lib, IOT_LOG_ERROR,
 				"no remaining space (max: %u) for alarm: %s",
-				IOT_ALARM_MAX, name );
+				(unsigned int)max, name );
 #ifdef IOT_THREAD_SUPPORT
 		os_thread_mutex_unlock( &lib->alarm_mutex );
 #endif /* ifdef IOT_THREAD_SUPPORT */
@@ -135,14 +160,16 @@ iot_status_t iot_alarm_deregister(
 		result = IOT_STATUS_NOT_INITIALIZED;
 		if ( lib )
 		{
-			unsigned int i, max;
+			struct iot_alarm **alarm_ptr;
+			iot_uint32_t i, max;
 #ifdef IOT_THREAD_SUPPORT
 			os_thread_mutex_lock( &lib->alarm_mutex );
 #endif /* ifdef IOT_THREAD_SUPPORT */
 			/* find alarm within the library */
+			alarm_ptr = IOT_ALARM_PTR( lib );
 			max = lib->alarm_count;
 			for ( i = 0u; ( i < max ) &&
-				( lib->alarm_ptr[ i ] != alarm );
+				( alarm_ptr[ i ] != alarm );
 				++i );
 
 			if ( i < max )
@@ -157,8 +184,8 @@ iot_status_t iot_alarm_deregister(
 
 				/* remove from library */
 				os_memmove(
-					&lib->alarm_ptr[ i ],
-					&lib->alarm_ptr[ i + 1u ],
+					&alarm_ptr[ i ],
+					&alarm_ptr[ i + 1u ],
 					sizeof( struct iot_alarm * ) * ( max - i - 1u ) );
 
 				/* set lib to NULL */
@@ -169,18 +196,18 @@ iot_status_t iot_alarm_deregister(
 #ifndef IOT_STACK_ONLY
 				if ( is_in_heap == IOT_FALSE )
 				{
-					lib->alarm_ptr[
+					alarm_ptr[
 						lib->alarm_count] = alarm;
 				}
 				else
 				{
-					lib->alarm_ptr[
+					alarm_ptr[
 						lib->alarm_count] = NULL;
 					os_free( alarm );
 					alarm = NULL;
 				}
 #else
-				lib->alarm_ptr[
+				alarm_ptr[
 					lib->alarm_count] = alarm;
 #endif /* ifndef IOT_STACK_ONLY */
 				result = IOT_STATUS_SUCCESS;
@@ -98,6 +98,29 @@ static IOT_SECTION iot_status_t iot_config_set_data(
 	const char *name,
 	const struct iot_data *data );
 
+/**
+ * @brief Reads how command actions are launched from the configuration
+ *
+ * @param[in,out]  lib                 library handle
+ */
+static IOT_SECTION void iot_base_command_configure( iot_t *lib );
+
+/**
+ * @brief Completes a pending transaction and calls its callback
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in]      txn                 transaction id
+ * @param[in]      status              new status of the transaction
+ * @param[in]      from_plugins        status is the one returned by the
+ *                                     plug-ins, a successful transaction
+ *                                     waiting for a reply stays pending
+ */
+static IOT_SECTION void iot_base_transaction_complete(
+	iot_t *lib,
+	iot_transaction_t txn,
+	iot_status_t status,
+	iot_bool_t from_plugins );
+
 #ifdef IOT_THREAD_SUPPORT
 /**
  * @brief default main thread
@@ -107,10 +130,16 @@ static IOT_SECTION iot_status_t iot_config_set_data(
  * @retval NULL    always on thread termination
  */
 static OS_THREAD_DECL iot_base_main_thread( void *user_data );
+/**
+ * @brief Reads the worker pool settings from the configuration
+ *
+ * @param[in,out]  lib                 library handle
+ */
+static IOT_SECTION void iot_base_worker_configure( iot_t *lib );
 /**
  * @brief worker thread main function
  *
- * @param[in,out]  user_data           pointer to the library instance
+ * @param[in,out]  user_data           pointer to the worker slot
  *
  * @retval NULL    always on thread termination
  */
@@ -160,22 +189,19 @@ static IOT_SECTION iot_status_t iot_base_configuration_read(
 	iot_millisecond_t *max_time_out );
 
 /**
- * @brief Parses the configuration file
+ * @brief Applies the configuration file, once parsed
  *
  * @param[in,out]  lib                 library handle
- * @param[in]      file_path           path of configuration file read
- * @param[in]      buf                 configuration file contents
- * @param[in]      len                 buffer length
+ * @param[in]      json                json decoder
+ * @param[in]      root                root object of the configuration file
  *
  * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
- * @retval IOT_STATUS_PARSE_ERROR      failed to parse configuration file
  * @retval IOT_STATUS_SUCCESS          on success
  */
 static IOT_SECTION iot_status_t iot_base_configuration_parse(
 	iot_t *lib,
-	const char *file_path,
-	const char *buf,
-	const size_t len );
+	iot_json_decoder_t *json,
+	const iot_json_item_t *root );
 
 /**
  * @brief Parses the base object in a configuration file
@@ -305,43 +331,56 @@ iot_status_t iot_base_configuration_read(
 			{
 				char *buf = NULL;
 				size_t buf_len = 0u;
-				iot_bool_t more_to_read = IOT_TRUE;
+				iot_json_decoder_t *json;
+				const iot_json_item_t *root = NULL;
+				char err_msg[32u];
+#ifdef IOT_STACK_ONLY
+				char stack_buf[IOT_READ_BLOCK_SIZE * 2u];
+				char buffer[1024u];
+				json = iot_json_decode_initialize( buffer, 1024u, 0 );
+#else
+				json = iot_json_decode_initialize( NULL, 0u,
+					IOT_JSON_FLAG_DYNAMIC );
+#endif
 
-				result = IOT_STATUS_SUCCESS;
-				while ( result == IOT_STATUS_SUCCESS &&
-					more_to_read == IOT_TRUE )
+				/* each block is parsed as it is read, carrying on
+				 * from the previous one */
+				*err_msg = '\0';
+				result = IOT_STATUS_PARSE_ERROR;
+				if ( json )
+					result = IOT_STATUS_TRY_AGAIN;
+				while ( result == IOT_STATUS_TRY_AGAIN )
 				{
+					size_t bytes = IOT_READ_BLOCK_SIZE;
 					char *new_buf;
 #ifdef IOT_STACK_ONLY
-					char stack_buf[IOT_READ_BLOCK_SIZE * 2u];
-					new_buf = stack_buf;
-					if ( buf_len < IOT_READ_BLOCK_SIZE * 2u )
+					new_buf = NULL;
+					if ( buf_len < sizeof( stack_buf ) )
+						new_buf = stack_buf;
+					if ( bytes > sizeof( stack_buf ) - buf_len )
+						bytes = sizeof( stack_buf ) - buf_len;
 #else
 					new_buf = os_realloc( buf,
-						sizeof( char ) *
-						( buf_len + IOT_READ_BLOCK_SIZE ) );
-					if ( new_buf )
+						sizeof( char ) * ( buf_len + bytes ) );
 #endif /* ifdef IOT_STACK_ONLY */
+					result = IOT_STATUS_NO_MEMORY;
+					if ( new_buf )
 					{
-						size_t bytes;
-
 						buf = new_buf;
 						bytes = os_file_read(
 							&buf[buf_len],
-							sizeof(char),
-							IOT_READ_BLOCK_SIZE, fd );
-						if ( bytes == 0u )
-						{
-							if ( os_file_eof( fd ) == OS_FALSE )
-								result = IOT_STATUS_FAILURE;
-							more_to_read = IOT_FALSE;
-						}
+							sizeof(char), bytes, fd );
+						if ( bytes == 0u &&
+							os_file_eof( fd ) == OS_FALSE )
+							result = IOT_STATUS_FAILURE;
 						else
+						{
 							buf_len += bytes;
-					}
-					else
-					{
-						result = IOT_STATUS_NO_MEMORY;
+							result = iot_json_decode_parse_chunk(
+								json, buf, buf_len,
+								bytes > 0u ? IOT_TRUE : IOT_FALSE,
+								&root, err_msg, 32u );
+						}
 					}
 				}
 
@@ -349,8 +388,15 @@ iot_status_t iot_base_configuration_read(
 				{
 					/* process configuration file */
 					result = iot_base_configuration_parse(
-						lib, file_path, buf, buf_len );
+						lib, json, root );
 				}
+				else if ( result == IOT_STATUS_PARSE_ERROR )
+				{
+					IOT_LOG( lib, IOT_LOG_ERROR,
+						"Failed to parse configuration file: %s (%s)",
+							file_path, err_msg );
+				}
+				iot_json_decode_terminate( json );
 
 #ifndef IOT_STACK_ONLY
 				if ( buf )
@@ -375,43 +421,18 @@ iot_status_t iot_base_configuration_read(
 
 iot_status_t iot_base_configuration_parse(
 	iot_t *lib,
-	const char *file_path,
-	const char *buf,
-	const size_t len )
+	iot_json_decoder_t *json,
+	const iot_json_item_t *root )
 {
 	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
-	if ( lib && file_path && buf && len > 0 )
+	if ( lib && json )
 	{
-		iot_json_decoder_t *json;
-		const iot_json_item_t *root;
-		char err_msg[32u];
-
-#ifdef IOT_STACK_ONLY
-		char buffer[1024u];
-		json = iot_json_decode_initialize( buffer, 1024u, 0 );
-#else
-		json = iot_json_decode_initialize( NULL, 0u,
-			IOT_JSON_FLAG_DYNAMIC );
-#endif
-		if ( json &&
-			iot_json_decode_parse( json, buf, len, &root,
-				err_msg, 32u ) == IOT_STATUS_SUCCESS )
-		{
-			char key_buff[256u];
-			*key_buff = '\0';
-			os_fprintf( OS_STDERR, "Current Configuration:\n" );
-			iot_base_configuration_parse_object(
-				lib, json, root, key_buff, 0u );
-			result = IOT_STATUS_SUCCESS;
-		}
-		else
-		{
-			IOT_LOG( lib, IOT_LOG_ERROR,
-				"Failed to parse configuration file: %s (%s)",
-					file_path, err_msg );
-			result = IOT_STATUS_PARSE_ERROR;
-		}
-		iot_json_decode_terminate( json );
+		char key_buff[256u];
+		*key_buff = '\0';
+		os_fprintf( OS_STDERR, "Current Configuration:\n" );
+		iot_base_configuration_parse_object(
+			lib, json, root, key_buff, 0u );
+		result = IOT_STATUS_SUCCESS;
 	}
 	return result;
 }
@@ -611,6 +632,31 @@ iot_status_t iot_base_device_id_set(
 	return result;
 }
 
+void iot_base_command_configure( iot_t *lib )
+{
+	const char *launch = NULL;
+
+	lib->command_launch = IOT_COMMAND_LAUNCH_SHELL;
+	iot_config_get( lib, "action.command_launch", IOT_FALSE,
+		IOT_TYPE_STRING, &launch );
+	if ( launch && os_strcmp( launch, "spawn" ) == 0 )
+		lib->command_launch = IOT_COMMAND_LAUNCH_SPAWN;
+	else if ( launch && os_strcmp( launch, "helper" ) == 0 )
+	{
+		lib->command_launch = IOT_COMMAND_LAUNCH_HELPER;
+		if ( iot_spawn_helper_start( lib ) != IOT_STATUS_SUCCESS )
+		{
+			IOT_LOG( lib, IOT_LOG_WARNING, "%s",
+				"Failed to start command helper, "
+				"spawning commands directly" );
+			lib->command_launch = IOT_COMMAND_LAUNCH_SPAWN;
+		}
+	}
+	else if ( launch && os_strcmp( launch, "shell" ) != 0 )
+		IOT_LOG( lib, IOT_LOG_WARNING,
+			"Unknown command launch method: %s", launch );
+}
+
 #ifdef IOT_THREAD_SUPPORT
 OS_THREAD_DECL iot_base_main_thread( void *user_data )
 {
@@ -619,16 +665,71 @@ OS_THREAD_DECL iot_base_main_thread( void *user_data )
 	return (OS_THREAD_RETURN)0;
 }
 
+void iot_base_worker_configure( iot_t *lib )
+{
+	iot_int64_t value = 0;
+
+	lib->worker_max = IOT_WORKER_THREADS;
+	if ( iot_config_get( lib, "worker.max", IOT_FALSE,
+		IOT_TYPE_INT64, &value ) == IOT_STATUS_SUCCESS &&
+		value > 0 && value <= IOT_WORKER_THREADS )
+		lib->worker_max = (iot_uint32_t)value;
+
+	/* by default the pool does not shrink */
+	lib->worker_min = lib->worker_max;
+	if ( iot_config_get( lib, "worker.min", IOT_FALSE,
+		IOT_TYPE_INT64, &value ) == IOT_STATUS_SUCCESS &&
+		value >= 0 && value <= (iot_int64_t)lib->worker_max )
+		lib->worker_min = (iot_uint32_t)value;
+
+	lib->worker_idle_time = IOT_WORKER_IDLE_TIME_DEFAULT;
+	if ( iot_config_get( lib, "worker.idle_time", IOT_FALSE,
+		IOT_TYPE_INT64, &value ) == IOT_STATUS_SUCCESS &&
+		value > 0 && value <= 0xFFFFFFFF )
+		lib->worker_idle_time = (iot_millisecond_t)value;
+
+	lib->worker_shed_depth = 0u;
+	if ( iot_config_get( lib, "worker.shed_depth", IOT_FALSE,
+		IOT_TYPE_INT64, &value ) == IOT_STATUS_SUCCESS &&
+		value > 0 && value < IOT_ACTION_QUEUE_MAX )
+		lib->worker_shed_depth = (iot_uint32_t)value;
+}
+
 OS_THREAD_DECL iot_base_worker_thread_main( void *user_data )
 {
-	struct iot *lib = (struct iot *)user_data;
+	struct iot_worker *const worker = (struct iot_worker *)user_data;
+	struct iot *const lib = worker->lib;
 	iot_status_t result = IOT_STATUS_SUCCESS;
-	while( lib && lib->to_quit == IOT_FALSE &&
-		result == IOT_STATUS_SUCCESS )
+	while( lib->to_quit == IOT_FALSE &&
+		( result == IOT_STATUS_SUCCESS ||
+		  result == IOT_STATUS_NOT_FOUND ) )
 	{
 		result = iot_action_process( lib, 0u );
 		if ( result == IOT_STATUS_SUCCESS )
 			iot_action_check( lib, 0u );
+		else if ( result == IOT_STATUS_TIMED_OUT )
+		{
+			/* idle for too long, leave the pool unless it is
+			 * already down to its minimum size */
+			os_thread_mutex_lock( &lib->worker_mutex );
+			if ( lib->worker_count > lib->worker_min )
+			{
+				--lib->worker_count;
+				worker->exited = IOT_TRUE;
+			}
+			else
+				result = IOT_STATUS_NOT_FOUND;
+			os_thread_mutex_unlock( &lib->worker_mutex );
+		}
+	}
+
+	/* stopped on an error, free the slot for another worker */
+	if ( worker->exited == IOT_FALSE && lib->to_quit == IOT_FALSE )
+	{
+		os_thread_mutex_lock( &lib->worker_mutex );
+		--lib->worker_count;
+		worker->exited = IOT_TRUE;
+		os_thread_mutex_unlock( &lib->worker_mutex );
 	}
 	return (OS_THREAD_RETURN)0;
 }
@@ -799,6 +900,9 @@ iot_status_t iot_connect(
 		if ( log_level )
 			iot_log_level_set_string( lib, log_level );
 
+		/* before any threads are started, the helper is forked */
+		iot_base_command_configure( lib );
+
 		if ( result == IOT_STATUS_SUCCESS )
 			result = iot_plugin_perform( lib,
 				NULL, &max_time_out,
@@ -813,11 +917,31 @@ iot_status_t iot_connect(
 			if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) &&
 				(result == IOT_STATUS_SUCCESS) )
 			{
+				iot_bool_t queue_block = IOT_FALSE;
+				iot_int64_t queue_max = 0;
+
 				result = iot_loop_start( lib );
 				if ( result != IOT_STATUS_SUCCESS )
 					IOT_LOG( lib,
 					IOT_LOG_ERROR, "%s",
 					"Failed to start main loop" );
+
+				/* asynchronous publishing of telemetry */
+				iot_config_get( lib, "publish.queue_max",
+					IOT_FALSE, IOT_TYPE_INT64, &queue_max );
+				iot_config_get( lib, "publish.queue_block",
+					IOT_FALSE, IOT_TYPE_BOOL, &queue_block );
+				if ( queue_max < 0 )
+					queue_max = 0;
+				if ( queue_max > 0xFFFFFFFF )
+					queue_max = 0xFFFFFFFF;
+				if ( result == IOT_STATUS_SUCCESS &&
+					iot_telemetry_publish_start( lib,
+						(iot_uint32_t)queue_max,
+						queue_block ) != IOT_STATUS_SUCCESS )
+					IOT_LOG( lib, IOT_LOG_ERROR, "%s",
+						"Failed to start asynchronous "
+						"publishing" );
 			}
 #endif /* ifdef IOT_THREAD_SUPPORT */
 		}
@@ -873,11 +997,17 @@ iot_status_t iot_disconnect(
 	if ( lib )
 	{
 #ifdef IOT_THREAD_SUPPORT
+		/* publish any queued samples */
+		iot_telemetry_publish_stop( lib );
+
 		/* kill process loop */
 		if ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
 			iot_loop_stop( lib, IOT_FALSE );
 #endif /* ifdef IOT_THREAD_SUPPORT */
 
+		/* publish the summary of any partial aggregation windows */
+		iot_telemetry_reduce_flush( lib, IOT_TRUE, max_time_out );
+
 		result = iot_plugin_perform( lib, NULL, &max_time_out,
 			IOT_OPERATION_CLIENT_DISCONNECT, NULL, NULL, NULL );
 	}
@@ -957,6 +1087,9 @@ iot_t *iot_initialize(
 				result->request_queue_free[i] = &result->request_queue[i];
 
 			result->logger_level = IOT_LOG_INFO;
+#ifdef IOT_SPAWN_SUPPORT
+			result->spawn_helper_fd = -1;
+#endif /* ifdef IOT_SPAWN_SUPPORT */
 			if ( iot_configuration_file_set( result, cfg_path )
 				!= IOT_STATUS_NO_MEMORY )
 			{
@@ -970,6 +1103,11 @@ iot_t *iot_initialize(
 				os_thread_mutex_create( &result->worker_mutex );
 				os_thread_condition_create( &result->worker_signal );
 				os_thread_rwlock_create( &result->worker_thread_exclusive_lock );
+				os_thread_mutex_create( &result->publish_mutex );
+				os_thread_condition_create( &result->publish_signal );
+				os_thread_mutex_create( &result->transaction_mutex );
+				os_thread_condition_create(
+					&result->transaction_signal );
 #endif /* ifndef IOT_THREAD_SUPPORT */
 
 				/*os_socket_initialize();*/
@@ -1147,6 +1285,12 @@ iot_status_t iot_loop_iteration( iot_t *lib, iot_millisecond_t max_time_out )
 		result = iot_plugin_perform( lib, NULL, &max_time_out,
 			IOT_OPERATION_ITERATION, NULL, NULL, NULL );
 
+		/* report deferred action requests that timed out */
+		iot_action_request_expire( lib );
+
+		/* close aggregation windows no longer receiving samples */
+		iot_telemetry_reduce_flush( lib, IOT_FALSE, max_time_out );
+
 		if ( result == IOT_STATUS_SUCCESS
 #ifdef IOT_THREAD_SUPPORT
 			&& ( lib->flags & IOT_FLAG_SINGLE_THREAD )
@@ -1184,18 +1328,20 @@ iot_status_t iot_loop_start( iot_t *lib )
 			stack_size = deviceCloudStackSizeGet();
 #endif /* defined( __VXWORKS__ ) */
 
-			os_status_t os_result;
 			result = IOT_STATUS_FAILURE;
-			os_result = os_thread_create( &lib->main_thread,
-				iot_base_main_thread, lib, stack_size );
-			for ( i = 0u; os_result == OS_STATUS_SUCCESS &&
-				i < IOT_WORKER_THREADS; ++i )
-				os_result = os_thread_create(
-					&lib->worker_thread[i],
-					iot_base_worker_thread_main, lib,
-					stack_size );
-			if ( os_result == OS_STATUS_SUCCESS )
+			iot_base_worker_configure( lib );
+			if ( os_thread_create( &lib->main_thread,
+				iot_base_main_thread, lib, stack_size ) ==
+				OS_STATUS_SUCCESS )
+			{
+				/* more workers are started as requests queue up */
 				result = IOT_STATUS_SUCCESS;
+				os_thread_mutex_lock( &lib->worker_mutex );
+				for ( i = 0u; result == IOT_STATUS_SUCCESS &&
+					i < lib->worker_min; ++i )
+					result = iot_loop_worker_start( lib );
+				os_thread_mutex_unlock( &lib->worker_mutex );
+			}
 		}
 		else
 			result = IOT_STATUS_SUCCESS;
@@ -1238,18 +1384,23 @@ iot_status_t iot_loop_stop( iot_t *lib, iot_bool_t force )
 				&lib->worker_signal );
 			for ( i = 0u; i < IOT_WORKER_THREADS; ++i )
 			{
-				if ( lib->worker_thread[i] != 0 )
+				struct iot_worker *const worker =
+					&lib->worker[i];
+				if ( worker->thread != 0 )
 				{
-					if ( force == IOT_FALSE )
+					if ( force == IOT_FALSE ||
+						worker->exited != IOT_FALSE )
 						os_thread_wait(
-							&lib->worker_thread[i] );
+							&worker->thread );
 					else
 						os_thread_destroy(
-							&lib->worker_thread[i] );
+							&worker->thread );
 					/* set to 0, in case this is called again */
-					lib->worker_thread[i] = 0;
+					worker->thread = 0;
+					worker->exited = IOT_FALSE;
 				}
 			}
+			lib->worker_count = 0u;
 			result = IOT_STATUS_SUCCESS;
 		}
 #else
@@ -1260,6 +1411,54 @@ iot_status_t iot_loop_stop( iot_t *lib, iot_bool_t force )
 	return result;
 }
 
+iot_status_t iot_loop_worker_start( iot_t *lib )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( lib )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		struct iot_worker *worker = NULL;
+		size_t i;
+		size_t stack_size = 0u;
+
+#if defined( __VXWORKS__ )
+		stack_size = deviceCloudStackSizeGet();
+#endif /* defined( __VXWORKS__ ) */
+
+		/* find a free slot, or one of a worker that has exited */
+		result = IOT_STATUS_FULL;
+		for ( i = 0u; !worker && lib->worker_count < lib->worker_max &&
+			i < IOT_WORKER_THREADS; ++i )
+		{
+			if ( lib->worker[i].thread == 0 ||
+				lib->worker[i].exited != IOT_FALSE )
+				worker = &lib->worker[i];
+		}
+
+		if ( worker )
+		{
+			if ( worker->thread != 0 )
+				os_thread_wait( &worker->thread );
+			worker->lib = lib;
+			worker->exited = IOT_FALSE;
+			++lib->worker_count;
+			result = IOT_STATUS_SUCCESS;
+			if ( os_thread_create( &worker->thread,
+				iot_base_worker_thread_main, worker,
+				stack_size ) != OS_STATUS_SUCCESS )
+			{
+				--lib->worker_count;
+				worker->thread = 0;
+				result = IOT_STATUS_FAILURE;
+			}
+		}
+#else
+		result = IOT_STATUS_NOT_SUPPORTED;
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+	return result;
+}
+
 iot_status_t iot_terminate(
 	iot_t *lib,
 	iot_millisecond_t max_time_out )
@@ -1268,12 +1467,17 @@ iot_status_t iot_terminate(
 	if ( lib )
 	{
 		iot_uint8_t i;
+#ifdef IOT_THREAD_SUPPORT
+		/* publish any queued samples before telemetry is freed */
+		iot_telemetry_publish_stop( lib );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		iot_spawn_helper_stop( lib );
 #ifndef IOT_STACK_ONLY
 		/* free memory allocated for telemetry */
 		while ( lib->telemetry_count > 0u )
 		{
 			struct iot_telemetry *const telemetry =
-				lib->telemetry_ptr[lib->telemetry_count - 1u];
+				IOT_TELEMETRY_PTR( lib )[lib->telemetry_count - 1u];
 
 			if ( iot_telemetry_free( telemetry, max_time_out )
 				!= IOT_STATUS_SUCCESS )
@@ -1284,7 +1488,7 @@ iot_status_t iot_terminate(
 		while ( lib->action_count > 0u )
 		{
 			struct iot_action *const action =
-				lib->action_ptr[lib->action_count - 1u];
+				IOT_ACTION_PTR( lib )[lib->action_count - 1u];
 			if ( iot_action_free( action, max_time_out )
 				!= IOT_STATUS_SUCCESS )
 				--lib->action_count;
@@ -1294,13 +1498,23 @@ iot_status_t iot_terminate(
 		while ( lib->alarm_count > 0u )
 		{
 			struct iot_alarm *const alarm =
-				lib->alarm_ptr[lib->alarm_count - 1u];
+				IOT_ALARM_PTR( lib )[lib->alarm_count - 1u];
 
 			if ( iot_alarm_deregister( alarm )
 				!= IOT_STATUS_SUCCESS )
 				--lib->alarm_count;
 		}
 
+		/* free registries that grew beyond their initial storage */
+		os_free_null( (void **)&lib->telemetry_heap );
+		os_free_null( (void **)&lib->action_heap );
+		os_free_null( (void **)&lib->alarm_heap );
+		iot_common_index_terminate( &lib->action_index );
+
+		/* free storage kept by the request slots */
+		for ( i = 0u; i < IOT_ACTION_QUEUE_MAX; ++i )
+			os_free_null( (void **)&lib->request_queue[i].arena );
+
 		/* free memory allocated for each option */
 		for ( i = 0u; i < lib->options_count; ++i )
 		{
@@ -1346,9 +1560,16 @@ iot_status_t iot_terminate(
 		os_thread_condition_destroy( &lib->worker_signal );
 		os_thread_rwlock_destroy(
 			&lib->worker_thread_exclusive_lock );
+		for ( i = 0u; i < lib->lock_group_count; ++i )
+			os_thread_rwlock_destroy( &lib->lock_group[i].lock );
+		os_thread_mutex_destroy( &lib->publish_mutex );
+		os_thread_condition_destroy( &lib->publish_signal );
+		os_thread_mutex_destroy( &lib->transaction_mutex );
+		os_thread_condition_destroy( &lib->transaction_signal );
 #endif /* ifdef IOT_THREAD_SUPPORT */
 
 #ifndef IOT_STACK_ONLY
+		os_free_null( (void **)&lib->transaction );
 		if ( lib->cfg_file_path )
 			os_free( lib->cfg_file_path );
 		if ( lib->device_id )
@@ -1366,6 +1587,164 @@ iot_timestamp_t iot_timestamp_now( void )
 	return time_stamp;
 }
 
+iot_transaction_t iot_transaction_allocate(
+	iot_t *lib )
+{
+	iot_transaction_t result = 0u;
+	if ( lib )
+	{
+		iot_transaction_callback_t *callback = NULL;
+		void *user_data = NULL;
+		iot_transaction_t forgotten = 0u;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &lib->transaction_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		if ( !lib->transaction )
+		{
+#ifdef IOT_STACK_ONLY
+			lib->transaction = lib->_transaction;
+#else /* ifdef IOT_STACK_ONLY */
+			lib->transaction = os_malloc(
+				sizeof( struct iot_transaction ) *
+				IOT_TRANSACTION_SLOTS );
+			if ( lib->transaction )
+#endif /* else IOT_STACK_ONLY */
+				os_memzero( lib->transaction,
+					sizeof( struct iot_transaction ) *
+					IOT_TRANSACTION_SLOTS );
+		}
+
+		/* 0 is never used, it means no transaction */
+		if ( ++lib->transaction_count == 0u )
+			++lib->transaction_count;
+		result = lib->transaction_count;
+
+		if ( lib->transaction )
+		{
+			/* slots are reused once the ids wrap around the table,
+			 * the rest of the id tells the generations apart */
+			struct iot_transaction *const entry =
+				&lib->transaction[result % IOT_TRANSACTION_SLOTS];
+			if ( entry->id != 0u &&
+				entry->status == IOT_STATUS_INVOKED )
+			{
+				forgotten = entry->id;
+				callback = entry->callback;
+				user_data = entry->user_data;
+			}
+			entry->id = result;
+			entry->status = IOT_STATUS_INVOKED;
+			entry->reply = IOT_FALSE;
+			entry->callback = NULL;
+			entry->user_data = NULL;
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &lib->transaction_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+		if ( callback )
+			callback( lib, forgotten, IOT_STATUS_TIMED_OUT,
+				user_data );
+	}
+	return result;
+}
+
+iot_status_t iot_transaction_callback_set(
+	iot_t *lib,
+	const iot_transaction_t *txn,
+	iot_transaction_callback_t *func,
+	void *user_data )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( lib && txn && *txn != 0u )
+	{
+		iot_status_t status = IOT_STATUS_INVOKED;
+		result = IOT_STATUS_NOT_FOUND;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &lib->transaction_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		if ( lib->transaction )
+		{
+			struct iot_transaction *const entry =
+				&lib->transaction[*txn % IOT_TRANSACTION_SLOTS];
+			if ( entry->id == *txn )
+			{
+				status = entry->status;
+				if ( status == IOT_STATUS_INVOKED )
+				{
+					entry->callback = func;
+					entry->user_data = user_data;
+				}
+				result = IOT_STATUS_SUCCESS;
+			}
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &lib->transaction_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+		/* already completed, report it straight away */
+		if ( result == IOT_STATUS_SUCCESS &&
+			status != IOT_STATUS_INVOKED && func )
+			func( lib, *txn, status, user_data );
+	}
+	return result;
+}
+
+void iot_base_transaction_complete(
+	iot_t *lib,
+	iot_transaction_t txn,
+	iot_status_t status,
+	iot_bool_t from_plugins )
+{
+	if ( lib && txn != 0u )
+	{
+		iot_transaction_callback_t *callback = NULL;
+		void *user_data = NULL;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &lib->transaction_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		if ( lib->transaction )
+		{
+			struct iot_transaction *const entry =
+				&lib->transaction[txn % IOT_TRANSACTION_SLOTS];
+			if ( entry->id == txn &&
+				entry->status == IOT_STATUS_INVOKED )
+			{
+				if ( status == IOT_STATUS_INVOKED )
+					entry->reply = IOT_TRUE;
+				else if ( from_plugins == IOT_FALSE ||
+					status != IOT_STATUS_SUCCESS ||
+					entry->reply == IOT_FALSE )
+				{
+					entry->status = status;
+					callback = entry->callback;
+					user_data = entry->user_data;
+					entry->callback = NULL;
+					entry->user_data = NULL;
+#ifdef IOT_THREAD_SUPPORT
+					os_thread_condition_broadcast(
+						&lib->transaction_signal );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+				}
+			}
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &lib->transaction_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+		if ( callback )
+			callback( lib, txn, status, user_data );
+	}
+}
+
+void iot_transaction_finish(
+	iot_t *lib,
+	iot_transaction_t txn,
+	iot_status_t status )
+{
+	iot_base_transaction_complete( lib, txn, status, IOT_TRUE );
+}
+
 iot_status_t iot_transaction_status(
 	iot_t *lib,
 	const iot_transaction_t *txn,
@@ -1374,14 +1753,72 @@ iot_status_t iot_transaction_status(
 	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
 	if ( lib && txn )
 	{
-		result = iot_plugin_perform( lib,
-			NULL, &max_time_out,
-			IOT_OPERATION_TRANSACTION_STATUS,
-			txn, NULL, NULL );
+		iot_bool_t is_tracked = IOT_FALSE;
+		result = IOT_STATUS_SUCCESS;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &lib->transaction_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		if ( lib->transaction )
+		{
+			const struct iot_transaction *const entry =
+				&lib->transaction[*txn % IOT_TRANSACTION_SLOTS];
+#ifdef IOT_THREAD_SUPPORT
+			/* wait for the reply, unless the application drives
+			 * the library from its own thread */
+			os_status_t wait_result = OS_STATUS_SUCCESS;
+			os_timestamp_t now = 0u;
+			os_timestamp_t end;
+			os_time( &now, NULL );
+			end = now + max_time_out;
+			while ( !( lib->flags & IOT_FLAG_SINGLE_THREAD ) &&
+				entry->id == *txn &&
+				entry->status == IOT_STATUS_INVOKED &&
+				wait_result == OS_STATUS_SUCCESS )
+			{
+				if ( max_time_out == 0u )
+					wait_result = os_thread_condition_wait(
+						&lib->transaction_signal,
+						&lib->transaction_mutex );
+				else if ( now < end )
+				{
+					wait_result =
+						os_thread_condition_timed_wait(
+						&lib->transaction_signal,
+						&lib->transaction_mutex,
+						(os_millisecond_t)( end - now ) );
+					os_time( &now, NULL );
+				}
+				else
+					wait_result = OS_STATUS_TIMED_OUT;
+			}
+#endif /* ifdef IOT_THREAD_SUPPORT */
+			is_tracked = IOT_TRUE;
+			result = IOT_STATUS_NOT_FOUND;
+			if ( entry->id == *txn && *txn != 0u )
+				result = entry->status;
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &lib->transaction_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+		/* plug-ins may know more about completed transactions */
+		if ( is_tracked == IOT_FALSE || result == IOT_STATUS_SUCCESS )
+			result = iot_plugin_perform( lib,
+				NULL, &max_time_out,
+				IOT_OPERATION_TRANSACTION_STATUS,
+				txn, NULL, NULL );
 	}
 	return result;
 }
 
+void iot_transaction_status_set(
+	iot_t *lib,
+	iot_transaction_t txn,
+	iot_status_t status )
+{
+	iot_base_transaction_complete( lib, txn, status, IOT_FALSE );
+}
+
 iot_version_t iot_version( void )
 {
 	return iot_version_encode( IOT_VERSION_MAJOR, IOT_VERSION_MINOR,
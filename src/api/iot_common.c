@@ -47,6 +47,19 @@ static IOT_SECTION iot_status_t iot_perform_conversion( struct iot_data *to,
  */
 static IOT_SECTION iot_bool_t iot_common_data_no_decimal( double number );
 
+/**
+ * @brief Returns the hash of a name, ignoring case
+ *
+ * @param[in]      name                name to hash
+ *
+ * @return FNV-1a hash of the lower-case name
+ */
+static IOT_SECTION iot_uint32_t iot_common_index_hash( const char *name );
+
+/** @brief Returns the name of an object held in an index */
+#define IOT_INDEX_NAME( index, obj ) \
+	( *(const char *const *)( (const char *)(obj) + (index)->name_offset ) )
+
 iot_status_t iot_perform_conversion( struct iot_data *to,
 	const struct iot_data *from, iot_bool_t convert )
 {
@@ -1727,3 +1740,181 @@ iot_bool_t iot_common_data_no_decimal( double number )
 	return result;
 }
 
+
+iot_uint32_t iot_common_index_hash( const char *name )
+{
+	iot_uint32_t result = 2166136261u;
+	size_t i;
+	for ( i = 0u; i < IOT_NAME_MAX_LEN && name[i] != '\0'; ++i )
+	{
+		char c = name[i];
+		if ( c >= 'A' && c <= 'Z' )
+			c = (char)( c - 'A' + 'a' );
+		result = ( result ^ (iot_uint8_t)c ) * 16777619u;
+	}
+	return result;
+}
+
+void *iot_common_index_find( const struct iot_index *index,
+	const char *name )
+{
+	void *result = NULL;
+	if ( index && index->slot && name )
+	{
+		iot_uint32_t i = iot_common_index_hash( name ) % index->size;
+		while ( result == NULL && index->slot[i] )
+		{
+			if ( os_strncasecmp( IOT_INDEX_NAME( index, index->slot[i] ),
+				name, IOT_NAME_MAX_LEN ) == 0 )
+				result = index->slot[i];
+			else
+				i = ( i + 1u ) % index->size;
+		}
+	}
+	return result;
+}
+
+void iot_common_index_initialize( struct iot_index *index,
+	size_t name_offset, void **slot, iot_uint32_t size )
+{
+	os_memzero( slot, sizeof( void * ) * size );
+	index->count = 0u;
+	index->name_offset = name_offset;
+	index->size = size;
+	index->slot = slot;
+#ifndef IOT_STACK_ONLY
+	index->is_in_heap = IOT_FALSE;
+#endif /* ifndef IOT_STACK_ONLY */
+}
+
+iot_status_t iot_common_index_insert( struct iot_index *index, void *obj )
+{
+	iot_status_t result = iot_common_index_reserve( index,
+		index->count + 1u );
+	if ( result == IOT_STATUS_SUCCESS )
+	{
+		iot_uint32_t i = iot_common_index_hash(
+			IOT_INDEX_NAME( index, obj ) ) % index->size;
+		while ( index->slot[i] )
+			i = ( i + 1u ) % index->size;
+		index->slot[i] = obj;
+		++index->count;
+	}
+	return result;
+}
+
+iot_status_t iot_common_index_remove( struct iot_index *index,
+	const void *obj )
+{
+	iot_status_t result = IOT_STATUS_NOT_FOUND;
+	if ( index->slot )
+	{
+		iot_uint32_t i = iot_common_index_hash(
+			IOT_INDEX_NAME( index, obj ) ) % index->size;
+		while ( index->slot[i] && index->slot[i] != obj )
+			i = ( i + 1u ) % index->size;
+
+		if ( index->slot[i] )
+		{
+			iot_uint32_t j = ( i + 1u ) % index->size;
+			index->slot[i] = NULL;
+			--index->count;
+
+			/* move back any object that probed past the new hole,
+			 * unless its home slot lies between the hole and it */
+			while ( index->slot[j] )
+			{
+				const iot_uint32_t home = iot_common_index_hash(
+					IOT_INDEX_NAME( index, index->slot[j] ) ) %
+					index->size;
+				if ( i <= j ? ( home <= i || home > j ) :
+					( home <= i && home > j ) )
+				{
+					index->slot[i] = index->slot[j];
+					index->slot[j] = NULL;
+					i = j;
+				}
+				j = ( j + 1u ) % index->size;
+			}
+			result = IOT_STATUS_SUCCESS;
+		}
+	}
+	return result;
+}
+
+iot_status_t iot_common_index_reserve( struct iot_index *index,
+	iot_uint32_t count )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	if ( IOT_INDEX_SIZE( count ) > index->size )
+	{
+#ifdef IOT_STACK_ONLY
+		result = IOT_STATUS_FULL;
+#else /* ifdef IOT_STACK_ONLY */
+		iot_uint32_t size = index->size;
+		void **slot;
+
+		while ( size < IOT_INDEX_SIZE( count ) )
+			size = IOT_INDEX_SIZE( size );
+		result = IOT_STATUS_NO_MEMORY;
+		slot = (void **)os_malloc( sizeof( void * ) * size );
+		if ( slot )
+		{
+			void **const old_slot = index->slot;
+			const iot_uint32_t old_size = index->size;
+			const iot_bool_t old_in_heap = index->is_in_heap;
+			iot_uint32_t i;
+
+			/* rehash objects into the larger table */
+			os_memzero( slot, sizeof( void * ) * size );
+			index->count = 0u;
+			index->size = size;
+			index->slot = slot;
+			index->is_in_heap = IOT_TRUE;
+			for ( i = 0u; i < old_size; ++i )
+				if ( old_slot[i] )
+					iot_common_index_insert( index, old_slot[i] );
+			if ( old_in_heap != IOT_FALSE )
+				os_free( old_slot );
+			result = IOT_STATUS_SUCCESS;
+		}
+#endif /* else IOT_STACK_ONLY */
+	}
+	return result;
+}
+
+void iot_common_index_terminate( struct iot_index *index )
+{
+#ifndef IOT_STACK_ONLY
+	if ( index->is_in_heap != IOT_FALSE )
+		os_free_null( (void **)&index->slot );
+#endif /* ifndef IOT_STACK_ONLY */
+	os_memzero( index, sizeof( struct iot_index ) );
+}
+
+#ifndef IOT_STACK_ONLY
+void **iot_common_list_grow( void **heap, void *const *initial,
+	iot_uint32_t *max )
+{
+	const iot_uint32_t old_max = *max;
+	const iot_uint32_t new_max = old_max * 2u;
+	void **result;
+	if ( heap )
+		result = (void **)os_realloc( heap,
+			sizeof( void * ) * new_max );
+	else
+	{
+		result = (void **)os_malloc( sizeof( void * ) * new_max );
+		if ( result )
+			os_memcpy( result, initial, sizeof( void * ) * old_max );
+	}
+
+	if ( result )
+	{
+		os_memzero( &result[old_max],
+			sizeof( void * ) * ( new_max - old_max ) );
+		*max = new_max;
+	}
+	return result;
+}
+#endif /* ifndef IOT_STACK_ONLY */
@@ -185,5 +185,100 @@ IOT_SECTION iot_bool_t iot_common_data_convert(
 	iot_type_t to_type,
 	struct iot_data *obj );
 
+/**
+ * @brief Finds an object in an index by name (case-insensitive)
+ *
+ * @param[in]      index               index to search
+ * @param[in]      name                name of the object to find
+ *
+ * @retval NULL                        object not found
+ * @retval !NULL                       object with the name given
+ */
+IOT_SECTION void *iot_common_index_find( const struct iot_index *index,
+	const char *name );
+
+/**
+ * @brief Sets up an empty index
+ *
+ * @param[out]     index               index to set up
+ * @param[in]      name_offset         offset of the name pointer within
+ *                                     the objects to be indexed
+ * @param[in]      slot                initial storage for the table
+ * @param[in]      size                number of slots in @p slot
+ */
+IOT_SECTION void iot_common_index_initialize( struct iot_index *index,
+	size_t name_offset, void **slot, iot_uint32_t size );
+
+/**
+ * @brief Adds an object to an index
+ *
+ * @param[in,out]  index               index to add the object to
+ * @param[in]      obj                 object to add (named at the offset
+ *                                     given on initialization)
+ *
+ * @retval IOT_STATUS_FULL             index is full (IOT_STACK_ONLY)
+ * @retval IOT_STATUS_NO_MEMORY        failed to grow the index
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see iot_common_index_reserve
+ */
+IOT_SECTION iot_status_t iot_common_index_insert( struct iot_index *index,
+	void *obj );
+
+/**
+ * @brief Removes an object from an index
+ *
+ * @param[in,out]  index               index to remove the object from
+ * @param[in]      obj                 object to remove
+ *
+ * @retval IOT_STATUS_NOT_FOUND        object is not in the index
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+IOT_SECTION iot_status_t iot_common_index_remove( struct iot_index *index,
+	const void *obj );
+
+/**
+ * @brief Ensures an index has room for a number of objects
+ *
+ * Moves the table to the heap, if required, so that adding objects up to
+ * @p count afterwards cannot fail.
+ *
+ * @param[in,out]  index               index to grow
+ * @param[in]      count               number of objects to make room for
+ *
+ * @retval IOT_STATUS_FULL             index can't grow (IOT_STACK_ONLY)
+ * @retval IOT_STATUS_NO_MEMORY        failed to allocate a larger table
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+IOT_SECTION iot_status_t iot_common_index_reserve( struct iot_index *index,
+	iot_uint32_t count );
+
+/**
+ * @brief Frees any memory held by an index and empties it
+ *
+ * @param[in,out]  index               index to terminate
+ */
+IOT_SECTION void iot_common_index_terminate( struct iot_index *index );
+
+#ifndef IOT_STACK_ONLY
+/**
+ * @brief Doubles the size of a list of object pointers
+ *
+ * The first time a list grows, the pointers in its initial storage are
+ * copied to the heap.  Afterwards the heap allocation is resized.  New
+ * slots are set to NULL.
+ *
+ * @param[in]      heap                list on the heap (NULL if none yet)
+ * @param[in]      initial             initial storage of the list
+ * @param[in,out]  max                 number of pointers in the list,
+ *                                     updated on success
+ *
+ * @retval NULL                        out of memory (list is unchanged)
+ * @retval !NULL                       list on the heap
+ */
+IOT_SECTION void **iot_common_list_grow( void **heap, void *const *initial,
+	iot_uint32_t *max );
+#endif /* ifndef IOT_STACK_ONLY */
+
 #endif /* ifndef IOT_COMMON_H */
 
@@ -1035,38 +1035,32 @@ iot_status_t iot_mqtt_publish(
 			payload, qos, retain ) == MOSQ_ERR_SUCCESS )
 			result = IOT_STATUS_SUCCESS;
 #else /* ifdef IOT_MQTT_MOSQUITTO */
-		void *pl = os_malloc( payload_len );
-		result = IOT_STATUS_NO_MEMORY;
-		if ( pl )
-		{
 #ifdef IOT_THREAD_SUPPORT
-			int rs;
-			const MQTTAsync_token token = mqtt->msg_id++;
-			MQTTAsync_responseOptions opts =
-				MQTTAsync_responseOptions_initializer;
-			opts.context = mqtt;
-			opts.token = token;
-			opts.onFailure = iot_mqtt_on_failure;
-			opts.onSuccess = iot_mqtt_on_success;
-
-			os_memcpy( pl, payload, payload_len );
-			result = IOT_STATUS_IO_ERROR;
-			rs = MQTTAsync_send( mqtt->client, topic,
-				(int)payload_len, pl, qos, retain, &opts );
-			if ( rs == MQTTASYNC_SUCCESS )
+		int rs;
+		const MQTTAsync_token token = mqtt->msg_id++;
+		MQTTAsync_responseOptions opts =
+			MQTTAsync_responseOptions_initializer;
+		opts.context = mqtt;
+		opts.token = token;
+		opts.onFailure = iot_mqtt_on_failure;
+		opts.onSuccess = iot_mqtt_on_success;
+
+		/* the client library takes its own copy of the payload,
+		 * so it is passed through without another one here */
+		result = IOT_STATUS_IO_ERROR;
+		rs = MQTTAsync_send( mqtt->client, topic,
+			(int)payload_len, payload, qos, retain, &opts );
+		if ( rs == MQTTASYNC_SUCCESS )
 #else /* ifdef IOT_THREAD_SUPPORT */
-			MQTTClient_deliveryToken token;
-			os_memcpy( pl, payload, payload_len );
-			result = IOT_STATUS_IO_ERROR;
-			if ( MQTTClient_publish( mqtt->client, topic,
-				(int)payload_len, pl, qos, retain, &token )
-				== MQTTCLIENT_SUCCESS )
+		MQTTClient_deliveryToken token;
+		result = IOT_STATUS_IO_ERROR;
+		if ( MQTTClient_publish( mqtt->client, topic,
+			(int)payload_len, payload, qos, retain, &token )
+			== MQTTCLIENT_SUCCESS )
 #endif /* ifdef IOT_THREAD_SUPPORT */
-			{
-				mid = (int)token;
-				result = IOT_STATUS_SUCCESS;
-			}
-			os_free( pl );
+		{
+			mid = (int)token;
+			result = IOT_STATUS_SUCCESS;
 		}
 #endif /* else IOT_MQTT_MOSQUITTO */
 	}
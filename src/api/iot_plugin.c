@@ -232,6 +232,25 @@ iot_status_t iot_plugin_perform(
 	const void *item,
 	const void *value,
 	const iot_options_t *options )
+{
+	iot_status_t result;
+	if ( lib && txn )
+		*txn = iot_transaction_allocate( lib );
+	result = iot_plugin_perform_transaction( lib, txn, max_time_out, op,
+		item, value, options );
+	if ( lib && txn )
+		iot_transaction_finish( lib, *txn, result );
+	return result;
+}
+
+iot_status_t iot_plugin_perform_transaction(
+	iot_t *lib,
+	iot_transaction_t *txn,
+	iot_millisecond_t *max_time_out,
+	iot_operation_t op,
+	const void *item,
+	const void *value,
+	const iot_options_t *options )
 {
 	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
 	iot_millisecond_t time_remaining;
@@ -253,13 +272,6 @@ iot_status_t iot_plugin_perform(
 		if ( time_remaining == 0u )
 			ignore_time_out = IOT_TRUE;
 
-		if ( txn )
-		{
-			if ( lib->transaction_count == 0u )
-				++lib->transaction_count;
-			*txn = lib->transaction_count++;
-		}
-
 		for ( i = IOT_STEP_BEFORE; i <= IOT_STEP_AFTER
 			&& (ignore_time_out || time_remaining > 0u); ++i )
 		{
@@ -0,0 +1,924 @@
+/**
+ * @file
+ * @brief source file for running commands without a shell
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "shared/iot_types.h"
+
+#ifdef IOT_SPAWN_SUPPORT
+#include <errno.h>        /* for errno, EAGAIN, EINTR */
+#include <fcntl.h>        /* for fcntl, O_RDONLY, O_WRONLY */
+#include <poll.h>         /* for poll */
+#include <signal.h>       /* for kill, sigaction */
+#include <spawn.h>        /* for posix_spawnp */
+#include <stddef.h>       /* for offsetof */
+#include <sys/socket.h>   /* for recvmsg, sendmsg, socketpair */
+#include <sys/types.h>    /* for pid_t */
+#include <sys/wait.h>     /* for waitpid */
+#include <unistd.h>       /* for close, fork, pipe, read, write */
+
+/** @brief Maximum number of commands the helper process waits on */
+#define IOT_SPAWN_HELPER_CHILD_MAX               64u
+/** @brief Number of file descriptors sent to the helper with a command */
+#define IOT_SPAWN_HELPER_FD_COUNT                3u
+/** @brief Time in milliseconds between checks the helper makes on the
+ *         process that started it */
+#define IOT_SPAWN_HELPER_POLL_TIME               1000
+/** @brief Maximum number of arguments sent to the helper */
+#define IOT_SPAWN_HELPER_ARGC_MAX                255u
+/** @brief Number of characters of output read at once */
+#define IOT_SPAWN_READ_CHUNK                     4096u
+/** @brief Time in milliseconds between checks whether a child of this
+ *         process exited while its output is still open */
+#define IOT_SPAWN_REAP_INTERVAL                  10
+
+/** @brief Environment passed to commands */
+extern char **environ;
+
+/**
+ * @brief command sent to the helper process
+ */
+struct iot_spawn_request
+{
+	/** @brief whether output is captured (pipes are sent) */
+	iot_uint8_t capture;
+	/** @brief number of arguments */
+	iot_uint8_t argc;
+	/** @brief arguments, each terminated by a null character */
+	char argv[ PATH_MAX + 1u ];
+};
+
+/**
+ * @brief command started by the helper process
+ */
+struct iot_spawn_child
+{
+	/** @brief process id (0 if the slot is not used) */
+	pid_t pid;
+	/** @brief socket to send the exit status on */
+	int reply_fd;
+};
+
+/** @brief Write end of the pipe telling the helper that a command exited */
+static int iot_spawn_signal_fd = -1;
+
+/**
+ * @brief Sets a file descriptor to close when a command is executed
+ *
+ * @param[in]      fd                  file descriptor to set
+ */
+static IOT_SECTION void iot_spawn_cloexec(
+	int fd );
+
+/**
+ * @brief Main loop of the helper process, never returns
+ *
+ * @param[in]      fd                  socket receiving commands to start
+ */
+static IOT_SECTION void iot_spawn_helper_main(
+	int fd );
+
+/**
+ * @brief Sends a command to the helper process to start
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in]      args                command to start
+ * @param[in]      out_fd              standard output of the command (optional)
+ * @param[in]      err_fd              standard error of the command (optional)
+ * @param[out]     pid                 process id of the command
+ * @param[out]     status_fd           socket the exit status is sent on
+ *
+ * @retval IOT_STATUS_FAILURE          helper failed to start the command
+ * @retval IOT_STATUS_NOT_SUPPORTED    arguments too long to send
+ * @retval IOT_STATUS_SUCCESS          command started
+ */
+static IOT_SECTION iot_status_t iot_spawn_helper_launch(
+	iot_t *lib,
+	const struct iot_spawn_args *args,
+	int out_fd,
+	int err_fd,
+	pid_t *pid,
+	int *status_fd );
+
+/**
+ * @brief Starts a command received by the helper process
+ *
+ * @param[in]      fd                  socket receiving commands to start
+ * @param[in,out]  child               commands started by the helper
+ */
+static IOT_SECTION void iot_spawn_helper_request(
+	int fd,
+	struct iot_spawn_child *child );
+
+/**
+ * @brief Signal handler of the helper process for exiting commands
+ *
+ * @param[in]      sig                 signal received
+ */
+static void iot_spawn_helper_signal(
+	int sig );
+
+/**
+ * @brief Copies the arguments of a command one after the other
+ *
+ * @param[out]     request             request to copy the arguments to
+ * @param[in]      argv                program and its arguments
+ * @param[out]     used                number of characters copied
+ *
+ * @retval IOT_STATUS_NOT_SUPPORTED    too many, or too long, arguments
+ * @retval IOT_STATUS_SUCCESS          arguments copied
+ *
+ * @see iot_spawn_unpack
+ */
+static IOT_SECTION iot_status_t iot_spawn_pack(
+	struct iot_spawn_request *request,
+	const char *const *argv,
+	size_t *used );
+
+/**
+ * @brief Creates a pipe, closed when a command is executed
+ *
+ * @param[out]     fd                  read and write ends of the pipe
+ *
+ * @retval 0                           on success
+ * @retval -1                          on failure
+ */
+static IOT_SECTION int iot_spawn_pipe(
+	int fd[2] );
+
+/**
+ * @brief Starts a command
+ *
+ * @param[out]     pid                 process id of the command
+ * @param[in]      argv                program and its arguments
+ * @param[in]      out_fd              standard output of the command
+ *                                     (-1 to discard)
+ * @param[in]      err_fd              standard error of the command
+ *                                     (-1 to discard)
+ *
+ * @retval 0                           on success
+ * @retval !0                          error number on failure
+ */
+static IOT_SECTION int iot_spawn_process(
+	pid_t *pid,
+	char *const argv[],
+	int out_fd,
+	int err_fd );
+
+/**
+ * @brief Reads output of a command into a buffer
+ *
+ * Output is passed to the output callback, if any, as it is read; output
+ * beyond the size of the buffer is discarded.
+ *
+ * @param[in,out]  args                command started
+ * @param[in]      is_err              whether reading standard error
+ * @param[in,out]  fd                  pipe to read (closed, and set to -1, at
+ *                                     the end of the output)
+ * @param[in,out]  used                number of characters in the buffer
+ */
+static IOT_SECTION void iot_spawn_read(
+	struct iot_spawn_args *args,
+	iot_bool_t is_err,
+	int *fd,
+	size_t *used );
+
+/**
+ * @brief Splits the arguments copied into a request
+ *
+ * @param[out]     argv                pointers to the arguments, terminated
+ *                                     by NULL (holds at least
+ *                                     IOT_SPAWN_HELPER_ARGC_MAX + 1 items)
+ * @param[in]      request             request holding the arguments
+ * @param[in]      used                number of characters in the request
+ *
+ * @return the number of complete arguments
+ *
+ * @see iot_spawn_pack
+ */
+static IOT_SECTION size_t iot_spawn_unpack(
+	char *argv[],
+	struct iot_spawn_request *request,
+	size_t used );
+
+/**
+ * @brief Waits for a command to exit, collecting its output
+ *
+ * @param[in,out]  args                command started (return code updated)
+ * @param[in]      pid                 process id of the command
+ * @param[in]      out_fd              standard output pipe (closed on return)
+ * @param[in]      err_fd              standard error pipe (closed on return)
+ * @param[in]      status_fd           socket the helper sends the exit status
+ *                                     on (-1 if the command is a child of
+ *                                     this process)
+ *
+ * @retval IOT_STATUS_FAILURE          failed waiting for the command
+ * @retval IOT_STATUS_SUCCESS          command exited
+ * @retval IOT_STATUS_TIMED_OUT        command was killed, or its output was
+ *                                     still open, when the time limit passed
+ */
+static IOT_SECTION iot_status_t iot_spawn_wait(
+	struct iot_spawn_args *args,
+	pid_t pid,
+	int out_fd,
+	int err_fd,
+	int status_fd );
+
+void iot_spawn_cloexec( int fd )
+{
+	const int flags = fcntl( fd, F_GETFD );
+	if ( flags >= 0 )
+		fcntl( fd, F_SETFD, flags | FD_CLOEXEC );
+}
+
+void iot_spawn_helper_main( int fd )
+{
+	struct iot_spawn_child child[ IOT_SPAWN_HELPER_CHILD_MAX ];
+	struct sigaction action;
+	sigset_t mask;
+	const pid_t parent = getppid();
+	int signal_pipe[2];
+	size_t i;
+
+	os_memzero( child, sizeof( child ) );
+	if ( pipe( signal_pipe ) != 0 )
+		_exit( 1 );
+	for ( i = 0u; i < 2u; ++i )
+	{
+		iot_spawn_cloexec( signal_pipe[i] );
+		fcntl( signal_pipe[i], F_SETFL,
+			fcntl( signal_pipe[i], F_GETFL ) | O_NONBLOCK );
+	}
+	iot_spawn_signal_fd = signal_pipe[1];
+
+	/* handlers of the library process must not run in the helper */
+	os_memzero( &action, sizeof( struct sigaction ) );
+	sigemptyset( &action.sa_mask );
+	action.sa_handler = SIG_DFL;
+	sigaction( SIGHUP, &action, NULL );
+	sigaction( SIGINT, &action, NULL );
+	sigaction( SIGTERM, &action, NULL );
+	action.sa_handler = SIG_IGN;
+	sigaction( SIGPIPE, &action, NULL );
+	action.sa_handler = iot_spawn_helper_signal;
+	action.sa_flags = SA_NOCLDSTOP | SA_RESTART;
+	sigaction( SIGCHLD, &action, NULL );
+	sigemptyset( &mask );
+	sigprocmask( SIG_SETMASK, &mask, NULL );
+
+	/* exit along with the library process */
+	while ( getppid() == parent )
+	{
+		struct pollfd pfd[2];
+		pfd[0].fd = fd;
+		pfd[0].events = POLLIN;
+		pfd[0].revents = 0;
+		pfd[1].fd = signal_pipe[0];
+		pfd[1].events = POLLIN;
+		pfd[1].revents = 0;
+		if ( poll( pfd, 2u, IOT_SPAWN_HELPER_POLL_TIME ) > 0 )
+		{
+			if ( pfd[1].revents & POLLIN )
+			{
+				char c;
+				int status = 0;
+				pid_t pid;
+
+				while ( read( signal_pipe[0], &c, 1u ) > 0 );
+				while ( ( pid = waitpid( -1, &status,
+					WNOHANG ) ) > 0 )
+				{
+					for ( i = 0u; i < IOT_SPAWN_HELPER_CHILD_MAX; ++i )
+					{
+						if ( child[i].pid == pid )
+						{
+							if ( write( child[i].reply_fd,
+								&status, sizeof( int ) ) < 0 )
+								status = 0;
+							close( child[i].reply_fd );
+							child[i].pid = 0;
+						}
+					}
+				}
+			}
+			if ( pfd[0].revents & POLLIN )
+				iot_spawn_helper_request( fd, child );
+		}
+	}
+	_exit( 0 );
+}
+
+iot_status_t iot_spawn_helper_launch(
+	iot_t *lib,
+	const struct iot_spawn_args *args,
+	int out_fd,
+	int err_fd,
+	pid_t *pid,
+	int *status_fd )
+{
+	iot_status_t result;
+	struct iot_spawn_request request;
+	size_t used = 0u;
+
+	/* arguments are sent one after the other */
+	result = iot_spawn_pack( &request, args->argv, &used );
+	if ( result == IOT_STATUS_SUCCESS )
+	{
+		int reply[2];
+
+		result = IOT_STATUS_FAILURE;
+		if ( out_fd >= 0 && err_fd >= 0 )
+			request.capture = 1u;
+		if ( socketpair( AF_UNIX, SOCK_STREAM, 0, reply ) == 0 )
+		{
+			union
+			{
+				struct cmsghdr align;
+				char buf[ CMSG_SPACE( sizeof( int ) *
+					IOT_SPAWN_HELPER_FD_COUNT ) ];
+			} control;
+			struct cmsghdr *cmsg;
+			struct iovec iov;
+			struct msghdr msg;
+			size_t fd_count = 1u;
+			int fds[ IOT_SPAWN_HELPER_FD_COUNT ];
+
+			iot_spawn_cloexec( reply[0] );
+			iot_spawn_cloexec( reply[1] );
+			fds[0] = reply[1];
+			fds[1] = out_fd;
+			fds[2] = err_fd;
+			if ( request.capture )
+				fd_count = IOT_SPAWN_HELPER_FD_COUNT;
+
+			os_memzero( &control, sizeof( control ) );
+			os_memzero( &msg, sizeof( struct msghdr ) );
+			iov.iov_base = &request;
+			iov.iov_len = offsetof( struct iot_spawn_request, argv ) +
+				used;
+			msg.msg_iov = &iov;
+			msg.msg_iovlen = 1u;
+			msg.msg_control = control.buf;
+			msg.msg_controllen = CMSG_SPACE( sizeof( int ) * fd_count );
+			cmsg = CMSG_FIRSTHDR( &msg );
+			cmsg->cmsg_level = SOL_SOCKET;
+			cmsg->cmsg_type = SCM_RIGHTS;
+			cmsg->cmsg_len = CMSG_LEN( sizeof( int ) * fd_count );
+			os_memcpy( CMSG_DATA( cmsg ), fds, sizeof( int ) * fd_count );
+
+			if ( sendmsg( lib->spawn_helper_fd, &msg, 0 ) >= 0 )
+			{
+				int child = 0;
+
+				/* the helper keeps its own copy of the socket */
+				close( reply[1] );
+				reply[1] = -1;
+				if ( read( reply[0], &child, sizeof( int ) ) ==
+					(ssize_t)sizeof( int ) && child > 0 )
+				{
+					*pid = (pid_t)child;
+					*status_fd = reply[0];
+					reply[0] = -1;
+					result = IOT_STATUS_SUCCESS;
+				}
+			}
+			if ( reply[0] >= 0 )
+				close( reply[0] );
+			if ( reply[1] >= 0 )
+				close( reply[1] );
+		}
+	}
+	return result;
+}
+
+void iot_spawn_helper_request(
+	int fd,
+	struct iot_spawn_child *child )
+{
+	union
+	{
+		struct cmsghdr align;
+		char buf[ CMSG_SPACE( sizeof( int ) *
+			IOT_SPAWN_HELPER_FD_COUNT ) ];
+	} control;
+	struct iot_spawn_request request;
+	struct iovec iov;
+	struct msghdr msg;
+	ssize_t len;
+	size_t i;
+	int fds[ IOT_SPAWN_HELPER_FD_COUNT ];
+
+	for ( i = 0u; i < IOT_SPAWN_HELPER_FD_COUNT; ++i )
+		fds[i] = -1;
+	os_memzero( &msg, sizeof( struct msghdr ) );
+	iov.iov_base = &request;
+	iov.iov_len = sizeof( struct iot_spawn_request );
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1u;
+	msg.msg_control = control.buf;
+	msg.msg_controllen = sizeof( control.buf );
+
+	len = recvmsg( fd, &msg, 0 );
+	if ( len >= (ssize_t)offsetof( struct iot_spawn_request, argv ) )
+	{
+		struct cmsghdr *const cmsg = CMSG_FIRSTHDR( &msg );
+		char *argv[ IOT_SPAWN_HELPER_ARGC_MAX + 1u ];
+		const size_t used = (size_t)len -
+			offsetof( struct iot_spawn_request, argv );
+		size_t argc;
+		size_t fd_count = 0u;
+		int reply = -1;
+
+		if ( cmsg && cmsg->cmsg_level == SOL_SOCKET &&
+			cmsg->cmsg_type == SCM_RIGHTS )
+		{
+			fd_count = ( cmsg->cmsg_len - CMSG_LEN( 0u ) ) /
+				sizeof( int );
+			if ( fd_count > IOT_SPAWN_HELPER_FD_COUNT )
+				fd_count = IOT_SPAWN_HELPER_FD_COUNT;
+			os_memcpy( fds, CMSG_DATA( cmsg ),
+				sizeof( int ) * fd_count );
+			for ( i = 0u; i < fd_count; ++i )
+				iot_spawn_cloexec( fds[i] );
+		}
+
+		/* split the arguments, which must all be terminated */
+		argc = iot_spawn_unpack( argv, &request, used );
+
+		/* find a slot to remember the command in */
+		for ( i = 0u; i < IOT_SPAWN_HELPER_CHILD_MAX &&
+			child[i].pid != 0; ++i );
+
+		if ( fds[0] >= 0 && argc > 0u && argc == request.argc &&
+			i < IOT_SPAWN_HELPER_CHILD_MAX &&
+			( !request.capture ||
+			  fd_count == IOT_SPAWN_HELPER_FD_COUNT ) )
+		{
+			pid_t pid = 0;
+			if ( iot_spawn_process( &pid, argv,
+				request.capture ? fds[1] : -1,
+				request.capture ? fds[2] : -1 ) == 0 )
+			{
+				child[i].pid = pid;
+				child[i].reply_fd = fds[0];
+				reply = (int)pid;
+			}
+		}
+
+		/* process id first, the exit status follows */
+		if ( fds[0] >= 0 )
+		{
+			if ( write( fds[0], &reply, sizeof( int ) ) < 0 )
+				reply = -1;
+			if ( reply <= 0 )
+				close( fds[0] );
+		}
+		for ( i = 1u; i < IOT_SPAWN_HELPER_FD_COUNT; ++i )
+			if ( fds[i] >= 0 )
+				close( fds[i] );
+	}
+}
+
+void iot_spawn_helper_signal( int sig )
+{
+	const int saved_errno = errno;
+	const char c = (char)sig;
+	/* pipe is non-blocking, if full the helper is already woken */
+	if ( write( iot_spawn_signal_fd, &c, 1u ) < 0 )
+		errno = saved_errno;
+	errno = saved_errno;
+}
+
+iot_status_t iot_spawn_pack(
+	struct iot_spawn_request *request,
+	const char *const *argv,
+	size_t *used )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	size_t argc;
+
+	os_memzero( request, offsetof( struct iot_spawn_request, argv ) );
+	*used = 0u;
+	for ( argc = 0u; result == IOT_STATUS_SUCCESS && argv[argc]; ++argc )
+	{
+		const size_t len = os_strlen( argv[argc] ) + 1u;
+		if ( argc < IOT_SPAWN_HELPER_ARGC_MAX &&
+			*used + len <= sizeof( request->argv ) )
+		{
+			os_memcpy( &request->argv[*used], argv[argc], len );
+			*used += len;
+		}
+		else
+			result = IOT_STATUS_NOT_SUPPORTED;
+	}
+	request->argc = (iot_uint8_t)argc;
+	return result;
+}
+
+int iot_spawn_pipe( int fd[2] )
+{
+	int result = pipe( fd );
+	if ( result == 0 )
+	{
+		iot_spawn_cloexec( fd[0] );
+		iot_spawn_cloexec( fd[1] );
+	}
+	return result;
+}
+
+int iot_spawn_process(
+	pid_t *pid,
+	char *const argv[],
+	int out_fd,
+	int err_fd )
+{
+	posix_spawn_file_actions_t file_actions;
+	posix_spawnattr_t attr;
+	sigset_t mask;
+	int result;
+
+	posix_spawn_file_actions_init( &file_actions );
+	posix_spawn_file_actions_addopen( &file_actions, STDIN_FILENO,
+		"/dev/null", O_RDONLY, 0 );
+	if ( out_fd >= 0 )
+		posix_spawn_file_actions_adddup2( &file_actions, out_fd,
+			STDOUT_FILENO );
+	else
+		posix_spawn_file_actions_addopen( &file_actions,
+			STDOUT_FILENO, "/dev/null", O_WRONLY, 0 );
+	if ( err_fd >= 0 )
+		posix_spawn_file_actions_adddup2( &file_actions, err_fd,
+			STDERR_FILENO );
+	else
+		posix_spawn_file_actions_addopen( &file_actions,
+			STDERR_FILENO, "/dev/null", O_WRONLY, 0 );
+
+	/* commands start with no signals blocked and default handlers */
+	posix_spawnattr_init( &attr );
+	sigemptyset( &mask );
+	posix_spawnattr_setsigmask( &attr, &mask );
+	sigaddset( &mask, SIGCHLD );
+	sigaddset( &mask, SIGPIPE );
+	posix_spawnattr_setsigdefault( &attr, &mask );
+	posix_spawnattr_setflags( &attr,
+		POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF );
+
+	result = posix_spawnp( pid, argv[0], &file_actions, &attr, argv,
+		environ );
+
+	posix_spawnattr_destroy( &attr );
+	posix_spawn_file_actions_destroy( &file_actions );
+	return result;
+}
+
+void iot_spawn_read(
+	struct iot_spawn_args *args,
+	iot_bool_t is_err,
+	int *fd,
+	size_t *used )
+{
+	char chunk[ IOT_SPAWN_READ_CHUNK ];
+	char *buf = args->std_out;
+	size_t len = args->std_out_len;
+	ssize_t count;
+
+	if ( is_err != IOT_FALSE )
+	{
+		buf = args->std_err;
+		len = args->std_err_len;
+	}
+
+	count = read( *fd, chunk, sizeof( chunk ) );
+	if ( count > 0 )
+	{
+		size_t copy = (size_t)count;
+		if ( buf && *used + 1u < len )
+		{
+			if ( copy > len - *used - 1u )
+				copy = len - *used - 1u;
+			os_memcpy( &buf[*used], chunk, copy );
+			*used += copy;
+		}
+		if ( args->output )
+			args->output( args->user_data, is_err, chunk,
+				(size_t)count );
+	}
+	else if ( count == 0 || ( errno != EINTR && errno != EAGAIN ) )
+	{
+		close( *fd );
+		*fd = -1;
+	}
+}
+
+size_t iot_spawn_unpack(
+	char *argv[],
+	struct iot_spawn_request *request,
+	size_t used )
+{
+	size_t result = 0u;
+	size_t pos = 0u;
+	while ( pos < used && result < request->argc )
+	{
+		argv[result] = &request->argv[pos];
+		while ( pos < used && request->argv[pos] != '\0' )
+			++pos;
+		if ( pos < used )
+			++result;
+		++pos;
+	}
+	argv[result] = NULL;
+	return result;
+}
+
+iot_status_t iot_spawn_wait(
+	struct iot_spawn_args *args,
+	pid_t pid,
+	int out_fd,
+	int err_fd,
+	int status_fd )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	iot_bool_t exited = IOT_FALSE;
+	iot_timestamp_t start = 0u;
+	size_t err_used = 0u;
+	size_t out_used = 0u;
+	int status = 0;
+
+	os_time( &start, NULL );
+	while ( result == IOT_STATUS_SUCCESS &&
+		( exited == IOT_FALSE || out_fd >= 0 || err_fd >= 0 ) )
+	{
+		struct pollfd pfd[3];
+		nfds_t count = 0u;
+		int wait_ms = -1;
+
+		if ( out_fd >= 0 )
+		{
+			pfd[count].fd = out_fd;
+			pfd[count].events = POLLIN;
+			pfd[count].revents = 0;
+			++count;
+		}
+		if ( err_fd >= 0 )
+		{
+			pfd[count].fd = err_fd;
+			pfd[count].events = POLLIN;
+			pfd[count].revents = 0;
+			++count;
+		}
+		if ( status_fd >= 0 && exited == IOT_FALSE )
+		{
+			pfd[count].fd = status_fd;
+			pfd[count].events = POLLIN;
+			pfd[count].revents = 0;
+			++count;
+		}
+
+		/* the time limit also covers collecting the output, a
+		 * process started by the command may keep writing to it */
+		if ( args->max_time_out > 0u )
+		{
+			iot_timestamp_t now = 0u;
+			os_time( &now, NULL );
+			if ( now - start >= args->max_time_out )
+				result = IOT_STATUS_TIMED_OUT;
+			else
+				wait_ms = (int)( args->max_time_out -
+					( now - start ) );
+		}
+		if ( exited != IOT_FALSE )
+			/* only collect what was written before it exited */
+			wait_ms = 0;
+
+		/* a process started by the command may hold the pipes
+		 * open after the command exits */
+		if ( exited == IOT_FALSE && status_fd < 0 && count > 0u &&
+			( wait_ms < 0 || wait_ms > IOT_SPAWN_REAP_INTERVAL ) )
+			wait_ms = IOT_SPAWN_REAP_INTERVAL;
+
+		if ( result == IOT_STATUS_SUCCESS && count == 0u )
+		{
+			/* output closed, reap the child of this process */
+			const pid_t res = waitpid( pid, &status,
+				wait_ms < 0 ? 0 : WNOHANG );
+			if ( res == pid )
+				exited = IOT_TRUE;
+			else if ( res < 0 && errno != EINTR )
+				result = IOT_STATUS_FAILURE;
+			else if ( wait_ms >= 0 )
+				os_time_sleep( 1u, IOT_FALSE );
+		}
+		else if ( result == IOT_STATUS_SUCCESS )
+		{
+			const int res = poll( pfd, count, wait_ms );
+			nfds_t i;
+			if ( res < 0 && errno != EINTR )
+				result = IOT_STATUS_FAILURE;
+			else if ( res == 0 && exited != IOT_FALSE )
+			{
+				/* nothing left to collect */
+				close( out_fd );
+				out_fd = -1;
+				close( err_fd );
+				err_fd = -1;
+			}
+			for ( i = 0u; res > 0 && i < count; ++i )
+			{
+				if ( pfd[i].revents == 0 )
+					continue;
+				if ( pfd[i].fd == out_fd )
+					iot_spawn_read( args, IOT_FALSE,
+						&out_fd, &out_used );
+				else if ( pfd[i].fd == err_fd )
+					iot_spawn_read( args, IOT_TRUE,
+						&err_fd, &err_used );
+				else if ( read( status_fd, &status,
+					sizeof( int ) ) == (ssize_t)sizeof( int ) )
+					exited = IOT_TRUE;
+				else
+					result = IOT_STATUS_FAILURE;
+			}
+
+			if ( result == IOT_STATUS_SUCCESS &&
+				exited == IOT_FALSE && status_fd < 0 &&
+				waitpid( pid, &status, WNOHANG ) == pid )
+				exited = IOT_TRUE;
+		}
+	}
+
+	/* once reaped, the process id may belong to another process */
+	if ( result == IOT_STATUS_TIMED_OUT && exited == IOT_FALSE )
+	{
+		kill( pid, SIGKILL );
+		if ( status_fd < 0 )
+			waitpid( pid, &status, 0 );
+	}
+	if ( out_fd >= 0 )
+		close( out_fd );
+	if ( err_fd >= 0 )
+		close( err_fd );
+
+	if ( args->std_out && args->std_out_len > 0u )
+		args->std_out[out_used] = '\0';
+	if ( args->std_err && args->std_err_len > 0u )
+		args->std_err[err_used] = '\0';
+	if ( result == IOT_STATUS_SUCCESS )
+	{
+		if ( WIFEXITED( status ) )
+			args->return_code = WEXITSTATUS( status );
+		else if ( WIFSIGNALED( status ) )
+			args->return_code = 128 + WTERMSIG( status );
+	}
+	return result;
+}
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
+iot_status_t iot_spawn_helper_start( iot_t *lib )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( lib )
+	{
+#ifdef IOT_SPAWN_SUPPORT
+		int fd[2];
+
+		result = IOT_STATUS_SUCCESS;
+		if ( lib->spawn_helper_pid <= 0 )
+			result = IOT_STATUS_FAILURE;
+		if ( result != IOT_STATUS_SUCCESS &&
+			socketpair( AF_UNIX, SOCK_DGRAM, 0, fd ) == 0 )
+		{
+			const pid_t pid = fork();
+			if ( pid == 0 )
+			{
+				close( fd[0] );
+				iot_spawn_cloexec( fd[1] );
+				iot_spawn_helper_main( fd[1] );
+			}
+
+			close( fd[1] );
+			if ( pid > 0 )
+			{
+				iot_spawn_cloexec( fd[0] );
+				lib->spawn_helper_fd = fd[0];
+				lib->spawn_helper_pid = (int)pid;
+				IOT_LOG( lib, IOT_LOG_DEBUG,
+					"Command helper started: %d", (int)pid );
+				result = IOT_STATUS_SUCCESS;
+			}
+			else
+				close( fd[0] );
+		}
+#else /* ifdef IOT_SPAWN_SUPPORT */
+		result = IOT_STATUS_NOT_SUPPORTED;
+#endif /* else IOT_SPAWN_SUPPORT */
+	}
+	return result;
+}
+
+iot_status_t iot_spawn_helper_stop( iot_t *lib )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( lib )
+	{
+#ifdef IOT_SPAWN_SUPPORT
+		if ( lib->spawn_helper_pid > 0 )
+		{
+			const pid_t pid = (pid_t)lib->spawn_helper_pid;
+			close( lib->spawn_helper_fd );
+			kill( pid, SIGTERM );
+			waitpid( pid, NULL, 0 );
+			lib->spawn_helper_fd = -1;
+			lib->spawn_helper_pid = 0;
+		}
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+		result = IOT_STATUS_SUCCESS;
+	}
+	return result;
+}
+
+iot_status_t iot_spawn_run(
+	iot_t *lib,
+	struct iot_spawn_args *args )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( lib && args && args->argv && args->argv[0] )
+	{
+#ifdef IOT_SPAWN_SUPPORT
+		int err_pipe[2] = { -1, -1 };
+		int out_pipe[2] = { -1, -1 };
+		int status_fd = -1;
+		pid_t pid = 0;
+
+		result = IOT_STATUS_SUCCESS;
+		if ( args->block == IOT_FALSE && lib->spawn_helper_pid <= 0 )
+			/* nothing would reap the command once it exits */
+			result = IOT_STATUS_NOT_SUPPORTED;
+		else if ( args->block != IOT_FALSE &&
+			( iot_spawn_pipe( out_pipe ) != 0 ||
+			  iot_spawn_pipe( err_pipe ) != 0 ) )
+			result = IOT_STATUS_FAILURE;
+
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			if ( lib->spawn_helper_pid > 0 )
+				result = iot_spawn_helper_launch( lib, args,
+					out_pipe[1], err_pipe[1], &pid,
+					&status_fd );
+			else
+			{
+				/* posix_spawnp takes modifiable arguments */
+				struct iot_spawn_request request;
+				char *argv[ IOT_SPAWN_HELPER_ARGC_MAX + 1u ];
+				size_t used = 0u;
+
+				result = iot_spawn_pack( &request, args->argv,
+					&used );
+				if ( result == IOT_STATUS_SUCCESS )
+				{
+					iot_spawn_unpack( argv, &request, used );
+					if ( iot_spawn_process( &pid, argv,
+						out_pipe[1], err_pipe[1] ) != 0 )
+						result = IOT_STATUS_FAILURE;
+				}
+			}
+		}
+
+		/* only the command writes to the pipes */
+		if ( out_pipe[1] >= 0 )
+			close( out_pipe[1] );
+		if ( err_pipe[1] >= 0 )
+			close( err_pipe[1] );
+
+		if ( result == IOT_STATUS_SUCCESS &&
+			args->block != IOT_FALSE )
+			result = iot_spawn_wait( args, pid, out_pipe[0],
+				err_pipe[0], status_fd );
+		else
+		{
+			if ( result == IOT_STATUS_SUCCESS )
+				result = IOT_STATUS_INVOKED;
+			if ( out_pipe[0] >= 0 )
+				close( out_pipe[0] );
+			if ( err_pipe[0] >= 0 )
+				close( err_pipe[0] );
+		}
+		if ( status_fd >= 0 )
+			close( status_fd );
+#else /* ifdef IOT_SPAWN_SUPPORT */
+		result = IOT_STATUS_NOT_SUPPORTED;
+#endif /* else IOT_SPAWN_SUPPORT */
+	}
+	return result;
+}
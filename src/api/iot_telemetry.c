@@ -39,6 +39,115 @@ static IOT_SECTION iot_status_t iot_telemetry_option_set_data(
 	const char *name,
 	const struct iot_data *data );
 
+#ifdef IOT_THREAD_SUPPORT
+/**
+ * @brief Removes any queued samples for a telemetry object
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in]      telemetry           telemetry object being removed
+ *
+ * @note called while holding the telemetry mutex
+ */
+static IOT_SECTION void iot_telemetry_publish_purge(
+	iot_t *lib,
+	const iot_telemetry_t *telemetry );
+
+/**
+ * @brief Copies a telemetry sample into the queue for the sender thread
+ *
+ * @param[in,out]  telemetry           telemetry object sample is for
+ * @param[out]     txn                 transaction status (optional)
+ * @param[in]      max_time_out        maximum time to wait for room in the
+ *                                     queue, if blocking
+ *                                     (0 = wait indefinitely)
+ * @param[in]      data                sample data to publish
+ *
+ * @retval IOT_STATUS_FULL             queue is full
+ * @retval IOT_STATUS_NOT_SUPPORTED    sample must be published synchronously
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t iot_telemetry_publish_queue(
+	iot_telemetry_t *telemetry,
+	iot_transaction_t *txn,
+	iot_millisecond_t max_time_out,
+	const struct iot_data *data );
+
+/**
+ * @brief Thread publishing the queued telemetry samples through the plug-ins
+ *
+ * @param[in,out]  user_data           library handle
+ *
+ * @retval 0                           on exit
+ */
+static OS_THREAD_DECL iot_telemetry_publish_thread( void *user_data );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+/**
+ * @brief Reduces and publishes a telemetry sample through the plug-ins
+ *
+ * @param[in,out]  telemetry           telemetry object sample is for
+ * @param[in,out]  txn                 transaction status (optional)
+ * @param[in]      is_queued           @p txn was assigned when the sample
+ *                                     was queued
+ * @param[in]      time_stamp          time of the sample (0 = now)
+ * @param[in]      max_time_out        maximum time to wait
+ *                                     (0 = wait indefinitely)
+ * @param[in]      data                sample data to publish (NULL closes
+ *                                     the pending aggregation window)
+ *
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @retval ...                         status returned by the plug-ins
+ *
+ * @note called while holding the telemetry mutex
+ */
+static IOT_SECTION iot_status_t iot_telemetry_publish_sample(
+	iot_telemetry_t *telemetry,
+	iot_transaction_t *txn,
+	iot_bool_t is_queued,
+	iot_timestamp_t time_stamp,
+	iot_millisecond_t max_time_out,
+	const struct iot_data *data );
+
+/**
+ * @brief Updates the sample reduction or precision settings if an option
+ *        controls them
+ *
+ * @param[in,out]  telemetry           telemetry object to update
+ * @param[in]      name                option name
+ * @param[in]      data                option value
+ *
+ * @see iot_telemetry_option_set
+ */
+static IOT_SECTION void iot_telemetry_reduce_option(
+	iot_telemetry_t *telemetry,
+	const char *name,
+	const struct iot_data *data );
+
+/**
+ * @brief Adds a sample to the current aggregation window
+ *
+ * @param[in,out]  reduce              reduction state to update
+ * @param[in]      value               sample value
+ * @param[in]      time_stamp          time of the sample
+ */
+static IOT_SECTION void iot_telemetry_reduce_window_add(
+	struct iot_telemetry_reduce *reduce,
+	iot_float64_t value,
+	iot_timestamp_t time_stamp );
+
+/**
+ * @brief Retrieves the numeric value of a sample
+ *
+ * @param[in]      data                sample data
+ * @param[out]     value               numeric value of the sample
+ *
+ * @retval IOT_FALSE                   sample is not numeric
+ * @retval IOT_TRUE                    @p value holds the sample value
+ */
+static IOT_SECTION iot_bool_t iot_telemetry_sample_number(
+	const struct iot_data *data,
+	iot_float64_t *value );
+
 /**
  * @brief Internal function to publish a telemetry sample
  *
@@ -68,18 +177,41 @@ iot_telemetry_t *iot_telemetry_allocate(
 	struct iot_telemetry *result = NULL;
 	if ( lib && name && *name != '\0' )
 	{
+		struct iot_telemetry **telemetry_ptr;
+		iot_uint32_t max = IOT_TELEMETRY_MAX;
 #ifdef IOT_THREAD_SUPPORT
 		os_thread_mutex_lock( &lib->telemetry_mutex );
 #endif /* ifdef IOT_THREAD_SUPPORT */
-		if ( lib->telemetry_count < IOT_TELEMETRY_MAX )
+		telemetry_ptr = IOT_TELEMETRY_PTR( lib );
+#ifndef IOT_STACK_ONLY
+		if ( lib->telemetry_heap )
+			max = lib->telemetry_max;
+
+		/* grow the list of telemetry if it is full */
+		if ( lib->telemetry_count >= max )
 		{
-			const unsigned int count = lib->telemetry_count;
+			struct iot_telemetry **const heap =
+				(struct iot_telemetry **)iot_common_list_grow(
+					(void **)lib->telemetry_heap,
+					(void *const *)lib->telemetry_ptr, &max );
+			if ( heap )
+			{
+				lib->telemetry_heap = heap;
+				lib->telemetry_max = max;
+				telemetry_ptr = heap;
+			}
+		}
+#endif /* ifndef IOT_STACK_ONLY */
+
+		if ( lib->telemetry_count < max )
+		{
+			const iot_uint32_t count = lib->telemetry_count;
 #ifndef IOT_STACK_ONLY
 			iot_bool_t is_in_heap = IOT_FALSE;
 #endif /* ifndef IOT_STACK_ONLY */
 
 			/* look for free telemetry in stack */
-			result = lib->telemetry_ptr[count];
+			result = telemetry_ptr[count];
 
 #ifndef IOT_STACK_ONLY
 			/* allocate telemetry in heap if none is available in stack */
@@ -93,9 +225,9 @@ iot_telemetry_t *iot_telemetry_allocate(
 
 			if ( result )
 			{
-				unsigned int cur_idx = 0u;
-				unsigned int min_idx = 0u;
-				unsigned int max_idx = count;
+				iot_uint32_t cur_idx = 0u;
+				iot_uint32_t min_idx = 0u;
+				iot_uint32_t max_idx = count;
 				size_t name_len;
 				os_memzero( result,
 					sizeof( struct iot_telemetry ) );
@@ -125,7 +257,7 @@ iot_telemetry_t *iot_telemetry_allocate(
 						int cmp_result;
 						cur_idx = (max_idx - min_idx) / 2u + min_idx;
 						cmp_result = os_strncmp( name,
-							lib->telemetry_ptr[cur_idx]->name,
+							telemetry_ptr[cur_idx]->name,
 							IOT_NAME_MAX_LEN );
 						if ( cmp_result > 0 )
 						{
@@ -137,10 +269,10 @@ iot_telemetry_t *iot_telemetry_allocate(
 					}
 
 					/* insert into proper spot in list */
-					os_memmove( &lib->telemetry_ptr[cur_idx + 1u],
-						&lib->telemetry_ptr[cur_idx],
+					os_memmove( &telemetry_ptr[cur_idx + 1u],
+						&telemetry_ptr[cur_idx],
 						sizeof(struct iot_telemetry *) * (count - cur_idx) );
-					lib->telemetry_ptr[cur_idx] = result;
+					telemetry_ptr[cur_idx] = result;
 					++lib->telemetry_count;
 				}
 #ifndef IOT_STACK_ONLY
@@ -156,7 +288,7 @@ iot_telemetry_t *iot_telemetry_allocate(
 		else
 			IOT_LOG( lib, IOT_LOG_ERROR,
 				"no remaining space (max: %u) for telemetry: %s",
-				IOT_TELEMETRY_MAX, name );
+				(unsigned int)max, name );
 #ifdef IOT_THREAD_SUPPORT
 		os_thread_mutex_unlock( &lib->telemetry_mutex );
 #endif /* ifdef IOT_THREAD_SUPPORT */
@@ -277,6 +409,7 @@ iot_status_t iot_telemetry_option_set_data(
 				/** @todo fix this to take ownership */
 				os_memcpy( &opt->data, data,
 					sizeof( struct iot_data ) );
+				iot_telemetry_reduce_option( telemetry, name, data );
 				result = IOT_STATUS_SUCCESS;
 			}
 		}
@@ -315,7 +448,7 @@ iot_status_t iot_telemetry_deregister(
 				result = iot_plugin_perform( telemetry->lib,
 					txn, &max_time_out,
 					IOT_OPERATION_TELEMETRY_DEREGISTER,
-					NULL, NULL, NULL );
+					telemetry, NULL, NULL );
 				if ( result == IOT_STATUS_SUCCESS )
 					telemetry->state = IOT_ITEM_DEREGISTERED;
 				else
@@ -337,16 +470,18 @@ iot_status_t iot_telemetry_free(
 		result = IOT_STATUS_NOT_INITIALIZED;
 		if ( lib )
 		{
-			unsigned int i, max;
+			struct iot_telemetry **telemetry_ptr;
+			iot_uint32_t i, max;
 			result = iot_telemetry_deregister( telemetry, NULL,
 				max_time_out );
 #ifdef IOT_THREAD_SUPPORT
 			os_thread_mutex_lock( &lib->telemetry_mutex );
 #endif /* ifdef IOT_THREAD_SUPPORT */
 			/* find telemetry within the library */
+			telemetry_ptr = IOT_TELEMETRY_PTR( lib );
 			max = lib->telemetry_count;
 			for ( i = 0u; ( i < max ) &&
-				( lib->telemetry_ptr[ i ] != telemetry );
+				( telemetry_ptr[ i ] != telemetry );
 				++i );
 
 			if ( i < max )
@@ -357,6 +492,9 @@ iot_status_t iot_telemetry_free(
 #endif /* ifndef IOT_STACK_ONLY */
 				/* free any heap allocated storage */
 				size_t j;
+#ifdef IOT_THREAD_SUPPORT
+				iot_telemetry_publish_purge( lib, telemetry );
+#endif /* ifdef IOT_THREAD_SUPPORT */
 				for ( j = 0u; j < telemetry->option_count; ++j )
 				{
 					os_free_null(
@@ -365,8 +503,8 @@ iot_status_t iot_telemetry_free(
 
 				/* remove from library */
 				os_memmove(
-					&lib->telemetry_ptr[ i ],
-					&lib->telemetry_ptr[ i + 1u ],
+					&telemetry_ptr[ i ],
+					&telemetry_ptr[ i + 1u ],
 					sizeof( struct iot_telemetry * ) * ( max - i - 1u ) );
 
 				/* set lib to NULL */
@@ -384,17 +522,17 @@ iot_status_t iot_telemetry_free(
 				os_free_null( (void**)&telemetry->name );
 				if ( is_in_heap == IOT_FALSE )
 				{
-					lib->telemetry_ptr[
+					telemetry_ptr[
 						lib->telemetry_count] = telemetry;
 				}
 				else
 				{
-					lib->telemetry_ptr[
+					telemetry_ptr[
 						lib->telemetry_count] = NULL;
 					os_free_null( (void**)&telemetry );
 				}
 #else
-				lib->telemetry_ptr[
+				telemetry_ptr[
 					lib->telemetry_count] = telemetry;
 #endif /* ifndef IOT_STACK_ONLY */
 				result = IOT_STATUS_SUCCESS;
@@ -446,19 +584,27 @@ iot_status_t iot_telemetry_publish_data( iot_telemetry_t *telemetry,
 			if( telemetry->type == IOT_TYPE_NULL ||
 				telemetry->type == data->type )
 			{
+				result = IOT_STATUS_NOT_SUPPORTED;
 #ifdef IOT_THREAD_SUPPORT
-				os_thread_mutex_lock(
-					&telemetry->lib->telemetry_mutex );
+				if ( telemetry->lib->publish_queue_max > 0u )
+					result = iot_telemetry_publish_queue(
+						telemetry, txn, max_time_out,
+						data );
+				if ( result == IOT_STATUS_NOT_SUPPORTED )
+				{
+					os_thread_mutex_lock(
+						&telemetry->lib->telemetry_mutex );
 #endif /* ifdef IOT_THREAD_SUPPORT */
-				result = iot_plugin_perform(
-					telemetry->lib, txn, &max_time_out,
-						IOT_OPERATION_TELEMETRY_PUBLISH,
-						telemetry, data, NULL );
-				if ( result == IOT_STATUS_SUCCESS )
-					telemetry->time_stamp = 0u;
+					result = iot_telemetry_publish_sample(
+						telemetry, txn, IOT_FALSE,
+						telemetry->time_stamp,
+						max_time_out, data );
+					if ( result == IOT_STATUS_SUCCESS )
+						telemetry->time_stamp = 0u;
 #ifdef IOT_THREAD_SUPPORT
-				os_thread_mutex_unlock(
-					&telemetry->lib->telemetry_mutex );
+					os_thread_mutex_unlock(
+						&telemetry->lib->telemetry_mutex );
+				}
 #endif /* ifdef IOT_THREAD_SUPPORT */
 			}
 		}
@@ -466,6 +612,409 @@ iot_status_t iot_telemetry_publish_data( iot_telemetry_t *telemetry,
 	return result;
 }
 
+#ifdef IOT_THREAD_SUPPORT
+void iot_telemetry_publish_purge(
+	iot_t *lib,
+	const iot_telemetry_t *telemetry )
+{
+	iot_uint32_t i;
+	iot_uint32_t kept = 0u;
+	os_thread_mutex_lock( &lib->publish_mutex );
+	for ( i = 0u; i < lib->publish_queue_count; ++i )
+	{
+		struct iot_publish_entry *const entry =
+			&lib->publish_queue[( lib->publish_queue_head + i ) %
+				lib->publish_queue_max];
+		if ( entry->telemetry == telemetry )
+		{
+			iot_transaction_status_set( lib, entry->txn,
+				IOT_STATUS_FAILURE );
+			os_free_null( (void **)&entry->data.heap_storage );
+		}
+		else
+		{
+			if ( kept != i )
+				os_memcpy( &lib->publish_queue[
+					( lib->publish_queue_head + kept ) %
+					lib->publish_queue_max ], entry,
+					sizeof( struct iot_publish_entry ) );
+			++kept;
+		}
+	}
+	lib->publish_queue_count = kept;
+	os_thread_mutex_unlock( &lib->publish_mutex );
+	os_thread_condition_broadcast( &lib->publish_signal );
+}
+
+iot_status_t iot_telemetry_publish_queue(
+	iot_telemetry_t *telemetry,
+	iot_transaction_t *txn,
+	iot_millisecond_t max_time_out,
+	const struct iot_data *data )
+{
+	struct iot *const lib = telemetry->lib;
+	struct iot_publish_entry entry;
+	iot_status_t result;
+
+	/* dynamic data (strings, etc.) is copied on to the heap */
+	os_memzero( &entry, sizeof( struct iot_publish_entry ) );
+	result = iot_common_data_copy( &entry.data, data, IOT_TRUE );
+	if ( result == IOT_STATUS_SUCCESS )
+	{
+		os_status_t wait_result = OS_STATUS_SUCCESS;
+
+		/* transaction is pending until the sender publishes it */
+		entry.txn = iot_transaction_allocate( lib );
+		os_thread_mutex_lock( &lib->publish_mutex );
+		while ( lib->publish_queue_block != IOT_FALSE &&
+			lib->publish_queue_quit == IOT_FALSE &&
+			lib->publish_queue_count >= lib->publish_queue_max &&
+			wait_result == OS_STATUS_SUCCESS )
+		{
+			if ( max_time_out > 0u )
+				wait_result = os_thread_condition_timed_wait(
+					&lib->publish_signal,
+					&lib->publish_mutex, max_time_out );
+			else
+				wait_result = os_thread_condition_wait(
+					&lib->publish_signal,
+					&lib->publish_mutex );
+		}
+
+		if ( lib->publish_queue_quit != IOT_FALSE ||
+			lib->publish_queue_max == 0u )
+			result = IOT_STATUS_NOT_SUPPORTED;
+		else if ( lib->publish_queue_count >= lib->publish_queue_max )
+			result = IOT_STATUS_FULL;
+		else
+		{
+			if ( txn )
+				*txn = entry.txn;
+
+			/* time of the sample is when it was queued */
+			entry.telemetry = telemetry;
+			entry.time_stamp = telemetry->time_stamp;
+			if ( entry.time_stamp == 0u )
+				os_time( &entry.time_stamp, NULL );
+			telemetry->time_stamp = 0u;
+
+			os_memcpy( &lib->publish_queue[
+				( lib->publish_queue_head +
+				  lib->publish_queue_count ) %
+				lib->publish_queue_max ], &entry,
+				sizeof( struct iot_publish_entry ) );
+			++lib->publish_queue_count;
+		}
+		os_thread_mutex_unlock( &lib->publish_mutex );
+
+		if ( result == IOT_STATUS_SUCCESS )
+			os_thread_condition_broadcast( &lib->publish_signal );
+		else
+		{
+			iot_transaction_status_set( lib, entry.txn, result );
+			os_free_null( (void **)&entry.data.heap_storage );
+		}
+	}
+	else
+		result = IOT_STATUS_NOT_SUPPORTED;
+	return result;
+}
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+iot_status_t iot_telemetry_publish_sample(
+	iot_telemetry_t *telemetry,
+	iot_transaction_t *txn,
+	iot_bool_t is_queued,
+	iot_timestamp_t time_stamp,
+	iot_millisecond_t max_time_out,
+	const struct iot_data *data )
+{
+	iot_status_t result;
+	struct iot_telemetry_reduce *const r = &telemetry->reduce;
+	struct iot_data sample;
+	struct iot_options options;
+	struct iot_options *options_ptr = NULL;
+#ifndef IOT_STACK_ONLY
+	struct iot_option option;
+	char option_name[] = "time_stamp";
+#endif /* ifndef IOT_STACK_ONLY */
+	const iot_bool_t is_flush = ( data ? IOT_FALSE : IOT_TRUE );
+	iot_bool_t is_number = IOT_FALSE;
+	iot_bool_t publish = ( data ? IOT_TRUE : IOT_FALSE );
+	iot_timestamp_t now = 0u;
+	iot_float64_t value = 0.0;
+	iot_float64_t sample_value = 0.0;
+	iot_bool_t window_closed = IOT_FALSE;
+
+	if ( r->deadband > 0.0 || r->deadband_percent > 0.0 ||
+		r->interval > 0u || r->window > 0u )
+	{
+		now = time_stamp;
+		if ( now == 0u )
+			os_time( &now, NULL );
+		if ( data )
+			is_number = iot_telemetry_sample_number(
+				data, &sample_value );
+		value = sample_value;
+	}
+
+	/* samples are held until one falls outside of
+	 * the window (or the window is flushed), then a
+	 * summary of the window is published in their place */
+	if ( r->window > 0u &&
+		( is_number != IOT_FALSE || is_flush != IOT_FALSE ) )
+	{
+		publish = IOT_FALSE;
+		if ( r->count > 0u && ( is_flush != IOT_FALSE ||
+			now - r->window_start >= r->window ) )
+		{
+			os_memzero( &sample,
+				sizeof( struct iot_data ) );
+			sample.type = IOT_TYPE_FLOAT64;
+			sample.value.float64 =
+				r->sum / (iot_float64_t)r->count;
+			sample.has_value = IOT_TRUE;
+			data = &sample;
+			value = sample.value.float64;
+			is_number = IOT_TRUE;
+			window_closed = IOT_TRUE;
+			publish = IOT_TRUE;
+		}
+		else if ( is_flush == IOT_FALSE )
+			iot_telemetry_reduce_window_add( r,
+				sample_value, now );
+	}
+
+	/* minimum publish interval */
+	if ( publish != IOT_FALSE && r->interval > 0u &&
+		r->has_published != IOT_FALSE &&
+		now - r->published_time < r->interval )
+		publish = IOT_FALSE;
+
+	/* deadband, based on the last published value */
+	if ( publish != IOT_FALSE && is_number != IOT_FALSE &&
+		r->has_published != IOT_FALSE )
+	{
+		iot_float64_t delta = value - r->published_value;
+		iot_float64_t band = r->published_value *
+			r->deadband_percent / 100.0;
+		if ( delta < 0.0 )
+			delta = -delta;
+		if ( band < 0.0 )
+			band = -band;
+		if ( ( r->deadband > 0.0 &&
+			delta <= r->deadband ) ||
+		     ( r->deadband_percent > 0.0 &&
+			delta <= band ) )
+			publish = IOT_FALSE;
+	}
+
+	result = IOT_STATUS_SUCCESS;
+	if ( publish != IOT_FALSE )
+	{
+		/* the sample time is passed to the plug-ins as an
+		 * option, the telemetry object may be holding the
+		 * time for a newer sample */
+		if ( window_closed != IOT_FALSE )
+			time_stamp = r->last_time;
+		if ( time_stamp != 0u )
+		{
+			struct iot_option *opt;
+			os_memzero( &options, sizeof( struct iot_options ) );
+			options.lib = telemetry->lib;
+#ifdef IOT_STACK_ONLY
+			opt = &options._option[0u];
+			os_strncpy( opt->name, "time_stamp", IOT_NAME_MAX_LEN );
+#else /* ifdef IOT_STACK_ONLY */
+			os_memzero( &option, sizeof( struct iot_option ) );
+			opt = &option;
+			opt->name = option_name;
+#endif /* else IOT_STACK_ONLY */
+			opt->data.type = IOT_TYPE_INT64;
+			opt->data.value.int64 = (iot_int64_t)time_stamp;
+			opt->data.has_value = IOT_TRUE;
+			options.option = opt;
+			options.option_count = 1u;
+			options_ptr = &options;
+		}
+
+		if ( is_queued != IOT_FALSE )
+			result = iot_plugin_perform_transaction(
+				telemetry->lib, txn, &max_time_out,
+				IOT_OPERATION_TELEMETRY_PUBLISH,
+				telemetry, data, options_ptr );
+		else
+			result = iot_plugin_perform(
+				telemetry->lib, txn, &max_time_out,
+				IOT_OPERATION_TELEMETRY_PUBLISH,
+				telemetry, data, options_ptr );
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			r->has_published = IOT_TRUE;
+			r->published_value = value;
+			r->published_time = now;
+		}
+	}
+
+	/* start the next window with this sample */
+	if ( window_closed != IOT_FALSE )
+	{
+		r->count = 0u;
+		if ( is_flush == IOT_FALSE )
+			iot_telemetry_reduce_window_add( r,
+				sample_value, now );
+	}
+	return result;
+}
+
+iot_status_t iot_telemetry_publish_start(
+	iot_t *lib,
+	iot_uint32_t queue_max,
+	iot_bool_t block )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( lib )
+	{
+		result = IOT_STATUS_SUCCESS;
+#ifdef IOT_THREAD_SUPPORT
+		if ( queue_max > 0u && lib->publish_thread == 0 &&
+			!( lib->flags & IOT_FLAG_SINGLE_THREAD ) )
+		{
+#ifdef IOT_STACK_ONLY
+			if ( queue_max > IOT_PUBLISH_QUEUE_MAX )
+				queue_max = IOT_PUBLISH_QUEUE_MAX;
+			lib->publish_queue = lib->_publish_queue;
+#else /* ifdef IOT_STACK_ONLY */
+			lib->publish_queue = os_malloc(
+				sizeof( struct iot_publish_entry ) * queue_max );
+#endif /* else IOT_STACK_ONLY */
+			result = IOT_STATUS_NO_MEMORY;
+			if ( lib->publish_queue )
+			{
+				os_thread_mutex_lock( &lib->publish_mutex );
+				lib->publish_queue_block = block;
+				lib->publish_queue_count = 0u;
+				lib->publish_queue_head = 0u;
+				lib->publish_queue_max = queue_max;
+				lib->publish_queue_quit = IOT_FALSE;
+				os_thread_mutex_unlock( &lib->publish_mutex );
+
+				result = IOT_STATUS_FAILURE;
+				if ( os_thread_create( &lib->publish_thread,
+					iot_telemetry_publish_thread, lib, 0u )
+					== OS_STATUS_SUCCESS )
+					result = IOT_STATUS_SUCCESS;
+				else
+				{
+					lib->publish_queue_max = 0u;
+#ifndef IOT_STACK_ONLY
+					os_free_null( (void **)&lib->publish_queue );
+#endif /* ifndef IOT_STACK_ONLY */
+				}
+			}
+		}
+#else /* ifdef IOT_THREAD_SUPPORT */
+		(void)queue_max;
+		(void)block;
+#endif /* else IOT_THREAD_SUPPORT */
+	}
+	return result;
+}
+
+iot_status_t iot_telemetry_publish_stop(
+	iot_t *lib )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( lib )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		if ( lib->publish_thread != 0 )
+		{
+			/* sender thread publishes what is queued then exits */
+			os_thread_mutex_lock( &lib->publish_mutex );
+			lib->publish_queue_quit = IOT_TRUE;
+			os_thread_mutex_unlock( &lib->publish_mutex );
+			os_thread_condition_broadcast( &lib->publish_signal );
+			os_thread_wait( &lib->publish_thread );
+			lib->publish_thread = 0;
+
+			os_thread_mutex_lock( &lib->publish_mutex );
+			lib->publish_queue_max = 0u;
+			os_thread_mutex_unlock( &lib->publish_mutex );
+#ifndef IOT_STACK_ONLY
+			os_free_null( (void **)&lib->publish_queue );
+#endif /* ifndef IOT_STACK_ONLY */
+		}
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		result = IOT_STATUS_SUCCESS;
+	}
+	return result;
+}
+
+#ifdef IOT_THREAD_SUPPORT
+OS_THREAD_DECL iot_telemetry_publish_thread( void *user_data )
+{
+	struct iot *const lib = (struct iot *)user_data;
+	iot_bool_t quit = IOT_FALSE;
+	while ( quit == IOT_FALSE )
+	{
+		struct iot_publish_entry entry;
+		iot_bool_t has_entry;
+		iot_status_t result = IOT_STATUS_SUCCESS;
+
+		os_thread_mutex_lock( &lib->publish_mutex );
+		while ( lib->publish_queue_count == 0u &&
+			lib->publish_queue_quit == IOT_FALSE )
+			os_thread_condition_wait( &lib->publish_signal,
+				&lib->publish_mutex );
+		has_entry = ( lib->publish_queue_count > 0u ?
+			IOT_TRUE : IOT_FALSE );
+		quit = ( has_entry == IOT_FALSE ? IOT_TRUE : IOT_FALSE );
+		os_thread_mutex_unlock( &lib->publish_mutex );
+
+		/* the telemetry mutex is taken first, so the telemetry
+		 * object can't be freed while its sample is published */
+		if ( has_entry != IOT_FALSE )
+		{
+			os_thread_mutex_lock( &lib->telemetry_mutex );
+			os_thread_mutex_lock( &lib->publish_mutex );
+			has_entry = ( lib->publish_queue_count > 0u ?
+				IOT_TRUE : IOT_FALSE );
+			if ( has_entry != IOT_FALSE )
+			{
+				os_memcpy( &entry, &lib->publish_queue[
+					lib->publish_queue_head],
+					sizeof( struct iot_publish_entry ) );
+				lib->publish_queue_head =
+					( lib->publish_queue_head + 1u ) %
+					lib->publish_queue_max;
+				--lib->publish_queue_count;
+			}
+			os_thread_mutex_unlock( &lib->publish_mutex );
+
+			if ( has_entry != IOT_FALSE )
+			{
+				/* wake any producers waiting for room */
+				os_thread_condition_broadcast(
+					&lib->publish_signal );
+
+				result = iot_telemetry_publish_sample(
+					entry.telemetry, &entry.txn, IOT_TRUE,
+					entry.time_stamp, 0u, &entry.data );
+
+				os_free_null( (void **)&entry.data.heap_storage );
+			}
+			os_thread_mutex_unlock( &lib->telemetry_mutex );
+
+			/* outside of the lock, the callback may publish */
+			if ( has_entry != IOT_FALSE )
+				iot_transaction_finish( lib, entry.txn, result );
+		}
+	}
+	return (OS_THREAD_RETURN)0;
+}
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
 iot_status_t iot_telemetry_publish_raw( iot_telemetry_t *telemetry,
 	iot_transaction_t *txn, iot_millisecond_t max_time_out, size_t length,
 	const void *ptr )
@@ -479,6 +1028,110 @@ iot_status_t iot_telemetry_publish_raw( iot_telemetry_t *telemetry,
 	return iot_telemetry_publish_data( telemetry, txn, max_time_out, &data );
 }
 
+iot_status_t iot_telemetry_reduce_flush(
+	iot_t *lib,
+	iot_bool_t force,
+	iot_millisecond_t max_time_out )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( lib )
+	{
+		iot_uint32_t i;
+		iot_timestamp_t now = 0u;
+
+		os_time( &now, NULL );
+		result = IOT_STATUS_SUCCESS;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &lib->telemetry_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		for ( i = 0u; i < lib->telemetry_count; ++i )
+		{
+			iot_telemetry_t *const t = IOT_TELEMETRY_PTR( lib )[i];
+			const struct iot_telemetry_reduce *const r = &t->reduce;
+			if ( r->window > 0u && r->count > 0u &&
+				( force != IOT_FALSE ||
+				  now - r->window_start >= r->window ) )
+			{
+				/* summary is tracked as its own transaction */
+				iot_transaction_t txn;
+				const iot_status_t status =
+					iot_telemetry_publish_sample( t, &txn,
+						IOT_FALSE, now, max_time_out,
+						NULL );
+				if ( status != IOT_STATUS_SUCCESS )
+					result = status;
+			}
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &lib->telemetry_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+	return result;
+}
+
+void iot_telemetry_reduce_option(
+	iot_telemetry_t *telemetry,
+	const char *name,
+	const struct iot_data *data )
+{
+	struct iot_telemetry_reduce *const r = &telemetry->reduce;
+	struct iot_data opt;
+	iot_bool_t has_value = IOT_FALSE;
+	iot_float64_t value = 0.0;
+
+	os_memcpy( &opt, data, sizeof( struct iot_data ) );
+	if ( opt.has_value != IOT_FALSE &&
+		iot_common_data_convert( IOT_CONVERSION_BASIC,
+			IOT_TYPE_FLOAT64, &opt ) != IOT_FALSE &&
+		opt.value.float64 >= 0.0 )
+	{
+		has_value = IOT_TRUE;
+		value = opt.value.float64;
+	}
+
+	if ( os_strcmp( name, "deadband" ) == 0 )
+		r->deadband = value;
+	else if ( os_strcmp( name, "deadband_percent" ) == 0 )
+		r->deadband_percent = value;
+	else if ( os_strcmp( name, "interval_min" ) == 0 )
+		r->interval = (iot_millisecond_t)value;
+	else if ( os_strcmp( name, "window" ) == 0 )
+	{
+		r->window = (iot_millisecond_t)value;
+		r->count = 0u;
+	}
+	else if ( os_strcmp( name, "precision" ) == 0 )
+	{
+		/* negative (or no) value publishes the shortest form */
+		telemetry->has_precision = has_value;
+		if ( value > 255.0 )
+			value = 255.0;
+		telemetry->precision = (iot_uint8_t)value;
+	}
+}
+
+void iot_telemetry_reduce_window_add(
+	struct iot_telemetry_reduce *reduce,
+	iot_float64_t value,
+	iot_timestamp_t time_stamp )
+{
+	if ( reduce->count == 0u )
+	{
+		reduce->max = value;
+		reduce->min = value;
+		reduce->sum = 0.0;
+		reduce->window_start = time_stamp;
+	}
+	else if ( value > reduce->max )
+		reduce->max = value;
+	else if ( value < reduce->min )
+		reduce->min = value;
+	reduce->sum += value;
+	reduce->last = value;
+	reduce->last_time = time_stamp;
+	++reduce->count;
+}
+
 iot_status_t iot_telemetry_register(
 	iot_telemetry_t *telemetry,
 	iot_transaction_t *txn,
@@ -503,6 +1156,49 @@ iot_status_t iot_telemetry_register(
 	return result;
 }
 
+iot_bool_t iot_telemetry_sample_number(
+	const struct iot_data *data,
+	iot_float64_t *value )
+{
+	iot_bool_t result = IOT_FALSE;
+	if ( data->has_value != IOT_FALSE )
+	{
+		switch ( data->type )
+		{
+		case IOT_TYPE_FLOAT32:
+		case IOT_TYPE_FLOAT64:
+		case IOT_TYPE_INT8:
+		case IOT_TYPE_INT16:
+		case IOT_TYPE_INT32:
+		case IOT_TYPE_INT64:
+		case IOT_TYPE_UINT8:
+		case IOT_TYPE_UINT16:
+		case IOT_TYPE_UINT32:
+		case IOT_TYPE_UINT64:
+		{
+			struct iot_data number;
+			os_memcpy( &number, data, sizeof( struct iot_data ) );
+			result = iot_common_data_convert( IOT_CONVERSION_BASIC,
+				IOT_TYPE_FLOAT64, &number );
+			if ( result != IOT_FALSE )
+				*value = number.value.float64;
+			break;
+		}
+		case IOT_TYPE_BOOL:
+			*value = ( data->value.boolean != IOT_FALSE ? 1.0 : 0.0 );
+			result = IOT_TRUE;
+			break;
+		case IOT_TYPE_LOCATION:
+		case IOT_TYPE_NULL:
+		case IOT_TYPE_RAW:
+		case IOT_TYPE_STRING:
+		default:
+			break;
+		}
+	}
+	return result;
+}
+
 iot_status_t iot_telemetry_timestamp_set(
 	iot_telemetry_t *telemetry,
 	iot_timestamp_t time_stamp )
@@ -42,3 +42,25 @@ void iot_json_free( void* ptr )
 	app_json_free( ptr );
 }
 #endif /* if !defined( IOT_STACK_ONLY ) */
+
+size_t iot_json_number_integer( char *buf, iot_uint64_t value,
+	iot_bool_t negative )
+{
+	return app_json_number_integer( buf, value, negative );
+}
+
+size_t iot_json_number_real( char *buf, iot_float64_t value, int precision )
+{
+	return app_json_number_real( buf, value, precision );
+}
+
+size_t iot_json_string_escape( char *dest, const char *src, size_t src_len,
+	size_t num )
+{
+	return app_json_string_escape( dest, src, src_len, num );
+}
+
+size_t iot_json_string_escape_len( const char *str, size_t len )
+{
+	return app_json_string_escape_len( str, len );
+}
@@ -72,6 +72,20 @@ size_t iot_json_decode_array_size(
 		(const app_json_item_t *)item );
 }
 
+iot_status_t iot_json_decode_bind(
+	const iot_json_decoder_t *decoder,
+	const iot_json_item_t *object,
+	const iot_json_bind_t *fields,
+	size_t field_count,
+	void *out )
+{
+	return app_json_decode_bind(
+		(const app_json_decoder_t *)decoder,
+		(const app_json_item_t *)object,
+		(const app_json_bind_t *)fields,
+		field_count, out );
+}
+
 iot_status_t iot_json_decode_bool(
 	const iot_json_decoder_t *decoder,
 	const iot_json_item_t *item,
@@ -202,6 +216,20 @@ iot_status_t iot_json_decode_parse(
 		(const app_json_item_t **)root, error, error_len );
 }
 
+iot_status_t iot_json_decode_parse_chunk(
+	iot_json_decoder_t *decoder,
+	const char *js,
+	size_t len,
+	iot_bool_t more,
+	const iot_json_item_t **root,
+	char *error,
+	size_t error_len )
+{
+	return app_json_decode_parse_chunk(
+		(app_json_decoder_t *)decoder, js, len, more,
+		(const app_json_item_t **)root, error, error_len );
+}
+
 iot_status_t iot_json_decode_real(
 	const iot_json_decoder_t *decoder,
 	const iot_json_item_t *item,
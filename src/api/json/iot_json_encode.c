@@ -104,6 +104,22 @@ iot_status_t iot_json_encode_real(
 		(app_json_encoder_t *)encoder, key, value );
 }
 
+iot_status_t iot_json_encode_real_precision(
+	iot_json_encoder_t *encoder,
+	const char *key,
+	iot_float64_t value,
+	int precision )
+{
+	return app_json_encode_real_precision(
+		(app_json_encoder_t *)encoder, key, value, precision );
+}
+
+iot_status_t iot_json_encode_reset(
+	iot_json_encoder_t *encoder )
+{
+	return app_json_encode_reset( (app_json_encoder_t *)encoder );
+}
+
 iot_status_t iot_json_encode_string(
 	iot_json_encoder_t *encoder,
 	const char *key,
@@ -119,3 +135,11 @@ void iot_json_encode_terminate(
 	app_json_encode_terminate( (app_json_encoder_t *)encoder );
 }
 
+iot_status_t iot_json_encode_unsigned(
+	iot_json_encoder_t *encoder,
+	const char *key,
+	iot_uint64_t value )
+{
+	return app_json_encode_unsigned(
+		(app_json_encoder_t *)encoder, key, value );
+}
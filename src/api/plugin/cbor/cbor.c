@@ -0,0 +1,996 @@
+/**
+ * @file
+ * @brief source file for the cbor (generic mqtt broker) plugin
+ *
+ * Publishes the same outbound operations as the tr50 plugin to any mqtt
+ * broker, encoded as compact binary CBOR (RFC 7049) maps rather than json
+ * text.  Each message is a map written directly into a single reusable
+ * buffer, no intermediate document is built.
+ *
+ * Topics:
+ *   <cbor.topic>/<device id>/alarm       {"key","state","msg","ts",...}
+ *   <cbor.topic>/<device id>/attribute   {"key","value","ts"}
+ *   <cbor.topic>/<device id>/event       {"msg","level","ts"}
+ *   <cbor.topic>/<device id>/telemetry   {"key","value","ts"}
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "../../shared/iot_defs.h"
+#include "../../shared/iot_types.h"
+#include "utilities/app_cbor.h"
+
+#include <iot_mqtt.h>
+#include <iot_plugin.h>
+#include <os.h>
+
+/** @brief size of the buffer messages are encoded into */
+#define CBOR_BUFFER_SIZE                    1024u
+/** @brief suffix added to the application id to form the mqtt client id,
+ *         so the plug-in doesn't take over the session of another plug-in
+ *         connected to the same broker */
+#define CBOR_CLIENT_ID_SUFFIX               "-cbor"
+/** @brief keep alive interval for the mqtt connection in seconds */
+#define CBOR_MQTT_KEEP_ALIVE                60u
+/** @brief default quality of service for published messages */
+#define CBOR_MQTT_QOS                       1
+/** @brief time between reconnect attempts */
+#define CBOR_TIMEOUT_RECONNECT_MS           5u * IOT_MILLISECONDS_IN_SECOND /* 5 seconds */
+/** @brief default prefix for topics published to */
+#define CBOR_TOPIC_DEFAULT                  "iot"
+/** @brief maximum length of the topic prefix (including device id) */
+#define CBOR_TOPIC_MAX_LEN                  ( IOT_NAME_MAX_LEN + IOT_ID_MAX_LEN + 1u )
+/** @brief maximum length of a topic suffix */
+#define CBOR_TOPIC_SUFFIX_MAX_LEN           16u
+
+/** @brief internal data for the plug-in */
+struct cbor_data
+{
+#ifdef IOT_STACK_ONLY
+	/** @brief buffer messages are encoded into */
+	iot_uint8_t buf[ CBOR_BUFFER_SIZE ];
+#endif /* ifdef IOT_STACK_ONLY */
+	/** @brief encoder for outbound messages */
+	app_cbor_encoder_t encoder;
+#ifdef IOT_THREAD_SUPPORT
+	/** @brief mutex protecting the encoder */
+	os_thread_mutex_t encoder_mutex;
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	/** @brief library handle */
+	iot_t *lib;
+	/** @brief pointer to the mqtt connection to the broker */
+	iot_mqtt_t *mqtt;
+	/** @brief client id used to connect to the broker */
+	char client_id[ IOT_ID_MAX_LEN + sizeof( CBOR_CLIENT_ID_SUFFIX ) ];
+	/** @brief quality of service for published messages */
+	int qos;
+	/** @brief number of times reconnection has been attempted */
+	iot_uint32_t reconnect_count;
+	/** @brief prefix of topics published to ("<prefix>/<device id>") */
+	char topic[ CBOR_TOPIC_MAX_LEN + 1u ];
+};
+
+/**
+ * @brief publishes an alarm
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in]      alarm               alarm being published
+ * @param[in]      payload             alarm state
+ * @param[in]      options             map containing an optional options set
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t cbor_alarm_publish(
+	struct cbor_data *data,
+	const iot_alarm_t *alarm,
+	const iot_alarm_data_t *payload,
+	const iot_options_t *options );
+
+/**
+ * @brief publishes an attribute
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in]      key                 attribute key
+ * @param[in]      value               attribute value
+ * @param[in]      options             map containing an optional options set
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t cbor_attribute_publish(
+	struct cbor_data *data,
+	const char *key,
+	const char *value,
+	const iot_options_t *options );
+
+/**
+ * @brief connects (or reconnects) to the mqtt broker
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      data                plug-in specific data
+ * @param[in]      max_time_out        maximum time to wait
+ *                                     (0 = wait indefinitely)
+ * @param[in]      is_reconnect        whether this is a reconnection
+ *
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t cbor_connect(
+	iot_t *lib,
+	struct cbor_data *data,
+	iot_millisecond_t max_time_out,
+	iot_bool_t is_reconnect );
+
+/**
+ * @brief reconnects to the broker if the connection has been lost
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      data                plug-in specific data
+ * @param[in]      max_time_out        maximum time to wait
+ *                                     (0 = wait indefinitely)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FAILURE          not connected
+ * @retval IOT_STATUS_SUCCESS          connected
+ */
+static IOT_SECTION iot_status_t cbor_connect_check(
+	iot_t *lib,
+	struct cbor_data *data,
+	iot_millisecond_t max_time_out );
+
+/**
+ * @brief disables the plug-in
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      plugin_data         plug-in specific data
+ * @param[in]      force               force the disabling
+ *
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t cbor_disable(
+	iot_t *lib,
+	void *plugin_data,
+	iot_bool_t force );
+
+/**
+ * @brief disconnects from the mqtt broker
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      data                plug-in specific data
+ *
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t cbor_disconnect(
+	iot_t *lib,
+	struct cbor_data *data );
+
+/**
+ * @brief enables the plug-in
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      plugin_data         plug-in specific data
+ *
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t cbor_enable(
+	iot_t *lib,
+	void *plugin_data );
+
+/**
+ * @brief encodes a location as a map
+ *
+ * @param[in,out]  enc                 encoder to write to
+ * @param[in]      location            location to encode
+ *
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t cbor_encode_location(
+	app_cbor_encoder_t *enc,
+	const iot_location_t *location );
+
+/**
+ * @brief encodes a string key followed by a string value
+ *
+ * @param[in,out]  enc                 encoder to write to
+ * @param[in]      key                 key to write
+ * @param[in]      value               value to write
+ *
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t cbor_encode_pair(
+	app_cbor_encoder_t *enc,
+	const char *key,
+	const char *value );
+
+/**
+ * @brief encodes the "ts" key, if a time stamp is available
+ *
+ * @param[in,out]  enc                 encoder to write to
+ * @param[in]      options             map containing an optional options set
+ * @param[in]      ts                  time stamp of the sample (0 = none)
+ *
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t cbor_encode_timestamp(
+	app_cbor_encoder_t *enc,
+	const iot_options_t *options,
+	iot_timestamp_t ts );
+
+/**
+ * @brief encodes a telemetry sample value in its native cbor type
+ *
+ * @param[in,out]  enc                 encoder to write to
+ * @param[in]      d                   sample to encode
+ *
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t cbor_encode_value(
+	app_cbor_encoder_t *enc,
+	const struct iot_data *d );
+
+/**
+ * @brief obtains the encoder, locking it for the caller
+ *
+ * @param[in]      data                plug-in specific data
+ *
+ * @return the encoder, rewound to the start of a new message
+ *
+ * @see cbor_encoder_release
+ */
+static IOT_SECTION app_cbor_encoder_t *cbor_encoder_acquire(
+	struct cbor_data *data );
+
+/**
+ * @brief publishes the message in the encoder, then releases it
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in]      suffix              topic suffix to publish to
+ * @param[in]      result              result of encoding the message
+ *
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_FULL             message too large to encode
+ * @retval IOT_STATUS_NOT_INITIALIZED  not connected to the broker
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see cbor_encoder_acquire
+ */
+static IOT_SECTION iot_status_t cbor_encoder_release(
+	struct cbor_data *data,
+	const char *suffix,
+	iot_status_t result );
+
+/**
+ * @brief publishes an event
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in]      message             event message
+ * @param[in]      options             map containing an optional options set
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t cbor_event_publish(
+	struct cbor_data *data,
+	const char *message,
+	const iot_options_t *options );
+
+/**
+ * @brief executes an operation for the plug-in
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      plugin_data         plug-in specific data
+ * @param[in]      op                  operation to execute
+ * @param[in]      txn                 transaction id
+ * @param[in]      max_time_out        maximum time to wait
+ *                                     (0 = wait indefinitely)
+ * @param[in,out]  step                step of the operation
+ * @param[in]      item                item the operation applies to
+ * @param[in]      value               value for the operation
+ * @param[in]      options             map containing an optional options set
+ *
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t cbor_execute(
+	iot_t *lib,
+	void *plugin_data,
+	iot_operation_t op,
+	const iot_transaction_t *txn,
+	iot_millisecond_t max_time_out,
+	iot_step_t *step,
+	const void *item,
+	const void *value,
+	const iot_options_t *options );
+
+/**
+ * @brief initializes the plug-in
+ *
+ * @param[in]      lib                 library handle
+ * @param[out]     plugin_data         plug-in specific data
+ *
+ * @retval IOT_STATUS_NO_MEMORY        not enough memory for the plug-in
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t cbor_initialize(
+	iot_t *lib,
+	void **plugin_data );
+
+/**
+ * @brief publishes a telemetry sample
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in]      t                   telemetry object
+ * @param[in]      d                   sample to publish
+ * @param[in]      options             map containing an optional options set
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t cbor_telemetry_publish(
+	struct cbor_data *data,
+	const iot_telemetry_t *t,
+	const struct iot_data *d,
+	const iot_options_t *options );
+
+/**
+ * @brief terminates the plug-in
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      plugin_data         plug-in specific data
+ *
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t cbor_terminate(
+	iot_t *lib,
+	void *plugin_data );
+
+iot_status_t cbor_alarm_publish(
+	struct cbor_data *data,
+	const iot_alarm_t *alarm,
+	const iot_alarm_data_t *payload,
+	const iot_options_t *options )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( data && alarm && payload )
+	{
+		app_cbor_encoder_t *const enc = cbor_encoder_acquire( data );
+		const iot_location_t *location = NULL;
+		iot_bool_t republish;
+
+		result = app_cbor_encode_map_start( enc, APP_CBOR_INDEFINITE );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_pair( enc, "key", alarm->name );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_string( enc, "state" );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_unsigned( enc,
+				payload->severity );
+		if ( result == IOT_STATUS_SUCCESS &&
+			payload->message && *payload->message != '\0' )
+			result = cbor_encode_pair( enc, "msg",
+				payload->message );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_timestamp( enc, options, 0u );
+		if ( result == IOT_STATUS_SUCCESS &&
+			iot_options_get_location( options, "location",
+				IOT_FALSE, &location ) == IOT_STATUS_SUCCESS )
+		{
+			result = app_cbor_encode_string( enc, "location" );
+			if ( result == IOT_STATUS_SUCCESS )
+				result = cbor_encode_location( enc, location );
+		}
+		if ( result == IOT_STATUS_SUCCESS &&
+			iot_options_get_bool( options, "republish",
+				IOT_FALSE, &republish ) == IOT_STATUS_SUCCESS )
+		{
+			result = app_cbor_encode_string( enc, "republish" );
+			if ( result == IOT_STATUS_SUCCESS )
+				result = app_cbor_encode_bool( enc, republish );
+		}
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_end( enc );
+		result = cbor_encoder_release( data, "alarm", result );
+	}
+	return result;
+}
+
+iot_status_t cbor_attribute_publish(
+	struct cbor_data *data,
+	const char *key,
+	const char *value,
+	const iot_options_t *options )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( data && key && value )
+	{
+		app_cbor_encoder_t *const enc = cbor_encoder_acquire( data );
+
+		result = app_cbor_encode_map_start( enc, APP_CBOR_INDEFINITE );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_pair( enc, "key", key );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_pair( enc, "value", value );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_timestamp( enc, options, 0u );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_end( enc );
+		result = cbor_encoder_release( data, "attribute", result );
+	}
+	return result;
+}
+
+iot_status_t cbor_connect(
+	iot_t *lib,
+	struct cbor_data *data,
+	iot_millisecond_t max_time_out,
+	iot_bool_t is_reconnect )
+{
+	iot_status_t result = IOT_STATUS_FAILURE;
+	const char *operation = "connect";
+	if ( is_reconnect != IOT_FALSE )
+		operation = "reconnect";
+	IOT_LOG( lib, IOT_LOG_TRACE, "cbor: %s", operation );
+
+	if ( data )
+	{
+		const char *ca_bundle = NULL;
+		iot_mqtt_connect_options_t con_opts = IOT_MQTT_CONNECT_OPTIONS_INIT;
+		const char *host = NULL;
+		char fail_reason[128u] = { '\0' };
+		const char *password = NULL;
+		iot_int64_t port = 0;
+		iot_int64_t qos = CBOR_MQTT_QOS;
+		iot_bool_t ssl = IOT_FALSE;
+		iot_mqtt_ssl_t ssl_conf;
+		const char *topic = CBOR_TOPIC_DEFAULT;
+		const char *username = NULL;
+		iot_bool_t validate_cert = IOT_FALSE;
+
+		/* broker settings, falling back to the cloud settings */
+		if ( iot_config_get( lib, "cbor.host", IOT_FALSE,
+			IOT_TYPE_STRING, &host ) != IOT_STATUS_SUCCESS )
+			iot_config_get( lib, "cloud.host", IOT_FALSE,
+				IOT_TYPE_STRING, &host );
+		if ( iot_config_get( lib, "cbor.port", IOT_FALSE,
+			IOT_TYPE_INT64, &port ) != IOT_STATUS_SUCCESS )
+			iot_config_get( lib, "cloud.port", IOT_FALSE,
+				IOT_TYPE_INT64, &port );
+		iot_config_get( lib, "cbor.username", IOT_FALSE,
+			IOT_TYPE_STRING, &username );
+		iot_config_get( lib, "cbor.password", IOT_FALSE,
+			IOT_TYPE_STRING, &password );
+		iot_config_get( lib, "cbor.topic", IOT_FALSE,
+			IOT_TYPE_STRING, &topic );
+		iot_config_get( lib, "cbor.qos", IOT_FALSE,
+			IOT_TYPE_INT64, &qos );
+		iot_config_get( lib, "cbor.ssl", IOT_FALSE,
+			IOT_TYPE_BOOL, &ssl );
+		iot_config_get( lib, "ca_bundle_file", IOT_FALSE,
+			IOT_TYPE_STRING, &ca_bundle );
+		if ( !ca_bundle )
+			ca_bundle = IOT_DEFAULT_CERT_PATH;
+		iot_config_get( lib, "validate_cloud_cert", IOT_FALSE,
+			IOT_TYPE_BOOL, &validate_cert );
+
+		if ( qos < 0 || qos > 2 )
+			qos = CBOR_MQTT_QOS;
+		data->qos = (int)qos;
+		os_snprintf( data->topic, CBOR_TOPIC_MAX_LEN, "%s/%s",
+			topic, lib->device_id );
+		data->topic[ CBOR_TOPIC_MAX_LEN ] = '\0';
+
+		os_memzero( &ssl_conf, sizeof( iot_mqtt_ssl_t ) );
+		ssl_conf.ca_path = ca_bundle;
+		ssl_conf.insecure = !validate_cert;
+
+		os_snprintf( data->client_id, sizeof( data->client_id ),
+			"%s%s", iot_id( lib ), CBOR_CLIENT_ID_SUFFIX );
+		data->client_id[ sizeof( data->client_id ) - 1u ] = '\0';
+		con_opts.client_id = data->client_id;
+		con_opts.host = host;
+		con_opts.port = (iot_uint16_t)port;
+		con_opts.keep_alive = CBOR_MQTT_KEEP_ALIVE;
+		if ( ssl != IOT_FALSE )
+			con_opts.ssl_conf = &ssl_conf;
+		con_opts.username = username;
+		con_opts.password = password;
+		con_opts.version = IOT_MQTT_VERSION_3_1_1;
+		con_opts.error_msg = fail_reason;
+		con_opts.error_msg_len = sizeof(fail_reason);
+		if ( is_reconnect == IOT_FALSE )
+		{
+			data->mqtt = iot_mqtt_connect( &con_opts, max_time_out );
+			if ( data->mqtt )
+				result = IOT_STATUS_SUCCESS;
+		}
+		else
+		{
+			result = iot_mqtt_reconnect( data->mqtt, &con_opts,
+				max_time_out );
+		}
+
+		if ( data->mqtt && result == IOT_STATUS_SUCCESS )
+		{
+			data->reconnect_count = 1u;
+			iot_mqtt_set_user_data( data->mqtt, data );
+			IOT_LOG( lib, IOT_LOG_INFO, "cbor %s: %s",
+				operation, "successfully" );
+		}
+		else if ( is_reconnect == IOT_FALSE ) /* show on connect only */
+		{
+			IOT_LOG( lib, IOT_LOG_ERROR,
+				"cbor: failed to connect: %s", fail_reason );
+		}
+	}
+	return result;
+}
+
+iot_status_t cbor_connect_check(
+	iot_t *lib,
+	struct cbor_data *data,
+	iot_millisecond_t max_time_out )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+
+	if ( lib && data && data->mqtt )
+	{
+		iot_bool_t connected = IOT_TRUE;
+		iot_timestamp_t time_stamp_changed = 0u;
+
+		result = iot_mqtt_connection_status( data->mqtt,
+			&connected, &time_stamp_changed );
+		if ( result == IOT_STATUS_SUCCESS && connected == IOT_FALSE )
+		{
+			const iot_timestamp_t time_stamp_diff =
+				iot_timestamp_now() - time_stamp_changed;
+
+			result = IOT_STATUS_FAILURE; /* not connected */
+			if ( data->reconnect_count > 0u && time_stamp_diff >=
+			     ( data->reconnect_count * CBOR_TIMEOUT_RECONNECT_MS ) )
+			{
+				++data->reconnect_count;
+
+				/* default to 1 second */
+				if ( max_time_out == 0u )
+					max_time_out = IOT_MILLISECONDS_IN_SECOND;
+
+				result = cbor_connect( lib, data,
+					max_time_out, IOT_TRUE );
+			}
+		}
+	}
+	return result;
+}
+
+iot_status_t cbor_disable(
+	iot_t *lib,
+	void *UNUSED(plugin_data),
+	iot_bool_t UNUSED(force) )
+{
+	IOT_LOG( lib, IOT_LOG_TRACE, "cbor: %s", "disable" );
+	return IOT_STATUS_SUCCESS;
+}
+
+iot_status_t cbor_disconnect(
+	iot_t *lib,
+	struct cbor_data *data )
+{
+	iot_status_t result = IOT_STATUS_FAILURE;
+	IOT_LOG( lib, IOT_LOG_TRACE, "cbor: %s", "disconnect" );
+	if ( data )
+	{
+		data->reconnect_count = 0u; /* don't reconnect */
+		result = iot_mqtt_disconnect( data->mqtt );
+		data->mqtt = NULL;
+	}
+	return result;
+}
+
+iot_status_t cbor_enable(
+	iot_t *lib,
+	void *UNUSED(plugin_data) )
+{
+	IOT_LOG( lib, IOT_LOG_TRACE, "cbor: %s", "enable" );
+	return IOT_STATUS_SUCCESS;
+}
+
+iot_status_t cbor_encode_location(
+	app_cbor_encoder_t *enc,
+	const iot_location_t *location )
+{
+	iot_status_t result;
+	result = app_cbor_encode_map_start( enc, APP_CBOR_INDEFINITE );
+	if ( result == IOT_STATUS_SUCCESS )
+		result = app_cbor_encode_string( enc, "lat" );
+	if ( result == IOT_STATUS_SUCCESS )
+		result = app_cbor_encode_real( enc, location->latitude );
+	if ( result == IOT_STATUS_SUCCESS )
+		result = app_cbor_encode_string( enc, "lng" );
+	if ( result == IOT_STATUS_SUCCESS )
+		result = app_cbor_encode_real( enc, location->longitude );
+	if ( result == IOT_STATUS_SUCCESS &&
+		location->flags & IOT_FLAG_LOCATION_HEADING )
+	{
+		result = app_cbor_encode_string( enc, "heading" );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_real( enc, location->heading );
+	}
+	if ( result == IOT_STATUS_SUCCESS &&
+		location->flags & IOT_FLAG_LOCATION_ALTITUDE )
+	{
+		result = app_cbor_encode_string( enc, "altitude" );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_real( enc, location->altitude );
+	}
+	if ( result == IOT_STATUS_SUCCESS &&
+		location->flags & IOT_FLAG_LOCATION_SPEED )
+	{
+		result = app_cbor_encode_string( enc, "speed" );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_real( enc, location->speed );
+	}
+	if ( result == IOT_STATUS_SUCCESS &&
+		location->flags & IOT_FLAG_LOCATION_ACCURACY )
+	{
+		result = app_cbor_encode_string( enc, "fixAcc" );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_real( enc, location->accuracy );
+	}
+	if ( result == IOT_STATUS_SUCCESS &&
+		location->flags & IOT_FLAG_LOCATION_SOURCE )
+	{
+		const char *source;
+		switch ( location->source )
+		{
+			case IOT_LOCATION_SOURCE_FIXED:
+				source = "fixed";
+				break;
+			case IOT_LOCATION_SOURCE_GPS:
+				source = "gps";
+				break;
+			case IOT_LOCATION_SOURCE_WIFI:
+				source = "wifi";
+				break;
+			case IOT_LOCATION_SOURCE_UNKNOWN:
+			default:
+				source = "unknown";
+		}
+		result = cbor_encode_pair( enc, "fixType", source );
+	}
+	if ( result == IOT_STATUS_SUCCESS &&
+		location->flags & IOT_FLAG_LOCATION_TAG )
+		result = cbor_encode_pair( enc, "street", location->tag );
+	if ( result == IOT_STATUS_SUCCESS )
+		result = app_cbor_encode_end( enc );
+	return result;
+}
+
+iot_status_t cbor_encode_pair(
+	app_cbor_encoder_t *enc,
+	const char *key,
+	const char *value )
+{
+	iot_status_t result = app_cbor_encode_string( enc, key );
+	if ( result == IOT_STATUS_SUCCESS )
+		result = app_cbor_encode_string( enc, value ? value : "" );
+	return result;
+}
+
+iot_status_t cbor_encode_timestamp(
+	app_cbor_encoder_t *enc,
+	const iot_options_t *options,
+	iot_timestamp_t ts )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	iot_int64_t option_ts;
+	if ( iot_options_get_integer( options, "time_stamp",
+		IOT_FALSE, &option_ts ) == IOT_STATUS_SUCCESS )
+		ts = (iot_timestamp_t)option_ts;
+	if ( ts > 0u )
+	{
+		result = app_cbor_encode_string( enc, "ts" );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_unsigned( enc, ts );
+	}
+	return result;
+}
+
+iot_status_t cbor_encode_value(
+	app_cbor_encoder_t *enc,
+	const struct iot_data *d )
+{
+	iot_status_t result;
+	switch ( d->type )
+	{
+	case IOT_TYPE_BOOL:
+		result = app_cbor_encode_bool( enc, d->value.boolean );
+		break;
+	case IOT_TYPE_FLOAT32:
+		result = app_cbor_encode_real( enc,
+			(iot_float64_t)d->value.float32 );
+		break;
+	case IOT_TYPE_FLOAT64:
+		result = app_cbor_encode_real( enc, d->value.float64 );
+		break;
+	case IOT_TYPE_INT8:
+		result = app_cbor_encode_integer( enc, d->value.int8 );
+		break;
+	case IOT_TYPE_INT16:
+		result = app_cbor_encode_integer( enc, d->value.int16 );
+		break;
+	case IOT_TYPE_INT32:
+		result = app_cbor_encode_integer( enc, d->value.int32 );
+		break;
+	case IOT_TYPE_INT64:
+		result = app_cbor_encode_integer( enc, d->value.int64 );
+		break;
+	case IOT_TYPE_UINT8:
+		result = app_cbor_encode_unsigned( enc, d->value.uint8 );
+		break;
+	case IOT_TYPE_UINT16:
+		result = app_cbor_encode_unsigned( enc, d->value.uint16 );
+		break;
+	case IOT_TYPE_UINT32:
+		result = app_cbor_encode_unsigned( enc, d->value.uint32 );
+		break;
+	case IOT_TYPE_UINT64:
+		result = app_cbor_encode_unsigned( enc, d->value.uint64 );
+		break;
+	case IOT_TYPE_RAW:
+		/* binary data is sent as-is, no base64 encoding is needed */
+		result = app_cbor_encode_bytes( enc,
+			d->value.raw.ptr, d->value.raw.length );
+		break;
+	case IOT_TYPE_STRING:
+		result = app_cbor_encode_string( enc,
+			d->value.string ? d->value.string : "" );
+		break;
+	case IOT_TYPE_LOCATION:
+		result = app_cbor_encode_null( enc );
+		if ( d->value.location )
+			result = cbor_encode_location( enc,
+				d->value.location );
+		break;
+	case IOT_TYPE_NULL:
+	default:
+		result = app_cbor_encode_null( enc );
+	}
+	return result;
+}
+
+app_cbor_encoder_t *cbor_encoder_acquire(
+	struct cbor_data *data )
+{
+#ifdef IOT_THREAD_SUPPORT
+	os_thread_mutex_lock( &data->encoder_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	app_cbor_encode_reset( &data->encoder );
+	return &data->encoder;
+}
+
+iot_status_t cbor_encoder_release(
+	struct cbor_data *data,
+	const char *suffix,
+	iot_status_t result )
+{
+	if ( result == IOT_STATUS_SUCCESS && !data->mqtt )
+		result = IOT_STATUS_NOT_INITIALIZED;
+	else if ( result == IOT_STATUS_SUCCESS )
+	{
+		char topic[ CBOR_TOPIC_MAX_LEN + CBOR_TOPIC_SUFFIX_MAX_LEN + 2u ];
+		os_snprintf( topic, sizeof( topic ), "%s/%s",
+			data->topic, suffix );
+		topic[ sizeof( topic ) - 1u ] = '\0';
+		result = iot_mqtt_publish( data->mqtt, topic,
+			data->encoder.buf, data->encoder.len, data->qos,
+			IOT_FALSE, NULL );
+	}
+	else
+		IOT_LOG( data->lib, IOT_LOG_ERROR,
+			"cbor: failed to encode %s message", suffix );
+#ifdef IOT_THREAD_SUPPORT
+	os_thread_mutex_unlock( &data->encoder_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	return result;
+}
+
+iot_status_t cbor_event_publish(
+	struct cbor_data *data,
+	const char *message,
+	const iot_options_t *options )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( data && message )
+	{
+		app_cbor_encoder_t *const enc = cbor_encoder_acquire( data );
+		iot_int64_t level;
+
+		result = app_cbor_encode_map_start( enc, APP_CBOR_INDEFINITE );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_pair( enc, "msg", message );
+		if ( result == IOT_STATUS_SUCCESS &&
+			iot_options_get_integer( options, "level",
+				IOT_TRUE, &level ) == IOT_STATUS_SUCCESS )
+		{
+			result = app_cbor_encode_string( enc, "level" );
+			if ( result == IOT_STATUS_SUCCESS )
+				result = app_cbor_encode_integer( enc, level );
+		}
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_timestamp( enc, options, 0u );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_end( enc );
+		result = cbor_encoder_release( data, "event", result );
+	}
+	return result;
+}
+
+iot_status_t cbor_execute(
+	iot_t *lib,
+	void *plugin_data,
+	iot_operation_t op,
+	const iot_transaction_t *UNUSED(txn),
+	iot_millisecond_t max_time_out,
+	iot_step_t *step,
+	const void *item,
+	const void *value,
+	const iot_options_t *options )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	struct cbor_data *const data = plugin_data;
+	if ( op != IOT_OPERATION_ITERATION )
+		IOT_LOG( lib, IOT_LOG_TRACE, "cbor: %s %d.%d",
+			"execute", (int)op, (int)*step );
+	else
+		cbor_connect_check( lib, data, max_time_out );
+
+	if ( *step == IOT_STEP_DURING )
+	{
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+#endif /* ifdef __clang__ */
+		switch( op )
+		{
+			case IOT_OPERATION_CLIENT_CONNECT:
+				result = cbor_connect( lib, data,
+					max_time_out, IOT_FALSE );
+				break;
+			case IOT_OPERATION_CLIENT_DISCONNECT:
+				result = cbor_disconnect( lib, data );
+				break;
+			case IOT_OPERATION_ITERATION:
+				if ( data && data->mqtt )
+					iot_mqtt_loop( data->mqtt, max_time_out );
+				break;
+			case IOT_OPERATION_ALARM_PUBLISH:
+				result = cbor_alarm_publish( data,
+					(const iot_alarm_t*)item,
+					(const iot_alarm_data_t*)value,
+					options );
+				break;
+			case IOT_OPERATION_ATTRIBUTE_PUBLISH:
+				result = cbor_attribute_publish( data,
+					(const char *)item,
+					(const char *)value,
+					options );
+				break;
+			case IOT_OPERATION_EVENT_PUBLISH:
+				result = cbor_event_publish( data,
+					(const char *)value, options );
+				break;
+			case IOT_OPERATION_TELEMETRY_PUBLISH:
+				result = cbor_telemetry_publish( data,
+					(const iot_telemetry_t*)item,
+					(const struct iot_data*)value,
+					options );
+				break;
+			default:
+				/* unhandled operations */
+				break;
+		}
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif /* ifdef __clang__ */
+	}
+	return result;
+}
+
+iot_status_t cbor_initialize(
+	iot_t *lib,
+	void **plugin_data )
+{
+	iot_status_t result = IOT_STATUS_NO_MEMORY;
+	struct cbor_data *const data = os_malloc( sizeof( struct cbor_data ) );
+	IOT_LOG( lib, IOT_LOG_TRACE, "cbor: %s", "initialize" );
+	if ( data )
+	{
+		os_memzero( data, sizeof( struct cbor_data ) );
+		data->lib = lib;
+		data->qos = CBOR_MQTT_QOS;
+#ifdef IOT_STACK_ONLY
+		app_cbor_encode_initialize( &data->encoder, data->buf,
+			sizeof( data->buf ), 0u );
+#else
+		app_cbor_encode_initialize( &data->encoder, NULL,
+			CBOR_BUFFER_SIZE, APP_CBOR_FLAG_DYNAMIC );
+#endif /* else ifdef IOT_STACK_ONLY */
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_create( &data->encoder_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		*plugin_data = data;
+		result = iot_mqtt_initialize();
+	}
+	return result;
+}
+
+iot_status_t cbor_telemetry_publish(
+	struct cbor_data *data,
+	const iot_telemetry_t *t,
+	const struct iot_data *d,
+	const iot_options_t *options )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( data && t && d )
+	{
+		app_cbor_encoder_t *const enc = cbor_encoder_acquire( data );
+
+		result = app_cbor_encode_map_start( enc, APP_CBOR_INDEFINITE );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_pair( enc, "key",
+				iot_telemetry_name_get( t ) );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_string( enc, "value" );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_value( enc, d );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_timestamp( enc, options,
+				t->time_stamp );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_cbor_encode_end( enc );
+		result = cbor_encoder_release( data, "telemetry", result );
+	}
+	return result;
+}
+
+iot_status_t cbor_terminate(
+	iot_t *lib,
+	void *plugin_data )
+{
+	struct cbor_data *data = plugin_data;
+	IOT_LOG( lib, IOT_LOG_TRACE, "cbor: %s", "terminate" );
+	if ( data )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_destroy( &data->encoder_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		app_cbor_encode_terminate( &data->encoder );
+		os_free( data );
+		data = NULL;
+	}
+	iot_mqtt_terminate();
+	return IOT_STATUS_SUCCESS;
+}
+
+IOT_PLUGIN( cbor, 20, iot_version_encode(1,0,0,0),
+	iot_version_encode(2,3,0,0), 0 )
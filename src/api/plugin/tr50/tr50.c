@@ -18,6 +18,9 @@
 #include "../../shared/iot_base64.h"
 #include "../../shared/iot_defs.h"
 #include "../../shared/iot_types.h"
+#include "tr50_dedup.h"
+#include "tr50_journal.h"
+#include "tr50_telemetry.h"
 
 #include <iot_checksum.h>
 #include <iot_json.h>
@@ -25,11 +28,58 @@
 #include <iot_plugin.h>
 #include <os.h>
 #include <curl/curl.h>
+#ifndef IOT_STACK_ONLY
+#define ZLIB_CONST /* for const input pointer in z_stream */
+#include <zlib.h>
+#endif /* ifndef IOT_STACK_ONLY */
 
 #ifdef IOT_STACK_ONLY
+#ifndef TR50_IN_BUFFER_SIZE
+/** @brief Size of the buffer holding the tokens of an inbound message (can
+ *         be set when building, for larger mailbox batches) */
 #define TR50_IN_BUFFER_SIZE                 1024u
+#endif /* ifndef TR50_IN_BUFFER_SIZE */
+/** @brief Size of the buffer used to coalesce outbound commands */
+#define TR50_BATCH_BYTES_MAX                4096u
+/** @brief Size of each buffer used to encode an outbound command */
+#define TR50_ENCODER_BYTES_MAX              2048u
 #endif /* ifdef IOT_STACK_ONLY */
 
+/** @brief Maximum number of commands coalesced into a single message */
+#define TR50_BATCH_COUNT_MAX                64u
+/** @brief Key of a coalesced command without a transaction, followed by
+ *         its position in the message */
+#define TR50_BATCH_KEY_PREFIX               "cmd"
+/** @brief Longest key written for a coalesced command without a
+ *         transaction, including quotes and colon: "cmd63": */
+#define TR50_BATCH_KEY_MAX                  ( sizeof( TR50_BATCH_KEY_PREFIX ) + 4u )
+/** @brief Size of the buffer used to coalesce mailbox acknowledgements */
+#define TR50_ACK_BYTES_MAX                  4096u
+/** @brief Maximum number of mailbox acknowledgements in a single message */
+#define TR50_ACK_COUNT_MAX                  32u
+/** @brief Maximum time in milliseconds an acknowledgement waits to be
+ *         coalesced */
+#define TR50_ACK_LINGER                     100u
+/** @brief Default number of commands coalesced into a single message
+ *         (1 = send each command in its own message) */
+#define TR50_BATCH_COUNT_DEFAULT            1u
+/** @brief Default maximum size in bytes of a coalesced message */
+#define TR50_BATCH_BYTES_DEFAULT            4096u
+/** @brief Default time in milliseconds a command waits to be coalesced */
+#define TR50_BATCH_LINGER_DEFAULT           100u
+/** @brief Default size in bytes from which outbound messages are
+ *         compressed (0 = never compress) */
+#define TR50_COMPRESS_THRESHOLD_DEFAULT     0u
+/** @brief Key replayed journal records are sent with, replies to it are
+ *         not matched to a transaction */
+#define TR50_JOURNAL_KEY                    "{\"journal\":"
+/** @brief Default number of journal records replayed per second */
+#define TR50_JOURNAL_REPLAY_RATE_DEFAULT    10u
+/** @brief Number of reusable encoders kept for outbound commands */
+#define TR50_ENCODER_POOL_MAX               4u
+/** @brief Maximum number of telemetry objects with a pre-encoded message */
+#define TR50_TELEMETRY_TEMPLATE_MAX         32u
+
 /** @brief Maximum concurrent file transfers */
 #define TR50_FILE_TRANSFER_MAX              10u
 /** @brief Time interval in seconds to check file
@@ -40,16 +90,15 @@
 #define TR50_FILE_TRANSFER_EXPIRY_TIME      1u * IOT_MINUTES_IN_HOUR * \
                                             IOT_SECONDS_IN_MINUTE * \
                                             IOT_MILLISECONDS_IN_SECOND /* 1 hour */
-/** @brief Amount to offset the request id by */
-#define TR50_FILE_REQUEST_ID_OFFSET         256u
+/** @brief Prefix of the request id of file transfers, so they can't be
+ *         mistaken for a transaction id */
+#define TR50_FILE_REQUEST_ID_PREFIX         "file"
 /** @brief number of seconds before sending a keep alive message */
 #define TR50_MQTT_KEEP_ALIVE                60u
 /** @brief Time interval to send a ping if not data received */
 #define TR50_PING_INTERVAL                  60 * IOT_MILLISECONDS_IN_SECOND
 /** @brief Time interval to check mailbox if nothing */
 #define TR50_MAILBOX_CHECK_INTERVAL         120 * IOT_MILLISECONDS_IN_SECOND
-/** @brief Maximum number of actions to receive per mailbox check */
-#define TR50_MAILBOX_CHECK_LIMIT            1
 /** @brief Number of pings that can be missed before reconnection */
 #define TR50_PING_MISS_ALLOWED              0u
 /** @brief default QOS level */
@@ -111,9 +160,163 @@ struct tr50_file_transfer
 	iot_int64_t max_retries;
 };
 
+/** @brief outbound commands waiting to be sent in a single message */
+struct tr50_batch
+{
+#ifdef IOT_STACK_ONLY
+	/** @brief buffer holding the message being built */
+	char buf[ TR50_BATCH_BYTES_MAX + 1u ];
+#else
+	/** @brief buffer holding the message being built */
+	char *buf;
+#endif /* ifdef IOT_STACK_ONLY */
+	/** @brief number of commands in the message */
+	iot_uint32_t count;
+	/** @brief current length of the message */
+	size_t len;
+	/** @brief maximum size of a message in bytes */
+	size_t max_bytes;
+	/** @brief maximum number of commands in a message */
+	iot_uint32_t max_count;
+	/** @brief maximum time a command waits before the message is sent */
+	iot_millisecond_t max_linger;
+#ifdef IOT_THREAD_SUPPORT
+	/** @brief mutex protecting the message being built */
+	os_thread_mutex_t mutex;
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	/** @brief time the first command was added to the message */
+	iot_timestamp_t time_first;
+	/** @brief transaction ids of the commands in the message (0 for a
+	 *         command without one) */
+	iot_transaction_t txn[ TR50_BATCH_COUNT_MAX ];
+	/** @brief offset of the end of each command's value in the message */
+	iot_uint32_t value_end[ TR50_BATCH_COUNT_MAX ];
+	/** @brief offset of the start of each command's value in the message */
+	iot_uint32_t value_start[ TR50_BATCH_COUNT_MAX ];
+};
+
+/** @brief mailbox acknowledgements waiting to be sent in a single message */
+struct tr50_ack
+{
+	/** @brief buffer holding the message being built */
+	char buf[ TR50_ACK_BYTES_MAX + 1u ];
+	/** @brief number of acknowledgements in the message */
+	iot_uint32_t count;
+	/** @brief current length of the message */
+	size_t len;
+#ifdef IOT_THREAD_SUPPORT
+	/** @brief mutex protecting the message being built */
+	os_thread_mutex_t mutex;
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	/** @brief time the first acknowledgement was added to the message */
+	iot_timestamp_t time_first;
+};
+
+#ifndef IOT_STACK_ONLY
+/** @brief reusable context for compressing outbound messages */
+struct tr50_compress
+{
+	/** @brief buffer holding the compressed message */
+	iot_uint8_t *buf;
+	/** @brief size of the compressed message buffer */
+	size_t buf_len;
+	/** @brief compression level (1-9) */
+	int level;
+#ifdef IOT_THREAD_SUPPORT
+	/** @brief mutex protecting the stream and buffer */
+	os_thread_mutex_t mutex;
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	/** @brief whether the deflate stream has been set up */
+	iot_bool_t ready;
+	/** @brief deflate stream, reset between messages */
+	z_stream stream;
+	/** @brief size from which messages are compressed (0 = never) */
+	size_t threshold;
+};
+#endif /* ifndef IOT_STACK_ONLY */
+
+/** @brief date and time of the last time stamp formatted */
+struct tr50_time_cache
+{
+	/** @brief second the text was formatted for */
+	iot_timestamp_t second;
+	/** @brief length of the text (0 = nothing cached) */
+	size_t len;
+	/** @brief formatted time up to the seconds: "YYYY-MM-DDTHH:MM:SS" */
+	char text[ TR50_TIME_LEN ];
+};
+
+/** @brief reusable encoder for outbound commands */
+struct tr50_encoder
+{
+#ifdef IOT_STACK_ONLY
+	/** @brief buffer holding the encoder and the message being built */
+	char buf[ TR50_ENCODER_BYTES_MAX ];
+	/** @brief buffer for values converted before being encoded */
+	char scratch[ TR50_ENCODER_BYTES_MAX ];
+#else
+	/** @brief buffer for values converted before being encoded */
+	char *scratch;
+	/** @brief size of the scratch buffer */
+	size_t scratch_len;
+	/** @brief encoder is not part of the pool and is freed on release */
+	iot_bool_t temporary;
+#endif /* ifdef IOT_STACK_ONLY */
+	/** @brief whether the encoder is currently in use */
+	iot_bool_t in_use;
+	/** @brief json encoder, kept between messages */
+	iot_json_encoder_t *json;
+	/** @brief time stamp text reused between messages */
+	struct tr50_time_cache time;
+};
+
+/**
+ * @brief writes the value of a telemetry sample as a JSON number
+ *
+ * @param[out]     buf                 destination buffer, must hold at least
+ *                                     IOT_JSON_NUMBER_MAX_LEN characters
+ * @param[in]      t                   telemetry object being published
+ * @param[in]      d                   sample to write
+ *
+ * @return the number of characters written, 0 if the value can't be written
+ */
+typedef size_t (tr50_value_writer_t)(
+	char *buf,
+	const iot_telemetry_t *t,
+	const struct iot_data *d );
+
+/** @brief pre-encoded parts of the message published for a telemetry */
+struct tr50_telemetry_template
+{
+	/** @brief telemetry object the template was built for */
+	const iot_telemetry_t *telemetry;
+	/** @brief type of sample the value writer handles */
+	iot_type_t type;
+	/** @brief writes the value of a sample */
+	tr50_value_writer_t *write_value;
+	/** @brief length of the pre-encoded key part */
+	size_t key_len;
+	/** @brief pre-encoded key part: ","key":"<name>","value": */
+	char key[ TR50_TELEMETRY_KEY_MAX ];
+};
+
 /** @brief internal data required for the plug-in */
 struct tr50_data
 {
+	/** @brief mailbox acknowledgements waiting to be sent */
+	struct tr50_ack ack;
+	/** @brief outbound commands waiting to be sent */
+	struct tr50_batch batch;
+#ifndef IOT_STACK_ONLY
+	/** @brief compression of large outbound messages */
+	struct tr50_compress compress;
+#endif /* ifndef IOT_STACK_ONLY */
+	/** @brief reusable encoders for outbound commands */
+	struct tr50_encoder encoder[ TR50_ENCODER_POOL_MAX ];
+#ifdef IOT_THREAD_SUPPORT
+	/** @brief mutex protecting the encoder pool */
+	os_thread_mutex_t encoder_mutex;
+#endif /* ifdef IOT_THREAD_SUPPORT */
 	/** @brief number of times connection lost reported */
 	iot_uint32_t connection_lost_msg_count;
 	/** @brief file transfer queue */
@@ -122,6 +325,17 @@ struct tr50_data
 	iot_uint8_t file_transfer_count;
 	/** @brief time when file transfer queue is last checked */
 	iot_timestamp_t file_queue_last_checked;
+	/** @brief mailbox messages recently executed */
+	struct tr50_dedup dedup;
+	/** @brief store-and-forward journal for offline commands */
+	struct tr50_journal journal;
+	/** @brief buffer for replaying journal records */
+	char journal_buf[ sizeof( TR50_JOURNAL_KEY ) +
+		TR50_JOURNAL_RECORD_MAX + 1u ];
+	/** @brief maximum number of journal records replayed per second */
+	iot_uint32_t journal_replay_rate;
+	/** @brief time when journal records were last replayed */
+	iot_timestamp_t journal_replay_time;
 	/** @brief library handle */
 	iot_t *lib;
 #ifdef IOT_THREAD_SUPPORT
@@ -130,6 +344,9 @@ struct tr50_data
 	/** @brief pointer to the mqtt connection to the cloud */
 #endif /* IOT_THREAD_SUPPORT */
 	iot_mqtt_t *mqtt;
+	/** @brief maximum number of actions requested by the last mailbox
+	 *         check */
+	iot_uint32_t mailbox_limit;
 	/** @brief current number of pings missed */
 	iot_uint8_t ping_miss_count;
 	/** @brief proxy details */
@@ -138,23 +355,149 @@ struct tr50_data
 	iot_uint32_t reconnect_count;
 	/** @brief the key of the thing */
 	char thing_key[ TR50_THING_KEY_MAX_LEN + 1u ];
+	/** @brief the key of the thing, with JSON escape sequences added */
+	char thing_key_json[ 6u * ( TR50_THING_KEY_MAX_LEN ) ];
+	/** @brief length of the escaped key of the thing (0 = not connected) */
+	size_t thing_key_json_len;
+	/** @brief pre-encoded messages for registered telemetry */
+	struct tr50_telemetry_template telemetry[ TR50_TELEMETRY_TEMPLATE_MAX ];
+	/** @brief number of pre-encoded telemetry messages */
+	iot_uint32_t telemetry_count;
+#ifdef IOT_THREAD_SUPPORT
+	/** @brief mutex protecting the pre-encoded telemetry messages */
+	os_thread_mutex_t telemetry_mutex;
+#endif /* ifdef IOT_THREAD_SUPPORT */
 	/** @brief time when mailbox was last checked */
 	iot_timestamp_t time_last_mailbox_check;
 	/** @brief time when last message was received from cloud */
 	iot_timestamp_t time_last_msg_received;
-	/** @brief transaction status based on id */
-	iot_uint32_t transactions[16u];
 };
 
-/** @brief transaction status values */
-enum tr50_transaction_status
+/** @brief items of the reply to a command */
+struct tr50_reply
+{
+	/** @brief whether the command succeeded */
+	iot_bool_t success;
+	/** @brief messages returned by a mailbox check ("params.messages") */
+	const iot_json_item_t *messages;
+	/** @brief id of a file to transfer ("params.fileId") */
+	const iot_json_item_t *file_id;
+	/** @brief checksum of a file to transfer ("params.crc32") */
+	iot_int64_t crc32;
+	/** @brief size of a file to transfer ("params.fileSize") */
+	iot_int64_t file_size;
+};
+
+/** @brief items of a message in the mailbox */
+struct tr50_mailbox_message
 {
-	TR50_TRANSACTION_UNKNOWN = 0x0, /**< @brief unknown transaction */
-	TR50_TRANSACTION_INVOKED = 0x1, /**< @brief transaction sent */
-	TR50_TRANSACTION_FAILURE = 0x2, /**< @brief failure received */
-	TR50_TRANSACTION_SUCCESS = 0x3, /**< @brief success received */
+	/** @brief id of the message */
+	char id[ IOT_ID_MAX_LEN + 1u ];
+	/** @brief name of the action to execute ("params.method") */
+	char method[ IOT_NAME_MAX_LEN + 1u ];
+	/** @brief method and parameters of the action ("params") */
+	const iot_json_item_t *params;
+	/** @brief parameters of the action ("params.params") */
+	const iot_json_item_t *parameters;
+};
+
+/** @brief items bound from the "params" object of a reply */
+static const iot_json_bind_t TR50_REPLY_PARAMS[] = {
+	IOT_JSON_BIND_FIELD( "messages", IOT_JSON_BIND_ITEM, 0u,
+		struct tr50_reply, messages ),
+	IOT_JSON_BIND_FIELD( "fileId", IOT_JSON_BIND_ITEM, 0u,
+		struct tr50_reply, file_id ),
+	IOT_JSON_BIND_FIELD( "crc32", IOT_JSON_BIND_INTEGER, 0u,
+		struct tr50_reply, crc32 ),
+	IOT_JSON_BIND_FIELD( "fileSize", IOT_JSON_BIND_INTEGER, 0u,
+		struct tr50_reply, file_size )
+};
+
+/** @brief items bound from the reply to a command */
+static const iot_json_bind_t TR50_REPLY[] = {
+	IOT_JSON_BIND_FIELD( "success", IOT_JSON_BIND_BOOL,
+		IOT_JSON_BIND_REQUIRED, struct tr50_reply, success ),
+	IOT_JSON_BIND_NESTED( "params", 0u, TR50_REPLY_PARAMS )
 };
 
+/** @brief items bound from the "params" object of a mailbox message */
+static const iot_json_bind_t TR50_MAILBOX_PARAMS[] = {
+	IOT_JSON_BIND_FIELD( "method", IOT_JSON_BIND_STRING, 0u,
+		struct tr50_mailbox_message, method ),
+	IOT_JSON_BIND_FIELD( "params", IOT_JSON_BIND_ITEM, 0u,
+		struct tr50_mailbox_message, parameters )
+};
+
+/** @brief items bound from a mailbox message */
+static const iot_json_bind_t TR50_MAILBOX_MESSAGE[] = {
+	IOT_JSON_BIND_FIELD( "id", IOT_JSON_BIND_STRING, 0u,
+		struct tr50_mailbox_message, id ),
+	IOT_JSON_BIND_FIELD( "params", IOT_JSON_BIND_ITEM, 0u,
+		struct tr50_mailbox_message, params ),
+	IOT_JSON_BIND_NESTED( "params", 0u, TR50_MAILBOX_PARAMS )
+};
+
+
+/**
+ * @brief sends the pending mailbox acknowledgements if required
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in]      force               send the acknowledgements even if the
+ *                                     linger time has not expired
+ */
+static IOT_SECTION void tr50_ack_check(
+	struct tr50_data *data,
+	iot_bool_t force );
+
+/**
+ * @brief sends the pending mailbox acknowledgements as a single message
+ *
+ * @note the acknowledgement mutex must be held by the caller
+ *
+ * @param[in]      data                plug-in specific data
+ *
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t tr50_ack_flush(
+	struct tr50_data *data );
+
+/**
+ * @brief queues a mailbox acknowledgement to be sent with others
+ *
+ * Messages too large to be coalesced are sent on their own.
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in]      msg                 encoded command: {"<key>":{...}}
+ * @param[in]      msg_len             length of the encoded command
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t tr50_ack_publish(
+	struct tr50_data *data,
+	const char *msg,
+	size_t msg_len );
+
+/**
+ * @brief queues a mailbox acknowledgement without output parameters
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in]      req_id              id of the mailbox message
+ * @param[in]      status              status to report for the message
+ * @param[in]      error_msg           error message to report (optional)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_NO_MEMORY        no encoder available
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t tr50_ack_status(
+	struct tr50_data *data,
+	const char *req_id,
+	iot_status_t status,
+	const char *error_msg );
 
 /**
  * @brief function called to respond to the cloud on an action complete
@@ -175,6 +518,19 @@ static IOT_SECTION iot_status_t tr50_action_complete(
 	const iot_transaction_t *txn,
 	const iot_options_t *options );
 
+/**
+ * @brief determines whether a registered action returns a result
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      name                name of the action
+ *
+ * @retval IOT_FALSE                   action returns a result or is unknown
+ * @retval IOT_TRUE                    action is flagged IOT_ACTION_NO_RETURN
+ */
+static IOT_SECTION iot_bool_t tr50_action_no_return(
+	const iot_t *lib,
+	const char *name );
+
 /**
  * @brief publishes an alarm to the cloud
  *
@@ -212,13 +568,13 @@ static IOT_SECTION void tr50_append_location(
 /**
  * @brief appends a raw data value to to json structure
  *
- * @param[in,out]  json                structure to append to
+ * @param[in,out]  enc                 encoder to append to
  * @param[in]      key                 key to assoicate with object
  * @param[in]      value               value to append
  * @param[in]      len                 length of value to append
  */
 static IOT_SECTION void tr50_append_value_raw(
-	iot_json_encoder_t *json,
+	struct tr50_encoder *enc,
 	const char *key,
 	const void *value,
 	size_t len );
@@ -245,6 +601,63 @@ static IOT_SECTION iot_status_t tr50_attribute_publish(
 	const iot_transaction_t *txn,
 	const iot_options_t *options );
 
+/**
+ * @brief sends the coalesced commands to the cloud
+ *
+ * @note the caller must hold the batch mutex
+ *
+ * @param[in,out]  data                plug-in specific data
+ *
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success (or nothing to send)
+ *
+ * @see tr50_batch_publish
+ */
+static IOT_SECTION iot_status_t tr50_batch_flush(
+	struct tr50_data *data );
+
+/**
+ * @brief sends the coalesced commands to the cloud if they have waited
+ *        longer than the linger time
+ *
+ * @param[in,out]  data                plug-in specific data
+ * @param[in]      force               send regardless of the linger time
+ *
+ * @see tr50_batch_flush
+ * @see tr50_batch_publish
+ */
+static IOT_SECTION void tr50_batch_check(
+	struct tr50_data *data,
+	iot_bool_t force );
+
+/**
+ * @brief publishes a single command message, coalescing it with other
+ *        pending commands if enabled
+ *
+ * The message must be a json object containing one command keyed by its
+ * transaction id (i.e. {"<txn>":{...}}).  The command keeps its key when
+ * added to the outbound message, so replies continue to be matched with
+ * the transaction.  If the cloud can't be reached the command is added to
+ * the journal (if enabled) to be sent later.
+ *
+ * @param[in,out]  data                plug-in specific data
+ * @param[in]      msg                 message to publish
+ * @param[in]      msg_len             length of the message
+ * @param[in]      txn                 transaction status information
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see tr50_batch_check
+ * @see tr50_mqtt_publish
+ */
+static IOT_SECTION iot_status_t tr50_batch_publish(
+	struct tr50_data *data,
+	const char *msg,
+	size_t msg_len,
+	const iot_transaction_t *txn );
+
 /**
  * @brief Sends the message to check the mailbox for any cloud requests
  *
@@ -258,6 +671,29 @@ static IOT_SECTION iot_status_t tr50_check_mailbox(
 	struct tr50_data *data,
 	const iot_transaction_t *txn );
 
+#ifndef IOT_STACK_ONLY
+/**
+ * @brief compresses an outbound message into a zlib (RFC 1950) stream
+ *
+ * The stream starts with a zlib header (0x78), which a JSON message never
+ * does, so the receiving side can tell compressed and plain messages apart.
+ *
+ * @param[in,out]  z                   compression context, locked by caller
+ * @param[in,out]  payload             message to compress, set to the
+ *                                     compressed message on success
+ * @param[in,out]  payload_len         length of the message, set to the
+ *                                     length of the compressed message on
+ *                                     success
+ *
+ * @retval IOT_TRUE                    message compressed
+ * @retval IOT_FALSE                   message is to be sent as-is
+ */
+static IOT_SECTION iot_bool_t tr50_compress(
+	struct tr50_compress *z,
+	const void **payload,
+	size_t *payload_len );
+#endif /* ifndef IOT_STACK_ONLY */
+
 /**
  * @brief helper function for tr50 to connect to the cloud
  *
@@ -322,6 +758,17 @@ iot_status_t tr50_disable(
 	void* plugin_data,
 	iot_bool_t force );
 
+/**
+ * @brief opens the cache of recently executed mailbox messages, if
+ *        enabled in the configuration
+ *
+ * @param[in]      lib                 loaded iot library
+ * @param[in,out]  data                plug-in specific data
+ */
+static IOT_SECTION void tr50_dedup_start(
+	iot_t *lib,
+	struct tr50_data *data );
+
 /**
  * @brief helper function for tr50 to disconnect from the cloud
  *
@@ -354,6 +801,48 @@ iot_status_t tr50_enable(
 	iot_t *lib,
 	void* plugin_data );
 
+/**
+ * @brief obtains an encoder for an outbound command
+ *
+ * The encoder is taken from the pool and keeps the memory allocated for
+ * previous messages.  If all encoders in the pool are in use, a temporary
+ * one is allocated.
+ *
+ * @param[in,out]  data                plug-in specific data
+ *
+ * @retval NULL                        no encoder available
+ * @retval !NULL                       encoder, ready for a new message
+ *
+ * @see tr50_encoder_release
+ */
+static IOT_SECTION struct tr50_encoder *tr50_encoder_acquire(
+	struct tr50_data *data );
+
+/**
+ * @brief returns an encoder obtained from tr50_encoder_acquire
+ *
+ * @param[in,out]  data                plug-in specific data
+ * @param[in,out]  enc                 encoder to return
+ *
+ * @see tr50_encoder_acquire
+ */
+static IOT_SECTION void tr50_encoder_release(
+	struct tr50_data *data,
+	struct tr50_encoder *enc );
+
+/**
+ * @brief returns a scratch buffer of the encoder, growing it if required
+ *
+ * @param[in,out]  enc                 encoder
+ * @param[in]      len                 minimum size of the buffer required
+ *
+ * @retval NULL                        not enough memory
+ * @retval !NULL                       scratch buffer of at least len bytes
+ */
+static IOT_SECTION char *tr50_encoder_scratch(
+	struct tr50_encoder *enc,
+	size_t len );
+
 /**
  * @brief called when event log api publish is called
  *
@@ -374,6 +863,52 @@ static IOT_SECTION iot_status_t tr50_event_publish(
 	const iot_transaction_t *txn,
 	const iot_options_t *options );
 
+/**
+ * @brief adds the value of a command to the store-and-forward journal
+ *
+ * @param[in,out]  data                plug-in specific data
+ * @param[in]      value               command value to add
+ * @param[in]      len                 length of the command value
+ * @param[in]      txn_id              transaction identifier of the command
+ *                                     (0 if it has none)
+ *
+ * @retval IOT_STATUS_FULL             journal is full
+ * @retval IOT_STATUS_IO_ERROR         failed to write to the journal
+ * @retval IOT_STATUS_NOT_INITIALIZED  journal is not enabled
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see tr50_journal_replay
+ */
+static IOT_SECTION iot_status_t tr50_journal_command(
+	struct tr50_data *data,
+	const char *value,
+	size_t len,
+	iot_transaction_t txn_id );
+
+/**
+ * @brief sends commands from the journal to the cloud, limited to the
+ *        configured replay rate
+ *
+ * @param[in,out]  data                plug-in specific data
+ *
+ * @see tr50_journal_command
+ */
+static IOT_SECTION void tr50_journal_replay(
+	struct tr50_data *data );
+
+/**
+ * @brief opens the store-and-forward journal, if enabled in the
+ *        configuration
+ *
+ * @param[in]      lib                 loaded iot library
+ * @param[in,out]  data                plug-in specific data
+ *
+ * @see tr50_journal_command
+ */
+static IOT_SECTION void tr50_journal_start(
+	iot_t *lib,
+	struct tr50_data *data );
+
 /**
  * @brief plug-in function called to perform work in the plug-in
  *
@@ -498,6 +1033,17 @@ iot_status_t tr50_initialize(
 	iot_t *lib,
 	void **plugin_data );
 
+/**
+ * @brief determines whether the connection to the cloud is up
+ *
+ * @param[in]      data                plug-in specific data
+ *
+ * @retval IOT_FALSE                   not connected to the cloud
+ * @retval IOT_TRUE                    connected to the cloud
+ */
+static IOT_SECTION iot_bool_t tr50_online(
+	const struct tr50_data *data );
+
 /**
  * @brief helper fuction to publish data using MQTT
  *
@@ -574,86 +1120,383 @@ static IOT_SECTION void tr50_ping(
 /**
  * @brief convert a timestamp to a formatted time as in RFC3339
  *
+ * @param[in,out]  cache               (optional) date and time formatted
+ *                                     previously, reused if @p ts is in the
+ *                                     same second
  * @param[in]      ts                  time stamp to convert
  * @param[in,out]  out                 output buffer
  * @param[in]      len                 size of the output buffer
  *
- * @return a pointer to the output buffer
+ * @return the number of characters written, 0 if the buffer is too small
  */
-static IOT_SECTION char *tr50_strtime(
+static IOT_SECTION size_t tr50_strtime(
+	struct tr50_time_cache *cache,
 	iot_timestamp_t ts,
 	char *out,
 	size_t len );
 
 /**
- * @brief publishes a piece of iot telemetry to the cloud
+ * @brief appends the time stamp for a command
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in,out]  enc                 encoder to add time stamp to
+ * @param[in]      options             map containing optional settings
+ * @param[in]      ts                  time stamp to use if not set in
+ *                                     @p options (0 = none)
+ *
+ * @see tr50_timestamp_get
+ */
+static IOT_SECTION void tr50_timestamp(
+	const struct tr50_data *data,
+	struct tr50_encoder *enc,
+	const iot_options_t *options,
+	iot_timestamp_t ts );
+
+/**
+ * @brief returns the time stamp for a command
+ *
+ * The time stamp is taken from the "time_stamp" option.  If the option is
+ * not set and the journal is enabled, the current time is used so that
+ * commands replayed from the journal keep their original time.
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in]      options             map containing optional settings
+ * @param[in]      ts                  time stamp to use if not set in
+ *                                     @p options (0 = none)
+ *
+ * @return the time stamp for the command, 0 if none
+ */
+static IOT_SECTION iot_timestamp_t tr50_timestamp_get(
+	const struct tr50_data *data,
+	const iot_options_t *options,
+	iot_timestamp_t ts );
+
+/**
+ * @brief encodes the message for a telemetry sample
  *
  * @param[in]      data                plug-in specific data
+ * @param[in,out]  enc                 encoder to use
  * @param[in]      t                   telemetry object to publish
- * @param[in]      d                   data for telemetry object to publish
+ * @param[in]      d                   sample to publish
  * @param[in]      txn                 transaction status information
  * @param[in]      options             map containing an optional options set
  *
- * @retval IOT_STATUS_FAILURE          on failure
- * @retval IOT_STATUS_SUCCESS          on success
+ * @return the encoded message, NULL on failure
+ *
+ * @see tr50_telemetry_message
  */
-static IOT_SECTION iot_status_t tr50_telemetry_publish(
-	struct tr50_data *data,
+static IOT_SECTION const char *tr50_telemetry_encode(
+	const struct tr50_data *data,
+	struct tr50_encoder *enc,
 	const iot_telemetry_t *t,
 	const struct iot_data *d,
 	const iot_transaction_t *txn,
 	const iot_options_t *options );
 
 /**
- * @brief plug-in function called to terminate the plug-in
+ * @brief removes the pre-encoded message for a telemetry object
  *
- * @param[in]      lib                 library handle
- * @param[in]      plugin_data         plugin specific data
+ * @param[in,out]  data                plug-in specific data
+ * @param[in]      t                   telemetry object being deregistered
  *
- * @retval IOT_STATUS_FAILURE          on failure
  * @retval IOT_STATUS_SUCCESS          on success
  *
- * @see tr50_disable
- * @see tr50_initialize
+ * @see tr50_telemetry_register
  */
-iot_status_t tr50_terminate(
-	iot_t *lib,
-	void *plugin_data );
+static IOT_SECTION iot_status_t tr50_telemetry_deregister(
+	struct tr50_data *data,
+	const iot_telemetry_t *t );
 
 /**
- * @brief function called to determine the status of a transaction
+ * @brief builds the message for a telemetry sample from its pre-encoded
+ *        template
  *
  * @param[in]      data                plug-in specific data
- * @param[in]      txn                 transaction
- * @param[in]      options             optional parameters set for request
+ * @param[in,out]  enc                 encoder whose scratch buffer holds the
+ *                                     message
+ * @param[in]      t                   telemetry object to publish
+ * @param[in]      d                   sample to publish
+ * @param[in]      txn                 transaction status information
+ * @param[in]      options             map containing an optional options set
+ * @param[out]     msg_len             length of the message
  *
- * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
- * @retval IOT_STATUS_INVOKED          message has been sent/queue no response
- * @retval IOT_STATUS_FAILURE          failure status returned from cloud
- * @retval IOT_STATUS_NOT_FOUND        transaction is unknown
- * @retval IOT_STATUS_SUCCESS          success status returned from cloud
- * @retval IOT_STATUS_TIMED_OUT        function timed out before status returned
+ * @return the message, NULL if the telemetry has no template that handles
+ *         the sample
  *
- * @see tr50_disable
- * @see tr50_initialize
+ * @see tr50_telemetry_register
  */
-static iot_status_t tr50_transaction_status(
-	const struct tr50_data *data,
+static IOT_SECTION const char *tr50_telemetry_message(
+	struct tr50_data *data,
+	struct tr50_encoder *enc,
+	const iot_telemetry_t *t,
+	const struct iot_data *d,
 	const iot_transaction_t *txn,
-	const iot_options_t *options );
+	const iot_options_t *options,
+	size_t *msg_len );
 
 /**
- * @brief sets the transaction status for an incoming transaction
+ * @brief publishes a piece of iot telemetry to the cloud
  *
- * @param[in,out]  data                plug-in specific data
- * @param[in]      txn_id              transaction identifier
- * @param[in]      tx_status           status to set
+ * @param[in]      data                plug-in specific data
+ * @param[in]      t                   telemetry object to publish
+ * @param[in]      d                   data for telemetry object to publish
+ * @param[in]      txn                 transaction status information
+ * @param[in]      options             map containing an optional options set
+ *
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
  */
-static void tr50_transaction_status_set(
+static IOT_SECTION iot_status_t tr50_telemetry_publish(
+	struct tr50_data *data,
+	const iot_telemetry_t *t,
+	const struct iot_data *d,
+	const iot_transaction_t *txn,
+	const iot_options_t *options );
+
+/**
+ * @brief publishes a statistic of an aggregated piece of telemetry
+ *
+ * The statistic is published as a property with the key:
+ * "<telemetry name>.<stat>", under its own transaction so it is journaled
+ * while the cloud can't be reached.
+ *
+ * @param[in]      data                plug-in specific data
+ * @param[in]      t                   telemetry object statistic is for
+ * @param[in]      stat                name of the statistic
+ * @param[in]      value               value of the statistic
+ * @param[in]      options             options for the sample (optional)
+ *
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_NO_MEMORY        no encoder available
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t tr50_telemetry_publish_stat(
+	struct tr50_data *data,
+	const iot_telemetry_t *t,
+	const char *stat,
+	iot_float64_t value,
+	const iot_options_t *options );
+
+/**
+ * @brief pre-encodes the parts of the messages for a telemetry object that
+ *        don't change between samples
+ *
+ * Templates are only built for boolean and numeric telemetry, other samples
+ * are encoded in full each time.
+ *
+ * @param[in,out]  data                plug-in specific data
+ * @param[in]      t                   telemetry object being registered
+ *
+ * @retval IOT_STATUS_SUCCESS          on success (including when no template
+ *                                     is built)
+ *
+ * @see tr50_telemetry_deregister
+ * @see tr50_telemetry_message
+ */
+static IOT_SECTION iot_status_t tr50_telemetry_register(
+	struct tr50_data *data,
+	const iot_telemetry_t *t );
+
+/**
+ * @brief plug-in function called to terminate the plug-in
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      plugin_data         plugin specific data
+ *
+ * @retval IOT_STATUS_FAILURE          on failure
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see tr50_disable
+ * @see tr50_initialize
+ */
+iot_status_t tr50_terminate(
+	iot_t *lib,
+	void *plugin_data );
+
+/**
+ * @brief value writers for each type of telemetry sample
+ *
+ * @param[out]     buf                 destination buffer, must hold at least
+ *                                     IOT_JSON_NUMBER_MAX_LEN characters
+ * @param[in]      t                   telemetry object being published
+ * @param[in]      d                   sample to write
+ *
+ * @return the number of characters written, 0 if the value can't be written
+ *
+ * @see tr50_value_writer_t
+ * @{
+ */
+static IOT_SECTION tr50_value_writer_t tr50_value_bool;
+static IOT_SECTION tr50_value_writer_t tr50_value_float32;
+static IOT_SECTION tr50_value_writer_t tr50_value_float64;
+static IOT_SECTION tr50_value_writer_t tr50_value_int8;
+static IOT_SECTION tr50_value_writer_t tr50_value_int16;
+static IOT_SECTION tr50_value_writer_t tr50_value_int32;
+static IOT_SECTION tr50_value_writer_t tr50_value_int64;
+static IOT_SECTION tr50_value_writer_t tr50_value_uint8;
+static IOT_SECTION tr50_value_writer_t tr50_value_uint16;
+static IOT_SECTION tr50_value_writer_t tr50_value_uint32;
+static IOT_SECTION tr50_value_writer_t tr50_value_uint64;
+/** @} */
+
+/**
+ * @brief writes a signed integer as a JSON number
+ *
+ * @param[out]     buf                 destination buffer, must hold at least
+ *                                     IOT_JSON_NUMBER_MAX_LEN characters
+ * @param[in]      value               integer to write
+ *
+ * @return the number of characters written
+ */
+static IOT_SECTION size_t tr50_value_signed(
+	char *buf,
+	iot_int64_t value );
+
+
+void tr50_ack_check(
+	struct tr50_data *data,
+	iot_bool_t force )
+{
+	if ( data )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &data->ack.mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		if ( data->ack.count > 0u && ( force != IOT_FALSE ||
+			iot_timestamp_now() - data->ack.time_first >=
+				TR50_ACK_LINGER ) )
+			tr50_ack_flush( data );
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &data->ack.mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+}
+
+iot_status_t tr50_ack_flush(
+	struct tr50_data *data )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	struct tr50_ack *const ack = &data->ack;
+	if ( ack->count > 0u )
+	{
+		ack->buf[ack->len++] = '}';
+		ack->buf[ack->len] = '\0';
+		result = tr50_mqtt_publish( data, "api",
+			ack->buf, ack->len, NULL );
+		ack->count = 0u;
+		ack->len = 0u;
+	}
+	return result;
+}
+
+iot_status_t tr50_ack_publish(
 	struct tr50_data *data,
-	iot_uint8_t txn_id,
-	enum tr50_transaction_status tx_status );
+	const char *msg,
+	size_t msg_len )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( data && msg && msg_len > 2u &&
+		msg[0] == '{' && msg[msg_len - 1u] == '}' )
+	{
+		struct tr50_ack *const ack = &data->ack;
+		/* command value, following the key */
+		const char *value = os_strchr( msg, ':' );
+		size_t value_len = 0u;
+		/* room for the separator, key and closing brace */
+		const size_t key_max = sizeof( "\"a4294967295\":" ) + 2u;
+		iot_bool_t queued = IOT_FALSE;
+
+		if ( value )
+		{
+			++value;
+			value_len = (size_t)( &msg[msg_len - 1u] - value );
+		}
+
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &ack->mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		/* not enough room, send the pending acknowledgements first */
+		if ( ack->count > 0u &&
+			ack->len + key_max + value_len > TR50_ACK_BYTES_MAX )
+			tr50_ack_flush( data );
+
+		if ( value && key_max + value_len < TR50_ACK_BYTES_MAX )
+		{
+			if ( ack->count == 0u )
+			{
+				ack->buf[0] = '{';
+				ack->len = 1u;
+				ack->time_first = iot_timestamp_now();
+			}
+			else
+				ack->buf[ack->len++] = ',';
+
+			/* each acknowledgement requires a unique key, a
+			 * non-numeric one so replies aren't matched to a
+			 * transaction */
+			ack->len += (size_t)os_snprintf( &ack->buf[ack->len],
+				TR50_ACK_BYTES_MAX - ack->len, "\"a%u\":",
+				(unsigned int)ack->count );
+			os_memcpy( &ack->buf[ack->len], value, value_len );
+			ack->len += value_len;
+			++ack->count;
 
+			result = IOT_STATUS_SUCCESS;
+			if ( ack->count >= TR50_ACK_COUNT_MAX )
+				result = tr50_ack_flush( data );
+			queued = IOT_TRUE;
+		}
+		else
+			/* maintain ordering with pending acknowledgements */
+			tr50_ack_flush( data );
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &ack->mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+		if ( queued == IOT_FALSE )
+			result = tr50_mqtt_publish(
+				data, "api", msg, msg_len, NULL );
+	}
+	return result;
+}
+
+iot_status_t tr50_ack_status(
+	struct tr50_data *data,
+	const char *req_id,
+	iot_status_t status,
+	const char *error_msg )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( data && req_id )
+	{
+		struct tr50_encoder *const enc = tr50_encoder_acquire( data );
+		result = IOT_STATUS_NO_MEMORY;
+		if ( enc )
+		{
+			iot_json_encoder_t *const json = enc->json;
+			const char *msg;
+
+			iot_json_encode_object_start( json, "cmd" );
+			iot_json_encode_string( json, "command", "mailbox.ack" );
+			iot_json_encode_object_start( json, "params" );
+			iot_json_encode_string( json, "id", req_id );
+			iot_json_encode_integer( json, "errorCode", (int)status );
+			if ( error_msg )
+				iot_json_encode_string( json, "errorMessage",
+					error_msg );
+			iot_json_encode_object_end( json );
+			iot_json_encode_object_end( json );
+
+			result = IOT_STATUS_FAILURE;
+			msg = iot_json_encode_dump( json );
+			if ( msg )
+				result = tr50_ack_publish( data, msg,
+					os_strlen( msg ) );
+			tr50_encoder_release( data, enc );
+		}
+	}
+	return result;
+}
 
 iot_status_t tr50_action_complete(
 	struct tr50_data *data,
@@ -671,16 +1514,21 @@ iot_status_t tr50_action_complete(
 		if ( source && os_strncmp( source, "tr50", 4 ) == 0 )
 		{
 			const char *req_id;
+			iot_bool_t acked = IOT_FALSE;
 			result = iot_action_request_option_get(
 				request, "id", IOT_FALSE, IOT_TYPE_STRING, &req_id );
-			if ( data && result == IOT_STATUS_SUCCESS && req_id && *req_id )
+			/* already acknowledged when received */
+			iot_action_request_option_get( request, "acked",
+				IOT_FALSE, IOT_TYPE_BOOL, &acked );
+			if ( data && result == IOT_STATUS_SUCCESS && req_id &&
+				*req_id && acked == IOT_FALSE )
 			{
-				char buf[ 512u ];
-				iot_json_encoder_t *json;
-				json = iot_json_encode_initialize( buf, 512u, 0 );
+				struct tr50_encoder *const enc =
+					tr50_encoder_acquire( data );
 				result = IOT_STATUS_NO_MEMORY;
-				if ( json )
+				if ( enc )
 				{
+					iot_json_encoder_t *const json = enc->json;
 					char id[11u];
 					const char *msg = NULL;
 					iot_status_t status;
@@ -770,7 +1618,7 @@ iot_status_t tr50_action_complete(
 									IOT_FALSE,
 									&raw_len,
 									&raw );
-								tr50_append_value_raw( json, name,
+								tr50_append_value_raw( enc, name,
 									raw, raw_len );
 								break;
 							}
@@ -801,20 +1649,53 @@ iot_status_t tr50_action_complete(
 					iot_json_encode_object_end( json );
 
 					msg = iot_json_encode_dump( json );
-					result = tr50_mqtt_publish(
-						data,
-						"api",
-						msg,
-						os_strlen( msg ),
-						txn );
-					iot_json_encode_terminate( json );
+
+					/* kept to answer the message if delivered
+					 * again, unless it was refused for now */
+					if ( status == IOT_STATUS_FULL ||
+						status == IOT_STATUS_TRY_AGAIN )
+						tr50_dedup_forget( &data->dedup,
+							req_id );
+					else if ( msg )
+						tr50_dedup_complete( &data->dedup,
+							req_id, status, msg,
+							os_strlen( msg ) );
+					if ( msg && txn )
+						result = tr50_mqtt_publish(
+							data,
+							"api",
+							msg,
+							os_strlen( msg ),
+							txn );
+					else if ( msg )
+						result = tr50_ack_publish( data,
+							msg, os_strlen( msg ) );
+					tr50_encoder_release( data, enc );
 				}
 			}
+
+			/* nothing else in progress, no reason to wait */
+			if ( data->lib->request_queue_free_count <= 1u )
+				tr50_ack_check( data, IOT_TRUE );
 		}
 	}
 	return result;
 }
 
+iot_bool_t tr50_action_no_return(
+	const iot_t *lib,
+	const char *name )
+{
+	iot_bool_t result = IOT_FALSE;
+	if ( lib && name )
+	{
+		const iot_action_t *const action = iot_action_find( lib, name );
+		if ( action && ( action->flags & IOT_ACTION_NO_RETURN ) )
+			result = IOT_TRUE;
+	}
+	return result;
+}
+
 iot_status_t tr50_alarm_publish(
 	struct tr50_data *data,
 	const iot_alarm_t *alarm,
@@ -822,46 +1703,44 @@ iot_status_t tr50_alarm_publish(
 	const iot_transaction_t *txn,
 	const iot_options_t *options )
 {
-	iot_status_t result = IOT_STATUS_FAILURE;
-	char id[11u];
-	const char *out_msg;
-
-#ifdef IOT_STACK_ONLY
-	char buffer[1024u];
-	iot_json_encoder_t *const json =
-		iot_json_encode_initialize( buffer, 1024u, 0 );
-#else
-	iot_json_encoder_t *const json =
-		iot_json_encode_initialize( NULL, 0u, IOT_JSON_FLAG_DYNAMIC );
-#endif
+	iot_status_t result = IOT_STATUS_NO_MEMORY;
+	struct tr50_encoder *const enc = tr50_encoder_acquire( data );
+	if ( enc )
+	{
+		iot_json_encoder_t *const json = enc->json;
+		char id[11u];
+		const char *out_msg;
 
-	if ( txn )
-		os_snprintf( id, sizeof(id), "%u", (unsigned int)(*txn) );
-	else
-		os_snprintf( id, sizeof(id), "cmd" );
-	iot_json_encode_object_start( json, id );
-	iot_json_encode_string( json, "command", "alarm.publish" );
-	iot_json_encode_object_start( json, "params" );
-	iot_json_encode_string( json, "thingKey",
-		data->thing_key );
-	iot_json_encode_string( json, "key", alarm->name);
+		if ( txn )
+			os_snprintf( id, sizeof(id), "%u", (unsigned int)(*txn) );
+		else
+			os_snprintf( id, sizeof(id), "cmd" );
+		iot_json_encode_object_start( json, id );
+		iot_json_encode_string( json, "command", "alarm.publish" );
+		iot_json_encode_object_start( json, "params" );
+		iot_json_encode_string( json, "thingKey",
+			data->thing_key );
+		iot_json_encode_string( json, "key", alarm->name);
 
-	iot_json_encode_real( json, "state", payload->severity );
-	if( payload->message && *payload->message != '\0')
-		iot_json_encode_string( json, "msg", payload->message );
+		iot_json_encode_real( json, "state", payload->severity );
+		if( payload->message && *payload->message != '\0')
+			iot_json_encode_string( json, "msg", payload->message );
 
-	/* publish optional arguments */
-	tr50_optional( json, "ts", options, "time_stamp", IOT_TYPE_NULL );
-	tr50_optional( json, NULL, options, "location", IOT_TYPE_LOCATION );
-	tr50_optional( json, "republish", options, "republish", IOT_TYPE_BOOL );
+		/* publish optional arguments */
+		tr50_timestamp( data, enc, options, 0u );
+		tr50_optional( json, NULL, options, "location", IOT_TYPE_LOCATION );
+		tr50_optional( json, "republish", options, "republish", IOT_TYPE_BOOL );
 
-	iot_json_encode_object_end( json );
-	iot_json_encode_object_end( json );
+		iot_json_encode_object_end( json );
+		iot_json_encode_object_end( json );
 
-	out_msg = iot_json_encode_dump( json );
-	result = tr50_mqtt_publish(
-		data, "api", out_msg, os_strlen( out_msg ), txn );
-	iot_json_encode_terminate( json );
+		out_msg = iot_json_encode_dump( json );
+		result = IOT_STATUS_FAILURE;
+		if ( out_msg )
+			result = tr50_batch_publish(
+				data, out_msg, os_strlen( out_msg ), txn );
+		tr50_encoder_release( data, enc );
+	}
 	return result;
 }
 
@@ -913,32 +1792,27 @@ void tr50_append_location(
 }
 
 void tr50_append_value_raw(
-	iot_json_encoder_t *json,
+	struct tr50_encoder *enc,
 	const char *key,
 	const void *value,
 	size_t len )
 {
-	uint8_t *heap = NULL;
-
 	if ( !value )
 		value = "";
 	else if ( len != (size_t)-1 )
 	{
-		size_t req_len = iot_base64_encode_size( len );
-		heap = os_malloc( sizeof(uint8_t) * req_len + 1u );
-		if ( heap )
+		const size_t req_len = iot_base64_encode_size( len );
+		char *const scratch = tr50_encoder_scratch( enc, req_len + 1u );
+		if ( scratch )
 		{
-			iot_base64_encode( (char*)heap, req_len, value, len );
-			heap[req_len] = '\0';
-			value = heap;
+			iot_base64_encode( scratch, req_len, value, len );
+			scratch[req_len] = '\0';
+			value = scratch;
 		}
 	}
 
 	/* write raw or string data */
-	iot_json_encode_string( json, key, (const char *)value );
-
-	if ( heap )
-		os_free( heap );
+	iot_json_encode_string( enc->json, key, (const char *)value );
 }
 
 iot_status_t tr50_attribute_publish(
@@ -951,17 +1825,11 @@ iot_status_t tr50_attribute_publish(
 	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
 	if ( data && key && value )
 	{
-		iot_json_encoder_t *json;
-#ifdef IOT_STACK_ONLY
-		char buffer[1024u];
-		json = iot_json_encode_initialize( buffer, 1024u, 0 );
-#else
-		json = iot_json_encode_initialize(
-			NULL, 0u, IOT_JSON_FLAG_DYNAMIC );
-#endif
+		struct tr50_encoder *const enc = tr50_encoder_acquire( data );
 		result = IOT_STATUS_NO_MEMORY;
-		if ( json )
+		if ( enc )
 		{
+			iot_json_encoder_t *const json = enc->json;
 			char id[11u];
 			const char *msg;
 
@@ -980,8 +1848,7 @@ iot_status_t tr50_attribute_publish(
 			iot_json_encode_string( json, "value",
 				value );
 
-			tr50_optional( json, "ts", options, "time_stamp",
-				IOT_TYPE_NULL );
+			tr50_timestamp( data, enc, options, 0u );
 			tr50_optional( json, "republish", options, "republish",
 				IOT_TYPE_BOOL );
 
@@ -989,9 +1856,175 @@ iot_status_t tr50_attribute_publish(
 			iot_json_encode_object_end( json );
 
 			msg = iot_json_encode_dump( json );
+			result = IOT_STATUS_FAILURE;
+			if ( msg )
+				result = tr50_batch_publish(
+					data, msg, os_strlen( msg ), txn );
+			tr50_encoder_release( data, enc );
+		}
+	}
+	return result;
+}
+
+iot_status_t tr50_batch_flush(
+	struct tr50_data *data )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	struct tr50_batch *const batch = &data->batch;
+	if ( batch->count > 0u )
+	{
+		batch->buf[batch->len++] = '}';
+		batch->buf[batch->len] = '\0';
+		result = tr50_mqtt_publish( data, "api",
+			batch->buf, batch->len, NULL );
+		if ( result != IOT_STATUS_SUCCESS )
+		{
+			iot_uint32_t i;
+			for ( i = 0u; i < batch->count; ++i )
+			{
+				const iot_uint32_t start = batch->value_start[i];
+				if ( tr50_journal_command( data, &batch->buf[start],
+					batch->value_end[i] - start, batch->txn[i] )
+					== IOT_STATUS_SUCCESS )
+					result = IOT_STATUS_SUCCESS;
+				else if ( batch->txn[i] != 0u )
+					iot_transaction_status_set( data->lib,
+						batch->txn[i],
+						IOT_STATUS_EXECUTION_ERROR );
+			}
+		}
+		batch->count = 0u;
+		batch->len = 0u;
+	}
+	return result;
+}
+
+void tr50_batch_check(
+	struct tr50_data *data,
+	iot_bool_t force )
+{
+	if ( data )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &data->batch.mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		if ( data->batch.count > 0u && ( force != IOT_FALSE ||
+			iot_timestamp_now() - data->batch.time_first >=
+				data->batch.max_linger ) )
+			tr50_batch_flush( data );
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &data->batch.mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+}
+
+iot_status_t tr50_batch_publish(
+	struct tr50_data *data,
+	const char *msg,
+	size_t msg_len,
+	const iot_transaction_t *txn )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( data && msg && msg_len > 2u &&
+		msg[0] == '{' && msg[msg_len - 1u] == '}' )
+	{
+		struct tr50_batch *const batch = &data->batch;
+		/* command without the enclosing braces: "<txn>":{...} */
+		const char *const cmd = &msg[1];
+		const size_t cmd_len = msg_len - 2u;
+		/* command value, following the key */
+		const char *value = os_strchr( cmd, ':' );
+		size_t value_len = 0u;
+		/* length of the command once coalesced */
+		size_t entry_len = cmd_len;
+		iot_bool_t queued = IOT_FALSE;
+
+		if ( value )
+		{
+			++value;
+			value_len = (size_t)( &msg[msg_len - 1u] - value );
+			if ( !txn )
+				entry_len = TR50_BATCH_KEY_MAX + value_len;
+		}
+
+		/* store the command while the cloud can't be reached */
+		if ( value && tr50_online( data ) == IOT_FALSE &&
+			tr50_journal_command( data, value, value_len,
+				txn ? *txn : 0u ) == IOT_STATUS_SUCCESS )
+		{
+			result = IOT_STATUS_SUCCESS;
+			queued = IOT_TRUE;
+		}
+
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &batch->mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		/* each command in a message needs a unique key: its
+		 * transaction, or else its position in the message */
+		if ( queued == IOT_FALSE && value &&
+			batch->max_count > 1u &&
+			entry_len + 2u <= batch->max_bytes )
+		{
+			/* not enough room, send the pending commands first */
+			if ( batch->count > 0u &&
+				batch->len + entry_len + 2u > batch->max_bytes )
+				tr50_batch_flush( data );
+
+			if ( batch->count == 0u )
+			{
+				batch->buf[0] = '{';
+				batch->len = 1u;
+				batch->time_first = iot_timestamp_now();
+			}
+			else
+				batch->buf[batch->len++] = ',';
+			if ( txn )
+			{
+				os_memcpy( &batch->buf[batch->len], cmd, cmd_len );
+				batch->value_start[batch->count] = (iot_uint32_t)(
+					batch->len + (size_t)( value - cmd ) );
+				batch->len += cmd_len;
+				batch->txn[batch->count] = *txn;
+				iot_transaction_status_set( data->lib, *txn,
+					IOT_STATUS_INVOKED );
+			}
+			else
+			{
+				batch->len += (size_t)os_snprintf(
+					&batch->buf[batch->len],
+					TR50_BATCH_KEY_MAX + 1u, "\"%s%u\":",
+					TR50_BATCH_KEY_PREFIX,
+					(unsigned int)batch->count );
+				batch->value_start[batch->count] =
+					(iot_uint32_t)batch->len;
+				os_memcpy( &batch->buf[batch->len], value,
+					value_len );
+				batch->len += value_len;
+				batch->txn[batch->count] = 0u;
+			}
+			batch->value_end[batch->count++] =
+				(iot_uint32_t)batch->len;
+
+			result = IOT_STATUS_SUCCESS;
+			if ( batch->count >= batch->max_count )
+				result = tr50_batch_flush( data );
+			queued = IOT_TRUE;
+		}
+		else if ( queued == IOT_FALSE && batch->count > 0u )
+			/* maintain ordering with pending commands */
+			tr50_batch_flush( data );
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &batch->mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+		if ( queued == IOT_FALSE )
+		{
 			result = tr50_mqtt_publish(
-				data, "api", msg, os_strlen( msg ), txn );
-			iot_json_encode_terminate( json );
+				data, "api", msg, msg_len, txn );
+			if ( result != IOT_STATUS_SUCCESS && value &&
+				tr50_journal_command( data, value, value_len,
+					txn ? *txn : 0u ) == IOT_STATUS_SUCCESS )
+				result = IOT_STATUS_SUCCESS;
 		}
 	}
 	return result;
@@ -1002,33 +2035,39 @@ iot_status_t tr50_check_mailbox(
 	const iot_transaction_t *txn )
 {
 	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
-	iot_bool_t check_mailbox = IOT_TRUE;
-	if( data->lib->request_queue_free_count >= IOT_ACTION_QUEUE_MAX )
-		check_mailbox = IOT_FALSE;
+	iot_uint32_t limit = 0u;
+
+	/* request as many actions as there are free slots in the queue
+	 * (request_queue_free_count is the number of slots in use) */
+	if ( data && data->lib &&
+		data->lib->request_queue_free_count < IOT_ACTION_QUEUE_MAX )
+		limit = (iot_uint32_t)( IOT_ACTION_QUEUE_MAX -
+			data->lib->request_queue_free_count );
 
 	/* check for any outstanding messages on the cloud */
-	if ( check_mailbox != IOT_FALSE && data && data->lib )
+	if ( limit > 0u )
 	{
 		char id[11u];
-		const char *msg;
-		char req_buf[376u];
-		iot_json_encoder_t *req_json;
+		const char *msg = NULL;
+		struct tr50_encoder *const enc = tr50_encoder_acquire( data );
 
 		/* build the message: "{\"cmd\":{\"command\":\"mailbox.check\"}}" */
 		if ( txn )
 			os_snprintf( id, sizeof(id), "%u", (unsigned int)(*txn) );
 		else
 			os_snprintf( id, sizeof(id), "check" );
-		req_json = iot_json_encode_initialize(
-			req_buf, 376u, 0 );
-		iot_json_encode_object_start( req_json, id );
-		iot_json_encode_string( req_json, "command", "mailbox.check" );
-		iot_json_encode_object_start( req_json, "params" );
-		iot_json_encode_integer( req_json, "limit", TR50_MAILBOX_CHECK_LIMIT );
-		iot_json_encode_bool( req_json, "autoComplete", IOT_FALSE );
-		iot_json_encode_object_end( req_json );
-		iot_json_encode_object_end( req_json );
-		msg = iot_json_encode_dump( req_json );
+		if ( enc )
+		{
+			iot_json_encoder_t *const req_json = enc->json;
+			iot_json_encode_object_start( req_json, id );
+			iot_json_encode_string( req_json, "command", "mailbox.check" );
+			iot_json_encode_object_start( req_json, "params" );
+			iot_json_encode_integer( req_json, "limit", limit );
+			iot_json_encode_bool( req_json, "autoComplete", IOT_FALSE );
+			iot_json_encode_object_end( req_json );
+			iot_json_encode_object_end( req_json );
+			msg = iot_json_encode_dump( req_json );
+		}
 		result = IOT_STATUS_FAILURE;
 		if ( msg )
 		{
@@ -1044,6 +2083,7 @@ iot_status_t tr50_check_mailbox(
 				/* worst case scenario (publish failed)
 				 * we wait out the timer */
 				data->time_last_mailbox_check = iot_timestamp_now();
+				data->mailbox_limit = limit;
 #ifdef IOT_THREAD_SUPPORT
 				os_thread_mutex_unlock( &data->mail_check_mutex );
 #endif /* IOT_THREAD_SUPPORT */
@@ -1058,11 +2098,61 @@ iot_status_t tr50_check_mailbox(
 		else
 			IOT_LOG( data->lib, IOT_LOG_ERROR, "%s",
 				"Error failed to obtain device requests" );
-		iot_json_encode_terminate( req_json );
+		tr50_encoder_release( data, enc );
 	}
 	return result;
 }
 
+#ifndef IOT_STACK_ONLY
+iot_bool_t tr50_compress(
+	struct tr50_compress *z,
+	const void **payload,
+	size_t *payload_len )
+{
+	iot_bool_t result = IOT_FALSE;
+	if ( z->ready == IOT_FALSE )
+	{
+		os_memzero( &z->stream, sizeof( z_stream ) );
+		if ( deflateInit( &z->stream, z->level ) == Z_OK )
+			z->ready = IOT_TRUE;
+	}
+	else
+		deflateReset( &z->stream );
+
+	if ( z->ready != IOT_FALSE )
+	{
+		const size_t bound = (size_t)deflateBound( &z->stream,
+			(uLong)*payload_len );
+		if ( bound > z->buf_len )
+		{
+			iot_uint8_t *const buf = os_realloc( z->buf, bound );
+			if ( buf )
+			{
+				z->buf = buf;
+				z->buf_len = bound;
+			}
+		}
+
+		if ( bound <= z->buf_len )
+		{
+			z->stream.next_in = (const Bytef *)*payload;
+			z->stream.avail_in = (uInt)*payload_len;
+			z->stream.next_out = z->buf;
+			z->stream.avail_out = (uInt)z->buf_len;
+			/* only send compressed if it is smaller */
+			if ( deflate( &z->stream, Z_FINISH ) == Z_STREAM_END &&
+				(size_t)z->stream.total_out < *payload_len )
+			{
+				*payload = z->buf;
+				*payload_len = (size_t)z->stream.total_out;
+				result = IOT_TRUE;
+			}
+		}
+	}
+	return result;
+}
+#endif /* ifndef IOT_STACK_ONLY */
+
 iot_status_t tr50_connect(
 	iot_t *lib,
 	struct tr50_data *data,
@@ -1103,6 +2193,84 @@ iot_status_t tr50_connect(
 		iot_config_get( lib, "validate_cloud_cert", IOT_FALSE,
 			IOT_TYPE_BOOL, &validate_cert );
 
+		tr50_journal_start( lib, data );
+		tr50_dedup_start( lib, data );
+
+		/* outbound command coalescing */
+		if ( data->batch.max_bytes == 0u )
+		{
+			iot_int64_t batch_count = TR50_BATCH_COUNT_DEFAULT;
+			iot_int64_t batch_linger = TR50_BATCH_LINGER_DEFAULT;
+			iot_int64_t batch_size = TR50_BATCH_BYTES_DEFAULT;
+
+			iot_config_get( lib, "cloud.batch.count", IOT_FALSE,
+				IOT_TYPE_INT64, &batch_count );
+			iot_config_get( lib, "cloud.batch.linger", IOT_FALSE,
+				IOT_TYPE_INT64, &batch_linger );
+			iot_config_get( lib, "cloud.batch.size", IOT_FALSE,
+				IOT_TYPE_INT64, &batch_size );
+			if ( batch_count < 1 )
+				batch_count = 1;
+			if ( batch_count > TR50_BATCH_COUNT_MAX )
+				batch_count = TR50_BATCH_COUNT_MAX;
+			if ( batch_linger < 0 )
+				batch_linger = 0;
+#ifdef IOT_STACK_ONLY
+			if ( batch_size > TR50_BATCH_BYTES_MAX )
+				batch_size = TR50_BATCH_BYTES_MAX;
+#endif /* ifdef IOT_STACK_ONLY */
+			if ( batch_size < 2 )
+				batch_count = 1;
+
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_lock( &data->batch.mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+			data->batch.max_count = (iot_uint32_t)batch_count;
+			data->batch.max_linger = (iot_millisecond_t)batch_linger;
+			if ( batch_count > 1 )
+			{
+#ifndef IOT_STACK_ONLY
+				data->batch.buf =
+					os_malloc( (size_t)batch_size + 1u );
+				if ( data->batch.buf )
+#endif /* ifndef IOT_STACK_ONLY */
+					data->batch.max_bytes = (size_t)batch_size;
+			}
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_unlock( &data->batch.mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		}
+
+#ifndef IOT_STACK_ONLY
+		/* compression of large outbound messages */
+		{
+			iot_int64_t compress_level = Z_DEFAULT_COMPRESSION;
+			iot_int64_t compress_threshold =
+				TR50_COMPRESS_THRESHOLD_DEFAULT;
+
+			iot_config_get( lib, "cloud.compress.threshold", IOT_FALSE,
+				IOT_TYPE_INT64, &compress_threshold );
+			iot_config_get( lib, "cloud.compress.level", IOT_FALSE,
+				IOT_TYPE_INT64, &compress_level );
+			if ( compress_threshold < 0 )
+				compress_threshold = 0;
+			if ( compress_level < Z_BEST_SPEED ||
+				compress_level > Z_BEST_COMPRESSION )
+				compress_level = Z_DEFAULT_COMPRESSION;
+
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_lock( &data->compress.mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+			/* level is fixed once the stream is set up */
+			if ( data->compress.ready == IOT_FALSE )
+				data->compress.level = (int)compress_level;
+			data->compress.threshold = (size_t)compress_threshold;
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_unlock( &data->compress.mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		}
+#endif /* ifndef IOT_STACK_ONLY */
+
 		os_memzero( &ssl_conf, sizeof( iot_mqtt_ssl_t ) );
 		ssl_conf.ca_path = ca_bundle;
 		ssl_conf.insecure = !validate_cert;
@@ -1138,6 +2306,10 @@ iot_status_t tr50_connect(
 		os_snprintf( data->thing_key, TR50_THING_KEY_MAX_LEN,
 			"%s-%s", lib->device_id, iot_id( lib ) );
 		data->thing_key[ TR50_THING_KEY_MAX_LEN ] = '\0';
+		data->thing_key_json_len = iot_json_string_escape(
+			data->thing_key_json, data->thing_key,
+			os_strlen( data->thing_key ),
+			sizeof( data->thing_key_json ) );
 
 		con_opts.client_id = iot_id( lib );
 		con_opts.host = host;
@@ -1239,6 +2411,49 @@ iot_status_t tr50_connect_check(
 	return result;
 }
 
+void tr50_dedup_start(
+	iot_t *lib,
+	struct tr50_data *data )
+{
+	if ( data->dedup.size == 0u )
+	{
+		char path[PATH_MAX + 1u];
+		iot_int64_t size = TR50_DEDUP_SIZE_DEFAULT;
+		iot_bool_t persist = IOT_FALSE;
+		const char *file = NULL;
+		iot_status_t result;
+
+		iot_config_get( lib, "dedup.size", IOT_FALSE,
+			IOT_TYPE_INT64, &size );
+		iot_config_get( lib, "dedup.persist", IOT_FALSE,
+			IOT_TYPE_BOOL, &persist );
+		if ( size < 0 )
+			size = 0;
+		if ( size > TR50_DEDUP_SIZE_MAX )
+			size = TR50_DEDUP_SIZE_MAX;
+
+		if ( persist != IOT_FALSE && size > 0 )
+		{
+			const size_t path_len = iot_directory_name_get(
+				IOT_DIR_RUNTIME, path, PATH_MAX );
+			if ( path_len < PATH_MAX )
+			{
+				os_snprintf( &path[path_len], PATH_MAX - path_len,
+					"%c%s.dedup", OS_DIR_SEP, iot_id( lib ) );
+				path[PATH_MAX] = '\0';
+				file = path;
+			}
+		}
+
+		result = tr50_dedup_open( &data->dedup,
+			(iot_uint32_t)size, file );
+		if ( result != IOT_STATUS_SUCCESS )
+			IOT_LOG( lib, IOT_LOG_ERROR,
+				"tr50: failed to open duplicate cache; reason: %s",
+				iot_error( result ) );
+	}
+}
+
 iot_status_t tr50_disconnect(
 	iot_t *lib,
 	struct tr50_data *data )
@@ -1248,6 +2463,8 @@ iot_status_t tr50_disconnect(
 	if ( data )
 	{
 		data->reconnect_count = 0u; /* don't reconnect */
+		tr50_batch_check( data, IOT_TRUE );
+		tr50_ack_check( data, IOT_TRUE );
 		result = iot_mqtt_disconnect( data->mqtt );
 	}
 	return result;
@@ -1280,6 +2497,125 @@ iot_status_t tr50_enable(
 	return IOT_STATUS_SUCCESS;
 }
 
+struct tr50_encoder *tr50_encoder_acquire(
+	struct tr50_data *data )
+{
+	struct tr50_encoder *enc = NULL;
+	if ( data )
+	{
+		iot_uint32_t i;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &data->encoder_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		for ( i = 0u; !enc && i < TR50_ENCODER_POOL_MAX; ++i )
+		{
+			if ( data->encoder[i].in_use == IOT_FALSE )
+			{
+				enc = &data->encoder[i];
+				enc->in_use = IOT_TRUE;
+			}
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &data->encoder_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+#ifndef IOT_STACK_ONLY
+		/* all pooled encoders are busy */
+		if ( !enc )
+		{
+			enc = os_malloc( sizeof( struct tr50_encoder ) );
+			if ( enc )
+			{
+				os_memzero( enc, sizeof( struct tr50_encoder ) );
+				enc->in_use = IOT_TRUE;
+				enc->temporary = IOT_TRUE;
+			}
+		}
+#endif /* ifndef IOT_STACK_ONLY */
+
+		if ( enc )
+		{
+			/* reuse the memory from the previous message */
+			if ( enc->json )
+				iot_json_encode_reset( enc->json );
+			else
+#ifdef IOT_STACK_ONLY
+				enc->json = iot_json_encode_initialize(
+					enc->buf, sizeof( enc->buf ), 0u );
+#else
+				enc->json = iot_json_encode_initialize(
+					NULL, 0u, IOT_JSON_FLAG_DYNAMIC );
+#endif /* ifdef IOT_STACK_ONLY */
+
+			if ( !enc->json )
+			{
+				tr50_encoder_release( data, enc );
+				enc = NULL;
+			}
+		}
+	}
+	return enc;
+}
+
+void tr50_encoder_release(
+	struct tr50_data *data,
+	struct tr50_encoder *enc )
+{
+	if ( data && enc )
+	{
+#ifndef IOT_STACK_ONLY
+		if ( enc->temporary != IOT_FALSE )
+		{
+			if ( enc->json )
+				iot_json_encode_terminate( enc->json );
+			if ( enc->scratch )
+				os_free( enc->scratch );
+			os_free( enc );
+		}
+		else
+		{
+#endif /* ifndef IOT_STACK_ONLY */
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_lock( &data->encoder_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+			enc->in_use = IOT_FALSE;
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_unlock( &data->encoder_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+#ifndef IOT_STACK_ONLY
+		}
+#endif /* ifndef IOT_STACK_ONLY */
+	}
+}
+
+char *tr50_encoder_scratch(
+	struct tr50_encoder *enc,
+	size_t len )
+{
+	char *result = NULL;
+#ifdef IOT_STACK_ONLY
+	if ( len <= sizeof( enc->scratch ) )
+		result = enc->scratch;
+#else /* ifdef IOT_STACK_ONLY */
+	if ( len > enc->scratch_len )
+	{
+		size_t new_len = enc->scratch_len * 2u;
+		char *new_scratch;
+		if ( new_len < len )
+			new_len = len;
+		new_scratch = os_realloc( enc->scratch, new_len );
+		if ( new_scratch )
+		{
+			enc->scratch = new_scratch;
+			enc->scratch_len = new_len;
+		}
+	}
+	if ( len <= enc->scratch_len )
+		result = enc->scratch;
+#endif /* else ifdef IOT_STACK_ONLY */
+	return result;
+}
+
 iot_status_t tr50_event_publish(
 	struct tr50_data *data,
 	const char *message,
@@ -1289,17 +2625,11 @@ iot_status_t tr50_event_publish(
 	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
 	if ( data && message )
 	{
-		iot_json_encoder_t *json;
-#ifdef IOT_STACK_ONLY
-		char buffer[1024u];
-		json = iot_json_encode_initialize( buffer, 1024u, 0 );
-#else
-		json = iot_json_encode_initialize(
-			NULL, 0u, IOT_JSON_FLAG_DYNAMIC );
-#endif
+		struct tr50_encoder *const enc = tr50_encoder_acquire( data );
 		result = IOT_STATUS_NO_MEMORY;
-		if ( json )
+		if ( enc )
 		{
+			iot_json_encoder_t *const json = enc->json;
 			char id[11u];
 			iot_int64_t level;
 			const char *msg;
@@ -1317,8 +2647,7 @@ iot_status_t tr50_event_publish(
 				message );
 
 			/* publish optional arguments */
-			tr50_optional( json, "ts", options, "time_stamp",
-				IOT_TYPE_NULL );
+			tr50_timestamp( data, enc, options, 0u );
 			tr50_optional( json, "global", options, "global",
 				IOT_TYPE_BOOL );
 
@@ -1338,9 +2667,11 @@ iot_status_t tr50_event_publish(
 			iot_json_encode_object_end( json );
 
 			msg = iot_json_encode_dump( json );
-			result = tr50_mqtt_publish(
-				data, "api", msg, os_strlen( msg ), txn );
-			iot_json_encode_terminate( json );
+			result = IOT_STATUS_FAILURE;
+			if ( msg )
+				result = tr50_batch_publish(
+					data, msg, os_strlen( msg ), txn );
+			tr50_encoder_release( data, enc );
 		}
 	}
 	return result;
@@ -1364,10 +2695,6 @@ iot_status_t tr50_execute(
 			"execute", (int)op, (int)*step );
 	else
 		tr50_connect_check( lib, data, txn, max_time_out );
-
-	if ( txn )
-		tr50_transaction_status_set( data, (iot_uint8_t)(*txn),
-			TR50_TRANSACTION_INVOKED );
 	if ( *step == IOT_STEP_DURING )
 	{
 #ifdef __clang__
@@ -1389,15 +2716,30 @@ iot_status_t tr50_execute(
 					(const iot_file_transfer_t*)item,
 					txn, options );
 				break;
+			case IOT_OPERATION_TELEMETRY_DEREGISTER:
+				if ( item )
+					result = tr50_telemetry_deregister( data,
+						(const iot_telemetry_t*)item );
+				break;
 			case IOT_OPERATION_TELEMETRY_PUBLISH:
 				result = tr50_telemetry_publish( data,
 					(const iot_telemetry_t*)item,
 					(const struct iot_data*)value,
 					txn, options );
 				break;
+			case IOT_OPERATION_TELEMETRY_REGISTER:
+				result = tr50_telemetry_register( data,
+					(const iot_telemetry_t*)item );
+				break;
 			case IOT_OPERATION_ITERATION:
 				if ( data )
 					iot_mqtt_loop( data->mqtt, max_time_out );
+				tr50_batch_check( data, IOT_FALSE );
+				tr50_ack_check( data, IOT_FALSE );
+				tr50_journal_replay( data );
+				if ( data )
+					tr50_journal_sync( &data->journal,
+						IOT_FALSE );
 				tr50_ping( lib, data, txn, max_time_out );
 				tr50_file_queue_check( data );
 				break;
@@ -1426,11 +2768,6 @@ iot_status_t tr50_execute(
 				result = tr50_event_publish( data,
 					(const char *)value, txn, options );
 				break;
-			case IOT_OPERATION_TRANSACTION_STATUS:
-				result = tr50_transaction_status( data,
-					(const iot_transaction_t*)item,
-					options );
-				break;
 			default:
 				/* unhandled operations */
 				break;
@@ -1455,12 +2792,12 @@ iot_status_t tr50_file_request_send(
 		result = IOT_STATUS_FULL;
 		if ( data->file_transfer_count < TR50_FILE_TRANSFER_MAX )
 		{
-			char buf[ 512u ];
 			const char *msg;
 			struct tr50_file_transfer transfer;
-
-			iot_json_encoder_t *json =
-				iot_json_encode_initialize( buf, sizeof( buf ), 0u);
+			struct tr50_encoder *const enc = tr50_encoder_acquire( data );
+			iot_json_encoder_t *json = NULL;
+			if ( enc )
+				json = enc->json;
 
 			os_memzero( &transfer, sizeof( struct tr50_file_transfer ) );
 			os_strncpy( transfer.name, file_transfer->name, PATH_MAX );
@@ -1475,13 +2812,13 @@ iot_status_t tr50_file_request_send(
 			result = IOT_STATUS_FAILURE;
 			if ( json )
 			{
-				char id[11u];
+				char id[15u];
 				char global_name[PATH_MAX];
 
 				/* create json string request for file.get/file.put */
-				os_snprintf( id, sizeof(id), "%u",
-					(data->file_transfer_count +
-					TR50_FILE_REQUEST_ID_OFFSET) );
+				os_snprintf( id, sizeof(id), "%s%u",
+					TR50_FILE_REQUEST_ID_PREFIX,
+					(unsigned int)data->file_transfer_count );
 
 				iot_json_encode_object_start( json, id );
 				iot_json_encode_string( json, "command",
@@ -1519,9 +2856,11 @@ iot_status_t tr50_file_request_send(
 				msg = iot_json_encode_dump( json );
 
 				/* publish */
-				result = iot_mqtt_publish( data->mqtt, "api",
-					msg, os_strlen( msg ), TR50_MQTT_QOS,
-					IOT_FALSE, NULL );
+				result = IOT_STATUS_FAILURE;
+				if ( msg )
+					result = iot_mqtt_publish( data->mqtt, "api",
+						msg, os_strlen( msg ), TR50_MQTT_QOS,
+						IOT_FALSE, NULL );
 				if ( result == IOT_STATUS_SUCCESS )
 				{
 					/* add it to the queue */
@@ -1536,7 +2875,7 @@ iot_status_t tr50_file_request_send(
 					IOT_LOG( data->lib, IOT_LOG_ERROR, "%s",
 						"Failed send file request" );
 
-				iot_json_encode_terminate( json );
+				tr50_encoder_release( data, enc );
 			}
 			else
 				IOT_LOG( data->lib, IOT_LOG_ERROR, "%s",
@@ -2011,14 +3350,169 @@ iot_status_t tr50_initialize(
 	{
 		os_memzero( data, sizeof( struct tr50_data ) );
 		data->lib = lib;
+		data->journal.fd = OS_FILE_INVALID;
+		data->dedup.fd = OS_FILE_INVALID;
 		*plugin_data = data;
 #ifdef IOT_THREAD_SUPPORT
 		os_thread_mutex_create( &data->mail_check_mutex ) ;
+		os_thread_mutex_create( &data->ack.mutex );
+		os_thread_mutex_create( &data->batch.mutex );
+		os_thread_mutex_create( &data->encoder_mutex );
+		os_thread_mutex_create( &data->telemetry_mutex );
+#ifndef IOT_STACK_ONLY
+		os_thread_mutex_create( &data->compress.mutex );
+#endif /* ifndef IOT_STACK_ONLY */
 #endif /* IOT_THREAD_SUPPORT */
+#ifndef IOT_STACK_ONLY
+		data->compress.level = Z_DEFAULT_COMPRESSION;
+#endif /* ifndef IOT_STACK_ONLY */
 		curl_global_init( CURL_GLOBAL_ALL );
 		result = iot_mqtt_initialize();
 	}
-	return result;
+	return result;
+}
+
+iot_status_t tr50_journal_command(
+	struct tr50_data *data,
+	const char *value,
+	size_t len,
+	iot_transaction_t txn_id )
+{
+	iot_status_t result = IOT_STATUS_NOT_INITIALIZED;
+	if ( data->journal.fd != OS_FILE_INVALID )
+	{
+		result = tr50_journal_append( &data->journal, value, len );
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			/* no reply is matched to a command sent from the journal */
+			if ( txn_id != 0u )
+				iot_transaction_status_set( data->lib, txn_id,
+					IOT_STATUS_INVOKED );
+			IOT_LOG( data->lib, IOT_LOG_DEBUG,
+				"tr50: journaled (%u bytes): %.*s",
+				(unsigned int)len, (int)len, value );
+		}
+		else
+			IOT_LOG( data->lib, IOT_LOG_WARNING,
+				"tr50: failed to journal command; reason: %s",
+				iot_error( result ) );
+	}
+	return result;
+}
+
+void tr50_journal_replay(
+	struct tr50_data *data )
+{
+	if ( data && data->journal_replay_rate > 0u &&
+		tr50_journal_count( &data->journal ) > 0u &&
+		tr50_online( data ) != IOT_FALSE )
+	{
+		const size_t key_len = sizeof( TR50_JOURNAL_KEY ) - 1u;
+		const iot_timestamp_t now = iot_timestamp_now();
+		iot_uint64_t budget = ( now - data->journal_replay_time ) *
+			data->journal_replay_rate / IOT_MILLISECONDS_IN_SECOND;
+
+		/* allow at most one second worth of records at once */
+		if ( budget > data->journal_replay_rate )
+			budget = data->journal_replay_rate;
+		if ( budget > 0u )
+			data->journal_replay_time = now;
+
+		os_memcpy( data->journal_buf, TR50_JOURNAL_KEY, key_len );
+		while ( budget > 0u )
+		{
+			size_t len = 0u;
+			iot_status_t result = tr50_journal_peek( &data->journal,
+				&data->journal_buf[key_len],
+				TR50_JOURNAL_RECORD_MAX, &len );
+			--budget;
+			if ( result == IOT_STATUS_SUCCESS )
+			{
+				data->journal_buf[key_len + len] = '}';
+				result = tr50_mqtt_publish( data, "api",
+					data->journal_buf, key_len + len + 1u,
+					NULL );
+				if ( result == IOT_STATUS_SUCCESS )
+					tr50_journal_pop( &data->journal );
+				else
+					budget = 0u; /* try again later */
+			}
+			else if ( result == IOT_STATUS_NO_MEMORY ||
+				result == IOT_STATUS_PARSE_ERROR )
+			{
+				IOT_LOG( data->lib, IOT_LOG_WARNING,
+					"tr50: discarding journal record; reason: %s",
+					iot_error( result ) );
+				tr50_journal_pop( &data->journal );
+			}
+			else
+				budget = 0u;
+		}
+	}
+}
+
+void tr50_journal_start(
+	iot_t *lib,
+	struct tr50_data *data )
+{
+	iot_bool_t enabled = IOT_FALSE;
+	iot_config_get( lib, "journal.enabled", IOT_FALSE,
+		IOT_TYPE_BOOL, &enabled );
+	if ( enabled != IOT_FALSE && data->journal.fd == OS_FILE_INVALID )
+	{
+		char path[PATH_MAX + 1u];
+		size_t path_len;
+		const char *drop_str = NULL;
+		const char *sync_str = NULL;
+		enum tr50_journal_drop drop = TR50_JOURNAL_DROP_OLDEST;
+		enum tr50_journal_sync sync = TR50_JOURNAL_SYNC_BATCH;
+		iot_int64_t rate = TR50_JOURNAL_REPLAY_RATE_DEFAULT;
+		iot_int64_t size = TR50_JOURNAL_SIZE_DEFAULT;
+		iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+
+		iot_config_get( lib, "journal.size", IOT_FALSE,
+			IOT_TYPE_INT64, &size );
+		iot_config_get( lib, "journal.replay_rate", IOT_FALSE,
+			IOT_TYPE_INT64, &rate );
+		iot_config_get( lib, "journal.sync", IOT_FALSE,
+			IOT_TYPE_STRING, &sync_str );
+		iot_config_get( lib, "journal.drop", IOT_FALSE,
+			IOT_TYPE_STRING, &drop_str );
+
+		if ( sync_str && os_strcasecmp( sync_str, "record" ) == 0 )
+			sync = TR50_JOURNAL_SYNC_RECORD;
+		else if ( sync_str && os_strcasecmp( sync_str, "none" ) == 0 )
+			sync = TR50_JOURNAL_SYNC_NONE;
+		if ( drop_str && os_strcasecmp( drop_str, "newest" ) == 0 )
+			drop = TR50_JOURNAL_DROP_NEWEST;
+		if ( size < TR50_JOURNAL_SIZE_MIN )
+			size = TR50_JOURNAL_SIZE_MIN;
+		if ( size > 0x7FFFFFFF )
+			size = 0x7FFFFFFF;
+		if ( rate < 0 )
+			rate = 0;
+		data->journal_replay_rate = (iot_uint32_t)rate;
+
+		path_len = iot_directory_name_get( IOT_DIR_RUNTIME,
+			path, PATH_MAX );
+		if ( path_len < PATH_MAX )
+		{
+			os_snprintf( &path[path_len], PATH_MAX - path_len,
+				"%c%s.journal", OS_DIR_SEP, iot_id( lib ) );
+			path[PATH_MAX] = '\0';
+			result = tr50_journal_open( &data->journal, path,
+				(iot_uint32_t)size, sync, drop );
+		}
+
+		if ( result == IOT_STATUS_SUCCESS )
+			IOT_LOG( lib, IOT_LOG_INFO,
+				"tr50: journal %s contains %u records", path,
+				(unsigned int)tr50_journal_count( &data->journal ) );
+		else
+			IOT_LOG( lib, IOT_LOG_ERROR,
+				"tr50: failed to open journal; reason: %s",
+				iot_error( result ) );
+	}
 }
 
 iot_status_t tr50_mqtt_publish(
@@ -2031,15 +3525,46 @@ iot_status_t tr50_mqtt_publish(
 	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
 	if ( data && topic && payload )
 	{
+#ifndef IOT_STACK_ONLY
+		struct tr50_compress *const z = &data->compress;
+		iot_bool_t compressed = IOT_FALSE;
+#endif /* ifndef IOT_STACK_ONLY */
 		IOT_LOG( data->lib, IOT_LOG_DEBUG,
 			"tr50: sent (%u bytes on %s): %.*s",
 				(unsigned int)payload_len, topic,
 				(int)payload_len, (const char*)payload );
+#ifndef IOT_STACK_ONLY
+		if ( z->threshold > 0u && payload_len >= z->threshold )
+		{
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_lock( &z->mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+			compressed = tr50_compress( z, &payload, &payload_len );
+			if ( compressed != IOT_FALSE )
+				IOT_LOG( data->lib, IOT_LOG_TRACE,
+					"tr50: compressed to %u bytes",
+					(unsigned int)payload_len );
+#ifdef IOT_THREAD_SUPPORT
+			else
+				os_thread_mutex_unlock( &z->mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		}
+#endif /* ifndef IOT_STACK_ONLY */
 		result = iot_mqtt_publish( data->mqtt, topic,
 			payload, payload_len, TR50_MQTT_QOS, IOT_FALSE, NULL );
-		if ( result != IOT_STATUS_SUCCESS && txn )
-			tr50_transaction_status_set( data, (iot_uint8_t)(*txn),
-				TR50_TRANSACTION_FAILURE );
+#if !defined( IOT_STACK_ONLY ) && defined( IOT_THREAD_SUPPORT )
+		/* compressed message buffer is in use until published */
+		if ( compressed != IOT_FALSE )
+			os_thread_mutex_unlock( &z->mutex );
+#endif /* if !defined( IOT_STACK_ONLY ) && defined( IOT_THREAD_SUPPORT ) */
+
+		/* the reply to the command completes the transaction */
+		if ( result == IOT_STATUS_SUCCESS && txn )
+			iot_transaction_status_set( data->lib, *txn,
+				IOT_STATUS_INVOKED );
+		else if ( txn )
+			iot_transaction_status_set( data->lib, *txn,
+				IOT_STATUS_EXECUTION_ERROR );
 	}
 	return result;
 }
@@ -2102,19 +3627,28 @@ void tr50_on_message(
 		{
 			const iot_json_object_iterator_t *root_iter =
 				iot_json_decode_object_iterator( json, root );
-			if ( root_iter )
+
+			/* a reply may contain a result for multiple commands */
+			while ( root_iter )
 			{
 				char name[ IOT_NAME_MAX_LEN + 1u ];
 				const char *v = NULL;
 				size_t v_len = 0u;
 				const iot_json_item_t *j_obj = NULL;
-				int msg_id = 0;
+				iot_transaction_t txn_id = 0u;
+				int file_id = -1;
 
 				iot_json_decode_object_iterator_key(
 					json, root, root_iter,
 					&v, &v_len );
 				os_snprintf( name, IOT_NAME_MAX_LEN, "%.*s", (int)v_len, v );
-				msg_id = os_atoi( name );
+				if ( os_strncmp( name, TR50_FILE_REQUEST_ID_PREFIX,
+					sizeof( TR50_FILE_REQUEST_ID_PREFIX ) - 1u ) == 0 )
+					file_id = os_atoi( &name[
+						sizeof( TR50_FILE_REQUEST_ID_PREFIX ) - 1u] );
+				else
+					txn_id = (iot_transaction_t)os_strtoul(
+						name, NULL );
 				iot_json_decode_object_iterator_value(
 					json, root, root_iter, &j_obj );
 
@@ -2127,35 +3661,30 @@ void tr50_on_message(
 					--data->ping_miss_count;
 				else if ( j_obj )
 				{
-					const iot_json_item_t *j_success;
-					iot_bool_t is_success;
-
-					j_success = iot_json_decode_object_find( json,
-						j_obj, "success" );
-					if ( j_success )
+					struct tr50_reply reply;
+
+					/* the items used from the reply, in one pass */
+					os_memzero( &reply, sizeof( struct tr50_reply ) );
+					if ( iot_json_decode_bind( json, j_obj,
+						TR50_REPLY, sizeof( TR50_REPLY ) /
+							sizeof( TR50_REPLY[0] ),
+						&reply ) == IOT_STATUS_SUCCESS )
 					{
-						enum tr50_transaction_status s = TR50_TRANSACTION_FAILURE;
-						iot_json_decode_bool( json, j_success, &is_success );
+						iot_status_t s = IOT_STATUS_EXECUTION_ERROR;
+						const iot_json_item_t *const j_messages =
+							reply.messages;
 
 						/* update transaction status */
-						if ( msg_id > 0 && msg_id < 256 )
+						if ( txn_id > 0u )
 						{
-							if ( is_success )
-								s = TR50_TRANSACTION_SUCCESS;
-							tr50_transaction_status_set(
-								data, (iot_uint8_t)msg_id, s );
+							if ( reply.success )
+								s = IOT_STATUS_SUCCESS;
+							iot_transaction_status_set(
+								data->lib, txn_id, s );
 						}
 
-						if ( is_success )
+						if ( reply.success )
 						{
-							const iot_json_item_t *j_params;
-							const iot_json_item_t *j_messages;
-							j_params = iot_json_decode_object_find(
-								json, j_obj, "params" );
-
-							j_messages = iot_json_decode_object_find( json,
-								j_params, "messages" );
-
 							/* actions (aka methods) parsing */
 							if ( j_messages && iot_json_decode_type( json, j_messages )
 								== IOT_JSON_TYPE_ARRAY )
@@ -2167,77 +3696,89 @@ void tr50_on_message(
 								for ( i = 0u; i < msg_count; ++i )
 								{
 									const iot_json_item_t *j_cmd_item;
+									struct tr50_mailbox_message msg;
+									os_memzero( &msg, sizeof( struct tr50_mailbox_message ) );
 									if ( iot_json_decode_array_at( json,
 										j_messages, i, &j_cmd_item ) == IOT_STATUS_SUCCESS )
 									{
-										const iot_json_item_t *j_id;
-										j_id = iot_json_decode_object_find(
-											json, j_cmd_item, "id" );
-										if ( !j_id )
+										const char *const id = msg.id;
+
+										/* the items used from the message, in
+										 * one pass (missing ones are empty) */
+										iot_json_decode_bind( json,
+											j_cmd_item, TR50_MAILBOX_MESSAGE,
+											sizeof( TR50_MAILBOX_MESSAGE ) /
+												sizeof( TR50_MAILBOX_MESSAGE[0] ),
+											&msg );
+										if ( *id == '\0' )
 											IOT_LOG( data->lib, IOT_LOG_WARNING,
 												"\"%s\" not found!", "id" );
-
-										j_params = iot_json_decode_object_find(
-											json, j_cmd_item, "params" );
-										if ( !j_params )
+										if ( !msg.params )
 											IOT_LOG( data->lib, IOT_LOG_WARNING,
 												"\"%s\" not found!", "params" );
 
-										if ( j_id && j_params )
+										if ( *id != '\0' && msg.params )
 										{
-											const iot_json_item_t *j_method;
+											const iot_json_item_t *j_params;
 											const iot_json_object_iterator_t *iter;
 											iot_action_request_t *req = NULL;
 
-											j_method = iot_json_decode_object_find(
-												json, j_params, "method" );
-											if ( j_method )
+											if ( *msg.method != '\0' )
 											{
-												char id[ IOT_ID_MAX_LEN + 1u ];
-												*id = '\0';
-
-												iot_json_decode_string( json, j_id, &v, &v_len );
-												os_snprintf( id, IOT_ID_MAX_LEN, "%.*s", (int)v_len, v );
-												id[ IOT_ID_MAX_LEN ] = '\0';
-
-												iot_json_decode_string( json, j_method, &v, &v_len );
-												os_snprintf( name, IOT_NAME_MAX_LEN, "%.*s", (int)v_len, v );
-												name[ IOT_NAME_MAX_LEN ] = '\0';
-												req = iot_action_request_allocate( data->lib, name, "tr50" );
+												char ack[ TR50_DEDUP_ACK_MAX ];
+												size_t ack_len = 0u;
+												iot_status_t dup;
+												iot_status_t ack_status = IOT_STATUS_SUCCESS;
+
+												/* redelivered after its acknowledgement
+												 * was lost, answer it again instead */
+												dup = tr50_dedup_begin( &data->dedup, id,
+													&ack_status, ack, sizeof( ack ),
+													&ack_len );
+												if ( dup == IOT_STATUS_EXISTS )
+												{
+													IOT_LOG( data->lib, IOT_LOG_INFO,
+														"tr50: duplicate message %s (%s), "
+														"sending previous result", id, msg.method );
+													if ( ack_len == 0u ||
+														tr50_ack_publish( data, ack,
+															ack_len ) != IOT_STATUS_SUCCESS )
+														tr50_ack_status( data, id,
+															ack_status, NULL );
+												}
+												else if ( dup == IOT_STATUS_INVOKED )
+													IOT_LOG( data->lib, IOT_LOG_INFO,
+														"tr50: duplicate message %s (%s), "
+														"still executing", id, msg.method );
+												else
+													req = iot_action_request_allocate(
+														data->lib, msg.method, "tr50" );
 
-												/* check mailbox for more actions if queue is available */
-												tr50_check_mailbox( data, NULL );
 												if ( req )
+												{
 													iot_action_request_option_set( req, "id", IOT_TYPE_STRING, id );
-												else
+
+													/* no result to report, complete it now */
+													if ( tr50_action_no_return( data->lib, msg.method ) &&
+														tr50_ack_status( data, id, IOT_STATUS_SUCCESS,
+															NULL ) == IOT_STATUS_SUCCESS )
+													{
+														iot_action_request_option_set( req, "acked", IOT_TYPE_BOOL, IOT_TRUE );
+														tr50_dedup_complete( &data->dedup, id,
+															IOT_STATUS_SUCCESS, NULL, 0u );
+													}
+												}
+												else if ( dup == IOT_STATUS_SUCCESS )
 												{
 													/* send response that message can't be handled */
-													const char *out_msg;
-													char out_msg_id[6u];
-													char out_msg_buf[ 512u ];
-													iot_json_encoder_t *out_json;
-													out_json = iot_json_encode_initialize( out_msg_buf, 512u, 0 );
-													os_snprintf( out_msg_id, sizeof(out_msg_id), "cmd" );
-													iot_json_encode_object_start( out_json, out_msg_id );
-													iot_json_encode_string( out_json, "command", "mailbox.ack" );
-													iot_json_encode_object_start( out_json, "params" );
-													iot_json_encode_string( out_json, "id", id );
-													iot_json_encode_integer( out_json, "errorCode", (int)IOT_STATUS_FULL );
-													iot_json_encode_string( out_json, "errorMessage", "maximum inbound requests reached" );
-													iot_json_encode_object_end( out_json );
-													iot_json_encode_object_end( out_json );
-
-													out_msg = iot_json_encode_dump( out_json );
-													tr50_mqtt_publish(
-														data, "api", out_msg,
-														os_strlen( out_msg ), NULL );
-													iot_json_encode_terminate( out_json );
+													tr50_dedup_forget( &data->dedup, id );
+													tr50_ack_status( data, id, IOT_STATUS_FULL,
+														"maximum inbound requests reached" );
 												}
 											}
 
 											/* for each parameter */
-											j_params = iot_json_decode_object_find(
-												json, j_params, "params" );
+											j_params = msg.parameters;
 											iter = iot_json_decode_object_iterator(
 												json, j_params );
 											while ( iter )
@@ -2279,9 +3820,20 @@ void tr50_on_message(
 													break;
 												case IOT_JSON_TYPE_STRING:
 													{
-													char *value;
+													char *value = NULL;
+													iot_bool_t in_arena = IOT_FALSE;
 													iot_json_decode_string( json, j_value, &v, &v_len );
-													value = os_malloc( v_len + 1u );
+
+													/* unescape directly into the
+													 * request, it is then used
+													 * without another copy */
+													if ( req )
+														value = iot_action_request_arena_alloc(
+															req, v_len + 1u );
+													if ( value )
+														in_arena = IOT_TRUE;
+													else
+														value = os_malloc( v_len + 1u );
 													if( value )
 													{
 														size_t j;
@@ -2294,7 +3846,8 @@ void tr50_on_message(
 														}
 														*p = '\0';
 														iot_action_request_parameter_set( req, name, IOT_TYPE_STRING, value );
-														os_free( value );
+														if ( in_arena == IOT_FALSE )
+															os_free( value );
 													}
 													}
 												case IOT_JSON_TYPE_ARRAY:
@@ -2310,39 +3863,33 @@ void tr50_on_message(
 										}
 									}
 								}
+								tr50_ack_check( data, IOT_TRUE );
+
+								/* mailbox may hold more actions, check
+								 * again if the queue has room for them */
+								if ( msg_count > 0u &&
+									msg_count >= data->mailbox_limit )
+								{
+									data->time_last_mailbox_check = 0;
+									tr50_check_mailbox( data, NULL );
+								}
 							}
 							else
 							{
-								j_obj = iot_json_decode_object_find( json,
-									j_params, "fileId" );
+								j_obj = reply.file_id;
 								if ( j_obj && iot_json_decode_type( json, j_obj )
 									== IOT_JSON_TYPE_STRING )
 								{
 									/* file transfer request parsing */
 									iot_bool_t found_transfer = IOT_FALSE;
 									struct tr50_file_transfer *transfer = NULL;
-									iot_int64_t crc32 = 0u;
-									iot_int64_t fileSize = 0u;
 
 									/* obtain the fileId */
 									iot_json_decode_string( json, j_obj, &v, &v_len );
 
-									j_obj = iot_json_decode_object_find( json,
-										j_params, "crc32" );
-									if ( j_obj && iot_json_decode_type( json, j_obj )
-										== IOT_JSON_TYPE_INTEGER )
-										iot_json_decode_integer( json, j_obj, &crc32 );
-
-									j_obj = iot_json_decode_object_find( json,
-										j_params, "fileSize" );
-									if ( j_obj && iot_json_decode_type( json, j_obj )
-										== IOT_JSON_TYPE_INTEGER )
-										iot_json_decode_integer( json, j_obj, &fileSize );
-
-									if ( msg_id > 0 && (unsigned int)msg_id >= TR50_FILE_REQUEST_ID_OFFSET &&
-										(unsigned int)msg_id - TR50_FILE_REQUEST_ID_OFFSET < TR50_FILE_TRANSFER_MAX )
+									if ( file_id >= 0 && (unsigned int)file_id < TR50_FILE_TRANSFER_MAX )
 									{
-										transfer = &data->file_transfer_queue[(unsigned int)msg_id - TR50_FILE_REQUEST_ID_OFFSET];
+										transfer = &data->file_transfer_queue[(unsigned int)file_id];
 										if ( transfer->path[0] )
 										{
 											/* determine host name from config file */
@@ -2352,8 +3899,8 @@ void tr50_on_message(
 												IOT_TYPE_STRING, &host );
 											os_snprintf( transfer->url, PATH_MAX,
 												"https://%s/file/%.*s", host, (int)v_len, v );
-											transfer->crc32 = (iot_uint64_t)crc32;
-											transfer->size = (iot_uint64_t)fileSize;
+											transfer->crc32 = (iot_uint64_t)reply.crc32;
+											transfer->size = (iot_uint64_t)reply.file_size;
 											transfer->retry_time = 0u;
 											transfer->expiry_time =
 												iot_timestamp_now() +
@@ -2378,7 +3925,7 @@ void tr50_on_message(
 										if ( os_thread_create( &thread, tr50_file_transfer, transfer, stack_size ) )
 											IOT_LOG( data->lib, IOT_LOG_ERROR,
 												"Failed to create a thread to transfer "
-												"file for message #%u", (unsigned int)msg_id );
+												"file for message %s", name );
 #endif /* if defined( IOT_THREAD_SUPPORT ) */
 									}
 								}
@@ -2386,6 +3933,8 @@ void tr50_on_message(
 						}
 					}
 				}
+				root_iter = iot_json_decode_object_iterator_next(
+					json, root, root_iter );
 			}
 		}
 		else
@@ -2398,6 +3947,20 @@ void tr50_on_message(
 			"failed to parse incoming message" );
 }
 
+iot_bool_t tr50_online(
+	const struct tr50_data *data )
+{
+	iot_bool_t connected = IOT_FALSE;
+	if ( data && data->mqtt )
+	{
+		iot_timestamp_t time_stamp_changed = 0u;
+		if ( iot_mqtt_connection_status( data->mqtt, &connected,
+			&time_stamp_changed ) != IOT_STATUS_SUCCESS )
+			connected = IOT_FALSE;
+	}
+	return connected;
+}
+
 void tr50_optional(
 	iot_json_encoder_t *json,
 	const char *json_key,
@@ -2495,11 +4058,12 @@ void tr50_optional(
 			if ( iot_options_get_integer( options, options_key,
 				IOT_FALSE, &data.value.int64 ) == IOT_STATUS_SUCCESS )
 			{
-				char ts_str[32u];
-				tr50_strtime(
+				char ts_str[ TR50_TIME_LEN ];
+				if ( tr50_strtime( NULL,
 					(iot_timestamp_t)data.value.int64,
-					ts_str, 25u );
-				iot_json_encode_string( json, json_key, ts_str );
+					ts_str, sizeof( ts_str ) ) > 0u )
+					iot_json_encode_string( json, json_key,
+						ts_str );
 			}
 			break;
 		}
@@ -2529,21 +4093,25 @@ void tr50_ping(
 			else
 			{
 				/* encode ping message */
-				const char *out_msg;
-				char out_msg_id[6u];
-				char out_msg_buf[ 512u ];
-				iot_json_encoder_t *out_json;
-				out_json = iot_json_encode_initialize( out_msg_buf, 512u, 0 );
-				os_snprintf( out_msg_id, sizeof(out_msg_id), "ping" );
-				iot_json_encode_object_start( out_json, out_msg_id );
-				iot_json_encode_string( out_json, "command", "diag.ping" );
-				iot_json_encode_object_end( out_json );
-
-				out_msg = iot_json_encode_dump( out_json );
-				tr50_mqtt_publish(
-					data, "api", out_msg,
-					os_strlen( out_msg ), NULL );
-				iot_json_encode_terminate( out_json );
+				struct tr50_encoder *const out_enc =
+					tr50_encoder_acquire( data );
+				if ( out_enc )
+				{
+					const char *out_msg;
+					char out_msg_id[6u];
+					iot_json_encoder_t *const out_json = out_enc->json;
+					os_snprintf( out_msg_id, sizeof(out_msg_id), "ping" );
+					iot_json_encode_object_start( out_json, out_msg_id );
+					iot_json_encode_string( out_json, "command", "diag.ping" );
+					iot_json_encode_object_end( out_json );
+
+					out_msg = iot_json_encode_dump( out_json );
+					if ( out_msg )
+						tr50_mqtt_publish(
+							data, "api", out_msg,
+							os_strlen( out_msg ), NULL );
+					tr50_encoder_release( data, out_enc );
+				}
 
 				/* update receive time, so another ping isn't sent */
 				data->time_last_msg_received = now;
@@ -2553,26 +4121,49 @@ void tr50_ping(
 	}
 }
 
-char *tr50_strtime( iot_timestamp_t ts,
-	char *out, size_t len )
+size_t tr50_strtime(
+	struct tr50_time_cache *cache,
+	iot_timestamp_t ts,
+	char *out,
+	size_t len )
 {
-	size_t out_len;
+	size_t out_len = 0u;
+	const iot_timestamp_t second = ts / IOT_MILLISECONDS_IN_SECOND;
+
+	/* TR50 format: "YYYY-MM-DDTHH:MM:SS.mmmZ" */
+	if ( cache && cache->len > 0u && cache->second == second &&
+		cache->len < len )
+	{
+		/* same second as the previous time stamp */
+		os_memcpy( out, cache->text, cache->len );
+		out_len = cache->len;
+	}
+	else if ( out && len )
+	{
+		out_len = os_time_format( out, len,
+			"%Y-%m-%dT%H:%M:%S", ts, OS_FALSE );
+		if ( cache && out_len > 0u && out_len < sizeof( cache->text ) )
+		{
+			os_memcpy( cache->text, out, out_len );
+			cache->len = out_len;
+			cache->second = second;
+		}
+	}
 
-	/* TR50 format: "YYYY-MM-DDTHH:MM:SS.mmZ" */
-	out_len = os_time_format( out, len,
-		"%Y-%m-%dT%H:%M:%S", ts, OS_FALSE );
 	if ( out_len > 0u )
 	{
 		/* add milliseconds, if there are any remaining */
-		ts %= 1000u;
-		if ( ts > 0u )
+		const unsigned int ms =
+			(unsigned int)( ts % IOT_MILLISECONDS_IN_SECOND );
+		if ( ms > 0u )
 		{
-			size_t out_req;
-			out_req = (size_t)os_snprintf( &out[out_len],
-				len - out_len, ".%03u", (unsigned int)ts );
-
-			if ( out_req < len - out_len )
-				out_len += out_req;
+			if ( out_len + 4u < len )
+			{
+				out[out_len++] = '.';
+				out[out_len++] = (char)( '0' + ms / 100u );
+				out[out_len++] = (char)( '0' + ( ms / 10u ) % 10u );
+				out[out_len++] = (char)( '0' + ms % 10u );
+			}
 			else
 				out_len = 0u;
 		}
@@ -2587,7 +4178,92 @@ char *tr50_strtime( iot_timestamp_t ts,
 	/* ensure null-terminated */
 	if ( out && len )
 		out[out_len] = '\0';
-	return out;
+	return out_len;
+}
+
+iot_status_t tr50_telemetry_deregister(
+	struct tr50_data *data,
+	const iot_telemetry_t *t )
+{
+	iot_uint32_t i;
+#ifdef IOT_THREAD_SUPPORT
+	os_thread_mutex_lock( &data->telemetry_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	for ( i = 0u; i < data->telemetry_count; ++i )
+	{
+		if ( data->telemetry[i].telemetry == t )
+		{
+			/* move the last template into the free slot */
+			--data->telemetry_count;
+			if ( i < data->telemetry_count )
+				os_memcpy( &data->telemetry[i],
+					&data->telemetry[data->telemetry_count],
+					sizeof( struct tr50_telemetry_template ) );
+			break;
+		}
+	}
+#ifdef IOT_THREAD_SUPPORT
+	os_thread_mutex_unlock( &data->telemetry_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	return IOT_STATUS_SUCCESS;
+}
+
+const char *tr50_telemetry_message(
+	struct tr50_data *data,
+	struct tr50_encoder *enc,
+	const iot_telemetry_t *t,
+	const struct iot_data *d,
+	const iot_transaction_t *txn,
+	const iot_options_t *options,
+	size_t *msg_len )
+{
+	char *result = NULL;
+	iot_uint32_t i;
+#ifdef IOT_THREAD_SUPPORT
+	os_thread_mutex_lock( &data->telemetry_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	i = 0u;
+	while ( i < data->telemetry_count && data->telemetry[i].telemetry != t )
+		++i;
+
+	/* thing key is only known once connected */
+	if ( i < data->telemetry_count && data->telemetry[i].type == d->type &&
+		data->thing_key_json_len > 0u )
+	{
+		const struct tr50_telemetry_template *const tpl =
+			&data->telemetry[i];
+		const size_t max_len = TR50_TELEMETRY_FRAME_MAX +
+			data->thing_key_json_len + tpl->key_len +
+			IOT_JSON_NUMBER_MAX_LEN;
+		char *const buf = tr50_encoder_scratch( enc, max_len );
+		if ( buf )
+		{
+			size_t len = tr50_telemetry_head( buf, txn,
+				data->thing_key_json, data->thing_key_json_len,
+				tpl->key, tpl->key_len );
+			const size_t value_len =
+				tpl->write_value( &buf[len], t, d );
+			if ( value_len > 0u )
+			{
+				const iot_timestamp_t ts = tr50_timestamp_get(
+					data, options, t->time_stamp );
+				char ts_str[ TR50_TIME_LEN ];
+				size_t ts_len = 0u;
+				if ( ts > 0u )
+					ts_len = tr50_strtime( &enc->time, ts,
+						ts_str, sizeof( ts_str ) );
+				len += value_len;
+				len += tr50_telemetry_tail( &buf[len],
+					ts_str, ts_len );
+				*msg_len = len;
+				result = buf;
+			}
+		}
+	}
+#ifdef IOT_THREAD_SUPPORT
+	os_thread_mutex_unlock( &data->telemetry_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	return result;
 }
 
 iot_status_t tr50_telemetry_publish(
@@ -2595,117 +4271,272 @@ iot_status_t tr50_telemetry_publish(
 	const iot_telemetry_t *t,
 	const struct iot_data *d,
 	const iot_transaction_t *txn,
-	const iot_options_t *UNUSED(options) )
+	const iot_options_t *options )
 {
 	iot_status_t result = IOT_STATUS_FAILURE;
+	struct tr50_encoder *enc = NULL;
 	if ( d->has_value )
+		enc = tr50_encoder_acquire( data );
+	if ( enc )
 	{
-		const char *cmd;
-		char id[11u];
-		const char *msg;
-		const char *const value_key = "value";
-		iot_json_encoder_t *const json =
-			iot_json_encode_initialize( NULL, 0u, 0u);
-
-		if ( d->type == IOT_TYPE_LOCATION )
-			cmd = "location.publish";
-		else if ( d->type == IOT_TYPE_STRING ||
-			d->type == IOT_TYPE_RAW )
-			cmd = "attribute.publish";
-		else
-			cmd = "property.publish";
-
-		/* convert id to string */
-		if ( txn )
-			os_snprintf( id, sizeof(id), "%u", (unsigned int)(*txn) );
-		else
-			os_snprintf( id, sizeof(id), "cmd" );
-		iot_json_encode_object_start( json, id );
-		iot_json_encode_string( json, "command", cmd );
-		iot_json_encode_object_start( json, "params" );
-		iot_json_encode_string( json, "thingKey",
-			data->thing_key );
-		iot_json_encode_string( json, "key",
-			iot_telemetry_name_get( t ) );
-		switch ( d->type )
+		size_t msg_len = 0u;
+		const char *msg = tr50_telemetry_message( data, enc, t, d, txn,
+			options, &msg_len );
+		if ( !msg )
 		{
-		case IOT_TYPE_BOOL:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.boolean );
-			break;
-		case IOT_TYPE_FLOAT32:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.float32 );
-			break;
-		case IOT_TYPE_FLOAT64:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.float64 );
-			break;
-		case IOT_TYPE_INT8:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.int8 );
-			break;
-		case IOT_TYPE_INT16:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.int16 );
-			break;
-		case IOT_TYPE_INT32:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.int32 );
-			break;
-		case IOT_TYPE_INT64:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.int64 );
-			break;
-		case IOT_TYPE_UINT8:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.uint8 );
-			break;
-		case IOT_TYPE_UINT16:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.uint16 );
-			break;
-		case IOT_TYPE_UINT32:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.uint32 );
-			break;
-		case IOT_TYPE_UINT64:
-			iot_json_encode_real( json, value_key,
-				(double)d->value.uint64 );
-			break;
-		case IOT_TYPE_RAW:
-			tr50_append_value_raw( json, value_key,
-				d->value.raw.ptr, d->value.raw.length );
-			break;
-		case IOT_TYPE_STRING:
-			tr50_append_value_raw( json, value_key,
-				d->value.string, (size_t)-1 );
-			break;
-		case IOT_TYPE_LOCATION:
-			tr50_append_location( json, NULL, d->value.location );
-			break;
-		case IOT_TYPE_NULL:
-		default:
-			break;
+			msg = tr50_telemetry_encode( data, enc, t, d, txn, options );
+			if ( msg )
+				msg_len = os_strlen( msg );
 		}
+		if ( msg )
+			result = tr50_batch_publish(
+				data, msg, msg_len, txn );
+		tr50_encoder_release( data, enc );
 
-		if ( t->time_stamp > 0u )
+		/* sample is the mean of an aggregation window */
+		if ( result == IOT_STATUS_SUCCESS &&
+			t->reduce.window > 0u && t->reduce.count > 0u )
 		{
-			char ts_str[32u];
-			tr50_strtime( t->time_stamp, ts_str, 25u );
-			iot_json_encode_string( json, "ts", ts_str );
+			tr50_telemetry_publish_stat( data, t, "min",
+				t->reduce.min, options );
+			tr50_telemetry_publish_stat( data, t, "max",
+				t->reduce.max, options );
+			tr50_telemetry_publish_stat( data, t, "count",
+				(iot_float64_t)t->reduce.count, options );
+			tr50_telemetry_publish_stat( data, t, "last",
+				t->reduce.last, options );
 		}
+	}
+	return result;
+}
+
+const char *tr50_telemetry_encode(
+	const struct tr50_data *data,
+	struct tr50_encoder *enc,
+	const iot_telemetry_t *t,
+	const struct iot_data *d,
+	const iot_transaction_t *txn,
+	const iot_options_t *options )
+{
+	const char *cmd;
+	char id[11u];
+	const char *const value_key = "value";
+	iot_json_encoder_t *const json = enc->json;
+
+	if ( d->type == IOT_TYPE_LOCATION )
+		cmd = "location.publish";
+	else if ( d->type == IOT_TYPE_STRING ||
+		d->type == IOT_TYPE_RAW )
+		cmd = "attribute.publish";
+	else
+		cmd = "property.publish";
+
+	/* convert id to string */
+	if ( txn )
+		os_snprintf( id, sizeof(id), "%u", (unsigned int)(*txn) );
+	else
+		os_snprintf( id, sizeof(id), "cmd" );
+	iot_json_encode_object_start( json, id );
+	iot_json_encode_string( json, "command", cmd );
+	iot_json_encode_object_start( json, "params" );
+	iot_json_encode_string( json, "thingKey",
+		data->thing_key );
+	iot_json_encode_string( json, "key",
+		iot_telemetry_name_get( t ) );
+	switch ( d->type )
+	{
+	case IOT_TYPE_BOOL:
+		iot_json_encode_integer( json, value_key,
+			d->value.boolean != IOT_FALSE ? 1 : 0 );
+		break;
+	case IOT_TYPE_FLOAT32:
+		iot_json_encode_real_precision( json, value_key,
+			(double)d->value.float32, t->has_precision ?
+			(int)t->precision :
+			IOT_JSON_PRECISION_SHORTEST_FLOAT );
+		break;
+	case IOT_TYPE_FLOAT64:
+		iot_json_encode_real_precision( json, value_key,
+			d->value.float64, t->has_precision ?
+			(int)t->precision : IOT_JSON_PRECISION_SHORTEST );
+		break;
+	case IOT_TYPE_INT8:
+		iot_json_encode_integer( json, value_key,
+			d->value.int8 );
+		break;
+	case IOT_TYPE_INT16:
+		iot_json_encode_integer( json, value_key,
+			d->value.int16 );
+		break;
+	case IOT_TYPE_INT32:
+		iot_json_encode_integer( json, value_key,
+			d->value.int32 );
+		break;
+	case IOT_TYPE_INT64:
+		iot_json_encode_integer( json, value_key,
+			d->value.int64 );
+		break;
+	case IOT_TYPE_UINT8:
+		iot_json_encode_unsigned( json, value_key,
+			d->value.uint8 );
+		break;
+	case IOT_TYPE_UINT16:
+		iot_json_encode_unsigned( json, value_key,
+			d->value.uint16 );
+		break;
+	case IOT_TYPE_UINT32:
+		iot_json_encode_unsigned( json, value_key,
+			d->value.uint32 );
+		break;
+	case IOT_TYPE_UINT64:
+		iot_json_encode_unsigned( json, value_key,
+			d->value.uint64 );
+		break;
+	case IOT_TYPE_RAW:
+		tr50_append_value_raw( enc, value_key,
+			d->value.raw.ptr, d->value.raw.length );
+		break;
+	case IOT_TYPE_STRING:
+		tr50_append_value_raw( enc, value_key,
+			d->value.string, (size_t)-1 );
+		break;
+	case IOT_TYPE_LOCATION:
+		tr50_append_location( json, NULL, d->value.location );
+		break;
+	case IOT_TYPE_NULL:
+	default:
+		break;
+	}
+
+	tr50_timestamp( data, enc, options, t->time_stamp );
+	iot_json_encode_object_end( json );
+	iot_json_encode_object_end( json );
+	return iot_json_encode_dump( json );
+}
+
+iot_status_t tr50_telemetry_publish_stat(
+	struct tr50_data *data,
+	const iot_telemetry_t *t,
+	const char *stat,
+	iot_float64_t value,
+	const iot_options_t *options )
+{
+	iot_status_t result = IOT_STATUS_NO_MEMORY;
+	struct tr50_encoder *const enc = tr50_encoder_acquire( data );
+	if ( enc )
+	{
+		iot_json_encoder_t *const json = enc->json;
+		char key[ IOT_NAME_MAX_LEN * 2u + 1u ];
+		char id[11u];
+		const char *msg;
+		/* tracked like any other command, so it can be journaled */
+		const iot_transaction_t txn =
+			iot_transaction_allocate( data->lib );
+
+		os_snprintf( key, sizeof( key ), "%s.%s",
+			iot_telemetry_name_get( t ), stat );
+		key[ sizeof( key ) - 1u ] = '\0';
+		os_snprintf( id, sizeof( id ), "%u", (unsigned int)txn );
+		iot_json_encode_object_start( json, id );
+		iot_json_encode_string( json, "command", "property.publish" );
+		iot_json_encode_object_start( json, "params" );
+		iot_json_encode_string( json, "thingKey", data->thing_key );
+		iot_json_encode_string( json, "key", key );
+		iot_json_encode_real_precision( json, "value", (double)value,
+			t->has_precision ? (int)t->precision :
+			IOT_JSON_PRECISION_SHORTEST );
+		tr50_timestamp( data, enc, options, t->time_stamp );
 		iot_json_encode_object_end( json );
 		iot_json_encode_object_end( json );
 
 		msg = iot_json_encode_dump( json );
-		result = tr50_mqtt_publish(
-			data, "api", msg, os_strlen( msg ), txn );
-		iot_json_encode_terminate( json );
+		result = IOT_STATUS_FAILURE;
+		if ( msg )
+			result = tr50_batch_publish(
+				data, msg, os_strlen( msg ), &txn );
+		tr50_encoder_release( data, enc );
+		iot_transaction_finish( data->lib, txn, result );
 	}
 	return result;
 }
 
+iot_status_t tr50_telemetry_register(
+	struct tr50_data *data,
+	const iot_telemetry_t *t )
+{
+	tr50_value_writer_t *write_value;
+	switch ( t->type )
+	{
+	case IOT_TYPE_BOOL:
+		write_value = tr50_value_bool;
+		break;
+	case IOT_TYPE_FLOAT32:
+		write_value = tr50_value_float32;
+		break;
+	case IOT_TYPE_FLOAT64:
+		write_value = tr50_value_float64;
+		break;
+	case IOT_TYPE_INT8:
+		write_value = tr50_value_int8;
+		break;
+	case IOT_TYPE_INT16:
+		write_value = tr50_value_int16;
+		break;
+	case IOT_TYPE_INT32:
+		write_value = tr50_value_int32;
+		break;
+	case IOT_TYPE_INT64:
+		write_value = tr50_value_int64;
+		break;
+	case IOT_TYPE_UINT8:
+		write_value = tr50_value_uint8;
+		break;
+	case IOT_TYPE_UINT16:
+		write_value = tr50_value_uint16;
+		break;
+	case IOT_TYPE_UINT32:
+		write_value = tr50_value_uint32;
+		break;
+	case IOT_TYPE_UINT64:
+		write_value = tr50_value_uint64;
+		break;
+	case IOT_TYPE_LOCATION:
+	case IOT_TYPE_NULL:
+	case IOT_TYPE_RAW:
+	case IOT_TYPE_STRING:
+	default:
+		write_value = NULL;
+	}
+
+	tr50_telemetry_deregister( data, t );
+	if ( write_value )
+	{
+		const char *const name = iot_telemetry_name_get( t );
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &data->telemetry_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		/* other telemetry is encoded in full for each sample */
+		if ( data->telemetry_count < TR50_TELEMETRY_TEMPLATE_MAX )
+		{
+			struct tr50_telemetry_template *const tpl =
+				&data->telemetry[data->telemetry_count];
+			tpl->key_len = tr50_telemetry_key( tpl->key, name,
+				os_strlen( name ) );
+			if ( tpl->key_len > 0u )
+			{
+				tpl->telemetry = t;
+				tpl->type = t->type;
+				tpl->write_value = write_value;
+				++data->telemetry_count;
+			}
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &data->telemetry_mutex );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+	return IOT_STATUS_SUCCESS;
+}
+
 iot_status_t tr50_terminate(
 	iot_t *lib,
 	void *plugin_data )
@@ -2715,9 +4546,33 @@ iot_status_t tr50_terminate(
 	IOT_LOG( lib, IOT_LOG_TRACE, "tr50: %s", "terminate" );
 #ifdef IOT_THREAD_SUPPORT
 	os_thread_mutex_destroy( &data->mail_check_mutex );
+	os_thread_mutex_destroy( &data->ack.mutex );
+	os_thread_mutex_destroy( &data->batch.mutex );
+	os_thread_mutex_destroy( &data->encoder_mutex );
+	os_thread_mutex_destroy( &data->telemetry_mutex );
+#ifndef IOT_STACK_ONLY
+	os_thread_mutex_destroy( &data->compress.mutex );
+#endif /* ifndef IOT_STACK_ONLY */
 #endif /* IOT_THREAD_SUPPORT */
 	if ( data )
 	{
+		iot_uint32_t i;
+		tr50_journal_close( &data->journal );
+		tr50_dedup_close( &data->dedup );
+		for ( i = 0u; i < TR50_ENCODER_POOL_MAX; ++i )
+		{
+			if ( data->encoder[i].json )
+				iot_json_encode_terminate( data->encoder[i].json );
+#ifndef IOT_STACK_ONLY
+			os_free_null( (void **)&data->encoder[i].scratch );
+#endif /* ifndef IOT_STACK_ONLY */
+		}
+#ifndef IOT_STACK_ONLY
+		os_free_null( (void **)&data->batch.buf );
+		if ( data->compress.ready != IOT_FALSE )
+			deflateEnd( &data->compress.stream );
+		os_free_null( (void **)&data->compress.buf );
+#endif /* ifndef IOT_STACK_ONLY */
 		os_free( data );
 		data = NULL;
 	}
@@ -2726,69 +4581,142 @@ iot_status_t tr50_terminate(
 	return result;
 }
 
-iot_status_t tr50_transaction_status(
+void tr50_timestamp(
 	const struct tr50_data *data,
-	const iot_transaction_t *txn,
-	const iot_options_t *UNUSED(options) )
+	struct tr50_encoder *enc,
+	const iot_options_t *options,
+	iot_timestamp_t ts )
 {
-	/* size of a "chunk" in bits */
-	const unsigned int chunk_size_bits = sizeof(unsigned int)*8u;
-	/* number of bits required to data for each item */
-	const unsigned int data_bits = 2u;
-	/* number of data blocks in a "chunk" */
-	const unsigned int data_blks = chunk_size_bits/data_bits;
-	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
-
-	if ( data && txn )
+	ts = tr50_timestamp_get( data, options, ts );
+	if ( ts > 0u )
 	{
-		const iot_uint8_t txn_id = (iot_uint8_t)(*txn);
-		const unsigned int b = (txn_id / data_blks);
-		enum tr50_transaction_status tx_status;
+		char ts_str[ TR50_TIME_LEN ];
+		if ( tr50_strtime( &enc->time, ts, ts_str,
+			sizeof( ts_str ) ) > 0u )
+			iot_json_encode_string( enc->json, "ts", ts_str );
+	}
+}
 
-		/* obtain the bits within a chunk that hold the desired data */
-		tx_status = (data->transactions[b] >> (((txn_id%data_blks)*data_bits)) & ((1u<<data_bits)-1u));
+iot_timestamp_t tr50_timestamp_get(
+	const struct tr50_data *data,
+	const iot_options_t *options,
+	iot_timestamp_t ts )
+{
+	iot_int64_t option_ts;
+	if ( iot_options_get_integer( options, "time_stamp",
+		IOT_FALSE, &option_ts ) == IOT_STATUS_SUCCESS )
+		ts = (iot_timestamp_t)option_ts;
+	else if ( ts == 0u && data->journal.fd != OS_FILE_INVALID )
+		ts = iot_timestamp_now();
+	return ts;
+}
 
-		/* convert tr50 transaction status to result */
-		switch (tx_status)
-		{
-		case TR50_TRANSACTION_SUCCESS:
-			result = IOT_STATUS_SUCCESS;
-			break;
-		case TR50_TRANSACTION_INVOKED:
-			result = IOT_STATUS_INVOKED;
-			break;
-		case TR50_TRANSACTION_FAILURE:
-			result = IOT_STATUS_EXECUTION_ERROR;
-			break;
-		case TR50_TRANSACTION_UNKNOWN:
-		default:
-			result = IOT_STATUS_NOT_FOUND;
-		}
-	}
+size_t tr50_value_bool(
+	char *buf,
+	const iot_telemetry_t *UNUSED(t),
+	const struct iot_data *d )
+{
+	buf[0] = d->value.boolean != IOT_FALSE ? '1' : '0';
+	return 1u;
+}
+
+size_t tr50_value_float32(
+	char *buf,
+	const iot_telemetry_t *t,
+	const struct iot_data *d )
+{
+	return iot_json_number_real( buf, (iot_float64_t)d->value.float32,
+		t->has_precision ? (int)t->precision :
+		IOT_JSON_PRECISION_SHORTEST_FLOAT );
+}
+
+size_t tr50_value_float64(
+	char *buf,
+	const iot_telemetry_t *t,
+	const struct iot_data *d )
+{
+	return iot_json_number_real( buf, d->value.float64,
+		t->has_precision ? (int)t->precision :
+		IOT_JSON_PRECISION_SHORTEST );
+}
+
+size_t tr50_value_int8(
+	char *buf,
+	const iot_telemetry_t *UNUSED(t),
+	const struct iot_data *d )
+{
+	return tr50_value_signed( buf, d->value.int8 );
+}
+
+size_t tr50_value_int16(
+	char *buf,
+	const iot_telemetry_t *UNUSED(t),
+	const struct iot_data *d )
+{
+	return tr50_value_signed( buf, d->value.int16 );
+}
+
+size_t tr50_value_int32(
+	char *buf,
+	const iot_telemetry_t *UNUSED(t),
+	const struct iot_data *d )
+{
+	return tr50_value_signed( buf, d->value.int32 );
+}
+
+size_t tr50_value_int64(
+	char *buf,
+	const iot_telemetry_t *UNUSED(t),
+	const struct iot_data *d )
+{
+	return tr50_value_signed( buf, d->value.int64 );
+}
+
+size_t tr50_value_signed(
+	char *buf,
+	iot_int64_t value )
+{
+	size_t result;
+	/* negate without overflowing on the minimum value */
+	if ( value < 0 )
+		result = iot_json_number_integer( buf,
+			(iot_uint64_t)( -( value + 1 ) ) + 1u, IOT_TRUE );
+	else
+		result = iot_json_number_integer( buf,
+			(iot_uint64_t)value, IOT_FALSE );
 	return result;
 }
 
-void tr50_transaction_status_set(
-	struct tr50_data *data,
-	iot_uint8_t txn_id,
-	enum tr50_transaction_status tx_status )
+size_t tr50_value_uint8(
+	char *buf,
+	const iot_telemetry_t *UNUSED(t),
+	const struct iot_data *d )
 {
-	/* size of a "chunk" in bits */
-	const unsigned int chunk_size_bits = sizeof(iot_uint32_t)*8u;
-	/* number of bits required to data for each item */
-	const unsigned int data_bits = 2u;
-	/* number of data blocks in a "chunk" */
-	const unsigned int data_blks = chunk_size_bits/data_bits;
+	return iot_json_number_integer( buf, d->value.uint8, IOT_FALSE );
+}
 
-	if ( data )
-	{
-		const unsigned int b = (txn_id / data_blks);
-		const iot_uint32_t mask = ((1u<<data_bits)-1u) << ((txn_id%data_blks)*data_bits);
-		const iot_uint32_t value = tx_status << ((txn_id%data_blks)*data_bits);
+size_t tr50_value_uint16(
+	char *buf,
+	const iot_telemetry_t *UNUSED(t),
+	const struct iot_data *d )
+{
+	return iot_json_number_integer( buf, d->value.uint16, IOT_FALSE );
+}
 
-		if ( b < sizeof(data->transactions) / sizeof(iot_uint32_t) )
-			data->transactions[b] = (data->transactions[b] & ~mask) | (value & mask);
-	}
+size_t tr50_value_uint32(
+	char *buf,
+	const iot_telemetry_t *UNUSED(t),
+	const struct iot_data *d )
+{
+	return iot_json_number_integer( buf, d->value.uint32, IOT_FALSE );
+}
+
+size_t tr50_value_uint64(
+	char *buf,
+	const iot_telemetry_t *UNUSED(t),
+	const struct iot_data *d )
+{
+	return iot_json_number_integer( buf, d->value.uint64, IOT_FALSE );
 }
 
 IOT_PLUGIN( tr50, 10, iot_version_encode(1,0,0,0),
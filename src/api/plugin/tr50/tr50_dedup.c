@@ -0,0 +1,352 @@
+/**
+ * @file
+ * @brief source file for the tr50 cache of recently executed mailbox
+ *        messages
+ *
+ * A mailbox message whose acknowledgement is lost (for example, during a
+ * reconnect) is delivered again.  The cache remembers the most recently
+ * executed messages so a duplicate is answered with the acknowledgement
+ * already sent, instead of being executed a second time.  The cache can be
+ * kept in a file, one fixed size record per slot, so that it survives a
+ * restart of the application (or a reboot requested by a message).
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "tr50_dedup.h"
+
+/** @brief Identifier at the start of each record in the file ("TR5D") */
+#define TR50_DEDUP_MAGIC                    0x54523544u
+
+/** @brief record kept in the file for each slot */
+struct tr50_dedup_record
+{
+	/** @brief identifier of a valid record */
+	iot_uint32_t magic;
+	/** @brief state of the message */
+	iot_uint32_t state;
+	/** @brief status the message was acknowledged with */
+	iot_uint32_t status;
+	/** @brief when the message was last seen */
+	iot_uint32_t used;
+	/** @brief id of the mailbox message */
+	char id[ IOT_ID_MAX_LEN + 1u ];
+};
+
+/**
+ * @brief finds a remembered message (cache must be locked)
+ *
+ * @param[in]      d                   cache to search
+ * @param[in]      id                  id of the mailbox message
+ *
+ * @return the slot holding the message, NULL if not remembered
+ */
+static IOT_SECTION struct tr50_dedup_entry *tr50_dedup_find(
+	struct tr50_dedup *d,
+	const char *id );
+
+/**
+ * @brief writes a slot to the file, if the cache is kept in one (cache
+ *        must be locked)
+ *
+ * @param[in,out]  d                   cache to write
+ * @param[in]      entry               slot to write
+ */
+static IOT_SECTION void tr50_dedup_write(
+	struct tr50_dedup *d,
+	const struct tr50_dedup_entry *entry );
+
+iot_status_t tr50_dedup_begin(
+	struct tr50_dedup *d,
+	const char *id,
+	iot_status_t *status,
+	char *ack,
+	size_t ack_max,
+	size_t *ack_len )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( d && id && status && ack_len )
+	{
+		*ack_len = 0u;
+		result = IOT_STATUS_SUCCESS;
+		if ( d->size > 0u && *id != '\0' )
+		{
+			struct tr50_dedup_entry *entry;
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_lock( &d->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+			entry = tr50_dedup_find( d, id );
+			if ( entry )
+			{
+				entry->used = ++d->used;
+				result = IOT_STATUS_INVOKED;
+				if ( entry->state == TR50_DEDUP_DONE )
+				{
+					*status = entry->status;
+#ifndef IOT_STACK_ONLY
+					if ( ack && entry->ack &&
+						entry->ack_len <= ack_max )
+					{
+						os_memcpy( ack, entry->ack,
+							entry->ack_len );
+						*ack_len = entry->ack_len;
+					}
+#else /* ifndef IOT_STACK_ONLY */
+					(void)ack;
+					(void)ack_max;
+#endif /* ifndef IOT_STACK_ONLY */
+					result = IOT_STATUS_EXISTS;
+				}
+			}
+			else
+			{
+				iot_uint32_t i;
+
+				/* use a free slot, or the least recently used */
+				entry = &d->entry[0];
+				for ( i = 1u; i < d->size &&
+					entry->state != TR50_DEDUP_UNUSED; ++i )
+				{
+					if ( d->entry[i].state == TR50_DEDUP_UNUSED ||
+						d->entry[i].used < entry->used )
+						entry = &d->entry[i];
+				}
+
+#ifndef IOT_STACK_ONLY
+				os_free_null( (void **)&entry->ack );
+				entry->ack_len = 0u;
+#endif /* ifndef IOT_STACK_ONLY */
+				os_strncpy( entry->id, id, IOT_ID_MAX_LEN );
+				entry->id[ IOT_ID_MAX_LEN ] = '\0';
+				entry->state = TR50_DEDUP_RUNNING;
+				entry->status = IOT_STATUS_INVOKED;
+				entry->used = ++d->used;
+				tr50_dedup_write( d, entry );
+			}
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_unlock( &d->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		}
+	}
+	return result;
+}
+
+void tr50_dedup_close(
+	struct tr50_dedup *d )
+{
+	if ( d && d->size > 0u )
+	{
+#ifndef IOT_STACK_ONLY
+		iot_uint32_t i;
+#endif /* ifndef IOT_STACK_ONLY */
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &d->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+#ifndef IOT_STACK_ONLY
+		for ( i = 0u; i < d->size; ++i )
+			os_free_null( (void **)&d->entry[i].ack );
+#endif /* ifndef IOT_STACK_ONLY */
+		if ( d->fd != OS_FILE_INVALID )
+			os_file_close( d->fd );
+		d->fd = OS_FILE_INVALID;
+		d->size = 0u;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &d->lock );
+		os_thread_mutex_destroy( &d->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+}
+
+void tr50_dedup_complete(
+	struct tr50_dedup *d,
+	const char *id,
+	iot_status_t status,
+	const char *ack,
+	size_t ack_len )
+{
+	if ( d && id && d->size > 0u )
+	{
+		struct tr50_dedup_entry *entry;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &d->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		entry = tr50_dedup_find( d, id );
+		if ( entry )
+		{
+			entry->state = TR50_DEDUP_DONE;
+			entry->status = status;
+#ifndef IOT_STACK_ONLY
+			/* larger acknowledgements are answered by status only */
+			os_free_null( (void **)&entry->ack );
+			entry->ack_len = 0u;
+			if ( ack && ack_len > 0u && ack_len <= TR50_DEDUP_ACK_MAX )
+			{
+				entry->ack = (char *)os_malloc( ack_len );
+				if ( entry->ack )
+				{
+					os_memcpy( entry->ack, ack, ack_len );
+					entry->ack_len = ack_len;
+				}
+			}
+#else /* ifndef IOT_STACK_ONLY */
+			(void)ack;
+			(void)ack_len;
+#endif /* ifndef IOT_STACK_ONLY */
+			tr50_dedup_write( d, entry );
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &d->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+}
+
+struct tr50_dedup_entry *tr50_dedup_find(
+	struct tr50_dedup *d,
+	const char *id )
+{
+	struct tr50_dedup_entry *result = NULL;
+	iot_uint32_t i;
+	for ( i = 0u; i < d->size && !result; ++i )
+	{
+		if ( d->entry[i].state != TR50_DEDUP_UNUSED &&
+			os_strncmp( d->entry[i].id, id, IOT_ID_MAX_LEN ) == 0 )
+			result = &d->entry[i];
+	}
+	return result;
+}
+
+void tr50_dedup_forget(
+	struct tr50_dedup *d,
+	const char *id )
+{
+	if ( d && id && d->size > 0u )
+	{
+		struct tr50_dedup_entry *entry;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &d->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		entry = tr50_dedup_find( d, id );
+		if ( entry )
+		{
+#ifndef IOT_STACK_ONLY
+			os_free_null( (void **)&entry->ack );
+#endif /* ifndef IOT_STACK_ONLY */
+			os_memzero( entry, sizeof( struct tr50_dedup_entry ) );
+			tr50_dedup_write( d, entry );
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &d->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+}
+
+iot_status_t tr50_dedup_open(
+	struct tr50_dedup *d,
+	iot_uint32_t size,
+	const char *path )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( d )
+	{
+		os_memzero( d, sizeof( struct tr50_dedup ) );
+		d->fd = OS_FILE_INVALID;
+		if ( size > TR50_DEDUP_SIZE_MAX )
+			size = TR50_DEDUP_SIZE_MAX;
+
+		result = IOT_STATUS_SUCCESS;
+		if ( size > 0u && path )
+		{
+			os_strncpy( d->path, path, PATH_MAX );
+			d->path[ PATH_MAX ] = '\0';
+			if ( os_file_exists( d->path ) != IOT_FALSE )
+				d->fd = os_file_open( d->path, OS_READ_WRITE );
+			else
+				d->fd = os_file_open( d->path,
+					OS_READ_WRITE | OS_CREATE );
+			if ( d->fd == OS_FILE_INVALID )
+				result = IOT_STATUS_FILE_OPEN_FAILED;
+		}
+
+		if ( size > 0u )
+		{
+			struct tr50_dedup_record rec;
+			iot_uint32_t i;
+
+			d->size = size;
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_create( &d->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+			/* recover the messages remembered by a previous run */
+			for ( i = 0u; d->fd != OS_FILE_INVALID && i < size &&
+				os_file_read( &rec, sizeof( rec ), 1u, d->fd ) == 1u;
+				++i )
+			{
+				struct tr50_dedup_entry *const entry = &d->entry[i];
+				if ( rec.magic == TR50_DEDUP_MAGIC &&
+					( rec.state == TR50_DEDUP_RUNNING ||
+					  rec.state == TR50_DEDUP_DONE ) &&
+					rec.id[ IOT_ID_MAX_LEN ] == '\0' )
+				{
+					os_memcpy( entry->id, rec.id,
+						sizeof( entry->id ) );
+					entry->state = TR50_DEDUP_DONE;
+					entry->status = (iot_status_t)rec.status;
+					entry->used = rec.used;
+					if ( rec.used > d->used )
+						d->used = rec.used;
+
+					/* interrupted, don't run it again (the
+					 * write leaves the file at the next record) */
+					if ( rec.state == TR50_DEDUP_RUNNING )
+					{
+						entry->status =
+							IOT_STATUS_EXECUTION_ERROR;
+						tr50_dedup_write( d, entry );
+					}
+				}
+			}
+		}
+	}
+	return result;
+}
+
+void tr50_dedup_write(
+	struct tr50_dedup *d,
+	const struct tr50_dedup_entry *entry )
+{
+	if ( d->fd != OS_FILE_INVALID )
+	{
+		struct tr50_dedup_record rec;
+		const long pos = (long)( sizeof( struct tr50_dedup_record ) *
+			(size_t)( entry - d->entry ) );
+
+		os_memzero( &rec, sizeof( struct tr50_dedup_record ) );
+		if ( entry->state != TR50_DEDUP_UNUSED )
+		{
+			rec.magic = TR50_DEDUP_MAGIC;
+			rec.state = (iot_uint32_t)entry->state;
+			rec.status = (iot_uint32_t)entry->status;
+			rec.used = entry->used;
+			os_memcpy( rec.id, entry->id, sizeof( rec.id ) );
+		}
+
+		/* written through, the message may reboot the device */
+		if ( os_file_seek( d->fd, pos, OS_FILE_SEEK_START ) == 0 &&
+			os_file_write( &rec, sizeof( rec ), 1u, d->fd ) == 1u )
+		{
+			os_flush( d->fd );
+			os_file_sync( d->path );
+		}
+	}
+}
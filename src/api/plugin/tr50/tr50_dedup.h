@@ -0,0 +1,176 @@
+/**
+ * @file
+ * @brief header file for the tr50 cache of recently executed mailbox
+ *        messages
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+#ifndef TR50_DEDUP_H
+#define TR50_DEDUP_H
+
+#include "../../shared/iot_types.h"
+
+#include <os.h>
+
+/** @brief Default number of mailbox messages remembered */
+#define TR50_DEDUP_SIZE_DEFAULT             64u
+/** @brief Maximum number of mailbox messages remembered */
+#define TR50_DEDUP_SIZE_MAX                 256u
+/** @brief Maximum size of an acknowledgement kept to answer a duplicate */
+#define TR50_DEDUP_ACK_MAX                  1024u
+
+/** @brief state of a remembered mailbox message */
+enum tr50_dedup_state
+{
+	/** @brief slot is not used */
+	TR50_DEDUP_UNUSED = 0,
+	/** @brief message is being executed */
+	TR50_DEDUP_RUNNING,
+	/** @brief message has been executed and acknowledged */
+	TR50_DEDUP_DONE
+};
+
+/** @brief a remembered mailbox message */
+struct tr50_dedup_entry
+{
+	/** @brief id of the mailbox message */
+	char id[ IOT_ID_MAX_LEN + 1u ];
+	/** @brief state of the message */
+	enum tr50_dedup_state state;
+	/** @brief status the message was acknowledged with */
+	iot_status_t status;
+	/** @brief when the message was last seen (higher = more recent) */
+	iot_uint32_t used;
+#ifndef IOT_STACK_ONLY
+	/** @brief acknowledgement sent for the message (optional) */
+	char *ack;
+	/** @brief length of the acknowledgement */
+	size_t ack_len;
+#endif /* ifndef IOT_STACK_ONLY */
+};
+
+/** @brief least recently used cache of executed mailbox messages */
+struct tr50_dedup
+{
+	/** @brief remembered messages */
+	struct tr50_dedup_entry entry[ TR50_DEDUP_SIZE_MAX ];
+	/** @brief number of messages remembered (0 = disabled) */
+	iot_uint32_t size;
+	/** @brief counter used to order the messages by last use */
+	iot_uint32_t used;
+	/** @brief handle to the file the cache is kept in (optional) */
+	os_file_t fd;
+#ifdef IOT_THREAD_SUPPORT
+	/** @brief lock protecting the cache */
+	os_thread_mutex_t lock;
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	/** @brief path to the file the cache is kept in */
+	char path[ PATH_MAX + 1u ];
+};
+
+/**
+ * @brief records that a mailbox message is about to be executed
+ *
+ * A message seen before is not recorded again; if it has completed, the
+ * acknowledgement sent for it is returned so it can be sent again.
+ *
+ * @param[in,out]  d                   cache to check
+ * @param[in]      id                  id of the mailbox message
+ * @param[out]     status              status the message completed with
+ * @param[out]     ack                 buffer to return the acknowledgement
+ *                                     sent for the message
+ * @param[in]      ack_max             size of the acknowledgement buffer
+ * @param[out]     ack_len             length of the acknowledgement (0 if
+ *                                     only the status is known)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_EXISTS           message has already been executed
+ * @retval IOT_STATUS_INVOKED          message is still being executed
+ * @retval IOT_STATUS_SUCCESS          message is new (or cache is disabled)
+ *
+ * @see tr50_dedup_complete
+ * @see tr50_dedup_forget
+ */
+IOT_SECTION iot_status_t tr50_dedup_begin(
+	struct tr50_dedup *d,
+	const char *id,
+	iot_status_t *status,
+	char *ack,
+	size_t ack_max,
+	size_t *ack_len );
+
+/**
+ * @brief closes the cache, releasing the messages remembered
+ *
+ * @param[in,out]  d                   cache to close
+ *
+ * @see tr50_dedup_open
+ */
+IOT_SECTION void tr50_dedup_close(
+	struct tr50_dedup *d );
+
+/**
+ * @brief records the acknowledgement sent for a mailbox message
+ *
+ * @param[in,out]  d                   cache to update
+ * @param[in]      id                  id of the mailbox message
+ * @param[in]      status              status the message completed with
+ * @param[in]      ack                 acknowledgement sent (optional)
+ * @param[in]      ack_len             length of the acknowledgement
+ *
+ * @see tr50_dedup_begin
+ */
+IOT_SECTION void tr50_dedup_complete(
+	struct tr50_dedup *d,
+	const char *id,
+	iot_status_t status,
+	const char *ack,
+	size_t ack_len );
+
+/**
+ * @brief forgets a mailbox message that could not be executed, so it is
+ *        executed if it is delivered again
+ *
+ * @param[in,out]  d                   cache to update
+ * @param[in]      id                  id of the mailbox message
+ *
+ * @see tr50_dedup_begin
+ */
+IOT_SECTION void tr50_dedup_forget(
+	struct tr50_dedup *d,
+	const char *id );
+
+/**
+ * @brief opens the cache
+ *
+ * If a file is given, messages remembered by a previous run are
+ * recovered from it.  A message that was still being executed when that
+ * run ended is treated as having failed, rather than executed again.
+ *
+ * @param[in,out]  d                   cache to open
+ * @param[in]      size                number of messages to remember
+ * @param[in]      path                path to the file to keep the cache in
+ *                                     (optional)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FILE_OPEN_FAILED failed to open the file
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see tr50_dedup_close
+ */
+IOT_SECTION iot_status_t tr50_dedup_open(
+	struct tr50_dedup *d,
+	iot_uint32_t size,
+	const char *path );
+
+#endif /* ifndef TR50_DEDUP_H */
@@ -0,0 +1,645 @@
+/**
+ * @file
+ * @brief source file for the tr50 store-and-forward journal
+ *
+ * The journal is a ring of records kept in a single file: a fixed header
+ * followed by a data region of a bounded size.  Each record is written
+ * before the header that makes it visible, and carries a checksum, so a
+ * crash while writing loses at most the record being written.
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "tr50_journal.h"
+
+/** @brief Identifier at the start of a journal file ("TR5J") */
+#define TR50_JOURNAL_MAGIC                  0x54523541u
+/** @brief Version of the journal file format */
+#define TR50_JOURNAL_VERSION                1u
+/** @brief Record length indicating the next record is at the start */
+#define TR50_JOURNAL_WRAP                   0xFFFFFFFFu
+
+/** @brief header at the start of a journal file */
+struct tr50_journal_header
+{
+	/** @brief identifier of a journal file */
+	iot_uint32_t magic;
+	/** @brief version of the file format */
+	iot_uint32_t version;
+	/** @brief size of the data region in bytes */
+	iot_uint32_t capacity;
+	/** @brief offset of the oldest record */
+	iot_uint32_t head;
+	/** @brief offset to write the next record */
+	iot_uint32_t tail;
+	/** @brief number of records */
+	iot_uint32_t count;
+	/** @brief checksum of the fields above */
+	iot_uint32_t checksum;
+	/** @brief reserved for future use */
+	iot_uint32_t reserved;
+};
+
+/** @brief header before each record */
+struct tr50_journal_record
+{
+	/** @brief length of the record (or TR50_JOURNAL_WRAP) */
+	iot_uint32_t len;
+	/** @brief checksum of the record */
+	iot_uint32_t checksum;
+};
+
+/**
+ * @brief calculates a crc32 checksum
+ *
+ * @param[in]      crc                 checksum of the preceding data
+ *                                     (0 to start)
+ * @param[in]      data                data to calculate the checksum of
+ * @param[in]      len                 length of the data
+ *
+ * @return the checksum of the data
+ */
+static IOT_SECTION iot_uint32_t tr50_journal_checksum(
+	iot_uint32_t crc,
+	const void *data,
+	size_t len );
+
+/**
+ * @brief writes the journal header to the file
+ *
+ * @param[in,out]  j                   journal to write the header for
+ *
+ * @retval IOT_STATUS_IO_ERROR         failed to write to the journal file
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t tr50_journal_header_write(
+	struct tr50_journal *j );
+
+/**
+ * @brief reads data from the data region of the journal
+ *
+ * @param[in,out]  j                   journal to read from
+ * @param[in]      offset              offset in the data region
+ * @param[out]     buf                 buffer to read into
+ * @param[in]      len                 amount of data
+ *
+ * @retval IOT_STATUS_IO_ERROR         failed to read the journal file
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see tr50_journal_write
+ */
+static IOT_SECTION iot_status_t tr50_journal_read(
+	struct tr50_journal *j,
+	iot_uint32_t offset,
+	void *buf,
+	size_t len );
+
+/**
+ * @brief reads the header of the record at an offset, following the
+ *        wrap to the start of the data region if required
+ *
+ * @param[in,out]  j                   journal to read from
+ * @param[in,out]  offset              offset of the record, updated if the
+ *                                     record is at the start of the region
+ * @param[out]     rec                 record header
+ *
+ * @retval IOT_STATUS_IO_ERROR         failed to read the journal file
+ * @retval IOT_STATUS_PARSE_ERROR      record header is not valid
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t tr50_journal_record_header(
+	struct tr50_journal *j,
+	iot_uint32_t *offset,
+	struct tr50_journal_record *rec );
+
+/**
+ * @brief removes the oldest record (journal must be locked)
+ *
+ * @param[in,out]  j                   journal to remove the record from
+ *
+ * @retval IOT_STATUS_IO_ERROR         failed to update the journal file
+ * @retval IOT_STATUS_NOT_FOUND        journal is empty
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static IOT_SECTION iot_status_t tr50_journal_remove(
+	struct tr50_journal *j );
+
+/**
+ * @brief validates the records in a recovered journal, truncating it at
+ *        the first damaged record
+ *
+ * @param[in,out]  j                   journal to validate
+ */
+static IOT_SECTION void tr50_journal_recover(
+	struct tr50_journal *j );
+
+/**
+ * @brief writes data to the data region of the journal
+ *
+ * @param[in,out]  j                   journal to write to
+ * @param[in]      offset              offset in the data region
+ * @param[in]      buf                 data to write
+ * @param[in]      len                 amount of data
+ *
+ * @retval IOT_STATUS_IO_ERROR         failed to write the journal file
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see tr50_journal_read
+ */
+static IOT_SECTION iot_status_t tr50_journal_write(
+	struct tr50_journal *j,
+	iot_uint32_t offset,
+	const void *buf,
+	size_t len );
+
+/**
+ * @brief writes changes through to disk based on the sync policy
+ *        (journal must be locked)
+ *
+ * @param[in,out]  j                   journal to write through
+ * @param[in]      force               write through regardless of policy
+ */
+static IOT_SECTION void tr50_journal_write_through(
+	struct tr50_journal *j,
+	iot_bool_t force );
+
+
+iot_status_t tr50_journal_append(
+	struct tr50_journal *j,
+	const void *data,
+	size_t len )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( j && j->fd != OS_FILE_INVALID && data && len > 0u )
+	{
+		const iot_uint32_t rec_len =
+			(iot_uint32_t)( sizeof( struct tr50_journal_record ) + len );
+		result = IOT_STATUS_OUT_OF_RANGE;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		if ( len <= TR50_JOURNAL_RECORD_MAX && rec_len <= j->capacity )
+		{
+			iot_uint32_t offset = 0u;
+			iot_bool_t fits = IOT_FALSE;
+
+			result = IOT_STATUS_SUCCESS;
+			while ( fits == IOT_FALSE && result == IOT_STATUS_SUCCESS )
+			{
+				if ( j->count == 0u )
+				{
+					j->head = j->tail = 0u;
+					fits = IOT_TRUE;
+				}
+				else if ( j->tail > j->head )
+				{
+					if ( j->tail + rec_len <= j->capacity )
+						fits = IOT_TRUE;
+					else if ( rec_len <= j->head )
+					{
+						/* mark the wrap, if there is room */
+						if ( j->capacity - j->tail >=
+							sizeof( struct tr50_journal_record ) )
+						{
+							struct tr50_journal_record wrap;
+							wrap.len = TR50_JOURNAL_WRAP;
+							wrap.checksum = 0u;
+							result = tr50_journal_write( j, j->tail,
+								&wrap, sizeof( wrap ) );
+						}
+						j->tail = 0u;
+						fits = IOT_TRUE;
+					}
+				}
+				else if ( j->tail < j->head &&
+					j->tail + rec_len <= j->head )
+					fits = IOT_TRUE;
+
+				if ( result == IOT_STATUS_SUCCESS && fits == IOT_FALSE )
+				{
+					if ( j->drop == TR50_JOURNAL_DROP_OLDEST )
+						result = tr50_journal_remove( j );
+					else
+						result = IOT_STATUS_FULL;
+				}
+			}
+
+			/* write the record before making it visible */
+			if ( result == IOT_STATUS_SUCCESS )
+			{
+				struct tr50_journal_record rec;
+				offset = j->tail;
+				rec.len = (iot_uint32_t)len;
+				rec.checksum = tr50_journal_checksum( 0u, data, len );
+				result = tr50_journal_write( j, offset, &rec,
+					sizeof( rec ) );
+				if ( result == IOT_STATUS_SUCCESS )
+					result = tr50_journal_write( j,
+						offset + (iot_uint32_t)sizeof( rec ),
+						data, len );
+			}
+			if ( result == IOT_STATUS_SUCCESS )
+			{
+				j->tail = offset + rec_len;
+				++j->count;
+				result = tr50_journal_header_write( j );
+				tr50_journal_write_through( j, IOT_FALSE );
+			}
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+	return result;
+}
+
+iot_uint32_t tr50_journal_checksum(
+	iot_uint32_t crc,
+	const void *data,
+	size_t len )
+{
+	const iot_uint8_t *p = (const iot_uint8_t *)data;
+	crc = ~crc;
+	while ( len-- )
+	{
+		unsigned int i;
+		crc ^= *p++;
+		for ( i = 0u; i < 8u; ++i )
+			crc = ( crc >> 1 ) ^ ( 0xEDB88320u & ( 0u - ( crc & 1u ) ) );
+	}
+	return ~crc;
+}
+
+void tr50_journal_close(
+	struct tr50_journal *j )
+{
+	if ( j && j->fd != OS_FILE_INVALID )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		tr50_journal_write_through( j, IOT_TRUE );
+		os_file_close( j->fd );
+		j->fd = OS_FILE_INVALID;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &j->lock );
+		os_thread_mutex_destroy( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+}
+
+iot_uint32_t tr50_journal_count(
+	struct tr50_journal *j )
+{
+	iot_uint32_t result = 0u;
+	if ( j && j->fd != OS_FILE_INVALID )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		result = j->count;
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+	return result;
+}
+
+iot_status_t tr50_journal_header_write(
+	struct tr50_journal *j )
+{
+	iot_status_t result = IOT_STATUS_IO_ERROR;
+	struct tr50_journal_header hdr;
+
+	os_memzero( &hdr, sizeof( hdr ) );
+	hdr.magic = TR50_JOURNAL_MAGIC;
+	hdr.version = TR50_JOURNAL_VERSION;
+	hdr.capacity = j->capacity;
+	hdr.head = j->head;
+	hdr.tail = j->tail;
+	hdr.count = j->count;
+	hdr.checksum = tr50_journal_checksum( 0u, &hdr,
+		offsetof( struct tr50_journal_header, checksum ) );
+	if ( os_file_seek( j->fd, 0, OS_FILE_SEEK_START ) == 0 &&
+		os_file_write( &hdr, sizeof( hdr ), 1u, j->fd ) == 1u )
+	{
+		++j->sync_pending;
+		result = IOT_STATUS_SUCCESS;
+	}
+	return result;
+}
+
+iot_status_t tr50_journal_open(
+	struct tr50_journal *j,
+	const char *path,
+	iot_uint32_t capacity,
+	enum tr50_journal_sync sync,
+	enum tr50_journal_drop drop )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( j && path && *path != '\0' )
+	{
+		struct tr50_journal_header hdr;
+		iot_bool_t valid = IOT_FALSE;
+
+		if ( capacity < TR50_JOURNAL_SIZE_MIN )
+			capacity = TR50_JOURNAL_SIZE_MIN;
+		os_memzero( j, sizeof( struct tr50_journal ) );
+		os_strncpy( j->path, path, PATH_MAX );
+		j->path[ PATH_MAX ] = '\0';
+		j->capacity = capacity;
+		j->drop = drop;
+		j->sync = sync;
+		j->sync_time = iot_timestamp_now();
+
+		j->fd = OS_FILE_INVALID;
+		if ( os_file_exists( j->path ) != IOT_FALSE )
+			j->fd = os_file_open( j->path, OS_READ_WRITE );
+
+		/* recover an existing journal */
+		if ( j->fd != OS_FILE_INVALID &&
+			os_file_read( &hdr, sizeof( hdr ), 1u, j->fd ) == 1u &&
+			hdr.magic == TR50_JOURNAL_MAGIC &&
+			hdr.version == TR50_JOURNAL_VERSION &&
+			hdr.checksum == tr50_journal_checksum( 0u, &hdr,
+				offsetof( struct tr50_journal_header, checksum ) ) &&
+			hdr.head < hdr.capacity && hdr.tail <= hdr.capacity &&
+			hdr.count > 0u )
+		{
+			/* keep the size of the journal until it is drained */
+			j->capacity = hdr.capacity;
+			j->head = hdr.head;
+			j->tail = hdr.tail;
+			j->count = hdr.count;
+			valid = IOT_TRUE;
+		}
+
+		if ( valid == IOT_FALSE )
+		{
+			if ( j->fd != OS_FILE_INVALID )
+				os_file_close( j->fd );
+			j->fd = os_file_open( j->path, OS_READ_WRITE | OS_CREATE );
+		}
+
+		result = IOT_STATUS_FILE_OPEN_FAILED;
+		if ( j->fd != OS_FILE_INVALID )
+		{
+#ifdef IOT_THREAD_SUPPORT
+			os_thread_mutex_create( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+			if ( valid != IOT_FALSE )
+				tr50_journal_recover( j );
+			result = tr50_journal_header_write( j );
+			tr50_journal_write_through( j, IOT_TRUE );
+		}
+	}
+	return result;
+}
+
+iot_status_t tr50_journal_peek(
+	struct tr50_journal *j,
+	void *buf,
+	size_t buf_len,
+	size_t *len )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( j && j->fd != OS_FILE_INVALID && buf && len )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		result = IOT_STATUS_NOT_FOUND;
+		if ( j->count > 0u )
+		{
+			struct tr50_journal_record rec;
+			iot_uint32_t offset = j->head;
+			result = tr50_journal_record_header( j, &offset, &rec );
+			if ( result == IOT_STATUS_SUCCESS )
+			{
+				*len = rec.len;
+				if ( rec.len > buf_len )
+					result = IOT_STATUS_NO_MEMORY;
+				else
+					result = tr50_journal_read( j,
+						offset + (iot_uint32_t)sizeof( rec ),
+						buf, rec.len );
+			}
+			if ( result == IOT_STATUS_SUCCESS &&
+				tr50_journal_checksum( 0u, buf, rec.len ) !=
+					rec.checksum )
+				result = IOT_STATUS_PARSE_ERROR;
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+	return result;
+}
+
+iot_status_t tr50_journal_pop(
+	struct tr50_journal *j )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( j && j->fd != OS_FILE_INVALID )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		result = tr50_journal_remove( j );
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			result = tr50_journal_header_write( j );
+			tr50_journal_write_through( j, IOT_FALSE );
+		}
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+	return result;
+}
+
+iot_status_t tr50_journal_read(
+	struct tr50_journal *j,
+	iot_uint32_t offset,
+	void *buf,
+	size_t len )
+{
+	iot_status_t result = IOT_STATUS_IO_ERROR;
+	const long pos = (long)( sizeof( struct tr50_journal_header ) + offset );
+	if ( os_file_seek( j->fd, pos, OS_FILE_SEEK_START ) == 0 &&
+		os_file_read( buf, len, 1u, j->fd ) == 1u )
+		result = IOT_STATUS_SUCCESS;
+	return result;
+}
+
+iot_status_t tr50_journal_record_header(
+	struct tr50_journal *j,
+	iot_uint32_t *offset,
+	struct tr50_journal_record *rec )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	iot_bool_t wrap = IOT_TRUE;
+
+	/* too little room at the end of the region for a record */
+	if ( j->capacity - *offset >= sizeof( struct tr50_journal_record ) )
+	{
+		result = tr50_journal_read( j, *offset, rec,
+			sizeof( struct tr50_journal_record ) );
+		if ( result != IOT_STATUS_SUCCESS ||
+			rec->len != TR50_JOURNAL_WRAP )
+			wrap = IOT_FALSE;
+	}
+
+	if ( wrap != IOT_FALSE )
+	{
+		*offset = 0u;
+		result = tr50_journal_read( j, 0u, rec,
+			sizeof( struct tr50_journal_record ) );
+	}
+
+	if ( result == IOT_STATUS_SUCCESS &&
+		( rec->len > TR50_JOURNAL_RECORD_MAX ||
+		  *offset + sizeof( struct tr50_journal_record ) + rec->len >
+			j->capacity ) )
+		result = IOT_STATUS_PARSE_ERROR;
+	return result;
+}
+
+void tr50_journal_recover(
+	struct tr50_journal *j )
+{
+	iot_uint32_t i;
+	iot_uint32_t offset = j->head;
+
+	for ( i = 0u; i < j->count; ++i )
+	{
+		struct tr50_journal_record rec;
+		iot_bool_t valid = IOT_FALSE;
+		if ( tr50_journal_record_header( j, &offset, &rec )
+			== IOT_STATUS_SUCCESS )
+		{
+			char buf[256u];
+			iot_uint32_t crc = 0u;
+			iot_uint32_t pos = 0u;
+
+			valid = IOT_TRUE;
+			while ( valid != IOT_FALSE && pos < rec.len )
+			{
+				size_t chunk = rec.len - pos;
+				if ( chunk > sizeof( buf ) )
+					chunk = sizeof( buf );
+				if ( tr50_journal_read( j,
+					offset + (iot_uint32_t)sizeof( rec ) + pos,
+					buf, chunk ) == IOT_STATUS_SUCCESS )
+				{
+					crc = tr50_journal_checksum( crc, buf, chunk );
+					pos += (iot_uint32_t)chunk;
+				}
+				else
+					valid = IOT_FALSE;
+			}
+			if ( crc != rec.checksum )
+				valid = IOT_FALSE;
+		}
+
+		if ( valid == IOT_FALSE )
+		{
+			/* discard this record and everything after it */
+			j->count = i;
+			j->tail = offset;
+		}
+		else
+			offset += (iot_uint32_t)sizeof( rec ) + rec.len;
+	}
+	if ( j->count == 0u )
+		j->head = j->tail = 0u;
+}
+
+iot_status_t tr50_journal_remove(
+	struct tr50_journal *j )
+{
+	iot_status_t result = IOT_STATUS_NOT_FOUND;
+	if ( j->count > 0u )
+	{
+		struct tr50_journal_record rec;
+		iot_uint32_t offset = j->head;
+		result = tr50_journal_record_header( j, &offset, &rec );
+		if ( result == IOT_STATUS_SUCCESS )
+			j->head = offset + (iot_uint32_t)sizeof( rec ) + rec.len;
+		else
+			/* damaged record, nothing after it can be trusted */
+			j->count = 1u;
+
+		--j->count;
+		if ( j->count == 0u )
+			j->head = j->tail = 0u;
+		result = IOT_STATUS_SUCCESS;
+	}
+	return result;
+}
+
+void tr50_journal_sync(
+	struct tr50_journal *j,
+	iot_bool_t force )
+{
+	if ( j && j->fd != OS_FILE_INVALID )
+	{
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_lock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+		tr50_journal_write_through( j, force );
+#ifdef IOT_THREAD_SUPPORT
+		os_thread_mutex_unlock( &j->lock );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	}
+}
+
+iot_status_t tr50_journal_write(
+	struct tr50_journal *j,
+	iot_uint32_t offset,
+	const void *buf,
+	size_t len )
+{
+	iot_status_t result = IOT_STATUS_IO_ERROR;
+	const long pos = (long)( sizeof( struct tr50_journal_header ) + offset );
+	if ( os_file_seek( j->fd, pos, OS_FILE_SEEK_START ) == 0 &&
+		os_file_write( buf, len, 1u, j->fd ) == 1u )
+		result = IOT_STATUS_SUCCESS;
+	return result;
+}
+
+void tr50_journal_write_through(
+	struct tr50_journal *j,
+	iot_bool_t force )
+{
+	if ( j->sync_pending > 0u )
+	{
+		iot_bool_t do_sync = force;
+		const iot_timestamp_t now = iot_timestamp_now();
+		if ( j->sync == TR50_JOURNAL_SYNC_RECORD )
+			do_sync = IOT_TRUE;
+		else if ( j->sync == TR50_JOURNAL_SYNC_BATCH &&
+			( j->sync_pending >= TR50_JOURNAL_SYNC_BATCH_COUNT ||
+			  now - j->sync_time >= TR50_JOURNAL_SYNC_BATCH_INTERVAL ) )
+			do_sync = IOT_TRUE;
+
+		if ( do_sync != IOT_FALSE )
+		{
+			os_flush( j->fd );
+			if ( j->sync != TR50_JOURNAL_SYNC_NONE )
+				os_file_sync( j->path );
+			j->sync_pending = 0u;
+			j->sync_time = now;
+		}
+	}
+}
@@ -0,0 +1,201 @@
+/**
+ * @file
+ * @brief header file for the tr50 store-and-forward journal
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+#ifndef TR50_JOURNAL_H
+#define TR50_JOURNAL_H
+
+#include "../../shared/iot_types.h"
+
+#include <os.h>
+
+/** @brief Default size of the journal data region in bytes */
+#define TR50_JOURNAL_SIZE_DEFAULT           ( 1024u * 1024u ) /* 1 MB */
+/** @brief Minimum size of the journal data region in bytes */
+#define TR50_JOURNAL_SIZE_MIN               4096u
+/** @brief Maximum size of a single record in bytes */
+#define TR50_JOURNAL_RECORD_MAX             4096u
+/** @brief Number of records written before a batched sync */
+#define TR50_JOURNAL_SYNC_BATCH_COUNT       32u
+/** @brief Time in milliseconds before a batched sync */
+#define TR50_JOURNAL_SYNC_BATCH_INTERVAL    1000u
+
+/** @brief when the journal is written through to the disk */
+enum tr50_journal_sync
+{
+	/** @brief leave it to the operating system */
+	TR50_JOURNAL_SYNC_NONE = 0,
+	/** @brief after a number of records or an amount of time */
+	TR50_JOURNAL_SYNC_BATCH,
+	/** @brief after every record */
+	TR50_JOURNAL_SYNC_RECORD
+};
+
+/** @brief what to do when a record doesn't fit in the journal */
+enum tr50_journal_drop
+{
+	/** @brief discard the oldest records to make room */
+	TR50_JOURNAL_DROP_OLDEST = 0,
+	/** @brief discard the record being added */
+	TR50_JOURNAL_DROP_NEWEST
+};
+
+/** @brief append-only ring journal stored in a file */
+struct tr50_journal
+{
+	/** @brief size of the data region in bytes */
+	iot_uint32_t capacity;
+	/** @brief number of records in the journal */
+	iot_uint32_t count;
+	/** @brief policy when the journal is full */
+	enum tr50_journal_drop drop;
+	/** @brief handle to the journal file */
+	os_file_t fd;
+	/** @brief offset of the oldest record */
+	iot_uint32_t head;
+#ifdef IOT_THREAD_SUPPORT
+	/** @brief lock protecting the journal */
+	os_thread_mutex_t lock;
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	/** @brief path to the journal file */
+	char path[ PATH_MAX + 1u ];
+	/** @brief policy for writing through to disk */
+	enum tr50_journal_sync sync;
+	/** @brief number of changes not yet written through to disk */
+	iot_uint32_t sync_pending;
+	/** @brief time of the last write through to disk */
+	iot_timestamp_t sync_time;
+	/** @brief offset to write the next record */
+	iot_uint32_t tail;
+};
+
+/**
+ * @brief adds a record to the end of the journal
+ *
+ * @param[in,out]  j                   journal to add to
+ * @param[in]      data                record to add
+ * @param[in]      len                 length of the record
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             no space and drop policy is newest
+ * @retval IOT_STATUS_IO_ERROR         failed to write to the journal file
+ * @retval IOT_STATUS_OUT_OF_RANGE     record is too large for the journal
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see tr50_journal_peek
+ * @see tr50_journal_pop
+ */
+IOT_SECTION iot_status_t tr50_journal_append(
+	struct tr50_journal *j,
+	const void *data,
+	size_t len );
+
+/**
+ * @brief closes the journal, records remain in the file
+ *
+ * @param[in,out]  j                   journal to close
+ *
+ * @see tr50_journal_open
+ */
+IOT_SECTION void tr50_journal_close(
+	struct tr50_journal *j );
+
+/**
+ * @brief returns the number of records in the journal
+ *
+ * @param[in]      j                   journal to query
+ *
+ * @return the number of records in the journal (0 if not open)
+ */
+IOT_SECTION iot_uint32_t tr50_journal_count(
+	struct tr50_journal *j );
+
+/**
+ * @brief opens (or creates) a journal file
+ *
+ * If the file holds a valid journal, its records are recovered up to
+ * the first damaged record; otherwise an empty journal is created.
+ *
+ * @param[in,out]  j                   journal to open
+ * @param[in]      path                path to the journal file
+ * @param[in]      capacity            size of the data region in bytes
+ * @param[in]      sync                policy for writing through to disk
+ * @param[in]      drop                policy when the journal is full
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FILE_OPEN_FAILED failed to open the journal file
+ * @retval IOT_STATUS_IO_ERROR         failed to write to the journal file
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see tr50_journal_close
+ */
+IOT_SECTION iot_status_t tr50_journal_open(
+	struct tr50_journal *j,
+	const char *path,
+	iot_uint32_t capacity,
+	enum tr50_journal_sync sync,
+	enum tr50_journal_drop drop );
+
+/**
+ * @brief reads the oldest record in the journal without removing it
+ *
+ * @param[in,out]  j                   journal to read from
+ * @param[out]     buf                 buffer to read the record into
+ * @param[in]      buf_len             size of the buffer
+ * @param[out]     len                 length of the record
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_IO_ERROR         failed to read the journal file
+ * @retval IOT_STATUS_NO_MEMORY        buffer too small, @p len holds the size
+ *                                     required
+ * @retval IOT_STATUS_NOT_FOUND        journal is empty
+ * @retval IOT_STATUS_PARSE_ERROR      record is damaged
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see tr50_journal_pop
+ */
+IOT_SECTION iot_status_t tr50_journal_peek(
+	struct tr50_journal *j,
+	void *buf,
+	size_t buf_len,
+	size_t *len );
+
+/**
+ * @brief removes the oldest record from the journal
+ *
+ * @param[in,out]  j                   journal to remove the record from
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_IO_ERROR         failed to update the journal file
+ * @retval IOT_STATUS_NOT_FOUND        journal is empty
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see tr50_journal_peek
+ */
+IOT_SECTION iot_status_t tr50_journal_pop(
+	struct tr50_journal *j );
+
+/**
+ * @brief writes pending changes through to disk for the batched policy
+ *
+ * @param[in,out]  j                   journal to write through
+ * @param[in]      force               write through regardless of the
+ *                                     number of changes or time
+ */
+IOT_SECTION void tr50_journal_sync(
+	struct tr50_journal *j,
+	iot_bool_t force );
+
+#endif /* ifndef TR50_JOURNAL_H */
@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief source file for the pre-encoded tr50 telemetry messages
+ *
+ * Telemetry samples of a simple type are published without going through
+ * the JSON encoder: the parts of the message that don't change between
+ * samples are encoded once, when the telemetry object is registered, and
+ * the message for each sample is assembled around them.
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "tr50_telemetry.h"
+
+#include <iot_json.h>
+
+size_t tr50_telemetry_head(
+	char *buf,
+	const iot_transaction_t *txn,
+	const char *thing_key,
+	size_t thing_key_len,
+	const char *key,
+	size_t key_len )
+{
+	size_t result = 2u;
+	buf[0] = '{';
+	buf[1] = '"';
+	if ( txn )
+		result += iot_json_number_integer( &buf[result],
+			(iot_uint64_t)(*txn), IOT_FALSE );
+	else
+	{
+		os_memcpy( &buf[result], "cmd", 3u );
+		result += 3u;
+	}
+	os_memcpy( &buf[result], "\":{", 3u );
+	result += 3u;
+	os_memcpy( &buf[result], TR50_TELEMETRY_COMMAND,
+		sizeof( TR50_TELEMETRY_COMMAND ) - 1u );
+	result += sizeof( TR50_TELEMETRY_COMMAND ) - 1u;
+	os_memcpy( &buf[result], thing_key, thing_key_len );
+	result += thing_key_len;
+	os_memcpy( &buf[result], key, key_len );
+	result += key_len;
+	return result;
+}
+
+size_t tr50_telemetry_key(
+	char *key,
+	const char *name,
+	size_t name_len )
+{
+	static const char key_start[] = "\",\"key\":\"";
+	static const char value_start[] = "\",\"value\":";
+	size_t result = 0u;
+	if ( sizeof( key_start ) - 1u +
+		iot_json_string_escape_len( name, name_len ) +
+		sizeof( value_start ) - 1u <= TR50_TELEMETRY_KEY_MAX )
+	{
+		result = sizeof( key_start ) - 1u;
+		os_memcpy( key, key_start, result );
+		result += iot_json_string_escape( &key[result], name,
+			name_len, TR50_TELEMETRY_KEY_MAX - result );
+		os_memcpy( &key[result], value_start,
+			sizeof( value_start ) - 1u );
+		result += sizeof( value_start ) - 1u;
+	}
+	return result;
+}
+
+size_t tr50_telemetry_tail(
+	char *buf,
+	const char *ts,
+	size_t ts_len )
+{
+	size_t result = 0u;
+	if ( ts && ts_len > 0u )
+	{
+		os_memcpy( buf, TR50_TELEMETRY_TS,
+			sizeof( TR50_TELEMETRY_TS ) - 1u );
+		result = sizeof( TR50_TELEMETRY_TS ) - 1u;
+		os_memcpy( &buf[result], ts, ts_len );
+		result += ts_len;
+		buf[result++] = '"';
+	}
+	/* closes "params", the command and the message */
+	buf[result++] = '}';
+	buf[result++] = '}';
+	buf[result++] = '}';
+	buf[result] = '\0';
+	return result;
+}
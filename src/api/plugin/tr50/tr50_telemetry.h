@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief header file for the pre-encoded tr50 telemetry messages
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+#ifndef TR50_TELEMETRY_H
+#define TR50_TELEMETRY_H
+
+#include "../../shared/iot_types.h"
+
+#include <os.h>
+
+/** @brief Size of the pre-encoded key part of a telemetry message */
+#define TR50_TELEMETRY_KEY_MAX              ( IOT_NAME_MAX_LEN + 64u )
+/** @brief Start of a pre-encoded telemetry message, up to the thing key */
+#define TR50_TELEMETRY_COMMAND              \
+	"\"command\":\"property.publish\",\"params\":{\"thingKey\":\""
+/** @brief Time stamp part of a pre-encoded telemetry message */
+#define TR50_TELEMETRY_TS                   ",\"ts\":\""
+/** @brief Size of a formatted time stamp: "YYYY-MM-DDTHH:MM:SS.mmmZ" */
+#define TR50_TIME_LEN                       25u
+
+/**
+ * @brief Maximum length of a telemetry message, excluding the thing key,
+ *        key and value parts (includes the null-terminator)
+ *
+ * {"<id>":{<command><thing key><key><value>,"ts":"<ts>"}}}
+ */
+#define TR50_TELEMETRY_FRAME_MAX            \
+	( 16u + sizeof( TR50_TELEMETRY_COMMAND ) + \
+	  sizeof( TR50_TELEMETRY_TS ) + TR50_TIME_LEN + 3u )
+
+/**
+ * @brief writes the start of a telemetry message, up to its value
+ *
+ * The message written is:
+ * {"<id>":{"command":"property.publish","params":{"thingKey":"<thing key>
+ *
+ * followed by the pre-encoded key part.
+ *
+ * @param[out]     buf                 destination buffer
+ * @param[in]      txn                 transaction the message is sent for
+ *                                     (optional, "cmd" is used if not set)
+ * @param[in]      thing_key           escaped thing key
+ * @param[in]      thing_key_len       length of the thing key
+ * @param[in]      key                 pre-encoded key part
+ * @param[in]      key_len             length of the key part
+ *
+ * @return the number of characters written (not null-terminated)
+ *
+ * @see tr50_telemetry_key
+ * @see tr50_telemetry_tail
+ */
+IOT_SECTION size_t tr50_telemetry_head(
+	char *buf,
+	const iot_transaction_t *txn,
+	const char *thing_key,
+	size_t thing_key_len,
+	const char *key,
+	size_t key_len );
+
+/**
+ * @brief pre-encodes the key part of the messages for a telemetry object
+ *
+ * The key part written is: ","key":"<name>","value":
+ *
+ * @param[out]     key                 destination buffer, must hold at least
+ *                                     TR50_TELEMETRY_KEY_MAX characters
+ * @param[in]      name                name of the telemetry object
+ * @param[in]      name_len            length of the name
+ *
+ * @return the number of characters written (not null-terminated), 0 if the
+ *         escaped name does not fit
+ *
+ * @see tr50_telemetry_head
+ */
+IOT_SECTION size_t tr50_telemetry_key(
+	char *key,
+	const char *name,
+	size_t name_len );
+
+/**
+ * @brief writes the end of a telemetry message, after its value
+ *
+ * The message written is: ,"ts":"<ts>"}}} (the time stamp is omitted if
+ * @p ts_len is 0)
+ *
+ * @param[out]     buf                 destination buffer
+ * @param[in]      ts                  formatted time stamp (optional)
+ * @param[in]      ts_len              length of the time stamp
+ *
+ * @return the number of characters written, not including the
+ *         null-terminator
+ *
+ * @see tr50_telemetry_head
+ */
+IOT_SECTION size_t tr50_telemetry_tail(
+	char *buf,
+	const char *ts,
+	size_t ts_len );
+
+#endif /* ifndef TR50_TELEMETRY_H */
@@ -185,7 +185,7 @@ typedef uint32_t                                 iot_severity_t;
 /** @brief Type representing a telemetry data */
 typedef struct iot_telemetry                     iot_telemetry_t;
 /** @brief Type representing communication between client and agent */
-typedef iot_uint8_t                              iot_transaction_t;
+typedef iot_uint32_t                             iot_transaction_t;
 /** @brief Type containing verison information for the library */
 typedef iot_uint32_t                             iot_version_t;
 
@@ -372,7 +372,9 @@ typedef struct iot_log_source
  *                                     invoked the callback
  * @param[in]      user_data           pointer to user specific data
  *
- * @return a return code indicating if action was handled
+ * @return a return code indicating if action was handled, or
+ *         IOT_STATUS_INVOKED to keep the request and report its result later
+ *         through @ref iot_action_request_complete
  */
 typedef iot_status_t (iot_action_callback_t)(
 	iot_action_request_t *request,
@@ -404,6 +406,22 @@ typedef void (iot_log_callback_t)(
 	const char *message,
 	void *user_data );
 
+/**
+ * @brief Type for a callback function called when a transaction completes
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      txn                 transaction that completed
+ * @param[in]      status              result of the transaction
+ *                                     (IOT_STATUS_TIMED_OUT if it was
+ *                                     forgotten before completing)
+ * @param[in]      user_data           pointer to user specific data
+ */
+typedef void (iot_transaction_callback_t)(
+	iot_t *lib,
+	iot_transaction_t txn,
+	iot_status_t status,
+	void *user_data );
+
 /* common */
 /**
  * @brief Connects to an agent
@@ -622,6 +640,25 @@ IOT_API IOT_SECTION iot_status_t iot_action_option_set_raw(
 	size_t length,
 	const void *ptr );
 
+/**
+ * @brief Sets the maximum number of requests for an action that may execute
+ *        at the same time
+ *
+ * Requests beyond the limit stay queued until a running request for the
+ * action completes, leaving the other worker threads free for requests to
+ * other actions.
+ *
+ * @param[in,out]  action              action to set limit for
+ * @param[in]      max                 maximum number of concurrent requests
+ *                                     (0 indicates no limit)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed
+ * @retval IOT_STATUS_SUCCESS          limit was successfully set
+ */
+IOT_API IOT_SECTION iot_status_t iot_action_concurrency_set(
+	iot_action_t *action,
+	iot_uint32_t max );
+
 /**
  * @brief Deregisters an action from an agent
  *
@@ -662,6 +699,32 @@ IOT_API IOT_SECTION iot_status_t iot_action_free(
 	iot_action_t *action,
 	iot_millisecond_t max_time_out );
 
+/**
+ * @brief Adds an action to a named group of actions using the same resource
+ *
+ * An action added exclusively does not execute at the same time as any
+ * other action in the group, while actions added shared execute together.
+ * Actions that have no group in common do not block each other.  An action
+ * flagged with IOT_ACTION_EXCLUSIVE_APP is exclusive of all groups.
+ *
+ * @note This must be set before an action is registered
+ *
+ * @param[in,out]  action              action to add to the group
+ * @param[in]      group               name of the group (e.g. "filesystem")
+ * @param[in]      exclusive           whether the action needs the group
+ *                                     to itself while executing
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed
+ * @retval IOT_STATUS_FULL             maximum number of groups reached
+ * @retval IOT_STATUS_SUCCESS          action was successfully added
+ *
+ * @see iot_action_flags_set
+ */
+IOT_API IOT_SECTION iot_status_t iot_action_lock_group_add(
+	iot_action_t *action,
+	const char *group,
+	iot_bool_t exclusive );
+
 /**
  * @brief Adds a parameter to an action
  *
@@ -855,6 +918,30 @@ IOT_API IOT_SECTION iot_action_request_t *iot_action_request_allocate(
 	const char *name,
 	const char *source );
 
+/**
+ * @brief Completes a request whose callback returned IOT_STATUS_INVOKED
+ *
+ * The result is reported and the request is freed, it must not be used
+ * afterwards.  This function may be called from any thread.  If the request
+ * passed the time limit of its action, a time out was already reported and
+ * the request is only freed.
+ *
+ * @param[in]      request             deferred request to complete
+ * @param[in]      status              result of the action
+ * @param[in]      message             error message to report (optional)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function,
+ *                                     or the request is not deferred
+ * @retval IOT_STATUS_SUCCESS          result reported
+ * @retval IOT_STATUS_TIMED_OUT        request had already timed out
+ *
+ * @see iot_action_register_callback
+ */
+IOT_API IOT_SECTION iot_status_t iot_action_request_complete(
+	iot_action_request_t *request,
+	iot_status_t status,
+	const char *message );
+
 /**
  * @brief Returns the value of a action request option
  *
@@ -2056,6 +2143,20 @@ IOT_API IOT_SECTION iot_telemetry_t *iot_telemetry_allocate(
 /**
  * @brief Sets an option value for a telemetry object
  *
+ * The following options reduce the number of samples published for
+ * numeric telemetry (a value of 0 disables the reduction):
+ * - "deadband": publish only if the value changed by more than this amount
+ * - "deadband_percent": publish only if the value changed by more than this
+ *   percentage of the last published value
+ * - "interval_min": minimum number of milliseconds between published samples
+ * - "window": aggregate samples over tumbling windows of this number of
+ *   milliseconds; when a sample falls outside the window, the mean of the
+ *   window is published (along with its min, max, count and last values)
+ *
+ * The "precision" option sets the maximum number of decimal places published
+ * for real samples; without it (or if negative), the fewest digits that read
+ * back as the same value are published.
+ *
  * @param[in,out]  telemetry           telemetry object to set
  * @param[in]      name                attibute name
  * @param[in]      type                type of option data
@@ -2261,13 +2362,43 @@ IOT_API IOT_SECTION iot_status_t iot_telemetry_timestamp_set(
 IOT_API IOT_SECTION iot_timestamp_t iot_timestamp_now( void );
 
 /* transaction */
+/**
+ * @brief Sets a function to call when a transaction completes
+ *
+ * The function is called from the thread that receives the result (so it
+ * should not block), or straight away if the transaction has already
+ * completed.  Only the most recent transactions are tracked (4096 by
+ * default); if the transaction is forgotten before it completes, the
+ * function is called with IOT_STATUS_TIMED_OUT.
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in]      txn                 transaction to follow
+ * @param[in]      func                function to call
+ * @param[in]      user_data           user data passed to the function
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_NOT_FOUND        transaction is unknown or forgotten
+ * @retval IOT_STATUS_SUCCESS          function set (or already called)
+ *
+ * @see iot_transaction_status
+ */
+IOT_API IOT_SECTION iot_status_t iot_transaction_callback_set(
+	iot_t *lib,
+	const iot_transaction_t *txn,
+	iot_transaction_callback_t *func,
+	void *user_data );
+
 /**
  * @brief Determine the status of a transaction
  *
+ * If the transaction is still in progress, waits up to @p max_time_out for
+ * it to complete (if the library is running multi-threaded).
+ *
  * @param[in]      lib                 library handle
  * @param[in]      txn                 transaction to query
- * @param[in]      max_time_out        maximum time to wait for query to be
- *                                     performed
+ * @param[in]      max_time_out        maximum time to wait for the
+ *                                     transaction to complete
+ *                                     (0 = wait indefinitely)
  *
  * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
  * @retval IOT_STATUS_INVOKED          message has been sent/queue no response
@@ -65,6 +65,21 @@ typedef enum iot_json_type
  */
 #define IOT_JSON_FLAG_INDENT(x)        ((x) << IOT_JSON_INDENT_OFFSET)
 
+/**
+ * @brief Encode real numbers with the fewest digits that read back as the
+ *        same double
+ */
+#define IOT_JSON_PRECISION_SHORTEST       (-1)
+/**
+ * @brief Encode real numbers with the fewest digits that read back as the
+ *        same float
+ */
+#define IOT_JSON_PRECISION_SHORTEST_FLOAT (-2)
+/**
+ * @brief Maximum number of decimal places that can be requested
+ */
+#define IOT_JSON_PRECISION_MAX            17
+
 /* BASE SUPPORT */
 #ifndef IOT_STACK_ONLY
 /**
@@ -88,6 +103,85 @@ IOT_API IOT_SECTION void iot_json_allocation_set(
 	iot_json_free_t *fptr );
 #endif /* ifndef IOT_STACK_ONLY */
 
+/**
+ * @brief maximum number of characters written by the iot_json_number_*
+ *        functions
+ */
+#define IOT_JSON_NUMBER_MAX_LEN        32u
+
+/**
+ * @brief formats an integer as a JSON number
+ *
+ * @param[out]     buf                 destination buffer, must hold at least
+ *                                     IOT_JSON_NUMBER_MAX_LEN characters
+ * @param[in]      value               magnitude of the integer
+ * @param[in]      negative            whether the integer is negative
+ *
+ * @return the number of characters written (not null-terminated)
+ *
+ * @see iot_json_number_real
+ */
+IOT_API IOT_SECTION size_t iot_json_number_integer(
+	char *buf,
+	iot_uint64_t value,
+	iot_bool_t negative );
+
+/**
+ * @brief formats a real number as a JSON number
+ *
+ * @param[out]     buf                 destination buffer, must hold at least
+ *                                     IOT_JSON_NUMBER_MAX_LEN characters
+ * @param[in]      value               number to format
+ * @param[in]      precision           maximum number of decimal places, or
+ *                                     IOT_JSON_PRECISION_SHORTEST or
+ *                                     IOT_JSON_PRECISION_SHORTEST_FLOAT
+ *
+ * @return the number of characters written (not null-terminated), 0 if the
+ *         value can't be represented in JSON (NaN or infinity)
+ *
+ * @see iot_json_number_integer
+ */
+IOT_API IOT_SECTION size_t iot_json_number_real(
+	char *buf,
+	iot_float64_t value,
+	int precision );
+
+/**
+ * @brief copies a string, adding JSON escape sequences
+ *
+ * @note the output is not null-terminated and stops before any escape
+ *       sequence that does not completely fit
+ *
+ * @param[out]     dest                destination buffer
+ * @param[in]      src                 source string
+ * @param[in]      src_len             length of the source string
+ * @param[in]      num                 size of the destination buffer
+ *
+ * @return the number of characters written
+ *
+ * @see iot_json_string_escape_len
+ */
+IOT_API IOT_SECTION size_t iot_json_string_escape(
+	char *dest,
+	const char *src,
+	size_t src_len,
+	size_t num );
+
+/**
+ * @brief calculates the length of a string once JSON escape sequences are
+ *        added
+ *
+ * @param[in]      str                 source string
+ * @param[in]      len                 length of the source string
+ *
+ * @return the length of the string including escape sequences
+ *
+ * @see iot_json_string_escape
+ */
+IOT_API IOT_SECTION size_t iot_json_string_escape_len(
+	const char *str,
+	size_t len );
+
 /* DECODE SUPPORT */
 /******************/
 
@@ -112,6 +206,75 @@ typedef void iot_json_array_iterator_t;
 /** @brief Represents an object for iterating through items in a JSON object */
 typedef void iot_json_object_iterator_t;
 
+/** @brief type of destination for a bound item */
+typedef enum iot_json_bind_type
+{
+	/** @brief JSON boolean, into an @c iot_bool_t */
+	IOT_JSON_BIND_BOOL = 0,
+	/** @brief JSON integer, into an @c iot_int64_t */
+	IOT_JSON_BIND_INTEGER,
+	/** @brief JSON integer or real number, into an @c iot_float64_t */
+	IOT_JSON_BIND_REAL,
+	/** @brief JSON string, copied into a @c char array (truncated to fit,
+	 *         always null-terminated) */
+	IOT_JSON_BIND_STRING,
+	/** @brief JSON item of any type, into a @c const iot_json_item_t
+	 *         pointer */
+	IOT_JSON_BIND_ITEM,
+	/** @brief JSON object, its items bound by a table of fields */
+	IOT_JSON_BIND_OBJECT
+} iot_json_bind_type_t;
+
+/** @brief Field is required, binding fails if it is not bound */
+#define IOT_JSON_BIND_REQUIRED         (1)
+/** @brief Maximum number of fields in a table (nested tables count apart) */
+#define IOT_JSON_BIND_MAX              32u
+
+/** @brief Describes an item of a JSON object to bind to a structure */
+typedef struct iot_json_bind
+{
+	/** @brief key of the item in the object */
+	const char *key;
+	/** @brief type of destination */
+	iot_json_bind_type_t type;
+	/** @brief flags for the field (IOT_JSON_BIND_REQUIRED) */
+	unsigned int flags;
+	/** @brief offset of the destination in the structure */
+	size_t offset;
+	/** @brief size of the destination */
+	size_t size;
+	/** @brief fields of a nested object (IOT_JSON_BIND_OBJECT) */
+	const struct iot_json_bind *fields;
+	/** @brief number of fields of a nested object */
+	size_t field_count;
+} iot_json_bind_t;
+
+/**
+ * @brief Declares a field binding an item to a member of a structure
+ *
+ * @param[in]      key                 key of the item in the object
+ * @param[in]      type                type of destination
+ *                                     (iot_json_bind_type_t)
+ * @param[in]      flags               flags for the field
+ * @param[in]      s                   type of the structure
+ * @param[in]      member              member of the structure
+ */
+#define IOT_JSON_BIND_FIELD( key, type, flags, s, member ) \
+	{ (key), (type), (flags), offsetof( s, member ), \
+	  sizeof( ((s *)0)->member ), NULL, 0u }
+
+/**
+ * @brief Declares a field binding the items of a nested object, by a table
+ *        of fields into the same structure
+ *
+ * @param[in]      key                 key of the object
+ * @param[in]      flags               flags for the field
+ * @param[in]      fields              array of fields for the object
+ */
+#define IOT_JSON_BIND_NESTED( key, flags, fields ) \
+	{ (key), IOT_JSON_BIND_OBJECT, (flags), 0u, 0u, (fields), \
+	  sizeof( fields ) / sizeof( (fields)[0] ) }
+
 /**
  * @brief Returns the element in array at position index.
  *
@@ -213,6 +376,37 @@ IOT_API IOT_SECTION size_t iot_json_decode_array_size(
 	const iot_json_decoder_t *decoder,
 	const iot_json_item_t *item );
 
+/**
+ * @brief Binds the items of an object to the members of a structure
+ *
+ * The items of the object are visited once, each item matching the key of a
+ * field in the table is decoded into the structure.  Members for items that
+ * are missing, or of another type, are left unchanged.  Which item is bound
+ * when more than one has the same key depends on the JSON backend.
+ *
+ * @param[in]      decoder             JSON decoder object
+ * @param[in]      object              JSON object to bind
+ * @param[in]      fields              fields to bind
+ * @param[in]      field_count         number of fields (at most
+ *                                     IOT_JSON_BIND_MAX)
+ * @param[in,out]  out                 structure to bind the fields to
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      @c object does not point to a JSON
+ *                                     object
+ * @retval IOT_STATUS_NOT_FOUND        a required field was not bound
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see IOT_JSON_BIND_FIELD
+ * @see IOT_JSON_BIND_NESTED
+ */
+IOT_API IOT_SECTION iot_status_t iot_json_decode_bind(
+	const iot_json_decoder_t *decoder,
+	const iot_json_item_t *object,
+	const iot_json_bind_t *fields,
+	size_t field_count,
+	void *out );
+
 /**
  * @brief Returns the associated boolean value
  *
@@ -472,6 +666,45 @@ IOT_API IOT_SECTION iot_status_t iot_json_decode_parse(
 	char *error,
 	size_t error_len );
 
+/**
+ * @brief Parses a JSON string as it is received, in chunks
+ *
+ * Call this each time more of the document is received, with all of the
+ * document received so far (it may be moved, but the part already given must
+ * not change).  The parse carries on from where the previous call stopped.  A
+ * decoder with a fixed buffer fails if the document needs more room than the
+ * buffer has.
+ *
+ * @param[in]      decoder             JSON decoder object
+ * @param[in]      js                  pointer to the JSON text received so far
+ * @param[in]      len                 length of the JSON text received so far
+ * @param[in]      more                whether more of the document is to be
+ *                                     received
+ * @param[out]     root                the root element, once complete
+ * @param[in,out]  error               error text on failure (optional)
+ * @param[in]      error_len           size of the error string buffer
+ *                                     (optional)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_NO_MEMORY        not enough memory available
+ * @retval IOT_STATUS_PARSE_ERROR      invalid JSON string passed to function,
+ *                                     or incomplete with no more to receive
+ * @retval IOT_STATUS_TRY_AGAIN        document is incomplete, call again once
+ *                                     more is received
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see iot_json_decode_initialize
+ * @see iot_json_decode_parse
+ */
+IOT_API IOT_SECTION iot_status_t iot_json_decode_parse_chunk(
+	iot_json_decoder_t *decoder,
+	const char* js,
+	size_t len,
+	iot_bool_t more,
+	const iot_json_item_t **root,
+	char *error,
+	size_t error_len );
+
 /**
  * @brief Returns the associated real number value
  *
@@ -779,6 +1012,55 @@ IOT_API IOT_SECTION iot_status_t iot_json_encode_real(
 	const char *key,
 	iot_float64_t value );
 
+/**
+ * @brief Encodes a floating-point number with a maximum number of decimal
+ *        places
+ *
+ * @param[in]      encoder             JSON encoder object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               floating-point number
+ * @param[in]      precision           maximum number of decimal places
+ *                                     (0 - IOT_JSON_PRECISION_MAX), or
+ *                                     IOT_JSON_PRECISION_SHORTEST or
+ *                                     IOT_JSON_PRECISION_SHORTEST_FLOAT
+ *
+ * @note @c key should be NULL when not inside a JSON object.  If defining a key
+ * when not inside an JSON object a parent object is generated.  If NULL when
+ * inside a JSON object, a blank key ("") will be used.  Adding an object with
+ * the same key as another item in the object will result in undefined
+ * behaviour.
+ *
+ * @retval IOT_STATUS_FULL             the maximum number of items for the
+ *                                     buffer has been reached
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_NO_MEMORY        no more memory available
+ * @retval IOS_STATUS_SUCCESS          on success
+ *
+ * @see iot_json_encode_real
+ */
+IOT_API IOT_SECTION iot_status_t iot_json_encode_real_precision(
+	iot_json_encoder_t *encoder,
+	const char *key,
+	iot_float64_t value,
+	int precision );
+
+/**
+ * @brief Clears a JSON encoder so it can be used for a new message
+ *
+ * The memory already allocated by the encoder is kept, so encoding messages
+ * of a similar size again does not require any more allocations.
+ *
+ * @param[in,out]  encoder             JSON encoder object
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see iot_json_encode_initialize
+ */
+IOT_API IOT_SECTION iot_status_t iot_json_encode_reset(
+	iot_json_encoder_t *encoder );
+
 /**
  * @brief Encodes a string
  *
@@ -816,6 +1098,33 @@ IOT_API IOT_SECTION iot_status_t iot_json_encode_string(
 IOT_API IOT_SECTION void iot_json_encode_terminate(
 	iot_json_encoder_t *encoder );
 
+/**
+ * @brief Encodes an unsigned integer number
+ *
+ * @param[in]      encoder             JSON encoder object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               unsigned integer number
+ *
+ * @note @c key should be NULL when not inside a JSON object.  If defining a key
+ * when not inside an JSON object a parent object is generated.  If NULL when
+ * inside a JSON object, a blank key ("") will be used.  Adding an object with
+ * the same key as another item in the object will result in undefined
+ * behaviour.
+ *
+ * @retval IOT_STATUS_FULL             the maximum number of items for the
+ *                                     buffer has been reached
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_NO_MEMORY        no more memory available
+ * @retval IOS_STATUS_SUCCESS          on success
+ *
+ * @see iot_json_encode_integer
+ */
+IOT_API IOT_SECTION iot_status_t iot_json_encode_unsigned(
+	iot_json_encoder_t *encoder,
+	const char *key,
+	iot_uint64_t value );
+
 #ifdef __cplusplus
 };
 #endif
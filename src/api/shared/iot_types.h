@@ -22,10 +22,68 @@
 #include "iot_defs.h"
 #include "iot_plugin.h"
 
+#if IOT_LOCK_GROUP_MAX > 32
+#	error "IOT_LOCK_GROUP_MAX is limited to the 32 bits of a lock mask"
+#endif /* if IOT_LOCK_GROUP_MAX > 32 */
+
 /* Flags */
 /** @brief Run in a single thread */
 #define IOT_FLAG_SINGLE_THREAD                   0x01
 
+/** @brief Action request queue lane for high priority actions */
+#define IOT_ACTION_LANE_HIGH                     0u
+/** @brief Action request queue lane for normal priority actions */
+#define IOT_ACTION_LANE_NORMAL                   1u
+/** @brief Action request queue lane for low priority actions */
+#define IOT_ACTION_LANE_LOW                      2u
+/** @brief Number of priority lanes in the action request queue */
+#define IOT_ACTION_LANE_COUNT                    3u
+
+/** @brief Default time an extra worker thread waits for work before it
+ *         exits, in milliseconds */
+#define IOT_WORKER_IDLE_TIME_DEFAULT             60000u
+
+/** @brief Command actions are run through the shell (default) */
+#define IOT_COMMAND_LAUNCH_SHELL                 0u
+/** @brief Command actions without shell syntax are spawned directly */
+#define IOT_COMMAND_LAUNCH_SPAWN                 1u
+/** @brief As IOT_COMMAND_LAUNCH_SPAWN, from a pre-forked helper process */
+#define IOT_COMMAND_LAUNCH_HELPER                2u
+
+#if !defined( _WIN32 ) && !defined( __VXWORKS__ ) && \
+	( !defined( __ANDROID__ ) || __ANDROID_API__ >= 28 )
+/** @brief Commands can be spawned with posix_spawn, without a shell
+ *         (available on Android from API level 28) */
+#	define IOT_SPAWN_SUPPORT
+#endif /* if !defined( _WIN32 ) && !defined( __VXWORKS__ ) &&
+          ( !defined( __ANDROID__ ) || __ANDROID_API__ >= 28 ) */
+
+/** @brief Number of slots in an index holding up to @p max objects */
+#define IOT_INDEX_SIZE( max )                    ( (max) * 2u + 1u )
+
+#ifdef IOT_STACK_ONLY
+/** @brief Returns the list of action pointers of a library handle */
+#	define IOT_ACTION_PTR( lib )                 ( (lib)->action_ptr )
+/** @brief Returns the list of alarm pointers of a library handle */
+#	define IOT_ALARM_PTR( lib )                  ( (lib)->alarm_ptr )
+/** @brief Returns the list of telemetry pointers of a library handle */
+#	define IOT_TELEMETRY_PTR( lib )              ( (lib)->telemetry_ptr )
+/** @brief Number of transactions tracked at once */
+#	define IOT_TRANSACTION_SLOTS                 IOT_TRANSACTION_STACK_MAX
+#else /* ifdef IOT_STACK_ONLY */
+/** @brief Returns the list of action pointers of a library handle */
+#	define IOT_ACTION_PTR( lib ) \
+	( (lib)->action_heap ? (lib)->action_heap : (lib)->action_ptr )
+/** @brief Returns the list of alarm pointers of a library handle */
+#	define IOT_ALARM_PTR( lib ) \
+	( (lib)->alarm_heap ? (lib)->alarm_heap : (lib)->alarm_ptr )
+/** @brief Returns the list of telemetry pointers of a library handle */
+#	define IOT_TELEMETRY_PTR( lib ) \
+	( (lib)->telemetry_heap ? (lib)->telemetry_heap : (lib)->telemetry_ptr )
+/** @brief Number of transactions tracked at once */
+#	define IOT_TRANSACTION_SLOTS                 IOT_TRANSACTION_MAX
+#endif /* else IOT_STACK_ONLY */
+
 /** @brief Type containing information required for file transfer */
 typedef struct iot_file_transfer                 iot_file_transfer_t;
 
@@ -194,6 +252,16 @@ struct iot_action
 	iot_uint8_t parameter_count;
 	/** @brief maximum amount of time to wait before returning failure */
 	iot_millisecond_t time_limit;
+	/** @brief maximum number of requests executing at once
+	 *         (0 = no limit) */
+	iot_uint32_t concurrency_max;
+	/** @brief number of requests currently executing */
+	iot_uint32_t running;
+	/** @brief lock groups the action holds shared, one bit per group */
+	iot_uint32_t lock_shared;
+	/** @brief lock groups the action holds exclusively, one bit per
+	 *         group */
+	iot_uint32_t lock_exclusive;
 #ifdef IOT_STACK_ONLY
 	/** @brief storage of options on the stack
 	 *
@@ -221,6 +289,30 @@ struct iot_action
 #endif /* IOT_STACK_ONLY */
 };
 
+/**
+ * @brief named group of actions that use the same resource
+ */
+struct iot_lock_group
+{
+	/** @brief group name */
+	char name[ IOT_NAME_MAX_LEN + 1u ];
+#ifdef IOT_THREAD_SUPPORT
+	/** @brief lock held by actions in the group while they execute */
+	os_thread_rwlock_t lock;
+#endif /* ifdef IOT_THREAD_SUPPORT */
+};
+
+/** @brief request is not deferred */
+#define IOT_ACTION_REQUEST_DEFERRED_NONE             0u
+/** @brief request is waiting for the application to complete it */
+#define IOT_ACTION_REQUEST_DEFERRED                  1u
+/** @brief time out of the request is being reported */
+#define IOT_ACTION_REQUEST_DEFERRED_EXPIRING         2u
+/** @brief request was completed while its time out was being reported */
+#define IOT_ACTION_REQUEST_DEFERRED_EXPIRING_DONE    3u
+/** @brief time out of the request has been reported */
+#define IOT_ACTION_REQUEST_DEFERRED_EXPIRED          4u
+
 /**
  * @brief an action request from the cloud
  */
@@ -248,7 +340,23 @@ struct iot_action_request
 	iot_millisecond_t time_limit;
 	/** @brief result of the action */
 	iot_status_t result;
+	/** @brief state of a request whose completion is deferred */
+	iot_uint8_t deferred;
+	/** @brief time a deferred request times out (0 if never) */
+	iot_timestamp_t deadline;
+	/** @brief storage for names, arrays and string values of the
+	 *         request, kept when the request slot is recycled */
+	char *arena;
+	/** @brief number of bytes of @c arena in use */
+	size_t arena_used;
+	/** @brief offset of the last block allocated from @c arena */
+	size_t arena_last;
 #ifdef IOT_STACK_ONLY
+	/** @brief storage for @c arena
+	 *
+	 * @note This is not to be used directly, use @c arena instead
+	 */
+	char _arena[ IOT_ACTION_REQUEST_ARENA_SIZE ];
 	/** @brief error message details */
 	char _error[ IOT_NAME_MAX_LEN + 1u ];
 	/** @brief holds value of options */
@@ -265,6 +373,41 @@ struct iot_action_request
 #endif /* IOT_STACK_ONLY */
 };
 
+/**
+ * @brief ring of action requests waiting to be processed
+ */
+struct iot_action_request_ring
+{
+	/** @brief number of requests waiting */
+	iot_uint8_t count;
+	/** @brief index of the oldest request waiting */
+	iot_uint8_t head;
+	/** @brief requests waiting, in order from @c head */
+	struct iot_action_request *request[IOT_ACTION_QUEUE_MAX];
+};
+
+/**
+ * @brief case-insensitive hash index of named objects
+ *
+ * Uses open addressing with linear probing.  The table is kept less than
+ * half full, so a lookup only compares a couple of names.
+ */
+struct iot_index
+{
+	/** @brief number of objects in the index */
+	iot_uint32_t count;
+	/** @brief offset of the name pointer within an indexed object */
+	size_t name_offset;
+	/** @brief number of slots in the table */
+	iot_uint32_t size;
+	/** @brief table of objects (NULL = empty slot) */
+	void **slot;
+#ifndef IOT_STACK_ONLY
+	/** @brief whether the table has been allocated on the heap */
+	iot_bool_t is_in_heap;
+#endif /* ifndef IOT_STACK_ONLY */
+};
+
 /**
  * @brief Alarm information
  */
@@ -332,6 +475,45 @@ struct iot_location
 #endif /* ifdef IOT_STACK_ONLY */
 };
 
+/**
+ * @brief telemetry sample reduction settings and state
+ *
+ * @note settings are taken from the telemetry options: "deadband",
+ *       "deadband_percent", "interval_min" & "window"
+ */
+struct iot_telemetry_reduce
+{
+	/** @brief minimum absolute change to publish a sample (0 = off) */
+	iot_float64_t deadband;
+	/** @brief minimum change as a percentage of the last published
+	 *         value to publish a sample (0 = off) */
+	iot_float64_t deadband_percent;
+	/** @brief minimum time between published samples (0 = off) */
+	iot_millisecond_t interval;
+	/** @brief length of the tumbling aggregation window (0 = off) */
+	iot_millisecond_t window;
+	/** @brief whether a sample has been published */
+	iot_bool_t has_published;
+	/** @brief last published value */
+	iot_float64_t published_value;
+	/** @brief time the last sample was published */
+	iot_timestamp_t published_time;
+	/** @brief number of samples in the current window */
+	iot_uint32_t count;
+	/** @brief last sample in the current window */
+	iot_float64_t last;
+	/** @brief time of the last sample in the current window */
+	iot_timestamp_t last_time;
+	/** @brief largest sample in the current window */
+	iot_float64_t max;
+	/** @brief smallest sample in the current window */
+	iot_float64_t min;
+	/** @brief sum of the samples in the current window */
+	iot_float64_t sum;
+	/** @brief time of the first sample in the current window */
+	iot_timestamp_t window_start;
+};
+
 /**
  * @brief telemetry details
  */
@@ -347,6 +529,12 @@ struct iot_telemetry
 	struct iot_option *option;
 	/** @brief number of options*/
 	iot_uint8_t option_count;
+	/** @brief whether real samples are published with fixed precision */
+	iot_bool_t has_precision;
+	/** @brief maximum decimal places published for real samples */
+	iot_uint8_t precision;
+	/** @brief sample reduction settings and state */
+	struct iot_telemetry_reduce reduce;
 	/** @brief sample time stamp */
 	iot_timestamp_t time_stamp;
 	/** @brief telemetry type */
@@ -417,6 +605,83 @@ struct iot_plugin_enabled
 	iot_plugin_t                *ptr;
 };
 
+/**
+ * @brief telemetry sample waiting to be published by the sender thread
+ */
+struct iot_publish_entry
+{
+	/** @brief sample data (any heap storage is owned by the entry) */
+	struct iot_data data;
+	/** @brief telemetry object the sample is for */
+	struct iot_telemetry *telemetry;
+	/** @brief time the sample was taken */
+	iot_timestamp_t time_stamp;
+	/** @brief transaction id returned to the caller */
+	iot_transaction_t txn;
+};
+
+/**
+ * @brief command to spawn
+ */
+struct iot_spawn_args
+{
+	/** @brief program and its arguments, terminated by NULL */
+	const char *const *argv;
+	/** @brief wait for the command to exit */
+	iot_bool_t block;
+	/** @brief maximum time to wait in milliseconds (0 = indefinitely) */
+	iot_millisecond_t max_time_out;
+	/** @brief buffer for standard output (optional, if blocking) */
+	char *std_out;
+	/** @brief size of the standard output buffer */
+	size_t std_out_len;
+	/** @brief buffer for standard error (optional, if blocking) */
+	char *std_err;
+	/** @brief size of the standard error buffer */
+	size_t std_err_len;
+	/** @brief called with output as it is read, while the command runs
+	 *         (optional, if blocking) */
+	void (*output)( void *user_data, iot_bool_t is_err, const char *buf,
+		size_t len );
+	/** @brief user data passed to the output callback */
+	void *user_data;
+	/** @brief exit code of the command (128 + signal, if killed) */
+	int return_code;
+};
+
+/**
+ * @brief transaction being tracked by the library
+ */
+struct iot_transaction
+{
+	/** @brief transaction id (0 = slot not used) */
+	iot_transaction_t id;
+	/** @brief status of the transaction
+	 *         (@ref IOT_STATUS_INVOKED = still pending) */
+	iot_status_t status;
+	/** @brief a plug-in is waiting for a reply from the cloud */
+	iot_bool_t reply;
+	/** @brief callback to call once the transaction completes */
+	iot_transaction_callback_t *callback;
+	/** @brief user data passed to the callback */
+	void *user_data;
+};
+
+#ifdef IOT_THREAD_SUPPORT
+/**
+ * @brief worker thread handling action requests
+ */
+struct iot_worker
+{
+	/** @brief library handle */
+	struct iot *lib;
+	/** @brief handle to the thread (0 = slot not used) */
+	os_thread_t thread;
+	/** @brief the thread has exited and is waiting to be joined */
+	iot_bool_t exited;
+};
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
 /**
  * @brief library connection details
  */
@@ -425,26 +690,52 @@ struct iot
 	/** @brief registered actions stored on the stack */
 	struct iot_action           action[ IOT_ACTION_STACK_MAX ];
 	/** @brief number of registered actions */
-	iot_uint8_t                 action_count;
+	iot_uint32_t                action_count;
 	/**
 	 * @brief Pointer to which action objects are used or available
 	 *
 	 * @note if the index is < action_count are used.
 	 *       if the index is >= action_count are available for use.
+	 * @note use IOT_ACTION_PTR to access the list, it moves to
+	 *       @c action_heap once it grows beyond IOT_ACTION_MAX items
 	 */
 	struct iot_action           *action_ptr[ IOT_ACTION_MAX ];
+#ifndef IOT_STACK_ONLY
+	/** @brief action pointers, once more than IOT_ACTION_MAX are
+	 *         registered */
+	struct iot_action           **action_heap;
+	/** @brief number of pointers that fit in @c action_heap */
+	iot_uint32_t                action_max;
+#endif /* ifndef IOT_STACK_ONLY */
+	/** @brief index of registered actions by name */
+	struct iot_index            action_index;
+	/**
+	 * @brief storage for @c action_index
+	 *
+	 * @note This is not to be used directly, use @c action_index instead
+	 */
+	void                        *_action_index[
+		IOT_INDEX_SIZE( IOT_ACTION_MAX ) ];
 
 	/** @brief registered alarms stored on the stack */
 	struct iot_alarm            alarm[ IOT_ALARM_STACK_MAX ];
 	/** @brief number of registered alarms */
-	iot_uint8_t                 alarm_count;
+	iot_uint32_t                alarm_count;
 	/**
 	 * @brief Pointer to which alarm objects are used or available
 	 *
 	 * @note if the index is < alarm_count are used.
 	 *       if the index is >= alarm_count are available for use.
+	 * @note use IOT_ALARM_PTR to access the list, it moves to
+	 *       @c alarm_heap once it grows beyond IOT_ALARM_MAX items
 	 */
 	struct iot_alarm            *alarm_ptr[ IOT_ALARM_MAX ];
+#ifndef IOT_STACK_ONLY
+	/** @brief alarm pointers, once more than IOT_ALARM_MAX are registered */
+	struct iot_alarm            **alarm_heap;
+	/** @brief number of pointers that fit in @c alarm_heap */
+	iot_uint32_t                alarm_max;
+#endif /* ifndef IOT_STACK_ONLY */
 
 	/** @brief options lists */
 	struct iot_options          **options;
@@ -476,17 +767,29 @@ struct iot
 	/** @brief registered telemetry stored on the stack */
 	struct iot_telemetry        telemetry[ IOT_TELEMETRY_STACK_MAX ];
 	/** @brief number of registered telemetry */
-	iot_uint8_t                 telemetry_count;
+	iot_uint32_t                telemetry_count;
 	/**
 	 * @brief Pointer to which telemetry objects are used or available
 	 *
 	 * @note if the index is < telemetry_count are used.
 	 *       if the index is >= telemetry_count are available for use.
+	 * @note use IOT_TELEMETRY_PTR to access the list, it moves to
+	 *       @c telemetry_heap once it grows beyond IOT_TELEMETRY_MAX items
 	 */
 	struct iot_telemetry        *telemetry_ptr[ IOT_TELEMETRY_MAX ];
+#ifndef IOT_STACK_ONLY
+	/** @brief telemetry pointers, once more than IOT_TELEMETRY_MAX are
+	 *         registered */
+	struct iot_telemetry        **telemetry_heap;
+	/** @brief number of pointers that fit in @c telemetry_heap */
+	iot_uint32_t                telemetry_max;
+#endif /* ifndef IOT_STACK_ONLY */
 
 	/** @brief number of the lastest transaction */
 	iot_transaction_t           transaction_count;
+	/** @brief transactions being tracked, by id modulo
+	 *         IOT_TRANSACTION_SLOTS (allocated on first use) */
+	struct iot_transaction      *transaction;
 
 	/** @brief about to disconnect & quit */
 	iot_bool_t                  to_quit;
@@ -500,10 +803,27 @@ struct iot
 	struct iot_action_request   *request_queue_free[IOT_ACTION_QUEUE_MAX];
 	/** @brief Number of spaces available to queue action requests */
 	iot_uint8_t                 request_queue_free_count;
-	/** @brief Index of requests waiting for a slot for processing */
-	struct iot_action_request   *request_queue_wait[IOT_ACTION_QUEUE_MAX];
+	/** @brief Requests waiting for a worker, one ring per priority lane */
+	struct iot_action_request_ring request_queue_wait[IOT_ACTION_LANE_COUNT];
 	/** @brief Number of action requests waiting to be processed */
 	iot_uint8_t                 request_queue_wait_count;
+	/** @brief Number of action requests waiting to be completed */
+	iot_uint8_t                 request_deferred_count;
+
+	/** @brief Named lock groups of actions, in the order locks are taken */
+	struct iot_lock_group       lock_group[IOT_LOCK_GROUP_MAX];
+	/** @brief Number of lock groups */
+	iot_uint8_t                 lock_group_count;
+
+	/** @brief How command actions are launched */
+	iot_uint8_t                 command_launch;
+#ifdef IOT_SPAWN_SUPPORT
+	/** @brief Socket to the helper process launching commands
+	 *         (-1 if not running) */
+	int                         spawn_helper_fd;
+	/** @brief Process id of the helper process (0 if not running) */
+	int                         spawn_helper_pid;
+#endif /* ifdef IOT_SPAWN_SUPPORT */
 
 	/* log support */
 	/** @brief Function to call to log a message */
@@ -525,14 +845,61 @@ struct iot
 	os_thread_mutex_t           alarm_mutex;
 
 	/* worker threads */
-	/** @brief Array of all worker threads for handling commands */
-	os_thread_t                 worker_thread[IOT_WORKER_THREADS];
+	/** @brief Pool of worker threads for handling commands */
+	struct iot_worker           worker[IOT_WORKER_THREADS];
+	/** @brief Number of worker threads running */
+	iot_uint32_t                worker_count;
+	/** @brief Number of worker threads waiting for a request */
+	iot_uint32_t                worker_idle;
+	/** @brief Time an extra worker waits for a request before exiting */
+	iot_millisecond_t           worker_idle_time;
+	/** @brief Maximum number of worker threads */
+	iot_uint32_t                worker_max;
+	/** @brief Number of worker threads kept when idle */
+	iot_uint32_t                worker_min;
+	/** @brief Queue depth at which requests other than high priority
+	 *         ones are refused (0 = only when the queue is full) */
+	iot_uint32_t                worker_shed_depth;
 	/** @brief Mutex to protect signal condition variable */
 	os_thread_mutex_t           worker_mutex;
 	/** @brief Signal for waking up waiting threads */
 	os_thread_condition_t       worker_signal;
-	/** @brief Lock for commands which cannot run concurrently */
+	/** @brief Lock for commands which cannot run concurrently with any
+	 *         other command (lock groups narrow this down) */
 	os_thread_rwlock_t          worker_thread_exclusive_lock;
+
+	/* asynchronous publishing */
+	/** @brief Samples waiting to be published by the sender thread */
+	struct iot_publish_entry    *publish_queue;
+	/** @brief Whether producers wait for room when the queue is full */
+	iot_bool_t                  publish_queue_block;
+	/** @brief Number of samples waiting in the queue */
+	iot_uint32_t                publish_queue_count;
+	/** @brief Index of the oldest sample in the queue */
+	iot_uint32_t                publish_queue_head;
+	/** @brief Maximum number of samples in the queue
+	 *         (0 = publish synchronously) */
+	iot_uint32_t                publish_queue_max;
+	/** @brief The sender thread is to publish the queue and exit */
+	iot_bool_t                  publish_queue_quit;
+	/** @brief Mutex to protect the publish queue */
+	os_thread_mutex_t           publish_mutex;
+	/** @brief Signal that the publish queue has changed */
+	os_thread_condition_t       publish_signal;
+	/** @brief Thread draining the publish queue through the plug-ins */
+	os_thread_t                 publish_thread;
+#ifdef IOT_STACK_ONLY
+	/** @brief storage of the publish queue
+	 *
+	 * @note This is not to be used directly, use @c publish_queue instead
+	 */
+	struct iot_publish_entry    _publish_queue[IOT_PUBLISH_QUEUE_MAX];
+#endif /* ifdef IOT_STACK_ONLY */
+
+	/** @brief Mutex to protect the transaction table */
+	os_thread_mutex_t           transaction_mutex;
+	/** @brief Signal that a transaction has completed */
+	os_thread_condition_t       transaction_signal;
 #endif /* ifdef IOT_THREAD_SUPPORT */
 
 #ifdef IOT_STACK_ONLY
@@ -549,6 +916,8 @@ struct iot
 	struct iot_options          _options[ IOT_OPTION_MAX ];
 	/** @brief pointers to the location of option maps */
 	struct iot_options          *_options_ptrs[ IOT_OPTION_MAX ];
+	/** @brief storage for tracked transactions */
+	struct iot_transaction      _transaction[ IOT_TRANSACTION_SLOTS ];
 #endif /* ifdef IOT_STACK_ONLY */
 };
 
@@ -696,6 +1065,19 @@ IOT_API IOT_SECTION iot_status_t iot_action_check(
 	iot_t *lib,
 	iot_millisecond_t max_time_out );
 
+/**
+ * @brief Finds a registered action by name (case-insensitive)
+ *
+ * @param[in]      lib                 library handle
+ * @param[in]      name                name of the action
+ *
+ * @retval NULL                        action not found
+ * @retval !NULL                       action with the name given
+ */
+IOT_API IOT_SECTION iot_action_t *iot_action_find(
+	const iot_t *lib,
+	const char *name );
+
 /**
  * @brief Returns the value of a action option
  *
@@ -752,13 +1134,107 @@ IOT_API IOT_SECTION iot_status_t iot_action_option_get(
  *                                     request to process
  *
  * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to function
+ * @retval IOT_STATUS_NOT_FOUND        no request could be processed
  * @retval IOT_STATUS_SUCCESS          request successfully completed
  * @retval IOT_STATUS_TIMED_OUT        timed out while waiting for request to be
- *                                     processed
+ *                                     processed (or, for a worker beyond the
+ *                                     minimum pool size, for a request to
+ *                                     arrive)
  */
 IOT_API IOT_SECTION iot_status_t iot_action_process( iot_t *lib,
 	iot_millisecond_t max_time_out );
 
+/**
+ * @brief Allocates space from the arena of an action request
+ *
+ * The space lives until the request is freed.  A string allocated here and
+ * then passed to @ref iot_action_request_parameter_set is used in place,
+ * without being copied.
+ *
+ * @param[in,out]  request             action request
+ * @param[in]      size                number of bytes required
+ *
+ * @return a pointer to the space, NULL if the arena does not have room
+ */
+IOT_API IOT_SECTION void *iot_action_request_arena_alloc(
+	iot_action_request_t *request,
+	size_t size );
+
+/**
+ * @brief Reports deferred requests that have passed their time limit
+ *
+ * A time out is sent for each request that was not completed within the
+ * time limit of its action.  The request remains owned by the application
+ * until it calls @ref iot_action_request_complete, which then only frees it.
+ *
+ * @param[in,out]  lib                 library handle
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to function
+ * @retval IOT_STATUS_NOT_FOUND        no deferred request has timed out
+ * @retval IOT_STATUS_SUCCESS          time outs reported
+ */
+IOT_API IOT_SECTION iot_status_t iot_action_request_expire( iot_t *lib );
+
+/**
+ * @brief Starts publishing telemetry samples asynchronously
+ *
+ * Samples are copied into a queue and a sender thread publishes them through
+ * the plug-ins.
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in]      queue_max           maximum number of samples that can
+ *                                     wait to be published
+ *                                     (0 = publish synchronously)
+ * @param[in]      block               whether producers wait for room when
+ *                                     the queue is full, instead of
+ *                                     returning @ref IOT_STATUS_FULL
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FAILURE          failed to start the sender thread
+ * @retval IOT_STATUS_NO_MEMORY        failed to allocate the queue
+ * @retval IOT_STATUS_SUCCESS          on success (or not configured)
+ *
+ * @see iot_telemetry_publish_stop
+ */
+IOT_SECTION iot_status_t iot_telemetry_publish_start(
+	iot_t *lib,
+	iot_uint32_t queue_max,
+	iot_bool_t block );
+
+/**
+ * @brief Publishes any queued telemetry samples and stops the sender thread
+ *
+ * @param[in,out]  lib                 library handle
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see iot_telemetry_publish_start
+ */
+IOT_SECTION iot_status_t iot_telemetry_publish_stop(
+	iot_t *lib );
+
+/**
+ * @brief Publishes the summary of aggregation windows that are pending
+ *
+ * A window is normally closed by the first sample falling outside of it,
+ * this closes the windows of telemetry that has stopped receiving samples.
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in]      force               publish all pending windows, not just
+ *                                     the ones that have expired
+ * @param[in]      max_time_out        maximum time to wait for each window
+ *                                     (0 = wait indefinitely)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_SUCCESS          on success (or nothing to publish)
+ * @retval ...                         status returned by the plug-ins
+ */
+IOT_SECTION iot_status_t iot_telemetry_reduce_flush(
+	iot_t *lib,
+	iot_bool_t force,
+	iot_millisecond_t max_time_out );
+
 /**
  * @brief Returns the value of a telemetry option
  *
@@ -861,7 +1337,7 @@ typedef void (iot_state_callback_t)(
  */
 /** @brief Function will not return (fire and forget) */
 #define IOT_ACTION_NO_RETURN           0x01
-/** @brief Local exclusive lock */
+/** @brief Local exclusive lock (exclusive of all lock groups) */
 #define IOT_ACTION_EXCLUSIVE_APP       0x02
 /** @brief Remote exclusive lock */
 #define IOT_ACTION_EXCLUSIVE_DEVICE    (0x04 | IOT_ACTION_EXCLUSIVE_APP)
@@ -869,6 +1345,12 @@ typedef void (iot_state_callback_t)(
 #define IOT_ACTION_TRUNCATE_SERVICE    0x08
 /** @brief Ignore the time limit */
 #define IOT_ACTION_NO_TIME_LIMIT       0x10
+/** @brief Requests are processed before normal priority ones */
+#define IOT_ACTION_PRIORITY_HIGH       0x20
+/** @brief Requests are processed after normal priority ones */
+#define IOT_ACTION_PRIORITY_LOW        0x40
+/** @brief Output of a command is published as events while it runs */
+#define IOT_ACTION_STREAM_OUTPUT       0x80
 /** @} */
 
 /**
@@ -1086,6 +1568,25 @@ IOT_SECTION iot_status_t iot_loop_stop(
 	iot_t *lib,
 	iot_bool_t force );
 
+/**
+ * @brief Starts another worker thread, unless the pool is at its maximum
+ *
+ * @note The caller must hold @c worker_mutex
+ *
+ * @param[in,out]  lib                 library handle
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FAILURE          failed to start the thread
+ * @retval IOT_STATUS_FULL             maximum number of workers running
+ * @retval IOT_STATUS_NOT_SUPPORTED    library is not compiled with thread
+ *                                     support
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see iot_loop_start
+ */
+IOT_SECTION iot_status_t iot_loop_worker_start(
+	iot_t *lib );
+
 /* helper function for log level setting */
 /**
  * @brief Sets a log level for the service based on a string
@@ -1299,6 +1800,37 @@ IOT_SECTION iot_status_t iot_plugin_perform(
 	const void *new_value,
 	const iot_options_t *options );
 
+/**
+ * @brief triggers all the plug-ins to perform an operation for a transaction
+ *        id that has already been assigned
+ *
+ * @param[in]      lib                 library holding plug-ins
+ * @param[in]      txn                 assigned transaction id (optional)
+ * @param[in,out]  max_time_out        maximum time to wait in milliseconds
+ *                                     (0 = wait indefinitely) (optional),
+ *                                     returns amount of time remaining
+ * @param[in]      op                  operation to perform
+ * @param[in]      item                item operating is being performed on
+ *                                     (optional)
+ * @param[in]      new_value           new value for item, type is based on
+ *                                     @p op (optional)
+ * @param[in]      options             optional options for the plug-in
+ *                                     (optional)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see iot_plugin_perform
+ */
+IOT_SECTION iot_status_t iot_plugin_perform_transaction(
+	iot_t *lib,
+	iot_transaction_t *txn,
+	iot_millisecond_t *max_time_out,
+	iot_operation_t op,
+	const void *item,
+	const void *new_value,
+	const iot_options_t *options );
+
 /**
  * @brief terminates a loaded plug-in
  *
@@ -1323,6 +1855,65 @@ IOT_SECTION iot_status_t iot_plugin_unload(
 	iot_t *lib,
 	const char *name );
 
+/**
+ * @brief Runs a command without a shell
+ *
+ * The command is started with posix_spawn, so the process is not forked, or
+ * by the helper process if it is running.  Standard output and error are
+ * captured into the buffers given, truncated to fit.
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in,out]  args                command to run (return code updated)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FAILURE          failed to start the command
+ * @retval IOT_STATUS_INVOKED          command started, not waited for
+ * @retval IOT_STATUS_NOT_SUPPORTED    spawning is not supported, a command
+ *                                     not waited for needs the helper
+ *                                     process, or the arguments are too long
+ * @retval IOT_STATUS_SUCCESS          command exited, return code is set
+ * @retval IOT_STATUS_TIMED_OUT        command was killed for taking too long
+ *
+ * @see iot_spawn_helper_start
+ */
+IOT_API IOT_SECTION iot_status_t iot_spawn_run(
+	iot_t *lib,
+	struct iot_spawn_args *args );
+
+/**
+ * @brief Starts the helper process that launches commands
+ *
+ * The helper is forked while the process is still small and before worker
+ * threads start, then launches commands on behalf of the library, so the
+ * library process is never forked again.
+ *
+ * @param[in,out]  lib                 library handle
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FAILURE          failed to start the helper
+ * @retval IOT_STATUS_NOT_SUPPORTED    spawning is not supported
+ * @retval IOT_STATUS_SUCCESS          helper is running
+ *
+ * @see iot_spawn_helper_stop
+ */
+IOT_API IOT_SECTION iot_status_t iot_spawn_helper_start(
+	iot_t *lib );
+
+/**
+ * @brief Stops the helper process that launches commands
+ *
+ * Commands it launched keep running.
+ *
+ * @param[in,out]  lib                 library handle
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_SUCCESS          helper is not running
+ *
+ * @see iot_spawn_helper_start
+ */
+IOT_API IOT_SECTION iot_status_t iot_spawn_helper_stop(
+	iot_t *lib );
+
 /**
  * @brief Sets the path to the customized configuration file
  *
@@ -1360,5 +1951,53 @@ IOT_SECTION IOT_API const char *iot_telemetry_name_get(
  */
 IOT_SECTION iot_status_t iot_get_device_uuid( const char *filename,
 	char *buf, size_t len);
+
+/**
+ * @brief Starts tracking a new transaction
+ *
+ * The transaction is pending until its status is set.  Once more than
+ * IOT_TRANSACTION_SLOTS transactions have been started the oldest are
+ * forgotten, and a callback still waiting on one of them is called with
+ * @ref IOT_STATUS_TIMED_OUT.
+ *
+ * @param[in,out]  lib                 library handle
+ *
+ * @return the id of the new transaction (never 0)
+ */
+IOT_API IOT_SECTION iot_transaction_t iot_transaction_allocate(
+	iot_t *lib );
+
+/**
+ * @brief Records the status returned by the plug-ins for a transaction
+ *
+ * A successful transaction stays pending if a plug-in has marked it as
+ * waiting for a reply from the cloud.
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in]      txn                 transaction id
+ * @param[in]      status              status returned by the plug-ins
+ *
+ * @see iot_transaction_status_set
+ */
+IOT_API IOT_SECTION void iot_transaction_finish(
+	iot_t *lib,
+	iot_transaction_t txn,
+	iot_status_t status );
+
+/**
+ * @brief Sets the status of a transaction
+ *
+ * @ref IOT_STATUS_INVOKED marks the transaction as waiting for a reply
+ * from the cloud, any other status completes it and calls its callback.
+ * Transactions that are unknown or already completed are ignored.
+ *
+ * @param[in,out]  lib                 library handle
+ * @param[in]      txn                 transaction id
+ * @param[in]      status              new status of the transaction
+ */
+IOT_API IOT_SECTION void iot_transaction_status_set(
+	iot_t *lib,
+	iot_transaction_t txn,
+	iot_status_t status );
 #endif /* ifndef IOT_TYPES_H */
 
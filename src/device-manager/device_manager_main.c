@@ -501,6 +501,10 @@ iot_status_t device_manager_actions_register(
 				DEVICE_MANAGER_FILE_CLOUD_PARAMETER_FILE_PATH,
 				IOT_PARAMETER_IN, IOT_TYPE_STRING, 0u );
 
+			/* transfers run alongside each other */
+			iot_action_lock_group_add( action->ptr,
+				DEVICE_MANAGER_LOCK_GROUP_FILESYSTEM, IOT_FALSE );
+
 			result = iot_action_register_callback( action->ptr,
 				&device_manager_file_download, device_manager, NULL, 0u );
 
@@ -537,6 +541,9 @@ iot_status_t device_manager_actions_register(
 				DEVICE_MANAGER_FILE_CLOUD_PARAMETER_FILE_PATH,
 				IOT_PARAMETER_IN, IOT_TYPE_STRING, 0u );
 
+			iot_action_lock_group_add( action->ptr,
+				DEVICE_MANAGER_LOCK_GROUP_FILESYSTEM, IOT_FALSE );
+
 			result = iot_action_register_callback( action->ptr,
 				&device_manager_file_upload, device_manager, NULL, 0u );
 			if ( result != IOT_STATUS_SUCCESS )
@@ -674,8 +681,10 @@ iot_status_t device_manager_actions_register(
 		{
 			action->ptr = iot_action_allocate( iot_lib,
 				action->action_name );
-			iot_action_flags_set( action->ptr,
-				IOT_ACTION_EXCLUSIVE_APP );
+			/* only blocks file transfers, while the logs are
+			 * being archived */
+			iot_action_lock_group_add( action->ptr,
+				DEVICE_MANAGER_LOCK_GROUP_FILESYSTEM, IOT_TRUE );
 			result = device_manager_make_control_command( command_path,
 				PATH_MAX, device_manager, " --dump" );
 			if ( result == IOT_STATUS_SUCCESS )
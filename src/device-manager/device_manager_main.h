@@ -47,6 +47,9 @@
 /** @brief Flag to enable remote login related actions */
 #define DEVICE_MANAGER_ENABLE_REMOTE_LOGIN            0x0100
 
+/** @brief Lock group of actions reading or writing the file system */
+#define DEVICE_MANAGER_LOCK_GROUP_FILESYSTEM          "filesystem"
+
 /**
  * @brief Index of various default device manager functions in the global
  *        structure
@@ -24,6 +24,7 @@ iotutils_c_includes := \
 
 iotutils_src_files := \
 	app_arg.c \
+	app_cbor.c \
 	app_config.c \
 	app_log.c \
 	app_path.c \
@@ -31,6 +32,7 @@ iotutils_src_files := \
 	app_json_decode.c \
 	app_json_encode.c \
 	app_json_schema.c \
+	app_json_token.c \
 
 include $(CLEAR_VARS)
 LOCAL_C_INCLUDES := $(iotutils_c_includes)
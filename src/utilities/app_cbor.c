@@ -0,0 +1,777 @@
+/**
+ * @file
+ * @brief source file for IoT library CBOR (RFC 7049) functionality
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "app_cbor.h"
+
+#include <os.h>
+
+/** @brief Maximum nesting of arrays, maps and tags skipped by the decoder */
+#define CBOR_DEPTH_MAX                 32u
+/** @brief Smallest buffer allocated by a dynamic encoder */
+#define CBOR_DYNAMIC_MIN               64u
+/** @brief Exponent bits of a double */
+#define CBOR_DOUBLE_EXPONENT           0x7ff0000000000000uLL
+/** @brief Mantissa bits of a double */
+#define CBOR_DOUBLE_MANTISSA           0x000fffffffffffffuLL
+
+/** @brief major types, in the upper 3 bits of the initial byte */
+enum cbor_major
+{
+	CBOR_MAJOR_UNSIGNED = 0x00,
+	CBOR_MAJOR_NEGATIVE = 0x20,
+	CBOR_MAJOR_BYTES    = 0x40,
+	CBOR_MAJOR_STRING   = 0x60,
+	CBOR_MAJOR_ARRAY    = 0x80,
+	CBOR_MAJOR_MAP      = 0xa0,
+	CBOR_MAJOR_TAG      = 0xc0,
+	CBOR_MAJOR_SIMPLE   = 0xe0
+};
+
+/** @brief additional information values with a special meaning */
+enum cbor_info
+{
+	CBOR_INFO_UINT8      = 24,
+	CBOR_INFO_UINT16     = 25,
+	CBOR_INFO_UINT32     = 26,
+	CBOR_INFO_UINT64     = 27,
+	CBOR_INFO_INDEFINITE = 31
+};
+
+/** @brief simple values and floats (major type 7) */
+enum cbor_simple
+{
+	CBOR_SIMPLE_FALSE     = 0xf4,
+	CBOR_SIMPLE_TRUE      = 0xf5,
+	CBOR_SIMPLE_NULL      = 0xf6,
+	CBOR_SIMPLE_UNDEFINED = 0xf7,
+	CBOR_SIMPLE_FLOAT16   = 0xf9,
+	CBOR_SIMPLE_FLOAT32   = 0xfa,
+	CBOR_SIMPLE_FLOAT64   = 0xfb,
+	CBOR_SIMPLE_BREAK     = 0xff
+};
+
+/**
+ * @brief reads a big-endian unsigned integer
+ *
+ * @param[in]      buf                 buffer to read from
+ * @param[in]      len                 number of bytes to read (1 - 8)
+ *
+ * @return the integer read
+ */
+static iot_uint64_t cbor_decode_be( const iot_uint8_t *buf, size_t len );
+
+/**
+ * @brief converts a half precision float to a double
+ *
+ * @param[in]      half                bits of the half precision float
+ *
+ * @return the value as a double
+ */
+static iot_float64_t cbor_decode_half( iot_uint16_t half );
+
+/**
+ * @brief skips an item and everything it contains
+ *
+ * @param[in,out]  decoder             decoder to read from
+ * @param[in]      item                item header already decoded
+ * @param[in]      depth               current nesting depth
+ *
+ * @retval IOT_STATUS_PARSE_ERROR      malformed, truncated or too deep
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static iot_status_t cbor_decode_skip_depth(
+	app_cbor_decoder_t *decoder,
+	const app_cbor_item_t *item,
+	unsigned int depth );
+
+/**
+ * @brief ensures there is room for more bytes in the output
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      len                 number of bytes to be written
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static iot_status_t cbor_encode_reserve(
+	app_cbor_encoder_t *encoder,
+	size_t len );
+
+/**
+ * @brief writes the initial byte(s) of an item
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      major               major type of the item
+ * @param[in]      value               argument of the item
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static iot_status_t cbor_encode_head(
+	app_cbor_encoder_t *encoder,
+	enum cbor_major major,
+	iot_uint64_t value );
+
+/**
+ * @brief writes a single byte
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      byte                byte to write
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+static iot_status_t cbor_encode_byte(
+	app_cbor_encoder_t *encoder,
+	iot_uint8_t byte );
+
+/* decode */
+iot_uint64_t cbor_decode_be( const iot_uint8_t *buf, size_t len )
+{
+	iot_uint64_t result = 0u;
+	size_t i;
+	for ( i = 0u; i < len; ++i )
+		result = ( result << 8 ) | buf[i];
+	return result;
+}
+
+iot_float64_t cbor_decode_half( iot_uint16_t half )
+{
+	const unsigned int exponent = ( half >> 10 ) & 0x1fu;
+	const unsigned int mantissa = half & 0x3ffu;
+	iot_uint32_t bits = (iot_uint32_t)( half & 0x8000u ) << 16;
+	iot_float32_t result;
+
+	if ( exponent == 0x1fu )
+		/* infinity or NaN */
+		bits |= 0x7f800000u | ( (iot_uint32_t)mantissa << 13 );
+	else if ( exponent != 0u )
+		/* normal: rebias exponent from 15 to 127 */
+		bits |= ( (iot_uint32_t)( exponent + 112u ) << 23 ) |
+			( (iot_uint32_t)mantissa << 13 );
+	else if ( mantissa != 0u )
+	{
+		/* subnormal: normalize for single precision */
+		unsigned int m = mantissa;
+		unsigned int e = 113u;
+		while ( ( m & 0x400u ) == 0u )
+		{
+			m <<= 1;
+			--e;
+		}
+		bits |= ( (iot_uint32_t)e << 23 ) |
+			( (iot_uint32_t)( m & 0x3ffu ) << 13 );
+	}
+	os_memcpy( &result, &bits, sizeof( result ) );
+	return (iot_float64_t)result;
+}
+
+void app_cbor_decode_initialize(
+	app_cbor_decoder_t *decoder,
+	const void *buf,
+	size_t len )
+{
+	if ( decoder )
+	{
+		decoder->buf = (const iot_uint8_t *)buf;
+		decoder->len = buf ? len : 0u;
+		decoder->pos = 0u;
+	}
+}
+
+iot_status_t app_cbor_decode_integer(
+	const app_cbor_item_t *item,
+	iot_int64_t *value )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( item && value )
+	{
+		if ( item->type == APP_CBOR_TYPE_UNSIGNED )
+		{
+			result = IOT_STATUS_OUT_OF_RANGE;
+			if ( item->value.uint64 <= (iot_uint64_t)INT64_MAX )
+			{
+				*value = (iot_int64_t)item->value.uint64;
+				result = IOT_STATUS_SUCCESS;
+			}
+		}
+		else if ( item->type == APP_CBOR_TYPE_NEGATIVE )
+		{
+			*value = item->value.int64;
+			result = IOT_STATUS_SUCCESS;
+		}
+	}
+	return result;
+}
+
+iot_status_t app_cbor_decode_map_find(
+	app_cbor_decoder_t *decoder,
+	const app_cbor_item_t *map,
+	const char *key,
+	app_cbor_item_t *value )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( decoder && map && map->type == APP_CBOR_TYPE_MAP && key && value )
+	{
+		const size_t start = decoder->pos;
+		size_t i;
+		result = IOT_STATUS_NOT_FOUND;
+		for ( i = 0u; result == IOT_STATUS_NOT_FOUND &&
+			( map->count == APP_CBOR_INDEFINITE || i < map->count );
+			++i )
+		{
+			app_cbor_item_t k;
+			iot_status_t status = app_cbor_decode_next( decoder, &k );
+			if ( status != IOT_STATUS_SUCCESS )
+				result = IOT_STATUS_PARSE_ERROR;
+			else if ( k.type == APP_CBOR_TYPE_BREAK )
+				break;
+			else if ( app_cbor_decode_skip( decoder, &k ) !=
+					IOT_STATUS_SUCCESS ||
+				app_cbor_decode_next( decoder, value ) !=
+					IOT_STATUS_SUCCESS )
+				result = IOT_STATUS_PARSE_ERROR;
+			else if ( app_cbor_decode_string_equal( &k, key ) )
+				result = IOT_STATUS_SUCCESS;
+			else if ( app_cbor_decode_skip( decoder, value ) !=
+				IOT_STATUS_SUCCESS )
+				result = IOT_STATUS_PARSE_ERROR;
+		}
+		if ( result != IOT_STATUS_SUCCESS )
+			decoder->pos = start;
+	}
+	return result;
+}
+
+iot_status_t app_cbor_decode_next(
+	app_cbor_decoder_t *decoder,
+	app_cbor_item_t *item )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( decoder && item )
+	{
+		result = IOT_STATUS_NOT_FOUND;
+		if ( decoder->pos < decoder->len )
+		{
+			const iot_uint8_t initial = decoder->buf[decoder->pos];
+			const unsigned int major = initial & 0xe0u;
+			const unsigned int info = initial & 0x1fu;
+			iot_uint64_t arg = info;
+			size_t arg_len = 0u;
+
+			result = IOT_STATUS_SUCCESS;
+			if ( info >= CBOR_INFO_UINT8 && info <= CBOR_INFO_UINT64 )
+				arg_len = (size_t)1u << ( info - CBOR_INFO_UINT8 );
+			else if ( info > CBOR_INFO_UINT64 &&
+				info < CBOR_INFO_INDEFINITE )
+				result = IOT_STATUS_PARSE_ERROR;
+
+			if ( result == IOT_STATUS_SUCCESS &&
+				decoder->len - decoder->pos - 1u < arg_len )
+				result = IOT_STATUS_PARSE_ERROR;
+
+			if ( result == IOT_STATUS_SUCCESS )
+			{
+				if ( arg_len > 0u )
+					arg = cbor_decode_be(
+						&decoder->buf[decoder->pos + 1u],
+						arg_len );
+				decoder->pos += 1u + arg_len;
+				os_memzero( item, sizeof( app_cbor_item_t ) );
+				item->count = 0u;
+
+				switch ( major )
+				{
+				case CBOR_MAJOR_UNSIGNED:
+				case CBOR_MAJOR_NEGATIVE:
+					if ( info == CBOR_INFO_INDEFINITE )
+						result = IOT_STATUS_PARSE_ERROR;
+					else if ( major == CBOR_MAJOR_UNSIGNED )
+					{
+						item->type = APP_CBOR_TYPE_UNSIGNED;
+						item->value.uint64 = arg;
+					}
+					else if ( arg > (iot_uint64_t)INT64_MAX )
+						result = IOT_STATUS_OUT_OF_RANGE;
+					else
+					{
+						/* value is -1 - arg */
+						item->type = APP_CBOR_TYPE_NEGATIVE;
+						item->value.int64 =
+							-1 - (iot_int64_t)arg;
+					}
+					break;
+				case CBOR_MAJOR_BYTES:
+				case CBOR_MAJOR_STRING:
+					item->type = APP_CBOR_TYPE_BYTES;
+					if ( major == CBOR_MAJOR_STRING )
+						item->type = APP_CBOR_TYPE_STRING;
+					if ( info == CBOR_INFO_INDEFINITE )
+						result = IOT_STATUS_NOT_SUPPORTED;
+					else if ( arg > decoder->len - decoder->pos )
+						result = IOT_STATUS_PARSE_ERROR;
+					else
+					{
+						item->count = (size_t)arg;
+						item->value.ptr =
+							&decoder->buf[decoder->pos];
+						decoder->pos += (size_t)arg;
+					}
+					break;
+				case CBOR_MAJOR_ARRAY:
+				case CBOR_MAJOR_MAP:
+					item->type = APP_CBOR_TYPE_ARRAY;
+					if ( major == CBOR_MAJOR_MAP )
+						item->type = APP_CBOR_TYPE_MAP;
+					item->count = (size_t)arg;
+					if ( info == CBOR_INFO_INDEFINITE )
+						item->count = APP_CBOR_INDEFINITE;
+					break;
+				case CBOR_MAJOR_TAG:
+					item->type = APP_CBOR_TYPE_TAG;
+					item->value.uint64 = arg;
+					if ( info == CBOR_INFO_INDEFINITE )
+						result = IOT_STATUS_PARSE_ERROR;
+					break;
+				case CBOR_MAJOR_SIMPLE:
+				default:
+					switch ( initial )
+					{
+					case CBOR_SIMPLE_FALSE:
+					case CBOR_SIMPLE_TRUE:
+						item->type = APP_CBOR_TYPE_BOOL;
+						item->value.boolean =
+							initial == CBOR_SIMPLE_TRUE ?
+							IOT_TRUE : IOT_FALSE;
+						break;
+					case CBOR_SIMPLE_NULL:
+						item->type = APP_CBOR_TYPE_NULL;
+						break;
+					case CBOR_SIMPLE_UNDEFINED:
+						item->type = APP_CBOR_TYPE_UNDEFINED;
+						break;
+					case CBOR_SIMPLE_FLOAT16:
+						item->type = APP_CBOR_TYPE_REAL;
+						item->value.float64 = cbor_decode_half(
+							(iot_uint16_t)arg );
+						break;
+					case CBOR_SIMPLE_FLOAT32:
+					{
+						const iot_uint32_t bits =
+							(iot_uint32_t)arg;
+						iot_float32_t f;
+						os_memcpy( &f, &bits, sizeof( f ) );
+						item->type = APP_CBOR_TYPE_REAL;
+						item->value.float64 =
+							(iot_float64_t)f;
+						break;
+					}
+					case CBOR_SIMPLE_FLOAT64:
+						item->type = APP_CBOR_TYPE_REAL;
+						os_memcpy( &item->value.float64, &arg,
+							sizeof( iot_float64_t ) );
+						break;
+					case CBOR_SIMPLE_BREAK:
+						item->type = APP_CBOR_TYPE_BREAK;
+						break;
+					default:
+						/* unassigned simple values */
+						result = IOT_STATUS_PARSE_ERROR;
+					}
+				}
+			}
+		}
+	}
+	return result;
+}
+
+iot_status_t app_cbor_decode_skip(
+	app_cbor_decoder_t *decoder,
+	const app_cbor_item_t *item )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( decoder && item )
+		result = cbor_decode_skip_depth( decoder, item, 0u );
+	return result;
+}
+
+iot_status_t cbor_decode_skip_depth(
+	app_cbor_decoder_t *decoder,
+	const app_cbor_item_t *item,
+	unsigned int depth )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	size_t remaining = 0u;
+
+	if ( item->type == APP_CBOR_TYPE_ARRAY )
+		remaining = item->count;
+	else if ( item->type == APP_CBOR_TYPE_MAP )
+	{
+		remaining = item->count;
+		if ( remaining != APP_CBOR_INDEFINITE )
+		{
+			if ( remaining > ( APP_CBOR_INDEFINITE - 1u ) / 2u )
+				result = IOT_STATUS_PARSE_ERROR;
+			remaining *= 2u;
+		}
+	}
+	else if ( item->type == APP_CBOR_TYPE_TAG )
+		remaining = 1u;
+
+	if ( remaining > 0u && depth >= CBOR_DEPTH_MAX )
+		result = IOT_STATUS_PARSE_ERROR;
+
+	while ( result == IOT_STATUS_SUCCESS && remaining > 0u )
+	{
+		app_cbor_item_t child;
+		result = app_cbor_decode_next( decoder, &child );
+		if ( result != IOT_STATUS_SUCCESS )
+			result = IOT_STATUS_PARSE_ERROR;
+		else if ( child.type == APP_CBOR_TYPE_BREAK )
+		{
+			/* only valid to end an indefinite array or map */
+			if ( remaining != APP_CBOR_INDEFINITE )
+				result = IOT_STATUS_PARSE_ERROR;
+			remaining = 0u;
+		}
+		else
+		{
+			result = cbor_decode_skip_depth( decoder, &child,
+				depth + 1u );
+			if ( remaining != APP_CBOR_INDEFINITE )
+				--remaining;
+		}
+	}
+	return result;
+}
+
+iot_bool_t app_cbor_decode_string_equal(
+	const app_cbor_item_t *item,
+	const char *str )
+{
+	iot_bool_t result = IOT_FALSE;
+	if ( item && str && item->type == APP_CBOR_TYPE_STRING &&
+		os_strlen( str ) == item->count &&
+		os_memcmp( item->value.ptr, str, item->count ) == 0 )
+		result = IOT_TRUE;
+	return result;
+}
+
+/* encode */
+iot_status_t app_cbor_encode_array_start(
+	app_cbor_encoder_t *encoder,
+	size_t count )
+{
+	iot_status_t result;
+	if ( count == APP_CBOR_INDEFINITE )
+		result = cbor_encode_byte( encoder,
+			CBOR_MAJOR_ARRAY | CBOR_INFO_INDEFINITE );
+	else
+		result = cbor_encode_head( encoder, CBOR_MAJOR_ARRAY,
+			(iot_uint64_t)count );
+	return result;
+}
+
+iot_status_t app_cbor_encode_bool(
+	app_cbor_encoder_t *encoder,
+	iot_bool_t value )
+{
+	return cbor_encode_byte( encoder, value != IOT_FALSE ?
+		CBOR_SIMPLE_TRUE : CBOR_SIMPLE_FALSE );
+}
+
+iot_status_t app_cbor_encode_bytes(
+	app_cbor_encoder_t *encoder,
+	const void *value,
+	size_t len )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( value || len == 0u )
+	{
+		const size_t start = encoder ? encoder->len : 0u;
+		result = cbor_encode_head( encoder, CBOR_MAJOR_BYTES,
+			(iot_uint64_t)len );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_reserve( encoder, len );
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			if ( len > 0u )
+				os_memcpy( &encoder->buf[encoder->len],
+					value, len );
+			encoder->len += len;
+		}
+		else if ( encoder )
+			encoder->len = start;
+	}
+	return result;
+}
+
+iot_status_t app_cbor_encode_end(
+	app_cbor_encoder_t *encoder )
+{
+	return cbor_encode_byte( encoder, CBOR_SIMPLE_BREAK );
+}
+
+void app_cbor_encode_initialize(
+	app_cbor_encoder_t *encoder,
+	void *buf,
+	size_t len,
+	unsigned int flags )
+{
+	if ( encoder )
+	{
+		encoder->buf = (iot_uint8_t *)buf;
+		encoder->len = 0u;
+		encoder->size = buf ? len : 0u;
+		encoder->flags = flags;
+	}
+}
+
+iot_status_t app_cbor_encode_integer(
+	app_cbor_encoder_t *encoder,
+	iot_int64_t value )
+{
+	iot_status_t result;
+	if ( value < 0 )
+		/* encoded as -1 - n */
+		result = cbor_encode_head( encoder, CBOR_MAJOR_NEGATIVE,
+			(iot_uint64_t)( -( value + 1 ) ) );
+	else
+		result = cbor_encode_head( encoder, CBOR_MAJOR_UNSIGNED,
+			(iot_uint64_t)value );
+	return result;
+}
+
+iot_status_t app_cbor_encode_map_start(
+	app_cbor_encoder_t *encoder,
+	size_t count )
+{
+	iot_status_t result;
+	if ( count == APP_CBOR_INDEFINITE )
+		result = cbor_encode_byte( encoder,
+			CBOR_MAJOR_MAP | CBOR_INFO_INDEFINITE );
+	else
+		result = cbor_encode_head( encoder, CBOR_MAJOR_MAP,
+			(iot_uint64_t)count );
+	return result;
+}
+
+iot_status_t app_cbor_encode_null(
+	app_cbor_encoder_t *encoder )
+{
+	return cbor_encode_byte( encoder, CBOR_SIMPLE_NULL );
+}
+
+iot_status_t app_cbor_encode_real(
+	app_cbor_encoder_t *encoder,
+	iot_float64_t value )
+{
+	iot_status_t result = cbor_encode_reserve( encoder, 9u );
+	if ( result == IOT_STATUS_SUCCESS )
+	{
+		iot_uint8_t *const out = &encoder->buf[encoder->len];
+		const iot_float32_t single = (iot_float32_t)value;
+		const iot_float64_t widened = (iot_float64_t)single;
+		iot_uint64_t bits;
+		iot_uint64_t widened_bits;
+		size_t len;
+		size_t i;
+
+		/* compare bits, so NaN (sent as single) is also matched */
+		os_memcpy( &bits, &value, sizeof( bits ) );
+		os_memcpy( &widened_bits, &widened, sizeof( widened_bits ) );
+		if ( bits == widened_bits ||
+			( ( bits & CBOR_DOUBLE_EXPONENT ) == CBOR_DOUBLE_EXPONENT &&
+			  ( bits & CBOR_DOUBLE_MANTISSA ) != 0u ) )
+		{
+			iot_uint32_t bits32;
+			os_memcpy( &bits32, &single, sizeof( bits32 ) );
+			bits = bits32;
+			len = 4u;
+			out[0] = CBOR_SIMPLE_FLOAT32;
+		}
+		else
+		{
+			len = 8u;
+			out[0] = CBOR_SIMPLE_FLOAT64;
+		}
+		for ( i = len; i > 0u; --i )
+		{
+			out[i] = (iot_uint8_t)( bits & 0xffu );
+			bits >>= 8;
+		}
+		encoder->len += len + 1u;
+	}
+	return result;
+}
+
+void app_cbor_encode_reset(
+	app_cbor_encoder_t *encoder )
+{
+	if ( encoder )
+		encoder->len = 0u;
+}
+
+iot_status_t app_cbor_encode_string(
+	app_cbor_encoder_t *encoder,
+	const char *value )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( value )
+	{
+		const size_t len = os_strlen( value );
+		const size_t start = encoder ? encoder->len : 0u;
+		result = cbor_encode_head( encoder, CBOR_MAJOR_STRING,
+			(iot_uint64_t)len );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = cbor_encode_reserve( encoder, len );
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			os_memcpy( &encoder->buf[encoder->len], value, len );
+			encoder->len += len;
+		}
+		else if ( encoder )
+			encoder->len = start;
+	}
+	return result;
+}
+
+iot_status_t app_cbor_encode_tag(
+	app_cbor_encoder_t *encoder,
+	iot_uint64_t tag )
+{
+	return cbor_encode_head( encoder, CBOR_MAJOR_TAG, tag );
+}
+
+void app_cbor_encode_terminate(
+	app_cbor_encoder_t *encoder )
+{
+#if !defined( IOT_STACK_ONLY )
+	if ( encoder && ( encoder->flags & APP_CBOR_FLAG_DYNAMIC ) )
+	{
+		os_free_null( (void **)&encoder->buf );
+		encoder->size = 0u;
+		encoder->len = 0u;
+	}
+#else /* if !defined( IOT_STACK_ONLY ) */
+	(void)encoder;
+#endif /* else if !defined( IOT_STACK_ONLY ) */
+}
+
+iot_status_t app_cbor_encode_unsigned(
+	app_cbor_encoder_t *encoder,
+	iot_uint64_t value )
+{
+	return cbor_encode_head( encoder, CBOR_MAJOR_UNSIGNED, value );
+}
+
+iot_status_t cbor_encode_byte(
+	app_cbor_encoder_t *encoder,
+	iot_uint8_t byte )
+{
+	iot_status_t result = cbor_encode_reserve( encoder, 1u );
+	if ( result == IOT_STATUS_SUCCESS )
+		encoder->buf[encoder->len++] = byte;
+	return result;
+}
+
+iot_status_t cbor_encode_head(
+	app_cbor_encoder_t *encoder,
+	enum cbor_major major,
+	iot_uint64_t value )
+{
+	size_t len = 0u;
+	unsigned int info = (unsigned int)value;
+	iot_status_t result;
+
+	/* use the shortest form that holds the value */
+	if ( value > 0xffffffffu )
+	{
+		info = CBOR_INFO_UINT64;
+		len = 8u;
+	}
+	else if ( value > 0xffffu )
+	{
+		info = CBOR_INFO_UINT32;
+		len = 4u;
+	}
+	else if ( value > 0xffu )
+	{
+		info = CBOR_INFO_UINT16;
+		len = 2u;
+	}
+	else if ( value >= CBOR_INFO_UINT8 )
+	{
+		info = CBOR_INFO_UINT8;
+		len = 1u;
+	}
+
+	result = cbor_encode_reserve( encoder, len + 1u );
+	if ( result == IOT_STATUS_SUCCESS )
+	{
+		iot_uint8_t *const out = &encoder->buf[encoder->len];
+		size_t i;
+		out[0] = (iot_uint8_t)( (unsigned int)major | info );
+		for ( i = len; i > 0u; --i )
+		{
+			out[i] = (iot_uint8_t)( value & 0xffu );
+			value >>= 8;
+		}
+		encoder->len += len + 1u;
+	}
+	return result;
+}
+
+iot_status_t cbor_encode_reserve(
+	app_cbor_encoder_t *encoder,
+	size_t len )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( encoder )
+	{
+		result = IOT_STATUS_SUCCESS;
+		if ( len > encoder->size - encoder->len )
+		{
+			result = IOT_STATUS_FULL;
+#if !defined( IOT_STACK_ONLY )
+			if ( encoder->flags & APP_CBOR_FLAG_DYNAMIC )
+			{
+				/* grow geometrically */
+				size_t new_size = encoder->size * 2u;
+				iot_uint8_t *new_buf;
+				if ( new_size < CBOR_DYNAMIC_MIN )
+					new_size = CBOR_DYNAMIC_MIN;
+				if ( new_size < encoder->len + len )
+					new_size = encoder->len + len;
+				new_buf = os_realloc( encoder->buf, new_size );
+				if ( new_buf )
+				{
+					encoder->buf = new_buf;
+					encoder->size = new_size;
+					result = IOT_STATUS_SUCCESS;
+				}
+				else
+					result = IOT_STATUS_NO_MEMORY;
+			}
+#endif /* if !defined( IOT_STACK_ONLY ) */
+		}
+	}
+	return result;
+}
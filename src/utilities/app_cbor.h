@@ -0,0 +1,417 @@
+/**
+ * @file
+ * @brief Header file for CBOR (RFC 7049) operations within the IoT library
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+#ifndef APP_CBOR_H
+#define APP_CBOR_H
+
+#include "iot.h"    /* for iot_status_t */
+
+#include <stddef.h> /* for size_t */
+
+#ifdef __cplusplus
+extern C {
+#endif
+
+/** @brief Number of items for an array or map of indefinite length */
+#define APP_CBOR_INDEFINITE            ((size_t)-1)
+
+#if !defined( IOT_STACK_ONLY )
+/**
+ * @brief Grow the output buffer using dynamic memory as required
+ */
+#define APP_CBOR_FLAG_DYNAMIC          (1)
+#endif /* if !defined( IOT_STACK_ONLY ) */
+
+/** @brief type of a decoded cbor item */
+typedef enum app_cbor_type
+{
+	APP_CBOR_TYPE_UNSIGNED = 0,  /**< @brief unsigned integer */
+	APP_CBOR_TYPE_NEGATIVE,      /**< @brief negative integer */
+	APP_CBOR_TYPE_BYTES,         /**< @brief byte string */
+	APP_CBOR_TYPE_STRING,        /**< @brief UTF-8 text string */
+	APP_CBOR_TYPE_ARRAY,         /**< @brief start of an array */
+	APP_CBOR_TYPE_MAP,           /**< @brief start of a map */
+	APP_CBOR_TYPE_TAG,           /**< @brief tag for the next item */
+	APP_CBOR_TYPE_BOOL,          /**< @brief true or false */
+	APP_CBOR_TYPE_NULL,          /**< @brief null */
+	APP_CBOR_TYPE_UNDEFINED,     /**< @brief undefined */
+	APP_CBOR_TYPE_REAL,          /**< @brief half, single or double float */
+	APP_CBOR_TYPE_BREAK          /**< @brief end of an indefinite item */
+} app_cbor_type_t;
+
+/** @brief streaming cbor encoder, items are written as they are added */
+typedef struct app_cbor_encoder
+{
+	/** @brief output buffer */
+	iot_uint8_t *buf;
+	/** @brief number of bytes written */
+	size_t len;
+	/** @brief size of the output buffer */
+	size_t size;
+	/** @brief encoder flags */
+	unsigned int flags;
+} app_cbor_encoder_t;
+
+/** @brief cbor decoder, reads items in order from a buffer */
+typedef struct app_cbor_decoder
+{
+	/** @brief buffer being decoded */
+	const iot_uint8_t *buf;
+	/** @brief length of the buffer */
+	size_t len;
+	/** @brief offset of the next item */
+	size_t pos;
+} app_cbor_decoder_t;
+
+/** @brief a decoded cbor item */
+typedef struct app_cbor_item
+{
+	/** @brief type of the item */
+	app_cbor_type_t type;
+	/**
+	 * @brief number of items in an array, pairs in a map or bytes in a
+	 *        string (APP_CBOR_INDEFINITE for indefinite arrays and maps)
+	 */
+	size_t count;
+	/** @brief value of the item */
+	union
+	{
+		/** @brief boolean value */
+		iot_bool_t boolean;
+		/** @brief value of an unsigned integer or tag */
+		iot_uint64_t uint64;
+		/** @brief value of a negative integer */
+		iot_int64_t int64;
+		/** @brief value of a real number */
+		iot_float64_t float64;
+		/** @brief contents of a byte or text string (not terminated) */
+		const void *ptr;
+	} value;
+} app_cbor_item_t;
+
+/* DECODE SUPPORT */
+/******************/
+
+/**
+ * @brief Sets up a decoder for a buffer
+ *
+ * @param[out]     decoder             decoder to set up
+ * @param[in]      buf                 buffer to decode
+ * @param[in]      len                 length of the buffer
+ */
+void app_cbor_decode_initialize(
+	app_cbor_decoder_t *decoder,
+	const void *buf,
+	size_t len );
+
+/**
+ * @brief Decodes a signed integer (major type 0 or 1)
+ *
+ * @param[in]      item                decoded item
+ * @param[out]     value               integer value
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    item is not an integer
+ * @retval IOT_STATUS_OUT_OF_RANGE     value does not fit in a 64-bit integer
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t app_cbor_decode_integer(
+	const app_cbor_item_t *item,
+	iot_int64_t *value );
+
+/**
+ * @brief Searches the map the decoder is positioned in for a text key
+ *
+ * On success the decoder is positioned after the header of the value.
+ * Otherwise the decoder position is unchanged.
+ *
+ * @param[in,out]  decoder             decoder positioned just after the map
+ *                                     header
+ * @param[in]      map                 decoded map header
+ * @param[in]      key                 key to search for
+ * @param[out]     value               header of the value found
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_NOT_FOUND        key not found in the map
+ * @retval IOT_STATUS_PARSE_ERROR      malformed cbor data
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t app_cbor_decode_map_find(
+	app_cbor_decoder_t *decoder,
+	const app_cbor_item_t *map,
+	const char *key,
+	app_cbor_item_t *value );
+
+/**
+ * @brief Decodes the header of the next item
+ *
+ * Byte and text strings are returned whole.  For arrays, maps and tags the
+ * decoder is positioned at their first contained item.
+ *
+ * @param[in,out]  decoder             decoder to read from
+ * @param[out]     item                decoded item
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_NOT_FOUND        no more items in the buffer
+ * @retval IOT_STATUS_NOT_SUPPORTED    indefinite length strings
+ * @retval IOT_STATUS_PARSE_ERROR      malformed or truncated cbor data
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t app_cbor_decode_next(
+	app_cbor_decoder_t *decoder,
+	app_cbor_item_t *item );
+
+/**
+ * @brief Skips the contents of an item whose header was just decoded
+ *
+ * Items contained in arrays, maps and tags are skipped, so the decoder is
+ * positioned at the item following @p item.
+ *
+ * @param[in,out]  decoder             decoder to read from
+ * @param[in]      item                item header returned by
+ *                                     app_cbor_decode_next
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_PARSE_ERROR      malformed or truncated cbor data
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t app_cbor_decode_skip(
+	app_cbor_decoder_t *decoder,
+	const app_cbor_item_t *item );
+
+/**
+ * @brief Compares a decoded text string item with a string
+ *
+ * @param[in]      item                decoded item
+ * @param[in]      str                 null-terminated string to compare
+ *
+ * @retval IOT_TRUE                    item is a text string equal to @p str
+ * @retval IOT_FALSE                   otherwise
+ */
+iot_bool_t app_cbor_decode_string_equal(
+	const app_cbor_item_t *item,
+	const char *str );
+
+/* ENCODE SUPPORT */
+/******************/
+
+/**
+ * @brief Starts an array
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      count               number of items in the array or
+ *                                     APP_CBOR_INDEFINITE
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see app_cbor_encode_end
+ */
+iot_status_t app_cbor_encode_array_start(
+	app_cbor_encoder_t *encoder,
+	size_t count );
+
+/**
+ * @brief Encodes a true or false value
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      value               value to write
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t app_cbor_encode_bool(
+	app_cbor_encoder_t *encoder,
+	iot_bool_t value );
+
+/**
+ * @brief Encodes a byte string
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      value               bytes to write
+ * @param[in]      len                 number of bytes to write
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t app_cbor_encode_bytes(
+	app_cbor_encoder_t *encoder,
+	const void *value,
+	size_t len );
+
+/**
+ * @brief Ends an array or map of indefinite length
+ *
+ * @param[in,out]  encoder             encoder to write to
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see app_cbor_encode_array_start
+ * @see app_cbor_encode_map_start
+ */
+iot_status_t app_cbor_encode_end(
+	app_cbor_encoder_t *encoder );
+
+/**
+ * @brief Sets up an encoder
+ *
+ * @param[out]     encoder             encoder to set up
+ * @param[in]      buf                 output buffer (NULL with
+ *                                     APP_CBOR_FLAG_DYNAMIC to allocate one)
+ * @param[in]      len                 size of the output buffer
+ * @param[in]      flags               encoder flags
+ *
+ * @see app_cbor_encode_terminate
+ */
+void app_cbor_encode_initialize(
+	app_cbor_encoder_t *encoder,
+	void *buf,
+	size_t len,
+	unsigned int flags );
+
+/**
+ * @brief Encodes a signed integer
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      value               value to write
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see app_cbor_encode_unsigned
+ */
+iot_status_t app_cbor_encode_integer(
+	app_cbor_encoder_t *encoder,
+	iot_int64_t value );
+
+/**
+ * @brief Starts a map, keys and values are then added in turn
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      count               number of key/value pairs in the map or
+ *                                     APP_CBOR_INDEFINITE
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see app_cbor_encode_end
+ */
+iot_status_t app_cbor_encode_map_start(
+	app_cbor_encoder_t *encoder,
+	size_t count );
+
+/**
+ * @brief Encodes a null value
+ *
+ * @param[in,out]  encoder             encoder to write to
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t app_cbor_encode_null(
+	app_cbor_encoder_t *encoder );
+
+/**
+ * @brief Encodes a real number
+ *
+ * The value is written as a single precision float if that holds it
+ * exactly, otherwise as a double.
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      value               value to write
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t app_cbor_encode_real(
+	app_cbor_encoder_t *encoder,
+	iot_float64_t value );
+
+/**
+ * @brief Rewinds an encoder to write a new message, keeping its buffer
+ *
+ * @param[in,out]  encoder             encoder to rewind
+ */
+void app_cbor_encode_reset(
+	app_cbor_encoder_t *encoder );
+
+/**
+ * @brief Encodes a text string
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      value               null-terminated string to write
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t app_cbor_encode_string(
+	app_cbor_encoder_t *encoder,
+	const char *value );
+
+/**
+ * @brief Encodes a tag for the item that follows
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      tag                 tag number
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ */
+iot_status_t app_cbor_encode_tag(
+	app_cbor_encoder_t *encoder,
+	iot_uint64_t tag );
+
+/**
+ * @brief Frees any memory allocated by an encoder
+ *
+ * @param[in,out]  encoder             encoder to free
+ *
+ * @see app_cbor_encode_initialize
+ */
+void app_cbor_encode_terminate(
+	app_cbor_encoder_t *encoder );
+
+/**
+ * @brief Encodes an unsigned integer
+ *
+ * @param[in,out]  encoder             encoder to write to
+ * @param[in]      value               value to write
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_FULL             output buffer is full
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see app_cbor_encode_integer
+ */
+iot_status_t app_cbor_encode_unsigned(
+	app_cbor_encoder_t *encoder,
+	iot_uint64_t value );
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* ifndef APP_CBOR_H */
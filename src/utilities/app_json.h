@@ -67,6 +67,21 @@ typedef enum app_json_type
  */
 #define APP_JSON_FLAG_INDENT(x)        ((x) << APP_JSON_INDENT_OFFSET)
 
+/**
+ * @brief Encode real numbers with the fewest digits that read back as the
+ *        same double
+ */
+#define APP_JSON_PRECISION_SHORTEST       (-1)
+/**
+ * @brief Encode real numbers with the fewest digits that read back as the
+ *        same float
+ */
+#define APP_JSON_PRECISION_SHORTEST_FLOAT (-2)
+/**
+ * @brief Maximum number of decimal places that can be requested
+ */
+#define APP_JSON_PRECISION_MAX            17
+
 /* BASE SUPPORT */
 #if !defined( IOT_STACK_ONLY )
 /**
@@ -114,6 +129,75 @@ typedef void app_json_array_iterator_t;
 /** @brief Represents an object for iterating through items in a JSON object */
 typedef void app_json_object_iterator_t;
 
+/** @brief type of destination a JSON item is bound to */
+typedef enum app_json_bind_type
+{
+	/** @brief JSON boolean, into an @c iot_bool_t */
+	APP_JSON_BIND_BOOL = 0,
+	/** @brief JSON integer, into an @c iot_int64_t */
+	APP_JSON_BIND_INTEGER,
+	/** @brief JSON integer or real number, into an @c iot_float64_t */
+	APP_JSON_BIND_REAL,
+	/** @brief JSON string, copied into a @c char array (truncated to fit,
+	 *         always null-terminated) */
+	APP_JSON_BIND_STRING,
+	/** @brief JSON item of any type, into a @c const app_json_item_t
+	 *         pointer */
+	APP_JSON_BIND_ITEM,
+	/** @brief JSON object, its items bound by a table of fields */
+	APP_JSON_BIND_OBJECT
+} app_json_bind_type_t;
+
+/** @brief Field is required, binding fails if it is not bound */
+#define APP_JSON_BIND_REQUIRED         (1)
+/** @brief Maximum number of fields in a table (nested tables count apart) */
+#define APP_JSON_BIND_MAX              32u
+
+/** @brief Describes an item of a JSON object to bind to a structure */
+typedef struct app_json_bind
+{
+	/** @brief key of the item in the object */
+	const char *key;
+	/** @brief type of destination */
+	app_json_bind_type_t type;
+	/** @brief flags for the field (APP_JSON_BIND_REQUIRED) */
+	unsigned int flags;
+	/** @brief offset of the destination in the structure */
+	size_t offset;
+	/** @brief size of the destination */
+	size_t size;
+	/** @brief fields of a nested object (APP_JSON_BIND_OBJECT) */
+	const struct app_json_bind *fields;
+	/** @brief number of fields of a nested object */
+	size_t field_count;
+} app_json_bind_t;
+
+/**
+ * @brief Declares a field binding an item to a member of a structure
+ *
+ * @param[in]      key                 key of the item in the object
+ * @param[in]      type                type of destination
+ *                                     (app_json_bind_type_t)
+ * @param[in]      flags               flags for the field
+ * @param[in]      s                   type of the structure
+ * @param[in]      member              member of the structure
+ */
+#define APP_JSON_BIND_FIELD( key, type, flags, s, member ) \
+	{ (key), (type), (flags), offsetof( s, member ), \
+	  sizeof( ((s *)0)->member ), NULL, 0u }
+
+/**
+ * @brief Declares a field binding the items of a nested object, by a table
+ *        of fields into the same structure
+ *
+ * @param[in]      key                 key of the object
+ * @param[in]      flags               flags for the field
+ * @param[in]      fields              array of fields for the object
+ */
+#define APP_JSON_BIND_NESTED( key, flags, fields ) \
+	{ (key), APP_JSON_BIND_OBJECT, (flags), 0u, 0u, (fields), \
+	  sizeof( fields ) / sizeof( (fields)[0] ) }
+
 /**
  * @brief Returns the element in array at position index.
  *
@@ -215,6 +299,40 @@ size_t app_json_decode_array_size(
 	const app_json_decoder_t *decoder,
 	const app_json_item_t *item );
 
+/**
+ * @brief Binds the items of an object to the members of a structure
+ *
+ * The items of the object are visited once, each item matching the key of a
+ * field in the table is decoded into the structure.  Members for items that
+ * are missing, or of another type, are left unchanged.  Which item is bound
+ * when more than one has the same key depends on the JSON backend (jansson
+ * and json-c keep only the last, the built-in parser binds the first).  A
+ * table can have more than one field for the same key (for example, to bind
+ * a nested object and a pointer to it).
+ *
+ * @param[in]      decoder             JSON decoder object
+ * @param[in]      object              JSON object to bind
+ * @param[in]      fields              fields to bind
+ * @param[in]      field_count         number of fields (at most
+ *                                     APP_JSON_BIND_MAX)
+ * @param[in,out]  out                 structure to bind the fields to
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      @c object does not point to a JSON
+ *                                     object
+ * @retval IOT_STATUS_NOT_FOUND        a required field was not bound
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see APP_JSON_BIND_FIELD
+ * @see APP_JSON_BIND_NESTED
+ */
+iot_status_t app_json_decode_bind(
+	const app_json_decoder_t *decoder,
+	const app_json_item_t *object,
+	const app_json_bind_t *fields,
+	size_t field_count,
+	void *out );
+
 /**
  * @brief Returns the associated boolean value
  *
@@ -474,6 +592,49 @@ iot_status_t app_json_decode_parse(
 	char *error,
 	size_t error_len );
 
+/**
+ * @brief Parses a JSON string as it is received, in chunks
+ *
+ * Call this each time more of the document is received, with all of the
+ * document received so far (it may be moved, but the part already given must
+ * not change).  The parse carries on from where the previous call stopped, so
+ * the document is never parsed again from the start.  A decoder with a fixed
+ * buffer fails if the document needs more tokens than fit in the buffer; one
+ * using dynamic memory grows its tokens as needed.
+ *
+ * @note a document being parsed in chunks is carried on with until it is
+ * complete or fails to parse, or app_json_decode_parse is called
+ *
+ * @param[in]      decoder             JSON decoder object
+ * @param[in]      js                  pointer to the JSON text received so far
+ * @param[in]      len                 length of the JSON text received so far
+ * @param[in]      more                whether more of the document is to be
+ *                                     received
+ * @param[out]     root                the root element, once complete
+ * @param[in,out]  error               error text on failure (optional)
+ * @param[in]      error_len           size of the error string buffer
+ *                                     (optional)
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    invalid parameter passed to the function
+ * @retval IOT_STATUS_NO_MEMORY        not enough memory available
+ * @retval IOT_STATUS_PARSE_ERROR      invalid JSON string passed to function,
+ *                                     or incomplete with no more to receive
+ * @retval IOT_STATUS_TRY_AGAIN        document is incomplete, call again once
+ *                                     more is received
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see app_json_decode_initialize
+ * @see app_json_decode_parse
+ */
+iot_status_t app_json_decode_parse_chunk(
+	app_json_decoder_t *decoder,
+	const char* js,
+	size_t len,
+	iot_bool_t more,
+	const app_json_item_t **root,
+	char *error,
+	size_t error_len );
+
 /**
  * @brief Returns the associated real number value
  *
@@ -781,6 +942,55 @@ iot_status_t app_json_encode_real(
 	const char *key,
 	iot_float64_t value );
 
+/**
+ * @brief Encodes a floating-point number with a maximum number of decimal
+ *        places
+ *
+ * @param[in]      encoder             JSON encoder object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               floating-point number
+ * @param[in]      precision           maximum number of decimal places
+ *                                     (0 - APP_JSON_PRECISION_MAX), or
+ *                                     APP_JSON_PRECISION_SHORTEST or
+ *                                     APP_JSON_PRECISION_SHORTEST_FLOAT
+ *
+ * @note @c key should be NULL when not inside a JSON object.  If defining a key
+ * when not inside an JSON object a parent object is generated.  If NULL when
+ * inside a JSON object, a blank key ("") will be used.  Adding an object with
+ * the same key as another item in the object will result in undefined
+ * behaviour.
+ *
+ * @retval IOT_STATUS_FULL             the maximum number of items for the
+ *                                     buffer has been reached
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_NO_MEMORY        no more memory available
+ * @retval IOS_STATUS_SUCCESS          on success
+ *
+ * @see app_json_encode_real
+ */
+iot_status_t app_json_encode_real_precision(
+	app_json_encoder_t *encoder,
+	const char *key,
+	iot_float64_t value,
+	int precision );
+
+/**
+ * @brief Clears a JSON encoder so it can be used for a new message
+ *
+ * The memory already allocated by the encoder is kept, so encoding messages
+ * of a similar size again does not require any more allocations.
+ *
+ * @param[in,out]  encoder             JSON encoder object
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see app_json_encode_initialize
+ */
+iot_status_t app_json_encode_reset(
+	app_json_encoder_t *encoder );
+
 /**
  * @brief Encodes a string
  *
@@ -818,6 +1028,352 @@ iot_status_t app_json_encode_string(
 void app_json_encode_terminate(
 	app_json_encoder_t *encoder );
 
+/**
+ * @brief Encodes an unsigned integer number
+ *
+ * @param[in]      encoder             JSON encoder object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               unsigned integer number
+ *
+ * @note @c key should be NULL when not inside a JSON object.  If defining a key
+ * when not inside an JSON object a parent object is generated.  If NULL when
+ * inside a JSON object, a blank key ("") will be used.  Adding an object with
+ * the same key as another item in the object will result in undefined
+ * behaviour.
+ *
+ * @retval IOT_STATUS_FULL             the maximum number of items for the
+ *                                     buffer has been reached
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_NO_MEMORY        no more memory available
+ * @retval IOS_STATUS_SUCCESS          on success
+ *
+ * @see app_json_encode_integer
+ */
+iot_status_t app_json_encode_unsigned(
+	app_json_encoder_t *encoder,
+	const char *key,
+	iot_uint64_t value );
+
+
+/* STREAM SUPPORT */
+/********************/
+/** @brief Represents a JSON stream object */
+typedef struct app_json_stream app_json_stream_t;
+
+/**
+ * @brief Function called to write the output of a JSON stream
+ *
+ * @param[in]      user_data           user data given when initializing
+ * @param[in]      data                characters to write (not
+ *                                     null-terminated)
+ * @param[in]      len                 number of characters to write
+ *
+ * @retval IOT_STATUS_SUCCESS          all characters were written, any other
+ *                                     value stops the stream
+ */
+typedef iot_status_t (*app_json_stream_sink_t)( void *user_data,
+	const char *data, size_t len );
+
+/**
+ * @brief Default size of the output buffer of a JSON stream using dynamic
+ *        memory
+ */
+#define APP_JSON_STREAM_BUFFER_DEFAULT 1024u
+
+/**
+ * @brief Ends the encoding of a JSON array in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      not inside an JSON array object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_array_start
+ */
+iot_status_t app_json_stream_array_end(
+	app_json_stream_t *stream );
+
+/**
+ * @brief Starts the encoding of a new JSON array in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ * @param[in]      key                 (optional) parent JSON object key
+ *
+ * @note @c key should be NULL when not inside a JSON object.  If defining a
+ * key for the first item, a root object is generated.  If NULL when inside a
+ * JSON object, a blank key ("") will be used.  Unlike the encoder, a key
+ * can't be given inside an array, as the output already written can't be
+ * changed.
+ *
+ * @retval IOT_STATUS_FULL             the maximum depth has been reached
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_array_end
+ */
+iot_status_t app_json_stream_array_start(
+	app_json_stream_t *stream,
+	const char *key );
+
+/**
+ * @brief Encodes a boolean in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               boolean value
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_encode_bool
+ */
+iot_status_t app_json_stream_bool(
+	app_json_stream_t *stream,
+	const char *key,
+	iot_bool_t value );
+
+/**
+ * @brief Ends any open JSON arrays and objects, and writes the output still
+ *        held by the stream to the sink
+ *
+ * @param[in]      stream              JSON stream object
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_flush
+ */
+iot_status_t app_json_stream_finish(
+	app_json_stream_t *stream );
+
+/**
+ * @brief Writes the output held by the stream to the sink
+ *
+ * @param[in]      stream              JSON stream object
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_finish
+ */
+iot_status_t app_json_stream_flush(
+	app_json_stream_t *stream );
+
+/**
+ * @brief Initializes a JSON stream, encoding directly to a sink
+ *
+ * The output is held in a fixed size buffer and given to the sink each time
+ * the buffer is full, so the memory used does not depend on the size of the
+ * document.  The output is written as items are added, independently of the
+ * JSON library used, and is the same as the output of the encoder.
+ *
+ * @note specifying the flag APP_JSON_FLAG_DYNAMIC indicates to use dynamic
+ * memory on the heap for allocating the JSON stream object.  In this case,
+ * @c buf is ignored and @c len is the size of the output buffer to allocate
+ * (or 0 for APP_JSON_STREAM_BUFFER_DEFAULT).
+ *
+ * @param[in,out]  buf                 memory to use for the stream
+ * @param[in]      len                 amount of memory in the buf parameter
+ * @param[in]      flags               flags for indicating output format
+ * @param[in]      sink                function called to write the output
+ * @param[in]      user_data           (optional) user data passed to @c sink
+ *
+ * @return a valid JSON stream object, NULL on failure
+ *
+ * @see app_json_stream_finish
+ * @see app_json_stream_terminate
+ */
+app_json_stream_t *app_json_stream_initialize(
+	void *buf,
+	size_t len,
+	unsigned int flags,
+	app_json_stream_sink_t sink,
+	void *user_data );
+
+/**
+ * @brief Encodes an integer number in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               integer number
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_unsigned
+ */
+iot_status_t app_json_stream_integer(
+	app_json_stream_t *stream,
+	const char *key,
+	iot_int64_t value );
+
+/**
+ * @brief Ends the encoding of a JSON object in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      not inside an JSON object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_object_start
+ */
+iot_status_t app_json_stream_object_end(
+	app_json_stream_t *stream );
+
+/**
+ * @brief Starts the encoding of a new JSON object in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ * @param[in]      key                 (optional) parent JSON object key
+ *
+ * @retval IOT_STATUS_FULL             the maximum depth has been reached
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_array_start
+ * @see app_json_stream_object_end
+ */
+iot_status_t app_json_stream_object_start(
+	app_json_stream_t *stream,
+	const char *key );
+
+/**
+ * @brief Encodes a floating-point number in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               floating-point number
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function,
+ *                                     or the number is not finite
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_real_precision
+ */
+iot_status_t app_json_stream_real(
+	app_json_stream_t *stream,
+	const char *key,
+	iot_float64_t value );
+
+/**
+ * @brief Encodes a floating-point number with a maximum number of decimal
+ *        places in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               floating-point number
+ * @param[in]      precision           maximum number of decimal places
+ *                                     (0 - APP_JSON_PRECISION_MAX), or
+ *                                     APP_JSON_PRECISION_SHORTEST or
+ *                                     APP_JSON_PRECISION_SHORTEST_FLOAT
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function,
+ *                                     or the number is not finite
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_real
+ */
+iot_status_t app_json_stream_real_precision(
+	app_json_stream_t *stream,
+	const char *key,
+	iot_float64_t value,
+	int precision );
+
+/**
+ * @brief Encodes a string in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               string value
+ *
+ * @note strings longer than the output buffer are given to the sink in
+ * several parts
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_string_len
+ */
+iot_status_t app_json_stream_string(
+	app_json_stream_t *stream,
+	const char *key,
+	const char *value );
+
+/**
+ * @brief Encodes a string of a given length in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               string value (may not be
+ *                                     null-terminated)
+ * @param[in]      value_len           length of the string value
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_string
+ */
+iot_status_t app_json_stream_string_len(
+	app_json_stream_t *stream,
+	const char *key,
+	const char *value,
+	size_t value_len );
+
+/**
+ * @brief Frees memory assocated with a JSON stream
+ *
+ * @note output held by the stream is not written, call app_json_stream_finish
+ * before to complete the document
+ *
+ * @param[in]      stream              JSON stream object
+ *
+ * @see app_json_stream_initialize
+ */
+void app_json_stream_terminate(
+	app_json_stream_t *stream );
+
+/**
+ * @brief Encodes an unsigned integer number in a stream
+ *
+ * @param[in]      stream              JSON stream object
+ * @param[in]      key                 (optional) parent JSON object key
+ * @param[in]      value               unsigned integer number
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      adding item not inside an array or object
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ *
+ * @see app_json_stream_integer
+ */
+iot_status_t app_json_stream_unsigned(
+	app_json_stream_t *stream,
+	const char *key,
+	iot_uint64_t value );
+
 #ifdef __cplusplus
 };
 #endif
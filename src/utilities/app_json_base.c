@@ -20,6 +20,17 @@
 
 #include <os.h>
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || \
+	( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h> /* for SSE2 intrinsics */
+/** @brief scan strings for characters to escape 16 bytes at a time */
+#define JSON_ESCAPE_SSE2
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#include <arm_neon.h> /* for NEON intrinsics */
+/** @brief scan strings for characters to escape 16 bytes at a time */
+#define JSON_ESCAPE_NEON
+#endif /* elif defined( __ARM_NEON ) || defined( __ARM_NEON__ ) */
+
 #if !defined( IOT_STACK_ONLY )
 /** @brief internal pointer to use for freeing dynamically allocated memory */
 static app_json_free_t *JSON_FREE = NULL;
@@ -92,3 +103,821 @@ void app_json_free( void* ptr )
 		os_free(ptr);
 }
 #endif /* if !defined( IOT_STACK_ONLY ) */
+
+/** @brief sign bit of a double */
+#define JSON_DOUBLE_SIGN_BIT           UINT64_C(0x8000000000000000)
+/** @brief mask of the exponent bits of a double */
+#define JSON_DOUBLE_EXPONENT_MASK      UINT64_C(0x7FF0000000000000)
+/** @brief implicit leading bit of a normalized double */
+#define JSON_DOUBLE_HIDDEN_BIT         UINT64_C(0x0010000000000000)
+/** @brief mask of the significand bits of a double */
+#define JSON_DOUBLE_SIGNIFICAND_MASK   UINT64_C(0x000FFFFFFFFFFFFF)
+/** @brief exponent bias of a double, including the significand bits */
+#define JSON_DOUBLE_EXPONENT_BIAS      1075
+/** @brief implicit leading bit of a normalized float */
+#define JSON_FLOAT_HIDDEN_BIT          0x00800000u
+/** @brief mask of the significand bits of a float */
+#define JSON_FLOAT_SIGNIFICAND_MASK    0x007FFFFFu
+/** @brief exponent bias of a float, including the significand bits */
+#define JSON_FLOAT_EXPONENT_BIAS       150
+/** @brief largest integer that is exactly representable in a double (2^53) */
+#define JSON_DOUBLE_INTEGER_MAX        9007199254740992.0
+/** @brief most decimal places tried before searching for the shortest digits */
+#define JSON_DOUBLE_SHORT_DECIMALS     6
+/** @brief splits a double into two halves of 26 bits (2^27 + 1) */
+#define JSON_DOUBLE_SPLITTER           134217729.0
+
+/**
+ * @brief a floating-point number with a 64-bit significand, used while
+ *        formatting real numbers
+ */
+struct app_json_diyfp
+{
+	iot_uint64_t f;                  /**< @brief significand */
+	int e;                           /**< @brief binary exponent */
+};
+
+/** @brief characters used for JSON escape sequences (0 = not escaped) */
+static const char JSON_ESCAPE_CHARS[128u] = {
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+	0,   0,   '"', 0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   '\\',0,   0,   0,
+	0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0
+};
+
+/** @brief pairs of decimal digits, for writing two digits at a time */
+static const char JSON_DIGITS_2[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+/** @brief hexadecimal digits */
+static const char JSON_HEX_DIGITS[] = "0123456789abcdef";
+
+/** @brief powers of 10 that fit in 64-bits */
+static const iot_uint64_t JSON_POW10[] = {
+	UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000),
+	UINT64_C(10000), UINT64_C(100000), UINT64_C(1000000),
+	UINT64_C(10000000), UINT64_C(100000000), UINT64_C(1000000000),
+	UINT64_C(10000000000), UINT64_C(100000000000),
+	UINT64_C(1000000000000), UINT64_C(10000000000000),
+	UINT64_C(100000000000000), UINT64_C(1000000000000000),
+	UINT64_C(10000000000000000), UINT64_C(100000000000000000),
+	UINT64_C(1000000000000000000), UINT64_C(10000000000000000000)
+};
+
+/** @brief significands of the cached powers 10^-348, 10^-340, ..., 10^340 */
+static const iot_uint64_t JSON_CACHED_POWER_F[] = {
+	UINT64_C(0xfa8fd5a0081c0288), UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x8b16fb203055ac76),
+	UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0xe61acf033d1a45df),
+	UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0xbe5691ef416bd60c),
+	UINT64_C(0x8dd01fad907ffc3c), UINT64_C(0xd3515c2831559a83), UINT64_C(0x9d71ac8fada6c9b5),
+	UINT64_C(0xea9c227723ee8bcb), UINT64_C(0xaecc49914078536d), UINT64_C(0x823c12795db6ce57),
+	UINT64_C(0xc21094364dfb5637), UINT64_C(0x9096ea6f3848984f), UINT64_C(0xd77485cb25823ac7),
+	UINT64_C(0xa086cfcd97bf97f4), UINT64_C(0xef340a98172aace5), UINT64_C(0xb23867fb2a35b28e),
+	UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x936b9fcebb25c996),
+	UINT64_C(0xdbac6c247d62a584), UINT64_C(0xa3ab66580d5fdaf6), UINT64_C(0xf3e2f893dec3f126),
+	UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x87625f056c7c4a8b), UINT64_C(0xc9bcff6034c13053),
+	UINT64_C(0x964e858c91ba2655), UINT64_C(0xdff9772470297ebd), UINT64_C(0xa6dfbd9fb8e5b88f),
+	UINT64_C(0xf8a95fcf88747d94), UINT64_C(0xb94470938fa89bcf), UINT64_C(0x8a08f0f8bf0f156b),
+	UINT64_C(0xcdb02555653131b6), UINT64_C(0x993fe2c6d07b7fac), UINT64_C(0xe45c10c42a2b3b06),
+	UINT64_C(0xaa242499697392d3), UINT64_C(0xfd87b5f28300ca0e), UINT64_C(0xbce5086492111aeb),
+	UINT64_C(0x8cbccc096f5088cc), UINT64_C(0xd1b71758e219652c), UINT64_C(0x9c40000000000000),
+	UINT64_C(0xe8d4a51000000000), UINT64_C(0xad78ebc5ac620000), UINT64_C(0x813f3978f8940984),
+	UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x8f7e32ce7bea5c70), UINT64_C(0xd5d238a4abe98068),
+	UINT64_C(0x9f4f2726179a2245), UINT64_C(0xed63a231d4c4fb27), UINT64_C(0xb0de65388cc8ada8),
+	UINT64_C(0x83c7088e1aab65db), UINT64_C(0xc45d1df942711d9a), UINT64_C(0x924d692ca61be758),
+	UINT64_C(0xda01ee641a708dea), UINT64_C(0xa26da3999aef774a), UINT64_C(0xf209787bb47d6b85),
+	UINT64_C(0xb454e4a179dd1877), UINT64_C(0x865b86925b9bc5c2), UINT64_C(0xc83553c5c8965d3d),
+	UINT64_C(0x952ab45cfa97a0b3), UINT64_C(0xde469fbd99a05fe3), UINT64_C(0xa59bc234db398c25),
+	UINT64_C(0xf6c69a72a3989f5c), UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x88fcf317f22241e2),
+	UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x98165af37b2153df), UINT64_C(0xe2a0b5dc971f303a),
+	UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0xbb764c4ca7a44410),
+	UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0xd01fef10a657842c), UINT64_C(0x9b10a4e5e9913129),
+	UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0xac2820d9623bf429), UINT64_C(0x80444b5e7aa7cf85),
+	UINT64_C(0xbf21e44003acdd2d), UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0xd433179d9c8cb841),
+	UINT64_C(0x9e19db92b4e31ba9), UINT64_C(0xeb96bf6ebadf77d9), UINT64_C(0xaf87023b9bf0ee6b),
+};
+
+/** @brief binary exponents of the cached powers 10^-348, ..., 10^340 */
+static const iot_int16_t JSON_CACHED_POWER_E[] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+	-954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+	-688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+	-422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+	-157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+	109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+	641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+	907, 933, 960, 986, 1013, 1039, 1066,
+};
+
+/**
+ * @brief generates the shortest digits within the boundaries of a number
+ *
+ * @param[in]      w                   scaled number
+ * @param[in]      mp                  scaled upper boundary
+ * @param[in]      delta               distance between the boundaries
+ * @param[out]     digits              generated digits
+ * @param[in,out]  k                   decimal exponent of the digits
+ *
+ * @return the number of digits generated
+ */
+static int app_json_number_digits(
+	struct app_json_diyfp w,
+	struct app_json_diyfp mp,
+	iot_uint64_t delta,
+	char *digits,
+	int *k );
+
+/**
+ * @brief moves the last digit towards the number being formatted
+ *
+ * @param[in,out]  digits              generated digits
+ * @param[in]      len                 number of digits generated
+ * @param[in]      delta               distance between the boundaries
+ * @param[in]      rest                remainder after the last digit
+ * @param[in]      ten_kappa           value of the last digit
+ * @param[in]      wp_w                distance from the upper boundary to the
+ *                                     number
+ */
+static void app_json_number_digits_round(
+	char *digits,
+	int len,
+	iot_uint64_t delta,
+	iot_uint64_t rest,
+	iot_uint64_t ten_kappa,
+	iot_uint64_t wp_w );
+
+/**
+ * @brief multiplies two numbers, rounding the result
+ *
+ * @param[in]      a                   first number
+ * @param[in]      b                   second number
+ *
+ * @return the product of the numbers
+ */
+static struct app_json_diyfp app_json_number_diyfp_multiply(
+	struct app_json_diyfp a,
+	struct app_json_diyfp b );
+
+/**
+ * @brief shifts a number until its most significant bit is set
+ *
+ * @param[in]      v                   number to normalize
+ *
+ * @return the normalized number
+ */
+static struct app_json_diyfp app_json_number_diyfp_normalize(
+	struct app_json_diyfp v );
+
+/**
+ * @brief formats a positive real number with a fixed number of decimal
+ *        places, removing trailing zeros
+ *
+ * @param[out]     buf                 destination buffer
+ * @param[in]      value               number to format
+ * @param[in]      precision           number of decimal places
+ *
+ * @return the number of characters written, 0 if the number is too large
+ */
+static size_t app_json_number_fixed(
+	char *buf,
+	double value,
+	int precision );
+
+/**
+ * @brief rounds a positive real number, scaled by a power of 10, to the
+ *        nearest integer
+ *
+ * The scaled value is computed exactly (the rounding error of the
+ * multiplication is recovered by splitting both operands), so that a number
+ * such as 2.675, stored as 2.67499999..., is not rounded up because its
+ * product happens to round to a half.
+ *
+ * @param[in]      value               number to round
+ * @param[in]      pow10               power of 10 to scale the number by
+ * @param[out]     out                 rounded value, halves are rounded up
+ *
+ * @retval IOT_FALSE                   scaled number is too large
+ * @retval IOT_TRUE                    number rounded
+ */
+static iot_bool_t app_json_number_round(
+	double value,
+	double pow10,
+	iot_uint64_t *out );
+
+/**
+ * @brief finds the shortest digits that read back as a positive number
+ *        (Grisu2)
+ *
+ * @param[in]      f                   significand of the number
+ * @param[in]      e                   binary exponent of the number
+ * @param[in]      lower_closer        whether the lower boundary is closer
+ *                                     (significand is a power of 2)
+ * @param[out]     digits              generated digits
+ * @param[out]     k                   decimal exponent of the digits
+ *
+ * @return the number of digits generated
+ */
+static int app_json_number_grisu(
+	iot_uint64_t f,
+	int e,
+	iot_bool_t lower_closer,
+	char *digits,
+	int *k );
+
+/**
+ * @brief finds the first character in a string that must be escaped in JSON
+ *
+ * @param[in]      str                 string to search
+ * @param[in]      len                 length of the string
+ *
+ * @return offset of the first character to escape, @p len if there is none
+ */
+static size_t app_json_string_escape_find(
+	const char *str,
+	size_t len );
+
+/**
+ * @brief lays out generated digits as a JSON number
+ *
+ * @param[in,out]  buf                 generated digits, replaced by the output
+ * @param[in]      len                 number of digits generated
+ * @param[in]      k                   decimal exponent of the digits
+ *
+ * @return the number of characters written
+ */
+static size_t app_json_number_layout(
+	char *buf,
+	int len,
+	int k );
+
+int app_json_number_digits(
+	struct app_json_diyfp w,
+	struct app_json_diyfp mp,
+	iot_uint64_t delta,
+	char *digits,
+	int *k )
+{
+	const int shift = -mp.e;
+	const iot_uint64_t one = (iot_uint64_t)1u << shift;
+	const iot_uint64_t wp_w = mp.f - w.f;
+	iot_uint32_t p1 = (iot_uint32_t)( mp.f >> shift );
+	iot_uint64_t p2 = mp.f & ( one - 1u );
+	int kappa = 1;
+	int len = 0;
+
+	while ( kappa < 10 && p1 >= (iot_uint32_t)JSON_POW10[kappa] )
+		++kappa;
+
+	/* integral part */
+	while ( kappa > 0 )
+	{
+		const iot_uint32_t pow10 = (iot_uint32_t)JSON_POW10[kappa - 1];
+		const iot_uint32_t d = p1 / pow10;
+		iot_uint64_t rest;
+		p1 %= pow10;
+		if ( d || len )
+			digits[len++] = (char)( '0' + d );
+		--kappa;
+		rest = ( (iot_uint64_t)p1 << shift ) + p2;
+		if ( rest <= delta )
+		{
+			*k += kappa;
+			app_json_number_digits_round( digits, len, delta, rest,
+				JSON_POW10[kappa] << shift, wp_w );
+			return len;
+		}
+	}
+
+	/* fractional part */
+	for ( ;; )
+	{
+		char d;
+		p2 *= 10u;
+		delta *= 10u;
+		d = (char)( p2 >> shift );
+		if ( d || len )
+			digits[len++] = (char)( '0' + d );
+		p2 &= one - 1u;
+		--kappa;
+		if ( p2 < delta )
+		{
+			*k += kappa;
+			app_json_number_digits_round( digits, len, delta, p2,
+				one, -kappa < 20 ? wp_w * JSON_POW10[-kappa] : 0u );
+			return len;
+		}
+	}
+}
+
+void app_json_number_digits_round(
+	char *digits,
+	int len,
+	iot_uint64_t delta,
+	iot_uint64_t rest,
+	iot_uint64_t ten_kappa,
+	iot_uint64_t wp_w )
+{
+	while ( rest < wp_w && delta - rest >= ten_kappa &&
+		( rest + ten_kappa < wp_w ||
+		  wp_w - rest > rest + ten_kappa - wp_w ) )
+	{
+		--digits[len - 1];
+		rest += ten_kappa;
+	}
+}
+
+struct app_json_diyfp app_json_number_diyfp_multiply(
+	struct app_json_diyfp a,
+	struct app_json_diyfp b )
+{
+	const iot_uint64_t m32 = UINT64_C(0xFFFFFFFF);
+	const iot_uint64_t a_hi = a.f >> 32;
+	const iot_uint64_t a_lo = a.f & m32;
+	const iot_uint64_t b_hi = b.f >> 32;
+	const iot_uint64_t b_lo = b.f & m32;
+	const iot_uint64_t hi_lo = a_hi * b_lo;
+	const iot_uint64_t lo_hi = a_lo * b_hi;
+	iot_uint64_t tmp = ( ( a_lo * b_lo ) >> 32 ) +
+		( hi_lo & m32 ) + ( lo_hi & m32 );
+	struct app_json_diyfp result;
+	tmp += (iot_uint64_t)1u << 31; /* round */
+	result.f = a_hi * b_hi + ( hi_lo >> 32 ) + ( lo_hi >> 32 ) +
+		( tmp >> 32 );
+	result.e = a.e + b.e + 64;
+	return result;
+}
+
+struct app_json_diyfp app_json_number_diyfp_normalize(
+	struct app_json_diyfp v )
+{
+	while ( !( v.f & UINT64_C(0x8000000000000000) ) )
+	{
+		v.f <<= 1;
+		--v.e;
+	}
+	return v;
+}
+
+size_t app_json_number_fixed(
+	char *buf,
+	double value,
+	int precision )
+{
+	size_t result = 0u;
+	iot_uint64_t rounded;
+	if ( app_json_number_round( value, (double)JSON_POW10[precision],
+		&rounded ) != IOT_FALSE )
+	{
+		const iot_uint64_t pow10 = JSON_POW10[precision];
+		iot_uint64_t frac = rounded % pow10;
+
+		result = app_json_number_integer( buf, rounded / pow10,
+			IOT_FALSE );
+		buf[result++] = '.';
+		if ( frac == 0u )
+			buf[result++] = '0';
+		else
+		{
+			int i;
+			while ( frac % 10u == 0u )
+			{
+				frac /= 10u;
+				--precision;
+			}
+			for ( i = precision - 1; i >= 0; --i )
+			{
+				buf[result + (size_t)i] = (char)( '0' + frac % 10u );
+				frac /= 10u;
+			}
+			result += (size_t)precision;
+		}
+	}
+	return result;
+}
+
+iot_bool_t app_json_number_round(
+	double value,
+	double pow10,
+	iot_uint64_t *out )
+{
+	iot_bool_t result = IOT_FALSE;
+	const double scaled = value * pow10;
+	if ( scaled < JSON_DOUBLE_INTEGER_MAX )
+	{
+		/* value * pow10 == scaled + err exactly (Dekker's product) */
+		const double v_split = value * JSON_DOUBLE_SPLITTER;
+		const double v_hi = v_split - ( v_split - value );
+		const double v_lo = value - v_hi;
+		const double p_split = pow10 * JSON_DOUBLE_SPLITTER;
+		const double p_hi = p_split - ( p_split - pow10 );
+		const double p_lo = pow10 - p_hi;
+		const double err = ( ( v_hi * p_hi - scaled ) + v_hi * p_lo +
+			v_lo * p_hi ) + v_lo * p_lo;
+		const iot_uint64_t whole = (iot_uint64_t)scaled;
+
+		/* both subtractions are exact, only the sign of the sum is used */
+		*out = whole;
+		if ( ( ( scaled - (double)whole ) - 0.5 ) + err >= 0.0 )
+			++(*out);
+		result = IOT_TRUE;
+	}
+	return result;
+}
+
+int app_json_number_grisu(
+	iot_uint64_t f,
+	int e,
+	iot_bool_t lower_closer,
+	char *digits,
+	int *k )
+{
+	struct app_json_diyfp v;
+	struct app_json_diyfp c_mk;
+	struct app_json_diyfp w;
+	struct app_json_diyfp w_minus;
+	struct app_json_diyfp w_plus;
+	double dk;
+	int cached_k;
+	unsigned int idx;
+
+	/* boundaries of the values that round to this number */
+	v.f = f;
+	v.e = e;
+	w_plus.f = ( f << 1 ) + 1u;
+	w_plus.e = e - 1;
+	w_plus = app_json_number_diyfp_normalize( w_plus );
+	if ( lower_closer != IOT_FALSE )
+	{
+		w_minus.f = ( f << 2 ) - 1u;
+		w_minus.e = e - 2;
+	}
+	else
+	{
+		w_minus.f = ( f << 1 ) - 1u;
+		w_minus.e = e - 1;
+	}
+	w_minus.f <<= w_minus.e - w_plus.e;
+	w_minus.e = w_plus.e;
+
+	/* cached power of 10 bringing the exponent into [-60, -32] */
+	dk = ( -61 - w_plus.e ) * 0.30102999566398114 + 347.0;
+	cached_k = (int)dk;
+	if ( dk - cached_k > 0.0 )
+		++cached_k;
+	idx = (unsigned int)( ( cached_k >> 3 ) + 1 );
+	*k = -( -348 + (int)( idx << 3 ) );
+	c_mk.f = JSON_CACHED_POWER_F[idx];
+	c_mk.e = JSON_CACHED_POWER_E[idx];
+
+	w = app_json_number_diyfp_multiply(
+		app_json_number_diyfp_normalize( v ), c_mk );
+	w_plus = app_json_number_diyfp_multiply( w_plus, c_mk );
+	w_minus = app_json_number_diyfp_multiply( w_minus, c_mk );
+	++w_minus.f;
+	--w_plus.f;
+	return app_json_number_digits( w, w_plus, w_plus.f - w_minus.f,
+		digits, k );
+}
+
+size_t app_json_number_layout(
+	char *buf,
+	int len,
+	int k )
+{
+	size_t result;
+	const int kk = len + k; /* position of the decimal point */
+	if ( k >= 0 && kk <= 21 )
+	{
+		/* 1234e7 -> 12340000000.0 */
+		int i;
+		for ( i = len; i < kk; ++i )
+			buf[i] = '0';
+		buf[kk] = '.';
+		buf[kk + 1] = '0';
+		result = (size_t)kk + 2u;
+	}
+	else if ( kk > 0 && kk <= 21 )
+	{
+		/* 1234e-2 -> 12.34 */
+		os_memmove( &buf[kk + 1], &buf[kk], (size_t)( len - kk ) );
+		buf[kk] = '.';
+		result = (size_t)len + 1u;
+	}
+	else if ( kk > -6 && kk <= 0 )
+	{
+		/* 1234e-6 -> 0.001234 */
+		const int offset = 2 - kk;
+		int i;
+		os_memmove( &buf[offset], &buf[0], (size_t)len );
+		buf[0] = '0';
+		buf[1] = '.';
+		for ( i = 2; i < offset; ++i )
+			buf[i] = '0';
+		result = (size_t)( len + offset );
+	}
+	else
+	{
+		/* 1234e30 -> 1.234e33 */
+		int exp = kk - 1;
+		if ( len == 1 )
+			result = 1u;
+		else
+		{
+			os_memmove( &buf[2], &buf[1], (size_t)( len - 1 ) );
+			buf[1] = '.';
+			result = (size_t)len + 1u;
+		}
+		buf[result++] = 'e';
+		if ( exp < 0 )
+		{
+			buf[result++] = '-';
+			exp = -exp;
+		}
+		if ( exp >= 100 )
+		{
+			buf[result++] = (char)( '0' + exp / 100 );
+			exp %= 100;
+			buf[result++] = JSON_DIGITS_2[exp * 2];
+			buf[result++] = JSON_DIGITS_2[exp * 2 + 1];
+		}
+		else if ( exp >= 10 )
+		{
+			buf[result++] = JSON_DIGITS_2[exp * 2];
+			buf[result++] = JSON_DIGITS_2[exp * 2 + 1];
+		}
+		else
+			buf[result++] = (char)( '0' + exp );
+	}
+	return result;
+}
+
+size_t app_json_number_integer(
+	char *buf,
+	iot_uint64_t value,
+	iot_bool_t negative )
+{
+	char tmp[20u];
+	char *p = &tmp[sizeof( tmp )];
+	size_t len;
+
+	/* two digits at a time, from the end */
+	while ( value >= 100u )
+	{
+		const size_t i = (size_t)( value % 100u ) * 2u;
+		value /= 100u;
+		p -= 2;
+		p[0] = JSON_DIGITS_2[i];
+		p[1] = JSON_DIGITS_2[i + 1u];
+	}
+	if ( value >= 10u )
+	{
+		const size_t i = (size_t)value * 2u;
+		p -= 2;
+		p[0] = JSON_DIGITS_2[i];
+		p[1] = JSON_DIGITS_2[i + 1u];
+	}
+	else
+		*--p = (char)( '0' + value );
+
+	len = (size_t)( &tmp[sizeof( tmp )] - p );
+	if ( negative != IOT_FALSE )
+		*buf++ = '-';
+	os_memcpy( buf, p, len );
+	return len + ( negative != IOT_FALSE ? 1u : 0u );
+}
+
+size_t app_json_number_real(
+	char *buf,
+	double value,
+	int precision )
+{
+	size_t result = 0u;
+	iot_uint64_t bits;
+
+	os_memcpy( &bits, &value, sizeof( bits ) );
+	if ( ( bits & JSON_DOUBLE_EXPONENT_MASK ) != JSON_DOUBLE_EXPONENT_MASK )
+	{
+		char *out = buf;
+		double whole = 0.0;
+		if ( value < 0.0 )
+			*out++ = '-';
+		/* clear the sign bit, so the bits of -0.0 match 0.0 too */
+		bits &= ~JSON_DOUBLE_SIGN_BIT;
+		os_memcpy( &value, &bits, sizeof( value ) );
+
+		if ( precision > APP_JSON_PRECISION_MAX )
+			precision = APP_JSON_PRECISION_MAX;
+		if ( precision >= 0 )
+			result = app_json_number_fixed( out, value, precision );
+
+		if ( value < JSON_DOUBLE_INTEGER_MAX )
+			whole = (double)(iot_uint64_t)value;
+		if ( result == 0u && value < JSON_DOUBLE_INTEGER_MAX &&
+			os_memcmp( &whole, &value, sizeof( value ) ) == 0 )
+		{
+			/* integral value: exact without any digit search */
+			result = app_json_number_integer( out,
+				(iot_uint64_t)value, IOT_FALSE );
+			out[result++] = '.';
+			out[result++] = '0';
+		}
+		else if ( result == 0u &&
+			precision == APP_JSON_PRECISION_SHORTEST )
+		{
+			/* most readings have only a few decimal places, which are
+			 * exact if they read back as the same double */
+			int i;
+			for ( i = 1; result == 0u &&
+				i <= JSON_DOUBLE_SHORT_DECIMALS; ++i )
+			{
+				const double pow10 = (double)JSON_POW10[i];
+				iot_uint64_t rounded;
+				if ( app_json_number_round( value, pow10,
+					&rounded ) != IOT_FALSE )
+				{
+					const double back = (double)rounded / pow10;
+					if ( os_memcmp( &back, &value,
+						sizeof( value ) ) == 0 )
+						result = app_json_number_fixed( out,
+							value, i );
+				}
+			}
+		}
+
+		if ( result == 0u )
+		{
+			int k = 0;
+			int len;
+			if ( precision == APP_JSON_PRECISION_SHORTEST_FLOAT )
+			{
+				/* shortest digits that read back as the same float */
+				const float single = (float)value;
+				iot_uint32_t single_bits;
+				iot_uint32_t f;
+				int e;
+				os_memcpy( &single_bits, &single,
+					sizeof( single_bits ) );
+				f = single_bits & JSON_FLOAT_SIGNIFICAND_MASK;
+				e = (int)( single_bits >> 23 );
+				if ( e != 0 )
+				{
+					f += JSON_FLOAT_HIDDEN_BIT;
+					e -= JSON_FLOAT_EXPONENT_BIAS;
+				}
+				else
+					e = 1 - JSON_FLOAT_EXPONENT_BIAS;
+				len = app_json_number_grisu( f, e,
+					f == JSON_FLOAT_HIDDEN_BIT, out, &k );
+			}
+			else
+			{
+				iot_uint64_t f = bits & JSON_DOUBLE_SIGNIFICAND_MASK;
+				int e = (int)( ( bits & JSON_DOUBLE_EXPONENT_MASK ) >> 52 );
+				if ( e != 0 )
+				{
+					f += JSON_DOUBLE_HIDDEN_BIT;
+					e -= JSON_DOUBLE_EXPONENT_BIAS;
+				}
+				else
+					e = 1 - JSON_DOUBLE_EXPONENT_BIAS;
+				len = app_json_number_grisu( f, e,
+					f == JSON_DOUBLE_HIDDEN_BIT, out, &k );
+			}
+			result = app_json_number_layout( out, len, k );
+		}
+
+		/* "-0.0" is written as "0.0" */
+		if ( out != buf && result == 3u && out[0] == '0' &&
+			out[2] == '0' )
+			os_memmove( buf, out, result );
+		else
+			result += (size_t)( out - buf );
+	}
+	return result;
+}
+
+size_t app_json_string_escape(
+	char *dest,
+	const char *src,
+	size_t src_len,
+	size_t num )
+{
+	size_t result = 0u;
+	iot_bool_t done = IOT_FALSE;
+	while ( src_len > 0u && done == IOT_FALSE )
+	{
+		/* copy everything up to the next character to escape */
+		size_t run = app_json_string_escape_find( src, src_len );
+		if ( run > num - result )
+		{
+			run = num - result;
+			done = IOT_TRUE;
+		}
+		os_memcpy( &dest[result], src, run );
+		result += run;
+		src += run;
+		src_len -= run;
+
+		if ( src_len > 0u && done == IOT_FALSE )
+		{
+			const unsigned char c = (unsigned char)*src;
+			const char e = JSON_ESCAPE_CHARS[c];
+			if ( e == 'u' && num - result >= 6u )
+			{
+				dest[result++] = '\\';
+				dest[result++] = 'u';
+				dest[result++] = '0';
+				dest[result++] = '0';
+				dest[result++] = JSON_HEX_DIGITS[c >> 4];
+				dest[result++] = JSON_HEX_DIGITS[c & 0xFu];
+			}
+			else if ( e != 'u' && num - result >= 2u )
+			{
+				dest[result++] = '\\';
+				dest[result++] = e;
+			}
+			else
+				done = IOT_TRUE;
+			++src;
+			--src_len;
+		}
+	}
+	return result;
+}
+
+size_t app_json_string_escape_find(
+	const char *str,
+	size_t len )
+{
+	size_t i = 0u;
+#if defined( JSON_ESCAPE_SSE2 )
+	const __m128i quote = _mm_set1_epi8( '"' );
+	const __m128i backslash = _mm_set1_epi8( '\\' );
+	const __m128i control = _mm_set1_epi8( 0x1F );
+	while ( i + 16u <= len )
+	{
+		const __m128i v =
+			_mm_loadu_si128( (const __m128i *)&str[i] );
+		/* v <= 0x1F is where the unsigned minimum equals v */
+		const __m128i m = _mm_or_si128(
+			_mm_or_si128( _mm_cmpeq_epi8( v, quote ),
+				_mm_cmpeq_epi8( v, backslash ) ),
+			_mm_cmpeq_epi8( _mm_min_epu8( v, control ), v ) );
+		if ( _mm_movemask_epi8( m ) != 0 )
+			break;
+		i += 16u;
+	}
+#elif defined( JSON_ESCAPE_NEON )
+	const uint8x16_t quote = vdupq_n_u8( '"' );
+	const uint8x16_t backslash = vdupq_n_u8( '\\' );
+	const uint8x16_t control = vdupq_n_u8( 0x20 );
+	while ( i + 16u <= len )
+	{
+		const uint8x16_t v = vld1q_u8( (const uint8_t *)&str[i] );
+		const uint64x2_t m = vreinterpretq_u64_u8( vorrq_u8(
+			vorrq_u8( vceqq_u8( v, quote ),
+				vceqq_u8( v, backslash ) ),
+			vcltq_u8( v, control ) ) );
+		if ( ( vgetq_lane_u64( m, 0 ) | vgetq_lane_u64( m, 1 ) ) != 0u )
+			break;
+		i += 16u;
+	}
+#endif /* elif defined( JSON_ESCAPE_NEON ) */
+	while ( i < len && ( (unsigned char)str[i] >= 0x80u ||
+		JSON_ESCAPE_CHARS[(unsigned char)str[i]] == '\0' ) )
+		++i;
+	return i;
+}
+
+size_t app_json_string_escape_len(
+	const char *str,
+	size_t len )
+{
+	size_t result = len;
+	size_t i = app_json_string_escape_find( str, len );
+	while ( i < len )
+	{
+		/* "\\uXXXX" or "\\X" */
+		if ( JSON_ESCAPE_CHARS[(unsigned char)str[i]] == 'u' )
+			result += 5u;
+		else
+			++result;
+		++i;
+		i += app_json_string_escape_find( &str[i], len - i );
+	}
+	return result;
+}
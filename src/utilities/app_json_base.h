@@ -42,6 +42,10 @@
 		unsigned int flags;
 		/** @brief pointer to the root object */
 		struct json_object *j_root;
+		/** @brief tokener of a document parsed in chunks */
+		struct json_tokener *j_tok;
+		/** @brief length of the document given to the tokener */
+		size_t j_len;
 	};
 #else /* defined( IOT_JSON_JSMN ) */
 	/** @brief base structure used for decoding with JSMN */
@@ -59,6 +63,11 @@
 		unsigned int size;
 		/** @brief pointer to first token */
 		jsmntok_t *tokens;
+#ifndef IOT_STACK_ONLY
+		/** @brief key tables of objects with many keys (built when
+		 *         the document is parsed) */
+		struct app_json_decode_hash *hash;
+#endif /* ifndef IOT_STACK_ONLY */
 	};
 #endif
 
@@ -87,5 +96,179 @@ void *app_json_realloc( void *ptr, size_t size );
 void app_json_free( void* ptr );
 #endif /* ifndef IOT_STACK_ONLY */
 
+/**
+ * @brief maximum number of characters written by the app_json_number_*
+ *        functions
+ */
+#define APP_JSON_NUMBER_MAX_LEN        32u
+
+/**
+ * @brief formats an integer as a JSON number
+ *
+ * @param[out]     buf                 destination buffer, must hold at least
+ *                                     APP_JSON_NUMBER_MAX_LEN characters
+ * @param[in]      value               magnitude of the integer
+ * @param[in]      negative            whether the integer is negative
+ *
+ * @return the number of characters written (not null-terminated)
+ *
+ * @see app_json_number_real
+ */
+size_t app_json_number_integer(
+	char *buf,
+	iot_uint64_t value,
+	iot_bool_t negative );
+
+/**
+ * @brief formats a real number as a JSON number
+ *
+ * Without a precision, the shortest string that reads back as the same
+ * number is written (Grisu2).  The output always contains a '.' or an
+ * exponent, so it is decoded as a real number.
+ *
+ * @param[out]     buf                 destination buffer, must hold at least
+ *                                     APP_JSON_NUMBER_MAX_LEN characters
+ * @param[in]      value               number to format
+ * @param[in]      precision           maximum number of decimal places, or
+ *                                     APP_JSON_PRECISION_SHORTEST or
+ *                                     APP_JSON_PRECISION_SHORTEST_FLOAT
+ *
+ * @return the number of characters written (not null-terminated), 0 if the
+ *         value can't be represented in JSON (NaN or infinity)
+ *
+ * @see app_json_number_integer
+ */
+size_t app_json_number_real(
+	char *buf,
+	double value,
+	int precision );
+
+/**
+ * @brief copies a string, adding JSON escape sequences
+ *
+ * @note the output is not null-terminated and stops before any escape
+ *       sequence that does not completely fit
+ *
+ * @param[out]     dest                destination buffer
+ * @param[in]      src                 source string
+ * @param[in]      src_len             length of the source string
+ * @param[in]      num                 size of the destination buffer
+ *
+ * @return the number of characters written
+ *
+ * @see app_json_string_escape_len
+ */
+size_t app_json_string_escape(
+	char *dest,
+	const char *src,
+	size_t src_len,
+	size_t num );
+
+/**
+ * @brief calculates the length of a string once JSON escape sequences are
+ *        added
+ *
+ * @param[in]      str                 source string
+ * @param[in]      len                 length of the source string
+ *
+ * @return the length of the string including escape sequences
+ *
+ * @see app_json_string_escape
+ */
+size_t app_json_string_escape_len(
+	const char *str,
+	size_t len );
+
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+/**
+ * @brief number of words in the index of a JSON document
+ *
+ * @param[in]      len                 length of the document
+ */
+#define APP_JSON_TOKEN_INDEX_LEN( len ) ( ( ( len ) + 63u ) / 64u * 2u )
+
+/**
+ * @brief builds the index of a JSON document and counts its tokens
+ *
+ * The count is exact for a valid document and never less than the number
+ * of tokens app_json_token_parse builds for it, so it can be used to size
+ * the tokens before parsing.
+ *
+ * @param[in]      js                  JSON document
+ * @param[in,out]  len                 length of the document, set to the
+ *                                     position of a null character, if any
+ * @param[out]     index               index of the document, must hold
+ *                                     APP_JSON_TOKEN_INDEX_LEN( len ) words
+ *                                     (optional)
+ *
+ * @return the number of tokens in the document
+ *
+ * @see app_json_token_parse
+ */
+size_t app_json_token_index(
+	const char *js,
+	size_t *len,
+	iot_uint64_t *index );
+
+/**
+ * @brief builds the tokens for a JSON document
+ *
+ * The tokens built are the same as jsmn_parse builds in strict mode with
+ * parent links, but structural characters and strings are found with
+ * vector instructions, 64 characters at a time.
+ *
+ * @param[in]      js                  JSON document
+ * @param[in]      len                 length of the document
+ * @param[in]      index               index from app_json_token_index, or
+ *                                     NULL to scan the document
+ * @param[out]     tokens              tokens to fill
+ * @param[in]      num_tokens          number of tokens available
+ *
+ * @retval JSMN_ERROR_INVAL            invalid character in the document
+ * @retval JSMN_ERROR_NOMEM            not enough tokens
+ * @retval JSMN_ERROR_PART             document is incomplete
+ * @return the number of tokens built, on success
+ *
+ * @see app_json_token_index
+ */
+int app_json_token_parse(
+	const char *js,
+	size_t len,
+	const iot_uint64_t *index,
+	jsmntok_t *tokens,
+	unsigned int num_tokens );
+
+/**
+ * @brief carries on building the tokens for a JSON document, after more of
+ *        it is received or more tokens are available
+ *
+ * Where to carry on is worked out from the tokens already built, so nothing
+ * else needs to be kept between calls.  Tokens are only built for complete
+ * strings and primitives, so the tokens built so far are kept when the
+ * document is incomplete or there are not enough tokens.
+ *
+ * @param[in]      js                  JSON document received so far (the
+ *                                     part already parsed must not change)
+ * @param[in]      len                 length of the document received
+ * @param[in,out]  tokens              tokens to fill
+ * @param[in]      num_tokens          number of tokens available
+ * @param[in,out]  toknext             number of tokens already built, set to
+ *                                     the number built (0 to start)
+ *
+ * @retval JSMN_ERROR_INVAL            invalid character in the document
+ * @retval JSMN_ERROR_NOMEM            not enough tokens
+ * @retval JSMN_ERROR_PART             document is incomplete
+ * @return the number of tokens built, on success
+ *
+ * @see app_json_token_parse
+ */
+int app_json_token_parse_resume(
+	const char *js,
+	size_t len,
+	jsmntok_t *tokens,
+	unsigned int num_tokens,
+	unsigned int *toknext );
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+
 #endif
 
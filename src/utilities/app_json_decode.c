@@ -18,9 +18,157 @@
 #include "app_json.h"
 #include "app_json_base.h"
 
-#if defined( IOT_JSON_JANSSON  ) || defined( IOT_JSON_JSONC )
-#	include <os.h> /* for os_memzero, os_snprintf  */
-#else /* if defined( IOT_JSON_JSMN ) || defined( IOT_JSON_JSONC ) */
+#include <os.h> /* for os_memcmp, os_memcpy, os_memzero, os_snprintf,
+                   os_strlen, os_strncmp */
+
+#if !defined( IOT_JSON_JANSSON  ) && !defined( IOT_JSON_JSONC )
+#ifndef IOT_STACK_ONLY
+/** @brief number of keys an object needs before a table of them is built */
+#define APP_JSON_DECODE_HASH_MIN       16
+
+/** @brief table of the keys in an object */
+struct app_json_decode_hash
+{
+	/** @brief next table built by the decoder */
+	struct app_json_decode_hash *next;
+	/** @brief index of the object's token */
+	unsigned int object;
+	/** @brief number of slots less one (slots are a power of two) */
+	unsigned int mask;
+	/** @brief index of the token of each key plus one (0 = empty) */
+	unsigned int *slot;
+};
+
+/**
+ * @brief returns the table of the keys in an object
+ *
+ * @param[in]      decoder             JSON decoder object
+ * @param[in]      object              JSON object
+ *
+ * @return the table of keys, NULL if the keys are to be searched in order
+ *
+ * @see app_jsmn_decode_hash_build
+ */
+static const struct app_json_decode_hash *app_jsmn_decode_hash(
+	const app_json_decoder_t *decoder,
+	const jsmntok_t *object );
+
+/**
+ * @brief builds the tables of the keys in a parsed document
+ *
+ * Tables are only built for objects with many keys, by decoders using the
+ * heap.  An object without a table (if memory runs out) has its keys
+ * searched in order.  The tables are released when the decoder parses
+ * another document or is terminated.
+ *
+ * @param[in,out]  decoder             JSON decoder object, holding the
+ *                                     document just parsed
+ *
+ * @see app_jsmn_decode_hash
+ * @see app_jsmn_decode_hash_free
+ */
+static void app_jsmn_decode_hash_build(
+	app_json_decoder_t *decoder );
+
+/**
+ * @brief releases the tables of keys built by a decoder
+ *
+ * @param[in,out]  decoder             JSON decoder object
+ *
+ * @see app_jsmn_decode_hash_build
+ */
+static void app_jsmn_decode_hash_free(
+	app_json_decoder_t *decoder );
+
+/**
+ * @brief calculates the hash of a key (FNV-1a)
+ *
+ * @param[in]      key                 key to hash
+ * @param[in]      key_len             length of the key
+ *
+ * @return the hash of the key
+ */
+static iot_uint32_t app_jsmn_decode_hash_key(
+	const char *key,
+	size_t key_len );
+#endif /* ifndef IOT_STACK_ONLY */
+
+/**
+ * @brief returns whether a token is an object key matching the one given
+ *
+ * @param[in]      decoder             JSON decoder object
+ * @param[in]      tok                 token to compare
+ * @param[in]      key                 key to match
+ * @param[in]      key_len             length of the key
+ *
+ * @retval IOT_FALSE                   token is not the key
+ * @retval IOT_TRUE                    token is the key
+ */
+static iot_bool_t app_jsmn_decode_key_equal(
+	const app_json_decoder_t *decoder,
+	const jsmntok_t *tok,
+	const char *key,
+	size_t key_len );
+
+/**
+ * @brief returns the index of the token following a token and its
+ *        children (for an object key, its value)
+ *
+ * @param[in]      decoder             JSON decoder object
+ * @param[in]      idx                 index of the token
+ *
+ * @return the index of the next sibling of the token (or, if it is the last
+ *         child, the token following its parent)
+ */
+static unsigned int app_jsmn_decode_next(
+	const app_json_decoder_t *decoder,
+	unsigned int idx );
+
+/**
+ * @brief completes parsing a document, from the result of building its
+ *        tokens
+ *
+ * @param[in,out]  decoder             JSON decoder object
+ * @param[in]      js                  JSON document
+ * @param[in]      len                 length of the document
+ * @param[in]      i                   number of tokens built, or the error
+ *                                     building them
+ * @param[out]     root                the root element
+ * @param[in,out]  error               error text on failure (optional)
+ * @param[in]      error_len           size of the error string buffer
+ *                                     (optional)
+ *
+ * @retval IOT_STATUS_NO_MEMORY        not enough tokens
+ * @retval IOT_STATUS_PARSE_ERROR      invalid or incomplete document
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see app_json_decode_parse
+ * @see app_json_decode_parse_chunk
+ */
+static iot_status_t app_jsmn_decode_parsed(
+	app_json_decoder_t *decoder,
+	const char *js,
+	size_t len,
+	int i,
+	const app_json_item_t **root,
+	char *error,
+	size_t error_len );
+
+/**
+ * @brief returns where the decoder keeps the skip pointers of the tokens
+ *
+ * For each token, the skip pointer is the index of the token following it
+ * and its children.  A decoder using the heap allocates room for them with
+ * the tokens; a decoder with a fixed buffer keeps them in the tokens not
+ * used by the document, if there are enough left.
+ *
+ * @param[in]      decoder             JSON decoder object
+ *
+ * @return the skip pointers, NULL if there is no room for them
+ */
+static unsigned int *app_jsmn_decode_skip(
+	const app_json_decoder_t *decoder );
+
 /**
  * @brief helper function for decoding real numbers with JSMN
  *
@@ -138,7 +286,259 @@ iot_status_t app_jsmn_decode_number(
 		*is_integer = is_int;
 	return result;
 }
-#endif /* if defined( IOT_JSON_JSMN ) || defined( IOT_JSON_JSONC )*/
+
+#ifndef IOT_STACK_ONLY
+const struct app_json_decode_hash *app_jsmn_decode_hash(
+	const app_json_decoder_t *decoder,
+	const jsmntok_t *object )
+{
+	const struct app_json_decode_hash *result = NULL;
+	if ( object->size >= APP_JSON_DECODE_HASH_MIN )
+	{
+		const unsigned int idx =
+			(unsigned int)( object - decoder->tokens );
+		result = decoder->hash;
+		while ( result && result->object != idx )
+			result = result->next;
+	}
+	return result;
+}
+
+void app_jsmn_decode_hash_build(
+	app_json_decoder_t *decoder )
+{
+	if ( decoder->flags & APP_JSON_FLAG_DYNAMIC )
+	{
+		unsigned int idx;
+		for ( idx = 0u; idx < decoder->objs; ++idx )
+		{
+			const jsmntok_t *const object = &decoder->tokens[idx];
+			struct app_json_decode_hash *hash;
+			unsigned int slots = 1u;
+
+			if ( object->type != JSMN_OBJECT ||
+				object->size < APP_JSON_DECODE_HASH_MIN )
+				continue;
+
+			while ( slots < (unsigned int)object->size * 2u )
+				slots <<= 1;
+			hash = (struct app_json_decode_hash *)app_json_realloc(
+				NULL, sizeof( struct app_json_decode_hash ) +
+				sizeof( unsigned int ) * slots );
+			if ( hash )
+			{
+				int i;
+				unsigned int k = idx + 1u;
+
+				hash->object = idx;
+				hash->mask = slots - 1u;
+				hash->slot = (unsigned int *)(void *)( hash + 1 );
+				os_memzero( hash->slot,
+					sizeof( unsigned int ) * slots );
+				for ( i = 0; i < object->size && k < decoder->objs; ++i )
+				{
+					const jsmntok_t *const key = &decoder->tokens[k];
+					unsigned int s = (unsigned int)
+						app_jsmn_decode_hash_key(
+						&decoder->buf[key->start],
+						(size_t)( key->end - key->start ) ) &
+						hash->mask;
+					while ( hash->slot[s] != 0u )
+						s = ( s + 1u ) & hash->mask;
+					hash->slot[s] = k + 1u;
+					k = app_jsmn_decode_next( decoder, k );
+				}
+				hash->next = decoder->hash;
+				decoder->hash = hash;
+			}
+		}
+	}
+}
+
+void app_jsmn_decode_hash_free(
+	app_json_decoder_t *decoder )
+{
+	while ( decoder->hash )
+	{
+		struct app_json_decode_hash *const next = decoder->hash->next;
+		app_json_free( decoder->hash );
+		decoder->hash = next;
+	}
+}
+
+iot_uint32_t app_jsmn_decode_hash_key(
+	const char *key,
+	size_t key_len )
+{
+	iot_uint32_t result = 2166136261u;
+	size_t i;
+	for ( i = 0u; i < key_len; ++i )
+	{
+		result ^= (iot_uint32_t)(unsigned char)key[i];
+		result *= 16777619u;
+	}
+	return result;
+}
+#endif /* ifndef IOT_STACK_ONLY */
+
+iot_bool_t app_jsmn_decode_key_equal(
+	const app_json_decoder_t *decoder,
+	const jsmntok_t *tok,
+	const char *key,
+	size_t key_len )
+{
+	iot_bool_t result = IOT_FALSE;
+	if ( tok->type == JSMN_STRING && tok->size == 1 &&
+		(size_t)( tok->end - tok->start ) == key_len &&
+		os_memcmp( &decoder->buf[tok->start], key, key_len ) == 0 )
+		result = IOT_TRUE;
+	return result;
+}
+
+unsigned int app_jsmn_decode_next(
+	const app_json_decoder_t *decoder,
+	unsigned int idx )
+{
+	const unsigned int *const skip = app_jsmn_decode_skip( decoder );
+	unsigned int result = idx + 1u;
+	if ( skip )
+		result = skip[idx];
+	else
+	{
+		/* no room was left for the skip pointers: children start
+		 * before the end of their parent */
+		const jsmntok_t *tok = &decoder->tokens[idx];
+		if ( tok->type == JSMN_STRING && tok->size == 1 &&
+			result < decoder->objs )
+			tok = &decoder->tokens[result++];
+		while ( result < decoder->objs &&
+			decoder->tokens[result].start < tok->end )
+			++result;
+	}
+	return result;
+}
+
+iot_status_t app_jsmn_decode_parsed(
+	app_json_decoder_t *decoder,
+	const char *js,
+	size_t len,
+	int i,
+	const app_json_item_t **root,
+	char *error,
+	size_t error_len )
+{
+	iot_status_t result = IOT_STATUS_PARSE_ERROR;
+	const char *error_text = NULL;
+
+	/* token following the last marks the end for the iterators */
+	if ( i >= 0 && (unsigned int)i < decoder->size )
+	{
+		jsmntok_t *const tok = &decoder->tokens[i];
+		tok->type = JSMN_UNDEFINED;
+		tok->start = 0;
+		tok->end = 0;
+		tok->size = 0;
+		tok->parent = 0;
+	}
+
+	if ( i == JSMN_ERROR_NOMEM )
+	{
+		error_text = "out of memory";
+		result = IOT_STATUS_NO_MEMORY;
+	}
+	else if ( i == JSMN_ERROR_INVAL )
+		error_text = "invalid character";
+	else if ( i == JSMN_ERROR_PART )
+		error_text = "incomplete json string";
+	else if ( i < 0 )
+		error_text = "unknown error encountered";
+	else
+	{
+		unsigned int *skip;
+		unsigned int j;
+
+		decoder->objs = (unsigned int)i;
+		decoder->buf = js;
+
+		/* record where the children of each token end (tokens
+		 * follow their parent), so lookups go from one
+		 * sibling to the next */
+		skip = app_jsmn_decode_skip( decoder );
+		for ( j = 0u; skip && j < decoder->objs; ++j )
+			skip[j] = j + 1u;
+		while ( skip && j > 0u )
+		{
+			const int parent = decoder->tokens[--j].parent;
+			if ( parent >= 0 && skip[parent] < skip[j] )
+				skip[parent] = skip[j];
+		}
+#ifndef IOT_STACK_ONLY
+		app_jsmn_decode_hash_build( decoder );
+#endif /* ifndef IOT_STACK_ONLY */
+
+		decoder->len = len;
+		*root = decoder->tokens;
+		result = IOT_STATUS_SUCCESS;
+	}
+
+	/* copy error text */
+	if ( error && error_len > 0u && error_text )
+	{
+		size_t j = 0u;
+		--error_len;
+		while ( j < error_len && *error_text != '\0' )
+		{
+			*error = *error_text;
+			++error;
+			++error_text;
+			++j;
+		}
+		if ( j <= error_len )
+			*error = '\0';
+	}
+	return result;
+}
+
+unsigned int *app_jsmn_decode_skip(
+	const app_json_decoder_t *decoder )
+{
+	unsigned int *result = NULL;
+#ifndef IOT_STACK_ONLY
+	if ( decoder->flags & APP_JSON_FLAG_DYNAMIC )
+		result = (unsigned int *)(void *)
+			( decoder->tokens + decoder->size );
+	else
+#endif /* ifndef IOT_STACK_ONLY */
+	/* after the last token and the one marking the end */
+	if ( decoder->objs < decoder->size &&
+		( decoder->size - decoder->objs - 1u ) * sizeof( jsmntok_t ) >=
+		decoder->objs * sizeof( unsigned int ) )
+		result = (unsigned int *)(void *)
+			( decoder->tokens + decoder->objs + 1u );
+	return result;
+}
+#endif /* if !defined( IOT_JSON_JANSSON  ) && !defined( IOT_JSON_JSONC ) */
+
+/**
+ * @brief binds an item to the destination of a field
+ *
+ * @param[in]      decoder             JSON decoder object
+ * @param[in]      item                JSON item to bind
+ * @param[in]      field               field to bind the item to
+ * @param[in,out]  out                 structure to bind the item to
+ *
+ * @retval IOT_STATUS_BAD_REQUEST      @c item is not of the type of the field
+ * @retval IOT_STATUS_NOT_FOUND        a required field of a nested object was
+ *                                     not bound
+ * @retval IOT_STATUS_SUCCESS          on success
+ *
+ * @see app_json_decode_bind
+ */
+static iot_status_t app_json_decode_bind_field(
+	const app_json_decoder_t *decoder,
+	const app_json_item_t *item,
+	const app_json_bind_t *field,
+	void *out );
 
 iot_status_t app_json_decode_array_at(
 	const app_json_decoder_t *decoder,
@@ -176,27 +576,18 @@ iot_status_t app_json_decode_array_at(
 		result = IOT_STATUS_BAD_REQUEST;
 		if ( cur && cur->type == JSMN_ARRAY )
 		{
-			int array_idx = -1;
-			unsigned int idx = 0u;
-			unsigned int p_idx = 0u;
-
-			p_idx = (unsigned int)(cur - decoder->tokens);
-			idx = p_idx;
-			++cur;
-			++idx;
-			while ( obj == NULL && idx < decoder->objs )
+			unsigned int idx =
+				(unsigned int)(cur - decoder->tokens) + 1u;
+			if ( index < (size_t)cur->size )
 			{
-#ifdef JSMN_PARENT_LINKS
-				if ( cur->parent == (int)p_idx )
-					++array_idx;
-#else
-#error			/** @todo make this work without parent links */
-#endif /* ifdef JSMN_PARENT_LINKS */
-
-				if ( (size_t)array_idx == index )
-					obj = cur;
-				++cur;
-				++idx;
+				/* step over the elements before it */
+				while ( index > 0u && idx < decoder->objs )
+				{
+					idx = app_jsmn_decode_next( decoder, idx );
+					--index;
+				}
+				if ( idx < decoder->objs )
+					obj = &decoder->tokens[idx];
 			}
 
 			result = IOT_STATUS_NOT_FOUND;
@@ -291,35 +682,17 @@ const app_json_array_iterator_t *app_json_decode_array_iterator_next(
 			result = (app_json_array_iterator_t*)i;
 		}
 #else /* defined( IOT_JSON_JSMN ) */
-		const jsmntok_t *cur = (const jsmntok_t *)iter;
-		unsigned int idx;
+		const jsmntok_t *const cur = (const jsmntok_t *)iter;
 		const int obj_end_pos = ((const jsmntok_t*)item)->end;
-#ifdef JSMN_PARENT_LINKS
-		const int parent = (int)((const jsmntok_t *)item - decoder->tokens);
-#endif /* ifdef JSMN_PARENT_LINKS */
 
-		/* get index of current item */
-		idx = (unsigned int)(cur - decoder->tokens);
+		/* skip over the children of the current item */
+		const unsigned int idx = app_jsmn_decode_next( decoder,
+			(unsigned int)(cur - decoder->tokens) );
 
-		++cur;
-		++idx;
-#ifdef JSMN_PARENT_LINKS
-		while ( cur->start < obj_end_pos &&
-			cur->parent != parent &&
-			idx < decoder->objs )
-		{
-			++cur;
-			++idx;
-		}
-#else  /* ifdef JSMN_PARENT_LINKS */
-		/** @todo make this work without JSMN_PARENT_LINKS */
-#endif /* else JSMN_PARENT_LINKS */
-
-		result = cur;
 		/* hit end of list */
-		if ( idx >= decoder->objs ||
-			cur->start >= obj_end_pos )
-			result = NULL;
+		if ( idx < decoder->objs &&
+			decoder->tokens[idx].start < obj_end_pos )
+			result = &decoder->tokens[idx];
 #endif /* defined( IOT_JSON_JSMN ) */
 	}
 	return result;
@@ -348,6 +721,142 @@ size_t app_json_decode_array_size(
 	return result;
 }
 
+iot_status_t app_json_decode_bind(
+	const app_json_decoder_t *decoder,
+	const app_json_item_t *object,
+	const app_json_bind_t *fields,
+	size_t field_count,
+	void *out )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( decoder && object && fields && out &&
+		field_count <= APP_JSON_BIND_MAX )
+	{
+		result = IOT_STATUS_BAD_REQUEST;
+		if ( app_json_decode_type( decoder, object ) ==
+			APP_JSON_TYPE_OBJECT )
+		{
+			iot_uint32_t bound = 0u;
+			size_t i;
+			const app_json_object_iterator_t *iter =
+				app_json_decode_object_iterator( decoder, object );
+
+			/* one pass over the items, matching each to the fields */
+			while ( iter )
+			{
+				const char *key = NULL;
+				size_t key_len = 0u;
+				const app_json_item_t *value = NULL;
+				if ( app_json_decode_object_iterator_key( decoder,
+					object, iter, &key, &key_len ) ==
+						IOT_STATUS_SUCCESS &&
+					app_json_decode_object_iterator_value( decoder,
+						object, iter, &value ) ==
+						IOT_STATUS_SUCCESS )
+				{
+					for ( i = 0u; i < field_count; ++i )
+					{
+						const iot_uint32_t bit =
+							(iot_uint32_t)1u << i;
+						if ( !( bound & bit ) && fields[i].key &&
+							os_strncmp( fields[i].key, key,
+								key_len ) == 0 &&
+							fields[i].key[key_len] == '\0' &&
+							app_json_decode_bind_field( decoder,
+								value, &fields[i], out ) ==
+								IOT_STATUS_SUCCESS )
+							bound |= bit;
+					}
+				}
+				iter = app_json_decode_object_iterator_next(
+					decoder, object, iter );
+			}
+
+			result = IOT_STATUS_SUCCESS;
+			for ( i = 0u; i < field_count; ++i )
+			{
+				if ( ( fields[i].flags & APP_JSON_BIND_REQUIRED ) &&
+					!( bound & ( (iot_uint32_t)1u << i ) ) )
+					result = IOT_STATUS_NOT_FOUND;
+			}
+		}
+	}
+	return result;
+}
+
+iot_status_t app_json_decode_bind_field(
+	const app_json_decoder_t *decoder,
+	const app_json_item_t *item,
+	const app_json_bind_t *field,
+	void *out )
+{
+	iot_status_t result = IOT_STATUS_BAD_REQUEST;
+	char *const dest = (char *)out + field->offset;
+	switch ( field->type )
+	{
+	case APP_JSON_BIND_BOOL:
+		if ( field->size >= sizeof( iot_bool_t ) )
+		{
+			iot_bool_t value;
+			result = app_json_decode_bool( decoder, item, &value );
+			if ( result == IOT_STATUS_SUCCESS )
+				os_memcpy( dest, &value, sizeof( iot_bool_t ) );
+		}
+		break;
+	case APP_JSON_BIND_INTEGER:
+		if ( field->size >= sizeof( iot_int64_t ) &&
+			app_json_decode_type( decoder, item ) ==
+				APP_JSON_TYPE_INTEGER )
+		{
+			iot_int64_t value;
+			result = app_json_decode_integer( decoder, item, &value );
+			if ( result == IOT_STATUS_SUCCESS )
+				os_memcpy( dest, &value, sizeof( iot_int64_t ) );
+		}
+		break;
+	case APP_JSON_BIND_REAL:
+		if ( field->size >= sizeof( iot_float64_t ) )
+		{
+			iot_float64_t value;
+			result = app_json_decode_number( decoder, item, &value );
+			if ( result == IOT_STATUS_SUCCESS )
+				os_memcpy( dest, &value, sizeof( iot_float64_t ) );
+		}
+		break;
+	case APP_JSON_BIND_STRING:
+		if ( field->size > 0u &&
+			app_json_decode_type( decoder, item ) ==
+				APP_JSON_TYPE_STRING )
+		{
+			const char *value = NULL;
+			size_t value_len = 0u;
+			result = app_json_decode_string( decoder, item,
+				&value, &value_len );
+			if ( result == IOT_STATUS_SUCCESS )
+			{
+				if ( value_len >= field->size )
+					value_len = field->size - 1u;
+				os_memcpy( dest, value, value_len );
+				dest[value_len] = '\0';
+			}
+		}
+		break;
+	case APP_JSON_BIND_ITEM:
+		if ( field->size >= sizeof( const app_json_item_t * ) )
+		{
+			os_memcpy( dest, &item, sizeof( const app_json_item_t * ) );
+			result = IOT_STATUS_SUCCESS;
+		}
+		break;
+	case APP_JSON_BIND_OBJECT:
+		if ( field->fields )
+			result = app_json_decode_bind( decoder, item,
+				field->fields, field->field_count, out );
+		break;
+	}
+	return result;
+}
+
 iot_status_t app_json_decode_bool(
 	const app_json_decoder_t *decoder,
 	const app_json_item_t *item,
@@ -435,6 +944,8 @@ app_json_decoder_t *app_json_decode_initialize(
 		decoder = (struct app_json_decoder *)buf;
 		decoder->flags = flags;
 		decoder->j_root = NULL;
+		decoder->j_tok = NULL;
+		decoder->j_len = 0u;
 #else /* defined( IOT_JSON_JSMN ) */
 		const size_t max_objs =
 			(len - sizeof(struct app_json_decoder)) /
@@ -450,6 +961,9 @@ app_json_decoder_t *app_json_decode_initialize(
 			decoder->buf = NULL;
 			decoder->len = 0u;
 			decoder->tokens = NULL;
+#ifndef IOT_STACK_ONLY
+			decoder->hash = NULL;
+#endif /* ifndef IOT_STACK_ONLY */
 			if ( max_objs )
 			{
 				jsmntok_t *tok;
@@ -629,38 +1143,44 @@ const app_json_item_t *app_json_decode_object_find_len(
 		const jsmntok_t *cur = object;
 		if ( cur && cur->type == JSMN_OBJECT )
 		{
-			unsigned int idx = 0u;
-			unsigned int p_idx = 0u;
-			p_idx = (unsigned int)(cur - decoder->tokens);
-			idx = p_idx;
-			++cur;
-			++idx;
-			while ( result == NULL && idx < decoder->objs )
+#ifndef IOT_STACK_ONLY
+			const struct app_json_decode_hash *const hash =
+				app_jsmn_decode_hash( decoder, cur );
+#endif /* ifndef IOT_STACK_ONLY */
+			if ( key_len == 0u )
+				key_len = os_strlen( key );
+#ifndef IOT_STACK_ONLY
+			if ( hash )
 			{
-				if (
-#ifdef JSMN_PARENT_LINKS
-					cur->parent == (int)p_idx &&
-#endif /* ifdef JSMN_PARENT_LINKS */
-					cur->type == JSMN_STRING &&
-					cur->size == 1 )
+				unsigned int s = (unsigned int)
+					app_jsmn_decode_hash_key( key, key_len ) &
+					hash->mask;
+				while ( result == NULL && hash->slot[s] != 0u )
 				{
-					/* compare key */
-					size_t k = 0u;
-					const size_t k_len = (size_t)(cur->end - cur->start);
-
-					while ( (key_len == 0u || k < k_len) &&
-						decoder->buf[(size_t)(cur->start) + k] == key[k] )
-					{
-						++k;
-					}
-
-					/* match found */
-					if ( (key_len == 0u && key[k] == '\0')
-						|| (key_len > 0u && k == key_len) )
+					cur = &decoder->tokens[hash->slot[s] - 1u];
+					if ( app_jsmn_decode_key_equal( decoder, cur,
+						key, key_len ) != IOT_FALSE )
 						result = cur + 1;
+					s = ( s + 1u ) & hash->mask;
+				}
+			}
+			else
+#endif /* ifndef IOT_STACK_ONLY */
+			{
+				/* compare the keys only, skipping their values */
+				const int size = cur->size;
+				unsigned int idx =
+					(unsigned int)(cur - decoder->tokens) + 1u;
+				int i;
+				for ( i = 0; result == NULL && i < size &&
+					idx < decoder->objs; ++i )
+				{
+					cur = &decoder->tokens[idx];
+					if ( app_jsmn_decode_key_equal( decoder, cur,
+						key, key_len ) != IOT_FALSE )
+						result = cur + 1;
+					idx = app_jsmn_decode_next( decoder, idx );
 				}
-				++cur;
-				++idx;
 			}
 		}
 #endif /* defined( IOT_JSON_JSMN ) */
@@ -775,35 +1295,17 @@ const app_json_object_iterator_t *app_json_decode_object_iterator_next(
 		if ( !json_object_iter_equal( &i, &i_end ) )
 			result = i.opaque_;
 #else /* defined( IOT_JSON_JSMN ) */
-		const jsmntok_t *cur = iter;
-		unsigned int idx;
+		const jsmntok_t *const cur = iter;
 		const int obj_end_pos = ((const jsmntok_t*)item)->end;
-#ifdef JSMN_PARENT_LINKS
-		const int parent = (int)((const jsmntok_t *)item - decoder->tokens);
-#endif /* ifdef JSMN_PARENT_LINKS */
-
-		/* get index of current item */
-		idx = (unsigned int)(cur - decoder->tokens);
 
-		++cur;
-		++idx;
-#ifdef JSMN_PARENT_LINKS
-		while ( cur->start < obj_end_pos &&
-			cur->parent != parent &&
-			idx < decoder->objs )
-		{
-			++cur;
-			++idx;
-		}
-#else  /* ifdef JSMN_PARENT_LINKS */
-		/** @todo make this work without JSMN_PARENT_LINKS */
-#endif /* else JSMN_PARENT_LINKS */
+		/* skip over the children of the current item */
+		const unsigned int idx = app_jsmn_decode_next( decoder,
+			(unsigned int)(cur - decoder->tokens) );
 
-		result = cur;
 		/* hit end of list */
-		if ( idx >= decoder->objs ||
-			cur->start >= obj_end_pos )
-			result = NULL;
+		if ( idx < decoder->objs &&
+			decoder->tokens[idx].start < obj_end_pos )
+			result = &decoder->tokens[idx];
 #endif /* endif( IOT_JSON_JSMN ) */
 	}
 	return result;
@@ -916,115 +1418,177 @@ iot_status_t app_json_decode_parse(
 		if ( tok )
 			json_tokener_free(tok);
 #else /* defined( IOT_JSON_JSMN ) */
-		jsmn_parser parser;
-		const char *error_text = NULL;
-		int i;
-		result = IOT_STATUS_PARSE_ERROR;
+		int i = JSMN_ERROR_NOMEM;
+		decoder->objs = 0u;
+		decoder->buf = NULL;
 #ifndef IOT_STACK_ONLY
+		app_jsmn_decode_hash_free( decoder );
 		if ( decoder->flags & APP_JSON_FLAG_DYNAMIC )
 		{
-			i = JSMN_ERROR_NOMEM;
-			if ( !decoder->tokens )
+			/* size the tokens from a count of the document, instead
+			 * of growing them and parsing again (one more is kept
+			 * as the end marker for the iterators); the index built
+			 * while counting saves scanning the document twice */
+			iot_uint64_t *const index = (iot_uint64_t *)
+				app_json_realloc( NULL, sizeof( iot_uint64_t ) *
+					APP_JSON_TOKEN_INDEX_LEN( len ) );
+			const size_t count =
+				app_json_token_index( js, &len, index ) + 1u;
+			if ( !decoder->tokens || decoder->size < count )
 			{
-				decoder->size = 1u;
-				decoder->tokens =
-					(jsmntok_t*)app_json_realloc( NULL,
-					sizeof( jsmntok_t ) * decoder->size );
-			}
-			while ( i == JSMN_ERROR_NOMEM && decoder->tokens )
-			{
-				jsmn_init( &parser );
-				i = jsmn_parse( &parser, js, len,
-					decoder->tokens, decoder->size );
-				if ( i == JSMN_ERROR_NOMEM )
+				jsmntok_t *const tokens = (jsmntok_t *)
+					app_json_realloc( decoder->tokens,
+						( sizeof( jsmntok_t ) +
+						  sizeof( unsigned int ) ) * count );
+				if ( tokens )
 				{
-					jsmntok_t *tokens;
-					decoder->size = (decoder->size + 1) * 2u;
-					tokens = app_json_realloc(
-						decoder->tokens,
-						sizeof( jsmntok_t ) * decoder->size );
-					if ( tokens )
-					{
-						size_t j = 0u;
-
-						decoder->tokens = tokens;
-
-						/* initialize tokens */
-						while ( j < decoder->size )
-						{
-							decoder->tokens[j].type = JSMN_UNDEFINED;
-							decoder->tokens[j].start = 0;
-							decoder->tokens[j].end = 0;
-							decoder->tokens[j].size = 0;
-#ifdef JSMN_PARENT_LINKS
-							decoder->tokens[j].parent = 0;
-#endif /* ifdef JSMN_PARENT_LINKS */
-							++j;
-						}
-					}
-					else
-					{
-						app_json_free( decoder->tokens );
-						decoder->size = 0u;
-					}
+					decoder->tokens = tokens;
+					decoder->size = (unsigned int)count;
 				}
 			}
+			if ( decoder->tokens )
+				i = app_json_token_parse( js, len, index,
+					decoder->tokens, decoder->size );
+			if ( index )
+				app_json_free( index );
 		}
 		else
 #endif /* ifndef IOT_STACK_ONLY */
+		if ( decoder->tokens )
+			i = app_json_token_parse( js, len, NULL,
+				decoder->tokens, decoder->size );
+		result = app_jsmn_decode_parsed( decoder, js, len, i, root,
+			error, error_len );
+#endif /* defined( IOT_JSON_JSMN ) */
+	}
+	if ( result == IOT_STATUS_SUCCESS && error && error_len > 0u )
+		*error = '\0';
+	return result;
+}
+
+iot_status_t app_json_decode_parse_chunk(
+	app_json_decoder_t *decoder,
+	const char *js,
+	size_t len,
+	iot_bool_t more,
+	const app_json_item_t **root,
+	char *error,
+	size_t error_len )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( decoder && root && js && len > 0u )
+	{
+#if defined( IOT_JSON_JANSSON )
+		/* jansson only parses whole documents */
+		result = IOT_STATUS_TRY_AGAIN;
+		if ( more == IOT_FALSE )
+			result = app_json_decode_parse( decoder, js, len, root,
+				error, error_len );
+#elif defined( IOT_JSON_JSONC )
+		enum json_tokener_error j_error = json_tokener_continue;
+		result = IOT_STATUS_NO_MEMORY;
+		if ( !decoder->j_tok )
 		{
-			size_t j;
-			jsmn_init( &parser );
-			for ( j = 0u; j < decoder->size; ++j )
+			decoder->j_tok = json_tokener_new();
+			decoder->j_len = 0u;
+		}
+		if ( decoder->j_tok )
+		{
+			/* only the characters not given to the tokener yet */
+			if ( len > decoder->j_len )
 			{
-				decoder->tokens[j].type = JSMN_UNDEFINED;
-				decoder->tokens[j].start = 0;
-				decoder->tokens[j].end = 0;
-				decoder->tokens[j].size = 0;
-#ifdef JSMN_PARENT_LINKS
-				decoder->tokens[j].parent = 0;
-#endif /* ifdef JSMN_PARENT_LINKS */
+				decoder->j_root = json_tokener_parse_ex(
+					decoder->j_tok, &js[decoder->j_len],
+					(int)( len - decoder->j_len ) );
+				decoder->j_len = len;
+				j_error = json_tokener_get_error( decoder->j_tok );
 			}
 
-			i = jsmn_parse( &parser, js, len,
-				decoder->tokens, decoder->size );
-		}
+			/* a null character ends a number at the end */
+			if ( j_error == json_tokener_continue &&
+				more == IOT_FALSE )
+			{
+				decoder->j_root = json_tokener_parse_ex(
+					decoder->j_tok, "", 1 );
+				j_error = json_tokener_get_error( decoder->j_tok );
+			}
 
-		if ( i == JSMN_ERROR_NOMEM )
-		{
-			error_text = "out of memory";
-			result = IOT_STATUS_NO_MEMORY;
+			result = IOT_STATUS_TRY_AGAIN;
+			if ( decoder->j_root && j_error == json_tokener_success )
+			{
+				*root = decoder->j_root;
+				result = IOT_STATUS_SUCCESS;
+			}
+			else if ( j_error != json_tokener_continue ||
+				more == IOT_FALSE )
+			{
+				os_snprintf( error, error_len,
+					"%s", json_tokener_error_desc( j_error ) );
+
+				if ( decoder->j_root )
+					json_object_put( decoder->j_root );
+				decoder->j_root = NULL;
+				result = IOT_STATUS_PARSE_ERROR;
+			}
+
+			if ( result != IOT_STATUS_TRY_AGAIN )
+			{
+				json_tokener_free( decoder->j_tok );
+				decoder->j_tok = NULL;
+				decoder->j_len = 0u;
+			}
 		}
-		else if ( i == JSMN_ERROR_INVAL )
-			error_text = "invalid character";
-		else if ( i == JSMN_ERROR_PART )
-			error_text = "incomplete json string";
-		else if ( i < 0 )
-			error_text = "unknown error encountered";
-		else
+#else /* defined( IOT_JSON_JSMN ) */
+		unsigned int num_tokens = decoder->size;
+		unsigned int toknext = 0u;
+		int i = JSMN_ERROR_NOMEM;
+
+		/* until a document is complete, the decoder keeps the
+		 * number of tokens built so far, without a buffer */
+		if ( !decoder->buf )
+			toknext = decoder->objs;
+		decoder->objs = 0u;
+		decoder->buf = NULL;
+#ifndef IOT_STACK_ONLY
+		app_jsmn_decode_hash_free( decoder );
+		/* one more is kept as the end marker for the iterators */
+		if ( decoder->flags & APP_JSON_FLAG_DYNAMIC && num_tokens > 0u )
+			--num_tokens;
+#endif /* ifndef IOT_STACK_ONLY */
+		if ( decoder->tokens )
+			i = app_json_token_parse_resume( js, len,
+				decoder->tokens, num_tokens, &toknext );
+#ifndef IOT_STACK_ONLY
+		/* grow the tokens and carry on from the last one built,
+		 * instead of parsing the document again */
+		while ( i == JSMN_ERROR_NOMEM &&
+			decoder->flags & APP_JSON_FLAG_DYNAMIC )
 		{
-			decoder->objs = (unsigned int)i;
-			decoder->buf = js;
-			decoder->len = len;
-			*root = decoder->tokens;
-			result = IOT_STATUS_SUCCESS;
+			size_t count = app_json_token_index( js, &len, NULL ) + 1u;
+			jsmntok_t *tokens;
+			if ( count < (size_t)decoder->size * 2u )
+				count = (size_t)decoder->size * 2u;
+			tokens = (jsmntok_t *)app_json_realloc( decoder->tokens,
+				( sizeof( jsmntok_t ) + sizeof( unsigned int ) ) *
+				count );
+			if ( !tokens )
+				break;
+			decoder->tokens = tokens;
+			decoder->size = (unsigned int)count;
+			i = app_json_token_parse_resume( js, len,
+				decoder->tokens, decoder->size - 1u, &toknext );
 		}
+#endif /* ifndef IOT_STACK_ONLY */
 
-		/* copy error text */
-		if ( error && error_len > 0u && error_text )
+		if ( more != IOT_FALSE &&
+			( i == JSMN_ERROR_PART || i == 0 ) )
 		{
-			size_t j = 0u;
-			--error_len;
-			while ( j < error_len && *error_text != '\0' )
-			{
-				*error = *error_text;
-				++error;
-				++error_text;
-				++j;
-			}
-			if ( j <= error_len )
-				*error = '\0';
+			decoder->objs = toknext;
+			result = IOT_STATUS_TRY_AGAIN;
 		}
+		else
+			result = app_jsmn_decode_parsed( decoder, js, len, i,
+				root, error, error_len );
 #endif /* defined( IOT_JSON_JSMN ) */
 	}
 	if ( result == IOT_STATUS_SUCCESS && error && error_len > 0u )
@@ -1143,8 +1707,11 @@ void app_json_decode_terminate(
 				json_object_put( decoder->j_root );
 			json_tokener_free( tok );
 		}
+		if ( decoder->j_tok )
+			json_tokener_free( decoder->j_tok );
 #else /* defined( IOT_JSON_JSMN ) */
 #if !defined( IOT_STACK_ONLY )
+		app_jsmn_decode_hash_free( decoder );
 		if ( decoder->flags & APP_JSON_FLAG_DYNAMIC && decoder->tokens )
 			app_json_free( decoder->tokens );
 #endif /* if !defined( IOT_STACK_ONLY ) */
@@ -95,18 +95,6 @@ static const char JSON_CHARS_END[] = { ']', '}', '}' };
 static unsigned int app_json_encode_depth(
 	const app_json_encoder_t *encoder );
 
-/**
- * @brief calculated the number number of printable characters in an integer
- *
- * @param[in]      i                   integer to calculate number of characters
- * @param[in]      neg                 add characters for negative number
- *
- * @return number of printable characters in the number
- */
-static size_t app_json_encode_intlen(
-	uint64_t i,
-	iot_bool_t neg );
-
 /**
  * @brief helper function to start a new object
  *
@@ -124,35 +112,18 @@ static iot_status_t app_json_encode_key(
 	iot_bool_t *added_parent );
 
 /**
- * @brief helper function to calculate the length of a string for encoding
- *        in JSON
- *
- * @note This function handles adding counts for extra characters required to
- *       black-slash characters in JSON string
- *
- * @param[in]      str                 sring to get length of
- *
- * @return the length of the string in characters (adding for escape characters)
- */
-static size_t app_json_encode_strlen(
-	const char* str );
-
-/**
- * @brief copies the string in src to the destination buffer in JSON format
+ * @brief helper function to add an already formatted value
  *
- * @note This function handles adding escape characters into the destination
- *       buffer when copying the string
- *
- * @param[in,out]  dest                destination buffer
- * @param[in]      src                 source buffer
- * @param[in]      num                 size of the destination buffer
- *
- * @return a pointer to the destination buffer
+ * @param[in,out]  encoder             JSON encoder object
+ * @param[in]      key                 (optional) key for the new item
+ * @param[in]      value               formatted value
+ * @param[in]      value_len           length of the formatted value
  */
-static char *app_json_encode_strncpy(
-	char *dest,
-	const char *src,
-	size_t num );
+static iot_status_t app_json_encode_value(
+	app_json_encoder_t *encoder,
+	const char *key,
+	const char *value,
+	size_t value_len );
 
 /**
  * @brief helper function for starting a new JSON object or array structure
@@ -176,6 +147,139 @@ static iot_status_t app_json_encode_struct_start(
 	app_json_type_t s );
 #endif /* defined( IOT_JSON_JSMN ) */
 
+/**
+ * @brief Maximum supportable json depth of a stream
+ */
+#define JSON_STREAM_MAX_DEPTH          ( sizeof( iot_uint64_t ) * 8u )
+
+/**
+ * @brief Minimum size of the output buffer of a stream (an escaped
+ *        character is at most 6 characters)
+ */
+#define JSON_STREAM_MIN_LEN            16u
+
+/**
+ * @brief internal structure for streaming JSON messages to a sink
+ *
+ * The output is written as items are added, for all JSON libraries, so only
+ * the levels that are open are tracked.
+ */
+struct app_json_stream
+{
+	app_json_stream_sink_t sink;     /**< @brief function writing output */
+	void *user_data;                 /**< @brief user data for the sink */
+	char *buf;                       /**< @brief output buffer */
+	size_t len;                      /**< @brief size of output buffer */
+	size_t used;                     /**< @brief characters in output buffer */
+	unsigned int flags;              /**< @brief output flags */
+	unsigned int depth;              /**< @brief current depth */
+	iot_uint64_t objects;            /**< @brief bit set for each level that
+	                                      is an object (current level is
+	                                      the lowest bit) */
+	iot_bool_t first;                /**< @brief whether no item has been
+	                                      added at the current level */
+	iot_status_t status;             /**< @brief status of the sink */
+};
+
+/**
+ * @brief helper function to write a string with JSON escape sequences to a
+ *        stream
+ *
+ * @param[in,out]  stream              JSON stream object
+ * @param[in]      src                 string to write
+ * @param[in]      src_len             length of the string to write
+ *
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ */
+static iot_status_t app_json_stream_escape(
+	app_json_stream_t *stream,
+	const char *src,
+	size_t src_len );
+
+/**
+ * @brief helper function to write a character a number of times to a stream
+ *
+ * @param[in,out]  stream              JSON stream object
+ * @param[in]      ch                  character to write
+ * @param[in]      count               number of times to write it
+ *
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ */
+static iot_status_t app_json_stream_fill(
+	app_json_stream_t *stream,
+	char ch,
+	size_t count );
+
+/**
+ * @brief helper function to start a new item in a stream
+ *
+ * @param[in,out]  stream              JSON stream object
+ * @param[in]      key                 (optional) key for the new item
+ *
+ * @retval IOT_STATUS_BAD_PARAMETER    bad parameter passed to the function
+ * @retval IOT_STATUS_BAD_REQUEST      the item can't be added at this level
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ */
+static iot_status_t app_json_stream_key(
+	app_json_stream_t *stream,
+	const char *key );
+
+/**
+ * @brief helper function for ending a JSON object or array in a stream
+ *
+ * @param[in,out]  stream              JSON stream object
+ * @param[in]      is_object           whether ending an object (or an array)
+ */
+static iot_status_t app_json_stream_struct_end(
+	app_json_stream_t *stream,
+	iot_bool_t is_object );
+
+/**
+ * @brief helper function for starting a JSON object or array in a stream
+ *
+ * @param[in,out]  stream              JSON stream object
+ * @param[in]      key                 (optional) key for the new item
+ * @param[in]      is_object           whether starting an object (or an
+ *                                     array)
+ */
+static iot_status_t app_json_stream_struct_start(
+	app_json_stream_t *stream,
+	const char *key,
+	iot_bool_t is_object );
+
+/**
+ * @brief helper function to add an already formatted value to a stream
+ *
+ * @param[in,out]  stream              JSON stream object
+ * @param[in]      key                 (optional) key for the new item
+ * @param[in]      value               formatted value
+ * @param[in]      value_len           length of the formatted value
+ */
+static iot_status_t app_json_stream_value(
+	app_json_stream_t *stream,
+	const char *key,
+	const char *value,
+	size_t value_len );
+
+/**
+ * @brief helper function to write characters to a stream, giving the output
+ *        buffer to the sink each time it is full
+ *
+ * @param[in,out]  stream              JSON stream object
+ * @param[in]      data                characters to write
+ * @param[in]      len                 number of characters to write
+ *
+ * @retval IOT_STATUS_SUCCESS          on success
+ * @return the status returned by the sink, if writing failed
+ */
+static iot_status_t app_json_stream_write(
+	app_json_stream_t *stream,
+	const char *data,
+	size_t len );
+
 #if defined( IOT_JSON_JANSSON ) || defined( IOT_JSON_JSONC )
 iot_status_t app_json_encode_key(
 	app_json_encoder_t *encoder,
@@ -598,67 +702,20 @@ iot_status_t app_json_encode_integer(
 #elif defined( IOT_JSON_JSONC )
 	result = app_json_encode_key( encoder, key, json_object_new_int64( value ) );
 #else /* defined( IOT_JSON_JSMN ) */
-	/* can't add boolean as root element */
-	if ( !key && ( encoder && encoder->structs == 0u ) )
-		result = IOT_STATUS_BAD_REQUEST;
+	char num[APP_JSON_NUMBER_MAX_LEN];
+	size_t value_len;
+	if ( value < 0 )
+		value_len = app_json_number_integer( num,
+			(iot_uint64_t)0u - (iot_uint64_t)value, IOT_TRUE );
 	else
-	{
-		iot_bool_t added_parent = IOT_FALSE;
-		uint64_t pos_value;
-		size_t value_len;
-		if ( value < 0 )
-			pos_value = (uint64_t)(value * -1);
-		else
-			pos_value = (uint64_t)value;
-
-		value_len = app_json_encode_intlen( pos_value, value < 0 );
-		result = app_json_encode_key( encoder, key, value_len,
-			&added_parent );
-		if ( result == IOT_STATUS_SUCCESS )
-		{
-			char *dest = &encoder->cur[value_len - 1u];
-			if ( value <= 0 )
-			{
-				if ( value < 0 )
-				{
-					*encoder->cur = '-';
-					value *= -1;
-				}
-				else
-					*encoder->cur = '0';
-				++encoder->cur;
-			}
-			while ( pos_value > 0 )
-			{
-				*dest = (pos_value % 10 + '0');
-				pos_value /= 10;
-				--dest;
-				++encoder->cur;
-			}
-
-			if ( added_parent )
-				result = app_json_encode_struct_end( encoder,
-					APP_JSON_TYPE_OBJECT << 1u );
-		}
-	}
+		value_len = app_json_number_integer( num,
+			(iot_uint64_t)value, IOT_FALSE );
+	result = app_json_encode_value( encoder, key, num, value_len );
 #endif /* defined( IOT_JSON_JSMN ) */
 	return result;
 }
 
 #if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
-size_t app_json_encode_intlen( uint64_t i, iot_bool_t neg )
-{
-	size_t len = 0u;
-	if ( neg || i == 0 )
-		++len;
-	while ( i > 0 )
-	{
-		i /= 10;
-		++len;
-	}
-	return len;
-}
-
 iot_status_t app_json_encode_key(
 	app_json_encoder_t *encoder,
 	const char *key,
@@ -689,10 +746,14 @@ iot_status_t app_json_encode_key(
 
 		if ( key )
 		{
-			key_len = app_json_encode_strlen( key );
+			key_len = app_json_string_escape_len( key,
+				os_strlen( key ) );
 			extra_space += 3u; /* for '"' around key, ':' */
 		}
 
+		if ( !encoder->cur )
+			encoder->cur = encoder->buf;
+
 		if ( result == IOT_STATUS_SUCCESS )
 		{
 			size_t space = encoder->len - (size_t)(encoder->cur - encoder->buf);
@@ -727,13 +788,23 @@ iot_status_t app_json_encode_key(
 			/* how much space is required to indent/close the object */
 			if ( indent )
 				extra_space += ( indent * 2u * depth ) + 1u; /* +1 for '\n' */
+			else
+				/* closing the open objects and arrays, and '\0' (as
+				 * app_json_encode_dump adds them without checking) */
+				extra_space += depth + 1u;
 
 #ifndef IOT_STACK_ONLY
-			if ( encoder->flags & APP_JSON_FLAG_DYNAMIC )
+			/* grow geometrically, so a reused encoder stops allocating */
+			if ( ( encoder->flags & APP_JSON_FLAG_DYNAMIC ) &&
+				key_len + value_len + extra_space > space )
 			{
-				const size_t new_space =
-					encoder->len + key_len + value_len + extra_space;
-				void *const new_buf = app_json_realloc(
+				size_t new_space = encoder->len * 2u;
+				void *new_buf;
+				if ( new_space < encoder->len + key_len +
+					value_len + extra_space )
+					new_space = encoder->len + key_len +
+						value_len + extra_space;
+				new_buf = app_json_realloc(
 					encoder->buf, new_space + 1u );
 				if ( new_buf )
 				{
@@ -741,15 +812,11 @@ iot_status_t app_json_encode_key(
 						(encoder->cur - encoder->buf);
 					encoder->buf = new_buf;
 					encoder->len = new_space;
-					space = new_space;
+					space = new_space -
+						(size_t)(encoder->cur - encoder->buf);
 				}
 			}
-			else
 #endif /* ifndef IOT_STACK_ONLY */
-			{
-				if ( !encoder->cur )
-					encoder->cur = encoder->buf;
-			}
 
 			if ( key_len + value_len + extra_space <= space )
 			{
@@ -782,8 +849,8 @@ iot_status_t app_json_encode_key(
 				{
 					*encoder->cur = '"';
 					++encoder->cur;
-					app_json_encode_strncpy(
-						encoder->cur, key, key_len );
+					app_json_string_escape( encoder->cur,
+						key, os_strlen( key ), key_len );
 					encoder->cur += key_len;
 					os_strncpy( encoder->cur, "\":", 2u );
 					encoder->cur += 2u;
@@ -1055,84 +1122,104 @@ iot_status_t app_json_encode_object_start(
 	return result;
 }
 
-/**
- * @def JSON_ENCODE_MAX_DECIMALS
- * @brief number of decimals to display for real data
- */
-#define JSON_ENCODE_MAX_DECIMALS 6
-
 iot_status_t app_json_encode_real(
 	app_json_encoder_t *encoder,
 	const char *key,
 	double value )
+{
+	return app_json_encode_real_precision( encoder, key, value,
+		APP_JSON_PRECISION_SHORTEST );
+}
+
+iot_status_t app_json_encode_real_precision(
+	app_json_encoder_t *encoder,
+	const char *key,
+	double value,
+	int precision )
 {
 	iot_status_t result;
 #if defined( IOT_JSON_JANSSON )
+	/* jansson chooses the digits written, so round the value instead */
+	if ( precision >= 0 )
+	{
+		char num[APP_JSON_NUMBER_MAX_LEN + 1u];
+		const size_t num_len =
+			app_json_number_real( num, value, precision );
+		num[num_len] = '\0';
+		if ( num_len > 0u )
+			value = os_atof( num );
+	}
 	result = app_json_encode_key( encoder, key, json_real( value ) );
 #elif defined( IOT_JSON_JSONC )
-	result = app_json_encode_key( encoder, key, json_object_new_double( value ) );
-#else /* defined( IOT_JSON_JSMN ) */
-	/* can't add boolean as root element */
-	if ( !key && ( encoder && encoder->structs == 0u ) )
-		result = IOT_STATUS_BAD_REQUEST;
+	json_t *obj = NULL;
+	if ( precision == APP_JSON_PRECISION_SHORTEST )
+		obj = json_object_new_double( value );
 	else
 	{
-		iot_bool_t added_parent = 0;
-
-		uint64_t i = (uint64_t)value;
-		double frac = value - i;
-		size_t int_len;
-		size_t value_len;
+		char num[APP_JSON_NUMBER_MAX_LEN + 1u];
+		const size_t num_len =
+			app_json_number_real( num, value, precision );
+		num[num_len] = '\0';
+		if ( num_len > 0u )
+			obj = json_object_new_double_s( value, num );
+	}
+	result = app_json_encode_key( encoder, key, obj );
+#else /* defined( IOT_JSON_JSMN ) */
+	char num[APP_JSON_NUMBER_MAX_LEN];
+	const size_t value_len =
+		app_json_number_real( num, value, precision );
+	/* NaN & infinity can't be represented in JSON */
+	if ( value_len == 0u )
+		result = IOT_STATUS_BAD_PARAMETER;
+	else
+		result = app_json_encode_value( encoder, key, num, value_len );
+#endif /* defined( IOT_JSON_JSMN ) */
+	return result;
+}
 
-		/* handle negative numbers */
-		if ( value < 0.0 )
+iot_status_t app_json_encode_reset(
+	app_json_encoder_t *encoder )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( encoder )
+	{
+#if defined( IOT_JSON_JANSSON ) || defined( IOT_JSON_JSONC )
+		/* the object tree is rebuilt for each message */
+		if ( encoder->output )
 		{
-			i = (uint64_t)(value * -1.0);
-			frac = (value * -1.0) - i;
+#if defined( IOT_JSON_JANSSON )
+			json_free_t free_fn = os_free;
+#if JANSSON_VERSION_HEX >= 0x020800
+			json_get_alloc_funcs( NULL, &free_fn );
+#endif /* if JANSSON_VERSION_HEX >= 0x020800 */
+			if ( free_fn )
+				free_fn( encoder->output );
+#else /* if defined( IOT_JSON_JANSSON ) */
+			app_json_free( encoder->output );
+#endif /* else if defined( IOT_JSON_JANSSON ) */
+			encoder->output = NULL;
 		}
-
-		int_len = app_json_encode_intlen( i, value < 0.0 );
-		value_len = int_len + JSON_ENCODE_MAX_DECIMALS + 1u;
-		result = app_json_encode_key( encoder, key, value_len, &added_parent );
-		if ( result == IOT_STATUS_SUCCESS )
+		if ( encoder->j_cur && encoder->depth > 0u )
 		{
-			char *dest = &encoder->cur[int_len - 1u];
-			if ( value < 0.0 )
-			{
-				*encoder->cur = '-';
-				++encoder->cur;
-			}
-
-			if ( i == 0 )
-			{
-				*encoder->cur = '0';
-				++encoder->cur;
-			}
-
-			while ( i > 0u )
-			{
-				*dest = (i % 10 + '0');
-				i /= 10;
-				--dest;
-				++encoder->cur;
-			}
-
-			*encoder->cur++ = '.';
-			i = 0u;
-			do {
-				int j;
-				frac *= 10.0;
-				j = (int)(frac);
-				*encoder->cur++ = '0' + (char)j;
-				frac -= j;
-				++i;
-			} while ( frac > 0.0 && i < JSON_ENCODE_MAX_DECIMALS );
-			if ( added_parent )
-				result = app_json_encode_struct_end( encoder,
-					APP_JSON_TYPE_OBJECT << 1u );
+#if defined( IOT_JSON_JANSSON )
+			json_decref( encoder->j_cur[0] );
+#else /* if defined( IOT_JSON_JANSSON ) */
+			json_object_put( encoder->j_cur[0] );
+#endif /* else if defined( IOT_JSON_JANSSON ) */
 		}
-	}
+		if ( encoder->j_cur )
+			app_json_free( encoder->j_cur );
+		encoder->j_cur = NULL;
+		encoder->depth = 0u;
+#else /* defined( IOT_JSON_JSMN ) */
+		/* keep the buffer, only the write position is reset */
+		encoder->cur = encoder->buf;
+		if ( encoder->buf )
+			*encoder->buf = '\0';
+		encoder->structs = 0u;
 #endif /* defined( IOT_JSON_JSMN ) */
+		result = IOT_STATUS_SUCCESS;
+	}
 	return result;
 }
 
@@ -1156,18 +1243,20 @@ iot_status_t app_json_encode_string(
 	else
 	{
 		iot_bool_t added_parent = 0;
+		size_t len;
 		size_t value_len;
 
 		if ( !value )
 			value = "";
-		value_len = app_json_encode_strlen( value );
+		len = os_strlen( value );
+		value_len = app_json_string_escape_len( value, len );
 		result = app_json_encode_key( encoder, key, value_len + 2u,
 			&added_parent );
 		if ( encoder && result == IOT_STATUS_SUCCESS )
 		{
 			*encoder->cur++ = '"';
-			app_json_encode_strncpy(
-				encoder->cur, value, value_len );
+			app_json_string_escape( encoder->cur,
+				value, len, value_len );
 			encoder->cur += value_len;
 			*encoder->cur++ = '"';
 			if ( added_parent )
@@ -1180,81 +1269,6 @@ iot_status_t app_json_encode_string(
 }
 
 #if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
-size_t app_json_encode_strlen(
-	const char* str )
-{
-	size_t result = 0u;
-	while ( *str != '\0' )
-	{
-		/* add additional character for null-terminator */
-		if ( *str == '\"' || *str == '\\' || *str == '\b' ||
-		     *str == '\f' || *str == '\n' || *str == '\r' ||
-		     *str == '\t' )
-			++result;
-		++result;
-		++str;
-	}
-	return result;
-}
-
-char *app_json_encode_strncpy(
-	char *dest,
-	const char *src,
-	size_t num )
-{
-	iot_bool_t skip_char = IOT_FALSE;
-	char *out = dest;
-	size_t i = 0u;
-	while ( i < num && *src != '\0' )
-	{
-		if ( *src == '\"' || *src == '\\' || *src == '\b' ||
-		     *src == '\f' || *src == '\n' || *src == '\r' ||
-		     *src == '\t' )
-		{
-			if ( i + 1u < num )
-			{
-				*out = '\\';
-				++out;
-				++i;
-			}
-			else
-				skip_char = IOT_TRUE;
-		}
-
-		if ( skip_char == IOT_FALSE )
-		{
-			switch ( *src )
-			{
-			case '\b':
-				*out = 'b';
-				break;
-			case '\f':
-				*out = 'f';
-				break;
-			case '\n':
-				*out = 'n';
-				break;
-			case '\r':
-				*out = 'r';
-				break;
-			case '\t':
-				*out = 't';
-				break;
-			default:
-				*out = *src;
-			}
-			++src;
-			++out;
-			++i;
-		}
-	}
-
-	/* pad remaining with zero's */
-	for ( ; i < num; ++i )
-		*out = '\0';
-	return dest;
-}
-
 iot_status_t app_json_encode_struct_end(
 	app_json_encoder_t *encoder,
 	app_json_type_t s )
@@ -1373,6 +1387,33 @@ iot_status_t app_json_encode_struct_start(
 	}
 	return result;
 }
+
+iot_status_t app_json_encode_value(
+	app_json_encoder_t *encoder,
+	const char *key,
+	const char *value,
+	size_t value_len )
+{
+	iot_status_t result;
+	/* can't add a value as root element */
+	if ( !key && ( encoder && encoder->structs == 0u ) )
+		result = IOT_STATUS_BAD_REQUEST;
+	else
+	{
+		iot_bool_t added_parent = IOT_FALSE;
+		result = app_json_encode_key( encoder, key, value_len,
+			&added_parent );
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			os_memcpy( encoder->cur, value, value_len );
+			encoder->cur += value_len;
+			if ( added_parent )
+				result = app_json_encode_struct_end( encoder,
+					APP_JSON_TYPE_OBJECT << 1u );
+		}
+	}
+	return result;
+}
 #endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
 
 void app_json_encode_terminate(
@@ -1422,3 +1463,515 @@ void app_json_encode_terminate(
 #endif /* else if defined( IOT_STACK_ONLY ) */
 }
 
+iot_status_t app_json_encode_unsigned(
+	app_json_encoder_t *encoder,
+	const char *key,
+	iot_uint64_t value )
+{
+	iot_status_t result;
+#if defined( IOT_JSON_JANSSON )
+	/* jansson only supports signed integers */
+	if ( value > (iot_uint64_t)INT64_MAX )
+		result = app_json_encode_key( encoder, key,
+			json_real( (double)value ) );
+	else
+		result = app_json_encode_key( encoder, key,
+			json_integer( (json_int_t)value ) );
+#elif defined( IOT_JSON_JSONC )
+#if defined( JSON_C_VERSION_NUM ) && JSON_C_VERSION_NUM >= ( 14 << 8 )
+	result = app_json_encode_key( encoder, key,
+		json_object_new_uint64( value ) );
+#else /* if JSON_C_VERSION_NUM >= 0.14 */
+	if ( value > (iot_uint64_t)INT64_MAX )
+		result = app_json_encode_key( encoder, key,
+			json_object_new_double( (double)value ) );
+	else
+		result = app_json_encode_key( encoder, key,
+			json_object_new_int64( (int64_t)value ) );
+#endif /* else if JSON_C_VERSION_NUM >= 0.14 */
+#else /* defined( IOT_JSON_JSMN ) */
+	char num[APP_JSON_NUMBER_MAX_LEN];
+	const size_t value_len =
+		app_json_number_integer( num, value, IOT_FALSE );
+	result = app_json_encode_value( encoder, key, num, value_len );
+#endif /* defined( IOT_JSON_JSMN ) */
+	return result;
+}
+
+iot_status_t app_json_stream_array_end(
+	app_json_stream_t *stream )
+{
+	return app_json_stream_struct_end( stream, IOT_FALSE );
+}
+
+iot_status_t app_json_stream_array_start(
+	app_json_stream_t *stream,
+	const char *key )
+{
+	return app_json_stream_struct_start( stream, key, IOT_FALSE );
+}
+
+iot_status_t app_json_stream_bool(
+	app_json_stream_t *stream,
+	const char *key,
+	iot_bool_t value )
+{
+	iot_status_t result;
+	if ( value )
+		result = app_json_stream_value( stream, key, "true", 4u );
+	else
+		result = app_json_stream_value( stream, key, "false", 5u );
+	return result;
+}
+
+iot_status_t app_json_stream_escape(
+	app_json_stream_t *stream,
+	const char *src,
+	size_t src_len )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	while ( src_len > 0u && result == IOT_STATUS_SUCCESS )
+	{
+		/* escape only as much as is sure to fit, 6 characters for
+		 * each character in the worst case ("\\u00XX") */
+		const size_t space = stream->len - stream->used;
+		size_t run = space / 6u;
+		if ( run == 0u )
+			result = app_json_stream_flush( stream );
+		else
+		{
+			if ( run > src_len )
+				run = src_len;
+			stream->used += app_json_string_escape(
+				&stream->buf[stream->used], src, run, space );
+			src += run;
+			src_len -= run;
+		}
+	}
+	return result;
+}
+
+iot_status_t app_json_stream_fill(
+	app_json_stream_t *stream,
+	char ch,
+	size_t count )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	while ( count > 0u && result == IOT_STATUS_SUCCESS )
+	{
+		if ( stream->used == stream->len )
+			result = app_json_stream_flush( stream );
+		else
+		{
+			size_t run = stream->len - stream->used;
+			if ( run > count )
+				run = count;
+			os_memset( &stream->buf[stream->used], ch, run );
+			stream->used += run;
+			count -= run;
+		}
+	}
+	return result;
+}
+
+iot_status_t app_json_stream_finish(
+	app_json_stream_t *stream )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( stream )
+	{
+		result = stream->status;
+		while ( stream->depth > 0u && result == IOT_STATUS_SUCCESS )
+			result = app_json_stream_struct_end( stream,
+				(iot_bool_t)( stream->objects & 0x1u ) );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_json_stream_flush( stream );
+	}
+	return result;
+}
+
+iot_status_t app_json_stream_flush(
+	app_json_stream_t *stream )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( stream )
+	{
+		if ( stream->status == IOT_STATUS_SUCCESS && stream->used > 0u )
+		{
+			/* once the sink fails, the output is incomplete */
+			stream->status = stream->sink( stream->user_data,
+				stream->buf, stream->used );
+			stream->used = 0u;
+		}
+		result = stream->status;
+	}
+	return result;
+}
+
+app_json_stream_t *app_json_stream_initialize(
+	void *buf,
+	size_t len,
+	unsigned int flags,
+	app_json_stream_sink_t sink,
+	void *user_data )
+{
+	struct app_json_stream *stream = NULL;
+
+#ifndef IOT_STACK_ONLY
+	if ( !buf )
+		flags |= APP_JSON_FLAG_DYNAMIC;
+#endif /* ifndef IOT_STACK_ONLY */
+
+	if ( sink )
+	{
+#ifndef IOT_STACK_ONLY
+		if ( flags & APP_JSON_FLAG_DYNAMIC )
+		{
+			if ( len == 0u )
+				len = APP_JSON_STREAM_BUFFER_DEFAULT;
+			else if ( len < JSON_STREAM_MIN_LEN )
+				len = JSON_STREAM_MIN_LEN;
+			stream = (struct app_json_stream *)app_json_realloc(
+				NULL, sizeof( struct app_json_stream ) + len );
+			if ( stream )
+			{
+				stream->buf = (char *)stream +
+					sizeof( struct app_json_stream );
+				stream->len = len;
+			}
+		}
+		else
+#endif /* ifndef IOT_STACK_ONLY */
+		if ( buf && len >= sizeof( struct app_json_stream ) +
+			JSON_STREAM_MIN_LEN )
+		{
+			stream = (struct app_json_stream *)buf;
+			stream->buf = (char *)buf + sizeof( struct app_json_stream );
+			stream->len = len - sizeof( struct app_json_stream );
+		}
+
+		if ( stream )
+		{
+			stream->sink = sink;
+			stream->user_data = user_data;
+			stream->used = 0u;
+			stream->flags = flags;
+			stream->depth = 0u;
+			stream->objects = 0u;
+			stream->first = IOT_TRUE;
+			stream->status = IOT_STATUS_SUCCESS;
+		}
+	}
+	return stream;
+}
+
+iot_status_t app_json_stream_integer(
+	app_json_stream_t *stream,
+	const char *key,
+	iot_int64_t value )
+{
+	char num[APP_JSON_NUMBER_MAX_LEN];
+	size_t value_len;
+	if ( value < 0 )
+		value_len = app_json_number_integer( num,
+			(iot_uint64_t)0u - (iot_uint64_t)value, IOT_TRUE );
+	else
+		value_len = app_json_number_integer( num,
+			(iot_uint64_t)value, IOT_FALSE );
+	return app_json_stream_value( stream, key, num, value_len );
+}
+
+iot_status_t app_json_stream_key(
+	app_json_stream_t *stream,
+	const char *key )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( stream )
+	{
+		result = stream->status;
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			if ( stream->depth == 0u )
+			{
+				/* only one root item, a key adds a root object */
+				if ( stream->first == IOT_FALSE )
+					result = IOT_STATUS_BAD_REQUEST;
+				else if ( key )
+					result = app_json_stream_struct_start(
+						stream, NULL, IOT_TRUE );
+			}
+			else if ( stream->objects & 0x1u )
+			{
+				/* we are inside object we must have a key */
+				if ( !key )
+					key = "";
+			}
+			else if ( key )
+				/* the output can't be changed to add a parent */
+				result = IOT_STATUS_BAD_REQUEST;
+		}
+
+		if ( result == IOT_STATUS_SUCCESS && stream->depth > 0u )
+		{
+			const unsigned int indent =
+				( stream->flags >> APP_JSON_INDENT_OFFSET );
+			if ( stream->first == IOT_FALSE )
+			{
+				if ( !indent &&
+					( stream->flags & APP_JSON_FLAG_EXPAND ) )
+					result = app_json_stream_write(
+						stream, ", ", 2u );
+				else
+					result = app_json_stream_write(
+						stream, ",", 1u );
+			}
+			if ( result == IOT_STATUS_SUCCESS && indent )
+			{
+				result = app_json_stream_write( stream, "\n", 1u );
+				if ( result == IOT_STATUS_SUCCESS )
+					result = app_json_stream_fill( stream, ' ',
+						(size_t)indent * stream->depth );
+			}
+			if ( result == IOT_STATUS_SUCCESS && key )
+			{
+				result = app_json_stream_write( stream, "\"", 1u );
+				if ( result == IOT_STATUS_SUCCESS )
+					result = app_json_stream_escape( stream,
+						key, os_strlen( key ) );
+				if ( result == IOT_STATUS_SUCCESS )
+				{
+					if ( stream->flags & APP_JSON_FLAG_EXPAND )
+						result = app_json_stream_write(
+							stream, "\": ", 3u );
+					else
+						result = app_json_stream_write(
+							stream, "\":", 2u );
+				}
+			}
+		}
+	}
+	return result;
+}
+
+iot_status_t app_json_stream_object_end(
+	app_json_stream_t *stream )
+{
+	return app_json_stream_struct_end( stream, IOT_TRUE );
+}
+
+iot_status_t app_json_stream_object_start(
+	app_json_stream_t *stream,
+	const char *key )
+{
+	return app_json_stream_struct_start( stream, key, IOT_TRUE );
+}
+
+iot_status_t app_json_stream_real(
+	app_json_stream_t *stream,
+	const char *key,
+	double value )
+{
+	return app_json_stream_real_precision( stream, key, value,
+		APP_JSON_PRECISION_SHORTEST );
+}
+
+iot_status_t app_json_stream_real_precision(
+	app_json_stream_t *stream,
+	const char *key,
+	double value,
+	int precision )
+{
+	iot_status_t result;
+	char num[APP_JSON_NUMBER_MAX_LEN];
+	const size_t value_len =
+		app_json_number_real( num, value, precision );
+	/* NaN & infinity can't be represented in JSON */
+	if ( value_len == 0u )
+		result = IOT_STATUS_BAD_PARAMETER;
+	else
+		result = app_json_stream_value( stream, key, num, value_len );
+	return result;
+}
+
+iot_status_t app_json_stream_string(
+	app_json_stream_t *stream,
+	const char *key,
+	const char *value )
+{
+	if ( !value )
+		value = "";
+	return app_json_stream_string_len( stream, key, value,
+		os_strlen( value ) );
+}
+
+iot_status_t app_json_stream_string_len(
+	app_json_stream_t *stream,
+	const char *key,
+	const char *value,
+	size_t value_len )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( stream && ( value || value_len == 0u ) )
+	{
+		/* can't add a string as root element */
+		if ( !key && stream->depth == 0u )
+			result = IOT_STATUS_BAD_REQUEST;
+		else
+		{
+			result = app_json_stream_key( stream, key );
+			if ( result == IOT_STATUS_SUCCESS )
+				result = app_json_stream_write( stream, "\"", 1u );
+			if ( result == IOT_STATUS_SUCCESS )
+				result = app_json_stream_escape( stream,
+					value, value_len );
+			if ( result == IOT_STATUS_SUCCESS )
+				result = app_json_stream_write( stream, "\"", 1u );
+			if ( result == IOT_STATUS_SUCCESS )
+				stream->first = IOT_FALSE;
+		}
+	}
+	return result;
+}
+
+iot_status_t app_json_stream_struct_end(
+	app_json_stream_t *stream,
+	iot_bool_t is_object )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( stream )
+	{
+		result = stream->status;
+		if ( result == IOT_STATUS_SUCCESS &&
+			( stream->depth == 0u ||
+			  ( ( stream->objects & 0x1u ) != 0u ) !=
+			  ( is_object != IOT_FALSE ) ) )
+			result = IOT_STATUS_BAD_REQUEST;
+
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			const unsigned int indent =
+				( stream->flags >> APP_JSON_INDENT_OFFSET );
+			if ( indent && stream->first == IOT_FALSE )
+			{
+				result = app_json_stream_write( stream, "\n", 1u );
+				if ( result == IOT_STATUS_SUCCESS )
+					result = app_json_stream_fill( stream, ' ',
+						(size_t)indent * ( stream->depth - 1u ) );
+			}
+			if ( result == IOT_STATUS_SUCCESS )
+			{
+				if ( is_object )
+					result = app_json_stream_write(
+						stream, "}", 1u );
+				else
+					result = app_json_stream_write(
+						stream, "]", 1u );
+			}
+			if ( result == IOT_STATUS_SUCCESS )
+			{
+				stream->objects >>= 1u;
+				--stream->depth;
+				stream->first = IOT_FALSE;
+			}
+		}
+	}
+	return result;
+}
+
+iot_status_t app_json_stream_struct_start(
+	app_json_stream_t *stream,
+	const char *key,
+	iot_bool_t is_object )
+{
+	iot_status_t result = IOT_STATUS_BAD_PARAMETER;
+	if ( stream )
+	{
+		result = IOT_STATUS_FULL;
+		if ( stream->depth < JSON_STREAM_MAX_DEPTH )
+			result = app_json_stream_key( stream, key );
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			if ( is_object )
+				result = app_json_stream_write( stream, "{", 1u );
+			else
+				result = app_json_stream_write( stream, "[", 1u );
+		}
+		if ( result == IOT_STATUS_SUCCESS )
+		{
+			stream->objects <<= 1u;
+			if ( is_object )
+				stream->objects |= 0x1u;
+			++stream->depth;
+			stream->first = IOT_TRUE;
+		}
+	}
+	return result;
+}
+
+void app_json_stream_terminate(
+	app_json_stream_t *stream )
+{
+#if defined( IOT_STACK_ONLY )
+	(void)stream;
+#else /* if defined( IOT_STACK_ONLY ) */
+	if ( stream && ( stream->flags & APP_JSON_FLAG_DYNAMIC ) )
+		app_json_free( stream );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+}
+
+iot_status_t app_json_stream_unsigned(
+	app_json_stream_t *stream,
+	const char *key,
+	iot_uint64_t value )
+{
+	char num[APP_JSON_NUMBER_MAX_LEN];
+	const size_t value_len =
+		app_json_number_integer( num, value, IOT_FALSE );
+	return app_json_stream_value( stream, key, num, value_len );
+}
+
+iot_status_t app_json_stream_value(
+	app_json_stream_t *stream,
+	const char *key,
+	const char *value,
+	size_t value_len )
+{
+	iot_status_t result;
+	/* can't add a value as root element */
+	if ( !key && ( stream && stream->depth == 0u ) )
+		result = IOT_STATUS_BAD_REQUEST;
+	else
+	{
+		result = app_json_stream_key( stream, key );
+		if ( result == IOT_STATUS_SUCCESS )
+			result = app_json_stream_write( stream, value,
+				value_len );
+		if ( result == IOT_STATUS_SUCCESS )
+			stream->first = IOT_FALSE;
+	}
+	return result;
+}
+
+iot_status_t app_json_stream_write(
+	app_json_stream_t *stream,
+	const char *data,
+	size_t len )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	while ( len > 0u && result == IOT_STATUS_SUCCESS )
+	{
+		if ( stream->used == stream->len )
+			result = app_json_stream_flush( stream );
+		else
+		{
+			size_t run = stream->len - stream->used;
+			if ( run > len )
+				run = len;
+			os_memcpy( &stream->buf[stream->used], data, run );
+			stream->used += run;
+			data += run;
+			len -= run;
+		}
+	}
+	return result;
+}
@@ -0,0 +1,911 @@
+/**
+ * @file
+ * @brief source file for the JSON tokenizer used with the JSMN library
+ *
+ * The document is scanned 64 bytes at a time.  For each block, bit masks of
+ * the quotes, back slashes, white space and structural characters are built
+ * with SSE2, AVX2 or NEON (or eight bytes at a time in a 64-bit word, without
+ * them).  Strings are found from the quotes which are not escaped, so the
+ * characters within them are never looked at one at a time.  This gives an
+ * index of the structural characters, the start of each primitive and the
+ * escape sequences, which are then visited in order to build the same tokens
+ * jsmn_parse() builds (strict, with parent links), so the app_json_decode_*
+ * functions work on them unchanged.  The index can be kept between the two
+ * steps, or each block used as soon as it is scanned.  Building the tokens
+ * can also carry on from the last one built, as more of a document is
+ * received.
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "app_json.h"
+#include "app_json_base.h"
+
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+#include <os.h> /* for os_memcpy, os_memzero */
+
+#ifndef JSMN_PARENT_LINKS
+#error "the JSON tokenizer requires jsmn built with JSMN_PARENT_LINKS"
+#endif /* ifndef JSMN_PARENT_LINKS */
+
+#if defined( __AVX2__ )
+#include <immintrin.h> /* for AVX2 intrinsics */
+/** @brief classify characters 32 bytes at a time */
+#define JSON_TOKEN_AVX2
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || \
+	( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h> /* for SSE2 intrinsics */
+/** @brief classify characters 16 bytes at a time */
+#define JSON_TOKEN_SSE2
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#include <arm_neon.h> /* for NEON intrinsics */
+/** @brief classify characters 16 bytes at a time */
+#define JSON_TOKEN_NEON
+#endif /* elif defined( __ARM_NEON ) || defined( __ARM_NEON__ ) */
+
+#if defined( _MSC_VER )
+#include <intrin.h> /* for _BitScanForward */
+#endif /* if defined( _MSC_VER ) */
+
+/** @brief number of characters scanned at a time */
+#define JSON_TOKEN_BLOCK                    64u
+
+/** @brief bit masks of the characters of each class in a block */
+struct app_json_token_chars
+{
+	/** @brief quotes */
+	iot_uint64_t quote;
+	/** @brief back slashes */
+	iot_uint64_t backslash;
+	/** @brief white space */
+	iot_uint64_t space;
+	/** @brief structural characters */
+	iot_uint64_t op;
+	/** @brief start of objects and arrays */
+	iot_uint64_t open;
+	/** @brief null characters */
+	iot_uint64_t nul;
+};
+
+/** @brief state carried from one block to the next */
+struct app_json_token_scan
+{
+	/** @brief 1 if the first character of the block is escaped */
+	iot_uint64_t escaped;
+	/** @brief all ones if the block starts within a string */
+	iot_uint64_t in_string;
+	/** @brief 1 if the block starts within a primitive */
+	iot_uint64_t scalar;
+};
+
+#if !defined( JSON_TOKEN_AVX2 ) && !defined( JSON_TOKEN_SSE2 ) && \
+	!defined( JSON_TOKEN_NEON )
+/** @brief the value 1 in each byte of a word */
+#define JSON_TOKEN_SWAR_ONES                0x0101010101010101u
+/** @brief the top bit of each byte of a word */
+#define JSON_TOKEN_SWAR_HIGH                0x8080808080808080u
+#endif /* if !defined( JSON_TOKEN_AVX2 ) && !defined( JSON_TOKEN_SSE2 ) &&
+          !defined( JSON_TOKEN_NEON ) */
+
+/**
+ * @brief allocates the next token
+ *
+ * @param[in,out]  tokens              tokens
+ * @param[in]      num_tokens          number of tokens available
+ * @param[in,out]  toknext             index of the next token to allocate
+ * @param[in]      type                type of the token
+ * @param[in]      start               start of the token
+ * @param[in]      end                 end of the token (-1 if not known yet)
+ * @param[in]      parent              index of the parent token (-1 if none)
+ *
+ * @return the token allocated, NULL if there are no more tokens
+ */
+static jsmntok_t *app_json_token_alloc(
+	jsmntok_t *tokens,
+	unsigned int num_tokens,
+	unsigned int *toknext,
+	jsmntype_t type,
+	int start,
+	int end,
+	int parent );
+
+/**
+ * @brief scans a block of the document
+ *
+ * @param[in,out]  scan                state carried between blocks
+ * @param[in]      js                  start of the block
+ * @param[in]      len                 number of characters in the block (at
+ *                                     most JSON_TOKEN_BLOCK)
+ * @param[out]     valid               number of characters before a null
+ *                                     character (or @p len)
+ * @param[out]     starts              characters starting a token
+ * @param[out]     escaped             characters escaped within strings
+ *
+ * @return characters to visit to build the tokens: quotes, structural
+ *         characters and the first character of each primitive
+ */
+static iot_uint64_t app_json_token_block(
+	struct app_json_token_scan *scan,
+	const char *js,
+	size_t len,
+	size_t *valid,
+	iot_uint64_t *starts,
+	iot_uint64_t *escaped );
+
+/**
+ * @brief classifies the characters in a block
+ *
+ * @param[in]      js                  start of the block, must hold
+ *                                     JSON_TOKEN_BLOCK characters
+ * @param[out]     chars               characters of each class
+ */
+static void app_json_token_classify(
+	const char *js,
+	struct app_json_token_chars *chars );
+
+/**
+ * @brief builds the tokens for a JSON document, from a given state
+ *
+ * @param[in]      js                  JSON document
+ * @param[in]      len                 length of the document
+ * @param[in]      index               index from app_json_token_index (only
+ *                                     when starting at the beginning), or
+ *                                     NULL to scan the document
+ * @param[out]     tokens              tokens to fill
+ * @param[in]      num_tokens          number of tokens available
+ * @param[in]      pos                 position to start at, outside of any
+ *                                     string or primitive
+ * @param[in,out]  toknext             number of tokens built
+ * @param[in]      toksuper            index of the current parent token (-1
+ *                                     if none)
+ * @param[in]      open                number of objects and arrays open
+ *
+ * @retval JSMN_ERROR_INVAL            invalid character in the document
+ * @retval JSMN_ERROR_NOMEM            not enough tokens
+ * @retval JSMN_ERROR_PART             document is incomplete
+ * @return the number of tokens built, on success
+ */
+static int app_json_token_build(
+	const char *js,
+	size_t len,
+	const iot_uint64_t *index,
+	jsmntok_t *tokens,
+	unsigned int num_tokens,
+	size_t pos,
+	unsigned int *toknext,
+	int toksuper,
+	unsigned int open );
+
+/**
+ * @brief returns the position of the lowest bit set
+ *
+ * @param[in]      bits                bits, must not be 0
+ *
+ * @return position of the lowest bit set
+ */
+static unsigned int app_json_token_ctz(
+	iot_uint64_t bits );
+
+/**
+ * @brief returns the characters which follow an escaping back slash
+ *
+ * A sequence of back slashes escapes every second character, so the
+ * character following an odd length sequence is escaped.
+ *
+ * @param[in]      backslash           back slashes in the block
+ * @param[in,out]  carry               1 if the first character of the block
+ *                                     is escaped, set for the next block
+ *
+ * @return the escaped characters in the block
+ */
+static iot_uint64_t app_json_token_escaped(
+	iot_uint64_t backslash,
+	iot_uint64_t *carry );
+
+/**
+ * @brief returns the number of bits set
+ *
+ * @param[in]      bits                bits to count
+ *
+ * @return the number of bits set
+ */
+static unsigned int app_json_token_popcount(
+	iot_uint64_t bits );
+
+/**
+ * @brief sets each bit to the exclusive or of itself and the bits below it
+ *
+ * For a mask of quotes, this gives the characters within strings (including
+ * the opening quote, but not the closing one).
+ *
+ * @param[in]      bits                bits
+ *
+ * @return the prefix exclusive or of the bits
+ */
+static iot_uint64_t app_json_token_prefix_xor(
+	iot_uint64_t bits );
+
+#if !defined( JSON_TOKEN_AVX2 ) && !defined( JSON_TOKEN_SSE2 ) && \
+	!defined( JSON_TOKEN_NEON )
+/**
+ * @brief gathers the top bit of each byte of a word into a byte
+ *
+ * @param[in]      w                   word, only the top bit of each byte
+ *                                     may be set
+ *
+ * @return a bit for each byte, the first byte in the lowest bit
+ */
+static iot_uint64_t app_json_token_swar_bits(
+	iot_uint64_t w );
+
+/**
+ * @brief finds the bytes of a word equal to a character
+ *
+ * @param[in]      w                   word holding eight characters
+ * @param[in]      c                   character to find
+ *
+ * @return the top bit set in each byte equal to the character
+ */
+static iot_uint64_t app_json_token_swar_eq(
+	iot_uint64_t w,
+	unsigned char c );
+#endif /* if !defined( JSON_TOKEN_AVX2 ) && !defined( JSON_TOKEN_SSE2 ) &&
+          !defined( JSON_TOKEN_NEON ) */
+
+jsmntok_t *app_json_token_alloc(
+	jsmntok_t *tokens,
+	unsigned int num_tokens,
+	unsigned int *toknext,
+	jsmntype_t type,
+	int start,
+	int end,
+	int parent )
+{
+	jsmntok_t *result = NULL;
+	if ( *toknext < num_tokens )
+	{
+		result = &tokens[*toknext];
+		result->type = type;
+		result->start = start;
+		result->end = end;
+		result->size = 0;
+		result->parent = parent;
+		++(*toknext);
+	}
+	return result;
+}
+
+iot_uint64_t app_json_token_block(
+	struct app_json_token_scan *scan,
+	const char *js,
+	size_t len,
+	size_t *valid,
+	iot_uint64_t *starts,
+	iot_uint64_t *escaped )
+{
+	struct app_json_token_chars chars;
+	iot_uint64_t in_string;
+	iot_uint64_t quote;
+	iot_uint64_t scalar;
+	iot_uint64_t prim;
+
+	if ( len < JSON_TOKEN_BLOCK )
+	{
+		/* pad the last block with white space */
+		char tail[ JSON_TOKEN_BLOCK ];
+		size_t i;
+		os_memcpy( tail, js, len );
+		for ( i = len; i < JSON_TOKEN_BLOCK; ++i )
+			tail[i] = ' ';
+		app_json_token_classify( tail, &chars );
+	}
+	else
+		app_json_token_classify( js, &chars );
+
+	/* the document ends at a null character, as with jsmn */
+	*valid = len;
+	if ( chars.nul )
+	{
+		const unsigned int end = app_json_token_ctz( chars.nul );
+		const iot_uint64_t mask = ( (iot_uint64_t)1u << end ) - 1u;
+		chars.quote &= mask;
+		chars.backslash &= mask;
+		chars.op &= mask;
+		chars.open &= mask;
+		chars.space |= ~mask;
+		*valid = end;
+	}
+
+	*escaped = app_json_token_escaped( chars.backslash, &scan->escaped );
+	quote = chars.quote & ~(*escaped);
+	in_string = app_json_token_prefix_xor( quote ) ^ scan->in_string;
+	scan->in_string = (iot_uint64_t)0u - ( in_string >> 63 );
+
+	/* primitives are runs of any other characters outside strings */
+	scalar = ~( chars.op | chars.space | quote | in_string );
+	prim = scalar & ~( ( scalar << 1 ) | scan->scalar );
+	scan->scalar = scalar >> 63;
+
+	*escaped &= in_string;
+	/* a back slash at the end of the document escapes nothing */
+	if ( *valid < JSON_TOKEN_BLOCK )
+		*escaped &= ( (iot_uint64_t)1u << *valid ) - 1u;
+	*starts = ( chars.open & ~in_string ) | ( quote & in_string ) | prim;
+	return ( chars.op & ~in_string ) | quote | prim;
+}
+
+void app_json_token_classify(
+	const char *js,
+	struct app_json_token_chars *chars )
+{
+	unsigned int i;
+#if defined( JSON_TOKEN_AVX2 )
+	const __m256i lower = _mm256_set1_epi8( 0x20 );
+	os_memzero( chars, sizeof( struct app_json_token_chars ) );
+	for ( i = 0u; i < JSON_TOKEN_BLOCK; i += 32u )
+	{
+		const __m256i v =
+			_mm256_loadu_si256( (const __m256i *)&js[i] );
+		/* '[' and ']' differ from '{' and '}' only by 0x20 */
+		const __m256i l = _mm256_or_si256( v, lower );
+		const __m256i open = _mm256_cmpeq_epi8( l, _mm256_set1_epi8( '{' ) );
+		const __m256i op = _mm256_or_si256(
+			_mm256_or_si256( open,
+				_mm256_cmpeq_epi8( l, _mm256_set1_epi8( '}' ) ) ),
+			_mm256_or_si256(
+				_mm256_cmpeq_epi8( v, _mm256_set1_epi8( ':' ) ),
+				_mm256_cmpeq_epi8( v, _mm256_set1_epi8( ',' ) ) ) );
+		const __m256i space = _mm256_or_si256(
+			_mm256_or_si256(
+				_mm256_cmpeq_epi8( v, _mm256_set1_epi8( ' ' ) ),
+				_mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\t' ) ) ),
+			_mm256_or_si256(
+				_mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\n' ) ),
+				_mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\r' ) ) ) );
+		chars->quote |= (iot_uint64_t)(unsigned int)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi8( v, _mm256_set1_epi8( '"' ) ) ) << i;
+		chars->backslash |= (iot_uint64_t)(unsigned int)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\\' ) ) ) << i;
+		chars->nul |= (iot_uint64_t)(unsigned int)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi8( v, _mm256_setzero_si256() ) ) << i;
+		chars->space |= (iot_uint64_t)(unsigned int)
+			_mm256_movemask_epi8( space ) << i;
+		chars->op |= (iot_uint64_t)(unsigned int)
+			_mm256_movemask_epi8( op ) << i;
+		chars->open |= (iot_uint64_t)(unsigned int)
+			_mm256_movemask_epi8( open ) << i;
+	}
+#elif defined( JSON_TOKEN_SSE2 )
+	const __m128i lower = _mm_set1_epi8( 0x20 );
+	os_memzero( chars, sizeof( struct app_json_token_chars ) );
+	for ( i = 0u; i < JSON_TOKEN_BLOCK; i += 16u )
+	{
+		const __m128i v = _mm_loadu_si128( (const __m128i *)&js[i] );
+		/* '[' and ']' differ from '{' and '}' only by 0x20 */
+		const __m128i l = _mm_or_si128( v, lower );
+		const __m128i open = _mm_cmpeq_epi8( l, _mm_set1_epi8( '{' ) );
+		const __m128i op = _mm_or_si128(
+			_mm_or_si128( open,
+				_mm_cmpeq_epi8( l, _mm_set1_epi8( '}' ) ) ),
+			_mm_or_si128(
+				_mm_cmpeq_epi8( v, _mm_set1_epi8( ':' ) ),
+				_mm_cmpeq_epi8( v, _mm_set1_epi8( ',' ) ) ) );
+		const __m128i space = _mm_or_si128(
+			_mm_or_si128(
+				_mm_cmpeq_epi8( v, _mm_set1_epi8( ' ' ) ),
+				_mm_cmpeq_epi8( v, _mm_set1_epi8( '\t' ) ) ),
+			_mm_or_si128(
+				_mm_cmpeq_epi8( v, _mm_set1_epi8( '\n' ) ),
+				_mm_cmpeq_epi8( v, _mm_set1_epi8( '\r' ) ) ) );
+		chars->quote |= (iot_uint64_t)_mm_movemask_epi8(
+			_mm_cmpeq_epi8( v, _mm_set1_epi8( '"' ) ) ) << i;
+		chars->backslash |= (iot_uint64_t)_mm_movemask_epi8(
+			_mm_cmpeq_epi8( v, _mm_set1_epi8( '\\' ) ) ) << i;
+		chars->nul |= (iot_uint64_t)_mm_movemask_epi8(
+			_mm_cmpeq_epi8( v, _mm_setzero_si128() ) ) << i;
+		chars->space |= (iot_uint64_t)_mm_movemask_epi8( space ) << i;
+		chars->op |= (iot_uint64_t)_mm_movemask_epi8( op ) << i;
+		chars->open |= (iot_uint64_t)_mm_movemask_epi8( open ) << i;
+	}
+#elif defined( JSON_TOKEN_NEON )
+	/* weight of each lane, summed to form a 16-bit mask */
+	static const uint8_t weights[16] = {
+		1u, 2u, 4u, 8u, 16u, 32u, 64u, 128u,
+		1u, 2u, 4u, 8u, 16u, 32u, 64u, 128u };
+	const uint8x16_t w = vld1q_u8( weights );
+	const uint8x16_t lower = vdupq_n_u8( 0x20 );
+	os_memzero( chars, sizeof( struct app_json_token_chars ) );
+	for ( i = 0u; i < JSON_TOKEN_BLOCK; i += 16u )
+	{
+		const uint8x16_t v = vld1q_u8( (const uint8_t *)&js[i] );
+		/* '[' and ']' differ from '{' and '}' only by 0x20 */
+		const uint8x16_t l = vorrq_u8( v, lower );
+		const uint8x16_t open = vceqq_u8( l, vdupq_n_u8( '{' ) );
+		uint8x16_t m[6];
+		unsigned int j;
+		m[0] = vceqq_u8( v, vdupq_n_u8( '"' ) );
+		m[1] = vceqq_u8( v, vdupq_n_u8( '\\' ) );
+		m[2] = vorrq_u8(
+			vorrq_u8( vceqq_u8( v, vdupq_n_u8( ' ' ) ),
+				vceqq_u8( v, vdupq_n_u8( '\t' ) ) ),
+			vorrq_u8( vceqq_u8( v, vdupq_n_u8( '\n' ) ),
+				vceqq_u8( v, vdupq_n_u8( '\r' ) ) ) );
+		m[3] = vorrq_u8(
+			vorrq_u8( open, vceqq_u8( l, vdupq_n_u8( '}' ) ) ),
+			vorrq_u8( vceqq_u8( v, vdupq_n_u8( ':' ) ),
+				vceqq_u8( v, vdupq_n_u8( ',' ) ) ) );
+		m[4] = open;
+		m[5] = vceqq_u8( v, vdupq_n_u8( 0u ) );
+		for ( j = 0u; j < 6u; ++j )
+		{
+			const uint8x16_t b = vandq_u8( m[j], w );
+			uint8x8_t lo = vget_low_u8( b );
+			uint8x8_t hi = vget_high_u8( b );
+			iot_uint64_t bits;
+			lo = vpadd_u8( lo, lo );
+			lo = vpadd_u8( lo, lo );
+			lo = vpadd_u8( lo, lo );
+			hi = vpadd_u8( hi, hi );
+			hi = vpadd_u8( hi, hi );
+			hi = vpadd_u8( hi, hi );
+			bits = ( (iot_uint64_t)vget_lane_u8( lo, 0 ) |
+				( (iot_uint64_t)vget_lane_u8( hi, 0 ) << 8 ) ) << i;
+			switch ( j )
+			{
+			case 0u: chars->quote |= bits; break;
+			case 1u: chars->backslash |= bits; break;
+			case 2u: chars->space |= bits; break;
+			case 3u: chars->op |= bits; break;
+			case 4u: chars->open |= bits; break;
+			default: chars->nul |= bits; break;
+			}
+		}
+	}
+#else /* defined( JSON_TOKEN_NEON ) */
+	/* eight characters at a time in a 64-bit word */
+	os_memzero( chars, sizeof( struct app_json_token_chars ) );
+	for ( i = 0u; i < JSON_TOKEN_BLOCK; i += 8u )
+	{
+		iot_uint64_t w;
+		iot_uint64_t l;
+		iot_uint64_t open;
+		os_memcpy( &w, &js[i], sizeof( iot_uint64_t ) );
+		/* '[' and ']' differ from '{' and '}' only by 0x20 */
+		l = w | ( JSON_TOKEN_SWAR_ONES * 0x20u );
+		open = app_json_token_swar_eq( l, '{' );
+		chars->quote |= app_json_token_swar_bits(
+			app_json_token_swar_eq( w, '"' ) ) << i;
+		chars->backslash |= app_json_token_swar_bits(
+			app_json_token_swar_eq( w, '\\' ) ) << i;
+		chars->space |= app_json_token_swar_bits(
+			app_json_token_swar_eq( w, ' ' ) |
+			app_json_token_swar_eq( w, '\t' ) |
+			app_json_token_swar_eq( w, '\n' ) |
+			app_json_token_swar_eq( w, '\r' ) ) << i;
+		chars->op |= app_json_token_swar_bits( open |
+			app_json_token_swar_eq( l, '}' ) |
+			app_json_token_swar_eq( w, ':' ) |
+			app_json_token_swar_eq( w, ',' ) ) << i;
+		chars->open |= app_json_token_swar_bits( open ) << i;
+		chars->nul |= app_json_token_swar_bits(
+			app_json_token_swar_eq( w, '\0' ) ) << i;
+	}
+#endif /* defined( JSON_TOKEN_NEON ) */
+}
+
+int app_json_token_build(
+	const char *js,
+	size_t len,
+	const iot_uint64_t *index,
+	jsmntok_t *tokens,
+	unsigned int num_tokens,
+	size_t pos,
+	unsigned int *toknext,
+	int toksuper,
+	unsigned int open )
+{
+	int result = JSMN_ERROR_INVAL;
+	if ( js && tokens )
+	{
+		struct app_json_token_scan scan;
+		int str_start = -1;
+
+		result = 0;
+		os_memzero( &scan, sizeof( struct app_json_token_scan ) );
+		while ( result == 0 && pos < len )
+		{
+			size_t n = len - pos;
+			size_t valid;
+			iot_uint64_t starts;
+			iot_uint64_t escaped;
+			iot_uint64_t bits;
+			if ( n > JSON_TOKEN_BLOCK )
+				n = JSON_TOKEN_BLOCK;
+			if ( index )
+			{
+				bits = *index++;
+				escaped = *index++;
+			}
+			else
+			{
+				bits = app_json_token_block( &scan, &js[pos], n,
+					&valid, &starts, &escaped );
+				if ( valid < n )
+					len = pos + valid;
+				bits |= escaped;
+			}
+
+			while ( result == 0 && bits )
+			{
+				const iot_uint64_t bit = bits & ( ~bits + 1u );
+				const size_t i = pos + app_json_token_ctz( bits );
+				const char c = js[i];
+				jsmntok_t *token;
+				bits ^= bit;
+
+				if ( escaped & bit )
+				{
+					/* character following a back slash */
+					if ( c == 'u' )
+					{
+						size_t j;
+						for ( j = i + 1u; j < i + 5u && j < len &&
+							js[j] != '\0'; ++j )
+						{
+							if ( !( ( js[j] >= '0' && js[j] <= '9' ) ||
+								( js[j] >= 'A' && js[j] <= 'F' ) ||
+								( js[j] >= 'a' && js[j] <= 'f' ) ) )
+								result = JSMN_ERROR_INVAL;
+						}
+					}
+					else if ( c != '"' && c != '/' && c != '\\' &&
+						c != 'b' && c != 'f' && c != 'r' &&
+						c != 'n' && c != 't' )
+						result = JSMN_ERROR_INVAL;
+				}
+				else if ( str_start >= 0 )
+				{
+					/* closing quote */
+					token = app_json_token_alloc( tokens,
+						num_tokens, toknext, JSMN_STRING,
+						str_start + 1, (int)i, toksuper );
+					if ( !token )
+						result = JSMN_ERROR_NOMEM;
+					else if ( toksuper != -1 )
+						tokens[toksuper].size++;
+					str_start = -1;
+				}
+				else if ( c == '"' )
+					str_start = (int)i;
+				else if ( c == '{' || c == '[' )
+				{
+					token = app_json_token_alloc( tokens,
+						num_tokens, toknext,
+						c == '{' ? JSMN_OBJECT : JSMN_ARRAY,
+						(int)i, -1, toksuper );
+					if ( !token )
+						result = JSMN_ERROR_NOMEM;
+					else
+					{
+						if ( toksuper != -1 )
+							tokens[toksuper].size++;
+						toksuper = (int)*toknext - 1;
+						++open;
+					}
+				}
+				else if ( c == '}' || c == ']' )
+				{
+					const jsmntype_t type =
+						c == '}' ? JSMN_OBJECT : JSMN_ARRAY;
+					result = JSMN_ERROR_INVAL;
+					if ( *toknext > 0u )
+					{
+						/* find the object or array being closed */
+						token = &tokens[*toknext - 1u];
+						while ( result == JSMN_ERROR_INVAL )
+						{
+							if ( token->start != -1 &&
+								token->end == -1 )
+							{
+								if ( token->type == type )
+								{
+									token->end = (int)i + 1;
+									toksuper = token->parent;
+									--open;
+									result = 0;
+								}
+								break;
+							}
+							if ( token->parent == -1 )
+							{
+								if ( token->type == type &&
+									toksuper != -1 )
+									result = 0;
+								break;
+							}
+							token = &tokens[token->parent];
+						}
+					}
+				}
+				else if ( c == ':' )
+					toksuper = (int)*toknext - 1;
+				else if ( c == ',' )
+				{
+					if ( toksuper != -1 &&
+						tokens[toksuper].type != JSMN_ARRAY &&
+						tokens[toksuper].type != JSMN_OBJECT )
+						toksuper = tokens[toksuper].parent;
+				}
+				else if ( ( c >= '0' && c <= '9' ) || c == '-' ||
+					c == 't' || c == 'f' || c == 'n' )
+				{
+					/* primitive, which can't be a key */
+					size_t end = i + 1u;
+					if ( toksuper != -1 &&
+						( tokens[toksuper].type == JSMN_OBJECT ||
+						( tokens[toksuper].type == JSMN_STRING &&
+						  tokens[toksuper].size != 0 ) ) )
+						result = JSMN_ERROR_INVAL;
+					/* jsmn would carry on past a quote, ':', '[',
+					 * '{' or back slash, only ever in an invalid
+					 * document, so these are rejected instead */
+					while ( result == 0 && end < len &&
+						js[end] != '\t' && js[end] != '\r' &&
+						js[end] != '\n' && js[end] != ' ' &&
+						js[end] != ',' && js[end] != ']' &&
+						js[end] != '}' && js[end] != '\0' )
+					{
+						if ( (unsigned char)js[end] < 32u ||
+							(unsigned char)js[end] >= 127u ||
+							js[end] == '"' || js[end] == ':' ||
+							js[end] == '[' || js[end] == '{' ||
+							js[end] == '\\' )
+							result = JSMN_ERROR_INVAL;
+						++end;
+					}
+
+					/* a primitive must be followed by something */
+					if ( result == 0 &&
+						( end >= len || js[end] == '\0' ) )
+						result = JSMN_ERROR_PART;
+					if ( result == 0 )
+					{
+						token = app_json_token_alloc( tokens,
+							num_tokens, toknext,
+							JSMN_PRIMITIVE, (int)i,
+							(int)end, toksuper );
+						if ( !token )
+							result = JSMN_ERROR_NOMEM;
+						else if ( toksuper != -1 )
+							tokens[toksuper].size++;
+					}
+				}
+				else
+					result = JSMN_ERROR_INVAL;
+			}
+			pos += n;
+		}
+
+		if ( result == 0 )
+		{
+			result = (int)*toknext;
+			if ( str_start >= 0 || open > 0u )
+				result = JSMN_ERROR_PART;
+		}
+	}
+	return result;
+}
+
+unsigned int app_json_token_ctz(
+	iot_uint64_t bits )
+{
+#if defined( __GNUC__ )
+	return (unsigned int)__builtin_ctzll( bits );
+#elif defined( _MSC_VER ) && defined( _M_X64 )
+	unsigned long result;
+	_BitScanForward64( &result, bits );
+	return (unsigned int)result;
+#else /* if defined( __GNUC__ ) */
+	unsigned int result = 0u;
+	if ( ( bits & 0xFFFFFFFFu ) == 0u )
+	{
+		bits >>= 32;
+		result += 32u;
+	}
+	while ( ( bits & 1u ) == 0u )
+	{
+		bits >>= 1;
+		++result;
+	}
+	return result;
+#endif /* if defined( __GNUC__ ) */
+}
+
+iot_uint64_t app_json_token_escaped(
+	iot_uint64_t backslash,
+	iot_uint64_t *carry )
+{
+	const iot_uint64_t even_bits = 0x5555555555555555u;
+	iot_uint64_t follows_escape;
+	iot_uint64_t odd_starts;
+	iot_uint64_t sequences;
+
+	/* an escaped back slash does not start a sequence */
+	backslash &= ~(*carry);
+	follows_escape = ( backslash << 1 ) | *carry;
+
+	/* adding the starts of the sequences on odd bits carries them to the
+	 * end of the sequence, leaving the sequences that start on even bits */
+	odd_starts = backslash & ~even_bits & ~follows_escape;
+	sequences = odd_starts + backslash;
+	*carry = ( sequences < backslash ) ? 1u : 0u;
+	return ( even_bits ^ ( sequences << 1 ) ) & follows_escape;
+}
+
+size_t app_json_token_index(
+	const char *js,
+	size_t *len,
+	iot_uint64_t *index )
+{
+	size_t result = 0u;
+	if ( js && len )
+	{
+		struct app_json_token_scan scan;
+		size_t pos = 0u;
+		os_memzero( &scan, sizeof( struct app_json_token_scan ) );
+		while ( pos < *len )
+		{
+			size_t n = *len - pos;
+			size_t valid;
+			iot_uint64_t starts;
+			iot_uint64_t escaped;
+			iot_uint64_t bits;
+			if ( n > JSON_TOKEN_BLOCK )
+				n = JSON_TOKEN_BLOCK;
+			bits = app_json_token_block( &scan, &js[pos], n, &valid,
+				&starts, &escaped );
+			result += app_json_token_popcount( starts );
+			if ( index )
+			{
+				*index++ = bits | escaped;
+				*index++ = escaped;
+			}
+			if ( valid < n )
+				*len = pos + valid;
+			pos += n;
+		}
+	}
+	return result;
+}
+
+int app_json_token_parse(
+	const char *js,
+	size_t len,
+	const iot_uint64_t *index,
+	jsmntok_t *tokens,
+	unsigned int num_tokens )
+{
+	unsigned int toknext = 0u;
+	return app_json_token_build( js, len, index, tokens, num_tokens,
+		0u, &toknext, -1, 0u );
+}
+
+int app_json_token_parse_resume(
+	const char *js,
+	size_t len,
+	jsmntok_t *tokens,
+	unsigned int num_tokens,
+	unsigned int *toknext )
+{
+	int result = JSMN_ERROR_INVAL;
+	if ( js && tokens && toknext && *toknext <= num_tokens )
+	{
+		int toksuper = -1;
+		unsigned int open = 0u;
+		size_t pos = 0u;
+
+		if ( *toknext > 0u )
+		{
+			const jsmntok_t *tok = &tokens[*toknext - 1u];
+			int parent;
+			if ( tok->end == -1 )
+			{
+				/* object or array still open */
+				pos = (size_t)tok->start + 1u;
+				toksuper = (int)*toknext - 1;
+			}
+			else
+			{
+				/* after the last token, or after the last object
+				 * or array closed since (a ':' or ',' following
+				 * is read again, which sets the same parent) */
+				pos = (size_t)tok->end;
+				if ( tok->type == JSMN_STRING )
+					++pos;
+				toksuper = tok->parent;
+				for ( parent = tok->parent; parent != -1;
+					parent = tok->parent )
+				{
+					tok = &tokens[parent];
+					if ( tok->type == JSMN_OBJECT ||
+						tok->type == JSMN_ARRAY )
+					{
+						if ( tok->end == -1 )
+							break;
+						pos = (size_t)tok->end;
+						toksuper = tok->parent;
+					}
+				}
+			}
+
+			/* objects and arrays still open */
+			for ( parent = toksuper; parent != -1;
+				parent = tokens[parent].parent )
+			{
+				if ( tokens[parent].type != JSMN_STRING )
+					++open;
+			}
+		}
+		result = app_json_token_build( js, len, NULL, tokens,
+			num_tokens, pos, toknext, toksuper, open );
+	}
+	return result;
+}
+
+unsigned int app_json_token_popcount(
+	iot_uint64_t bits )
+{
+#if defined( __GNUC__ )
+	return (unsigned int)__builtin_popcountll( bits );
+#else /* if defined( __GNUC__ ) */
+	bits = bits - ( ( bits >> 1 ) & 0x5555555555555555u );
+	bits = ( bits & 0x3333333333333333u ) +
+		( ( bits >> 2 ) & 0x3333333333333333u );
+	bits = ( bits + ( bits >> 4 ) ) & 0x0F0F0F0F0F0F0F0Fu;
+	return (unsigned int)( ( bits * 0x0101010101010101u ) >> 56 );
+#endif /* if defined( __GNUC__ ) */
+}
+
+iot_uint64_t app_json_token_prefix_xor(
+	iot_uint64_t bits )
+{
+	bits ^= bits << 1;
+	bits ^= bits << 2;
+	bits ^= bits << 4;
+	bits ^= bits << 8;
+	bits ^= bits << 16;
+	bits ^= bits << 32;
+	return bits;
+}
+
+#if !defined( JSON_TOKEN_AVX2 ) && !defined( JSON_TOKEN_SSE2 ) && \
+	!defined( JSON_TOKEN_NEON )
+iot_uint64_t app_json_token_swar_bits(
+	iot_uint64_t w )
+{
+	return ( ( w >> 7 ) * 0x0102040810204080u ) >> 56;
+}
+
+iot_uint64_t app_json_token_swar_eq(
+	iot_uint64_t w,
+	unsigned char c )
+{
+	/* top bit is set in the bytes which are zero, without carrying
+	 * from one byte to the next */
+	const iot_uint64_t v = w ^ ( JSON_TOKEN_SWAR_ONES * c );
+	return ~( ( ( v & ~JSON_TOKEN_SWAR_HIGH ) + ~JSON_TOKEN_SWAR_HIGH ) |
+		v | ~JSON_TOKEN_SWAR_HIGH );
+}
+#endif /* if !defined( JSON_TOKEN_AVX2 ) && !defined( JSON_TOKEN_SSE2 ) &&
+          !defined( JSON_TOKEN_NEON ) */
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
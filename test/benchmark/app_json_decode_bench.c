@@ -0,0 +1,282 @@
+/**
+ * @file
+ * @brief micro-benchmark for JSON decoding of tr50 replies
+ *
+ * Parses typical tr50 replies (mailbox checks with actions, batches of
+ * acknowledgements and errors) through app_json_decode_parse.  The JSON
+ * library is chosen when building (IOT_JSON_LIBRARY), so building this with
+ * jsmn, jansson and json-c compares them.  With jsmn, the previous parse
+ * (jsmn_parse, growing the tokens and parsing again when they run out) is
+ * also measured.  The lookup kernel also finds the items of each mailbox
+ * message, the way the tr50 plug-in does.
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "utilities/app_json.h"
+#include "utilities/app_json_base.h"
+
+#include <os.h>
+
+/** @brief default number of iterations for each kernel */
+#define BENCH_ITERATIONS_DEFAULT 200000u
+/** @brief size of the buffer used by the decoder without the heap */
+#define BENCH_DECODE_BUFFER      4096u
+
+/** @brief a benchmark kernel, returns the number of bytes parsed */
+typedef size_t (bench_kernel_t)( size_t i );
+
+/** @brief sample tr50 replies */
+static const char *const BENCH_REPLIES[] = {
+	/* mailbox check, one action */
+	"{\"check\":{\"success\":true,\"params\":{\"messages\":[{"
+	"\"id\":\"5b3a7f0e2c1d4e0011a2b3c4\","
+	"\"thingKey\":\"f3a1c2d4-5e6f-4a7b-8c9d-0e1f2a3b4c5d-device\","
+	"\"command\":\"method.exec\",\"params\":{"
+	"\"method\":\"set_led\",\"params\":{\"state\":true,"
+	"\"colour\":\"green\",\"brightness\":75}}}]}}}",
+	/* mailbox check, several actions */
+	"{\"check\":{\"success\":true,\"params\":{\"messages\":["
+	"{\"id\":\"5b3a7f0e2c1d4e0011a2b3c5\",\"thingKey\":\"gateway-01\","
+	"\"command\":\"method.exec\",\"params\":{\"method\":\"file_download\","
+	"\"params\":{\"file_name\":\"firmware-2.1.4.tar.gz\",\"file_path\":"
+	"\"/var/lib/device/download\",\"use_global_store\":false}}},"
+	"{\"id\":\"5b3a7f0e2c1d4e0011a2b3c6\",\"thingKey\":\"gateway-01\","
+	"\"command\":\"method.exec\",\"params\":{\"method\":\"remote_login\","
+	"\"params\":{\"host\":\"127.0.0.1\",\"protocol\":\"ssh\","
+	"\"url\":\"wss://relay.example.com/ws/9f8e7d6c\",\"debug-mode\":false}}},"
+	"{\"id\":\"5b3a7f0e2c1d4e0011a2b3c7\",\"thingKey\":\"gateway-01\","
+	"\"command\":\"method.exec\",\"params\":{\"method\":\"set_interval\","
+	"\"params\":{\"interval\":30,\"unit\":\"s\",\"jitter\":0.25}}},"
+	"{\"id\":\"5b3a7f0e2c1d4e0011a2b3c8\",\"thingKey\":\"gateway-01\","
+	"\"command\":\"method.exec\",\"params\":{\"method\":\"shell\","
+	"\"params\":{\"command\":\"echo \\\"hello\\\" > /tmp/out\\\\log\"}}}"
+	"]}}}",
+	/* acknowledgements of a batch of publishes */
+	"{\"1\":{\"success\":true},\"2\":{\"success\":true},"
+	"\"3\":{\"success\":true},\"4\":{\"success\":true},"
+	"\"5\":{\"success\":true},\"6\":{\"success\":true},"
+	"\"7\":{\"success\":true},\"8\":{\"success\":true},"
+	"\"9\":{\"success\":true},\"10\":{\"success\":true},"
+	"\"11\":{\"success\":true},\"12\":{\"success\":true},"
+	"\"ping\":{\"success\":true}}",
+	/* errors */
+	"{\"2\":{\"success\":false,\"errorCodes\":[-90008],"
+	"\"errorMessages\":[\"Thing not found: gateway-01\"]},"
+	"\"check\":{\"success\":true,\"params\":{\"messages\":[]}}}" };
+
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+/**
+ * @brief Previous parse, growing the tokens and parsing again
+ *
+ * @param[in]      i                   sample index
+ *
+ * @return the number of bytes parsed
+ */
+static size_t legacy_parse( size_t i );
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+
+/**
+ * @brief Current parse, tokens allocated on the heap
+ *
+ * @param[in]      i                   sample index
+ *
+ * @return the number of bytes parsed
+ */
+static size_t current_parse_dynamic( size_t i );
+
+/**
+ * @brief Current parse, tokens in a fixed buffer
+ *
+ * @param[in]      i                   sample index
+ *
+ * @return the number of bytes parsed
+ */
+static size_t current_parse_fixed( size_t i );
+
+/**
+ * @brief Current parse, then finds the items of each mailbox message the
+ *        way the tr50 plug-in does
+ *
+ * @param[in]      i                   sample index
+ *
+ * @return the number of bytes parsed
+ */
+static size_t current_parse_lookup( size_t i );
+
+/**
+ * @brief Runs a kernel and prints the time taken and bytes parsed
+ *
+ * @param[in]      name                name of the kernel
+ * @param[in]      kernel              kernel to run
+ * @param[in]      iterations          number of times to call the kernel
+ */
+static void run_kernel( const char *name, bench_kernel_t *kernel,
+	size_t iterations );
+
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+size_t legacy_parse( size_t i )
+{
+	const size_t count = sizeof( BENCH_REPLIES ) / sizeof( BENCH_REPLIES[0] );
+	const char *const js = BENCH_REPLIES[i % count];
+	const size_t len = os_strlen( js );
+	unsigned int size = 1u;
+	jsmntok_t *tokens = os_malloc( sizeof( jsmntok_t ) * size );
+	int r = JSMN_ERROR_NOMEM;
+	while ( r == JSMN_ERROR_NOMEM && tokens )
+	{
+		jsmn_parser parser;
+		jsmn_init( &parser );
+		r = jsmn_parse( &parser, js, len, tokens, size );
+		if ( r == JSMN_ERROR_NOMEM )
+		{
+			jsmntok_t *const t = os_realloc( tokens,
+				sizeof( jsmntok_t ) * ( size + 1u ) * 2u );
+			size = ( size + 1u ) * 2u;
+			if ( !t )
+				os_free( tokens );
+			tokens = t;
+		}
+	}
+	if ( tokens )
+		os_free( tokens );
+	return r > 0 ? len : 0u;
+}
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+
+size_t current_parse_dynamic( size_t i )
+{
+	const size_t count = sizeof( BENCH_REPLIES ) / sizeof( BENCH_REPLIES[0] );
+	const char *const js = BENCH_REPLIES[i % count];
+	const size_t len = os_strlen( js );
+	size_t result = 0u;
+	app_json_decoder_t *const decoder = app_json_decode_initialize(
+		NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+	if ( decoder )
+	{
+		const app_json_item_t *root = NULL;
+		if ( app_json_decode_parse( decoder, js, len, &root,
+			NULL, 0u ) == IOT_STATUS_SUCCESS )
+			result = len;
+		app_json_decode_terminate( decoder );
+	}
+	return result;
+}
+
+size_t current_parse_fixed( size_t i )
+{
+	const size_t count = sizeof( BENCH_REPLIES ) / sizeof( BENCH_REPLIES[0] );
+	const char *const js = BENCH_REPLIES[i % count];
+	const size_t len = os_strlen( js );
+	size_t result = 0u;
+	char buf[ BENCH_DECODE_BUFFER ];
+	app_json_decoder_t *const decoder = app_json_decode_initialize(
+		buf, sizeof( buf ), 0u );
+	if ( decoder )
+	{
+		const app_json_item_t *root = NULL;
+		if ( app_json_decode_parse( decoder, js, len, &root,
+			NULL, 0u ) == IOT_STATUS_SUCCESS )
+			result = len;
+		app_json_decode_terminate( decoder );
+	}
+	return result;
+}
+
+size_t current_parse_lookup( size_t i )
+{
+	const size_t count = sizeof( BENCH_REPLIES ) / sizeof( BENCH_REPLIES[0] );
+	const char *const js = BENCH_REPLIES[i % count];
+	const size_t len = os_strlen( js );
+	size_t result = 0u;
+	app_json_decoder_t *const decoder = app_json_decode_initialize(
+		NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+	if ( decoder )
+	{
+		const app_json_item_t *root = NULL;
+		if ( app_json_decode_parse( decoder, js, len, &root,
+			NULL, 0u ) == IOT_STATUS_SUCCESS )
+		{
+			const app_json_item_t *j_check;
+			const app_json_item_t *j_messages;
+			const app_json_item_t *j_params;
+			size_t msg_count;
+			size_t m;
+
+			j_check = app_json_decode_object_find( decoder, root,
+				"check" );
+			j_params = app_json_decode_object_find( decoder, j_check,
+				"params" );
+			j_messages = app_json_decode_object_find( decoder,
+				j_params, "messages" );
+			msg_count = app_json_decode_array_size( decoder, j_messages );
+			for ( m = 0u; m < msg_count; ++m )
+			{
+				const app_json_item_t *j_msg = NULL;
+				if ( app_json_decode_array_at( decoder, j_messages,
+					m, &j_msg ) == IOT_STATUS_SUCCESS &&
+					app_json_decode_object_find( decoder, j_msg,
+					"id" ) )
+				{
+					j_params = app_json_decode_object_find(
+						decoder, j_msg, "params" );
+					app_json_decode_object_find( decoder,
+						j_params, "method" );
+				}
+			}
+			result = len;
+		}
+		app_json_decode_terminate( decoder );
+	}
+	return result;
+}
+
+void run_kernel( const char *name, bench_kernel_t *kernel,
+	size_t iterations )
+{
+	os_timestamp_t start = 0u;
+	os_timestamp_t end = 0u;
+	size_t bytes = 0u;
+	size_t i;
+
+	os_time( &start, NULL );
+	for ( i = 0u; i < iterations; ++i )
+		bytes += kernel( i );
+	os_time( &end, NULL );
+
+	os_printf( "%-18s %8lu ms %12lu bytes\n", name,
+		(unsigned long)( end - start ), (unsigned long)bytes );
+}
+
+int main( int argc, char *argv[] )
+{
+	size_t iterations = BENCH_ITERATIONS_DEFAULT;
+	if ( argc > 1 )
+		iterations = (size_t)os_strtoul( argv[1], NULL );
+
+#if defined( IOT_JSON_JANSSON )
+	os_printf( "jansson, " );
+#elif defined( IOT_JSON_JSONC )
+	os_printf( "json-c, " );
+#else /* defined( IOT_JSON_JSMN ) */
+	os_printf( "jsmn, " );
+#endif /* defined( IOT_JSON_JSMN ) */
+	os_printf( "%lu iterations per kernel\n", (unsigned long)iterations );
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+	run_kernel( "legacy parse", legacy_parse, iterations );
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+	run_kernel( "current dynamic", current_parse_dynamic, iterations );
+	run_kernel( "current fixed", current_parse_fixed, iterations );
+	run_kernel( "current lookup", current_parse_lookup, iterations );
+	return 0;
+}
@@ -0,0 +1,308 @@
+/**
+ * @file
+ * @brief micro-benchmark for the jsmn-backend JSON encoding kernels
+ *
+ * Compares the previous digit-by-digit number and byte-by-byte string
+ * encoding with the current kernels used by app_json_encode_*.
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "utilities/app_json.h"
+#include "utilities/app_json_base.h"
+
+#include <os.h>
+
+/** @brief default number of iterations for each kernel */
+#define BENCH_ITERATIONS_DEFAULT 1000000u
+/** @brief number of decimals the previous real encoder wrote */
+#define LEGACY_MAX_DECIMALS      6
+
+/** @brief a benchmark kernel, returns the number of bytes written */
+typedef size_t (bench_kernel_t)( char *out, size_t i );
+
+/** @brief sample telemetry values */
+static const double BENCH_REALS[] = {
+	0.1, 23.45, -0.25, 1013.25, 3.14159265358979, 1e-3, 98.6, -40.0 };
+/** @brief sample telemetry integers */
+static const iot_int64_t BENCH_INTEGERS[] = {
+	0, 7, -42, 1024, 65535, -2147483647, 4294967296, 9007199254740993 };
+/** @brief sample strings with and without characters to escape */
+static const char *const BENCH_STRINGS[] = {
+	"temperature",
+	"device-0001-2f9c-4b7a-8d1e-9a0f3c6b5e21",
+	"a much longer attribute value that has no characters to escape "
+	"in it at all, typical of a description or a firmware string",
+	"line one\nline two\twith \"quotes\" and a \\ back slash" };
+
+/**
+ * @brief Previous length calculation for integers
+ *
+ * @param[in]      i                   absolute value
+ * @param[in]      neg                 whether the value is negative
+ *
+ * @return the number of characters required
+ */
+static size_t legacy_intlen( iot_uint64_t i, iot_bool_t neg );
+
+/**
+ * @brief Previous integer encoding (integers were published as reals)
+ *
+ * @param[out]     out                 output buffer
+ * @param[in]      i                   sample index
+ *
+ * @return the number of bytes written
+ */
+static size_t legacy_integer( char *out, size_t i );
+
+/**
+ * @brief Previous real encoding, digit by digit
+ *
+ * @param[out]     out                 output buffer
+ * @param[in]      value               value to encode
+ *
+ * @return the number of bytes written
+ */
+static size_t legacy_real( char *out, double value );
+
+/**
+ * @brief Previous real encoding of the sample reals
+ *
+ * @param[out]     out                 output buffer
+ * @param[in]      i                   sample index
+ *
+ * @return the number of bytes written
+ */
+static size_t legacy_reals( char *out, size_t i );
+
+/**
+ * @brief Previous string encoding, one byte at a time
+ *
+ * @param[out]     out                 output buffer
+ * @param[in]      i                   sample index
+ *
+ * @return the number of bytes written
+ */
+static size_t legacy_string( char *out, size_t i );
+
+/**
+ * @brief Current integer encoding of the sample integers
+ *
+ * @param[out]     out                 output buffer
+ * @param[in]      i                   sample index
+ *
+ * @return the number of bytes written
+ */
+static size_t current_integer( char *out, size_t i );
+
+/**
+ * @brief Current shortest real encoding of the sample reals
+ *
+ * @param[out]     out                 output buffer
+ * @param[in]      i                   sample index
+ *
+ * @return the number of bytes written
+ */
+static size_t current_reals( char *out, size_t i );
+
+/**
+ * @brief Current string encoding
+ *
+ * @param[out]     out                 output buffer
+ * @param[in]      i                   sample index
+ *
+ * @return the number of bytes written
+ */
+static size_t current_string( char *out, size_t i );
+
+/**
+ * @brief Runs a kernel and prints the time taken and bytes written
+ *
+ * @param[in]      name                name of the kernel
+ * @param[in]      kernel              kernel to run
+ * @param[in]      iterations          number of times to call the kernel
+ */
+static void run_kernel( const char *name, bench_kernel_t *kernel,
+	size_t iterations );
+
+size_t legacy_intlen( iot_uint64_t i, iot_bool_t neg )
+{
+	size_t len = 0u;
+	if ( neg || i == 0 )
+		++len;
+	while ( i > 0 )
+	{
+		i /= 10;
+		++len;
+	}
+	return len;
+}
+
+size_t legacy_integer( char *out, size_t i )
+{
+	const size_t count = sizeof( BENCH_INTEGERS ) / sizeof( BENCH_INTEGERS[0] );
+	return legacy_real( out, (double)BENCH_INTEGERS[i % count] );
+}
+
+size_t legacy_real( char *out, double value )
+{
+	char *const start = out;
+	iot_uint64_t i = (iot_uint64_t)value;
+	double frac = value - i;
+	size_t int_len;
+	char *dest;
+
+	if ( value < 0.0 )
+	{
+		i = (iot_uint64_t)(value * -1.0);
+		frac = (value * -1.0) - i;
+	}
+
+	int_len = legacy_intlen( i, value < 0.0 );
+	dest = &out[int_len - 1u];
+	if ( value < 0.0 )
+		*out++ = '-';
+	if ( i == 0 )
+		*out++ = '0';
+	while ( i > 0u )
+	{
+		*dest = (char)(i % 10 + '0');
+		i /= 10;
+		--dest;
+		++out;
+	}
+
+	*out++ = '.';
+	i = 0u;
+	do {
+		int j;
+		frac *= 10.0;
+		j = (int)(frac);
+		*out++ = '0' + (char)j;
+		frac -= j;
+		++i;
+	} while ( frac > 0.0 && i < LEGACY_MAX_DECIMALS );
+	return (size_t)(out - start);
+}
+
+size_t legacy_reals( char *out, size_t i )
+{
+	const size_t count = sizeof( BENCH_REALS ) / sizeof( BENCH_REALS[0] );
+	return legacy_real( out, BENCH_REALS[i % count] );
+}
+
+size_t legacy_string( char *out, size_t i )
+{
+	const size_t count = sizeof( BENCH_STRINGS ) / sizeof( BENCH_STRINGS[0] );
+	const char *str = BENCH_STRINGS[i % count];
+	const char *src = str;
+	size_t len = 0u;
+	char *dest = out;
+
+	/* length pass */
+	while ( *str != '\0' )
+	{
+		if ( *str == '\"' || *str == '\\' || *str == '\b' ||
+		     *str == '\f' || *str == '\n' || *str == '\r' ||
+		     *str == '\t' )
+			++len;
+		++len;
+		++str;
+	}
+
+	/* copy pass */
+	for ( i = 0u; i < len && *src != '\0'; ++src, ++i )
+	{
+		char c = *src;
+		switch ( c )
+		{
+		case '\b': c = 'b'; break;
+		case '\f': c = 'f'; break;
+		case '\n': c = 'n'; break;
+		case '\r': c = 'r'; break;
+		case '\t': c = 't'; break;
+		default: break;
+		}
+		if ( c != *src || c == '\"' || c == '\\' )
+		{
+			*dest++ = '\\';
+			++i;
+		}
+		*dest++ = c;
+	}
+	return (size_t)(dest - out);
+}
+
+size_t current_integer( char *out, size_t i )
+{
+	const size_t count = sizeof( BENCH_INTEGERS ) / sizeof( BENCH_INTEGERS[0] );
+	const iot_int64_t value = BENCH_INTEGERS[i % count];
+	size_t result;
+	if ( value < 0 )
+		result = app_json_number_integer( out,
+			(iot_uint64_t)0u - (iot_uint64_t)value, IOT_TRUE );
+	else
+		result = app_json_number_integer( out,
+			(iot_uint64_t)value, IOT_FALSE );
+	return result;
+}
+
+size_t current_reals( char *out, size_t i )
+{
+	const size_t count = sizeof( BENCH_REALS ) / sizeof( BENCH_REALS[0] );
+	return app_json_number_real( out, BENCH_REALS[i % count],
+		APP_JSON_PRECISION_SHORTEST );
+}
+
+size_t current_string( char *out, size_t i )
+{
+	const size_t count = sizeof( BENCH_STRINGS ) / sizeof( BENCH_STRINGS[0] );
+	const char *const str = BENCH_STRINGS[i % count];
+	const size_t str_len = os_strlen( str );
+	const size_t len = app_json_string_escape_len( str, str_len );
+	return app_json_string_escape( out, str, str_len, len );
+}
+
+void run_kernel( const char *name, bench_kernel_t *kernel,
+	size_t iterations )
+{
+	char out[256u];
+	os_timestamp_t start = 0u;
+	os_timestamp_t end = 0u;
+	size_t bytes = 0u;
+	size_t i;
+
+	os_time( &start, NULL );
+	for ( i = 0u; i < iterations; ++i )
+		bytes += kernel( out, i );
+	os_time( &end, NULL );
+
+	os_printf( "%-18s %8lu ms %12lu bytes\n", name,
+		(unsigned long)( end - start ), (unsigned long)bytes );
+}
+
+int main( int argc, char *argv[] )
+{
+	size_t iterations = BENCH_ITERATIONS_DEFAULT;
+	if ( argc > 1 )
+		iterations = (size_t)os_strtoul( argv[1], NULL );
+
+	os_printf( "%lu iterations per kernel\n", (unsigned long)iterations );
+	run_kernel( "legacy integer", legacy_integer, iterations );
+	run_kernel( "current integer", current_integer, iterations );
+	run_kernel( "legacy real", legacy_reals, iterations );
+	run_kernel( "current real", current_reals, iterations );
+	run_kernel( "legacy string", legacy_string, iterations );
+	run_kernel( "current string", current_string, iterations );
+	return 0;
+}
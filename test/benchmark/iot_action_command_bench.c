@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @brief micro-benchmark for launching command actions
+ *
+ * Runs a command action a number of times with each launch method: through
+ * the shell, spawned directly and spawned by the helper process.  Reports
+ * the average and worst latency from queuing a request to the command
+ * exiting.
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "api/public/iot.h"
+#include "api/shared/iot_types.h"
+
+#include <os.h>
+
+/** @brief default number of times the command is run per method */
+#define BENCH_REQUESTS_DEFAULT   1000u
+/** @brief default command run */
+#define BENCH_COMMAND_DEFAULT    "/bin/true"
+
+/**
+ * @brief Runs the benchmark for a launch method
+ *
+ * @param[in]      name                name of the launch method
+ * @param[in]      launch              launch method
+ * @param[in]      command             command to run
+ * @param[in]      requests            number of times to run the command
+ */
+static void bench_run( const char *name, iot_uint8_t launch,
+	const char *command, iot_uint64_t requests );
+
+void bench_run( const char *name, iot_uint8_t launch,
+	const char *command, iot_uint64_t requests )
+{
+	iot_t *lib;
+	iot_action_t *action;
+	os_timestamp_t start = 0u;
+	os_timestamp_t end = 0u;
+	os_timestamp_t worst = 0u;
+	iot_uint64_t failed = 0u;
+	iot_uint64_t i;
+
+	lib = iot_initialize( "action-command-bench", NULL, 0u );
+	lib->command_launch = launch;
+	action = iot_action_allocate( lib, "bench_command" );
+	iot_action_flags_set( action, IOT_ACTION_NO_TIME_LIMIT );
+	iot_action_register_command( action, command, NULL, 0u );
+
+	if ( launch != IOT_COMMAND_LAUNCH_HELPER ||
+		iot_spawn_helper_start( lib ) == IOT_STATUS_SUCCESS )
+	{
+		os_time( &start, NULL );
+		for ( i = 0u; i < requests; ++i )
+		{
+			iot_action_request_t *const req =
+				iot_action_request_allocate( lib,
+					"bench_command", "bench" );
+			os_timestamp_t req_start = 0u;
+			os_timestamp_t req_end = 0u;
+
+			os_time( &req_start, NULL );
+			if ( !req || iot_action_request_execute( req, 0u ) !=
+					IOT_STATUS_SUCCESS ||
+				iot_action_process( lib, 0u ) !=
+					IOT_STATUS_SUCCESS )
+				++failed;
+			os_time( &req_end, NULL );
+			if ( req_end - req_start > worst )
+				worst = req_end - req_start;
+		}
+		os_time( &end, NULL );
+
+		if ( requests == 0u )
+			requests = 1u;
+		os_printf( "%-7s %10lu %8lu ms %9.3f ms %7lu ms %8lu\n",
+			name, (unsigned long)requests,
+			(unsigned long)( end - start ),
+			(double)( end - start ) / (double)requests,
+			(unsigned long)worst, (unsigned long)failed );
+	}
+	else
+		os_printf( "%-7s %s\n", name, "not supported" );
+
+	iot_action_free( action, 0u );
+	iot_terminate( lib, 0u );
+}
+
+int main( int argc, char *argv[] )
+{
+	iot_uint64_t requests = BENCH_REQUESTS_DEFAULT;
+	const char *command = BENCH_COMMAND_DEFAULT;
+	if ( argc > 1 )
+		requests = (iot_uint64_t)os_strtoul( argv[1], NULL );
+	if ( argc > 2 )
+		command = argv[2];
+
+	os_printf( "%lu runs of \"%s\"\n", (unsigned long)requests, command );
+	os_printf( "%-7s %10s %11s %12s %10s %8s\n", "launch", "requests",
+		"time", "average", "worst", "failed" );
+	bench_run( "shell", IOT_COMMAND_LAUNCH_SHELL, command, requests );
+	bench_run( "spawn", IOT_COMMAND_LAUNCH_SPAWN, command, requests );
+	bench_run( "helper", IOT_COMMAND_LAUNCH_HELPER, command, requests );
+	return 0;
+}
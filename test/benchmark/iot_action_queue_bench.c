@@ -0,0 +1,255 @@
+/**
+ * @file
+ * @brief micro-benchmark for the action request queue
+ *
+ * Queues requests from one producer to 1 to 16 worker threads and
+ * reports the throughput of the queue under contention.  Every 16th
+ * request is for a high priority action, the others are for a low
+ * priority action; the number of requests completed while a high
+ * priority request was waiting shows how far it jumped the queue.
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "api/public/iot.h"
+#include "api/shared/iot_types.h"
+
+#include <os.h>
+
+/** @brief default number of requests queued for each worker count */
+#define BENCH_REQUESTS_DEFAULT   100000u
+/** @brief default number of loop iterations of work per low request */
+#define BENCH_WORK_DEFAULT       1000u
+/** @brief maximum number of worker threads */
+#define BENCH_WORKERS_MAX        16u
+/** @brief every n-th request is for the high priority action */
+#define BENCH_HIGH_INTERVAL      16u
+
+/** @brief state shared between the producer and the workers */
+struct bench
+{
+	/** @brief requests completed */
+	iot_uint64_t completed;
+	/** @brief number of workers that have stopped */
+	unsigned int exited;
+	/** @brief high priority requests completed */
+	iot_uint64_t high_count;
+	/** @brief requests completed while high priority ones waited */
+	iot_uint64_t high_waited;
+	/** @brief library handle */
+	iot_t *lib;
+	/** @brief mutex protecting the counters */
+	os_thread_mutex_t mutex;
+	/** @brief whether the workers are to stop */
+	iot_bool_t stop;
+	/** @brief loop iterations of work per low priority request */
+	unsigned long work;
+};
+
+/**
+ * @brief Action called for each benchmark request
+ *
+ * @param[in]      request             request to execute
+ * @param[in]      user_data           benchmark state
+ *
+ * @retval IOT_STATUS_SUCCESS          always
+ */
+static iot_status_t bench_action( iot_action_request_t *request,
+	void *user_data );
+
+/**
+ * @brief Queues a request, retrying while the queue is full
+ *
+ * @param[in]      b                   benchmark state
+ * @param[in]      name                name of the action to request
+ * @param[in]      high                whether the action is high priority
+ */
+static void bench_queue( struct bench *b, const char *name,
+	iot_bool_t high );
+
+/**
+ * @brief Runs the benchmark for a number of worker threads
+ *
+ * @param[in]      workers             number of worker threads
+ * @param[in]      requests            number of requests to queue
+ * @param[in]      work                loop iterations per low request
+ */
+static void bench_run( unsigned int workers, iot_uint64_t requests,
+	unsigned long work );
+
+/**
+ * @brief Worker thread processing queued requests
+ *
+ * @param[in]      user_data           benchmark state
+ *
+ * @return 0
+ */
+static OS_THREAD_DECL bench_worker( void *user_data );
+
+iot_status_t bench_action( iot_action_request_t *request,
+	void *user_data )
+{
+	struct bench *const b = (struct bench *)user_data;
+	iot_uint64_t seq = 0u;
+	iot_bool_t high = IOT_FALSE;
+
+	if ( iot_action_request_option_get( request, "seq", IOT_FALSE,
+		IOT_TYPE_UINT64, &seq ) == IOT_STATUS_SUCCESS )
+		high = IOT_TRUE;
+	else
+	{
+		volatile unsigned long i;
+		for ( i = 0u; i < b->work; ++i );
+	}
+
+	os_thread_mutex_lock( &b->mutex );
+	if ( high != IOT_FALSE )
+	{
+		b->high_waited += b->completed - seq;
+		++b->high_count;
+	}
+	++b->completed;
+	os_thread_mutex_unlock( &b->mutex );
+	return IOT_STATUS_SUCCESS;
+}
+
+void bench_queue( struct bench *b, const char *name, iot_bool_t high )
+{
+	iot_action_request_t *req = NULL;
+	while ( !req )
+		req = iot_action_request_allocate( b->lib, name, "bench" );
+	if ( high != IOT_FALSE )
+	{
+		iot_uint64_t seq;
+		os_thread_mutex_lock( &b->mutex );
+		seq = b->completed;
+		os_thread_mutex_unlock( &b->mutex );
+		iot_action_request_option_set( req, "seq",
+			IOT_TYPE_UINT64, seq );
+	}
+	iot_action_request_execute( req, 0u );
+}
+
+void bench_run( unsigned int workers, iot_uint64_t requests,
+	unsigned long work )
+{
+	struct bench b;
+	os_thread_t thread[BENCH_WORKERS_MAX];
+	iot_action_t *high_action;
+	iot_action_t *low_action;
+	os_timestamp_t start = 0u;
+	os_timestamp_t end = 0u;
+	iot_uint64_t completed = 0u;
+	iot_uint64_t i;
+	unsigned int exited = 0u;
+	unsigned int w;
+
+	os_memzero( &b, sizeof( struct bench ) );
+	b.work = work;
+	b.lib = iot_initialize( "action-queue-bench", NULL, 0u );
+	os_thread_mutex_create( &b.mutex );
+
+	high_action = iot_action_allocate( b.lib, "bench_high" );
+	iot_action_flags_set( high_action, IOT_ACTION_PRIORITY_HIGH );
+	iot_action_register_callback( high_action, bench_action, &b,
+		NULL, 0u );
+	low_action = iot_action_allocate( b.lib, "bench_low" );
+	iot_action_flags_set( low_action, IOT_ACTION_PRIORITY_LOW );
+	iot_action_register_callback( low_action, bench_action, &b,
+		NULL, 0u );
+
+	for ( w = 0u; w < workers; ++w )
+		os_thread_create( &thread[w], bench_worker, &b, 0u );
+
+	os_time( &start, NULL );
+	for ( i = 0u; i < requests; ++i )
+	{
+		if ( i % BENCH_HIGH_INTERVAL == 0u )
+			bench_queue( &b, "bench_high", IOT_TRUE );
+		else
+			bench_queue( &b, "bench_low", IOT_FALSE );
+	}
+	while ( completed < requests )
+	{
+		os_time_sleep( 1u, IOT_FALSE );
+		os_thread_mutex_lock( &b.mutex );
+		completed = b.completed;
+		os_thread_mutex_unlock( &b.mutex );
+	}
+	os_time( &end, NULL );
+
+	/* wake the workers until they have all stopped */
+	os_thread_mutex_lock( &b.mutex );
+	b.stop = IOT_TRUE;
+	os_thread_mutex_unlock( &b.mutex );
+	while ( exited < workers )
+	{
+		bench_queue( &b, "bench_high", IOT_FALSE );
+		os_time_sleep( 1u, IOT_FALSE );
+		os_thread_mutex_lock( &b.mutex );
+		exited = b.exited;
+		os_thread_mutex_unlock( &b.mutex );
+	}
+	for ( w = 0u; w < workers; ++w )
+		os_thread_wait( &thread[w] );
+
+	if ( end == start )
+		end = start + 1u;
+	if ( b.high_count == 0u )
+		b.high_count = 1u;
+	os_printf( "%7u %10lu %8lu ms %12lu %12.1f\n", workers,
+		(unsigned long)requests, (unsigned long)( end - start ),
+		(unsigned long)( requests * 1000u / ( end - start ) ),
+		(double)b.high_waited / (double)b.high_count );
+
+	iot_action_free( high_action, 0u );
+	iot_action_free( low_action, 0u );
+	iot_terminate( b.lib, 0u );
+	os_thread_mutex_destroy( &b.mutex );
+}
+
+OS_THREAD_DECL bench_worker( void *user_data )
+{
+	struct bench *const b = (struct bench *)user_data;
+	iot_bool_t stop = IOT_FALSE;
+	while ( stop == IOT_FALSE )
+	{
+		iot_action_process( b->lib, 0u );
+		os_thread_mutex_lock( &b->mutex );
+		stop = b->stop;
+		if ( stop != IOT_FALSE )
+			++b->exited;
+		os_thread_mutex_unlock( &b->mutex );
+	}
+	return (OS_THREAD_RETURN)0;
+}
+
+int main( int argc, char *argv[] )
+{
+	iot_uint64_t requests = BENCH_REQUESTS_DEFAULT;
+	unsigned long work = BENCH_WORK_DEFAULT;
+	unsigned int workers;
+	if ( argc > 1 )
+		requests = (iot_uint64_t)os_strtoul( argv[1], NULL );
+	if ( argc > 2 )
+		work = os_strtoul( argv[2], NULL );
+
+	os_printf( "%lu requests, %lu iterations of work per request, "
+		"1 in %u high priority\n", (unsigned long)requests, work,
+		BENCH_HIGH_INTERVAL );
+	os_printf( "%7s %10s %11s %12s %12s\n", "workers", "requests",
+		"time", "requests/s", "high wait" );
+	for ( workers = 1u; workers <= BENCH_WORKERS_MAX; workers *= 2u )
+		bench_run( workers, requests, work );
+	return 0;
+}
@@ -18,11 +18,26 @@
 #include "test_support.h"
 
 #include "api/public/iot.h"
+#include "api/iot_common.h"
 #include "api/shared/iot_types.h"
 #include "iot_build.h"
 
+#include <stddef.h> /* for offsetof */
 #include <string.h>
 
+/* adds the actions set up by a test to the action index */
+static void test_action_index( struct iot *lib )
+{
+	iot_uint32_t i;
+	iot_common_index_initialize( &lib->action_index,
+		offsetof( struct iot_action, name ), lib->_action_index,
+		IOT_INDEX_SIZE( IOT_ACTION_MAX ) );
+	for ( i = 0u; i < lib->action_count; ++i )
+		if ( lib->action_ptr[i] && lib->action_ptr[i]->name )
+			iot_common_index_insert( &lib->action_index,
+				lib->action_ptr[i] );
+}
+
 static iot_status_t test_callback_func( iot_action_request_t *request, void *user_data )
 {
 	assert_non_null( request );
@@ -131,6 +146,9 @@ static void test_iot_action_allocate_full( void **state )
 	}
 
 	lib.action_count = IOT_ACTION_MAX;
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 0 ); /* grow list of actions */
+#endif
 	action = iot_action_allocate( &lib, "newaction" );
 	assert_null( action );
 	assert_int_equal( lib.action_count, IOT_ACTION_MAX );
@@ -142,6 +160,53 @@ static void test_iot_action_allocate_full( void **state )
 	test_free( stack_actions );
 }
 
+static void test_iot_action_allocate_grow( void **state )
+{
+#ifndef IOT_STACK_ONLY
+	size_t i;
+	iot_action_t *action;
+	iot_t lib;
+	char _name[IOT_ACTION_MAX][ IOT_NAME_MAX_LEN + 1u ];
+	iot_action_t *stack_actions = NULL;
+
+	stack_actions = (iot_action_t *)test_calloc( IOT_ACTION_MAX - IOT_ACTION_STACK_MAX,
+	                                             sizeof( iot_action_t ) );
+	assert_non_null( stack_actions );
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	for ( i = 0u; i < IOT_ACTION_MAX; ++i )
+	{
+		if ( i < IOT_ACTION_STACK_MAX )
+			lib.action_ptr[i] = &lib.action[i];
+		else
+			lib.action_ptr[i] = &stack_actions[i - IOT_ACTION_STACK_MAX];
+		lib.action_ptr[i]->name = &_name[i][0];
+		snprintf( lib.action_ptr[i]->name, IOT_NAME_MAX_LEN, "%luaction", i + 1u );
+	}
+
+	lib.action_count = IOT_ACTION_MAX;
+	will_return( __wrap_os_malloc, 1 ); /* grow list of actions */
+	will_return( __wrap_os_malloc, 1 ); /* grow action index */
+	will_return( __wrap_os_malloc, 1 ); /* for new object */
+	will_return( __wrap_os_malloc, 1 ); /* for item name */
+	action = iot_action_allocate( &lib, "newaction" );
+	assert_non_null( action );
+	assert_int_equal( lib.action_count, IOT_ACTION_MAX + 1u );
+	assert_non_null( lib.action_heap );
+	assert_int_equal( lib.action_max, IOT_ACTION_MAX * 2u );
+	assert_ptr_equal( lib.action_heap[0], lib.action_ptr[0] );
+	assert_ptr_equal( lib.action_heap[IOT_ACTION_MAX], action );
+	assert_ptr_equal( iot_action_find( &lib, "NewAction" ), action );
+
+	/* clean up */
+	os_free( action->name );
+	os_free( action );
+	os_free( lib.action_heap );
+	iot_common_index_terminate( &lib.action_index );
+	test_free( stack_actions );
+#endif /* ifndef IOT_STACK_ONLY */
+}
+
 static void test_iot_action_allocate_stack_full( void **state )
 {
 	size_t i;
@@ -243,6 +308,29 @@ static void test_iot_action_allocate_no_memory( void **state )
 	assert_null( result );
 }
 
+static void test_iot_action_concurrency_set_bad_action( void **state )
+{
+	iot_status_t result;
+	result = iot_action_concurrency_set( NULL, 1u );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+static void test_iot_action_concurrency_set_valid( void **state )
+{
+	struct iot_action act;
+	iot_status_t result;
+
+	memset( &act, 0, sizeof( struct iot_action ) );
+	result = iot_action_concurrency_set( &act, 2u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( act.concurrency_max, 2u );
+
+	/* remove the limit */
+	result = iot_action_concurrency_set( &act, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( act.concurrency_max, 0u );
+}
+
 static void test_iot_action_deregister_deregistered( void **state )
 {
 	size_t i;
@@ -718,6 +806,91 @@ static void test_iot_action_free_transmit_fail( void **state )
 #endif
 }
 
+static void test_iot_action_lock_group_add_bad_parameter( void **state )
+{
+	struct iot lib;
+	struct iot_action act;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	memset( &act, 0, sizeof( struct iot_action ) );
+	result = iot_action_lock_group_add( NULL, "filesystem", IOT_TRUE );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = iot_action_lock_group_add( &act, "filesystem", IOT_TRUE );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	act.lib = &lib;
+	result = iot_action_lock_group_add( &act, NULL, IOT_TRUE );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = iot_action_lock_group_add( &act, "", IOT_TRUE );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	assert_int_equal( lib.lock_group_count, 0u );
+}
+
+static void test_iot_action_lock_group_add_existing( void **state )
+{
+	struct iot lib;
+	struct iot_action act1;
+	struct iot_action act2;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	memset( &act1, 0, sizeof( struct iot_action ) );
+	memset( &act2, 0, sizeof( struct iot_action ) );
+	act1.lib = &lib;
+	act2.lib = &lib;
+	result = iot_action_lock_group_add( &act1, "network-config", IOT_FALSE );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = iot_action_lock_group_add( &act1, "filesystem", IOT_FALSE );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = iot_action_lock_group_add( &act2, "filesystem", IOT_TRUE );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* groups are shared between actions, in the order created */
+	assert_int_equal( lib.lock_group_count, 2u );
+	assert_string_equal( lib.lock_group[0].name, "network-config" );
+	assert_string_equal( lib.lock_group[1].name, "filesystem" );
+	assert_int_equal( act1.lock_shared, 0x3u );
+	assert_int_equal( act1.lock_exclusive, 0u );
+	assert_int_equal( act2.lock_shared, 0u );
+	assert_int_equal( act2.lock_exclusive, 0x2u );
+
+	/* exclusive takes precedence over shared */
+	result = iot_action_lock_group_add( &act2, "filesystem", IOT_FALSE );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( act2.lock_shared, 0u );
+	assert_int_equal( act2.lock_exclusive, 0x2u );
+	result = iot_action_lock_group_add( &act1, "filesystem", IOT_TRUE );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( act1.lock_shared, 0x1u );
+	assert_int_equal( act1.lock_exclusive, 0x2u );
+}
+
+static void test_iot_action_lock_group_add_full( void **state )
+{
+	size_t i;
+	struct iot lib;
+	struct iot_action act;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	memset( &act, 0, sizeof( struct iot_action ) );
+	act.lib = &lib;
+	for ( i = 0u; i < IOT_LOCK_GROUP_MAX; ++i )
+	{
+		char name[ IOT_NAME_MAX_LEN + 1u ];
+		snprintf( name, IOT_NAME_MAX_LEN, "group %u", (unsigned)i );
+		result = iot_action_lock_group_add( &act, name, IOT_TRUE );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+	}
+	result = iot_action_lock_group_add( &act, "one more", IOT_TRUE );
+	assert_int_equal( result, IOT_STATUS_FULL );
+	assert_int_equal( lib.lock_group_count, IOT_LOCK_GROUP_MAX );
+
+	/* existing groups can still be added */
+	result = iot_action_lock_group_add( &act, "group 0", IOT_TRUE );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+}
+
 static void test_iot_action_option_get_not_there( void **state )
 {
 	iot_action_t action;
@@ -2326,23 +2499,25 @@ static void test_iot_action_process_actions_empty( void **state )
 		lib.action_ptr[i] = &lib.action[i];
 	lib.action_count = 0u;
 	lib.request_queue[0].lib = &lib;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
 		lib.request_queue[i].lib = &lib;
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
 	will_return( __wrap_iot_error, "Not Found" );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -2373,24 +2548,26 @@ static void test_iot_action_process_actions_full( void **state )
 		lib.action_ptr[i]->lib = &lib;
 		lib.action_ptr[i]->callback = &test_callback_func;
 	}
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	snprintf( lib.request_queue_wait[0]->name,
+	snprintf( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name,
 	          IOT_NAME_MAX_LEN,
 	          "action name %d",
 	          IOT_ACTION_STACK_MAX / 2 );
 	will_return( test_callback_func, IOT_STATUS_SUCCESS );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -2427,21 +2604,23 @@ static void test_iot_action_process_actions_not_found( void **state )
 		lib.action_ptr[i]->lib = &lib;
 		lib.action_ptr[i]->callback = &test_callback_func;
 	}
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
 	will_return( __wrap_iot_error, "Not Found" );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -2480,25 +2659,27 @@ static void test_iot_action_process_command_no_return( void **state )
 	lib.action_ptr[0]->callback = NULL;
 	strncpy( lib.action_ptr[0]->command, "script_path", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->flags = IOT_ACTION_NO_RETURN;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
 	expect_string( __wrap_os_system_run, args->cmd, "script_path" );
 	will_return( __wrap_os_system_run, 0u );
 	will_return( __wrap_os_system_run, NULL ); /* stdout */
 	will_return( __wrap_os_system_run, NULL ); /* stderr */
 	will_return( __wrap_os_system_run, IOT_STATUS_INVOKED );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -2559,31 +2740,32 @@ static void test_iot_action_process_command_parameter_bool( void **state )
 	strncpy( lib.action_ptr[0]->parameter[0].name, "bool", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->parameter[0].data.type = IOT_TYPE_BOOL;
 	lib.action_ptr[0]->parameter[0].type = IOT_PARAMETER_IN;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter = lib.request_queue_wait[0]->_parameter;
-	lib.request_queue_wait[0]->parameter[0].name = lib.request_queue_wait[0]->parameter[0]._name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) );
-	memset( lib.request_queue_wait[0]->parameter, 0, sizeof( struct iot_action_parameter ) );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter[0].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
-#endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "bool", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_BOOL;
-	lib.request_queue_wait[0]->parameter[0].data.value.boolean = IOT_TRUE;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "bool", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_BOOL;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.boolean = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
 	expect_string( __wrap_os_system_run, args->cmd, "script_path --bool=1" );
 	will_return( __wrap_os_system_run, 0u );
 	will_return( __wrap_os_system_run, "this is stdout" );
@@ -2603,6 +2785,7 @@ static void test_iot_action_process_command_parameter_bool( void **state )
 	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -2670,39 +2853,40 @@ static void test_iot_action_process_command_parameter_float( void **state )
 	strncpy( lib.action_ptr[0]->parameter[1].name, "float64", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->parameter[1].data.type = IOT_TYPE_FLOAT64;
 	lib.action_ptr[0]->parameter[1].type = IOT_PARAMETER_IN;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter = lib.request_queue_wait[0]->_parameter;
-	lib.request_queue_wait[0]->parameter[0].name = lib.request_queue_wait[0]->parameter[0]._name;
-	lib.request_queue_wait[0]->parameter[1].name = lib.request_queue_wait[0]->parameter[1]._name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0]._name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 2u );
-	memset( lib.request_queue_wait[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 2u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 2u );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 2u );
 	for ( i = 0u; i < 2u; ++i )
 	{
 		will_return( __wrap_os_malloc, 1 );
-		lib.request_queue_wait[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
-	}
-#endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 2u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "float32", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_FLOAT32;
-	lib.request_queue_wait[0]->parameter[0].data.value.float32 = 32.32f;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
-	strncpy( lib.request_queue_wait[0]->parameter[1].name, "float64", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[1].data.type = IOT_TYPE_FLOAT64;
-	lib.request_queue_wait[0]->parameter[1].data.value.float64 = 64.64;
-	lib.request_queue_wait[0]->parameter[1].data.has_value = IOT_TRUE;
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	}
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 2u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "float32", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_FLOAT32;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.float32 = 32.32f;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].name, "float64", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].data.type = IOT_TYPE_FLOAT64;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].data.value.float64 = 64.64;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].data.has_value = IOT_TRUE;
 	expect_string( __wrap_os_system_run, args->cmd,
 		"script_path --float32=32.320000 --float64=64.640000" );
 	will_return( __wrap_os_system_run, 0u );
@@ -2723,6 +2907,7 @@ static void test_iot_action_process_command_parameter_float( void **state )
 	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -2796,47 +2981,48 @@ static void test_iot_action_process_command_parameter_int( void **state )
 	strncpy( lib.action_ptr[0]->parameter[3].name, "int64", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->parameter[3].data.type = IOT_TYPE_INT64;
 	lib.action_ptr[0]->parameter[3].type = IOT_PARAMETER_IN;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter = lib.request_queue_wait[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
 	for ( i = 0u; i < 4u; ++i )
-		lib.request_queue_wait[0]->parameter[i].name = lib.request_queue_wait[0]->parameter[i]._name;
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
-	memset( lib.request_queue_wait[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
 	for ( i = 0u; i < 4u; ++i )
 	{
 		will_return( __wrap_os_malloc, 1 );
-		lib.request_queue_wait[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
-	}
-#endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 4u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "int8", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_INT8;
-	lib.request_queue_wait[0]->parameter[0].data.value.int8 = 8;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
-	strncpy( lib.request_queue_wait[0]->parameter[1].name, "int16", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[1].data.type = IOT_TYPE_INT16;
-	lib.request_queue_wait[0]->parameter[1].data.value.int16 = 16;
-	lib.request_queue_wait[0]->parameter[1].data.has_value = IOT_TRUE;
-	strncpy( lib.request_queue_wait[0]->parameter[2].name, "int32", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[2].data.type = IOT_TYPE_INT32;
-	lib.request_queue_wait[0]->parameter[2].data.value.int32 = 32;
-	lib.request_queue_wait[0]->parameter[2].data.has_value = IOT_TRUE;
-	strncpy( lib.request_queue_wait[0]->parameter[3].name, "int64", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[3].data.type = IOT_TYPE_INT64;
-	lib.request_queue_wait[0]->parameter[3].data.value.int64 = 64;
-	lib.request_queue_wait[0]->parameter[3].data.has_value = IOT_TRUE;
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	}
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 4u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "int8", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_INT8;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.int8 = 8;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].name, "int16", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].data.type = IOT_TYPE_INT16;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].data.value.int16 = 16;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].data.has_value = IOT_TRUE;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[2].name, "int32", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[2].data.type = IOT_TYPE_INT32;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[2].data.value.int32 = 32;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[2].data.has_value = IOT_TRUE;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[3].name, "int64", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[3].data.type = IOT_TYPE_INT64;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[3].data.value.int64 = 64;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[3].data.has_value = IOT_TRUE;
 	expect_string( __wrap_os_system_run, args->cmd,
 		"script_path --int8=8 --int16=16 --int32=32 --int64=64" );
 	will_return( __wrap_os_system_run, 0u );
@@ -2857,6 +3043,7 @@ static void test_iot_action_process_command_parameter_int( void **state )
 	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -2925,7 +3112,7 @@ static void test_iot_action_process_command_parameter_location( void **state )
 	strncpy( lib.action_ptr[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->parameter[0].data.type = IOT_TYPE_LOCATION;
 	lib.action_ptr[0]->parameter[0].type = IOT_PARAMETER_IN;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -2933,28 +3120,29 @@ static void test_iot_action_process_command_parameter_location( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter = lib.request_queue_wait[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
 	for ( i = 0u; i < 1u; ++i )
-		lib.request_queue_wait[0]->parameter[i].name = lib.request_queue_wait[0]->parameter[i]._name;
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
-	memset( lib.request_queue_wait[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
 	for ( i = 0u; i < 1u; ++i )
 	{
 		will_return( __wrap_os_malloc, 1 );
-		lib.request_queue_wait[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	}
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_LOCATION;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_LOCATION;
 #ifdef IOT_STACK_ONLY
 	loc = &loc_data;
 #else
@@ -2964,9 +3152,9 @@ static void test_iot_action_process_command_parameter_location( void **state )
 	memset( loc, 0, sizeof( struct iot_location ) );
 	loc->longitude = 40.446195;
 	loc->latitude = -79.982195;
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage = loc;
-	lib.request_queue_wait[0]->parameter[0].data.value.location = loc;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage = loc;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.location = loc;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
 	expect_string( __wrap_os_system_run, args->cmd,
 		"script_path --param=[40.446195,-79.982195]" );
 	will_return( __wrap_os_system_run, 0u );
@@ -2987,6 +3175,7 @@ static void test_iot_action_process_command_parameter_location( void **state )
 	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3051,7 +3240,7 @@ static void test_iot_action_process_command_parameter_null( void **state )
 	strncpy( lib.action_ptr[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->parameter[0].data.type = IOT_TYPE_NULL;
 	lib.action_ptr[0]->parameter[0].type = IOT_PARAMETER_IN;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -3059,29 +3248,30 @@ static void test_iot_action_process_command_parameter_null( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter = lib.request_queue_wait[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
 	for ( i = 0u; i < 1u; ++i )
-		lib.request_queue_wait[0]->parameter[i].name = lib.request_queue_wait[0]->parameter[i]._name;
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
-	memset( lib.request_queue_wait[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
 	for ( i = 0u; i < 1u; ++i )
 	{
 		will_return( __wrap_os_malloc, 1 );
-		lib.request_queue_wait[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	}
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_NULL;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_NULL;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
 	expect_string( __wrap_os_system_run, args->cmd,
 		"script_path --param=[NULL]" );
 	will_return( __wrap_os_system_run, 0u );
@@ -3102,6 +3292,7 @@ static void test_iot_action_process_command_parameter_null( void **state )
 	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3166,7 +3357,7 @@ static void test_iot_action_process_command_parameter_raw( void **state )
 	strncpy( lib.action_ptr[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->parameter[0].data.type = IOT_TYPE_RAW;
 	lib.action_ptr[0]->parameter[0].type = IOT_PARAMETER_IN;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -3174,42 +3365,43 @@ static void test_iot_action_process_command_parameter_raw( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter = lib.request_queue_wait[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
 	for ( i = 0u; i < 1u; ++i )
-		lib.request_queue_wait[0]->parameter[i].name = lib.request_queue_wait[0]->parameter[i]._name;
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
-	memset( lib.request_queue_wait[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
 	for ( i = 0u; i < 1u; ++i )
 	{
 		will_return( __wrap_os_malloc, 1 );
-		lib.request_queue_wait[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	}
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_RAW;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_RAW;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage = NULL;
-	lib.request_queue_wait[0]->parameter[0].data.value.raw.ptr =
-	    lib.request_queue_wait[0]->parameter[0].data.heap_storage;
-	lib.request_queue_wait[0]->parameter[0].data.value.raw.length = 0u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage = NULL;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.raw.ptr =
+	    lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.raw.length = 0u;
 #else
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage = test_malloc( sizeof( char ) * 25 );
-	lib.request_queue_wait[0]->parameter[0].data.value.raw.ptr =
-	    lib.request_queue_wait[0]->parameter[0].data.heap_storage;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage = test_malloc( sizeof( char ) * 25 );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.raw.ptr =
+	    lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage;
 	strncpy(
-	    (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage, "raw data value", 25 );
-	lib.request_queue_wait[0]->parameter[0].data.value.raw.length = 14u;
+	    (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage, "raw data value", 25 );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.raw.length = 14u;
 #endif
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
 #ifdef IOT_STACK_ONLY
 	expect_string( __wrap_os_system_run, args->cmd,
 		"script_path --param=" );
@@ -3236,6 +3428,7 @@ static void test_iot_action_process_command_parameter_raw( void **state )
 	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3305,7 +3498,7 @@ static void test_iot_action_process_command_parameter_string( void **state )
 	strncpy( lib.action_ptr[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->parameter[0].data.type = IOT_TYPE_STRING;
 	lib.action_ptr[0]->parameter[0].type = IOT_PARAMETER_IN;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -3313,44 +3506,45 @@ static void test_iot_action_process_command_parameter_string( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter = lib.request_queue_wait[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
 	for ( i = 0u; i < 1u; ++i )
-		lib.request_queue_wait[0]->parameter[i].name = lib.request_queue_wait[0]->parameter[i]._name;
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
-	memset( lib.request_queue_wait[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
 	for ( i = 0u; i < 1u; ++i )
 	{
 		will_return( __wrap_os_malloc, 1 );
-		lib.request_queue_wait[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	}
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_STRING;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_STRING;
 	path_len = 25u;
 #ifdef IOT_STACK_ONLY
 	test_data = test_malloc( path_len + 1u );
 	assert_non_null( test_data );
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage = test_data;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage = test_data;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage = os_malloc( path_len + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage = os_malloc( path_len + 1u );
 #endif
-	assert_non_null( lib.request_queue_wait[0]->parameter[0].data.heap_storage );
-	lib.request_queue_wait[0]->parameter[0].data.value.string =
-	    (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage;
-	strncpy( (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage,
+	assert_non_null( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.string =
+	    (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage;
+	strncpy( (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage,
 	         "string\r\n \\ \"value\"",
 	         25 );
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
 	expect_string( __wrap_os_system_run, args->cmd,
 		"script_path --param=\"string \\\\ \\\"value\\\"\"" );
 	will_return( __wrap_os_system_run, 0u );
@@ -3371,6 +3565,7 @@ static void test_iot_action_process_command_parameter_string( void **state )
 	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 1000u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3443,7 +3638,7 @@ static void test_iot_action_process_command_parameter_string_max_len( void **sta
 	strncpy( lib.action_ptr[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->parameter[0].data.type = IOT_TYPE_STRING;
 	lib.action_ptr[0]->parameter[0].type = IOT_PARAMETER_IN;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -3451,49 +3646,50 @@ static void test_iot_action_process_command_parameter_string_max_len( void **sta
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter = lib.request_queue_wait[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
 	for ( i = 0u; i < 1u; ++i )
-		lib.request_queue_wait[0]->parameter[i].name = lib.request_queue_wait[0]->parameter[i]._name;
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
-	memset( lib.request_queue_wait[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
 	for ( i = 0u; i < 1u; ++i )
 	{
 		will_return( __wrap_os_malloc, 1 );
-		lib.request_queue_wait[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	}
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_STRING;
-	path_len = PATH_MAX - strlen( lib.action_ptr[0]->command ) - strlen( lib.request_queue_wait[0]->parameter[0].name ) - 6u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_STRING;
+	path_len = PATH_MAX - strlen( lib.action_ptr[0]->command ) - strlen( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name ) - 6u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->parameter[0].data.value.string = path_storage;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.string = path_storage;
 	for ( i = 0u; i < path_len; ++i )
 		path_storage[i] = '\\';
 	path_storage[path_len - 1u] = '\0';
 #else
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage = test_malloc( path_len + 1u );
-	assert_non_null( lib.request_queue_wait[0]->parameter[0].data.heap_storage );
-	lib.request_queue_wait[0]->parameter[0].data.value.string =
-	    (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage = test_malloc( path_len + 1u );
+	assert_non_null( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.string =
+	    (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage;
 	for ( i = 0u; i < path_len; ++i )
-		((char *)(lib.request_queue_wait[0]->parameter[0].data.heap_storage)) [i] = '\\';
-	((char *)(lib.request_queue_wait[0]->parameter[0].data.heap_storage))[path_len - 1u] = '\0';
+		((char *)(lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage)) [i] = '\\';
+	((char *)(lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage))[path_len - 1u] = '\0';
 #endif
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
 	snprintf( expected_path, PATH_MAX, "%s --%s=\"%s%s\"",
 		lib.action_ptr[0]->command,
-		lib.request_queue_wait[0]->parameter[0].name,
-		lib.request_queue_wait[0]->parameter[0].data.value.string,
-		lib.request_queue_wait[0]->parameter[0].data.value.string );
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name,
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.string,
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.string );
 	expected_path[ PATH_MAX ] = '\0';
 	expect_string( __wrap_os_system_run, args->cmd, expected_path );
 	will_return( __wrap_os_system_run, 0u );
@@ -3514,6 +3710,7 @@ static void test_iot_action_process_command_parameter_string_max_len( void **sta
 	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 1000u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3587,7 +3784,7 @@ static void test_iot_action_process_command_parameter_uint( void **state )
 	strncpy( lib.action_ptr[0]->parameter[3].name, "uint64", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->parameter[3].data.type = IOT_TYPE_UINT64;
 	lib.action_ptr[0]->parameter[3].type = IOT_PARAMETER_IN;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -3595,42 +3792,43 @@ static void test_iot_action_process_command_parameter_uint( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter = lib.request_queue_wait[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
 	for ( i = 0u; i < 4u; ++i )
-		lib.request_queue_wait[0]->parameter[i].name = lib.request_queue_wait[0]->parameter[i]._name;
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
-	memset( lib.request_queue_wait[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) * 4u );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) * 4u );
 	for ( i = 0u; i < 4u; ++i )
 	{
 		will_return( __wrap_os_malloc, 1 );
-		lib.request_queue_wait[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
-	}
-#endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 4u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "uint8", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_UINT8;
-	lib.request_queue_wait[0]->parameter[0].data.value.uint8 = 8u;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
-	strncpy( lib.request_queue_wait[0]->parameter[1].name, "uint16", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[1].data.type = IOT_TYPE_UINT16;
-	lib.request_queue_wait[0]->parameter[1].data.value.uint16 = 16u;
-	lib.request_queue_wait[0]->parameter[1].data.has_value = IOT_TRUE;
-	strncpy( lib.request_queue_wait[0]->parameter[2].name, "uint32", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[2].data.type = IOT_TYPE_UINT32;
-	lib.request_queue_wait[0]->parameter[2].data.value.uint32 = 32u;
-	lib.request_queue_wait[0]->parameter[2].data.has_value = IOT_TRUE;
-	strncpy( lib.request_queue_wait[0]->parameter[3].name, "uint64", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[3].data.type = IOT_TYPE_UINT64;
-	lib.request_queue_wait[0]->parameter[3].data.value.uint64 = 64u;
-	lib.request_queue_wait[0]->parameter[3].data.has_value = IOT_TRUE;
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	}
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 4u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "uint8", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_UINT8;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.uint8 = 8u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].name, "uint16", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].data.type = IOT_TYPE_UINT16;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].data.value.uint16 = 16u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[1].data.has_value = IOT_TRUE;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[2].name, "uint32", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[2].data.type = IOT_TYPE_UINT32;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[2].data.value.uint32 = 32u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[2].data.has_value = IOT_TRUE;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[3].name, "uint64", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[3].data.type = IOT_TYPE_UINT64;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[3].data.value.uint64 = 64u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[3].data.has_value = IOT_TRUE;
 	expect_string( __wrap_os_system_run, args->cmd,
 		"script_path --uint8=8 --uint16=16 --uint32=32 --uint64=64" );
 	will_return( __wrap_os_system_run, 0u );
@@ -3651,6 +3849,7 @@ static void test_iot_action_process_command_parameter_uint( void **state )
 	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3695,7 +3894,7 @@ static void test_iot_action_process_command_script_return_fail( void **state )
 	lib.action_ptr[0]->lib = &lib;
 	lib.action_ptr[0]->callback = NULL;
 	strncpy( lib.action_ptr[0]->command, "script_path", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -3703,14 +3902,15 @@ static void test_iot_action_process_command_script_return_fail( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
 	expect_string( __wrap_os_system_run, args->cmd, "script_path" );
 	will_return( __wrap_os_system_run, 1u ); /* script exit status */
 	will_return( __wrap_os_system_run, "this is stdout" );
@@ -3730,6 +3930,7 @@ static void test_iot_action_process_command_script_return_fail( void **state )
 	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3745,7 +3946,8 @@ static void test_iot_action_process_command_script_return_fail( void **state )
 #endif
 }
 
-static void test_iot_action_process_command_system_run_fail( void **state )
+#ifdef IOT_SPAWN_SUPPORT
+static void test_iot_action_process_command_spawn( void **state )
 {
 	size_t i;
 	iot_t lib;
@@ -3754,44 +3956,86 @@ static void test_iot_action_process_command_system_run_fail( void **state )
 	memset( &lib, 0, sizeof( iot_t ) );
 	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
 	{
+		size_t j;
 #ifdef IOT_STACK_ONLY
 		lib.action[i].name = lib.action[i]._name;
 		lib.action[i].command = lib.action[i]._command;
+		lib.action[i].parameter = lib.action[i]._parameter;
+		for ( j = 0u; j < IOT_PARAMETER_MAX; ++j )
+			lib.action[i].parameter[j].name =
+				lib.action[i].parameter[j]._name;
 #else
 		will_return( __wrap_os_malloc, 1 );
 		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 		will_return( __wrap_os_malloc, 1 );
 		lib.action[i].command = os_malloc( PATH_MAX + 1u );
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].parameter = os_malloc(
+			sizeof( struct iot_action_parameter ) * IOT_PARAMETER_MAX );
+		memset( lib.action[i].parameter, 0,
+			sizeof( struct iot_action_parameter ) * IOT_PARAMETER_MAX );
+		for ( j = 0u; j < IOT_PARAMETER_MAX; ++j )
+		{
+			will_return( __wrap_os_malloc, 1 );
+			lib.action[i].parameter[j].name =
+				os_malloc( IOT_NAME_MAX_LEN + 1u );
+		}
 #endif
 		lib.action_ptr[i] = &lib.action[i];
 	}
 	lib.action_count = 1u;
+	lib.command_launch = IOT_COMMAND_LAUNCH_SPAWN;
 	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->lib = &lib;
 	lib.action_ptr[0]->callback = NULL;
 	strncpy( lib.action_ptr[0]->command, "script_path", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.action_ptr[0]->parameter_count = 1u;
+	strncpy( lib.action_ptr[0]->parameter[0].name, "bool", IOT_NAME_MAX_LEN );
+	lib.action_ptr[0]->parameter[0].data.type = IOT_TYPE_BOOL;
+	lib.action_ptr[0]->parameter[0].type = IOT_PARAMETER_IN;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
-	{
-		lib.request_queue[0].lib = &lib;
 		lib.request_queue_free[i] = &lib.request_queue[i];
-	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	will_return( __wrap_os_malloc, 1 );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) );
+	will_return( __wrap_os_malloc, 1 );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "bool", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_BOOL;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.boolean = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
+	/* each parameter is passed as a single argument */
+	expect_string( __wrap_iot_spawn_run, args->argv[i], "script_path" );
+	expect_string( __wrap_iot_spawn_run, args->argv[i], "--bool=1" );
+	will_return( __wrap_iot_spawn_run, 0 );
+	will_return( __wrap_iot_spawn_run, "this is stdout" );
+	will_return( __wrap_iot_spawn_run, IOT_STATUS_SUCCESS );
+#ifndef IOT_STACK_ONLY
+	/* add parameter: retval */
+	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
+	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
+	/* add parameter: stdout */
+	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
+	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
+	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	expect_string( __wrap_os_system_run, args->cmd, "script_path" );
-	will_return( __wrap_os_system_run, -1 );
-	will_return( __wrap_os_system_run, "\0" );
-	will_return( __wrap_os_system_run, "\0" );
-	will_return( __wrap_os_system_run, IOT_STATUS_NOT_EXECUTABLE );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3801,13 +4045,17 @@ static void test_iot_action_process_command_system_run_fail( void **state )
 #ifndef IOT_STACK_ONLY
 	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
 	{
+		size_t j;
 		os_free( lib.action[i].command );
+		for ( j = 0u; j < IOT_PARAMETER_MAX; ++j )
+			os_free( lib.action[i].parameter[j].name );
+		os_free( lib.action[i].parameter );
 		os_free( lib.action[i].name );
 	}
 #endif
 }
 
-static void test_iot_action_process_command_valid( void **state )
+static void test_iot_action_process_command_spawn_shell_syntax( void **state )
 {
 	size_t i;
 	iot_t lib;
@@ -3828,11 +4076,12 @@ static void test_iot_action_process_command_valid( void **state )
 		lib.action_ptr[i] = &lib.action[i];
 	}
 	lib.action_count = 1u;
+	lib.command_launch = IOT_COMMAND_LAUNCH_SPAWN;
 	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->lib = &lib;
 	lib.action_ptr[0]->callback = NULL;
-	strncpy( lib.action_ptr[0]->command, "script_path", PATH_MAX );
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	strncpy( lib.action_ptr[0]->command, "script_path | tee log", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -3840,33 +4089,28 @@ static void test_iot_action_process_command_valid( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	expect_string( __wrap_os_system_run, args->cmd, "script_path" );
-	will_return( __wrap_os_system_run, 0u );
-	will_return( __wrap_os_system_run, "this is stdout" );
-	will_return( __wrap_os_system_run, "this is stderr" );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	/* shell syntax needs the shell */
+	expect_string( __wrap_os_system_run, args->cmd, "script_path | tee log" );
+	will_return( __wrap_os_system_run, 0u ); /* script exit status */
+	will_return( __wrap_os_system_run, NULL ); /* stdout */
+	will_return( __wrap_os_system_run, NULL ); /* stderr */
 	will_return( __wrap_os_system_run, IOT_STATUS_SUCCESS );
 #ifndef IOT_STACK_ONLY
 	/* add parameter: retval */
 	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
 	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
-	/* add parameter: stdout */
-	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
-	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
-	will_return( __wrap_os_realloc, 1 ); /* copy string value */
-	/* add parameter: stderr */
-	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
-	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
-	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3882,7 +4126,7 @@ static void test_iot_action_process_command_valid( void **state )
 #endif
 }
 
-static void test_iot_action_process_exclusive( void **state )
+static void test_iot_action_process_command_spawn_stream( void **state )
 {
 	size_t i;
 	iot_t lib;
@@ -3891,37 +4135,92 @@ static void test_iot_action_process_exclusive( void **state )
 	memset( &lib, 0, sizeof( iot_t ) );
 	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
 	{
+		size_t j;
 #ifdef IOT_STACK_ONLY
 		lib.action[i].name = lib.action[i]._name;
+		lib.action[i].command = lib.action[i]._command;
+		lib.action[i].parameter = lib.action[i]._parameter;
+		for ( j = 0u; j < IOT_PARAMETER_MAX; ++j )
+			lib.action[i].parameter[j].name =
+				lib.action[i].parameter[j]._name;
 #else
 		will_return( __wrap_os_malloc, 1 );
 		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].command = os_malloc( PATH_MAX + 1u );
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].parameter = os_malloc(
+			sizeof( struct iot_action_parameter ) * IOT_PARAMETER_MAX );
+		memset( lib.action[i].parameter, 0,
+			sizeof( struct iot_action_parameter ) * IOT_PARAMETER_MAX );
+		for ( j = 0u; j < IOT_PARAMETER_MAX; ++j )
+		{
+			will_return( __wrap_os_malloc, 1 );
+			lib.action[i].parameter[j].name =
+				os_malloc( IOT_NAME_MAX_LEN + 1u );
+		}
 #endif
 		lib.action_ptr[i] = &lib.action[i];
 	}
 	lib.action_count = 1u;
+	lib.command_launch = IOT_COMMAND_LAUNCH_SPAWN;
 	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->lib = &lib;
-	lib.action_ptr[0]->callback = &test_callback_func;
-	lib.action_ptr[0]->flags = IOT_ACTION_EXCLUSIVE_APP;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.action_ptr[0]->callback = NULL;
+	strncpy( lib.action_ptr[0]->command, "script_path", IOT_NAME_MAX_LEN );
+	lib.action_ptr[0]->flags = IOT_ACTION_STREAM_OUTPUT;
+	lib.action_ptr[0]->parameter_count = 1u;
+	strncpy( lib.action_ptr[0]->parameter[0].name, "bool", IOT_NAME_MAX_LEN );
+	lib.action_ptr[0]->parameter[0].data.type = IOT_TYPE_BOOL;
+	lib.action_ptr[0]->parameter[0].type = IOT_PARAMETER_IN;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
-	{
-		lib.request_queue[0].lib = &lib;
 		lib.request_queue_free[i] = &lib.request_queue[i];
-	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	will_return( __wrap_os_malloc, 1 );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc( sizeof( struct iot_action_parameter ) );
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0, sizeof( struct iot_action_parameter ) );
+	will_return( __wrap_os_malloc, 1 );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "bool", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_BOOL;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.boolean = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
+	/* each parameter is passed as a single argument */
+	expect_string( __wrap_iot_spawn_run, args->argv[i], "script_path" );
+	expect_string( __wrap_iot_spawn_run, args->argv[i], "--bool=1" );
+	will_return( __wrap_iot_spawn_run, 0 );
+	will_return( __wrap_iot_spawn_run, "line 1\nline 2\n" );
+	will_return( __wrap_iot_spawn_run, IOT_STATUS_SUCCESS );
+	/* output is published as it is read, then a summary */
+	expect_string( __wrap_iot_event_publish, message,
+		"action name: line 1\nline 2" );
+	expect_string( __wrap_iot_event_publish, message,
+		"action name: exited with 0, 14 bytes of output (0 on stderr)" );
+#ifndef IOT_STACK_ONLY
+	/* add parameter: retval */
+	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
+	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
+	/* add parameter: stdout */
+	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
+	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
+	will_return( __wrap_os_realloc, 1 ); /* copy string value */
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
-	will_return( test_callback_func, IOT_STATUS_SUCCESS );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3930,11 +4229,18 @@ static void test_iot_action_process_exclusive( void **state )
 	/* clean up */
 #ifndef IOT_STACK_ONLY
 	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+		size_t j;
+		os_free( lib.action[i].command );
+		for ( j = 0u; j < IOT_PARAMETER_MAX; ++j )
+			os_free( lib.action[i].parameter[j].name );
+		os_free( lib.action[i].parameter );
 		os_free( lib.action[i].name );
+	}
 #endif
 }
 
-static void test_iot_action_process_lib_to_quit( void **state )
+static void test_iot_action_process_command_spawn_stream_shell( void **state )
 {
 	size_t i;
 	iot_t lib;
@@ -3945,18 +4251,22 @@ static void test_iot_action_process_lib_to_quit( void **state )
 	{
 #ifdef IOT_STACK_ONLY
 		lib.action[i].name = lib.action[i]._name;
+		lib.action[i].command = lib.action[i]._command;
 #else
 		will_return( __wrap_os_malloc, 1 );
 		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].command = os_malloc( PATH_MAX + 1u );
 #endif
 		lib.action_ptr[i] = &lib.action[i];
 	}
-	lib.to_quit = IOT_TRUE;
 	lib.action_count = 1u;
 	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->lib = &lib;
-	lib.action_ptr[0]->callback = &test_callback_func;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.action_ptr[0]->callback = NULL;
+	lib.action_ptr[0]->flags = IOT_ACTION_STREAM_OUTPUT;
+	strncpy( lib.action_ptr[0]->command, "script_path | tee log", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -3964,15 +4274,31 @@ static void test_iot_action_process_lib_to_quit( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	/* output of commands run by the shell can be streamed too */
+	expect_string( __wrap_iot_spawn_run, args->argv[i], "/bin/sh" );
+	expect_string( __wrap_iot_spawn_run, args->argv[i], "-c" );
+	expect_string( __wrap_iot_spawn_run, args->argv[i], "script_path | tee log" );
+	will_return( __wrap_iot_spawn_run, 0 );
+	will_return( __wrap_iot_spawn_run, "" );
+	will_return( __wrap_iot_spawn_run, IOT_STATUS_SUCCESS );
+	expect_string( __wrap_iot_event_publish, message,
+		"action name: exited with 0, 0 bytes of output (0 on stderr)" );
+#ifndef IOT_STACK_ONLY
+	/* add parameter: retval */
+	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
+	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -3981,11 +4307,15 @@ static void test_iot_action_process_lib_to_quit( void **state )
 	/* clean up */
 #ifndef IOT_STACK_ONLY
 	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+		os_free( lib.action[i].command );
 		os_free( lib.action[i].name );
+	}
 #endif
 }
+#endif /* ifdef IOT_SPAWN_SUPPORT */
 
-static void test_iot_action_process_no_handler( void **state )
+static void test_iot_action_process_command_system_run_fail( void **state )
 {
 	size_t i;
 	iot_t lib;
@@ -3996,9 +4326,12 @@ static void test_iot_action_process_no_handler( void **state )
 	{
 #ifdef IOT_STACK_ONLY
 		lib.action[i].name = lib.action[i]._name;
+		lib.action[i].command = lib.action[i]._command;
 #else
 		will_return( __wrap_os_malloc, 1 );
 		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].command = os_malloc( PATH_MAX + 1u );
 #endif
 		lib.action_ptr[i] = &lib.action[i];
 	}
@@ -4006,28 +4339,31 @@ static void test_iot_action_process_no_handler( void **state )
 	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->lib = &lib;
 	lib.action_ptr[0]->callback = NULL;
-	lib.action_ptr[0]->command = NULL;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	strncpy( lib.action_ptr[0]->command, "script_path", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
-		lib.request_queue[i].lib = &lib;
+		lib.request_queue[0].lib = &lib;
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	expect_string( __wrap_os_system_run, args->cmd, "script_path" );
+	will_return( __wrap_os_system_run, -1 );
+	will_return( __wrap_os_system_run, "\0" );
+	will_return( __wrap_os_system_run, "\0" );
+	will_return( __wrap_os_system_run, IOT_STATUS_NOT_EXECUTABLE );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
-#ifndef IOT_STACK_ONLY
-	/* space to store error message */
-	will_return( __wrap_os_realloc, 1 );
-#endif
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -4036,21 +4372,15 @@ static void test_iot_action_process_no_handler( void **state )
 	/* clean up */
 #ifndef IOT_STACK_ONLY
 	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+		os_free( lib.action[i].command );
 		os_free( lib.action[i].name );
+	}
 #endif
 }
 
-static void test_iot_action_process_null_lib( void **state )
-{
-	iot_status_t result;
-
-	result = iot_action_process( NULL, 0u );
-	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
-}
-
-static void test_iot_action_process_options( void **state )
+static void test_iot_action_process_command_valid( void **state )
 {
-	void *data;
 	size_t i;
 	iot_t lib;
 	iot_status_t result;
@@ -4060,20 +4390,409 @@ static void test_iot_action_process_options( void **state )
 	{
 #ifdef IOT_STACK_ONLY
 		lib.action[i].name = lib.action[i]._name;
+		lib.action[i].command = lib.action[i]._command;
 #else
 		will_return( __wrap_os_malloc, 1 );
 		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].command = os_malloc( PATH_MAX + 1u );
 #endif
 		lib.action_ptr[i] = &lib.action[i];
 	}
-	lib.action_count = IOT_ACTION_STACK_MAX - 1u;
-	for ( i = 0u; i < lib.action_count; ++i )
-	{
-		snprintf( lib.action_ptr[i]->name, IOT_NAME_MAX_LEN, "action name %ld", i );
-		lib.action_ptr[i]->lib = &lib;
+	lib.action_count = 1u;
+	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.action_ptr[0]->lib = &lib;
+	lib.action_ptr[0]->callback = NULL;
+	strncpy( lib.action_ptr[0]->command, "script_path", PATH_MAX );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
+	lib.request_queue[0].lib = &lib;
+	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
+	{
+		lib.request_queue[i].lib = &lib;
+		lib.request_queue_free[i] = &lib.request_queue[i];
+	}
+	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
+	lib.request_queue_free_count = 1u;
+#ifdef IOT_STACK_ONLY
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+#else
+	will_return( __wrap_os_malloc, 1 );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	expect_string( __wrap_os_system_run, args->cmd, "script_path" );
+	will_return( __wrap_os_system_run, 0u );
+	will_return( __wrap_os_system_run, "this is stdout" );
+	will_return( __wrap_os_system_run, "this is stderr" );
+	will_return( __wrap_os_system_run, IOT_STATUS_SUCCESS );
+#ifndef IOT_STACK_ONLY
+	/* add parameter: retval */
+	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
+	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
+	/* add parameter: stdout */
+	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
+	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
+	will_return( __wrap_os_realloc, 1 ); /* copy string value */
+	/* add parameter: stderr */
+	will_return( __wrap_os_realloc, 1 ); /* increase parameter array */
+	will_return( __wrap_os_malloc, 1 ); /* space to hold name */
+	will_return( __wrap_os_realloc, 1 ); /* copy string value */
+#endif
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
+	result = iot_action_process( &lib, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_wait_count, 0u );
+	assert_int_equal( lib.request_queue_free_count, 0u );
+
+	/* clean up */
+#ifndef IOT_STACK_ONLY
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+		os_free( lib.action[i].command );
+		os_free( lib.action[i].name );
+	}
+#endif
+}
+
+static void test_iot_action_process_concurrency_limit( void **state )
+{
+	size_t i;
+	iot_t lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+#ifdef IOT_STACK_ONLY
+		lib.action[i].name = lib.action[i]._name;
+#else
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+		memset( lib.action[i].name, 0, IOT_NAME_MAX_LEN + 1u );
+		lib.action_ptr[i] = &lib.action[i];
+	}
+	lib.action_count = 2u;
+	/* action already running its maximum number of requests */
+	strncpy( lib.action_ptr[0]->name, "update", IOT_NAME_MAX_LEN );
+	lib.action_ptr[0]->lib = &lib;
+	lib.action_ptr[0]->callback = &test_callback_func;
+	lib.action_ptr[0]->concurrency_max = 1u;
+	lib.action_ptr[0]->running = 1u;
+	strncpy( lib.action_ptr[1]->name, "ping", IOT_NAME_MAX_LEN );
+	lib.action_ptr[1]->lib = &lib;
+	lib.action_ptr[1]->callback = &test_callback_func;
+	for ( i = 2u; i < IOT_ACTION_QUEUE_MAX; ++i )
+		lib.request_queue_free[i] = &lib.request_queue[i];
+	for ( i = 0u; i < 2u; ++i )
+	{
+		lib.request_queue[i].lib = &lib;
+#ifdef IOT_STACK_ONLY
+		lib.request_queue[i].name = lib.request_queue[i]._name;
+#else
+		will_return( __wrap_os_malloc, 1 );
+		lib.request_queue[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+		memset( lib.request_queue[i].name, 0, IOT_NAME_MAX_LEN + 1u );
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[i] = &lib.request_queue[i];
+	}
+	strncpy( lib.request_queue[0].name, "update", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue[1].name, "ping", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 2u;
+	lib.request_queue_wait_count = 2u;
+	lib.request_queue_free_count = 2u;
+
+	will_return( test_callback_func, IOT_STATUS_SUCCESS );
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
+	result = iot_action_process( &lib, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* newer request processed, older one stays at the front */
+	assert_int_equal( lib.request_queue_wait_count, 1u );
+	assert_int_equal( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count, 1u );
+	assert_int_equal( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].head, 1u );
+	assert_ptr_equal( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[1], &lib.request_queue[0] );
+	assert_int_equal( lib.action_ptr[0]->running, 1u );
+	assert_int_equal( lib.action_ptr[1]->running, 0u );
+	assert_int_equal( lib.request_queue_free_count, 1u );
+
+	/* clean up */
+#ifndef IOT_STACK_ONLY
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+		os_free( lib.action[i].name );
+	os_free( lib.request_queue[0].name );
+#endif
+}
+
+static void test_iot_action_process_deferred( void **state )
+{
+	size_t i;
+	iot_t lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+#ifdef IOT_STACK_ONLY
+		lib.action[i].name = lib.action[i]._name;
+#else
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+		memset( lib.action[i].name, 0, IOT_NAME_MAX_LEN + 1u );
+		lib.action_ptr[i] = &lib.action[i];
+	}
+	lib.action_count = 1u;
+	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.action_ptr[0]->lib = &lib;
+	lib.action_ptr[0]->callback = &test_callback_func;
+	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
+		lib.request_queue_free[i] = &lib.request_queue[i];
+	lib.request_queue[0].lib = &lib;
+#ifdef IOT_STACK_ONLY
+	lib.request_queue[0].name = lib.request_queue[0]._name;
+#else
+	will_return( __wrap_os_malloc, 1 );
+	lib.request_queue[0].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+	memset( lib.request_queue[0].name, 0, IOT_NAME_MAX_LEN + 1u );
+	strncpy( lib.request_queue[0].name, "action name", IOT_NAME_MAX_LEN );
+	lib.request_queue[0].time_limit = 1000u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
+	lib.request_queue_wait_count = 1u;
+	lib.request_queue_free_count = 1u;
+
+	/* callback keeps the request, nothing is reported yet */
+	will_return( test_callback_func, IOT_STATUS_INVOKED );
+	test_action_index( &lib );
+	result = iot_action_process( &lib, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_wait_count, 0u );
+	assert_int_equal( lib.request_queue_free_count, 1u );
+	assert_int_equal( lib.request_deferred_count, 1u );
+	assert_int_equal( lib.request_queue[0].deferred, IOT_ACTION_REQUEST_DEFERRED );
+	assert_int_equal( lib.request_queue[0].deadline, 1234567u + 1000u );
+	assert_int_equal( lib.action_ptr[0]->running, 1u );
+
+	/* completed later */
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	result = iot_action_request_complete( &lib.request_queue[0],
+		IOT_STATUS_SUCCESS, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_free_count, 0u );
+	assert_int_equal( lib.request_deferred_count, 0u );
+	assert_int_equal( lib.action_ptr[0]->running, 0u );
+	assert_null( lib.request_queue[0].lib );
+
+	/* clean up */
+#ifndef IOT_STACK_ONLY
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+		os_free( lib.action[i].name );
+#endif
+}
+
+static void test_iot_action_process_exclusive( void **state )
+{
+	size_t i;
+	iot_t lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+#ifdef IOT_STACK_ONLY
+		lib.action[i].name = lib.action[i]._name;
+#else
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+		lib.action_ptr[i] = &lib.action[i];
+	}
+	lib.action_count = 1u;
+	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.action_ptr[0]->lib = &lib;
+	lib.action_ptr[0]->callback = &test_callback_func;
+	lib.action_ptr[0]->flags = IOT_ACTION_EXCLUSIVE_APP;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
+	lib.request_queue[0].lib = &lib;
+	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
+	{
+		lib.request_queue[0].lib = &lib;
+		lib.request_queue_free[i] = &lib.request_queue[i];
+	}
+	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
+	lib.request_queue_free_count = 1u;
+#ifdef IOT_STACK_ONLY
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+#else
+	will_return( __wrap_os_malloc, 1 );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	will_return( test_callback_func, IOT_STATUS_SUCCESS );
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
+	result = iot_action_process( &lib, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_wait_count, 0u );
+	assert_int_equal( lib.request_queue_free_count, 0u );
+
+	/* clean up */
+#ifndef IOT_STACK_ONLY
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+		os_free( lib.action[i].name );
+#endif
+}
+
+static void test_iot_action_process_lib_to_quit( void **state )
+{
+	size_t i;
+	iot_t lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+#ifdef IOT_STACK_ONLY
+		lib.action[i].name = lib.action[i]._name;
+#else
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+		lib.action_ptr[i] = &lib.action[i];
+	}
+	lib.to_quit = IOT_TRUE;
+	lib.action_count = 1u;
+	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.action_ptr[0]->lib = &lib;
+	lib.action_ptr[0]->callback = &test_callback_func;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
+	lib.request_queue[0].lib = &lib;
+	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
+	{
+		lib.request_queue[i].lib = &lib;
+		lib.request_queue_free[i] = &lib.request_queue[i];
+	}
+	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
+	lib.request_queue_free_count = 1u;
+#ifdef IOT_STACK_ONLY
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+#else
+	will_return( __wrap_os_malloc, 1 );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
+	result = iot_action_process( &lib, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_wait_count, 0u );
+	assert_int_equal( lib.request_queue_free_count, 0u );
+
+	/* clean up */
+#ifndef IOT_STACK_ONLY
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+		os_free( lib.action[i].name );
+#endif
+}
+
+static void test_iot_action_process_no_handler( void **state )
+{
+	size_t i;
+	iot_t lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+#ifdef IOT_STACK_ONLY
+		lib.action[i].name = lib.action[i]._name;
+#else
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+		lib.action_ptr[i] = &lib.action[i];
+	}
+	lib.action_count = 1u;
+	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.action_ptr[0]->lib = &lib;
+	lib.action_ptr[0]->callback = NULL;
+	lib.action_ptr[0]->command = NULL;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
+	lib.request_queue[0].lib = &lib;
+	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
+	{
+		lib.request_queue[i].lib = &lib;
+		lib.request_queue_free[i] = &lib.request_queue[i];
+	}
+	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
+	lib.request_queue_free_count = 1u;
+#ifdef IOT_STACK_ONLY
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+#else
+	will_return( __wrap_os_malloc, 1 );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+#ifndef IOT_STACK_ONLY
+	/* space to store error message */
+	will_return( __wrap_os_realloc, 1 );
+#endif
+	test_action_index( &lib );
+	result = iot_action_process( &lib, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_wait_count, 0u );
+	assert_int_equal( lib.request_queue_free_count, 0u );
+
+	/* clean up */
+#ifndef IOT_STACK_ONLY
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+		os_free( lib.action[i].name );
+#endif
+}
+
+static void test_iot_action_process_null_lib( void **state )
+{
+	iot_status_t result;
+
+	result = iot_action_process( NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+static void test_iot_action_process_options( void **state )
+{
+	void *data;
+	size_t i;
+	iot_t lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+#ifdef IOT_STACK_ONLY
+		lib.action[i].name = lib.action[i]._name;
+#else
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+		lib.action_ptr[i] = &lib.action[i];
+	}
+	lib.action_count = IOT_ACTION_STACK_MAX - 1u;
+	for ( i = 0u; i < lib.action_count; ++i )
+	{
+		snprintf( lib.action_ptr[i]->name, IOT_NAME_MAX_LEN, "action name %ld", i );
+		lib.action_ptr[i]->lib = &lib;
 		lib.action_ptr[i]->callback = &test_callback_func;
 	}
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -4081,35 +4800,37 @@ static void test_iot_action_process_options( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->option =
-		lib.request_queue_wait[0]->_option;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->option =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_option;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->option =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->option =
 		os_malloc( sizeof( struct iot_option ) );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->option[0].name =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->option[0].name =
 		os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name 1", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->option_count = 1u;
-	strncpy( lib.request_queue_wait[0]->option[0].name, "attr", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name 1", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->option_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->option[0].name, "attr", IOT_NAME_MAX_LEN );
 	data = test_malloc( ( IOT_NAME_MAX_LEN + 1 ) * sizeof( char ) );
 	assert_non_null( data );
-	lib.request_queue_wait[0]->option[0].data.heap_storage = data;
-	lib.request_queue_wait[0]->option[0].data.value.string =
-	    (char *)lib.request_queue_wait[0]->option[0].data.heap_storage;
-	strncpy( (char *)lib.request_queue_wait[0]->option[0].data.heap_storage,
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->option[0].data.heap_storage = data;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->option[0].data.value.string =
+	    (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->option[0].data.heap_storage;
+	strncpy( (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->option[0].data.heap_storage,
 	         "some text",
 	         IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->option[0].data.type = IOT_TYPE_STRING;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->option[0].data.type = IOT_TYPE_STRING;
 	will_return( test_callback_func, IOT_STATUS_SUCCESS );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -4168,7 +4889,7 @@ static void test_iot_action_process_parameters_bad_type( void **state )
 	lib.action_ptr[1]->parameter[0].type = IOT_PARAMETER_IN_REQUIRED;
 	lib.action_ptr[1]->parameter[0].data.type = IOT_TYPE_INT32;
 	lib.action_ptr[1]->parameter[0].data.has_value = IOT_FALSE;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -4176,40 +4897,42 @@ static void test_iot_action_process_parameters_bad_type( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter =
-		lib.request_queue_wait[0]->_parameter;
-	lib.request_queue_wait[0]->parameter[0].name =
-		lib.request_queue_wait[0]->parameter[0]._name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter =
 		os_malloc( sizeof( struct iot_action_parameter ) );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter[0].name =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name =
 		os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name 1", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name 1", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
 	data = test_malloc( ( IOT_NAME_MAX_LEN + 1 ) * sizeof( char ) );
 	assert_non_null( data );
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage = data;
-	lib.request_queue_wait[0]->parameter[0].data.value.string =
-	    (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage;
-	strncpy( (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage,
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage = data;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.string =
+	    (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage;
+	strncpy( (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage,
 	         "some text", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_STRING;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_STRING;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
 #ifndef IOT_STACK_ONLY
 	/* space to store error message */
 	will_return( __wrap_os_realloc, 1 );
 #endif
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -4274,7 +4997,7 @@ static void test_iot_action_process_parameters_missing_required( void **state )
 	lib.action_ptr[1]->parameter[0].type = IOT_PARAMETER_IN_REQUIRED;
 	lib.action_ptr[1]->parameter[0].data.type = IOT_TYPE_STRING;
 	lib.action_ptr[1]->parameter[0].data.has_value = IOT_FALSE;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -4282,14 +5005,15 @@ static void test_iot_action_process_parameters_missing_required( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name,
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name,
 		lib.action_ptr[1]->name, IOT_NAME_MAX_LEN );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
 
@@ -4297,6 +5021,7 @@ static void test_iot_action_process_parameters_missing_required( void **state )
 	/* space to store error message */
 	will_return( __wrap_os_realloc, 1 );
 #endif
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -4342,7 +5067,7 @@ static void test_iot_action_process_parameters_undeclared( void **state )
 		lib.action_ptr[i]->lib = &lib;
 		lib.action_ptr[i]->callback = &test_callback_func;
 	}
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -4350,42 +5075,44 @@ static void test_iot_action_process_parameters_undeclared( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter =
-		lib.request_queue_wait[0]->_parameter;
-	lib.request_queue_wait[0]->parameter[0].name =
-		lib.request_queue_wait[0]->parameter[0]._name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc(
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc(
 		sizeof( struct iot_action_parameter ) * 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter[0].name =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name =
 		os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name 1", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name 1", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage = value_str;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage = value_str;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage =
 	    os_malloc( ( IOT_NAME_MAX_LEN + 1 ) * sizeof( char ) );
-	lib.request_queue_wait[0]->parameter[0].data.value.string =
-	    (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.string =
+	    (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage;
 #endif
-	strncpy( (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage,
+	strncpy( (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage,
 	         "some text",
 	         IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_STRING;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_STRING;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
 	will_return( test_callback_func, IOT_STATUS_SUCCESS );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -4426,7 +5153,7 @@ static void test_iot_action_process_parameters_unknown_out( void **state )
 		lib.action_ptr[i]->lib = &lib;
 		lib.action_ptr[i]->callback = &test_callback_func;
 	}
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -4434,45 +5161,47 @@ static void test_iot_action_process_parameters_unknown_out( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter =
-		lib.request_queue_wait[0]->_parameter;
-	lib.request_queue_wait[0]->parameter[0].name =
-		lib.request_queue_wait[0]->parameter[0]._name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc(
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc(
 		sizeof( struct iot_action_parameter ) * 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter[0].name =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name =
 		os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name 1", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name 1", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->parameter[0].data.value.string = str;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.string = str;
 	strncpy( str, "some text", IOT_NAME_MAX_LEN );
 #else
 	will_return( __wrap_os_malloc, 1u );
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage =
 		os_malloc( ( IOT_NAME_MAX_LEN + 1 ) * sizeof( char ) );
-	lib.request_queue_wait[0]->parameter[0].data.value.string =
-		(char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage;
-	strncpy( (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage,
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.string =
+		(char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage;
+	strncpy( (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage,
 		"some text", IOT_NAME_MAX_LEN );
 #endif
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_STRING;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
-	lib.request_queue_wait[0]->parameter[0].type = IOT_PARAMETER_OUT;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_STRING;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].type = IOT_PARAMETER_OUT;
 #ifndef IOT_STACK_ONLY
 	will_return( __wrap_os_realloc, 1 ); /* space for error message */
 #endif /* ifndef IOT_STACK_ONLY */
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS ); /* successfully send update to cloud */
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	/* error message will be free'd after sending to the cloud */
@@ -4525,7 +5254,7 @@ static void test_iot_action_process_parameters_required_out( void **state )
 		lib.action_ptr[i]->parameter[0].type = IOT_PARAMETER_OUT | IOT_PARAMETER_OUT_REQUIRED;
 		++lib.action_ptr[i]->parameter_count;
 	}
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -4533,35 +5262,37 @@ static void test_iot_action_process_parameters_required_out( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter =
-		lib.request_queue_wait[0]->_parameter;
-	lib.request_queue_wait[0]->parameter[0].name =
-		lib.request_queue_wait[0]->parameter[0]._name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc(
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc(
 		sizeof( struct iot_action_parameter ) * 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter[0].name =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name =
 		os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name 1", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "param 1", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_INT8;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_FALSE;
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage = NULL;
-	lib.request_queue_wait[0]->parameter[0].type = IOT_PARAMETER_IN;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name 1", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "param 1", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_INT8;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_FALSE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage = NULL;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].type = IOT_PARAMETER_IN;
 	will_return( test_callback_func, IOT_STATUS_SUCCESS );
 #ifndef IOT_STACK_ONLY
 	will_return( __wrap_os_realloc, 1 ); /* space for error message */
 #endif
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS ); /* successfully send update to cloud */
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	/* error message will be free'd after sending to the cloud */
@@ -4621,7 +5352,7 @@ static void test_iot_action_process_parameters_valid( void **state )
 	lib.action_ptr[1]->parameter[0].type = IOT_PARAMETER_IN_REQUIRED;
 	lib.action_ptr[1]->parameter[0].data.type = IOT_TYPE_STRING;
 	lib.action_ptr[1]->parameter[0].data.has_value = IOT_FALSE;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	lib.request_queue[0].lib = &lib;
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 	{
@@ -4629,43 +5360,45 @@ static void test_iot_action_process_parameters_valid( void **state )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	}
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->name = lib.request_queue_wait[0]->_name;
-	lib.request_queue_wait[0]->parameter =
-		lib.request_queue_wait[0]->_parameter;
-	lib.request_queue_wait[0]->parameter[0].name =
-		lib.request_queue_wait[0]->parameter[0]._name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_name;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->_parameter;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name =
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0]._name;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter = os_malloc(
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter = os_malloc(
 		sizeof( struct iot_action_parameter ) * 1u );
-	memset( lib.request_queue_wait[0]->parameter, 0,
+	memset( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter, 0,
 		sizeof( struct iot_action_parameter ) * 1u );
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter[0].name =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name =
 		os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
-	strncpy( lib.request_queue_wait[0]->name, "action name 1", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter_count = 1u;
-	strncpy( lib.request_queue_wait[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name 1", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter_count = 1u;
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].name, "param", IOT_NAME_MAX_LEN );
 #ifdef IOT_STACK_ONLY
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage = value_str;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage = value_str;
 #else
 	will_return( __wrap_os_malloc, 1 );
-	lib.request_queue_wait[0]->parameter[0].data.heap_storage =
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage =
 		os_malloc( ( IOT_NAME_MAX_LEN + 1 ) * sizeof( char ) );
 #endif
-	lib.request_queue_wait[0]->parameter[0].data.value.string =
-	    (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage;
-	strncpy( (char *)lib.request_queue_wait[0]->parameter[0].data.heap_storage,
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.value.string =
+	    (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage;
+	strncpy( (char *)lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.heap_storage,
 	         "some text", IOT_NAME_MAX_LEN );
-	lib.request_queue_wait[0]->parameter[0].data.type = IOT_TYPE_STRING;
-	lib.request_queue_wait[0]->parameter[0].data.has_value = IOT_TRUE;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.type = IOT_TYPE_STRING;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->parameter[0].data.has_value = IOT_TRUE;
 	will_return( test_callback_func, IOT_STATUS_SUCCESS );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -4682,6 +5415,78 @@ static void test_iot_action_process_parameters_valid( void **state )
 #endif
 }
 
+static void test_iot_action_process_priority_lanes( void **state )
+{
+	size_t i;
+	iot_t lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+	{
+#ifdef IOT_STACK_ONLY
+		lib.action[i].name = lib.action[i]._name;
+#else
+		will_return( __wrap_os_malloc, 1 );
+		lib.action[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+		memset( lib.action[i].name, 0, IOT_NAME_MAX_LEN + 1u );
+		lib.action_ptr[i] = &lib.action[i];
+	}
+	lib.action_count = 2u;
+	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
+	lib.action_ptr[0]->lib = &lib;
+	lib.action_ptr[0]->callback = &test_callback_func;
+	strncpy( lib.action_ptr[1]->name, "ping", IOT_NAME_MAX_LEN );
+	lib.action_ptr[1]->lib = &lib;
+	lib.action_ptr[1]->flags = IOT_ACTION_PRIORITY_HIGH;
+	lib.action_ptr[1]->callback = &test_callback_func;
+	for ( i = 2u; i < IOT_ACTION_QUEUE_MAX; ++i )
+		lib.request_queue_free[i] = &lib.request_queue[i];
+	for ( i = 0u; i < 2u; ++i )
+	{
+		lib.request_queue[i].lib = &lib;
+#ifdef IOT_STACK_ONLY
+		lib.request_queue[i].name = lib.request_queue[i]._name;
+#else
+		will_return( __wrap_os_malloc, 1 );
+		lib.request_queue[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+#endif
+		memset( lib.request_queue[i].name, 0, IOT_NAME_MAX_LEN + 1u );
+	}
+	/* normal request queued first, high priority request queued after */
+	strncpy( lib.request_queue[0].name, "action name", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue[1].name, "ping", IOT_NAME_MAX_LEN );
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_HIGH].head = IOT_ACTION_QUEUE_MAX - 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_HIGH].request[IOT_ACTION_QUEUE_MAX - 1u] = &lib.request_queue[1];
+	lib.request_queue_wait[IOT_ACTION_LANE_HIGH].count = 1u;
+	lib.request_queue_wait_count = 2u;
+	lib.request_queue_free_count = 2u;
+
+	will_return( test_callback_func, IOT_STATUS_SUCCESS );
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
+	result = iot_action_process( &lib, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* high priority request processed, wrapping around the ring */
+	assert_int_equal( lib.request_queue_wait_count, 1u );
+	assert_int_equal( lib.request_queue_wait[IOT_ACTION_LANE_HIGH].count, 0u );
+	assert_int_equal( lib.request_queue_wait[IOT_ACTION_LANE_HIGH].head, 0u );
+	assert_int_equal( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count, 1u );
+	assert_ptr_equal( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0], &lib.request_queue[0] );
+	assert_int_equal( lib.request_queue_free_count, 1u );
+
+	/* clean up */
+#ifndef IOT_STACK_ONLY
+	for ( i = 0u; i < IOT_ACTION_STACK_MAX; ++i )
+		os_free( lib.action[i].name );
+	os_free( lib.request_queue[0].name );
+#endif
+}
+
 static void test_iot_action_process_valid( void **state )
 {
 	size_t i;
@@ -4704,10 +5509,11 @@ static void test_iot_action_process_valid( void **state )
 	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->lib = &lib;
 	lib.action_ptr[0]->callback = &test_callback_func;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	for ( i = 1u; i < IOT_ACTION_QUEUE_MAX; ++i )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	lib.request_queue_wait_count = 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
 	lib.request_queue_free_count = 1u;
 	for ( i = 0u; i < lib.request_queue_wait_count; ++i )
 	{
@@ -4719,11 +5525,12 @@ static void test_iot_action_process_valid( void **state )
 		lib.request_queue[i].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
 #endif
 		memset( lib.request_queue[i].name, 0, IOT_NAME_MAX_LEN + 1u );
-		lib.request_queue_wait[i] = &lib.request_queue[i];
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[i] = &lib.request_queue[i];
 	}
-	strncpy( lib.request_queue_wait[0]->name, "action name", IOT_NAME_MAX_LEN );
+	strncpy( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0]->name, "action name", IOT_NAME_MAX_LEN );
 	will_return( test_callback_func, IOT_STATUS_SUCCESS );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -4757,11 +5564,12 @@ static void test_iot_action_process_wait_queue_empty( void **state )
 	strncpy( lib.action_ptr[0]->name, "action name", IOT_NAME_MAX_LEN );
 	lib.action_ptr[0]->lib = &lib;
 	lib.action_ptr[0]->callback = &test_callback_func;
-	lib.request_queue_wait[0] = &lib.request_queue[0];
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0] = &lib.request_queue[0];
 	for ( i = 0u; i < IOT_ACTION_QUEUE_MAX; ++i )
 		lib.request_queue_free[i] = &lib.request_queue[i];
 	lib.request_queue_wait_count = 0u;
 	lib.request_queue_free_count = 0u;
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_NOT_FOUND );
 	assert_int_equal( lib.request_queue_wait_count, 0u );
@@ -4798,6 +5606,7 @@ static void test_iot_action_process_wait_queue_full( void **state )
 
 	/* number of jobs that are waiting */
 	lib.request_queue_wait_count = IOT_ACTION_QUEUE_MAX;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = IOT_ACTION_QUEUE_MAX;
 	/* number of spaces that are free */
 	lib.request_queue_free_count = IOT_ACTION_QUEUE_MAX;
 	for ( i = 0u; i < IOT_ACTION_QUEUE_MAX; ++i )
@@ -4811,12 +5620,13 @@ static void test_iot_action_process_wait_queue_full( void **state )
 #endif
 		snprintf( lib.request_queue[i].name, IOT_NAME_MAX_LEN,
 			"action %u", (unsigned)(i+1u) );
-		lib.request_queue_wait[i] = &lib.request_queue[i];
+		lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[i] = &lib.request_queue[i];
 	}
 
 	will_return( test_callback_func, IOT_STATUS_SUCCESS );
 	/* perform action */
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	test_action_index( &lib );
 	result = iot_action_process( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 
@@ -5062,18 +5872,19 @@ static void test_iot_action_request_allocate_long_name_and_source( void **state
 	char action_name[IOT_NAME_MAX_LEN + 2u];
 	char source_name[IOT_ID_MAX_LEN + 2u];
 	memset( &iot_lib, 0, sizeof( struct iot ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
 	iot_lib.request_queue_free[0u] = &req;
 	test_generate_random_string( action_name, IOT_NAME_MAX_LEN + 2u );
 	test_generate_random_string( source_name, IOT_ID_MAX_LEN + 2u);
 #ifndef IOT_STACK_ONLY
-	will_return( __wrap_os_malloc, 1 ); /* for names */
+	will_return( __wrap_os_malloc, 1 ); /* for arena */
 #endif
 	result = iot_action_request_allocate( &iot_lib, action_name, source_name );
 	assert_non_null( result );
 	assert_ptr_equal( result, &req );
 
 #ifndef IOT_STACK_ONLY
-	os_free( result->name );
+	os_free( result->arena );
 #endif
 }
 
@@ -5095,9 +5906,10 @@ static void test_iot_action_request_allocate_no_memory( void **state )
 	struct iot_action_request *result;
 	struct iot_action_request req;
 	memset( &iot_lib, 0, sizeof( struct iot ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
 	iot_lib.request_queue_free[0u] = &req;
 #ifndef IOT_STACK_ONLY
-	will_return( __wrap_os_malloc, 0 ); /* for names */
+	will_return( __wrap_os_malloc, 0 ); /* for arena */
 #endif
 	result = iot_action_request_allocate( &iot_lib, "my_action", "fake_source" );
 
@@ -5115,9 +5927,10 @@ static void test_iot_action_request_allocate_valid( void **state )
 	struct iot_action_request *result;
 	struct iot_action_request req;
 	memset( &iot_lib, 0, sizeof( struct iot ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
 	iot_lib.request_queue_free[0u] = &req;
 #ifndef IOT_STACK_ONLY
-	will_return( __wrap_os_malloc, 1 ); /* for names */
+	will_return( __wrap_os_malloc, 1 ); /* for arena */
 #endif
 	result = iot_action_request_allocate( &iot_lib, "my_action", NULL );
 
@@ -5125,10 +5938,126 @@ static void test_iot_action_request_allocate_valid( void **state )
 	assert_ptr_equal( result, &req );
 #ifndef IOT_STACK_ONLY
 	assert_null( result->source );
-	os_free( result->name );
+	os_free( result->arena );
+#endif
+}
+
+static void test_iot_action_request_allocate_inbound( void **state )
+{
+	struct iot iot_lib;
+	struct iot_action_request *result;
+	struct iot_action_request req;
+	char *value;
+	size_t i;
+	memset( &iot_lib, 0, sizeof( struct iot ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
+	iot_lib.request_queue_free[0u] = &req;
+
+	/* only the arena is allocated, the first time the slot is used */
+	for ( i = 0u; i < 2u; ++i )
+	{
+#ifndef IOT_STACK_ONLY
+		if ( i == 0u )
+			will_return( __wrap_os_malloc, 1 ); /* for arena */
+#endif
+		result = iot_action_request_allocate( &iot_lib,
+			"my_action", "tr50" );
+		assert_ptr_equal( result, &req );
+		assert_int_equal( iot_action_request_option_set( result,
+			"id", IOT_TYPE_STRING, "1234" ), IOT_STATUS_SUCCESS );
+		assert_int_equal( iot_action_request_option_set( result,
+			"acked", IOT_TYPE_BOOL, IOT_TRUE ), IOT_STATUS_SUCCESS );
+		assert_int_equal( iot_action_request_parameter_set( result,
+			"count", IOT_TYPE_INT64, 5 ), IOT_STATUS_SUCCESS );
+		assert_int_equal( iot_action_request_parameter_set( result,
+			"path", IOT_TYPE_STRING, "/tmp" ), IOT_STATUS_SUCCESS );
+
+		/* string decoded into the arena is not copied */
+		value = iot_action_request_arena_alloc( result, 6u );
+		assert_non_null( value );
+		strncpy( value, "hello", 6u );
+		assert_int_equal( iot_action_request_parameter_set( result,
+			"text", IOT_TYPE_STRING, value ), IOT_STATUS_SUCCESS );
+		assert_int_equal( result->parameter_count, 3u );
+		assert_ptr_equal( result->parameter[2].data.value.string, value );
+		assert_string_equal( result->option[0].data.value.string, "1234" );
+		assert_string_equal( result->parameter[1].data.value.string, "/tmp" );
+		assert_null( result->parameter[1].data.heap_storage );
+
+		assert_int_equal( iot_action_request_free( result ),
+			IOT_STATUS_SUCCESS );
+		assert_int_equal( iot_lib.request_queue_free_count, 0u );
+	}
+
+#ifndef IOT_STACK_ONLY
+	assert_non_null( req.arena );
+	os_free( req.arena );
 #endif
 }
 
+static void test_iot_action_request_complete_expired( void **state )
+{
+	struct iot lib;
+	struct iot_action_request req;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
+	req.lib = &lib;
+	req.deferred = IOT_ACTION_REQUEST_DEFERRED_EXPIRED;
+	lib.request_deferred_count = 1u;
+	lib.request_queue_free_count = 1u;
+
+	/* time out already reported, so the request is only freed */
+	result = iot_action_request_complete( &req, IOT_STATUS_SUCCESS, NULL );
+	assert_int_equal( result, IOT_STATUS_TIMED_OUT );
+	assert_int_equal( lib.request_deferred_count, 0u );
+	assert_int_equal( lib.request_queue_free_count, 0u );
+	assert_ptr_equal( lib.request_queue_free[0], &req );
+}
+
+static void test_iot_action_request_complete_expiring( void **state )
+{
+	struct iot lib;
+	struct iot_action_request req;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
+	req.lib = &lib;
+	req.deferred = IOT_ACTION_REQUEST_DEFERRED_EXPIRING;
+	lib.request_deferred_count = 1u;
+	lib.request_queue_free_count = 1u;
+
+	/* time out being reported, which then frees the request */
+	result = iot_action_request_complete( &req, IOT_STATUS_SUCCESS, NULL );
+	assert_int_equal( result, IOT_STATUS_TIMED_OUT );
+	assert_int_equal( req.deferred, IOT_ACTION_REQUEST_DEFERRED_EXPIRING_DONE );
+	assert_int_equal( lib.request_deferred_count, 1u );
+	assert_int_equal( lib.request_queue_free_count, 1u );
+}
+
+static void test_iot_action_request_complete_not_deferred( void **state )
+{
+	struct iot lib;
+	struct iot_action_request req;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
+	req.lib = &lib;
+	result = iot_action_request_complete( &req, IOT_STATUS_SUCCESS, NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	assert_ptr_equal( req.lib, &lib );
+}
+
+static void test_iot_action_request_complete_null_request( void **state )
+{
+	iot_status_t result;
+	result = iot_action_request_complete( NULL, IOT_STATUS_SUCCESS, NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
 static void test_iot_action_request_option_get_not_found( void **state )
 {
 	struct iot_action_request req;
@@ -6021,6 +6950,26 @@ static void test_iot_action_request_execute_full_queue( void **state )
 	assert_int_equal( result, IOT_STATUS_FULL );
 }
 
+static void test_iot_action_request_execute_grow_pool( void **state )
+{
+	struct iot lib;
+	struct iot_action_request req;
+	iot_status_t result;
+	memset( &lib, 0, sizeof( struct iot ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
+#ifdef IOT_THREAD_SUPPORT
+	/* all running workers are busy */
+	lib.main_thread = (os_thread_t)1;
+	lib.worker_count = 1u;
+	lib.worker_max = 2u;
+	will_return( __wrap_iot_loop_worker_start, IOT_STATUS_SUCCESS );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	req.lib = &lib;
+	result = iot_action_request_execute( &req, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_wait_count, 1u );
+}
+
 static void test_iot_action_request_execute_null_request( void **state )
 {
 	iot_status_t result;
@@ -6028,6 +6977,101 @@ static void test_iot_action_request_execute_null_request( void **state )
 	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
 }
 
+static void test_iot_action_request_execute_priority( void **state )
+{
+	struct iot lib;
+	struct iot_action action;
+	struct iot_action_request req;
+	char name[] = "ping";
+	iot_status_t result;
+	memset( &lib, 0, sizeof( struct iot ) );
+	memset( &action, 0, sizeof( struct iot_action ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
+	action.name = name;
+	action.flags = IOT_ACTION_PRIORITY_HIGH;
+	lib.action_ptr[0] = &action;
+	lib.action_count = 1u;
+	req.lib = &lib;
+	req.name = name;
+	test_action_index( &lib );
+	result = iot_action_request_execute( &req, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_wait_count, 1u );
+	assert_int_equal( lib.request_queue_wait[IOT_ACTION_LANE_HIGH].count, 1u );
+	assert_int_equal( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count, 0u );
+	assert_ptr_equal( lib.request_queue_wait[IOT_ACTION_LANE_HIGH].request[0], &req );
+
+	action.flags = IOT_ACTION_PRIORITY_LOW;
+	result = iot_action_request_execute( &req, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_wait_count, 2u );
+	assert_int_equal( lib.request_queue_wait[IOT_ACTION_LANE_LOW].count, 1u );
+}
+
+static void test_iot_action_request_execute_ring_wrap( void **state )
+{
+	struct iot lib;
+	struct iot_action_request req;
+	struct iot_action_request req_last;
+	iot_status_t result;
+	memset( &lib, 0, sizeof( struct iot ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
+
+	/* last slot of the ring is in use */
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].head = IOT_ACTION_QUEUE_MAX - 1u;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[IOT_ACTION_QUEUE_MAX - 1u] = &req_last;
+	lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count = 1u;
+	lib.request_queue_wait_count = 1u;
+
+	req.lib = &lib;
+	result = iot_action_request_execute( &req, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_wait_count, 2u );
+	assert_int_equal( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].count, 2u );
+	assert_ptr_equal( lib.request_queue_wait[IOT_ACTION_LANE_NORMAL].request[0], &req );
+}
+
+static void test_iot_action_request_execute_shed( void **state )
+{
+	struct iot lib;
+	struct iot_action action;
+	struct iot_action_request req;
+	char name[] = "ping";
+	iot_status_t result;
+	memset( &lib, 0, sizeof( struct iot ) );
+	memset( &action, 0, sizeof( struct iot_action ) );
+	memset( &req, 0, sizeof( struct iot_action_request ) );
+	action.name = name;
+	lib.action_ptr[0] = &action;
+	lib.action_count = 1u;
+	req.lib = &lib;
+	req.name = name;
+	test_action_index( &lib );
+
+	/* queue is backed up */
+	lib.request_queue_wait_count = 2u;
+#ifdef IOT_THREAD_SUPPORT
+	lib.worker_shed_depth = 2u;
+	will_return( __wrap_iot_error, "request queue is full" );
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	result = iot_action_request_execute( &req, 0u );
+#ifdef IOT_THREAD_SUPPORT
+	assert_int_equal( result, IOT_STATUS_FULL );
+	assert_int_equal( lib.request_queue_wait_count, 2u );
+#else
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+
+	/* high priority requests are still accepted */
+	action.flags = IOT_ACTION_PRIORITY_HIGH;
+	lib.request_queue_wait_count = 2u;
+	result = iot_action_request_execute( &req, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue_wait_count, 3u );
+	assert_int_equal( lib.request_queue_wait[IOT_ACTION_LANE_HIGH].count, 1u );
+}
+
 static void test_iot_action_request_execute_success( void **state )
 {
 	struct iot lib;
@@ -6040,6 +7084,66 @@ static void test_iot_action_request_execute_success( void **state )
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 }
 
+static void test_iot_action_request_expire_none( void **state )
+{
+	struct iot lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	result = iot_action_request_expire( &lib );
+	assert_int_equal( result, IOT_STATUS_NOT_FOUND );
+}
+
+static void test_iot_action_request_expire_null_lib( void **state )
+{
+	iot_status_t result;
+	result = iot_action_request_expire( NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+static void test_iot_action_request_expire_timed_out( void **state )
+{
+	struct iot lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	lib.request_queue[0].lib = &lib;
+	lib.request_queue[0].deferred = IOT_ACTION_REQUEST_DEFERRED;
+	lib.request_queue[0].deadline = 1000u;
+	lib.request_queue[1].lib = &lib;
+	lib.request_queue[1].deferred = IOT_ACTION_REQUEST_DEFERRED;
+	lib.request_queue[1].deadline = 2000000u;
+	lib.request_queue[2].lib = &lib;
+	lib.request_queue[2].deferred = IOT_ACTION_REQUEST_DEFERRED;
+	lib.request_deferred_count = 3u;
+#ifdef IOT_STACK_ONLY
+	lib.request_queue[0].name = lib.request_queue[0]._name;
+#else
+	will_return( __wrap_os_malloc, 1 );
+	lib.request_queue[0].name = os_malloc( IOT_NAME_MAX_LEN + 1u );
+	will_return( __wrap_os_realloc, 1 ); /* error message */
+#endif
+	strncpy( lib.request_queue[0].name, "action name", IOT_NAME_MAX_LEN );
+
+	/* only the request past its deadline times out */
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	result = iot_action_request_expire( &lib );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.request_queue[0].deferred, IOT_ACTION_REQUEST_DEFERRED_EXPIRED );
+	assert_int_equal( lib.request_queue[0].result, IOT_STATUS_TIMED_OUT );
+	assert_int_equal( lib.request_queue[1].deferred, IOT_ACTION_REQUEST_DEFERRED );
+	assert_int_equal( lib.request_queue[2].deferred, IOT_ACTION_REQUEST_DEFERRED );
+	assert_int_equal( lib.request_deferred_count, 3u );
+
+	/* owner completes it afterwards, which only frees it */
+	lib.request_queue_free_count = 1u;
+	result = iot_action_request_complete( &lib.request_queue[0],
+		IOT_STATUS_SUCCESS, NULL );
+	assert_int_equal( result, IOT_STATUS_TIMED_OUT );
+	assert_int_equal( lib.request_deferred_count, 2u );
+	assert_int_equal( lib.request_queue_free_count, 0u );
+}
+
 static void test_iot_action_request_free_bad_req( void **state )
 {
 	iot_status_t result;
@@ -6737,9 +7841,12 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_action_allocate_existing ),
 		cmocka_unit_test( test_iot_action_allocate_first ),
 		cmocka_unit_test( test_iot_action_allocate_full ),
+		cmocka_unit_test( test_iot_action_allocate_grow ),
 		cmocka_unit_test( test_iot_action_allocate_stack_full ),
 		cmocka_unit_test( test_iot_action_allocate_null_lib ),
 		cmocka_unit_test( test_iot_action_allocate_no_memory ),
+		cmocka_unit_test( test_iot_action_concurrency_set_bad_action ),
+		cmocka_unit_test( test_iot_action_concurrency_set_valid ),
 		cmocka_unit_test( test_iot_action_deregister_deregistered ),
 		cmocka_unit_test( test_iot_action_deregister_null_action ),
 		cmocka_unit_test( test_iot_action_deregister_null_lib ),
@@ -6753,6 +7860,9 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_action_free_null_handle ),
 		cmocka_unit_test( test_iot_action_free_parameters ),
 		cmocka_unit_test( test_iot_action_free_transmit_fail ),
+		cmocka_unit_test( test_iot_action_lock_group_add_bad_parameter ),
+		cmocka_unit_test( test_iot_action_lock_group_add_existing ),
+		cmocka_unit_test( test_iot_action_lock_group_add_full ),
 		cmocka_unit_test( test_iot_action_option_get_not_there ),
 		cmocka_unit_test( test_iot_action_option_get_null_action ),
 		cmocka_unit_test( test_iot_action_option_get_null_name ),
@@ -6815,8 +7925,16 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_action_process_command_parameter_string_max_len ),
 		cmocka_unit_test( test_iot_action_process_command_parameter_uint ),
 		cmocka_unit_test( test_iot_action_process_command_script_return_fail ),
+#ifdef IOT_SPAWN_SUPPORT
+		cmocka_unit_test( test_iot_action_process_command_spawn ),
+		cmocka_unit_test( test_iot_action_process_command_spawn_shell_syntax ),
+		cmocka_unit_test( test_iot_action_process_command_spawn_stream ),
+		cmocka_unit_test( test_iot_action_process_command_spawn_stream_shell ),
+#endif /* ifdef IOT_SPAWN_SUPPORT */
 		cmocka_unit_test( test_iot_action_process_command_system_run_fail ),
 		cmocka_unit_test( test_iot_action_process_command_valid ),
+		cmocka_unit_test( test_iot_action_process_concurrency_limit ),
+		cmocka_unit_test( test_iot_action_process_deferred ),
 		cmocka_unit_test( test_iot_action_process_exclusive ),
 		cmocka_unit_test( test_iot_action_process_lib_to_quit ),
 		cmocka_unit_test( test_iot_action_process_no_handler ),
@@ -6828,6 +7946,7 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_action_process_parameters_unknown_out ),
 		cmocka_unit_test( test_iot_action_process_parameters_required_out ),
 		cmocka_unit_test( test_iot_action_process_parameters_valid ),
+		cmocka_unit_test( test_iot_action_process_priority_lanes ),
 		cmocka_unit_test( test_iot_action_process_valid ),
 		cmocka_unit_test( test_iot_action_process_wait_queue_empty ),
 		cmocka_unit_test( test_iot_action_process_wait_queue_full ),
@@ -6842,10 +7961,15 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_action_register_command_valid_long_path ),
 		cmocka_unit_test( test_iot_action_request_allocate_bad_lib ),
 		cmocka_unit_test( test_iot_action_request_allocate_bad_name ),
+		cmocka_unit_test( test_iot_action_request_allocate_inbound ),
 		cmocka_unit_test( test_iot_action_request_allocate_long_name_and_source ),
 		cmocka_unit_test( test_iot_action_request_allocate_no_free_slots ),
 		cmocka_unit_test( test_iot_action_request_allocate_no_memory ),
 		cmocka_unit_test( test_iot_action_request_allocate_valid ),
+		cmocka_unit_test( test_iot_action_request_complete_expired ),
+		cmocka_unit_test( test_iot_action_request_complete_expiring ),
+		cmocka_unit_test( test_iot_action_request_complete_not_deferred ),
+		cmocka_unit_test( test_iot_action_request_complete_null_request ),
 		cmocka_unit_test( test_iot_action_request_option_get_not_found ),
 		cmocka_unit_test( test_iot_action_request_option_get_null_name ),
 		cmocka_unit_test( test_iot_action_request_option_get_null_req ),
@@ -6878,8 +8002,15 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_action_request_copy_size_string ),
 		cmocka_unit_test( test_iot_action_request_execute_invalid_request ),
 		cmocka_unit_test( test_iot_action_request_execute_full_queue ),
+		cmocka_unit_test( test_iot_action_request_execute_grow_pool ),
 		cmocka_unit_test( test_iot_action_request_execute_null_request ),
+		cmocka_unit_test( test_iot_action_request_execute_priority ),
+		cmocka_unit_test( test_iot_action_request_execute_ring_wrap ),
+		cmocka_unit_test( test_iot_action_request_execute_shed ),
 		cmocka_unit_test( test_iot_action_request_execute_success ),
+		cmocka_unit_test( test_iot_action_request_expire_none ),
+		cmocka_unit_test( test_iot_action_request_expire_null_lib ),
+		cmocka_unit_test( test_iot_action_request_expire_timed_out ),
 		cmocka_unit_test( test_iot_action_request_free_bad_req ),
 		cmocka_unit_test( test_iot_action_request_free_valid_req ),
 		cmocka_unit_test( test_iot_action_request_parameter_iterator_bad_iter ),
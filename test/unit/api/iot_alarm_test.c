@@ -75,6 +75,9 @@ static void test_iot_alarm_register_full( void **state )
 	}
 	snprintf( name, IOT_NAME_MAX_LEN, "alarm %03d.5", IOT_ALARM_MAX / 2u );
 	lib.alarm_count = IOT_ALARM_MAX;
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 0 ); /* grow list of alarms */
+#endif
 	result = iot_alarm_register( &lib, name );
 	assert_null( result );
 	assert_int_equal( lib.alarm_count, IOT_ALARM_MAX );
@@ -82,6 +85,54 @@ static void test_iot_alarm_register_full( void **state )
 	test_free( stack_alarm );
 }
 
+static void test_iot_alarm_register_grow( void **state )
+{
+#ifndef IOT_STACK_ONLY
+	size_t i;
+	iot_t lib;
+	char name[IOT_NAME_MAX_LEN + 1u];
+	char *t_names;
+	iot_alarm_t *result;
+	iot_alarm_t *stack_alarm;
+
+	t_names = test_malloc( sizeof( char ) * ( IOT_NAME_MAX_LEN + 1u ) * IOT_ALARM_MAX );
+	assert_non_null( t_names );
+
+	stack_alarm = (iot_alarm_t *)test_calloc( IOT_ALARM_MAX - IOT_ALARM_STACK_MAX,
+	                                                  sizeof( iot_alarm_t ) );
+	assert_non_null( stack_alarm );
+	memset( &lib, 0, sizeof( iot_t ) );
+	for ( i = 0u; i < IOT_ALARM_MAX; i++ )
+	{
+		if ( i < IOT_ALARM_STACK_MAX )
+			lib.alarm_ptr[i] = &lib.alarm[i];
+		else
+			lib.alarm_ptr[i] = &stack_alarm[i - IOT_ALARM_STACK_MAX];
+		lib.alarm_ptr[i]->name = &t_names[( IOT_NAME_MAX_LEN + 1u ) * i];
+		snprintf( lib.alarm_ptr[i]->name, IOT_NAME_MAX_LEN, "alarm %03lu", i );
+	}
+	snprintf( name, IOT_NAME_MAX_LEN, "alarm %03d.5", IOT_ALARM_MAX / 2u );
+	lib.alarm_count = IOT_ALARM_MAX;
+	will_return( __wrap_os_malloc, 1 ); /* grow list of alarms */
+	will_return( __wrap_os_malloc, 1 ); /* for new object */
+	will_return( __wrap_os_malloc, 1 ); /* for name */
+	result = iot_alarm_register( &lib, name );
+	assert_non_null( result );
+	assert_int_equal( lib.alarm_count, IOT_ALARM_MAX + 1u );
+	assert_non_null( lib.alarm_heap );
+	assert_int_equal( lib.alarm_max, IOT_ALARM_MAX * 2u );
+	assert_ptr_equal( lib.alarm_heap[0], lib.alarm_ptr[0] );
+	assert_ptr_equal( lib.alarm_heap[IOT_ALARM_MAX / 2u + 1u], result );
+
+	/* clean up */
+	os_free( result->name );
+	os_free( result );
+	os_free( lib.alarm_heap );
+	test_free( t_names );
+	test_free( stack_alarm );
+#endif /* ifndef IOT_STACK_ONLY */
+}
+
 static void test_iot_alarm_register_stack_full( void **state )
 {
 	size_t i;
@@ -430,6 +481,7 @@ int main( int argc, char *argv[] )
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test( test_iot_alarm_register_empty ),
 		cmocka_unit_test( test_iot_alarm_register_full ),
+		cmocka_unit_test( test_iot_alarm_register_grow ),
 		cmocka_unit_test( test_iot_alarm_register_stack_full ),
 		cmocka_unit_test( test_iot_alarm_register_null_lib ),
 		cmocka_unit_test( test_iot_alarm_register_null_name ),
@@ -1262,14 +1262,6 @@ static void test_iot_connect_configuration_fail_to_parse( void **state )
 	/* iot-connect.cfg */
 	will_return( __wrap_os_file_exists, OS_TRUE );
 	will_return( __wrap_os_file_open, 1u );
-#ifdef IOT_STACK_ONLY
-	will_return( __wrap_os_file_read, 1u );
-#else
-	will_return_count( __wrap_os_realloc, 1u, 3u );
-	will_return_count( __wrap_os_file_read, 1u, 2u );
-#endif
-	will_return( __wrap_os_file_read, 0u );
-	will_return( __wrap_os_file_eof, OS_TRUE );
 	/* fail to parse configuration file */
 	will_return( __wrap_iot_json_decode_initialize, 0 );
 
@@ -1308,6 +1300,7 @@ static void test_iot_connect_configuration_fail_to_read( void **state )
 	/* app_id.cfg */
 	will_return( __wrap_os_file_exists, OS_TRUE );
 	will_return( __wrap_os_file_open, 1u );
+	will_return( __wrap_iot_json_decode_initialize, 0x1 );
 #ifdef IOT_STACK_ONLY
 	will_return( __wrap_os_file_read, 1u );
 #else
@@ -1357,10 +1350,12 @@ static void test_iot_connect_configuration_no_memory( void **state )
 #ifdef IOT_STACK_ONLY
 	will_return( __wrap_os_file_exists, OS_TRUE );
 	will_return( __wrap_os_file_open, 1u );
+	will_return( __wrap_iot_json_decode_initialize, 0x1 );
 	will_return_count( __wrap_os_file_read, 1u, 2u );
 #else
 	will_return( __wrap_os_file_exists, OS_TRUE );
 	will_return( __wrap_os_file_open, 1u );
+	will_return( __wrap_iot_json_decode_initialize, 0x1 );
 	will_return( __wrap_os_realloc, 0u );
 #endif
 
@@ -2149,6 +2144,7 @@ static void test_iot_loop_iteration_single_thread( void **state )
 	memset( &lib, 0, sizeof( struct iot ) );
 	lib.flags = IOT_FLAG_SINGLE_THREAD;
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	will_return( __wrap_iot_action_request_expire, IOT_STATUS_NOT_FOUND );
 	will_return( __wrap_iot_action_process, IOT_STATUS_SUCCESS );
 	result = iot_loop_iteration( &lib, 0u );
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
@@ -2161,6 +2157,7 @@ static void test_iot_loop_iteration_threads( void **state )
 
 	memset( &lib, 0, sizeof( struct iot ) );
 	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	will_return( __wrap_iot_action_request_expire, IOT_STATUS_NOT_FOUND );
 #ifndef IOT_THREAD_SUPPORT
 	will_return( __wrap_iot_action_process, IOT_STATUS_SUCCESS );
 #endif /* ifndef IOT_THREAD_SUPPORT */
@@ -2234,7 +2231,8 @@ static void test_iot_loop_start_threads_success( void **state )
 	assert_int_equal( lib.to_quit, IOT_FALSE );
 	assert_true( lib.main_thread != 0 );
 	for ( i = 0u; i < IOT_WORKER_THREADS; ++i )
-		assert_true( lib.worker_thread[i] != 0 );
+		assert_true( lib.worker[i].thread != 0 );
+	assert_int_equal( lib.worker_count, IOT_WORKER_THREADS );
 #else
 	assert_int_equal( result, IOT_STATUS_NOT_SUPPORTED );
 #endif /* ifdef IOT_THREAD_SUPPORT */
@@ -2306,7 +2304,7 @@ static void test_iot_loop_stop_threads_force( void **state )
 #ifdef IOT_THREAD_SUPPORT
 	lib.main_thread = (os_thread_t)1234;
 	for ( i = 0u; i < IOT_WORKER_THREADS; ++i )
-		lib.worker_thread[i] = (os_thread_t)(i + 1u);
+		lib.worker[i].thread = (os_thread_t)(i + 1u);
 #endif /* ifdef IOT_THREAD_SUPPORT */
 	result = iot_loop_stop( &lib, IOT_TRUE );
 
@@ -2330,7 +2328,7 @@ static void test_iot_loop_stop_threads_no_force( void **state )
 #ifdef IOT_THREAD_SUPPORT
 	lib.main_thread = (os_thread_t)1234;
 	for ( i = 0u; i < IOT_WORKER_THREADS; ++i )
-		lib.worker_thread[i] = (os_thread_t)(i + 1u);
+		lib.worker[i].thread = (os_thread_t)(i + 1u);
 #endif /* ifdef IOT_THREAD_SUPPORT */
 
 	result = iot_loop_stop( &lib, IOT_FALSE );
@@ -2342,6 +2340,83 @@ static void test_iot_loop_stop_threads_no_force( void **state )
 	assert_int_equal( lib.to_quit, IOT_TRUE );
 }
 
+/* iot_loop_worker_start */
+static void test_iot_loop_worker_start_full( void **state )
+{
+	struct iot lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	lib.to_quit = IOT_TRUE;
+#ifdef IOT_THREAD_SUPPORT
+	lib.worker_max = 1u;
+	lib.worker_count = 1u;
+	lib.worker[0].thread = (os_thread_t)1;
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	result = iot_loop_worker_start( &lib );
+#ifdef IOT_THREAD_SUPPORT
+	assert_int_equal( result, IOT_STATUS_FULL );
+	assert_int_equal( lib.worker_count, 1u );
+#else
+	assert_int_equal( result, IOT_STATUS_NOT_SUPPORTED );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+}
+
+static void test_iot_loop_worker_start_null_lib( void **state )
+{
+	iot_status_t result;
+	result = iot_loop_worker_start( NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+static void test_iot_loop_worker_start_reuse_exited( void **state )
+{
+	struct iot lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	lib.to_quit = IOT_TRUE;
+#ifdef IOT_THREAD_SUPPORT
+	lib.worker_max = IOT_WORKER_THREADS;
+	lib.worker_count = 0u;
+	lib.worker[0].thread = (os_thread_t)1;
+	lib.worker[0].exited = IOT_TRUE;
+	will_return( __wrap_os_thread_create, OS_STATUS_SUCCESS );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	result = iot_loop_worker_start( &lib );
+#ifdef IOT_THREAD_SUPPORT
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.worker_count, 1u );
+	assert_ptr_equal( lib.worker[0].lib, &lib );
+	assert_true( lib.worker[0].thread != 0 );
+	assert_int_equal( lib.worker[0].exited, IOT_FALSE );
+	assert_true( lib.worker[1].thread == 0 );
+#else
+	assert_int_equal( result, IOT_STATUS_NOT_SUPPORTED );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+}
+
+static void test_iot_loop_worker_start_thread_fail( void **state )
+{
+	struct iot lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	lib.to_quit = IOT_TRUE;
+#ifdef IOT_THREAD_SUPPORT
+	lib.worker_max = IOT_WORKER_THREADS;
+	will_return( __wrap_os_thread_create, OS_STATUS_FAILURE );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+	result = iot_loop_worker_start( &lib );
+#ifdef IOT_THREAD_SUPPORT
+	assert_int_equal( result, IOT_STATUS_FAILURE );
+	assert_int_equal( lib.worker_count, 0u );
+	assert_true( lib.worker[0].thread == 0 );
+#else
+	assert_int_equal( result, IOT_STATUS_NOT_SUPPORTED );
+#endif /* ifdef IOT_THREAD_SUPPORT */
+}
+
 /* iot_terminate */
 static void test_iot_terminate_action( void **state )
 {
@@ -2515,6 +2590,119 @@ static void test_iot_timestamp_now_valid( void **state )
 	assert_int_equal( result, 1234567u );
 }
 
+/* iot_transaction_callback_set */
+static unsigned int transaction_callback_count;
+static iot_status_t transaction_callback_status;
+
+static void test_transaction_callback( iot_t *lib, iot_transaction_t txn,
+	iot_status_t status, void *user_data )
+{
+	++transaction_callback_count;
+	transaction_callback_status = status;
+}
+
+static void test_iot_transaction_callback_set_complete( void **state )
+{
+	iot_t lib;
+	iot_status_t result;
+	iot_transaction_t txn;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	transaction_callback_count = 0u;
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 1 );
+#endif
+	txn = iot_transaction_allocate( &lib );
+	assert_int_equal( txn, 1u );
+	result = iot_transaction_callback_set( &lib, &txn,
+		test_transaction_callback, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* sent, the plug-in is waiting for the reply from the cloud */
+	iot_transaction_status_set( &lib, txn, IOT_STATUS_INVOKED );
+	iot_transaction_finish( &lib, txn, IOT_STATUS_SUCCESS );
+	assert_int_equal( transaction_callback_count, 0u );
+	result = iot_transaction_status( &lib, &txn, 0u );
+	assert_int_equal( result, IOT_STATUS_INVOKED );
+
+	/* reply received */
+	iot_transaction_status_set( &lib, txn, IOT_STATUS_EXECUTION_ERROR );
+	assert_int_equal( transaction_callback_count, 1u );
+	assert_int_equal( transaction_callback_status,
+		IOT_STATUS_EXECUTION_ERROR );
+	iot_transaction_status_set( &lib, txn, IOT_STATUS_SUCCESS );
+	assert_int_equal( transaction_callback_count, 1u );
+	result = iot_transaction_status( &lib, &txn, 0u );
+	assert_int_equal( result, IOT_STATUS_EXECUTION_ERROR );
+
+	/* already completed, called straight away */
+	result = iot_transaction_callback_set( &lib, &txn,
+		test_transaction_callback, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( transaction_callback_count, 2u );
+#ifndef IOT_STACK_ONLY
+	os_free_null( (void **)&lib.transaction );
+#endif
+}
+
+static void test_iot_transaction_callback_set_forgotten( void **state )
+{
+	iot_t lib;
+	iot_status_t result;
+	iot_transaction_t txn;
+	iot_uint32_t i;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	transaction_callback_count = 0u;
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 1 );
+#endif
+	txn = iot_transaction_allocate( &lib );
+	result = iot_transaction_callback_set( &lib, &txn,
+		test_transaction_callback, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* ids wrap around the table, the oldest transaction is forgotten */
+	for ( i = 0u; i < IOT_TRANSACTION_SLOTS; ++i )
+		iot_transaction_allocate( &lib );
+	assert_int_equal( transaction_callback_count, 1u );
+	assert_int_equal( transaction_callback_status, IOT_STATUS_TIMED_OUT );
+
+	result = iot_transaction_status( &lib, &txn, 0u );
+	assert_int_equal( result, IOT_STATUS_NOT_FOUND );
+	result = iot_transaction_callback_set( &lib, &txn,
+		test_transaction_callback, NULL );
+	assert_int_equal( result, IOT_STATUS_NOT_FOUND );
+	iot_transaction_status_set( &lib, txn, IOT_STATUS_SUCCESS );
+	assert_int_equal( transaction_callback_count, 1u );
+#ifndef IOT_STACK_ONLY
+	os_free_null( (void **)&lib.transaction );
+#endif
+}
+
+static void test_iot_transaction_callback_set_not_found( void **state )
+{
+	iot_t lib;
+	iot_status_t result;
+	iot_transaction_t txn = 5u;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	result = iot_transaction_callback_set( &lib, &txn,
+		test_transaction_callback, NULL );
+	assert_int_equal( result, IOT_STATUS_NOT_FOUND );
+}
+
+static void test_iot_transaction_callback_set_null_txn( void **state )
+{
+	iot_t lib;
+	iot_status_t result;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+	result = iot_transaction_callback_set( &lib, NULL,
+		test_transaction_callback, NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
 /* iot_transaction_status */
 static void test_iot_transaction_status_bad( void **state )
 {
@@ -2540,6 +2728,38 @@ static void test_iot_transaction_status_good( void **state )
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 }
 
+static void test_iot_transaction_status_large_id( void **state )
+{
+	iot_t lib;
+	iot_status_t result;
+	iot_transaction_t txn[16u];
+	iot_uint32_t i;
+
+	memset( &lib, 0, sizeof( struct iot ) );
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 1 );
+#endif
+	/* ids past the size of the table, wrapping around (0 is skipped) */
+	lib.transaction_count = (iot_transaction_t)( 0u - 8u );
+	for ( i = 0u; i < 16u; ++i )
+	{
+		txn[i] = iot_transaction_allocate( &lib );
+		assert_int_not_equal( txn[i], 0u );
+	}
+	for ( i = 0u; i < 16u; ++i )
+		iot_transaction_status_set( &lib, txn[i], ( i % 2u ) ?
+			IOT_STATUS_FAILURE : IOT_STATUS_EXECUTION_ERROR );
+	for ( i = 0u; i < 16u; ++i )
+	{
+		result = iot_transaction_status( &lib, &txn[i], 0u );
+		assert_int_equal( result, ( i % 2u ) ?
+			IOT_STATUS_FAILURE : IOT_STATUS_EXECUTION_ERROR );
+	}
+#ifndef IOT_STACK_ONLY
+	os_free_null( (void **)&lib.transaction );
+#endif
+}
+
 static void test_iot_transaction_status_null_lib( void **state )
 {
 	iot_status_t result;
@@ -2665,6 +2885,10 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_loop_stop_single_thread ),
 		cmocka_unit_test( test_iot_loop_stop_threads_force ),
 		cmocka_unit_test( test_iot_loop_stop_threads_no_force ),
+		cmocka_unit_test( test_iot_loop_worker_start_full ),
+		cmocka_unit_test( test_iot_loop_worker_start_null_lib ),
+		cmocka_unit_test( test_iot_loop_worker_start_reuse_exited ),
+		cmocka_unit_test( test_iot_loop_worker_start_thread_fail ),
 		cmocka_unit_test( test_iot_terminate_action ),
 		cmocka_unit_test( test_iot_terminate_alarm ),
 		cmocka_unit_test( test_iot_terminate_blank ),
@@ -2672,8 +2896,13 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_terminate_option ),
 		cmocka_unit_test( test_iot_terminate_telemetry ),
 		cmocka_unit_test( test_iot_timestamp_now_valid ),
+		cmocka_unit_test( test_iot_transaction_callback_set_complete ),
+		cmocka_unit_test( test_iot_transaction_callback_set_forgotten ),
+		cmocka_unit_test( test_iot_transaction_callback_set_not_found ),
+		cmocka_unit_test( test_iot_transaction_callback_set_null_txn ),
 		cmocka_unit_test( test_iot_transaction_status_bad ),
 		cmocka_unit_test( test_iot_transaction_status_good ),
+		cmocka_unit_test( test_iot_transaction_status_large_id ),
 		cmocka_unit_test( test_iot_transaction_status_null_lib ),
 		cmocka_unit_test( test_iot_transaction_status_null_txn ),
 		cmocka_unit_test( test_iot_version ),
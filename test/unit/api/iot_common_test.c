@@ -22,6 +22,7 @@
 #include "api/shared/iot_types.h"
 #include "iot_build.h"
 
+#include <stddef.h> /* for offsetof */
 #include <string.h>
 
 static iot_status_t iot_common_arg_set_wrapper( struct iot_data *obj,
@@ -3136,6 +3137,153 @@ static void test_iot_common_data_copy_string_no_memory( void **state )
 	os_free( from.heap_storage );
 }
 
+/* object used to test the index functions */
+struct test_index_obj
+{
+	int value;
+	const char *name;
+};
+
+static void test_iot_common_index_find_case_insensitive( void **state )
+{
+	struct iot_index index;
+	void *slot[IOT_INDEX_SIZE( 4u )];
+	struct test_index_obj obj[3] = {
+		{ 1, "alpha" }, { 2, "Beta" }, { 3, "GAMMA" } };
+	size_t i;
+
+	iot_common_index_initialize( &index,
+		offsetof( struct test_index_obj, name ), slot,
+		IOT_INDEX_SIZE( 4u ) );
+	for ( i = 0u; i < 3u; ++i )
+		assert_int_equal( iot_common_index_insert( &index, &obj[i] ),
+			IOT_STATUS_SUCCESS );
+	assert_int_equal( index.count, 3u );
+	assert_ptr_equal( iot_common_index_find( &index, "ALPHA" ), &obj[0] );
+	assert_ptr_equal( iot_common_index_find( &index, "beta" ), &obj[1] );
+	assert_ptr_equal( iot_common_index_find( &index, "gamma" ), &obj[2] );
+	assert_null( iot_common_index_find( &index, "delta" ) );
+	assert_null( iot_common_index_find( &index, NULL ) );
+}
+
+static void test_iot_common_index_find_not_initialized( void **state )
+{
+	struct iot_index index;
+	memset( &index, 0, sizeof( struct iot_index ) );
+	assert_null( iot_common_index_find( &index, "alpha" ) );
+	assert_null( iot_common_index_find( NULL, "alpha" ) );
+}
+
+static void test_iot_common_index_remove( void **state )
+{
+	struct iot_index index;
+	void *slot[IOT_INDEX_SIZE( 8u )];
+	struct test_index_obj obj[8];
+	char name[8][8];
+	size_t i;
+
+	iot_common_index_initialize( &index,
+		offsetof( struct test_index_obj, name ), slot,
+		IOT_INDEX_SIZE( 8u ) );
+	for ( i = 0u; i < 8u; ++i )
+	{
+		snprintf( name[i], 8u, "obj%lu", (unsigned long)i );
+		obj[i].value = (int)i;
+		obj[i].name = name[i];
+		assert_int_equal( iot_common_index_insert( &index, &obj[i] ),
+			IOT_STATUS_SUCCESS );
+	}
+
+	/* objects that collided with removed ones must still be found */
+	for ( i = 0u; i < 8u; i += 2u )
+		assert_int_equal( iot_common_index_remove( &index, &obj[i] ),
+			IOT_STATUS_SUCCESS );
+	assert_int_equal( index.count, 4u );
+	for ( i = 0u; i < 8u; ++i )
+	{
+		if ( i % 2u )
+			assert_ptr_equal( iot_common_index_find( &index, name[i] ),
+				&obj[i] );
+		else
+			assert_null( iot_common_index_find( &index, name[i] ) );
+	}
+	assert_int_equal( iot_common_index_remove( &index, &obj[0] ),
+		IOT_STATUS_NOT_FOUND );
+}
+
+static void test_iot_common_index_reserve( void **state )
+{
+	struct iot_index index;
+	void *slot[IOT_INDEX_SIZE( 2u )];
+	struct test_index_obj obj[3] = {
+		{ 1, "alpha" }, { 2, "beta" }, { 3, "gamma" } };
+
+	iot_common_index_initialize( &index,
+		offsetof( struct test_index_obj, name ), slot,
+		IOT_INDEX_SIZE( 2u ) );
+	assert_int_equal( iot_common_index_insert( &index, &obj[0] ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( iot_common_index_insert( &index, &obj[1] ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( iot_common_index_reserve( &index, 2u ),
+		IOT_STATUS_SUCCESS );
+#ifdef IOT_STACK_ONLY
+	assert_int_equal( iot_common_index_insert( &index, &obj[2] ),
+		IOT_STATUS_FULL );
+	assert_null( iot_common_index_find( &index, "gamma" ) );
+#else
+	will_return( __wrap_os_malloc, 0 );
+	assert_int_equal( iot_common_index_insert( &index, &obj[2] ),
+		IOT_STATUS_NO_MEMORY );
+	assert_ptr_equal( index.slot, slot );
+
+	will_return( __wrap_os_malloc, 1 );
+	assert_int_equal( iot_common_index_insert( &index, &obj[2] ),
+		IOT_STATUS_SUCCESS );
+	assert_ptr_not_equal( index.slot, slot );
+	assert_true( index.size >= IOT_INDEX_SIZE( 3u ) );
+	assert_ptr_equal( iot_common_index_find( &index, "Alpha" ), &obj[0] );
+	assert_ptr_equal( iot_common_index_find( &index, "Beta" ), &obj[1] );
+	assert_ptr_equal( iot_common_index_find( &index, "Gamma" ), &obj[2] );
+#endif
+	iot_common_index_terminate( &index );
+	assert_null( index.slot );
+	assert_int_equal( index.count, 0u );
+}
+
+static void test_iot_common_list_grow( void **state )
+{
+#ifndef IOT_STACK_ONLY
+	int value[3] = { 1, 2, 3 };
+	void *initial[2] = { &value[0], &value[1] };
+	void **heap;
+	iot_uint32_t max = 2u;
+
+	will_return( __wrap_os_malloc, 0 );
+	heap = iot_common_list_grow( NULL, initial, &max );
+	assert_null( heap );
+	assert_int_equal( max, 2u );
+
+	will_return( __wrap_os_malloc, 1 );
+	heap = iot_common_list_grow( NULL, initial, &max );
+	assert_non_null( heap );
+	assert_int_equal( max, 4u );
+	assert_ptr_equal( heap[0], &value[0] );
+	assert_ptr_equal( heap[1], &value[1] );
+	assert_null( heap[2] );
+	assert_null( heap[3] );
+
+	heap[2] = &value[2];
+	will_return( __wrap_os_realloc, 1 );
+	heap = iot_common_list_grow( heap, initial, &max );
+	assert_non_null( heap );
+	assert_int_equal( max, 8u );
+	assert_ptr_equal( heap[2], &value[2] );
+	assert_null( heap[7] );
+	os_free( heap );
+#endif /* ifndef IOT_STACK_ONLY */
+}
+
 int main( int argc, char *argv[] )
 {
 	int result;
@@ -3318,7 +3466,12 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_common_data_copy_same_pointer_heap ),
 		cmocka_unit_test( test_iot_common_data_copy_same_pointer_stack ),
 		cmocka_unit_test( test_iot_common_data_copy_string ),
-		cmocka_unit_test( test_iot_common_data_copy_string_no_memory )
+		cmocka_unit_test( test_iot_common_data_copy_string_no_memory ),
+		cmocka_unit_test( test_iot_common_index_find_case_insensitive ),
+		cmocka_unit_test( test_iot_common_index_find_not_initialized ),
+		cmocka_unit_test( test_iot_common_index_remove ),
+		cmocka_unit_test( test_iot_common_index_reserve ),
+		cmocka_unit_test( test_iot_common_list_grow )
 	};
 	test_initialize( argc, argv );
 	result = cmocka_run_group_tests( tests, NULL, NULL );
@@ -49,6 +49,16 @@ static void test_iot_json_decode_parse( void **state )
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 }
 
+static void test_iot_json_decode_parse_chunk( void **state )
+{
+	iot_json_decoder_t* json = ( iot_json_decoder_t* )0x1;
+	iot_status_t result;
+
+	result = iot_json_decode_parse_chunk( json, NULL, 0u, IOT_TRUE,
+		NULL, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+}
+
 static void test_iot_json_decode_integer( void **state )
 {
 	const iot_json_decoder_t* json = ( iot_json_decoder_t* )0x1;
@@ -305,6 +315,7 @@ int main( int argc, char *argv[] )
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test( test_iot_json_decode_initialize ),
 		cmocka_unit_test( test_iot_json_decode_parse ),
+		cmocka_unit_test( test_iot_json_decode_parse_chunk ),
 		cmocka_unit_test( test_iot_json_decode_integer ),
 		cmocka_unit_test( test_iot_json_decode_bool ),
 		cmocka_unit_test( test_iot_json_decode_number ),
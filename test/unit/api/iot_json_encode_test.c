@@ -21,7 +21,8 @@
 #include "api/public/iot_json.h"
 
 #include <float.h> /* for DBL_MIN */
-#include <math.h> /* for fabs */
+#include <math.h> /* for fabs, INFINITY, NAN */
+#include <stdint.h> /* for UINT64_MAX */
 #include <stdlib.h>
 #include <string.h>
 
@@ -85,6 +86,22 @@ static void test_iot_json_encode_real( void **state )
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 }
 
+static void test_iot_json_encode_real_precision( void **state )
+{
+	iot_status_t result;
+	iot_json_encoder_t *json = (iot_json_encoder_t *) 0x1;
+	result = iot_json_encode_real_precision( json, "real", 1.2345, 2 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+}
+
+static void test_iot_json_encode_reset( void **state )
+{
+	iot_status_t result;
+	iot_json_encoder_t *json = (iot_json_encoder_t *) 0x1;
+	result = iot_json_encode_reset( json );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+}
+
 static void test_iot_json_encode_string( void **state )
 {
 	iot_status_t result;
@@ -130,6 +147,100 @@ static void test_iot_json_encode_terminate( void **state )
 	iot_json_encode_terminate( json );
 }
 
+static void test_iot_json_encode_unsigned( void **state )
+{
+	iot_status_t result;
+	iot_json_encoder_t *json = (iot_json_encoder_t *) 0x1;
+	result = iot_json_encode_unsigned( json, "unsigned", 1234u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+}
+
+static void test_iot_json_number_integer( void **state )
+{
+	char buf[IOT_JSON_NUMBER_MAX_LEN + 1u];
+	size_t result;
+
+	result = iot_json_number_integer( buf, 0u, IOT_FALSE );
+	buf[result] = '\0';
+	assert_int_equal( result, 1u );
+	assert_string_equal( buf, "0" );
+
+	result = iot_json_number_integer( buf, 12345u, IOT_TRUE );
+	buf[result] = '\0';
+	assert_int_equal( result, 6u );
+	assert_string_equal( buf, "-12345" );
+
+	result = iot_json_number_integer( buf, UINT64_MAX, IOT_FALSE );
+	buf[result] = '\0';
+	assert_int_equal( result, 20u );
+	assert_string_equal( buf, "18446744073709551615" );
+}
+
+static void test_iot_json_number_real( void **state )
+{
+	char buf[IOT_JSON_NUMBER_MAX_LEN + 1u];
+	size_t result;
+
+	result = iot_json_number_real( buf, 1.5,
+		IOT_JSON_PRECISION_SHORTEST );
+	buf[result] = '\0';
+	assert_string_equal( buf, "1.5" );
+
+	result = iot_json_number_real( buf, -0.1,
+		IOT_JSON_PRECISION_SHORTEST );
+	buf[result] = '\0';
+	assert_string_equal( buf, "-0.1" );
+
+	result = iot_json_number_real( buf, 3.14159, 2 );
+	buf[result] = '\0';
+	assert_string_equal( buf, "3.14" );
+
+	result = iot_json_number_real( buf, NAN,
+		IOT_JSON_PRECISION_SHORTEST );
+	assert_int_equal( result, 0u );
+
+	result = iot_json_number_real( buf, INFINITY, 2 );
+	assert_int_equal( result, 0u );
+}
+
+static void test_iot_json_string_escape( void **state )
+{
+	const char *const src = "a\"b\\c\n\x01";
+	char buf[32u];
+	size_t result;
+
+	result = iot_json_string_escape( buf, src, strlen( src ),
+		sizeof( buf ) );
+	buf[result] = '\0';
+	assert_string_equal( buf, "a\\\"b\\\\c\\n\\u0001" );
+	assert_int_equal( result,
+		iot_json_string_escape_len( src, strlen( src ) ) );
+}
+
+static void test_iot_json_string_escape_truncated( void **state )
+{
+	const char *const src = "ab\"c";
+	char buf[8u];
+	size_t result;
+
+	/* escape sequence for the quote does not fit */
+	memset( buf, 0, sizeof( buf ) );
+	result = iot_json_string_escape( buf, src, strlen( src ), 3u );
+	assert_int_equal( result, 2u );
+	assert_string_equal( buf, "ab" );
+
+	result = iot_json_string_escape( buf, src, strlen( src ), 1u );
+	assert_int_equal( result, 1u );
+}
+
+static void test_iot_json_string_escape_len( void **state )
+{
+	assert_int_equal( iot_json_string_escape_len( "", 0u ), 0u );
+	assert_int_equal( iot_json_string_escape_len( "plain", 5u ), 5u );
+	assert_int_equal( iot_json_string_escape_len( "\"\\", 2u ), 4u );
+	assert_int_equal( iot_json_string_escape_len( "\t\x1f", 2u ), 8u );
+}
+
 /* main */
 int main( int argc, char *argv[] )
 {
@@ -142,12 +253,20 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_json_encode_bool ),
 		cmocka_unit_test( test_iot_json_encode_integer ),
 		cmocka_unit_test( test_iot_json_encode_real ),
+		cmocka_unit_test( test_iot_json_encode_real_precision ),
+		cmocka_unit_test( test_iot_json_encode_reset ),
 		cmocka_unit_test( test_iot_json_encode_string ),
 		cmocka_unit_test( test_iot_json_encode_array_start ),
 		cmocka_unit_test( test_iot_json_encode_array_end ),
 		cmocka_unit_test( test_iot_json_encode_dump ),
 		cmocka_unit_test( test_iot_json_encode_initialize ),
 		cmocka_unit_test( test_iot_json_encode_terminate ),
+		cmocka_unit_test( test_iot_json_encode_unsigned ),
+		cmocka_unit_test( test_iot_json_number_integer ),
+		cmocka_unit_test( test_iot_json_number_real ),
+		cmocka_unit_test( test_iot_json_string_escape ),
+		cmocka_unit_test( test_iot_json_string_escape_truncated ),
+		cmocka_unit_test( test_iot_json_string_escape_len ),
 	};
 	test_initialize( argc, argv );
 	result = cmocka_run_group_tests( tests, NULL, NULL );
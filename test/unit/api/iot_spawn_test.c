@@ -0,0 +1,261 @@
+/**
+ * @file
+ * @brief unit testing for running commands without a shell
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "test_support.h"
+
+#include "api/public/iot.h"
+#include "api/shared/iot_types.h"
+#include "iot_build.h"
+
+#include <string.h>
+#include <time.h>   /* for nanosleep, time */
+
+#ifdef IOT_SPAWN_SUPPORT
+/**
+ * @brief output callback that reads slowly, so the pipe is always full
+ *
+ * @param[in,out]  user_data           number of characters read
+ * @param[in]      is_err              whether read from standard error
+ * @param[in]      buf                 output read
+ * @param[in]      len                 number of characters read
+ */
+static void test_iot_spawn_output_slow( void *user_data, iot_bool_t is_err,
+	const char *buf, size_t len )
+{
+	const struct timespec delay = { 0, 1000000L };
+	*(size_t *)user_data += len;
+	nanosleep( &delay, NULL );
+}
+
+/* iot_spawn_helper_start */
+static void test_iot_spawn_helper_start_valid( void **state )
+{
+	iot_status_t result;
+	iot_t lib;
+	char out[32u];
+	const char *const argv[] = { "echo", "from helper", NULL };
+	struct iot_spawn_args args;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	lib.spawn_helper_fd = -1;
+	result = iot_spawn_helper_start( &lib );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_true( lib.spawn_helper_fd >= 0 );
+	assert_true( lib.spawn_helper_pid > 0 );
+
+	memset( &args, 0, sizeof( struct iot_spawn_args ) );
+	args.argv = argv;
+	args.block = IOT_TRUE;
+	args.std_out = out;
+	args.std_out_len = sizeof( out );
+	args.return_code = -1;
+	result = iot_spawn_run( &lib, &args );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( args.return_code, 0 );
+	assert_string_equal( out, "from helper\n" );
+
+	result = iot_spawn_helper_stop( &lib );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( lib.spawn_helper_fd, -1 );
+	assert_int_equal( lib.spawn_helper_pid, 0 );
+}
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
+/* iot_spawn_helper_stop */
+static void test_iot_spawn_helper_stop_null_lib( void **state )
+{
+	iot_status_t result;
+
+	result = iot_spawn_helper_stop( NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+/* iot_spawn_run */
+#ifdef IOT_SPAWN_SUPPORT
+static void test_iot_spawn_run_no_block( void **state )
+{
+	iot_status_t result;
+	iot_t lib;
+	const char *const argv[] = { "true", NULL };
+	struct iot_spawn_args args;
+
+	/* nothing would reap the command without the helper */
+	memset( &lib, 0, sizeof( iot_t ) );
+	lib.spawn_helper_fd = -1;
+	memset( &args, 0, sizeof( struct iot_spawn_args ) );
+	args.argv = argv;
+	args.block = IOT_FALSE;
+	result = iot_spawn_run( &lib, &args );
+	assert_int_equal( result, IOT_STATUS_NOT_SUPPORTED );
+}
+
+static void test_iot_spawn_run_not_found( void **state )
+{
+	iot_status_t result;
+	iot_t lib;
+	const char *const argv[] = { "/nonexistent/iot_spawn_test", NULL };
+	struct iot_spawn_args args;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	lib.spawn_helper_fd = -1;
+	memset( &args, 0, sizeof( struct iot_spawn_args ) );
+	args.argv = argv;
+	args.block = IOT_TRUE;
+	result = iot_spawn_run( &lib, &args );
+	assert_int_equal( result, IOT_STATUS_FAILURE );
+}
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
+static void test_iot_spawn_run_null( void **state )
+{
+	iot_status_t result;
+	iot_t lib;
+	const char *const argv[] = { NULL };
+	struct iot_spawn_args args;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	memset( &args, 0, sizeof( struct iot_spawn_args ) );
+	result = iot_spawn_run( NULL, &args );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = iot_spawn_run( &lib, NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = iot_spawn_run( &lib, &args );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	args.argv = argv;
+	result = iot_spawn_run( &lib, &args );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+#ifdef IOT_SPAWN_SUPPORT
+static void test_iot_spawn_run_output( void **state )
+{
+	iot_status_t result;
+	iot_t lib;
+	char err[8u];
+	char out[32u];
+	const char *const argv[] = { "/bin/sh", "-c",
+		"echo 'to stdout'; echo 'to stderr' >&2; exit 3", NULL };
+	struct iot_spawn_args args;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	lib.spawn_helper_fd = -1;
+	memset( &args, 0, sizeof( struct iot_spawn_args ) );
+	args.argv = argv;
+	args.block = IOT_TRUE;
+	args.std_out = out;
+	args.std_out_len = sizeof( out );
+	args.std_err = err;
+	args.std_err_len = sizeof( err );
+	result = iot_spawn_run( &lib, &args );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( args.return_code, 3 );
+	assert_string_equal( out, "to stdout\n" );
+
+	/* output is truncated to the buffer */
+	assert_string_equal( err, "to stde" );
+}
+
+static void test_iot_spawn_run_signaled( void **state )
+{
+	iot_status_t result;
+	iot_t lib;
+	const char *const argv[] = { "/bin/sh", "-c", "kill -9 $$", NULL };
+	struct iot_spawn_args args;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	lib.spawn_helper_fd = -1;
+	memset( &args, 0, sizeof( struct iot_spawn_args ) );
+	args.argv = argv;
+	args.block = IOT_TRUE;
+	result = iot_spawn_run( &lib, &args );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( args.return_code, 128 + 9 );
+}
+
+static void test_iot_spawn_run_time_out( void **state )
+{
+	iot_status_t result;
+	iot_t lib;
+	const char *const argv[] = { "sleep", "10", NULL };
+	struct iot_spawn_args args;
+	time_t start;
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	lib.spawn_helper_fd = -1;
+	memset( &args, 0, sizeof( struct iot_spawn_args ) );
+	args.argv = argv;
+	args.block = IOT_TRUE;
+	args.max_time_out = 200u;
+	start = time( NULL );
+	result = iot_spawn_run( &lib, &args );
+	assert_int_equal( result, IOT_STATUS_TIMED_OUT );
+	assert_true( time( NULL ) - start < 5 );
+}
+
+static void test_iot_spawn_run_time_out_after_exit( void **state )
+{
+	iot_status_t result;
+	iot_t lib;
+	size_t count = 0u;
+	const char *const argv[] = { "/bin/sh", "-c", "yes &", NULL };
+	struct iot_spawn_args args;
+	time_t start;
+
+	/* command exits at once, but leaves a process writing to its
+	 * output: the time limit still applies */
+	memset( &lib, 0, sizeof( iot_t ) );
+	lib.spawn_helper_fd = -1;
+	memset( &args, 0, sizeof( struct iot_spawn_args ) );
+	args.argv = argv;
+	args.block = IOT_TRUE;
+	args.max_time_out = 300u;
+	args.output = test_iot_spawn_output_slow;
+	args.user_data = &count;
+	start = time( NULL );
+	result = iot_spawn_run( &lib, &args );
+	assert_int_equal( result, IOT_STATUS_TIMED_OUT );
+	assert_true( count > 0u );
+	assert_true( time( NULL ) - start < 5 );
+}
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+
+/* main */
+int main( int argc, char *argv[] )
+{
+	int result;
+	const struct CMUnitTest tests[] = {
+#ifdef IOT_SPAWN_SUPPORT
+		cmocka_unit_test( test_iot_spawn_helper_start_valid ),
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+		cmocka_unit_test( test_iot_spawn_helper_stop_null_lib ),
+#ifdef IOT_SPAWN_SUPPORT
+		cmocka_unit_test( test_iot_spawn_run_no_block ),
+		cmocka_unit_test( test_iot_spawn_run_not_found ),
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+		cmocka_unit_test( test_iot_spawn_run_null ),
+#ifdef IOT_SPAWN_SUPPORT
+		cmocka_unit_test( test_iot_spawn_run_output ),
+		cmocka_unit_test( test_iot_spawn_run_signaled ),
+		cmocka_unit_test( test_iot_spawn_run_time_out ),
+		cmocka_unit_test( test_iot_spawn_run_time_out_after_exit ),
+#endif /* ifdef IOT_SPAWN_SUPPORT */
+	};
+	test_initialize( argc, argv );
+	result = cmocka_run_group_tests( tests, NULL, NULL );
+	test_finalize( argc, argv );
+	return result;
+}
@@ -73,6 +73,9 @@ static void test_iot_telemetry_allocate_full( void **state )
 	}
 	snprintf( name, IOT_NAME_MAX_LEN, "telemetry %03d.5", IOT_TELEMETRY_MAX / 2u );
 	lib.telemetry_count = IOT_TELEMETRY_MAX;
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 0 ); /* grow list of telemetry */
+#endif
 	result = iot_telemetry_allocate( &lib, name, IOT_TYPE_INT32 );
 	assert_null( result );
 	assert_int_equal( lib.telemetry_count, IOT_TELEMETRY_MAX );
@@ -80,6 +83,54 @@ static void test_iot_telemetry_allocate_full( void **state )
 	test_free( stack_telemetry );
 }
 
+static void test_iot_telemetry_allocate_grow( void **state )
+{
+#ifndef IOT_STACK_ONLY
+	size_t i;
+	iot_t lib;
+	char name[IOT_NAME_MAX_LEN + 1u];
+	char *t_names;
+	iot_telemetry_t *result;
+	iot_telemetry_t *stack_telemetry;
+
+	t_names = test_malloc( sizeof( char ) * ( IOT_NAME_MAX_LEN + 1u ) * IOT_TELEMETRY_MAX );
+	assert_non_null( t_names );
+
+	stack_telemetry = (iot_telemetry_t *)test_calloc( IOT_TELEMETRY_MAX - IOT_TELEMETRY_STACK_MAX,
+	                                                  sizeof( iot_telemetry_t ) );
+	assert_non_null( stack_telemetry );
+	memset( &lib, 0, sizeof( iot_t ) );
+	for ( i = 0u; i < IOT_TELEMETRY_MAX; i++ )
+	{
+		if ( i < IOT_TELEMETRY_STACK_MAX )
+			lib.telemetry_ptr[i] = &lib.telemetry[i];
+		else
+			lib.telemetry_ptr[i] = &stack_telemetry[i - IOT_TELEMETRY_STACK_MAX];
+		lib.telemetry_ptr[i]->name = &t_names[( IOT_NAME_MAX_LEN + 1u ) * i];
+		snprintf( lib.telemetry_ptr[i]->name, IOT_NAME_MAX_LEN, "telemetry %03lu", i );
+	}
+	snprintf( name, IOT_NAME_MAX_LEN, "telemetry %03d.5", IOT_TELEMETRY_MAX / 2u );
+	lib.telemetry_count = IOT_TELEMETRY_MAX;
+	will_return( __wrap_os_malloc, 1 ); /* grow list of telemetry */
+	will_return( __wrap_os_malloc, 1 ); /* for new object */
+	will_return( __wrap_os_malloc, 1 ); /* for name */
+	result = iot_telemetry_allocate( &lib, name, IOT_TYPE_INT32 );
+	assert_non_null( result );
+	assert_int_equal( lib.telemetry_count, IOT_TELEMETRY_MAX + 1u );
+	assert_non_null( lib.telemetry_heap );
+	assert_int_equal( lib.telemetry_max, IOT_TELEMETRY_MAX * 2u );
+	assert_ptr_equal( lib.telemetry_heap[0], lib.telemetry_ptr[0] );
+	assert_ptr_equal( lib.telemetry_heap[IOT_TELEMETRY_MAX / 2u + 1u], result );
+
+	/* clean up */
+	os_free( result->name );
+	os_free( result );
+	os_free( lib.telemetry_heap );
+	test_free( t_names );
+	test_free( stack_telemetry );
+#endif /* ifndef IOT_STACK_ONLY */
+}
+
 static void test_iot_telemetry_allocate_stack_full( void **state )
 {
 	size_t i;
@@ -817,6 +868,164 @@ static void test_iot_telemetry_publish_null_type( void **state )
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 }
 
+static void test_iot_telemetry_publish_reduce_deadband( void **state )
+{
+	size_t i;
+	iot_status_t result;
+	iot_t lib;
+	iot_telemetry_t *telemetry;
+	struct iot_option opts[ IOT_OPTION_MAX ];
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	memset( &opts, 0, sizeof( struct iot_option ) * IOT_OPTION_MAX );
+	for ( i = 0u; i < IOT_TELEMETRY_STACK_MAX; i++ )
+		lib.telemetry_ptr[i] = &lib.telemetry[i];
+	lib.telemetry_count = 1u;
+	telemetry = lib.telemetry_ptr[0];
+	telemetry->lib = &lib;
+	telemetry->type = IOT_TYPE_FLOAT64;
+	telemetry->option = opts;
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 1 ); /* for name */
+#endif
+	result = iot_telemetry_option_set( telemetry, "deadband",
+		IOT_TYPE_FLOAT64, 1.0 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_true( telemetry->reduce.deadband == 1.0 );
+
+	/* first sample is always published */
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_FLOAT64, 10.0 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* within the deadband */
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_FLOAT64, 10.5 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_FLOAT64, 9.0 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* outside of the deadband */
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_FLOAT64, 11.5 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_true( telemetry->reduce.published_value == 11.5 );
+#ifndef IOT_STACK_ONLY
+	os_free( opts[0].name );
+#endif
+}
+
+static void test_iot_telemetry_publish_reduce_interval( void **state )
+{
+	size_t i;
+	iot_status_t result;
+	iot_t lib;
+	iot_telemetry_t *telemetry;
+	struct iot_option opts[ IOT_OPTION_MAX ];
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	memset( &opts, 0, sizeof( struct iot_option ) * IOT_OPTION_MAX );
+	for ( i = 0u; i < IOT_TELEMETRY_STACK_MAX; i++ )
+		lib.telemetry_ptr[i] = &lib.telemetry[i];
+	lib.telemetry_count = 1u;
+	telemetry = lib.telemetry_ptr[0];
+	telemetry->lib = &lib;
+	telemetry->type = IOT_TYPE_INT32;
+	telemetry->option = opts;
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 1 ); /* for name */
+#endif
+	result = iot_telemetry_option_set( telemetry, "interval_min",
+		IOT_TYPE_UINT32, 1000u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( telemetry->reduce.interval, 1000u );
+
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	iot_telemetry_timestamp_set( telemetry, 5000u );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_INT32, 1 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* too soon */
+	iot_telemetry_timestamp_set( telemetry, 5999u );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_INT32, 2 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( telemetry->time_stamp, 0u );
+
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	iot_telemetry_timestamp_set( telemetry, 6000u );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_INT32, 3 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_true( telemetry->reduce.published_value == 3.0 );
+#ifndef IOT_STACK_ONLY
+	os_free( opts[0].name );
+#endif
+}
+
+static void test_iot_telemetry_publish_reduce_window( void **state )
+{
+	size_t i;
+	iot_status_t result;
+	iot_t lib;
+	iot_telemetry_t *telemetry;
+	struct iot_option opts[ IOT_OPTION_MAX ];
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	memset( &opts, 0, sizeof( struct iot_option ) * IOT_OPTION_MAX );
+	for ( i = 0u; i < IOT_TELEMETRY_STACK_MAX; i++ )
+		lib.telemetry_ptr[i] = &lib.telemetry[i];
+	lib.telemetry_count = 1u;
+	telemetry = lib.telemetry_ptr[0];
+	telemetry->lib = &lib;
+	telemetry->type = IOT_TYPE_INT16;
+	telemetry->option = opts;
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 1 ); /* for name */
+#endif
+	result = iot_telemetry_option_set( telemetry, "window",
+		IOT_TYPE_INT32, 1000 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( telemetry->reduce.window, 1000u );
+
+	/* samples are held within the window */
+	iot_telemetry_timestamp_set( telemetry, 1000u );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_INT16, 1 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	iot_telemetry_timestamp_set( telemetry, 1200u );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_INT16, 5 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	iot_telemetry_timestamp_set( telemetry, 1900u );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_INT16, 3 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( telemetry->reduce.count, 3u );
+	assert_true( telemetry->reduce.min == 1.0 );
+	assert_true( telemetry->reduce.max == 5.0 );
+	assert_true( telemetry->reduce.last == 3.0 );
+
+	/* sample outside of the window publishes the mean */
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	iot_telemetry_timestamp_set( telemetry, 2100u );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_INT16, 7 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_true( telemetry->reduce.published_value == 3.0 );
+	assert_int_equal( telemetry->reduce.count, 1u );
+	assert_int_equal( telemetry->reduce.window_start, 2100u );
+	assert_true( telemetry->reduce.last == 7.0 );
+	assert_int_equal( telemetry->time_stamp, 0u );
+#ifndef IOT_STACK_ONLY
+	os_free( opts[0].name );
+#endif
+}
+
 static void test_iot_telemetry_publish_string( void **state )
 {
 	size_t i;
@@ -937,6 +1146,107 @@ static void test_iot_telemetry_publish_raw_valid( void **state )
 	assert_int_equal( result, IOT_STATUS_SUCCESS );
 }
 
+static void test_iot_telemetry_reduce_flush_expired( void **state )
+{
+	size_t i;
+	iot_status_t result;
+	iot_t lib;
+	iot_telemetry_t *telemetry;
+	struct iot_option opts[ IOT_OPTION_MAX ];
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	memset( &opts, 0, sizeof( struct iot_option ) * IOT_OPTION_MAX );
+	for ( i = 0u; i < IOT_TELEMETRY_STACK_MAX; i++ )
+		lib.telemetry_ptr[i] = &lib.telemetry[i];
+	lib.telemetry_count = 1u;
+	telemetry = lib.telemetry_ptr[0];
+	telemetry->lib = &lib;
+	telemetry->type = IOT_TYPE_INT16;
+	telemetry->option = opts;
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 1 ); /* for name */
+#endif
+	result = iot_telemetry_option_set( telemetry, "window",
+		IOT_TYPE_INT32, 1000 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* window is still open (os_time returns 1234567) */
+	iot_telemetry_timestamp_set( telemetry, 1234000u );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_INT16, 2 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = iot_telemetry_reduce_flush( &lib, IOT_FALSE, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( telemetry->reduce.count, 1u );
+	assert_int_equal( telemetry->reduce.has_published, IOT_FALSE );
+
+	/* no more samples arrive, the expired window is published */
+	iot_telemetry_timestamp_set( telemetry, 1234100u );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_INT16, 4 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	telemetry->reduce.window_start = 1000u;
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_SUCCESS );
+	result = iot_telemetry_reduce_flush( &lib, IOT_FALSE, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( telemetry->reduce.count, 0u );
+	assert_true( telemetry->reduce.published_value == 3.0 );
+
+	/* nothing left to publish */
+	result = iot_telemetry_reduce_flush( &lib, IOT_FALSE, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+#ifndef IOT_STACK_ONLY
+	os_free( opts[0].name );
+#endif
+}
+
+static void test_iot_telemetry_reduce_flush_force( void **state )
+{
+	size_t i;
+	iot_status_t result;
+	iot_t lib;
+	iot_telemetry_t *telemetry;
+	struct iot_option opts[ IOT_OPTION_MAX ];
+
+	memset( &lib, 0, sizeof( iot_t ) );
+	memset( &opts, 0, sizeof( struct iot_option ) * IOT_OPTION_MAX );
+	for ( i = 0u; i < IOT_TELEMETRY_STACK_MAX; i++ )
+		lib.telemetry_ptr[i] = &lib.telemetry[i];
+	lib.telemetry_count = 1u;
+	telemetry = lib.telemetry_ptr[0];
+	telemetry->lib = &lib;
+	telemetry->type = IOT_TYPE_INT16;
+	telemetry->option = opts;
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 1 ); /* for name */
+#endif
+	result = iot_telemetry_option_set( telemetry, "window",
+		IOT_TYPE_INT32, 1000 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* partial window is published, as done on disconnect */
+	iot_telemetry_timestamp_set( telemetry, 1234500u );
+	result = iot_telemetry_publish( telemetry, NULL, 0u,
+		IOT_TYPE_INT16, 5 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	will_return( __wrap_iot_plugin_perform, IOT_STATUS_FAILURE );
+	result = iot_telemetry_reduce_flush( &lib, IOT_TRUE, 0u );
+	assert_int_equal( result, IOT_STATUS_FAILURE );
+	assert_int_equal( telemetry->reduce.count, 0u );
+	assert_int_equal( telemetry->reduce.has_published, IOT_FALSE );
+#ifndef IOT_STACK_ONLY
+	os_free( opts[0].name );
+#endif
+}
+
+static void test_iot_telemetry_reduce_flush_null_lib( void **state )
+{
+	iot_status_t result;
+
+	result = iot_telemetry_reduce_flush( NULL, IOT_TRUE, 0u );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
 static void test_iot_telemetry_register_null_lib( void **state )
 {
 	size_t i;
@@ -1035,6 +1345,7 @@ int main( int argc, char *argv[] )
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test( test_iot_telemetry_allocate_empty ),
 		cmocka_unit_test( test_iot_telemetry_allocate_full ),
+		cmocka_unit_test( test_iot_telemetry_allocate_grow ),
 		cmocka_unit_test( test_iot_telemetry_allocate_stack_full ),
 		cmocka_unit_test( test_iot_telemetry_allocate_null_lib ),
 		cmocka_unit_test( test_iot_telemetry_allocate_null_name ),
@@ -1062,12 +1373,18 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_iot_telemetry_publish_null_lib ),
 		cmocka_unit_test( test_iot_telemetry_publish_null_telemetry ),
 		cmocka_unit_test( test_iot_telemetry_publish_null_type ),
+		cmocka_unit_test( test_iot_telemetry_publish_reduce_deadband ),
+		cmocka_unit_test( test_iot_telemetry_publish_reduce_interval ),
+		cmocka_unit_test( test_iot_telemetry_publish_reduce_window ),
 		cmocka_unit_test( test_iot_telemetry_publish_string ),
 		cmocka_unit_test( test_iot_telemetry_publish_string_no_memory ),
 		cmocka_unit_test( test_iot_telemetry_publish_string_null ),
 		cmocka_unit_test( test_iot_telemetry_publish_raw_no_memory ),
 		cmocka_unit_test( test_iot_telemetry_publish_raw_null ),
 		cmocka_unit_test( test_iot_telemetry_publish_raw_valid ),
+		cmocka_unit_test( test_iot_telemetry_reduce_flush_expired ),
+		cmocka_unit_test( test_iot_telemetry_reduce_flush_force ),
+		cmocka_unit_test( test_iot_telemetry_reduce_flush_null_lib ),
 		cmocka_unit_test( test_iot_telemetry_register_null_lib ),
 		cmocka_unit_test( test_iot_telemetry_register_null_telemetry ),
 		cmocka_unit_test( test_iot_telemetry_register_transmit_fail ),
@@ -0,0 +1,271 @@
+/**
+ * @file
+ * @brief unit testing for the tr50 cache of recently executed mailbox
+ *        messages
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "test_support.h"
+
+#include "api/plugin/tr50/tr50_dedup.h"
+
+#include <stdio.h> /* for remove */
+#include <string.h>
+
+/** @brief file the cache is kept in for the persistence tests */
+#define TEST_DEDUP_FILE                     "tr50_dedup_test.dat"
+
+/* tr50_dedup_begin */
+static void test_tr50_dedup_begin_disabled( void **state )
+{
+	struct tr50_dedup d;
+	iot_status_t result;
+	iot_status_t status = IOT_STATUS_SUCCESS;
+	size_t ack_len = 1u;
+
+	result = tr50_dedup_open( &d, 0u, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* nothing is remembered */
+	result = tr50_dedup_begin( &d, "id", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( ack_len, 0u );
+	result = tr50_dedup_begin( &d, "id", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	tr50_dedup_close( &d );
+}
+
+static void test_tr50_dedup_begin_null( void **state )
+{
+	struct tr50_dedup d;
+	iot_status_t result;
+	iot_status_t status;
+	size_t ack_len;
+
+	result = tr50_dedup_open( &d, 4u, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = tr50_dedup_begin( NULL, "id", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = tr50_dedup_begin( &d, NULL, &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = tr50_dedup_begin( &d, "id", NULL, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = tr50_dedup_begin( &d, "id", &status, NULL, 0u, NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	tr50_dedup_close( &d );
+}
+
+static void test_tr50_dedup_begin_duplicate( void **state )
+{
+	struct tr50_dedup d;
+	iot_status_t result;
+	iot_status_t status = IOT_STATUS_SUCCESS;
+	char ack[32u];
+	size_t ack_len;
+	const char *const sent = "{\"1\":{\"success\":false}}";
+
+	result = tr50_dedup_open( &d, 4u, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = tr50_dedup_begin( &d, "id", &status, ack, sizeof( ack ),
+		&ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* delivered again while still being executed */
+	result = tr50_dedup_begin( &d, "id", &status, ack, sizeof( ack ),
+		&ack_len );
+	assert_int_equal( result, IOT_STATUS_INVOKED );
+
+	/* delivered again once acknowledged */
+#ifndef IOT_STACK_ONLY
+	will_return( __wrap_os_malloc, 1 );
+#endif
+	tr50_dedup_complete( &d, "id", IOT_STATUS_EXECUTION_ERROR,
+		sent, strlen( sent ) );
+	result = tr50_dedup_begin( &d, "id", &status, ack, sizeof( ack ),
+		&ack_len );
+	assert_int_equal( result, IOT_STATUS_EXISTS );
+	assert_int_equal( status, IOT_STATUS_EXECUTION_ERROR );
+#ifndef IOT_STACK_ONLY
+	assert_int_equal( ack_len, strlen( sent ) );
+	assert_memory_equal( ack, sent, ack_len );
+#else
+	assert_int_equal( ack_len, 0u );
+#endif
+	tr50_dedup_close( &d );
+}
+
+static void test_tr50_dedup_begin_evict_lru( void **state )
+{
+	struct tr50_dedup d;
+	iot_status_t result;
+	iot_status_t status = IOT_STATUS_SUCCESS;
+	size_t ack_len;
+
+	result = tr50_dedup_open( &d, 2u, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = tr50_dedup_begin( &d, "a", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	tr50_dedup_complete( &d, "a", IOT_STATUS_SUCCESS, NULL, 0u );
+	result = tr50_dedup_begin( &d, "b", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	tr50_dedup_complete( &d, "b", IOT_STATUS_SUCCESS, NULL, 0u );
+
+	/* "a" is seen again, so "b" is now the least recently used */
+	result = tr50_dedup_begin( &d, "a", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_EXISTS );
+	result = tr50_dedup_begin( &d, "c", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = tr50_dedup_begin( &d, "b", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = tr50_dedup_begin( &d, "c", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_INVOKED );
+	result = tr50_dedup_begin( &d, "a", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	tr50_dedup_close( &d );
+}
+
+/* tr50_dedup_complete */
+static void test_tr50_dedup_complete_large_ack( void **state )
+{
+	struct tr50_dedup d;
+	iot_status_t result;
+	iot_status_t status = IOT_STATUS_SUCCESS;
+	char ack[TR50_DEDUP_ACK_MAX + 1u];
+	size_t ack_len;
+
+	memset( ack, 'x', sizeof( ack ) );
+	result = tr50_dedup_open( &d, 4u, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = tr50_dedup_begin( &d, "id", &status, ack, sizeof( ack ),
+		&ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* answered by status only */
+	tr50_dedup_complete( &d, "id", IOT_STATUS_SUCCESS, ack, sizeof( ack ) );
+	result = tr50_dedup_begin( &d, "id", &status, ack, sizeof( ack ),
+		&ack_len );
+	assert_int_equal( result, IOT_STATUS_EXISTS );
+	assert_int_equal( status, IOT_STATUS_SUCCESS );
+	assert_int_equal( ack_len, 0u );
+	tr50_dedup_close( &d );
+}
+
+static void test_tr50_dedup_complete_not_found( void **state )
+{
+	struct tr50_dedup d;
+	iot_status_t result;
+	iot_status_t status = IOT_STATUS_SUCCESS;
+	size_t ack_len;
+
+	result = tr50_dedup_open( &d, 4u, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	tr50_dedup_complete( &d, "id", IOT_STATUS_FAILURE, NULL, 0u );
+	result = tr50_dedup_begin( &d, "id", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	tr50_dedup_close( &d );
+}
+
+/* tr50_dedup_forget */
+static void test_tr50_dedup_forget_valid( void **state )
+{
+	struct tr50_dedup d;
+	iot_status_t result;
+	iot_status_t status = IOT_STATUS_SUCCESS;
+	size_t ack_len;
+
+	result = tr50_dedup_open( &d, 4u, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = tr50_dedup_begin( &d, "id", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* refused for now, executed if delivered again */
+	tr50_dedup_forget( &d, "id" );
+	result = tr50_dedup_begin( &d, "id", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	tr50_dedup_close( &d );
+}
+
+/* tr50_dedup_open */
+static void test_tr50_dedup_open_null( void **state )
+{
+	iot_status_t result;
+
+	result = tr50_dedup_open( NULL, 4u, NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+static void test_tr50_dedup_open_persist( void **state )
+{
+	struct tr50_dedup d;
+	iot_status_t result;
+	iot_status_t status = IOT_STATUS_SUCCESS;
+	size_t ack_len;
+
+	remove( TEST_DEDUP_FILE );
+	result = tr50_dedup_open( &d, 4u, TEST_DEDUP_FILE );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = tr50_dedup_begin( &d, "done", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	tr50_dedup_complete( &d, "done", IOT_STATUS_NOT_SUPPORTED, NULL, 0u );
+	result = tr50_dedup_begin( &d, "running", &status, NULL, 0u,
+		&ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = tr50_dedup_begin( &d, "forgotten", &status, NULL, 0u,
+		&ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	tr50_dedup_forget( &d, "forgotten" );
+	tr50_dedup_close( &d );
+
+	/* recovered after a restart */
+	result = tr50_dedup_open( &d, 4u, TEST_DEDUP_FILE );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = tr50_dedup_begin( &d, "done", &status, NULL, 0u, &ack_len );
+	assert_int_equal( result, IOT_STATUS_EXISTS );
+	assert_int_equal( status, IOT_STATUS_NOT_SUPPORTED );
+	assert_int_equal( ack_len, 0u );
+
+	/* interrupted by the restart, not executed again */
+	result = tr50_dedup_begin( &d, "running", &status, NULL, 0u,
+		&ack_len );
+	assert_int_equal( result, IOT_STATUS_EXISTS );
+	assert_int_equal( status, IOT_STATUS_EXECUTION_ERROR );
+
+	result = tr50_dedup_begin( &d, "forgotten", &status, NULL, 0u,
+		&ack_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	tr50_dedup_close( &d );
+	remove( TEST_DEDUP_FILE );
+}
+
+/* main */
+int main( int argc, char *argv[] )
+{
+	int result;
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test( test_tr50_dedup_begin_disabled ),
+		cmocka_unit_test( test_tr50_dedup_begin_null ),
+		cmocka_unit_test( test_tr50_dedup_begin_duplicate ),
+		cmocka_unit_test( test_tr50_dedup_begin_evict_lru ),
+		cmocka_unit_test( test_tr50_dedup_complete_large_ack ),
+		cmocka_unit_test( test_tr50_dedup_complete_not_found ),
+		cmocka_unit_test( test_tr50_dedup_forget_valid ),
+		cmocka_unit_test( test_tr50_dedup_open_null ),
+		cmocka_unit_test( test_tr50_dedup_open_persist ),
+	};
+	test_initialize( argc, argv );
+	result = cmocka_run_group_tests( tests, NULL, NULL );
+	test_finalize( argc, argv );
+	return result;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @brief unit testing for the pre-encoded tr50 telemetry messages
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "test_support.h"
+
+#include "api/plugin/tr50/tr50_telemetry.h"
+#include "api/public/iot_json.h"
+
+#include <string.h>
+
+/**
+ * @brief builds a complete message, as done when publishing a sample
+ *
+ * @param[out]     buf                 destination buffer
+ * @param[in]      txn                 transaction (optional)
+ * @param[in]      name                name of the telemetry object
+ * @param[in]      value               encoded value of the sample
+ * @param[in]      ts                  formatted time stamp (optional)
+ *
+ * @return the length of the message
+ */
+static size_t test_tr50_telemetry_message(
+	char *buf,
+	const iot_transaction_t *txn,
+	const char *name,
+	const char *value,
+	const char *ts )
+{
+	static const char thing_key[] = "device-app";
+	char key[ TR50_TELEMETRY_KEY_MAX ];
+	size_t key_len;
+	size_t result;
+
+	key_len = tr50_telemetry_key( key, name, strlen( name ) );
+	assert_true( key_len > 0u );
+	result = tr50_telemetry_head( buf, txn, thing_key,
+		sizeof( thing_key ) - 1u, key, key_len );
+	memcpy( &buf[result], value, strlen( value ) );
+	result += strlen( value );
+	result += tr50_telemetry_tail( &buf[result], ts,
+		ts ? strlen( ts ) : 0u );
+	return result;
+}
+
+static void test_tr50_telemetry_key_escaped( void **state )
+{
+	char key[ TR50_TELEMETRY_KEY_MAX + 1u ];
+	size_t result;
+
+	result = tr50_telemetry_key( key, "a\"b", 3u );
+	key[result] = '\0';
+	assert_string_equal( key, "\",\"key\":\"a\\\"b\",\"value\":" );
+}
+
+static void test_tr50_telemetry_key_too_long( void **state )
+{
+	char name[ TR50_TELEMETRY_KEY_MAX ];
+	char key[ TR50_TELEMETRY_KEY_MAX ];
+
+	/* each quote is escaped to two characters */
+	memset( name, '"', sizeof( name ) );
+	assert_int_equal(
+		tr50_telemetry_key( key, name, sizeof( name ) / 2u ), 0u );
+}
+
+static void test_tr50_telemetry_message_no_ts( void **state )
+{
+	char buf[256u];
+	size_t result;
+
+	result = test_tr50_telemetry_message( buf, NULL, "temp", "21.5",
+		NULL );
+	assert_string_equal( buf, "{\"cmd\":{\"command\":\"property.publish\","
+		"\"params\":{\"thingKey\":\"device-app\",\"key\":\"temp\","
+		"\"value\":21.5}}}" );
+	assert_int_equal( result, strlen( buf ) );
+}
+
+static void test_tr50_telemetry_message_ts( void **state )
+{
+	char buf[256u];
+	size_t result;
+	const iot_transaction_t txn = 42u;
+
+	result = test_tr50_telemetry_message( buf, &txn, "temp", "-3",
+		"2018-01-02T03:04:05.678Z" );
+	assert_string_equal( buf, "{\"42\":{\"command\":\"property.publish\","
+		"\"params\":{\"thingKey\":\"device-app\",\"key\":\"temp\","
+		"\"value\":-3,\"ts\":\"2018-01-02T03:04:05.678Z\"}}}" );
+	assert_int_equal( result, strlen( buf ) );
+}
+
+static void test_tr50_telemetry_message_empty_ts( void **state )
+{
+	char buf[256u];
+
+	/* a time stamp that could not be formatted is omitted */
+	test_tr50_telemetry_message( buf, NULL, "temp", "1", "" );
+	assert_null( strstr( buf, "\"ts\"" ) );
+	assert_string_equal( &buf[strlen( buf ) - 5u], ":1}}}" );
+}
+
+static void test_tr50_telemetry_message_frame_max( void **state )
+{
+	char buf[TR50_TELEMETRY_FRAME_MAX + TR50_TELEMETRY_KEY_MAX +
+		IOT_JSON_NUMBER_MAX_LEN + 16u];
+	size_t result;
+	const iot_transaction_t txn = (iot_transaction_t)-1;
+
+	/* longest frame: largest transaction id and a full time stamp */
+	result = test_tr50_telemetry_message( buf, &txn, "t", "0",
+		"2018-01-02T03:04:05.678Z" );
+	assert_true( result + 1u <= TR50_TELEMETRY_FRAME_MAX +
+		strlen( "device-app" ) + strlen( "\",\"key\":\"t\",\"value\":" ) +
+		strlen( "0" ) );
+}
+
+/* main */
+int main( int argc, char *argv[] )
+{
+	int result;
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test( test_tr50_telemetry_key_escaped ),
+		cmocka_unit_test( test_tr50_telemetry_key_too_long ),
+		cmocka_unit_test( test_tr50_telemetry_message_no_ts ),
+		cmocka_unit_test( test_tr50_telemetry_message_ts ),
+		cmocka_unit_test( test_tr50_telemetry_message_empty_ts ),
+		cmocka_unit_test( test_tr50_telemetry_message_frame_max ),
+	};
+	test_initialize( argc, argv );
+	result = cmocka_run_group_tests( tests, NULL, NULL );
+	test_finalize( argc, argv );
+	return result;
+}
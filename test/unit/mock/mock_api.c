@@ -23,17 +23,22 @@
 #include <stdarg.h>
 #include <stddef.h>
 #include <cmocka.h>
-#include <string.h> /* for strlen */
+#include <string.h> /* for strlen, strncpy */
 /* clang-format on */
 
 /* mock definitions */
 iot_status_t __wrap_iot_action_process( iot_t *lib_handle, iot_millisecond_t max_time_out );
 iot_status_t __wrap_iot_action_check( iot_t *lib_handle, iot_millisecond_t max_time_out );
 iot_status_t __wrap_iot_action_free( iot_action_t *action, iot_millisecond_t max_time_out );
+iot_status_t __wrap_iot_action_request_expire( iot_t *lib );
 iot_status_t __wrap_iot_alarm_deregister( iot_telemetry_t *alarm );
 size_t __wrap_iot_base64_encode( uint8_t *out, size_t out_len, const uint8_t *in, size_t in_len );
 size_t __wrap_iot_base64_encode_size( size_t in_bytes );
 const char *__wrap_iot_error( iot_status_t code );
+iot_status_t __wrap_iot_event_publish( iot_t *lib,
+                                       iot_transaction_t *txn,
+                                       const iot_options_t *options,
+                                       const char *message );
 iot_status_t __wrap_iot_log( iot_t *handle,
                              iot_log_level_t log_level,
                              const char *function_name,
@@ -41,6 +46,7 @@ iot_status_t __wrap_iot_log( iot_t *handle,
                              unsigned int line_number,
                              const char *log_msg_fmt,
                              ... );
+iot_status_t __wrap_iot_loop_worker_start( iot_t *lib );
 
 /* plug-in support */
 iot_status_t __wrap_iot_plugin_perform( iot_t *lib,
@@ -49,14 +55,34 @@ iot_status_t __wrap_iot_plugin_perform( iot_t *lib,
                                         iot_millisecond_t max_time_out,
                                         const void *item,
                                         const void *new_value );
+iot_status_t __wrap_iot_plugin_perform_transaction( iot_t *lib,
+                                                    iot_transaction_t *txn,
+                                                    iot_millisecond_t *max_time_out,
+                                                    iot_operation_t op,
+                                                    const void *item,
+                                                    const void *new_value,
+                                                    const iot_options_t *options );
 unsigned int __wrap_iot_plugin_builtin_load( iot_t *lib, unsigned int max );
 iot_bool_t __wrap_iot_plugin_builtin_enable( iot_t *lib );
 iot_status_t __wrap_iot_plugin_disable_all( iot_t *lib );
 iot_status_t __wrap_iot_plugin_enable( iot_t *lib, const char *name );
 void __wrap_iot_plugin_initialize( iot_plugin_t *p );
 void __wrap_iot_plugin_terminate( iot_plugin_t *p );
+iot_status_t __wrap_iot_spawn_helper_start( iot_t *lib );
+iot_status_t __wrap_iot_spawn_helper_stop( iot_t *lib );
+iot_status_t __wrap_iot_spawn_run( iot_t *lib, struct iot_spawn_args *args );
 iot_status_t __wrap_iot_telemetry_free( iot_telemetry_t *telemetry,
 	iot_millisecond_t max_time_out );
+iot_status_t __wrap_iot_telemetry_publish_start( iot_t *lib,
+	iot_uint32_t queue_max, iot_bool_t block );
+iot_status_t __wrap_iot_telemetry_publish_stop( iot_t *lib );
+iot_status_t __wrap_iot_telemetry_reduce_flush( iot_t *lib,
+	iot_bool_t force, iot_millisecond_t max_time_out );
+iot_transaction_t __wrap_iot_transaction_allocate( iot_t *lib );
+void __wrap_iot_transaction_finish( iot_t *lib, iot_transaction_t txn,
+	iot_status_t status );
+void __wrap_iot_transaction_status_set( iot_t *lib, iot_transaction_t txn,
+	iot_status_t status );
 
 /* mock iot_json functions */
 iot_status_t __wrap_iot_json_decode_bool(
@@ -96,6 +122,14 @@ iot_status_t __wrap_iot_json_decode_parse(
 	iot_json_item_t **root,
 	char *error,
 	size_t error_len );
+iot_status_t __wrap_iot_json_decode_parse_chunk(
+	iot_json_decoder_t *json,
+	const char* js,
+	size_t len,
+	iot_bool_t more,
+	iot_json_item_t **root,
+	char *error,
+	size_t error_len );
 iot_status_t __wrap_iot_json_decode_real(
 	const iot_json_decoder_t *json,
 	const iot_json_item_t *item,
@@ -131,6 +165,11 @@ iot_status_t __wrap_iot_action_free( iot_action_t *action, iot_millisecond_t max
 	return mock_type( iot_status_t );
 }
 
+iot_status_t __wrap_iot_action_request_expire( iot_t *lib )
+{
+	return mock_type( iot_status_t );
+}
+
 iot_status_t __wrap_iot_alarm_deregister( iot_telemetry_t *alarm )
 {
 	return mock_type( iot_status_t );
@@ -163,6 +202,15 @@ const char *__wrap_iot_error( iot_status_t code )
 	return (char *)mock();
 }
 
+iot_status_t __wrap_iot_event_publish( iot_t *lib,
+                                       iot_transaction_t *txn,
+                                       const iot_options_t *options,
+                                       const char *message )
+{
+	check_expected( message );
+	return IOT_STATUS_SUCCESS;
+}
+
 iot_status_t __wrap_iot_log( iot_t *handle,
                              iot_log_level_t log_level,
                              const char *function_name,
@@ -174,6 +222,12 @@ iot_status_t __wrap_iot_log( iot_t *handle,
 	return IOT_STATUS_FAILURE;
 }
 
+iot_status_t __wrap_iot_loop_worker_start( iot_t *lib )
+{
+	assert_non_null( lib );
+	return mock_type( iot_status_t );
+}
+
 iot_status_t __wrap_iot_plugin_perform( iot_t *lib,
                                         iot_transaction_t *txn,
                                         iot_operation_t op,
@@ -184,6 +238,17 @@ iot_status_t __wrap_iot_plugin_perform( iot_t *lib,
 	return (iot_status_t)mock();
 }
 
+iot_status_t __wrap_iot_plugin_perform_transaction( iot_t *lib,
+                                                    iot_transaction_t *txn,
+                                                    iot_millisecond_t *max_time_out,
+                                                    iot_operation_t op,
+                                                    const void *item,
+                                                    const void *new_value,
+                                                    const iot_options_t *options )
+{
+	return (iot_status_t)mock();
+}
+
 unsigned int __wrap_iot_plugin_builtin_load( iot_t *lib, unsigned int max )
 {
 	lib->plugin_count = mock_type( unsigned int );
@@ -213,12 +278,78 @@ void __wrap_iot_plugin_terminate( iot_plugin_t *p )
 {
 }
 
+iot_status_t __wrap_iot_spawn_helper_start( iot_t *lib )
+{
+	return mock_type( iot_status_t );
+}
+
+iot_status_t __wrap_iot_spawn_helper_stop( iot_t *lib )
+{
+	return IOT_STATUS_SUCCESS;
+}
+
+iot_status_t __wrap_iot_spawn_run( iot_t *lib, struct iot_spawn_args *args )
+{
+	iot_status_t result;
+	const char *std_out;
+	size_t i;
+
+	for ( i = 0u; args->argv[i]; ++i )
+		check_expected( args->argv[i] );
+	args->return_code = mock_type( int );
+	std_out = mock_type( const char * );
+	if ( args->std_out && args->std_out_len > 0u )
+	{
+		strncpy( args->std_out, std_out, args->std_out_len - 1u );
+		args->std_out[args->std_out_len - 1u] = '\0';
+	}
+	if ( args->output && std_out )
+		args->output( args->user_data, IOT_FALSE, std_out,
+			strlen( std_out ) );
+	if ( args->std_err && args->std_err_len > 0u )
+		args->std_err[0] = '\0';
+	result = mock_type( iot_status_t );
+	return result;
+}
+
 iot_status_t __wrap_iot_telemetry_free( iot_telemetry_t *telemetry,
 	iot_millisecond_t max_time_out )
 {
 	return mock_type( iot_status_t );
 }
 
+iot_status_t __wrap_iot_telemetry_publish_start( iot_t *lib,
+	iot_uint32_t queue_max, iot_bool_t block )
+{
+	return IOT_STATUS_SUCCESS;
+}
+
+iot_status_t __wrap_iot_telemetry_publish_stop( iot_t *lib )
+{
+	return IOT_STATUS_SUCCESS;
+}
+
+iot_status_t __wrap_iot_telemetry_reduce_flush( iot_t *lib,
+	iot_bool_t force, iot_millisecond_t max_time_out )
+{
+	return IOT_STATUS_SUCCESS;
+}
+
+iot_transaction_t __wrap_iot_transaction_allocate( iot_t *lib )
+{
+	return ++lib->transaction_count;
+}
+
+void __wrap_iot_transaction_finish( iot_t *lib, iot_transaction_t txn,
+	iot_status_t status )
+{
+}
+
+void __wrap_iot_transaction_status_set( iot_t *lib, iot_transaction_t txn,
+	iot_status_t status )
+{
+}
+
 iot_status_t __wrap_iot_json_decode_bool(
 	const iot_json_decoder_t *json,
 	const iot_json_item_t *item,
@@ -300,6 +431,21 @@ iot_status_t __wrap_iot_json_decode_parse(
 	return IOT_STATUS_SUCCESS;
 }
 
+iot_status_t __wrap_iot_json_decode_parse_chunk(
+	iot_json_decoder_t *json,
+	const char* js,
+	size_t len,
+	iot_bool_t more,
+	iot_json_item_t **root,
+	char *error,
+	size_t error_len )
+{
+	iot_status_t result = IOT_STATUS_SUCCESS;
+	if ( more != IOT_FALSE )
+		result = IOT_STATUS_TRY_AGAIN;
+	return result;
+}
+
 iot_status_t __wrap_iot_json_decode_real(
 	const iot_json_decoder_t *json,
 	const iot_json_item_t *item,
@@ -18,27 +18,41 @@ set( MOCK_API_FUNC
 	"iot_action_process"
 	"iot_action_check"
 	"iot_action_free"
+	"iot_action_request_expire"
 	"iot_alarm_deregister"
 	"iot_base64_encode"
 	"iot_base64_encode_size"
 	"iot_error"
+	"iot_event_publish"
 	"iot_log"
+	"iot_loop_worker_start"
 	"iot_protocol"
 	"iot_log"
 	"iot_plugin_perform"
+	"iot_plugin_perform_transaction"
 	"iot_plugin_builtin_load"
 	"iot_plugin_builtin_enable"
 	"iot_plugin_disable_all"
 	"iot_plugin_enable"
 	"iot_plugin_initialize"
 	"iot_plugin_terminate"
+	"iot_spawn_helper_start"
+	"iot_spawn_helper_stop"
+	"iot_spawn_run"
 	"iot_telemetry_free"
+	"iot_telemetry_publish_start"
+	"iot_telemetry_publish_stop"
+	"iot_telemetry_reduce_flush"
+	"iot_transaction_allocate"
+	"iot_transaction_finish"
+	"iot_transaction_status_set"
 
 	"iot_json_decode_array_at"
 	"iot_json_decode_array_iterator"
 	"iot_json_decode_array_iterator_next"
 	"iot_json_decode_array_iterator_value"
 	"iot_json_decode_array_size"
+	"iot_json_decode_bind"
 	"iot_json_decode_bool"
 	"iot_json_decode_initialize"
 	"iot_json_decode_integer"
@@ -50,6 +64,7 @@ set( MOCK_API_FUNC
 	"iot_json_decode_object_iterator_value"
 	"iot_json_decode_object_size"
 	"iot_json_decode_parse"
+	"iot_json_decode_parse_chunk"
 	"iot_json_decode_real"
 	"iot_json_decode_string"
 	"iot_json_decode_terminate"
@@ -90,6 +90,10 @@ os_status_t __wrap_os_thread_condition_destroy( os_thread_condition_t *cond );
 os_status_t __wrap_os_thread_condition_signal(
 	os_thread_condition_t *cond,
 	os_thread_mutex_t *lock );
+os_status_t __wrap_os_thread_condition_timed_wait(
+	os_thread_condition_t *cond,
+	os_thread_mutex_t *lock,
+	os_millisecond_t max_time_out );
 os_status_t __wrap_os_thread_condition_wait(
 	os_thread_condition_t *cond,
 	os_thread_mutex_t *lock );
@@ -723,6 +727,17 @@ os_status_t __wrap_os_thread_condition_signal(
 	return OS_STATUS_FAILURE;
 }
 
+os_status_t __wrap_os_thread_condition_timed_wait(
+	os_thread_condition_t *cond,
+	os_thread_mutex_t *lock,
+	os_millisecond_t max_time_out )
+{
+	/* ensure this function is called meeting pre-requirements */
+	assert_non_null( cond );
+	assert_non_null( lock );
+	return OS_STATUS_FAILURE;
+}
+
 os_status_t __wrap_os_thread_condition_wait(
 	os_thread_condition_t *cond,
 	os_thread_mutex_t *lock )
@@ -68,6 +68,7 @@ set( MOCK_OSAL_FUNC
 	"os_thread_condition_create"
 	"os_thread_condition_destroy"
 	"os_thread_condition_signal"
+	"os_thread_condition_timed_wait"
 	"os_thread_condition_wait"
 	"os_thread_create"
 	"os_thread_destroy"
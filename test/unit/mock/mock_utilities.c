@@ -66,6 +66,14 @@ iot_status_t __wrap_app_json_decode_parse(
 	app_json_item_t **root,
 	char *error,
 	size_t error_len );
+iot_status_t __wrap_app_json_decode_parse_chunk(
+	app_json_decoder_t *json,
+	const char* js,
+	size_t len,
+	iot_bool_t more,
+	app_json_item_t **root,
+	char *error,
+	size_t error_len );
 iot_status_t __wrap_app_json_decode_real(
 	const app_json_decoder_t *json,
 	const app_json_item_t *item,
@@ -140,6 +148,13 @@ iot_status_t __wrap_app_json_encode_real(
 	const app_json_encoder_t *json,
 	const char* key,
 	iot_float64_t value);
+iot_status_t __wrap_app_json_encode_real_precision(
+	const app_json_encoder_t *json,
+	const char* key,
+	iot_float64_t value,
+	int precision);
+iot_status_t __wrap_app_json_encode_reset(
+	const app_json_encoder_t *json );
 iot_status_t __wrap_app_json_encode_string(
 	const app_json_encoder_t *json,
 	const char* key,
@@ -157,6 +172,10 @@ app_json_encoder_t *__wrap_app_json_encode_initialize(
 	unsigned int flags);
 void __wrap_app_json_encode_terminate(
 	const app_json_encoder_t *json );
+iot_status_t __wrap_app_json_encode_unsigned(
+	const app_json_encoder_t *json,
+	const char* key,
+	iot_uint64_t value);
 
 /* mock functions */
 /* mock app_json_decode functions */
@@ -242,6 +261,18 @@ iot_status_t __wrap_app_json_decode_parse(
 	return IOT_STATUS_SUCCESS;
 }
 
+iot_status_t __wrap_app_json_decode_parse_chunk(
+	app_json_decoder_t *json,
+	const char* js,
+	size_t len,
+	iot_bool_t more,
+	app_json_item_t **root,
+	char *error,
+	size_t error_len )
+{
+	return IOT_STATUS_SUCCESS;
+}
+
 iot_status_t __wrap_app_json_decode_real(
 	const app_json_decoder_t *json,
 	const app_json_item_t *item,
@@ -403,6 +434,21 @@ iot_status_t __wrap_app_json_encode_real(
 	return IOT_STATUS_SUCCESS;
 }
 
+iot_status_t __wrap_app_json_encode_real_precision(
+	const app_json_encoder_t *json,
+	const char* key,
+	iot_float64_t value,
+	int precision)
+{
+	return IOT_STATUS_SUCCESS;
+}
+
+iot_status_t __wrap_app_json_encode_reset(
+	const app_json_encoder_t *json )
+{
+	return IOT_STATUS_SUCCESS;
+}
+
 iot_status_t __wrap_app_json_encode_string(
 	const app_json_encoder_t *json,
 	const char* key,
@@ -444,3 +490,11 @@ void __wrap_app_json_encode_terminate(
 {
 }
 
+iot_status_t __wrap_app_json_encode_unsigned(
+	const app_json_encoder_t *json,
+	const char* key,
+	iot_uint64_t value)
+{
+	return IOT_STATUS_SUCCESS;
+}
+
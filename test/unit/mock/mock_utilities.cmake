@@ -32,6 +32,7 @@ set( MOCK_UTILITIES_FUNC
 	"app_json_decode_object_iterator_value"
 	"app_json_decode_object_size"
 	"app_json_decode_parse"
+	"app_json_decode_parse_chunk"
 	"app_json_decode_real"
 	"app_json_decode_string"
 	"app_json_decode_terminate"
@@ -44,11 +45,14 @@ set( MOCK_UTILITIES_FUNC
 	"app_json_encode_bool"
 	"app_json_encode_integer"
 	"app_json_encode_real"
+	"app_json_encode_real_precision"
+	"app_json_encode_reset"
 	"app_json_encode_string"
 	"app_json_encode_array_start"
 	"app_json_encode_array_end"
 	"app_json_encode_dump"
 	"app_json_encode_initialize"
 	"app_json_encode_terminate"
+	"app_json_encode_unsigned"
 )
 
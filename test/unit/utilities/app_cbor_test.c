@@ -0,0 +1,385 @@
+/**
+ * @file
+ * @brief unit testing for IoT library (cbor encoding & decoding support)
+ *
+ * @copyright Copyright (C) 2018 Wind River Systems, Inc. All Rights Reserved.
+ *
+ * @license Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+ * OR CONDITIONS OF ANY KIND, either express or implied."
+ */
+
+#include "test_support.h"
+
+#include "utilities/app_cbor.h"
+
+#include <stdint.h> /* for INT64_MIN, UINT64_MAX */
+#include <string.h>
+
+static void test_app_cbor_decode_half_float( void **state )
+{
+	/* 0xf93c00 = 1.0, 0xf9c400 = -4.0 (RFC 7049, appendix A) */
+	const iot_uint8_t buf[] = { 0xf9, 0x3c, 0x00, 0xf9, 0xc4, 0x00 };
+	app_cbor_decoder_t dec;
+	app_cbor_item_t item;
+	iot_status_t result;
+
+	app_cbor_decode_initialize( &dec, buf, sizeof( buf ) );
+	result = app_cbor_decode_next( &dec, &item );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( item.type, APP_CBOR_TYPE_REAL );
+	assert_true( item.value.float64 > 0.999 && item.value.float64 < 1.001 );
+	result = app_cbor_decode_next( &dec, &item );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_true( item.value.float64 > -4.001 && item.value.float64 < -3.999 );
+	result = app_cbor_decode_next( &dec, &item );
+	assert_int_equal( result, IOT_STATUS_NOT_FOUND );
+}
+
+static void test_app_cbor_decode_integer_limits( void **state )
+{
+	const iot_uint8_t buf[] = {
+		0x3b, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, /* INT64_MIN */
+		0x1b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff  /* UINT64_MAX */
+	};
+	app_cbor_decoder_t dec;
+	app_cbor_item_t item;
+	iot_int64_t value = 0;
+	iot_status_t result;
+
+	app_cbor_decode_initialize( &dec, buf, sizeof( buf ) );
+	result = app_cbor_decode_next( &dec, &item );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( item.type, APP_CBOR_TYPE_NEGATIVE );
+	result = app_cbor_decode_integer( &item, &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_true( value == INT64_MIN );
+
+	result = app_cbor_decode_next( &dec, &item );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( item.type, APP_CBOR_TYPE_UNSIGNED );
+	assert_true( item.value.uint64 == UINT64_MAX );
+	result = app_cbor_decode_integer( &item, &value );
+	assert_int_equal( result, IOT_STATUS_OUT_OF_RANGE );
+}
+
+static void test_app_cbor_decode_map_find_missing( void **state )
+{
+	/* {"a": 1, "b": [2, 3]} */
+	const iot_uint8_t buf[] = {
+		0xa2, 0x61, 'a', 0x01, 0x61, 'b', 0x82, 0x02, 0x03 };
+	app_cbor_decoder_t dec;
+	app_cbor_item_t map;
+	app_cbor_item_t value;
+	iot_status_t result;
+	size_t pos;
+
+	app_cbor_decode_initialize( &dec, buf, sizeof( buf ) );
+	result = app_cbor_decode_next( &dec, &map );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( map.type, APP_CBOR_TYPE_MAP );
+	assert_int_equal( map.count, 2u );
+	pos = dec.pos;
+
+	result = app_cbor_decode_map_find( &dec, &map, "c", &value );
+	assert_int_equal( result, IOT_STATUS_NOT_FOUND );
+	assert_int_equal( dec.pos, pos );
+
+	result = app_cbor_decode_map_find( &dec, &map, "b", &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value.type, APP_CBOR_TYPE_ARRAY );
+	assert_int_equal( value.count, 2u );
+}
+
+static void test_app_cbor_decode_null_decoder( void **state )
+{
+	app_cbor_item_t item;
+	iot_status_t result;
+
+	result = app_cbor_decode_next( NULL, &item );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+static void test_app_cbor_decode_truncated( void **state )
+{
+	/* 4-byte unsigned integer with only 2 bytes of data */
+	const iot_uint8_t buf[] = { 0x1a, 0x00, 0x0f };
+	/* 5-byte text string with only 2 bytes of data */
+	const iot_uint8_t str[] = { 0x65, 'h', 'e' };
+	app_cbor_decoder_t dec;
+	app_cbor_item_t item;
+	iot_status_t result;
+
+	app_cbor_decode_initialize( &dec, buf, sizeof( buf ) );
+	result = app_cbor_decode_next( &dec, &item );
+	assert_int_equal( result, IOT_STATUS_PARSE_ERROR );
+
+	app_cbor_decode_initialize( &dec, str, sizeof( str ) );
+	result = app_cbor_decode_next( &dec, &item );
+	assert_int_equal( result, IOT_STATUS_PARSE_ERROR );
+}
+
+static void test_app_cbor_encode_decode_round_trip( void **state )
+{
+	iot_uint8_t buf[ 128u ];
+	app_cbor_encoder_t enc;
+	app_cbor_decoder_t dec;
+	app_cbor_item_t map;
+	app_cbor_item_t value;
+	iot_int64_t integer = 0;
+	const iot_uint8_t raw[] = { 0x00, 0xff, 0x10 };
+	iot_status_t result;
+
+	app_cbor_encode_initialize( &enc, buf, sizeof( buf ), 0u );
+	assert_int_equal( app_cbor_encode_map_start( &enc,
+		APP_CBOR_INDEFINITE ), IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_string( &enc, "key" ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_string( &enc, "temperature" ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_string( &enc, "value" ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_integer( &enc, -42 ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_string( &enc, "raw" ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_bytes( &enc, raw, sizeof( raw ) ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_string( &enc, "ok" ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_bool( &enc, IOT_TRUE ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_end( &enc ), IOT_STATUS_SUCCESS );
+
+	app_cbor_decode_initialize( &dec, enc.buf, enc.len );
+	result = app_cbor_decode_next( &dec, &map );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( map.type, APP_CBOR_TYPE_MAP );
+	assert_int_equal( map.count, APP_CBOR_INDEFINITE );
+
+	result = app_cbor_decode_map_find( &dec, &map, "value", &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_cbor_decode_integer( &value, &integer );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( integer, -42 );
+
+	app_cbor_decode_initialize( &dec, enc.buf, enc.len );
+	app_cbor_decode_next( &dec, &map );
+	result = app_cbor_decode_map_find( &dec, &map, "key", &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_true( app_cbor_decode_string_equal( &value, "temperature" ) );
+	assert_false( app_cbor_decode_string_equal( &value, "temp" ) );
+
+	app_cbor_decode_initialize( &dec, enc.buf, enc.len );
+	app_cbor_decode_next( &dec, &map );
+	result = app_cbor_decode_map_find( &dec, &map, "raw", &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value.type, APP_CBOR_TYPE_BYTES );
+	assert_int_equal( value.count, sizeof( raw ) );
+	assert_memory_equal( value.value.ptr, raw, sizeof( raw ) );
+
+	app_cbor_decode_initialize( &dec, enc.buf, enc.len );
+	app_cbor_decode_next( &dec, &map );
+	result = app_cbor_decode_map_find( &dec, &map, "ok", &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value.type, APP_CBOR_TYPE_BOOL );
+	assert_int_equal( value.value.boolean, IOT_TRUE );
+}
+
+static void test_app_cbor_encode_dynamic_grow( void **state )
+{
+#if !defined( IOT_STACK_ONLY )
+	app_cbor_encoder_t enc;
+	unsigned int i;
+	iot_status_t result;
+
+	will_return_always( __wrap_os_realloc, 1 );
+	app_cbor_encode_initialize( &enc, NULL, 0u, APP_CBOR_FLAG_DYNAMIC );
+	result = app_cbor_encode_array_start( &enc, 100u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	for ( i = 0u; i < 100u; ++i )
+	{
+		result = app_cbor_encode_unsigned( &enc, 1000000u );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+	}
+	/* 2-byte array header + 100 * 5-byte integers */
+	assert_int_equal( enc.len, 502u );
+	assert_true( enc.size >= enc.len );
+	assert_int_equal( enc.buf[0], 0x98 );
+	assert_int_equal( enc.buf[1], 100 );
+	app_cbor_encode_terminate( &enc );
+	assert_null( enc.buf );
+#endif /* if !defined( IOT_STACK_ONLY ) */
+}
+
+static void test_app_cbor_encode_full( void **state )
+{
+	iot_uint8_t buf[ 4u ];
+	app_cbor_encoder_t enc;
+	iot_status_t result;
+
+	app_cbor_encode_initialize( &enc, buf, sizeof( buf ), 0u );
+	result = app_cbor_encode_string( &enc, "IETF" );
+	assert_int_equal( result, IOT_STATUS_FULL );
+	assert_int_equal( enc.len, 0u );
+
+	result = app_cbor_encode_unsigned( &enc, 1000000u );
+	assert_int_equal( result, IOT_STATUS_FULL );
+	assert_int_equal( enc.len, 0u );
+
+	result = app_cbor_encode_unsigned( &enc, 1000u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( enc.len, 3u );
+}
+
+static void test_app_cbor_encode_integer( void **state )
+{
+	/* RFC 7049, appendix A */
+	const iot_uint8_t expected[] = {
+		0x20,                                     /* -1 */
+		0x29,                                     /* -10 */
+		0x38, 0x63,                               /* -100 */
+		0x39, 0x03, 0xe7,                         /* -1000 */
+		0x3b, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, /* INT64_MIN */
+		0x18, 0x64                                /* 100 */
+	};
+	iot_uint8_t buf[ 32u ];
+	app_cbor_encoder_t enc;
+
+	app_cbor_encode_initialize( &enc, buf, sizeof( buf ), 0u );
+	assert_int_equal( app_cbor_encode_integer( &enc, -1 ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_integer( &enc, -10 ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_integer( &enc, -100 ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_integer( &enc, -1000 ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_integer( &enc, INT64_MIN ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_integer( &enc, 100 ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( enc.len, sizeof( expected ) );
+	assert_memory_equal( buf, expected, sizeof( expected ) );
+}
+
+static void test_app_cbor_encode_null_encoder( void **state )
+{
+	iot_status_t result;
+
+	result = app_cbor_encode_unsigned( NULL, 1u );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_cbor_encode_string( NULL, "a" );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+static void test_app_cbor_encode_real( void **state )
+{
+	/* RFC 7049, appendix A: 1.5 fits a float, 1.1 needs a double */
+	const iot_uint8_t expected[] = {
+		0xfa, 0x3f, 0xc0, 0x00, 0x00,
+		0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a
+	};
+	iot_uint8_t buf[ 32u ];
+	app_cbor_encoder_t enc;
+
+	app_cbor_encode_initialize( &enc, buf, sizeof( buf ), 0u );
+	assert_int_equal( app_cbor_encode_real( &enc, 1.5 ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_real( &enc, 1.1 ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( enc.len, sizeof( expected ) );
+	assert_memory_equal( buf, expected, sizeof( expected ) );
+}
+
+static void test_app_cbor_encode_reset( void **state )
+{
+	iot_uint8_t buf[ 16u ];
+	app_cbor_encoder_t enc;
+
+	app_cbor_encode_initialize( &enc, buf, sizeof( buf ), 0u );
+	assert_int_equal( app_cbor_encode_null( &enc ), IOT_STATUS_SUCCESS );
+	assert_int_equal( enc.len, 1u );
+	assert_int_equal( buf[0], 0xf6 );
+	app_cbor_encode_reset( &enc );
+	assert_int_equal( enc.len, 0u );
+	assert_ptr_equal( enc.buf, buf );
+}
+
+static void test_app_cbor_encode_string( void **state )
+{
+	const iot_uint8_t expected[] = { 0x64, 'I', 'E', 'T', 'F', 0x60 };
+	iot_uint8_t buf[ 16u ];
+	app_cbor_encoder_t enc;
+
+	app_cbor_encode_initialize( &enc, buf, sizeof( buf ), 0u );
+	assert_int_equal( app_cbor_encode_string( &enc, "IETF" ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_string( &enc, "" ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( enc.len, sizeof( expected ) );
+	assert_memory_equal( buf, expected, sizeof( expected ) );
+}
+
+static void test_app_cbor_encode_unsigned( void **state )
+{
+	/* RFC 7049, appendix A */
+	const iot_uint8_t expected[] = {
+		0x00,                                     /* 0 */
+		0x17,                                     /* 23 */
+		0x18, 0x18,                               /* 24 */
+		0x19, 0x03, 0xe8,                         /* 1000 */
+		0x1a, 0x00, 0x0f, 0x42, 0x40,             /* 1000000 */
+		0x1b, 0x00, 0x00, 0x00, 0xe8, 0xd4, 0xa5, 0x10, 0x00 /* 10^12 */
+	};
+	iot_uint8_t buf[ 32u ];
+	app_cbor_encoder_t enc;
+
+	app_cbor_encode_initialize( &enc, buf, sizeof( buf ), 0u );
+	assert_int_equal( app_cbor_encode_unsigned( &enc, 0u ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_unsigned( &enc, 23u ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_unsigned( &enc, 24u ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_unsigned( &enc, 1000u ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_unsigned( &enc, 1000000u ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( app_cbor_encode_unsigned( &enc, 1000000000000u ),
+		IOT_STATUS_SUCCESS );
+	assert_int_equal( enc.len, sizeof( expected ) );
+	assert_memory_equal( buf, expected, sizeof( expected ) );
+}
+
+/* main */
+int main( int argc, char *argv[] )
+{
+	int result;
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test( test_app_cbor_decode_half_float ),
+		cmocka_unit_test( test_app_cbor_decode_integer_limits ),
+		cmocka_unit_test( test_app_cbor_decode_map_find_missing ),
+		cmocka_unit_test( test_app_cbor_decode_null_decoder ),
+		cmocka_unit_test( test_app_cbor_decode_truncated ),
+		cmocka_unit_test( test_app_cbor_encode_decode_round_trip ),
+		cmocka_unit_test( test_app_cbor_encode_dynamic_grow ),
+		cmocka_unit_test( test_app_cbor_encode_full ),
+		cmocka_unit_test( test_app_cbor_encode_integer ),
+		cmocka_unit_test( test_app_cbor_encode_null_encoder ),
+		cmocka_unit_test( test_app_cbor_encode_real ),
+		cmocka_unit_test( test_app_cbor_encode_reset ),
+		cmocka_unit_test( test_app_cbor_encode_string ),
+		cmocka_unit_test( test_app_cbor_encode_unsigned )
+	};
+	test_initialize( argc, argv );
+	result = cmocka_run_group_tests( tests, NULL, NULL );
+	test_finalize( argc, argv );
+	return result;
+}
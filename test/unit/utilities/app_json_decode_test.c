@@ -463,6 +463,147 @@ static void test_app_json_decode_array_size_valid( void **state )
 	app_json_decode_terminate( decoder );
 }
 
+/* structure and fields used by the binding tests */
+struct test_bind
+{
+	iot_bool_t success;
+	iot_int64_t count;
+	iot_float64_t ratio;
+	char name[8u];
+	char method[16u];
+	const app_json_item_t *params;
+	const app_json_item_t *list;
+};
+
+static const app_json_bind_t TEST_BIND_PARAMS[] = {
+	APP_JSON_BIND_FIELD( "method", APP_JSON_BIND_STRING,
+		APP_JSON_BIND_REQUIRED, struct test_bind, method ),
+	APP_JSON_BIND_FIELD( "ratio", APP_JSON_BIND_REAL, 0u,
+		struct test_bind, ratio )
+};
+
+static const app_json_bind_t TEST_BIND_FIELDS[] = {
+	APP_JSON_BIND_FIELD( "success", APP_JSON_BIND_BOOL,
+		APP_JSON_BIND_REQUIRED, struct test_bind, success ),
+	APP_JSON_BIND_FIELD( "count", APP_JSON_BIND_INTEGER, 0u,
+		struct test_bind, count ),
+	APP_JSON_BIND_FIELD( "name", APP_JSON_BIND_STRING, 0u,
+		struct test_bind, name ),
+	APP_JSON_BIND_FIELD( "params", APP_JSON_BIND_ITEM, 0u,
+		struct test_bind, params ),
+	APP_JSON_BIND_NESTED( "params", 0u, TEST_BIND_PARAMS ),
+	APP_JSON_BIND_FIELD( "list", APP_JSON_BIND_ITEM, 0u,
+		struct test_bind, list )
+};
+
+static void test_app_json_decode_bind_missing_required( void **state )
+{
+	char buf[512u];
+	char json[256u];
+	app_json_decoder_t *decoder;
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+	struct test_bind out;
+
+	/* "method" is required in "params", "success" has another type */
+	snprintf( json, 256u, "{"
+		"\"success\":\"true\","
+		"\"count\":3,"
+		"\"params\":{\"ratio\":0.5}"
+		"}" );
+	decoder = app_json_decode_initialize( buf, 512u, 0u );
+	assert_non_null( decoder );
+	result = app_json_decode_parse( decoder, json, strlen(json), &root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	memset( &out, 0, sizeof( out ) );
+	result = app_json_decode_bind( decoder, root, TEST_BIND_FIELDS,
+		sizeof( TEST_BIND_FIELDS ) / sizeof( TEST_BIND_FIELDS[0] ), &out );
+	assert_int_equal( result, IOT_STATUS_NOT_FOUND );
+	assert_int_equal( out.success, IOT_FALSE );
+	assert_int_equal( out.count, 3 );
+	assert_non_null( out.params );
+	assert_true( out.ratio > 0.49 && out.ratio < 0.51 );
+
+	result = app_json_decode_bind( decoder, out.params, TEST_BIND_PARAMS,
+		sizeof( TEST_BIND_PARAMS ) / sizeof( TEST_BIND_PARAMS[0] ), &out );
+	assert_int_equal( result, IOT_STATUS_NOT_FOUND );
+	app_json_decode_terminate( decoder );
+}
+
+static void test_app_json_decode_bind_not_object( void **state )
+{
+	char buf[512u];
+	char json[256u];
+	app_json_decoder_t *decoder;
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+	struct test_bind out;
+
+	snprintf( json, 256u, "[{\"success\":true}]" );
+	decoder = app_json_decode_initialize( buf, 512u, 0u );
+	assert_non_null( decoder );
+	result = app_json_decode_parse( decoder, json, strlen(json), &root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	memset( &out, 0, sizeof( out ) );
+	result = app_json_decode_bind( decoder, root, TEST_BIND_FIELDS,
+		sizeof( TEST_BIND_FIELDS ) / sizeof( TEST_BIND_FIELDS[0] ), &out );
+	assert_int_equal( result, IOT_STATUS_BAD_REQUEST );
+	assert_int_equal( out.success, IOT_FALSE );
+	app_json_decode_terminate( decoder );
+}
+
+static void test_app_json_decode_bind_null_json( void **state )
+{
+	iot_status_t result;
+	struct test_bind out;
+	const app_json_item_t *const item = (const app_json_item_t *)0x1;
+
+	result = app_json_decode_bind( NULL, item, TEST_BIND_FIELDS,
+		sizeof( TEST_BIND_FIELDS ) / sizeof( TEST_BIND_FIELDS[0] ), &out );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+static void test_app_json_decode_bind_valid( void **state )
+{
+	char buf[1024u];
+	char json[256u];
+	app_json_decoder_t *decoder;
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+	struct test_bind out;
+
+	snprintf( json, 256u, "{"
+		"\"other\":{\"success\":false},"
+		"\"name\":\"longer than the name\","
+		"\"params\":{\"method\":\"set_led\",\"ratio\":2},"
+		"\"success\":true,"
+		"\"count\":-12,"
+		"\"list\":[1,2,3]"
+		"}" );
+	decoder = app_json_decode_initialize( buf, 1024u, 0u );
+	assert_non_null( decoder );
+	result = app_json_decode_parse( decoder, json, strlen(json), &root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	memset( &out, 0, sizeof( out ) );
+	result = app_json_decode_bind( decoder, root, TEST_BIND_FIELDS,
+		sizeof( TEST_BIND_FIELDS ) / sizeof( TEST_BIND_FIELDS[0] ), &out );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( out.success, IOT_TRUE );
+	assert_int_equal( out.count, -12 );
+	assert_string_equal( out.name, "longer " );
+	assert_string_equal( out.method, "set_led" );
+	assert_true( out.ratio > 1.99 && out.ratio < 2.01 );
+	assert_ptr_equal( out.params,
+		app_json_decode_object_find( decoder, root, "params" ) );
+	assert_ptr_equal( out.list,
+		app_json_decode_object_find( decoder, root, "list" ) );
+	assert_int_equal( app_json_decode_array_size( decoder, out.list ), 3u );
+	app_json_decode_terminate( decoder );
+}
+
 static void test_app_json_decode_bool_null_item( void **state )
 {
 	app_json_decoder_t *json = (app_json_decoder_t*)0x1;
@@ -788,6 +929,115 @@ static void test_app_json_decode_object_find_valid( void **state )
 	app_json_decode_terminate( decoder );
 }
 
+static void test_app_json_decode_object_find_many_keys( void **state )
+{
+	char json[1024u];
+	app_json_decoder_t *decoder;
+#ifndef IOT_STACK_ONLY
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+	const app_json_item_t *item;
+	iot_int64_t value = 0;
+	size_t i;
+	size_t len;
+	will_return_always( __wrap_os_realloc, 1 );
+#endif
+
+	/* enough keys for a table of them to be built */
+	snprintf( json, 1024u, "{\"nested\":{\"key3\":-1}" );
+#ifndef IOT_STACK_ONLY
+	len = strlen( json );
+	for ( i = 0u; i < 24u; ++i )
+		len += (size_t)snprintf( &json[len], 1024u - len,
+			",\"key%u\":%u", (unsigned int)i, (unsigned int)i );
+	snprintf( &json[len], 1024u - len, ",\"key3\":-2}" );
+#endif
+#ifdef IOT_STACK_ONLY
+	decoder = app_json_decode_initialize( NULL, 0u, 0u );
+	assert_null( decoder );
+#else
+	decoder = app_json_decode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+	assert_non_null( decoder );
+	result = app_json_decode_parse( decoder, json, strlen(json), &root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_non_null( root );
+
+	for ( i = 0u; i < 24u; ++i )
+	{
+		char key[8u];
+		snprintf( key, 8u, "key%u", (unsigned int)i );
+		item = app_json_decode_object_find( decoder, root, key );
+		assert_non_null( item );
+		result = app_json_decode_integer( decoder, item, &value );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+		assert_int_equal( value, (iot_int64_t)i );
+	}
+	item = app_json_decode_object_find_len( decoder, root, "key12345", 5u );
+	assert_non_null( item );
+	result = app_json_decode_integer( decoder, item, &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value, 12 );
+	assert_null( app_json_decode_object_find( decoder, root, "key" ) );
+	assert_null( app_json_decode_object_find( decoder, root, "key24" ) );
+
+	/* another document, the keys are at different tokens */
+	len = (size_t)snprintf( json, 1024u, "{\"extra\":[1,2,3,4,5]" );
+	for ( i = 0u; i < 24u; ++i )
+		len += (size_t)snprintf( &json[len], 1024u - len,
+			",\"key%u\":%u", (unsigned int)i, (unsigned int)i * 2u );
+	snprintf( &json[len], 1024u - len, "}" );
+	result = app_json_decode_parse( decoder, json, strlen(json), &root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	item = app_json_decode_object_find( decoder, root, "key23" );
+	assert_non_null( item );
+	result = app_json_decode_integer( decoder, item, &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value, 46 );
+	app_json_decode_terminate( decoder );
+#endif
+}
+
+static void test_app_json_decode_object_find_nested( void **state )
+{
+	char buf[512u];
+	char json[256u];
+	app_json_decoder_t *decoder;
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+	const app_json_item_t *item;
+	const char *value = NULL;
+	size_t value_len = 0u;
+
+	snprintf( json, 256u, "{"
+		"\"params\":{\"id\":\"inner\",\"list\":[{\"id\":\"deep\"}]},"
+		"\"item1\":\"value1\","
+		"\"id\":\"outer\""
+		"}" );
+	decoder = app_json_decode_initialize( buf, 512u, 0u );
+	assert_non_null( decoder );
+	result = app_json_decode_parse( decoder, json, strlen(json), &root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_non_null( root );
+
+	/* keys of the children are not keys of the object */
+	item = app_json_decode_object_find( decoder, root, "id" );
+	assert_non_null( item );
+	result = app_json_decode_string( decoder, item, &value, &value_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value_len, 5u );
+	assert_memory_equal( value, "outer", 5u );
+	item = app_json_decode_object_find( decoder, root, "list" );
+	assert_null( item );
+
+	/* only whole keys match */
+	item = app_json_decode_object_find( decoder, root, "item" );
+	assert_null( item );
+	item = app_json_decode_object_find_len( decoder, root, "item", 4u );
+	assert_null( item );
+
+	app_json_decode_terminate( decoder );
+}
+
 static void test_app_json_decode_object_find_null_item( void **state )
 {
 	char buf[256u];
@@ -1443,6 +1693,192 @@ static void test_app_json_decode_object_size_multiple( void **state )
 	app_json_decode_terminate( decoder );
 }
 
+static void test_app_json_decode_parse_chunk_dynamic( void **state )
+{
+	char json[2048u];
+	app_json_decoder_t *decoder;
+#ifndef IOT_STACK_ONLY
+	iot_status_t result = IOT_STATUS_TRY_AGAIN;
+	const app_json_item_t *root = NULL;
+	const app_json_item_t *arr;
+	const app_json_item_t *obj;
+	iot_int64_t value = 0;
+	size_t i;
+	size_t len;
+	will_return_always( __wrap_os_realloc, 1 );
+#endif
+
+	/* received 37 characters at a time */
+	snprintf( json, 2048u, "{\"messages\":[" );
+#ifndef IOT_STACK_ONLY
+	len = strlen( json );
+	for ( i = 0u; i < 40u; ++i )
+		len += (size_t)snprintf( &json[len], 2048u - len,
+			"%s{\"id\":\"message-%u\",\"seq\":%u}",
+			i > 0u ? "," : "", (unsigned int)i, (unsigned int)i );
+	snprintf( &json[len], 2048u - len, "]}" );
+#endif
+#ifdef IOT_STACK_ONLY
+	decoder = app_json_decode_initialize( NULL, 0u, 0u );
+	assert_null( decoder );
+#else
+	decoder = app_json_decode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+	assert_non_null( decoder );
+	len = strlen( json );
+	for ( i = 37u; result == IOT_STATUS_TRY_AGAIN && i < len; i += 37u )
+	{
+		result = app_json_decode_parse_chunk( decoder, json, i,
+			IOT_TRUE, &root, NULL, 0u );
+		assert_null( root );
+	}
+	assert_int_equal( result, IOT_STATUS_TRY_AGAIN );
+	result = app_json_decode_parse_chunk( decoder, json, len, IOT_FALSE,
+		&root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_non_null( root );
+
+	arr = app_json_decode_object_find( decoder, root, "messages" );
+	assert_non_null( arr );
+	assert_int_equal( app_json_decode_array_size( decoder, arr ), 40u );
+	result = app_json_decode_array_at( decoder, arr, 39u, &obj );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	obj = app_json_decode_object_find( decoder, obj, "seq" );
+	assert_non_null( obj );
+	result = app_json_decode_integer( decoder, obj, &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value, 39 );
+
+	app_json_decode_terminate( decoder );
+#endif
+}
+
+static void test_app_json_decode_parse_chunk_incomplete( void **state )
+{
+	char buf[256u];
+	char error[128u];
+	char json[256u];
+	app_json_decoder_t *decoder;
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+
+	snprintf( json, 256u, "{ \"not\": 12.34" );
+	decoder = app_json_decode_initialize( buf, 256u, 0u );
+	assert_non_null( decoder );
+	result = app_json_decode_parse_chunk( decoder, json, 6u, IOT_TRUE,
+		&root, error, 128u );
+	assert_int_equal( result, IOT_STATUS_TRY_AGAIN );
+	result = app_json_decode_parse_chunk( decoder, json, strlen(json),
+		IOT_FALSE, &root, error, 128u );
+	assert_int_equal( result, IOT_STATUS_PARSE_ERROR );
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+	assert_string_equal( error, "incomplete json string" );
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+	assert_null( root );
+
+	app_json_decode_terminate( decoder );
+}
+
+static void test_app_json_decode_parse_chunk_no_memory( void **state )
+{
+	char buf[256u];
+	char error[128u];
+	char json[512u];
+	app_json_decoder_t *decoder;
+	iot_status_t result = IOT_STATUS_TRY_AGAIN;
+	const app_json_item_t *root = NULL;
+	size_t i;
+	size_t len;
+
+	/* more tokens than fit in the buffer */
+	snprintf( json, 512u, "[" );
+	len = strlen( json );
+	for ( i = 0u; i < 40u; ++i )
+		len += (size_t)snprintf( &json[len], 512u - len, "%s%u",
+			i > 0u ? "," : "", (unsigned int)i );
+	snprintf( &json[len], 512u - len, "]" );
+	len = strlen( json );
+
+	decoder = app_json_decode_initialize( buf, 256u, 0u );
+	assert_non_null( decoder );
+	for ( i = 16u; result == IOT_STATUS_TRY_AGAIN && i < len; i += 16u )
+		result = app_json_decode_parse_chunk( decoder, json, i,
+			IOT_TRUE, &root, error, 128u );
+#if defined( IOT_JSON_JANSSON ) || defined( IOT_JSON_JSONC )
+	assert_int_equal( result, IOT_STATUS_TRY_AGAIN );
+#else /* defined( IOT_JSON_JSMN ) */
+	assert_int_equal( result, IOT_STATUS_NO_MEMORY );
+	assert_string_equal( error, "out of memory" );
+	assert_null( root );
+#endif /* defined( IOT_JSON_JSMN ) */
+
+	app_json_decode_terminate( decoder );
+}
+
+static void test_app_json_decode_parse_chunk_null_json( void **state )
+{
+	char buf[256u];
+	app_json_decoder_t *decoder;
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+
+	decoder = app_json_decode_initialize( buf, 256u, 0u );
+	assert_non_null( decoder );
+	result = app_json_decode_parse_chunk( decoder, NULL, 0u, IOT_TRUE,
+		&root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	assert_null( root );
+
+	app_json_decode_terminate( decoder );
+}
+
+static void test_app_json_decode_parse_chunk_valid( void **state )
+{
+	/* chunks end within a key, a number, an escape sequence, after a ':'
+	 * and after an object is closed */
+	const size_t chunk_end[] = { 4u, 13u, 21u, 25u, 40u, 48u };
+	char buf[1024u];
+	char json[256u];
+	app_json_decoder_t *decoder;
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+	const app_json_item_t *obj;
+	const char *str = NULL;
+	size_t str_len = 0u;
+	iot_int64_t value = 0;
+	size_t i;
+
+	snprintf( json, 256u, "{\"count\":1234,\"path\":\"c:\\\\tmp\","
+		"\"inner\":{\"a\":[1]},\"last\":5}" );
+	decoder = app_json_decode_initialize( buf, 1024u, 0u );
+	assert_non_null( decoder );
+	for ( i = 0u; i < sizeof( chunk_end ) / sizeof( chunk_end[0] ); ++i )
+	{
+		result = app_json_decode_parse_chunk( decoder, json,
+			chunk_end[i], IOT_TRUE, &root, NULL, 0u );
+		assert_int_equal( result, IOT_STATUS_TRY_AGAIN );
+	}
+	result = app_json_decode_parse_chunk( decoder, json, strlen(json),
+		IOT_FALSE, &root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_non_null( root );
+	assert_int_equal( app_json_decode_object_size( decoder, root ), 4u );
+
+	obj = app_json_decode_object_find( decoder, root, "count" );
+	result = app_json_decode_integer( decoder, obj, &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value, 1234 );
+	obj = app_json_decode_object_find( decoder, root, "path" );
+	result = app_json_decode_string( decoder, obj, &str, &str_len );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_non_null( str );
+	obj = app_json_decode_object_find( decoder, root, "last" );
+	result = app_json_decode_integer( decoder, obj, &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value, 5 );
+
+	app_json_decode_terminate( decoder );
+}
+
 static void test_app_json_decode_parse_dynamic( void **state )
 {
 	char json[256u];
@@ -1468,6 +1904,87 @@ static void test_app_json_decode_parse_dynamic( void **state )
 #endif
 }
 
+static void test_app_json_decode_parse_dynamic_large( void **state )
+{
+	char json[2048u];
+	app_json_decoder_t *decoder;
+#ifndef IOT_STACK_ONLY
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+	const app_json_item_t *arr;
+	const app_json_item_t *obj;
+	iot_int64_t value = 0;
+	size_t i;
+	size_t len;
+	will_return_always( __wrap_os_realloc, 1 );
+#endif
+
+	/* spans many blocks of the tokenizer */
+	snprintf( json, 2048u, "{\"messages\":[" );
+#ifndef IOT_STACK_ONLY
+	len = strlen( json );
+	for ( i = 0u; i < 40u; ++i )
+		len += (size_t)snprintf( &json[len], 2048u - len,
+			"%s{\"id\":\"message-%u\",\"seq\":%u}",
+			i > 0u ? "," : "", (unsigned int)i, (unsigned int)i );
+	snprintf( &json[len], 2048u - len, "]}" );
+#endif
+#ifdef IOT_STACK_ONLY
+	decoder = app_json_decode_initialize( NULL, 0u, 0u );
+	assert_null( decoder );
+#else
+	decoder = app_json_decode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+	assert_non_null( decoder );
+	result = app_json_decode_parse( decoder, json, strlen(json), &root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_non_null( root );
+
+	arr = app_json_decode_object_find( decoder, root, "messages" );
+	assert_non_null( arr );
+	assert_int_equal( app_json_decode_array_size( decoder, arr ), 40u );
+	result = app_json_decode_array_at( decoder, arr, 39u, &obj );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	obj = app_json_decode_object_find( decoder, obj, "seq" );
+	assert_non_null( obj );
+	result = app_json_decode_integer( decoder, obj, &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value, 39 );
+
+	app_json_decode_terminate( decoder );
+#endif
+}
+
+static void test_app_json_decode_parse_escaped_quotes( void **state )
+{
+	char buf[1024u];
+	char json[256u];
+	app_json_decoder_t *decoder;
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+	const app_json_item_t *obj;
+	iot_int64_t value = 0;
+
+	/* escaped quotes and back slashes across the 64th character */
+	snprintf( json, 256u,
+		"{\"description\":\"%s\\\\\\\"quoted\\\"\\\\\","
+		"\"next\":7}",
+		"01234567890123456789012345678901234567890123456" );
+	decoder = app_json_decode_initialize( buf, 1024u, 0u );
+	assert_non_null( decoder );
+	result = app_json_decode_parse( decoder, json, strlen(json), &root, NULL, 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_non_null( root );
+	assert_int_equal( app_json_decode_object_size( decoder, root ), 2u );
+
+	obj = app_json_decode_object_find( decoder, root, "next" );
+	assert_non_null( obj );
+	result = app_json_decode_integer( decoder, obj, &value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_int_equal( value, 7 );
+
+	app_json_decode_terminate( decoder );
+}
+
 static void test_app_json_decode_parse_invalid_character( void **state )
 {
 	char buf[1024u];
@@ -1510,6 +2027,28 @@ static void test_app_json_decode_parse_invalid_character( void **state )
 	app_json_decode_terminate( decoder );
 }
 
+static void test_app_json_decode_parse_invalid_escape( void **state )
+{
+	char buf[256u];
+	char error[128u];
+	char json[256u];
+	app_json_decoder_t *decoder;
+	iot_status_t result;
+	const app_json_item_t *root = NULL;
+
+	snprintf( json, 256u, "{\"path\":\"c:\\windows\"}" );
+	decoder = app_json_decode_initialize( buf, 256u, 0u );
+	assert_non_null( decoder );
+	result = app_json_decode_parse( decoder, json, strlen(json), &root, error, 128u );
+	assert_int_equal( result, IOT_STATUS_PARSE_ERROR );
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+	assert_string_equal( error, "invalid character" );
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+	assert_null( root );
+
+	app_json_decode_terminate( decoder );
+}
+
 static void test_app_json_decode_parse_invalid_partial( void **state )
 {
 	char buf[256u];
@@ -1854,6 +2393,10 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_app_json_decode_array_size_null_decoder ),
 		cmocka_unit_test( test_app_json_decode_array_size_null_item ),
 		cmocka_unit_test( test_app_json_decode_array_size_valid ),
+		cmocka_unit_test( test_app_json_decode_bind_missing_required ),
+		cmocka_unit_test( test_app_json_decode_bind_not_object ),
+		cmocka_unit_test( test_app_json_decode_bind_null_json ),
+		cmocka_unit_test( test_app_json_decode_bind_valid ),
 		cmocka_unit_test( test_app_json_decode_bool_null_item ),
 		cmocka_unit_test( test_app_json_decode_bool_null_json ),
 		cmocka_unit_test( test_app_json_decode_bool_valid ),
@@ -1868,6 +2411,8 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_app_json_decode_number_valid ),
 		cmocka_unit_test( test_app_json_decode_object_find_invalid ),
 		cmocka_unit_test( test_app_json_decode_object_find_valid ),
+		cmocka_unit_test( test_app_json_decode_object_find_many_keys ),
+		cmocka_unit_test( test_app_json_decode_object_find_nested ),
 		cmocka_unit_test( test_app_json_decode_object_find_null_item ),
 		cmocka_unit_test( test_app_json_decode_object_find_null_json ),
 		cmocka_unit_test( test_app_json_decode_object_find_null_key ),
@@ -1895,8 +2440,16 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_app_json_decode_object_size_null_item ),
 		cmocka_unit_test( test_app_json_decode_object_size_single ),
 		cmocka_unit_test( test_app_json_decode_object_size_multiple ),
+		cmocka_unit_test( test_app_json_decode_parse_chunk_dynamic ),
+		cmocka_unit_test( test_app_json_decode_parse_chunk_incomplete ),
+		cmocka_unit_test( test_app_json_decode_parse_chunk_no_memory ),
+		cmocka_unit_test( test_app_json_decode_parse_chunk_null_json ),
+		cmocka_unit_test( test_app_json_decode_parse_chunk_valid ),
 		cmocka_unit_test( test_app_json_decode_parse_dynamic ),
+		cmocka_unit_test( test_app_json_decode_parse_dynamic_large ),
+		cmocka_unit_test( test_app_json_decode_parse_escaped_quotes ),
 		cmocka_unit_test( test_app_json_decode_parse_invalid_character ),
+		cmocka_unit_test( test_app_json_decode_parse_invalid_escape ),
 		cmocka_unit_test( test_app_json_decode_parse_invalid_partial ),
 		cmocka_unit_test( test_app_json_decode_parse_null_json ),
 		cmocka_unit_test( test_app_json_decode_parse_null_root ),
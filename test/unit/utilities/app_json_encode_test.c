@@ -601,6 +601,46 @@ static void test_app_json_encode_dump_expand( void **state )
 	app_json_encode_terminate( e );
 }
 
+static void test_app_json_encode_dump_growth_closes_structs( void **state )
+{
+	app_json_encoder_t *e;
+	const char *json_str;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 256u ];
+	e = app_json_encode_initialize( buffer, sizeof( buffer ), 0u );
+#else /* if defined( IOT_STACK_ONLY ) */
+#if defined( IOT_JSON_JSONC )
+	will_return( __wrap_os_malloc, 1 );
+#endif /* if defined( IOT_JSON_JSONC ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	e = app_json_encode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( e );
+
+	/* the buffer grows to just fit the values, the closing characters
+	 * added by the dump must still fit */
+	result = app_json_encode_object_start( e, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_encode_integer( e, "k0", 1762321689508692849 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_encode_array_start( e, "k1" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_encode_integer( e, NULL, -4224085604011258924 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_encode_array_end( e );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	json_str = app_json_encode_dump( e );
+	assert_non_null( json_str );
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+	assert_string_equal( json_str, "{\"k0\":1762321689508692849,"
+		"\"k1\":[-4224085604011258924]}" );
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+	app_json_encode_terminate( e );
+}
+
 static void test_app_json_encode_dump_indent_0( void **state )
 {
 	app_json_encoder_t *e;
@@ -1106,6 +1146,38 @@ static void test_app_json_encode_integer_inside_object_blank_key( void **state )
 	app_json_encode_terminate( e );
 }
 
+static void test_app_json_encode_integer_limits( void **state )
+{
+	app_json_encoder_t *e;
+	const char *json_str;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 128u ];
+	e = app_json_encode_initialize( buffer, sizeof( buffer ), 0u );
+#else /* if defined( IOT_STACK_ONLY ) */
+#if defined( IOT_JSON_JSONC )
+	will_return( __wrap_os_malloc, 1 );
+#endif /* if defined( IOT_JSON_JSONC ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	e = app_json_encode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( e );
+
+	result = app_json_encode_integer( e, "min", INT64_MIN );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_integer( e, "max", INT64_MAX );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	json_str = app_json_encode_dump( e );
+	assert_non_null( json_str );
+	assert_string_equal( json_str,
+		"{\"min\":-9223372036854775808,\"max\":9223372036854775807}" );
+
+	app_json_encode_terminate( e );
+}
+
 static void test_app_json_encode_integer_null_item( void **state )
 {
 	iot_status_t result;
@@ -1977,6 +2049,36 @@ static void test_app_json_encode_real_inside_object_blank_key( void **state )
 	app_json_encode_terminate( e );
 }
 
+static void test_app_json_encode_real_not_finite( void **state )
+{
+	app_json_encoder_t *e;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 128u ];
+	e = app_json_encode_initialize( buffer, sizeof( buffer ), 0u );
+#else /* if defined( IOT_STACK_ONLY ) */
+#if defined( IOT_JSON_JSONC )
+	will_return( __wrap_os_malloc, 1 );
+#endif /* if defined( IOT_JSON_JSONC ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	e = app_json_encode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( e );
+
+	result = app_json_encode_object_start( e, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* JSON has no representation for NaN or infinity */
+	result = app_json_encode_real( e, "test", NAN );
+	assert_int_not_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_real( e, "test", -INFINITY );
+	assert_int_not_equal( result, IOT_STATUS_SUCCESS );
+
+	app_json_encode_terminate( e );
+}
+
 static void test_app_json_encode_real_null_item( void **state )
 {
 	iot_status_t result;
@@ -2021,6 +2123,165 @@ static void test_app_json_encode_real_outside_object( void **state )
 	app_json_encode_terminate( e );
 }
 
+static void test_app_json_encode_real_precision( void **state )
+{
+	app_json_encoder_t *e;
+	const char *json_str;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 128u ];
+	e = app_json_encode_initialize( buffer, sizeof( buffer ), 0u );
+#else /* if defined( IOT_STACK_ONLY ) */
+#if defined( IOT_JSON_JSONC )
+	will_return( __wrap_os_malloc, 1 );
+#endif /* if defined( IOT_JSON_JSONC ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	e = app_json_encode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( e );
+
+	result = app_json_encode_object_start( e, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_real_precision( e, "test1", 3.14159, 2 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_real_precision( e, "test2", -0.0049, 2 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_real_precision( e, "test3", 2.5, 0 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* stored as 2.67499999..., even though scaling rounds it to 267.5 */
+	result = app_json_encode_real_precision( e, "test4", 2.675, 2 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	json_str = app_json_encode_dump( e );
+	assert_non_null( json_str );
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+	assert_string_equal( json_str,
+		"{\"test1\":3.14,\"test2\":0.0,\"test3\":3.0,"
+		"\"test4\":2.67}" );
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+
+	app_json_encode_terminate( e );
+}
+
+static void test_app_json_encode_real_shortest( void **state )
+{
+	app_json_encoder_t *e;
+	const char *json_str;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 128u ];
+	e = app_json_encode_initialize( buffer, sizeof( buffer ), 0u );
+#else /* if defined( IOT_STACK_ONLY ) */
+#if defined( IOT_JSON_JSONC )
+	will_return( __wrap_os_malloc, 1 );
+#endif /* if defined( IOT_JSON_JSONC ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	e = app_json_encode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( e );
+
+	result = app_json_encode_array_start( e, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_real( e, NULL, 0.1 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_real( e, NULL, 1e-7 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_real( e, NULL, 1.7976931348623157e308 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_real_precision( e, NULL, (double)0.3f,
+		APP_JSON_PRECISION_SHORTEST_FLOAT );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	json_str = app_json_encode_dump( e );
+	assert_non_null( json_str );
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+	assert_string_equal( json_str,
+		"[0.1,1e-7,1.7976931348623157e308,0.3]" );
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+
+	app_json_encode_terminate( e );
+}
+
+static void test_app_json_encode_reset_no_allocation( void **state )
+{
+	app_json_encoder_t *e;
+	unsigned int i;
+	const char *json_str;
+	iot_status_t result;
+	char expected[ 128u ];
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 256u ];
+	e = app_json_encode_initialize( buffer, sizeof( buffer ), 0u );
+#elif defined( IOT_JSON_JANSSON ) || defined( IOT_JSON_JSONC )
+	/* object tree is rebuilt for each message */
+#if defined( IOT_JSON_JSONC )
+	will_return_always( __wrap_os_malloc, 1 );
+#endif /* if defined( IOT_JSON_JSONC ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	e = app_json_encode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+#else /* if defined( IOT_STACK_ONLY ) */
+	/* only the first message allocates memory */
+	will_return_count( __wrap_os_realloc, 1, 5 );
+	e = app_json_encode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( e );
+
+	for ( i = 0u; i < 4u; ++i )
+	{
+		if ( i > 0u )
+		{
+			result = app_json_encode_reset( e );
+			assert_int_equal( result, IOT_STATUS_SUCCESS );
+		}
+		result = app_json_encode_object_start( e, "cmd" );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+		result = app_json_encode_string( e, "command",
+			"property.publish" );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+		result = app_json_encode_object_start( e, "params" );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+		result = app_json_encode_string( e, "key", "temperature" );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+		result = app_json_encode_integer( e, "value", (iot_int64_t)i );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+		result = app_json_encode_object_end( e );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+		result = app_json_encode_object_end( e );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+		json_str = app_json_encode_dump( e );
+		assert_non_null( json_str );
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+		snprintf( expected, sizeof( expected ),
+			"{\"cmd\":{\"command\":\"property.publish\","
+			"\"params\":{\"key\":\"temperature\",\"value\":%u}}}", i );
+		assert_string_equal( json_str, expected );
+#else /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+		(void)expected;
+#endif /* else if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+	}
+
+	app_json_encode_terminate( e );
+}
+
+static void test_app_json_encode_reset_null_item( void **state )
+{
+	iot_status_t result;
+	result = app_json_encode_reset( NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
 static void test_app_json_encode_string_as_root_item( void **state )
 {
 	app_json_encoder_t *e;
@@ -2041,6 +2302,37 @@ static void test_app_json_encode_string_as_root_item( void **state )
 	app_json_encode_terminate( e );
 }
 
+static void test_app_json_encode_string_control_chars( void **state )
+{
+	app_json_encoder_t *e;
+	const char *json_str;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 128u ];
+	e = app_json_encode_initialize( buffer, sizeof( buffer ), 0u );
+#else /* if defined( IOT_STACK_ONLY ) */
+#if defined( IOT_JSON_JSONC )
+	will_return( __wrap_os_malloc, 1 );
+#endif /* if defined( IOT_JSON_JSONC ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	e = app_json_encode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( e );
+
+	/* long enough for an escape outside the first block scanned */
+	result = app_json_encode_string( e, "test",
+		"0123456789abcdefghij\x01klmnopqrstuvwxyz\x10" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	json_str = app_json_encode_dump( e );
+	assert_non_null( json_str );
+	assert_string_equal( json_str,
+		"{\"test\":\"0123456789abcdefghij\\u0001"
+		"klmnopqrstuvwxyz\\u0010\"}" );
+	app_json_encode_terminate( e );
+}
+
 static void test_app_json_encode_string_escape_chars( void **state )
 {
 	app_json_encoder_t *e;
@@ -2261,6 +2553,383 @@ static void test_app_json_encode_string_utf8_chars( void **state )
 	app_json_encode_terminate( e );
 }
 
+static void test_app_json_encode_unsigned_as_root_item( void **state )
+{
+	app_json_encoder_t *e;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 128u ];
+	e = app_json_encode_initialize( buffer, sizeof( buffer ), 0u );
+#else /* if defined( IOT_STACK_ONLY ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	e = app_json_encode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( e );
+
+	result = app_json_encode_unsigned( e, NULL, 1234u );
+	assert_int_equal( result, IOT_STATUS_BAD_REQUEST );
+
+	app_json_encode_terminate( e );
+}
+
+static void test_app_json_encode_unsigned_inside_object( void **state )
+{
+	app_json_encoder_t *e;
+	const char *json_str;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 128u ];
+	e = app_json_encode_initialize( buffer, sizeof( buffer ), 0u );
+#else /* if defined( IOT_STACK_ONLY ) */
+#if defined( IOT_JSON_JSONC )
+	will_return( __wrap_os_malloc, 1 );
+#endif /* if defined( IOT_JSON_JSONC ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	e = app_json_encode_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( e );
+
+	result = app_json_encode_object_start( e, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_unsigned( e, "test1", 0u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_unsigned( e, "test2", UINT64_MAX );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	json_str = app_json_encode_dump( e );
+	assert_non_null( json_str );
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+	assert_string_equal( json_str,
+		"{\"test1\":0,\"test2\":18446744073709551615}" );
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+
+	app_json_encode_terminate( e );
+}
+
+static void test_app_json_encode_unsigned_null_item( void **state )
+{
+	iot_status_t result;
+
+	result = app_json_encode_unsigned( NULL, "test", 1234u );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+}
+
+/* app_json_stream */
+/** @brief output written by a stream in the tests */
+struct test_stream_output
+{
+	char data[ 1024u ];              /**< @brief characters written */
+	size_t len;                      /**< @brief number written */
+	unsigned int calls;              /**< @brief number of sink calls */
+	iot_status_t status;             /**< @brief status to return */
+};
+
+/** @brief sink collecting the output of a stream in the tests */
+static iot_status_t test_stream_sink( void *user_data, const char *data,
+	size_t len )
+{
+	struct test_stream_output *const out =
+		(struct test_stream_output *)user_data;
+	assert_non_null( out );
+	assert_true( len > 0u );
+	assert_true( out->len + len < sizeof( out->data ) );
+	memcpy( &out->data[out->len], data, len );
+	out->len += len;
+	out->data[out->len] = '\0';
+	++out->calls;
+	return out->status;
+}
+
+static void test_app_json_stream_bad_request( void **state )
+{
+	app_json_stream_t *s;
+	struct test_stream_output out;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 256u ];
+	s = app_json_stream_initialize( buffer, sizeof( buffer ), 0u,
+		test_stream_sink, &out );
+#else /* if defined( IOT_STACK_ONLY ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	s = app_json_stream_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC,
+		test_stream_sink, &out );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( s );
+	memset( &out, 0, sizeof( out ) );
+
+	/* values can't be a root item */
+	result = app_json_stream_integer( s, NULL, 1 );
+	assert_int_equal( result, IOT_STATUS_BAD_REQUEST );
+	result = app_json_stream_string( s, NULL, "value" );
+	assert_int_equal( result, IOT_STATUS_BAD_REQUEST );
+	result = app_json_stream_array_end( s );
+	assert_int_equal( result, IOT_STATUS_BAD_REQUEST );
+
+	result = app_json_stream_array_start( s, NULL );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	/* keys can't be given inside an array */
+	result = app_json_stream_bool( s, "key", IOT_TRUE );
+	assert_int_equal( result, IOT_STATUS_BAD_REQUEST );
+	result = app_json_stream_object_end( s );
+	assert_int_equal( result, IOT_STATUS_BAD_REQUEST );
+	result = app_json_stream_array_end( s );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* only one root item */
+	result = app_json_stream_object_start( s, NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_REQUEST );
+
+	result = app_json_stream_finish( s );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_string_equal( out.data, "[]" );
+	app_json_stream_terminate( s );
+}
+
+static void test_app_json_stream_initialize_no_sink( void **state )
+{
+	app_json_stream_t *s;
+	char buffer[ 256u ];
+
+	s = app_json_stream_initialize( buffer, sizeof( buffer ), 0u,
+		NULL, NULL );
+	assert_null( s );
+}
+
+static void test_app_json_stream_initialize_too_small( void **state )
+{
+	app_json_stream_t *s;
+	char buffer[ 8u ];
+
+	s = app_json_stream_initialize( buffer, sizeof( buffer ), 0u,
+		test_stream_sink, NULL );
+	assert_null( s );
+}
+
+static void test_app_json_stream_indent_expand( void **state )
+{
+	app_json_encoder_t *e;
+	app_json_stream_t *s;
+	struct test_stream_output out;
+	unsigned int i;
+	iot_status_t result;
+	const unsigned int flags = APP_JSON_FLAG_INDENT(2) |
+		APP_JSON_FLAG_EXPAND;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 512u ];
+	char s_buffer[ 256u ];
+	e = app_json_encode_initialize( buffer, sizeof( buffer ), flags );
+	s = app_json_stream_initialize( s_buffer, sizeof( s_buffer ), flags,
+		test_stream_sink, &out );
+#else /* if defined( IOT_STACK_ONLY ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	e = app_json_encode_initialize( NULL, 0u,
+		APP_JSON_FLAG_DYNAMIC | flags );
+	s = app_json_stream_initialize( NULL, 0u,
+		APP_JSON_FLAG_DYNAMIC | flags, test_stream_sink, &out );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	memset( &out, 0, sizeof( out ) );
+	assert_non_null( e );
+	assert_non_null( s );
+
+	/* same output as the encoder */
+	result = app_json_encode_array_start( e, "array" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_array_start( s, "array" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	for ( i = 0u; i < 3u; ++i )
+	{
+		result = app_json_encode_integer( e, NULL, i + 1u );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+		result = app_json_stream_integer( s, NULL, i + 1u );
+		assert_int_equal( result, IOT_STATUS_SUCCESS );
+	}
+	result = app_json_encode_array_end( e );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_array_end( s );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_object_start( e, "empty" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_encode_object_end( e );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_object_start( s, "empty" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_object_end( s );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	result = app_json_encode_object_start( e, "obj" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_encode_bool( e, "bool", IOT_FALSE );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_encode_real( e, "real", 0.5 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_encode_string( e, "string", "value" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_object_start( s, "obj" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_bool( s, "bool", IOT_FALSE );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_real( s, "real", 0.5 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_string( s, "string", "value" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* open items are ended by dump and finish */
+	result = app_json_stream_finish( s );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	assert_string_equal( out.data,
+		"{\n"
+		"  \"array\": [\n"
+		"    1,\n"
+		"    2,\n"
+		"    3\n"
+		"  ],\n"
+		"  \"empty\": {},\n"
+		"  \"obj\": {\n"
+		"    \"bool\": false,\n"
+		"    \"real\": 0.5,\n"
+		"    \"string\": \"value\"\n"
+		"  }\n"
+		"}" );
+#if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC )
+	assert_string_equal( out.data, app_json_encode_dump( e ) );
+#endif /* if !defined( IOT_JSON_JANSSON ) && !defined( IOT_JSON_JSONC ) */
+	app_json_encode_terminate( e );
+	app_json_stream_terminate( s );
+}
+
+static void test_app_json_stream_null_item( void **state )
+{
+	iot_status_t result;
+
+	result = app_json_stream_array_start( NULL, NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_json_stream_array_end( NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_json_stream_bool( NULL, "test", IOT_TRUE );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_json_stream_finish( NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_json_stream_flush( NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_json_stream_integer( NULL, "test", -1 );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_json_stream_object_start( NULL, "test" );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_json_stream_object_end( NULL );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_json_stream_real( NULL, "test", 1.5 );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_json_stream_string( NULL, "test", "value" );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	result = app_json_stream_unsigned( NULL, "test", 1u );
+	assert_int_equal( result, IOT_STATUS_BAD_PARAMETER );
+	app_json_stream_terminate( NULL );
+}
+
+static void test_app_json_stream_sink_failure( void **state )
+{
+	app_json_stream_t *s;
+	struct test_stream_output out;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 256u ];
+	s = app_json_stream_initialize( buffer, sizeof( buffer ), 0u,
+		test_stream_sink, &out );
+#else /* if defined( IOT_STACK_ONLY ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	s = app_json_stream_initialize( NULL, 0u, APP_JSON_FLAG_DYNAMIC,
+		test_stream_sink, &out );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( s );
+	memset( &out, 0, sizeof( out ) );
+	out.status = IOT_STATUS_IO_ERROR;
+
+	result = app_json_stream_string( s, "key", "value" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_flush( s );
+	assert_int_equal( result, IOT_STATUS_IO_ERROR );
+	assert_int_equal( out.calls, 1u );
+
+	/* the stream stops once the sink fails */
+	result = app_json_stream_string( s, "other", "value" );
+	assert_int_equal( result, IOT_STATUS_IO_ERROR );
+	result = app_json_stream_finish( s );
+	assert_int_equal( result, IOT_STATUS_IO_ERROR );
+	assert_int_equal( out.calls, 1u );
+	assert_string_equal( out.data, "{\"key\":\"value\"" );
+	app_json_stream_terminate( s );
+}
+
+static void test_app_json_stream_small_buffer( void **state )
+{
+	app_json_stream_t *s;
+	struct test_stream_output out;
+	char value[ 200u ];
+	char expected[ 512u ];
+	size_t i;
+	size_t len;
+	iot_status_t result;
+
+#if defined( IOT_STACK_ONLY )
+	char buffer[ 128u ];
+	s = app_json_stream_initialize( buffer, sizeof( buffer ), 0u,
+		test_stream_sink, &out );
+#else /* if defined( IOT_STACK_ONLY ) */
+	will_return_always( __wrap_os_realloc, 1 );
+	s = app_json_stream_initialize( NULL, 16u, APP_JSON_FLAG_DYNAMIC,
+		test_stream_sink, &out );
+#endif /* else if defined( IOT_STACK_ONLY ) */
+	assert_non_null( s );
+	memset( &out, 0, sizeof( out ) );
+
+	/* a long string with characters to escape */
+	for ( i = 0u; i < sizeof( value ) - 1u; ++i )
+		value[i] = ( i % 10u == 0u ) ? '\n' : (char)( 'a' + i % 26u );
+	value[sizeof( value ) - 1u] = '\0';
+	len = (size_t)snprintf( expected, sizeof( expected ),
+		"{\"numbers\":[-9223372036854775807,18446744073709551615,"
+		"1.25],\"text\":\"" );
+	for ( i = 0u; value[i] != '\0'; ++i )
+	{
+		if ( value[i] == '\n' )
+		{
+			expected[len++] = '\\';
+			expected[len++] = 'n';
+		}
+		else
+			expected[len++] = value[i];
+	}
+	snprintf( &expected[len], sizeof( expected ) - len, "\"}" );
+
+	result = app_json_stream_array_start( s, "numbers" );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_integer( s, NULL, -9223372036854775807 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_unsigned( s, NULL, 18446744073709551615u );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_real_precision( s, NULL, 1.25, 2 );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_array_end( s );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_string( s, "text", value );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+	result = app_json_stream_finish( s );
+	assert_int_equal( result, IOT_STATUS_SUCCESS );
+
+	/* the output is given to the sink as the buffer fills */
+	assert_true( out.calls > 1u );
+	assert_string_equal( out.data, expected );
+	app_json_stream_terminate( s );
+}
+
 /* main */
 int main( int argc, char *argv[] )
 {
@@ -2290,6 +2959,7 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_app_json_encode_dump_no_items ),
 		cmocka_unit_test( test_app_json_encode_dump_null_item ),
 		cmocka_unit_test( test_app_json_encode_dump_expand ),
+		cmocka_unit_test( test_app_json_encode_dump_growth_closes_structs ),
 		cmocka_unit_test( test_app_json_encode_dump_indent_0 ),
 #if !defined( IOT_JSON_JSONC )
 		cmocka_unit_test( test_app_json_encode_dump_indent_1 ),
@@ -2304,6 +2974,7 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_app_json_encode_integer_inside_array_valid_key ),
 		cmocka_unit_test( test_app_json_encode_integer_inside_object ),
 		cmocka_unit_test( test_app_json_encode_integer_inside_object_blank_key ),
+		cmocka_unit_test( test_app_json_encode_integer_limits ),
 		cmocka_unit_test( test_app_json_encode_integer_null_item ),
 		cmocka_unit_test( test_app_json_encode_integer_outside_object ),
 		cmocka_unit_test( test_app_json_encode_object_cancel_at_root ),
@@ -2334,9 +3005,15 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_app_json_encode_real_inside_array_valid_key ),
 		cmocka_unit_test( test_app_json_encode_real_inside_object ),
 		cmocka_unit_test( test_app_json_encode_real_inside_object_blank_key ),
+		cmocka_unit_test( test_app_json_encode_real_not_finite ),
 		cmocka_unit_test( test_app_json_encode_real_null_item ),
 		cmocka_unit_test( test_app_json_encode_real_outside_object ),
+		cmocka_unit_test( test_app_json_encode_real_precision ),
+		cmocka_unit_test( test_app_json_encode_real_shortest ),
+		cmocka_unit_test( test_app_json_encode_reset_no_allocation ),
+		cmocka_unit_test( test_app_json_encode_reset_null_item ),
 		cmocka_unit_test( test_app_json_encode_string_as_root_item ),
+		cmocka_unit_test( test_app_json_encode_string_control_chars ),
 		cmocka_unit_test( test_app_json_encode_string_escape_chars ),
 		cmocka_unit_test( test_app_json_encode_string_inside_array_null_key ),
 		cmocka_unit_test( test_app_json_encode_string_inside_array_valid_key ),
@@ -2344,7 +3021,17 @@ int main( int argc, char *argv[] )
 		cmocka_unit_test( test_app_json_encode_string_inside_object_blank_key ),
 		cmocka_unit_test( test_app_json_encode_string_null_item ),
 		cmocka_unit_test( test_app_json_encode_string_outside_object ),
-		cmocka_unit_test( test_app_json_encode_string_utf8_chars )
+		cmocka_unit_test( test_app_json_encode_string_utf8_chars ),
+		cmocka_unit_test( test_app_json_encode_unsigned_as_root_item ),
+		cmocka_unit_test( test_app_json_encode_unsigned_inside_object ),
+		cmocka_unit_test( test_app_json_encode_unsigned_null_item ),
+		cmocka_unit_test( test_app_json_stream_bad_request ),
+		cmocka_unit_test( test_app_json_stream_indent_expand ),
+		cmocka_unit_test( test_app_json_stream_initialize_no_sink ),
+		cmocka_unit_test( test_app_json_stream_initialize_too_small ),
+		cmocka_unit_test( test_app_json_stream_null_item ),
+		cmocka_unit_test( test_app_json_stream_sink_failure ),
+		cmocka_unit_test( test_app_json_stream_small_buffer )
 	};
 	test_initialize( argc, argv );
 	result = cmocka_run_group_tests( tests, NULL, NULL );